@@ -30,6 +30,19 @@ enum class AndroidRenderingAPI {
   kSkiaOpenGLES
 };
 
+// How the Skia raster cache populates its display list entries.
+enum class RasterCachePopulation {
+  // Entries are rasterized on the raster thread while the frame that first
+  // caches them is prepared.
+  kSynchronous,
+  // Entries are rasterized on the concurrent worker threads and the frame
+  // that caches them waits for them before it is painted.
+  kConcurrentJoin,
+  // Entries are rasterized on the concurrent worker threads and frames paint
+  // the uncached content until they are ready.
+  kConcurrentDeferred,
+};
+
 class FrameTiming {
  public:
   enum Phase {
@@ -346,6 +359,37 @@ struct Settings {
   // Max bytes threshold of resource cache, or 0 for unlimited.
   size_t resource_cache_max_bytes_threshold = 0;
 
+  // How the Skia raster cache populates display list entries. Ignored by
+  // Impeller, which does not use the raster cache.
+  RasterCachePopulation raster_cache_population =
+      RasterCachePopulation::kSynchronous;
+
+  // The total size of the images held by the Skia raster cache, or 0 for
+  // unlimited. Over budget, entries are kept by how much rendering work they
+  // save per pixel and how recently they were used.
+  size_t raster_cache_max_bytes = 0;
+
+  // The total size of the decoded images that the engine keeps to skip
+  // decoding the same encoded bytes at the same size again, or 0 (the default)
+  // to not keep any. The cache is shared by the engines of a group.
+  size_t decoded_image_cache_max_bytes = 0;
+
+  // The number of frames of an animated image that are decoded on worker
+  // threads ahead of the frame the framework asks for next.
+  size_t animated_image_decode_ahead_frames = 1;
+
+  // Animated images whose decoded frames all fit in this many bytes keep the
+  // frames after the first loop instead of decoding them again, or 0 (the
+  // default) to always decode them.
+  size_t animated_image_frame_cache_max_bytes = 0;
+
+  // If not empty, the rasterizer writes the flattened display list of each
+  // rendered view to this directory in the format of DlBinaryWriter, for
+  // offline replay with display_list_replay_benchmarks. Only the first
+  // |display_list_capture_frame_limit| frames are captured.
+  std::string display_list_capture_path;
+  size_t display_list_capture_frame_limit = 100;
+
   /// Enable embedder api on the embedder.
   ///
   /// This is currently only used by iOS.
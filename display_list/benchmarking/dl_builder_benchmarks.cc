@@ -4,6 +4,7 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/display_list/utils/dl_receiver_utils.h"
 
 namespace flutter {
 
@@ -57,6 +58,31 @@ bool NeedPrepareRTree(DisplayListBuilderBenchmarkType type) {
          type == DisplayListBuilderBenchmarkType::kBoundsAndRtree;
 }
 
+class NopReceiver final : public IgnoreAttributeDispatchHelper,
+                          public IgnoreClipDispatchHelper,
+                          public IgnoreTransformDispatchHelper,
+                          public IgnoreDrawDispatchHelper {};
+
+// Records |count| rects in a row, painted with |paints| in turn.
+sk_sp<DisplayList> BuildRects(int count,
+                              const std::vector<DlPaint>& paints,
+                              bool prepare_rtree) {
+  DisplayListBuilder builder(prepare_rtree);
+  for (int i = 0; i < count; i++) {
+    builder.DrawRect(SkRect::MakeXYWH((i % 100) * 10, (i / 100) * 10, 8, 8),
+                     paints[i % paints.size()]);
+  }
+  return builder.Build();
+}
+
+sk_sp<DisplayList> BuildAllRenderingOps(int repetitions, bool prepare_rtree) {
+  DisplayListBuilder builder(prepare_rtree);
+  for (int i = 0; i < repetitions; i++) {
+    InvokeAllRenderingOps(builder);
+  }
+  return builder.Build();
+}
+
 }  // namespace
 
 static void BM_DisplayListBuilderDefault(benchmark::State& state,
@@ -171,6 +197,112 @@ static void BM_DisplayListBuilderWithSaveLayerAndImageFilter(
   }
 }
 
+// Records display lists large enough to need the storage to grow many times.
+static void BM_DisplayListBuilderLarge(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BuildAllRenderingOps(state.range(0), false));
+  }
+}
+
+static void BM_DisplayListDispatch(benchmark::State& state) {
+  auto display_list = BuildAllRenderingOps(state.range(0), false);
+  NopReceiver receiver;
+  for (auto _ : state) {
+    display_list->Dispatch(receiver);
+  }
+  state.SetItemsProcessed(state.iterations() * display_list->op_count());
+}
+
+static void BM_DisplayListDispatchCulled(benchmark::State& state) {
+  auto display_list = BuildAllRenderingOps(state.range(0), true);
+  SkRect cull_rect = display_list->bounds().makeInset(
+      display_list->bounds().width() / 4, display_list->bounds().height() / 4);
+  NopReceiver receiver;
+  for (auto _ : state) {
+    display_list->Dispatch(receiver, cull_rect);
+  }
+  state.SetItemsProcessed(state.iterations() * display_list->op_count());
+}
+
+// Consecutive rects with the same paint share one op, this reports how
+// many bytes that takes.
+static void BM_DisplayListBuilderRects(benchmark::State& state) {
+  std::vector<DlPaint> paints = {DlPaint(DlColor::kBlue())};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BuildRects(state.range(0), paints, false));
+  }
+  state.counters["Bytes"] =
+      BuildRects(state.range(0), paints, false)->bytes();
+}
+
+// Switches back and forth between two gradients which are only stored
+// once in the attribute tables of the DisplayList.
+static void BM_DisplayListBuilderAlternatingShaders(benchmark::State& state) {
+  std::vector<DlPaint> paints = {
+      DlPaint().setColorSource(testing::kTestSource2),
+      DlPaint().setColorSource(testing::kTestSource3),
+  };
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BuildRects(state.range(0), paints, false));
+  }
+  state.counters["Bytes"] =
+      BuildRects(state.range(0), paints, false)->bytes();
+}
+
+// Runs of rects are handed to the receiver with one drawRects call.
+static void BM_DisplayListDispatchRects(benchmark::State& state) {
+  std::vector<DlPaint> paints = {DlPaint(DlColor::kBlue())};
+  auto display_list = BuildRects(state.range(0), paints, false);
+  NopReceiver receiver;
+  for (auto _ : state) {
+    display_list->Dispatch(receiver);
+  }
+  state.SetItemsProcessed(state.iterations() * display_list->op_count());
+}
+
+// A culled dispatch still has to visit the rects of a run one at a time.
+static void BM_DisplayListDispatchRectsCulled(benchmark::State& state) {
+  std::vector<DlPaint> paints = {DlPaint(DlColor::kBlue())};
+  auto display_list = BuildRects(state.range(0), paints, true);
+  SkRect cull_rect = display_list->bounds().makeInset(
+      display_list->bounds().width() / 4, display_list->bounds().height() / 4);
+  NopReceiver receiver;
+  for (auto _ : state) {
+    display_list->Dispatch(receiver, cull_rect);
+  }
+  state.SetItemsProcessed(state.iterations() * display_list->op_count());
+}
+
+BENCHMARK(BM_DisplayListBuilderRects)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListBuilderAlternatingShaders)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListDispatchRects)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListDispatchRectsCulled)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DisplayListBuilderLarge)
+    ->RangeMultiplier(10)
+    ->Range(1, 100)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListDispatch)
+    ->RangeMultiplier(10)
+    ->Range(1, 100)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListDispatchCulled)
+    ->RangeMultiplier(10)
+    ->Range(1, 100)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_CAPTURE(BM_DisplayListBuilderDefault,
                   kDefault,
                   DisplayListBuilderBenchmarkType::kDefault)
@@ -5,9 +5,11 @@
 #include "flutter/benchmarking/benchmarking.h"
 
 #include "flutter/display_list/geometry/dl_region.h"
+#include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkRegion.h"
 
+#include <algorithm>
 #include <random>
 
 namespace {
@@ -76,6 +78,8 @@ class SkRegionAdapter {
 
   bool intersects(const SkIRect& rect) { return region_.intersects(rect); }
 
+  void addRect(const SkIRect& rect) { region_.op(rect, SkRegion::kUnion_Op); }
+
   std::vector<SkIRect> getRects() {
     std::vector<SkIRect> rects;
     SkRegion::Iterator it(region_);
@@ -115,6 +119,8 @@ class DlRegionAdapter {
 
   bool intersects(const SkIRect& rect) { return region_.intersects(rect); }
 
+  void addRect(const SkIRect& rect) { region_.addRect(rect); }
+
   std::vector<SkIRect> getRects() { return region_.getRects(false); }
 
  private:
@@ -125,7 +131,9 @@ class DlRegionAdapter {
 };
 
 template <typename Region>
-void RunFromRectsBenchmark(benchmark::State& state, int maxSize) {
+void RunFromRectsBenchmark(benchmark::State& state,
+                           int maxSize,
+                           int rectCount) {
   std::random_device d;
   std::seed_seq seed{2, 1, 3};
   std::mt19937 rng(seed);
@@ -134,7 +142,7 @@ void RunFromRectsBenchmark(benchmark::State& state, int maxSize) {
   std::uniform_int_distribution size(1, maxSize);
 
   std::vector<SkIRect> rects;
-  for (int i = 0; i < 2000; ++i) {
+  for (int i = 0; i < rectCount; ++i) {
     SkIRect rect = SkIRect::MakeXYWH(pos(rng), pos(rng), size(rng), size(rng));
     rects.push_back(rect);
   }
@@ -142,6 +150,27 @@ void RunFromRectsBenchmark(benchmark::State& state, int maxSize) {
   while (state.KeepRunning()) {
     Region region(rects);
   }
+  state.SetItemsProcessed(state.iterations() * rectCount);
+}
+
+template <typename Region>
+void RunAddRectsBenchmark(benchmark::State& state,
+                          int maxSize,
+                          int rectCount) {
+  std::random_device d;
+  std::seed_seq seed{2, 1, 3};
+  std::mt19937 rng(seed);
+
+  auto rects =
+      GenerateRects(rng, SkIRect::MakeWH(4000, 4000), rectCount, maxSize);
+
+  while (state.KeepRunning()) {
+    Region region(std::vector<SkIRect>{});
+    for (const auto& rect : rects) {
+      region.addRect(rect);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * rectCount);
 }
 
 template <typename Region>
@@ -173,7 +202,8 @@ void RunRegionOpBenchmark(benchmark::State& state,
                           RegionOp op,
                           bool withSingleRect,
                           int maxSize,
-                          double sizeFactor) {
+                          double sizeFactor,
+                          int rectCount) {
   std::random_device d;
   std::seed_seq seed{2, 1, 3};
   std::mt19937 rng(seed);
@@ -181,11 +211,11 @@ void RunRegionOpBenchmark(benchmark::State& state,
   SkIRect bounds1 = SkIRect::MakeWH(4000, 4000);
   SkIRect bounds2 = RandomSubRect(rng, bounds1, sizeFactor);
 
-  auto rects = GenerateRects(rng, bounds1, 500, maxSize);
+  auto rects = GenerateRects(rng, bounds1, rectCount, maxSize);
   Region region1(rects);
 
-  rects = GenerateRects(rng, bounds2, withSingleRect ? 1 : 500 * sizeFactor,
-                        maxSize);
+  rects = GenerateRects(rng, bounds2,
+                        withSingleRect ? 1 : rectCount * sizeFactor, maxSize);
   Region region2(rects);
 
   switch (op) {
@@ -253,16 +283,94 @@ void RunIntersectsSingleRectBenchmark(benchmark::State& state, int maxSize) {
   }
 }
 
+
+// The bounds of the ops of a scrolling list of |rows| rows of 8 items,
+// either in the order in which they are drawn or shuffled.
+template <typename RNG>
+std::vector<SkRect> GenerateListRects(RNG& rng, int rows, bool shuffle) {
+  std::uniform_real_distribution<float> jitter(0, 20);
+  std::vector<SkRect> rects;
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < 8; ++c) {
+      rects.push_back(
+          SkRect::MakeXYWH(c * 50 + jitter(rng), r * 60 + jitter(rng), 40, 40));
+    }
+  }
+  if (shuffle) {
+    std::shuffle(rects.begin(), rects.end(), rng);
+  }
+  return rects;
+}
+
+// Viewport sized queries spread over the list.
+std::vector<SkRect> GenerateListQueries(int rows, int count) {
+  std::vector<SkRect> queries;
+  for (int i = 0; i < count; ++i) {
+    queries.push_back(SkRect::MakeXYWH(0, i * (rows * 60 - 800) / count, 400,
+                                       800));
+  }
+  return queries;
+}
+
+void RunRTreeBuildBenchmark(benchmark::State& state, bool shuffle) {
+  std::seed_seq seed{2, 1, 3};
+  std::mt19937 rng(seed);
+  auto rects = GenerateListRects(rng, state.range(0), shuffle);
+  while (state.KeepRunning()) {
+    flutter::DlRTree rtree(rects.data(), rects.size());
+    benchmark::DoNotOptimize(rtree.node_count());
+  }
+}
+
+void RunRTreeSearchBenchmark(benchmark::State& state,
+                             bool shuffle,
+                             bool batch) {
+  std::seed_seq seed{2, 1, 3};
+  std::mt19937 rng(seed);
+  auto rects = GenerateListRects(rng, state.range(0), shuffle);
+  flutter::DlRTree rtree(rects.data(), rects.size());
+  auto queries = GenerateListQueries(state.range(0), 100);
+
+  std::vector<int> results;
+  std::vector<int> offsets;
+  while (state.KeepRunning()) {
+    if (batch) {
+      rtree.search(queries.data(), queries.size(), &results, &offsets);
+    } else {
+      for (auto& query : queries) {
+        results.clear();
+        rtree.search(query, &results);
+      }
+    }
+  }
+}
+
 }  // namespace
 
 namespace flutter {
 
-static void BM_DlRegion_FromRects(benchmark::State& state, int maxSize) {
-  RunFromRectsBenchmark<DlRegionAdapter>(state, maxSize);
+static void BM_DlRegion_FromRects(benchmark::State& state,
+                                  int maxSize,
+                                  int rectCount = 2000) {
+  RunFromRectsBenchmark<DlRegionAdapter>(state, maxSize, rectCount);
+}
+
+static void BM_SkRegion_FromRects(benchmark::State& state,
+                                  int maxSize,
+                                  int rectCount = 2000) {
+  RunFromRectsBenchmark<SkRegionAdapter>(state, maxSize, rectCount);
+}
+
+static void BM_DlRegion_AddRects(benchmark::State& state,
+                                 int maxSize,
+                                 int rectCount) {
+  RunAddRectsBenchmark<DlRegionAdapter>(state, maxSize, rectCount);
 }
 
-static void BM_SkRegion_FromRects(benchmark::State& state, int maxSize) {
-  RunFromRectsBenchmark<SkRegionAdapter>(state, maxSize);
+static void BM_SkRegion_AddRects(benchmark::State& state,
+                                 int maxSize,
+                                 int rectCount) {
+  RunAddRectsBenchmark<SkRegionAdapter>(state, maxSize, rectCount);
 }
 
 static void BM_DlRegion_GetRects(benchmark::State& state, int maxSize) {
@@ -277,18 +385,20 @@ static void BM_DlRegion_Operation(benchmark::State& state,
                                   RegionOp op,
                                   bool withSingleRect,
                                   int maxSize,
-                                  double sizeFactor) {
+                                  double sizeFactor,
+                                  int rectCount = 500) {
   RunRegionOpBenchmark<DlRegionAdapter>(state, op, withSingleRect, maxSize,
-                                        sizeFactor);
+                                        sizeFactor, rectCount);
 }
 
 static void BM_SkRegion_Operation(benchmark::State& state,
                                   RegionOp op,
                                   bool withSingleRect,
                                   int maxSize,
-                                  double sizeFactor) {
+                                  double sizeFactor,
+                                  int rectCount = 500) {
   RunRegionOpBenchmark<SkRegionAdapter>(state, op, withSingleRect, maxSize,
-                                        sizeFactor);
+                                        sizeFactor, rectCount);
 }
 
 static void BM_DlRegion_IntersectsRegion(benchmark::State& state,
@@ -313,6 +423,18 @@ static void BM_SkRegion_IntersectsSingleRect(benchmark::State& state,
   RunIntersectsSingleRectBenchmark<SkRegionAdapter>(state, maxSize);
 }
 
+static void BM_DlRTree_Build(benchmark::State& state, bool shuffle) {
+  RunRTreeBuildBenchmark(state, shuffle);
+}
+
+static void BM_DlRTree_Search(benchmark::State& state, bool shuffle) {
+  RunRTreeSearchBenchmark(state, shuffle, false);
+}
+
+static void BM_DlRTree_SearchBatch(benchmark::State& state, bool shuffle) {
+  RunRTreeSearchBenchmark(state, shuffle, true);
+}
+
 const double kSizeFactorSmall = 0.3;
 
 BENCHMARK_CAPTURE(BM_DlRegion_IntersectsSingleRect, Tiny, 30)
@@ -692,6 +814,53 @@ BENCHMARK_CAPTURE(BM_DlRegion_FromRects, Large, 1500)
 BENCHMARK_CAPTURE(BM_SkRegion_FromRects, Large, 1500)
     ->Unit(benchmark::kMicrosecond);
 
+// 10k rect inputs, which is the size of the damage and culling regions of
+// large scrolling display lists.
+BENCHMARK_CAPTURE(BM_DlRegion_FromRects, Small_10k, 100, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_FromRects, Small_10k, 100, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRegion_FromRects, Large_10k, 1500, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_FromRects, Large_10k, 1500, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRegion_AddRects, Small_10k, 100, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_AddRects, Small_10k, 100, 10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRegion_Operation,
+                  Union_Small_10k,
+                  RegionOp::kUnion,
+                  false,
+                  100,
+                  1.0,
+                  10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_Operation,
+                  Union_Small_10k,
+                  RegionOp::kUnion,
+                  false,
+                  100,
+                  1.0,
+                  10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRegion_Operation,
+                  Intersection_Small_10k,
+                  RegionOp::kIntersection,
+                  false,
+                  100,
+                  1.0,
+                  10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_Operation,
+                  Intersection_Small_10k,
+                  RegionOp::kIntersection,
+                  false,
+                  100,
+                  1.0,
+                  10000)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_CAPTURE(BM_DlRegion_GetRects, Tiny, 30)
     ->Unit(benchmark::kMicrosecond);
 BENCHMARK_CAPTURE(BM_SkRegion_GetRects, Tiny, 30)
@@ -709,4 +878,29 @@ BENCHMARK_CAPTURE(BM_DlRegion_GetRects, Large, 1500)
 BENCHMARK_CAPTURE(BM_SkRegion_GetRects, Large, 1500)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_CAPTURE(BM_DlRTree_Build, InOrder, false)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Build, Shuffled, true)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search, InOrder, false)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search, Shuffled, true)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_SearchBatch, InOrder, false)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_SearchBatch, Shuffled, true)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
\ No newline at end of file
@@ -0,0 +1,159 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays display lists captured with --capture-display-lists as benchmarks,
+// so that production frames can be measured offline:
+//
+//   display_list_replay_benchmarks --dl-capture-dir=<dir> [benchmark flags]
+//
+// Every .dlb file in the directory is registered as a benchmark that loads
+// it, one that replays it into a raster SkCanvas through a
+// DlSkCanvasDispatcher and, if Impeller is available, one that records it into
+// an Impeller picture through a DlDispatcher. The ops are dispatched straight
+// from the mapped file.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "flutter/display_list/skia/dl_sk_dispatcher.h"
+#include "flutter/display_list/utils/dl_binary_reader.h"
+#include "flutter/fml/backtrace.h"
+#include "flutter/fml/command_line.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "txt/platform.h"
+
+#ifdef IMPELLER_SUPPORTS_RENDERING
+#include "flutter/impeller/display_list/dl_dispatcher.h"  // nogncheck
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
+namespace flutter {
+namespace {
+
+constexpr const char* kCaptureExtension = ".dlb";
+
+bool HasCaptureExtension(const std::string& filename) {
+  size_t length = strlen(kCaptureExtension);
+  return filename.size() > length &&
+         filename.compare(filename.size() - length, length,
+                          kCaptureExtension) == 0;
+}
+
+std::shared_ptr<DlBinaryReader> CreateReader(
+    const std::shared_ptr<fml::Mapping>& mapping) {
+  auto reader =
+      std::make_shared<DlBinaryReader>(mapping, txt::GetDefaultFontManager());
+  return reader->IsValid() ? reader : nullptr;
+}
+
+SkISize SurfaceSize(const DlBinaryReader& reader) {
+  SkIRect bounds = reader.bounds().roundOut();
+  return SkISize::Make(std::max(bounds.right(), 1),
+                       std::max(bounds.bottom(), 1));
+}
+
+void BM_Load(benchmark::State& state, std::shared_ptr<fml::Mapping> mapping) {
+  for (auto _ : state) {
+    auto reader = CreateReader(mapping);
+    benchmark::DoNotOptimize(reader->Build());
+  }
+  state.SetBytesProcessed(state.iterations() * mapping->GetSize());
+}
+
+void BM_ReplayToSkia(benchmark::State& state,
+                     std::shared_ptr<fml::Mapping> mapping) {
+  auto reader = CreateReader(mapping);
+  SkISize size = SurfaceSize(*reader);
+  auto surface = SkSurfaces::Raster(
+      SkImageInfo::MakeN32Premul(size.width(), size.height()));
+  for (auto _ : state) {
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    DlSkCanvasDispatcher dispatcher(canvas);
+    canvas->save();
+    reader->Dispatch(dispatcher);
+    canvas->restore();
+  }
+  state.counters["Ops"] = reader->op_count();
+}
+
+#ifdef IMPELLER_SUPPORTS_RENDERING
+void BM_ReplayToImpeller(benchmark::State& state,
+                         std::shared_ptr<fml::Mapping> mapping) {
+  auto reader = CreateReader(mapping);
+  SkISize size = SurfaceSize(*reader);
+  for (auto _ : state) {
+    impeller::DlDispatcher dispatcher(
+        impeller::IRect::MakeWH(size.width(), size.height()));
+    reader->Dispatch(dispatcher);
+    benchmark::DoNotOptimize(dispatcher.EndRecordingAsPicture());
+  }
+  state.counters["Ops"] = reader->op_count();
+}
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
+void RegisterCapture(const std::string& name,
+                     std::shared_ptr<fml::Mapping> mapping) {
+  if (!CreateReader(mapping)) {
+    FML_LOG(ERROR) << "Skipping " << name
+                   << ", it is not a valid display list capture.";
+    return;
+  }
+  benchmark::RegisterBenchmark(("BM_Load/" + name).c_str(), BM_Load, mapping)
+      ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark(("BM_ReplayToSkia/" + name).c_str(),
+                               BM_ReplayToSkia, mapping)
+      ->Unit(benchmark::kMicrosecond);
+#ifdef IMPELLER_SUPPORTS_RENDERING
+  benchmark::RegisterBenchmark(("BM_ReplayToImpeller/" + name).c_str(),
+                               BM_ReplayToImpeller, mapping)
+      ->Unit(benchmark::kMicrosecond);
+#endif  // IMPELLER_SUPPORTS_RENDERING
+}
+
+}  // namespace
+}  // namespace flutter
+
+int main(int argc, char** argv) {
+  fml::InstallCrashHandler();
+  fml::CommandLine command_line = fml::CommandLineFromArgcArgv(argc, argv);
+  std::string capture_dir;
+  if (!command_line.GetOptionValue("dl-capture-dir", &capture_dir)) {
+    FML_LOG(ERROR) << "Usage: " << argv[0]
+                   << " --dl-capture-dir=<dir> [benchmark flags]";
+    return 1;
+  }
+
+  fml::UniqueFD directory = fml::OpenDirectory(capture_dir.c_str(), false,
+                                               fml::FilePermission::kRead);
+  if (!directory.is_valid()) {
+    FML_LOG(ERROR) << "Could not open " << capture_dir;
+    return 1;
+  }
+  std::vector<std::string> filenames;
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& directory,
+                                 const std::string& filename) {
+    if (flutter::HasCaptureExtension(filename)) {
+      filenames.push_back(filename);
+    }
+    return true;
+  });
+  std::sort(filenames.begin(), filenames.end());
+  for (const auto& filename : filenames) {
+    std::shared_ptr<fml::Mapping> mapping =
+        fml::FileMapping::CreateReadOnly(directory, filename);
+    if (mapping) {
+      flutter::RegisterCapture(filename, std::move(mapping));
+    }
+  }
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
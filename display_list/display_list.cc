@@ -6,6 +6,7 @@
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/dl_op_records.h"
+#include "flutter/display_list/utils/dl_comparable.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -24,11 +25,13 @@ DisplayList::DisplayList()
       bounds_({0, 0, 0, 0}),
       can_apply_group_opacity_(true),
       is_ui_thread_safe_(true),
+      has_texture_images_(false),
       modifies_transparent_black_(false),
       root_has_backdrop_filter_(false),
       max_root_blend_mode_(DlBlendMode::kClear) {}
 
 DisplayList::DisplayList(DisplayListStorage&& storage,
+                         DisplayListAttributes&& attributes,
                          size_t byte_count,
                          uint32_t op_count,
                          size_t nested_byte_count,
@@ -37,11 +40,13 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
                          const SkRect& bounds,
                          bool can_apply_group_opacity,
                          bool is_ui_thread_safe,
+                         bool has_texture_images,
                          bool modifies_transparent_black,
                          DlBlendMode max_root_blend_mode,
                          bool root_has_backdrop_filter,
                          sk_sp<const DlRTree> rtree)
     : storage_(std::move(storage)),
+      attributes_(std::move(attributes)),
       byte_count_(byte_count),
       op_count_(op_count),
       nested_byte_count_(nested_byte_count),
@@ -51,6 +56,7 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
       bounds_(bounds),
       can_apply_group_opacity_(can_apply_group_opacity),
       is_ui_thread_safe_(is_ui_thread_safe),
+      has_texture_images_(has_texture_images),
       modifies_transparent_black_(modifies_transparent_black),
       root_has_backdrop_filter_(root_has_backdrop_filter),
       max_root_blend_mode_(max_root_blend_mode),
@@ -70,19 +76,18 @@ uint32_t DisplayList::next_unique_id() {
   return id;
 }
 
-class Culler {
- public:
-  virtual ~Culler() = default;
-  virtual bool init(DispatchContext& context) = 0;
-  virtual void update(DispatchContext& context) = 0;
-};
-class NopCuller final : public Culler {
- public:
-  static NopCuller instance;
+namespace {
 
-  ~NopCuller() = default;
-
-  bool init(DispatchContext& context) override {
+// Cullers tell the dispatch loop which rendering ops to execute. They are
+// not virtual, the loop is instantiated for each of them instead so that the
+// per-op bookkeeping can be inlined, which makes it free for NopCuller.
+//
+// A DrawRectsOp holds a run of rects that occupy one op index each.
+// NopCuller hands the whole run to the receiver at once, a culler that
+// tracks op indices has to dispatch the rects one at a time.
+class NopCuller final {
+ public:
+  bool init(DispatchContext& context) {
     // Setting next_render_index to 0 means that
     // all rendering ops will be at or after that
     // index so they will execute and all restore
@@ -91,17 +96,17 @@ class NopCuller final : public Culler {
     context.next_render_index = 0;
     return true;
   }
-  void update(DispatchContext& context) override {}
+  template <typename T>
+  void dispatch(const T* op, DispatchContext& context) {
+    op->dispatch(context);
+  }
 };
-NopCuller NopCuller::instance = NopCuller();
-class VectorCuller final : public Culler {
+class VectorCuller final {
  public:
   VectorCuller(const DlRTree* rtree, const std::vector<int>& rect_indices)
       : rtree_(rtree), cur_(rect_indices.begin()), end_(rect_indices.end()) {}
 
-  ~VectorCuller() = default;
-
-  bool init(DispatchContext& context) override {
+  bool init(DispatchContext& context) {
     if (cur_ < end_) {
       context.next_render_index = rtree_->id(*cur_++);
       return true;
@@ -120,7 +125,23 @@ class VectorCuller final : public Culler {
       return false;
     }
   }
-  void update(DispatchContext& context) override {
+  template <typename T>
+  void dispatch(const T* op, DispatchContext& context) {
+    op->dispatch(context);
+    update(context);
+  }
+  void dispatch(const DrawRectsOp* op, DispatchContext& context) {
+    const SkRect* rects = op->rects();
+    for (uint32_t i = 0; i < op->count; i++) {
+      if (op->op_needed(context)) {
+        context.receiver.drawRect(rects[i]);
+      }
+      update(context);
+    }
+  }
+
+ private:
+  void update(DispatchContext& context) {
     if (++context.cur_index > context.next_render_index) {
       while (cur_ < end_) {
         context.next_render_index = rtree_->id(*cur_++);
@@ -141,46 +162,20 @@ class VectorCuller final : public Culler {
     }
   }
 
- private:
   const DlRTree* rtree_;
   std::vector<int>::const_iterator cur_;
   std::vector<int>::const_iterator end_;
 };
 
-void DisplayList::Dispatch(DlOpReceiver& receiver) const {
-  const uint8_t* ptr = storage_.get();
-  Dispatch(receiver, ptr, ptr + byte_count_, NopCuller::instance);
-}
-
-void DisplayList::Dispatch(DlOpReceiver& receiver,
-                           const SkIRect& cull_rect) const {
-  Dispatch(receiver, SkRect::Make(cull_rect));
-}
-
-void DisplayList::Dispatch(DlOpReceiver& receiver,
-                           const SkRect& cull_rect) const {
-  if (cull_rect.isEmpty()) {
-    return;
-  }
-  if (!has_rtree() || cull_rect.contains(bounds())) {
-    Dispatch(receiver);
-    return;
-  }
-  const DlRTree* rtree = this->rtree().get();
-  FML_DCHECK(rtree != nullptr);
-  const uint8_t* ptr = storage_.get();
-  std::vector<int> rect_indices;
-  rtree->search(cull_rect, &rect_indices);
-  VectorCuller culler(rtree, rect_indices);
-  Dispatch(receiver, ptr, ptr + byte_count_, culler);
-}
-
-void DisplayList::Dispatch(DlOpReceiver& receiver,
-                           const uint8_t* ptr,
-                           const uint8_t* end,
-                           Culler& culler) const {
+template <class C>
+void DispatchOps(DlOpReceiver& receiver,
+                 const DisplayListAttributes& attributes,
+                 const uint8_t* ptr,
+                 const uint8_t* end,
+                 C& culler) {
   DispatchContext context = {
       .receiver = receiver,
+      .attributes = attributes,
       .cur_index = 0,
       // next_render_index will be initialized by culler.init()
       .next_restore_index = std::numeric_limits<int>::max(),
@@ -193,15 +188,12 @@ void DisplayList::Dispatch(DlOpReceiver& receiver,
     ptr += op->size;
     FML_DCHECK(ptr <= end);
     switch (op->type) {
-#define DL_OP_DISPATCH(name)                             \
-  case DisplayListOpType::k##name:                       \
-    static_cast<const name##Op*>(op)->dispatch(context); \
+#define DL_OP_DISPATCH(name)                                    \
+  case DisplayListOpType::k##name:                              \
+    culler.dispatch(static_cast<const name##Op*>(op), context); \
     break;
 
       FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
-#ifdef IMPELLER_ENABLE_3D
-      DL_OP_DISPATCH(SetSceneColorSource)
-#endif  // IMPELLER_ENABLE_3D
 
 #undef DL_OP_DISPATCH
 
@@ -209,10 +201,40 @@ void DisplayList::Dispatch(DlOpReceiver& receiver,
         FML_DCHECK(false);
         return;
     }
-    culler.update(context);
   }
 }
 
+}  // namespace
+
+void DisplayList::Dispatch(DlOpReceiver& receiver) const {
+  const uint8_t* ptr = storage_.get();
+  NopCuller culler;
+  DispatchOps(receiver, attributes_, ptr, ptr + byte_count_, culler);
+}
+
+void DisplayList::Dispatch(DlOpReceiver& receiver,
+                           const SkIRect& cull_rect) const {
+  Dispatch(receiver, SkRect::Make(cull_rect));
+}
+
+void DisplayList::Dispatch(DlOpReceiver& receiver,
+                           const SkRect& cull_rect) const {
+  if (cull_rect.isEmpty()) {
+    return;
+  }
+  if (!has_rtree() || cull_rect.contains(bounds())) {
+    Dispatch(receiver);
+    return;
+  }
+  const DlRTree* rtree = this->rtree().get();
+  FML_DCHECK(rtree != nullptr);
+  const uint8_t* ptr = storage_.get();
+  std::vector<int> rect_indices;
+  rtree->search(cull_rect, &rect_indices);
+  VectorCuller culler(rtree, rect_indices);
+  DispatchOps(receiver, attributes_, ptr, ptr + byte_count_, culler);
+}
+
 void DisplayList::DisposeOps(const uint8_t* ptr, const uint8_t* end) {
   while (ptr < end) {
     auto op = reinterpret_cast<const DLOp*>(ptr);
@@ -227,9 +249,6 @@ void DisplayList::DisposeOps(const uint8_t* ptr, const uint8_t* end) {
     break;
 
       FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPOSE)
-#ifdef IMPELLER_ENABLE_3D
-      DL_OP_DISPOSE(SetSceneColorSource)
-#endif  // IMPELLER_ENABLE_3D
 
 #undef DL_OP_DISPOSE
 
@@ -267,9 +286,6 @@ static bool CompareOps(const uint8_t* ptrA,
     break;
 
       FOR_EACH_DISPLAY_LIST_OP(DL_OP_EQUALS)
-#ifdef IMPELLER_ENABLE_3D
-      DL_OP_EQUALS(SetSceneColorSource)
-#endif  // IMPELLER_ENABLE_3D
 
 #undef DL_OP_EQUALS
 
@@ -308,6 +324,35 @@ static bool CompareOps(const uint8_t* ptrA,
   return true;
 }
 
+// The builder adds the attributes to the tables in the order in which the
+// ops first refer to them, so two DisplayLists whose ops compare equal
+// refer to equal attributes iff their tables are equal entry by entry.
+template <typename T>
+static bool CompareAttributes(
+    const std::vector<std::shared_ptr<const T>>& tableA,
+    const std::vector<std::shared_ptr<const T>>& tableB) {
+  if (tableA.size() != tableB.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < tableA.size(); i++) {
+    if (NotEquals(tableA[i], tableB[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool CompareAttributes(const DisplayListAttributes& attributesA,
+                              const DisplayListAttributes& attributesB) {
+  return CompareAttributes(attributesA.color_sources,
+                           attributesB.color_sources) &&
+         CompareAttributes(attributesA.color_filters,
+                           attributesB.color_filters) &&
+         CompareAttributes(attributesA.image_filters,
+                           attributesB.image_filters) &&
+         CompareAttributes(attributesA.mask_filters, attributesB.mask_filters);
+}
+
 bool DisplayList::Equals(const DisplayList* other) const {
   if (this == other) {
     return true;
@@ -320,7 +365,9 @@ bool DisplayList::Equals(const DisplayList* other) const {
   if (ptr == o_ptr) {
     return true;
   }
-  return CompareOps(ptr, ptr + byte_count_, o_ptr, o_ptr + other->byte_count_);
+  return CompareOps(ptr, ptr + byte_count_, o_ptr,
+                    o_ptr + other->byte_count_) &&
+         CompareAttributes(attributes_, other->attributes_);
 }
 
 }  // namespace flutter
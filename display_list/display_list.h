@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/display_list/dl_blend_mode.h"
 #include "flutter/display_list/dl_sampling_options.h"
@@ -70,19 +71,16 @@ namespace flutter {
   V(SetBlendMode)                   \
                                     \
   V(ClearColorFilter)               \
-  V(SetPodColorFilter)              \
+  V(SetColorFilter)                 \
                                     \
   V(ClearColorSource)               \
-  V(SetPodColorSource)              \
-  V(SetImageColorSource)            \
-  V(SetRuntimeEffectColorSource)    \
+  V(SetColorSource)                 \
                                     \
   V(ClearImageFilter)               \
-  V(SetPodImageFilter)              \
-  V(SetSharedImageFilter)           \
+  V(SetImageFilter)                 \
                                     \
   V(ClearMaskFilter)                \
-  V(SetPodMaskFilter)               \
+  V(SetMaskFilter)                  \
                                     \
   V(Save)                           \
   V(SaveLayer)                      \
@@ -109,7 +107,7 @@ namespace flutter {
                                     \
   V(DrawLine)                       \
   V(DrawDashedLine)                 \
-  V(DrawRect)                       \
+  V(DrawRects)                      \
   V(DrawOval)                       \
   V(DrawCircle)                     \
   V(DrawRRect)                      \
@@ -140,14 +138,15 @@ namespace flutter {
 #define DL_OP_TO_ENUM_VALUE(name) k##name,
 enum class DisplayListOpType {
   FOR_EACH_DISPLAY_LIST_OP(DL_OP_TO_ENUM_VALUE)
-#ifdef IMPELLER_ENABLE_3D
-      DL_OP_TO_ENUM_VALUE(SetSceneColorSource)
-#endif  // IMPELLER_ENABLE_3D
 };
 #undef DL_OP_TO_ENUM_VALUE
 
 class DlOpReceiver;
 class DisplayListBuilder;
+class DlColorSource;
+class DlColorFilter;
+class DlImageFilter;
+class DlMaskFilter;
 
 class SaveLayerOptions {
  public:
@@ -260,7 +259,15 @@ class DisplayListStorage {
   std::unique_ptr<uint8_t, FreeDeleter> ptr_;
 };
 
-class Culler;
+// The color sources and filters used by a DisplayList. The attribute ops
+// refer to them by index so that each distinct object is stored only once,
+// no matter how many times the DisplayList switches back to it.
+struct DisplayListAttributes {
+  std::vector<std::shared_ptr<const DlColorSource>> color_sources;
+  std::vector<std::shared_ptr<const DlColorFilter>> color_filters;
+  std::vector<std::shared_ptr<const DlImageFilter>> image_filters;
+  std::vector<std::shared_ptr<const DlMaskFilter>> mask_filters;
+};
 
 // The base class that contains a sequence of rendering operations
 // for dispatch to a DlOpReceiver. These objects must be instantiated
@@ -305,6 +312,14 @@ class DisplayList : public SkRefCnt {
   bool can_apply_group_opacity() const { return can_apply_group_opacity_; }
   bool isUIThreadSafe() const { return is_ui_thread_safe_; }
 
+  /// @brief    Indicates if any image drawn by this DisplayList, directly,
+  ///           through a color source, or in a nested DisplayList, is
+  ///           backed by a GPU texture.
+  ///
+  /// DisplayLists without texture images only touch CPU memory when they
+  /// are rendered to a raster surface and so may be rendered on any thread.
+  bool has_texture_images() const { return has_texture_images_; }
+
   /// @brief     Indicates if there are any rendering operations in this
   ///            DisplayList that will modify a surface of transparent black
   ///            pixels.
@@ -340,6 +355,7 @@ class DisplayList : public SkRefCnt {
 
  private:
   DisplayList(DisplayListStorage&& ptr,
+              DisplayListAttributes&& attributes,
               size_t byte_count,
               uint32_t op_count,
               size_t nested_byte_count,
@@ -348,6 +364,7 @@ class DisplayList : public SkRefCnt {
               const SkRect& bounds,
               bool can_apply_group_opacity,
               bool is_ui_thread_safe,
+              bool has_texture_images,
               bool modifies_transparent_black,
               DlBlendMode max_root_blend_mode,
               bool root_has_backdrop_filter,
@@ -358,6 +375,7 @@ class DisplayList : public SkRefCnt {
   static void DisposeOps(const uint8_t* ptr, const uint8_t* end);
 
   const DisplayListStorage storage_;
+  const DisplayListAttributes attributes_;
   const size_t byte_count_;
   const uint32_t op_count_;
 
@@ -371,17 +389,13 @@ class DisplayList : public SkRefCnt {
 
   const bool can_apply_group_opacity_;
   const bool is_ui_thread_safe_;
+  const bool has_texture_images_;
   const bool modifies_transparent_black_;
   const bool root_has_backdrop_filter_;
   const DlBlendMode max_root_blend_mode_;
 
   const sk_sp<const DlRTree> rtree_;
 
-  void Dispatch(DlOpReceiver& ctx,
-                const uint8_t* ptr,
-                const uint8_t* end,
-                Culler& culler) const;
-
   friend class DisplayListBuilder;
 };
 
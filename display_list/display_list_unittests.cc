@@ -12,6 +12,7 @@
 #include "flutter/display_list/dl_blend_mode.h"
 #include "flutter/display_list/dl_builder.h"
 #include "flutter/display_list/dl_paint.h"
+#include "flutter/display_list/effects/dl_runtime_effect.h"
 #include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/display_list/skia/dl_sk_dispatcher.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
@@ -27,6 +28,7 @@
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "third_party/skia/include/core/SkRSXform.h"
 #include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkRuntimeEffect.h"
 
 namespace flutter {
 
@@ -261,6 +263,83 @@ TEST_F(DisplayListTest, BuilderCanBeReused) {
   ASSERT_TRUE(dl->Equals(dl2));
 }
 
+TEST_F(DisplayListTest, RasterImagesAreNotTextureImages) {
+  DisplayListBuilder builder(kTestBounds);
+  builder.DrawRect(kTestBounds, DlPaint());
+  EXPECT_FALSE(builder.Build()->has_texture_images());
+
+  ASSERT_FALSE(TestImage1->isTextureBacked());
+  builder.DrawImage(TestImage1, SkPoint::Make(0, 0),
+                    DlImageSampling::kNearestNeighbor);
+  auto nested = builder.Build();
+  EXPECT_FALSE(nested->has_texture_images());
+
+  builder.DrawDisplayList(nested);
+  EXPECT_FALSE(builder.Build()->has_texture_images());
+}
+
+namespace {
+// A stand-in for an image that lives in a GPU texture, which the raster
+// cache must not rasterize away from the raster thread.
+class TestTextureImage final : public DlImage {
+ public:
+  sk_sp<SkImage> skia_image() const override { return nullptr; }
+  std::shared_ptr<impeller::Texture> impeller_texture() const override {
+    return nullptr;
+  }
+  bool isOpaque() const override { return false; }
+  bool isTextureBacked() const override { return true; }
+  bool isUIThreadSafe() const override { return true; }
+  SkISize dimensions() const override { return SkISize::Make(10, 10); }
+  size_t GetApproximateByteSize() const override { return sizeof(*this); }
+};
+}  // namespace
+
+TEST_F(DisplayListTest, ImageColorSourcesReportTextureImages) {
+  auto image = sk_make_sp<TestTextureImage>();
+  DlImageColorSource source(image, DlTileMode::kClamp, DlTileMode::kClamp);
+
+  DisplayListBuilder builder(kTestBounds);
+  builder.DrawRect(kTestBounds, DlPaint().setColorSource(&source));
+  auto nested = builder.Build();
+  EXPECT_TRUE(nested->has_texture_images());
+
+  builder.DrawDisplayList(nested);
+  EXPECT_TRUE(builder.Build()->has_texture_images());
+}
+
+TEST_F(DisplayListTest, RuntimeEffectSamplersReportTextureImages) {
+  SkString sksl("uniform shader s; vec4 main(vec2 p) { return s.eval(p); }");
+  auto effect =
+      DlRuntimeEffect::MakeSkia(SkRuntimeEffect::MakeForShader(sksl).effect);
+  auto raster_sampler = std::make_shared<DlImageColorSource>(
+      TestImage1, DlTileMode::kClamp, DlTileMode::kClamp);
+  auto texture_sampler = std::make_shared<DlImageColorSource>(
+      sk_make_sp<TestTextureImage>(), DlTileMode::kClamp, DlTileMode::kClamp);
+  auto uniforms = std::make_shared<std::vector<uint8_t>>();
+
+  DisplayListBuilder builder(kTestBounds);
+  auto raster_source =
+      DlColorSource::MakeRuntimeEffect(effect, {raster_sampler}, uniforms);
+  builder.DrawRect(kTestBounds, DlPaint().setColorSource(raster_source));
+  EXPECT_FALSE(builder.Build()->has_texture_images());
+
+  auto texture_source =
+      DlColorSource::MakeRuntimeEffect(effect, {texture_sampler}, uniforms);
+  builder.DrawRect(kTestBounds, DlPaint().setColorSource(texture_source));
+  EXPECT_TRUE(builder.Build()->has_texture_images());
+
+  // A runtime effect can sample another runtime effect.
+  auto outer_source =
+      DlColorSource::MakeRuntimeEffect(effect, {texture_source}, uniforms);
+  builder.DrawRect(kTestBounds, DlPaint().setColorSource(outer_source));
+  auto nested = builder.Build();
+  EXPECT_TRUE(nested->has_texture_images());
+
+  builder.DrawDisplayList(nested);
+  EXPECT_TRUE(builder.Build()->has_texture_images());
+}
+
 TEST_F(DisplayListTest, SaveRestoreRestoresTransform) {
   SkRect cull_rect = SkRect::MakeLTRB(-10.0f, -10.0f, 500.0f, 500.0f);
   DisplayListBuilder builder(cull_rect);
@@ -4724,5 +4803,131 @@ TEST_F(DisplayListTest, RecordLargeVertices) {
   }
 }
 
+class RectRunRecorder : public virtual DlOpReceiver,
+                        public IgnoreAttributeDispatchHelper,
+                        public IgnoreClipDispatchHelper,
+                        public IgnoreTransformDispatchHelper,
+                        public IgnoreDrawDispatchHelper {
+ public:
+  void setColorSource(const DlColorSource* source) override {
+    color_sources_.push_back(source);
+  }
+  void drawRect(const SkRect& rect) override { rects_.push_back(rect); }
+  void drawRects(const SkRect rects[], uint32_t count) override {
+    runs_.push_back(count);
+    DlOpReceiver::drawRects(rects, count);
+  }
+
+  const std::vector<const DlColorSource*>& color_sources() const {
+    return color_sources_;
+  }
+  const std::vector<SkRect>& rects() const { return rects_; }
+  const std::vector<uint32_t>& runs() const { return runs_; }
+
+ private:
+  std::vector<const DlColorSource*> color_sources_;
+  std::vector<SkRect> rects_;
+  std::vector<uint32_t> runs_;
+};
+
+TEST_F(DisplayListTest, ConsecutiveRectsShareOneOp) {
+  DisplayListBuilder builder;
+  DlOpReceiver& receiver = ToReceiver(builder);
+  receiver.drawRect({0, 0, 10, 10});
+  receiver.drawRect({10, 0, 20, 10});
+  receiver.drawRect({20, 0, 30, 10});
+  EXPECT_EQ(DisplayListBuilderTestingLastOpIndex(builder), 2);
+  auto display_list = builder.Build();
+
+  EXPECT_EQ(display_list->op_count(), 3u);
+  EXPECT_EQ(display_list->total_depth(), 3u);
+  // One 8 byte op header followed by 16 bytes for each rect.
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 8u + 3u * 16u);
+
+  RectRunRecorder recorder;
+  display_list->Dispatch(recorder);
+  EXPECT_EQ(recorder.runs(), std::vector<uint32_t>({3u}));
+  EXPECT_EQ(recorder.rects(), std::vector<SkRect>({
+                                  {0, 0, 10, 10},
+                                  {10, 0, 20, 10},
+                                  {20, 0, 30, 10},
+                              }));
+}
+
+TEST_F(DisplayListTest, RectsSeparatedByOtherOpsDoNotShareAnOp) {
+  DisplayListBuilder builder;
+  DlOpReceiver& receiver = ToReceiver(builder);
+  receiver.drawRect({0, 0, 10, 10});
+  receiver.setColor(DlColor::kBlue());
+  receiver.drawRect({10, 0, 20, 10});
+  auto display_list = builder.Build();
+
+  EXPECT_EQ(display_list->op_count(), 2u);
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 24u + 8u + 24u);
+
+  RectRunRecorder recorder;
+  display_list->Dispatch(recorder);
+  EXPECT_TRUE(recorder.runs().empty());
+  EXPECT_EQ(recorder.rects(), std::vector<SkRect>({
+                                  {0, 0, 10, 10},
+                                  {10, 0, 20, 10},
+                              }));
+}
+
+TEST_F(DisplayListTest, CulledDispatchSkipsRectsInsideARun) {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  DlOpReceiver& receiver = ToReceiver(builder);
+  for (int i = 0; i < 10; i++) {
+    receiver.drawRect(SkRect::MakeXYWH(i * 20, 0, 10, 10));
+  }
+  auto display_list = builder.Build();
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 8u + 10u * 16u);
+
+  RectRunRecorder recorder;
+  display_list->Dispatch(recorder, SkRect::MakeLTRB(45, 0, 65, 10));
+  EXPECT_EQ(recorder.rects(), std::vector<SkRect>({
+                                  SkRect::MakeXYWH(40, 0, 10, 10),
+                                  SkRect::MakeXYWH(60, 0, 10, 10),
+                              }));
+}
+
+TEST_F(DisplayListTest, RepeatedColorSourceIsStoredOnce) {
+  DisplayListBuilder builder;
+  DlOpReceiver& receiver = ToReceiver(builder);
+  receiver.setColorSource(kTestSource2.get());
+  receiver.drawRect({0, 0, 10, 10});
+  receiver.setColorSource(kTestSource3.get());
+  receiver.drawRect({10, 0, 20, 10});
+  receiver.setColorSource(kTestSource2->shared().get());
+  receiver.drawRect({20, 0, 30, 10});
+  auto display_list = builder.Build();
+
+  // Each SetColorSourceOp is an 8 byte index, whatever the size of the
+  // gradient it refers to.
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 3u * (8u + 24u));
+
+  RectRunRecorder recorder;
+  display_list->Dispatch(recorder);
+  ASSERT_EQ(recorder.color_sources().size(), 3u);
+  EXPECT_TRUE(Equals(recorder.color_sources()[0], kTestSource2.get()));
+  EXPECT_TRUE(Equals(recorder.color_sources()[1], kTestSource3.get()));
+  EXPECT_EQ(recorder.color_sources()[2], recorder.color_sources()[0]);
+}
+
+TEST_F(DisplayListTest, AttributesAreComparedByValue) {
+  auto build = [](const DlColorSource* source) {
+    DisplayListBuilder builder;
+    DlOpReceiver& receiver = ToReceiver(builder);
+    receiver.setColorSource(source);
+    receiver.drawRect({0, 0, 10, 10});
+    return builder.Build();
+  };
+  auto display_list = build(kTestSource2.get());
+
+  // Both refer to the first entry of their color source table.
+  EXPECT_TRUE(display_list->Equals(build(kTestSource2->shared().get())));
+  EXPECT_FALSE(display_list->Equals(build(kTestSource3.get())));
+}
+
 }  // namespace testing
 }  // namespace flutter
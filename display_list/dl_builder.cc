@@ -39,21 +39,29 @@ static constexpr inline bool is_power_of_two(int value) {
   return (value & (value - 1)) == 0;
 }
 
-template <typename T, typename... Args>
-void* DisplayListBuilder::Push(size_t pod, Args&&... args) {
-  size_t size = SkAlignPtr(sizeof(T) + pod);
-  FML_CHECK(size < (1 << 24));
+void DisplayListBuilder::Reserve(size_t size) {
   if (used_ + size > allocated_) {
     static_assert(is_power_of_two(DL_BUILDER_PAGE),
                   "This math needs updating for non-pow2.");
-    // Next greater multiple of DL_BUILDER_PAGE.
-    allocated_ = (used_ + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
+    // Grow geometrically so that recording large display lists does not
+    // copy the ops a quadratic number of times; Build() trims the storage
+    // to the bytes actually used. Next greater multiple of DL_BUILDER_PAGE.
+    size_t target = std::max(used_ + size, allocated_ * 2);
+    allocated_ = (target + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
     storage_.realloc(allocated_);
     FML_CHECK(storage_.get());
     memset(storage_.get() + used_, 0, allocated_ - used_);
   }
   FML_CHECK(used_ + size <= allocated_);
+}
+
+template <typename T, typename... Args>
+void* DisplayListBuilder::Push(size_t pod, Args&&... args) {
+  size_t size = SkAlignPtr(sizeof(T) + pod);
+  FML_CHECK(size < (1 << 24));
+  Reserve(size);
   auto op = reinterpret_cast<T*>(storage_.get() + used_);
+  last_op_offset_ = used_;
   used_ += size;
   new (op) T{std::forward<Args>(args)...};
   op->type = T::kType;
@@ -64,6 +72,30 @@ void* DisplayListBuilder::Push(size_t pod, Args&&... args) {
   return op + 1;
 }
 
+void DisplayListBuilder::PushDrawRect(const SkRect& rect) {
+  if (last_op_offset_ < used_) {
+    DLOp* last_op = reinterpret_cast<DLOp*>(storage_.get() + last_op_offset_);
+    if (last_op->type == DisplayListOpType::kDrawRects &&
+        last_op->size + sizeof(SkRect) < (1 << 24)) {
+      // Nothing has been recorded since the last run of rects, so the
+      // rect can join it and save the 8 bytes of a new op header.
+      Reserve(sizeof(SkRect));
+      auto op = reinterpret_cast<DrawRectsOp*>(storage_.get() +
+                                               last_op_offset_);
+      CopyV(storage_.get() + used_, &rect, 1);
+      used_ += sizeof(SkRect);
+      op->size += sizeof(SkRect);
+      op->count++;
+      render_op_count_ += DrawRectsOp::kRenderOpInc;
+      depth_ += DrawRectsOp::kDepthInc * render_op_depth_cost_;
+      op_index_++;
+      return;
+    }
+  }
+  void* pod = Push<DrawRectsOp>(sizeof(SkRect), 1u);
+  CopyV(pod, &rect, 1);
+}
+
 sk_sp<DisplayList> DisplayListBuilder::Build() {
   while (save_stack_.size() > 1) {
     restore();
@@ -76,6 +108,7 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   uint32_t total_depth = depth_;
   bool opacity_compatible = current_layer().is_group_opacity_compatible();
   bool is_safe = is_ui_thread_safe_;
+  bool has_texture_images = has_texture_images_;
   bool affects_transparency = current_layer().affects_transparent_layer;
   bool root_has_backdrop_filter = current_layer().contains_backdrop_filter;
   DlBlendMode max_root_blend_mode = current_layer().max_blend_mode;
@@ -96,10 +129,12 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
     bounds = current_layer().global_space_accumulator.bounds();
   }
 
-  used_ = allocated_ = render_op_count_ = op_index_ = 0;
+  used_ = allocated_ = last_op_offset_ = 0;
+  render_op_count_ = op_index_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
   depth_ = 0;
   is_ui_thread_safe_ = true;
+  has_texture_images_ = false;
   current_opacity_compatibility_ = true;
   render_op_depth_cost_ = 1u;
   current_ = DlPaint();
@@ -108,14 +143,32 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   Init(rtree != nullptr);
 
   storage_.realloc(bytes);
+  DisplayListAttributes attributes = std::move(attributes_);
+  attributes_ = DisplayListAttributes();
   return sk_sp<DisplayList>(new DisplayList(
-      std::move(storage_), bytes, count, nested_bytes, nested_count,
-      total_depth, bounds, opacity_compatible, is_safe, affects_transparency,
-      max_root_blend_mode, root_has_backdrop_filter, std::move(rtree)));
+      std::move(storage_), std::move(attributes), bytes, count, nested_bytes,
+      nested_count, total_depth, bounds, opacity_compatible, is_safe,
+      has_texture_images, affects_transparency, max_root_blend_mode,
+      root_has_backdrop_filter, std::move(rtree)));
 }
 
 static constexpr DlRect kEmpty = DlRect();
 
+static bool UsesTextureImage(const DlColorSource* source) {
+  if (const DlImageColorSource* image_source = source->asImage()) {
+    return image_source->image() && image_source->image()->isTextureBacked();
+  }
+  if (const DlRuntimeEffectColorSource* effect_source =
+          source->asRuntimeEffect()) {
+    for (const auto& sampler : effect_source->samplers()) {
+      if (sampler && UsesTextureImage(sampler.get())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 static const DlRect& ProtectEmpty(const SkRect& rect) {
   // isEmpty protects us against NaN while we normalize any empty cull rects
   return rect.isEmpty() ? kEmpty : ToDlRect(rect);
@@ -193,6 +246,20 @@ void DisplayListBuilder::onSetBlendMode(DlBlendMode mode) {
   UpdateCurrentOpacityCompatibility();
 }
 
+// Returns the index of the entry of |table| that is equal to |attribute|,
+// adding |attribute| to the end of the table if there is none yet.
+template <typename T>
+static uint32_t AttributeIndex(std::vector<std::shared_ptr<const T>>& table,
+                               std::shared_ptr<const T> attribute) {
+  for (size_t i = 0; i < table.size(); i++) {
+    if (Equals(table[i], attribute)) {
+      return i;
+    }
+  }
+  table.push_back(std::move(attribute));
+  return table.size() - 1;
+}
+
 void DisplayListBuilder::onSetColorSource(const DlColorSource* source) {
   if (source == nullptr) {
     current_.setColorSource(nullptr);
@@ -200,62 +267,15 @@ void DisplayListBuilder::onSetColorSource(const DlColorSource* source) {
   } else {
     current_.setColorSource(source->shared());
     is_ui_thread_safe_ = is_ui_thread_safe_ && source->isUIThreadSafe();
-    switch (source->type()) {
-      case DlColorSourceType::kColor: {
-        const DlColorColorSource* color_source = source->asColor();
-        current_.setColorSource(nullptr);
-        setColor(color_source->color());
-        break;
-      }
-      case DlColorSourceType::kImage: {
-        const DlImageColorSource* image_source = source->asImage();
-        FML_DCHECK(image_source);
-        Push<SetImageColorSourceOp>(0, image_source);
-        break;
-      }
-      case DlColorSourceType::kLinearGradient: {
-        const DlLinearGradientColorSource* linear = source->asLinearGradient();
-        FML_DCHECK(linear);
-        void* pod = Push<SetPodColorSourceOp>(linear->size());
-        new (pod) DlLinearGradientColorSource(linear);
-        break;
-      }
-      case DlColorSourceType::kRadialGradient: {
-        const DlRadialGradientColorSource* radial = source->asRadialGradient();
-        FML_DCHECK(radial);
-        void* pod = Push<SetPodColorSourceOp>(radial->size());
-        new (pod) DlRadialGradientColorSource(radial);
-        break;
-      }
-      case DlColorSourceType::kConicalGradient: {
-        const DlConicalGradientColorSource* conical =
-            source->asConicalGradient();
-        FML_DCHECK(conical);
-        void* pod = Push<SetPodColorSourceOp>(conical->size());
-        new (pod) DlConicalGradientColorSource(conical);
-        break;
-      }
-      case DlColorSourceType::kSweepGradient: {
-        const DlSweepGradientColorSource* sweep = source->asSweepGradient();
-        FML_DCHECK(sweep);
-        void* pod = Push<SetPodColorSourceOp>(sweep->size());
-        new (pod) DlSweepGradientColorSource(sweep);
-        break;
-      }
-      case DlColorSourceType::kRuntimeEffect: {
-        const DlRuntimeEffectColorSource* effect = source->asRuntimeEffect();
-        FML_DCHECK(effect);
-        Push<SetRuntimeEffectColorSourceOp>(0, effect);
-        break;
-      }
-#ifdef IMPELLER_ENABLE_3D
-      case DlColorSourceType::kScene: {
-        const DlSceneColorSource* scene = source->asScene();
-        FML_DCHECK(scene);
-        Push<SetSceneColorSourceOp>(0, scene);
-        break;
-      }
-#endif  // IMPELLER_ENABLE_3D
+    has_texture_images_ = has_texture_images_ || UsesTextureImage(source);
+    if (source->type() == DlColorSourceType::kColor) {
+      const DlColorColorSource* color_source = source->asColor();
+      current_.setColorSource(nullptr);
+      setColor(color_source->color());
+    } else {
+      uint32_t index = AttributeIndex(attributes_.color_sources,
+                                      current_.getColorSource());
+      Push<SetColorSourceOp>(0, index);
     }
   }
 }
@@ -265,42 +285,9 @@ void DisplayListBuilder::onSetImageFilter(const DlImageFilter* filter) {
     Push<ClearImageFilterOp>(0);
   } else {
     current_.setImageFilter(filter->shared());
-    switch (filter->type()) {
-      case DlImageFilterType::kBlur: {
-        const DlBlurImageFilter* blur_filter = filter->asBlur();
-        FML_DCHECK(blur_filter);
-        void* pod = Push<SetPodImageFilterOp>(blur_filter->size());
-        new (pod) DlBlurImageFilter(blur_filter);
-        break;
-      }
-      case DlImageFilterType::kDilate: {
-        const DlDilateImageFilter* dilate_filter = filter->asDilate();
-        FML_DCHECK(dilate_filter);
-        void* pod = Push<SetPodImageFilterOp>(dilate_filter->size());
-        new (pod) DlDilateImageFilter(dilate_filter);
-        break;
-      }
-      case DlImageFilterType::kErode: {
-        const DlErodeImageFilter* erode_filter = filter->asErode();
-        FML_DCHECK(erode_filter);
-        void* pod = Push<SetPodImageFilterOp>(erode_filter->size());
-        new (pod) DlErodeImageFilter(erode_filter);
-        break;
-      }
-      case DlImageFilterType::kMatrix: {
-        const DlMatrixImageFilter* matrix_filter = filter->asMatrix();
-        FML_DCHECK(matrix_filter);
-        void* pod = Push<SetPodImageFilterOp>(matrix_filter->size());
-        new (pod) DlMatrixImageFilter(matrix_filter);
-        break;
-      }
-      case DlImageFilterType::kCompose:
-      case DlImageFilterType::kLocalMatrix:
-      case DlImageFilterType::kColorFilter: {
-        Push<SetSharedImageFilterOp>(0, filter);
-        break;
-      }
-    }
+    uint32_t index =
+        AttributeIndex(attributes_.image_filters, current_.getImageFilter());
+    Push<SetImageFilterOp>(0, index);
   }
 }
 void DisplayListBuilder::onSetColorFilter(const DlColorFilter* filter) {
@@ -309,32 +296,9 @@ void DisplayListBuilder::onSetColorFilter(const DlColorFilter* filter) {
     Push<ClearColorFilterOp>(0);
   } else {
     current_.setColorFilter(filter->shared());
-    switch (filter->type()) {
-      case DlColorFilterType::kBlend: {
-        const DlBlendColorFilter* blend_filter = filter->asBlend();
-        FML_DCHECK(blend_filter);
-        void* pod = Push<SetPodColorFilterOp>(blend_filter->size());
-        new (pod) DlBlendColorFilter(blend_filter);
-        break;
-      }
-      case DlColorFilterType::kMatrix: {
-        const DlMatrixColorFilter* matrix_filter = filter->asMatrix();
-        FML_DCHECK(matrix_filter);
-        void* pod = Push<SetPodColorFilterOp>(matrix_filter->size());
-        new (pod) DlMatrixColorFilter(matrix_filter);
-        break;
-      }
-      case DlColorFilterType::kSrgbToLinearGamma: {
-        void* pod = Push<SetPodColorFilterOp>(filter->size());
-        new (pod) DlSrgbToLinearGammaColorFilter();
-        break;
-      }
-      case DlColorFilterType::kLinearToSrgbGamma: {
-        void* pod = Push<SetPodColorFilterOp>(filter->size());
-        new (pod) DlLinearToSrgbGammaColorFilter();
-        break;
-      }
-    }
+    uint32_t index =
+        AttributeIndex(attributes_.color_filters, current_.getColorFilter());
+    Push<SetColorFilterOp>(0, index);
   }
   UpdateCurrentOpacityCompatibility();
 }
@@ -346,15 +310,9 @@ void DisplayListBuilder::onSetMaskFilter(const DlMaskFilter* filter) {
   } else {
     current_.setMaskFilter(filter->shared());
     render_op_depth_cost_ = 2u;
-    switch (filter->type()) {
-      case DlMaskFilterType::kBlur: {
-        const DlBlurMaskFilter* blur_filter = filter->asBlur();
-        FML_DCHECK(blur_filter);
-        void* pod = Push<SetPodMaskFilterOp>(blur_filter->size());
-        new (pod) DlBlurMaskFilter(blur_filter);
-        break;
-      }
-    }
+    uint32_t index =
+        AttributeIndex(attributes_.mask_filters, current_.getMaskFilter());
+    Push<SetMaskFilterOp>(0, index);
   }
 }
 
@@ -1108,7 +1066,7 @@ void DisplayListBuilder::drawRect(const SkRect& rect) {
   OpResult result = PaintResult(current_, flags);
   if (result != OpResult::kNoEffect &&
       AccumulateOpBounds(rect.makeSorted(), flags)) {
-    Push<DrawRectOp>(0, rect);
+    PushDrawRect(rect);
     CheckLayerOpacityCompatibility();
     UpdateLayerResult(result);
   }
@@ -1362,6 +1320,7 @@ void DisplayListBuilder::drawImage(const sk_sp<DlImage> image,
     CheckLayerOpacityCompatibility(render_with_attributes);
     UpdateLayerResult(result, render_with_attributes);
     is_ui_thread_safe_ = is_ui_thread_safe_ && image->isUIThreadSafe();
+    has_texture_images_ = has_texture_images_ || image->isTextureBacked();
   }
 }
 void DisplayListBuilder::DrawImage(const sk_sp<DlImage>& image,
@@ -1392,6 +1351,7 @@ void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
     CheckLayerOpacityCompatibility(render_with_attributes);
     UpdateLayerResult(result, render_with_attributes);
     is_ui_thread_safe_ = is_ui_thread_safe_ && image->isUIThreadSafe();
+    has_texture_images_ = has_texture_images_ || image->isTextureBacked();
   }
 }
 void DisplayListBuilder::DrawImageRect(const sk_sp<DlImage>& image,
@@ -1424,6 +1384,7 @@ void DisplayListBuilder::drawImageNine(const sk_sp<DlImage> image,
     CheckLayerOpacityCompatibility(render_with_attributes);
     UpdateLayerResult(result, render_with_attributes);
     is_ui_thread_safe_ = is_ui_thread_safe_ && image->isUIThreadSafe();
+    has_texture_images_ = has_texture_images_ || image->isTextureBacked();
   }
 }
 void DisplayListBuilder::DrawImageNine(const sk_sp<DlImage>& image,
@@ -1512,6 +1473,7 @@ void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
   UpdateLayerOpacityCompatibility(false);
   UpdateLayerResult(result, render_with_attributes);
   is_ui_thread_safe_ = is_ui_thread_safe_ && atlas->isUIThreadSafe();
+  has_texture_images_ = has_texture_images_ || atlas->isTextureBacked();
 }
 void DisplayListBuilder::DrawAtlas(const sk_sp<DlImage>& atlas,
                                    const SkRSXform xform[],
@@ -1546,8 +1508,8 @@ void DisplayListBuilder::DrawDisplayList(const sk_sp<DisplayList> display_list,
   if (!rtree_data_.has_value() || !(rtree = display_list->rtree())) {
     accumulated = AccumulateOpBounds(bounds, kDrawDisplayListFlags);
   } else {
-    std::list<SkRect> rects =
-        rtree->searchAndConsolidateRects(GetLocalClipBounds(), false);
+    std::vector<SkRect> rects;
+    rtree->searchAndConsolidateRects(GetLocalClipBounds(), &rects, false);
     accumulated = false;
     for (const SkRect& rect : rects) {
       // TODO (https://github.com/flutter/flutter/issues/114919): Attributes
@@ -1576,6 +1538,8 @@ void DisplayListBuilder::DrawDisplayList(const sk_sp<DisplayList> display_list,
   depth_ += display_list->total_depth();
 
   is_ui_thread_safe_ = is_ui_thread_safe_ && display_list->isUIThreadSafe();
+  has_texture_images_ =
+      has_texture_images_ || display_list->has_texture_images();
   // Not really necessary if the developer is interacting with us via
   // our attribute-state-less DlCanvas methods, but this avoids surprises
   // for those who may have been using the stateful Dispatcher methods.
@@ -257,9 +257,13 @@ class DisplayListBuilder final : public virtual DlCanvas,
   // This method exposes the internal stateful DlOpReceiver implementation
   // of the DisplayListBuilder, primarily for testing purposes. Its use
   // is obsolete and forbidden in every other case and is only shared to a
-  // pair of "friend" accessors in the benchmark/unittest files.
+  // pair of "friend" accessors in the benchmark/unittest files and to the
+  // DlBinaryReader, which replays serialized ops that were recorded from a
+  // DlOpReceiver.
   DlOpReceiver& asReceiver() { return *this; }
 
+  friend class DlBinaryReader;
+
   friend DlOpReceiver& DisplayListBuilderBenchmarkAccessor(
       DisplayListBuilder& builder);
   friend DlOpReceiver& DisplayListBuilderTestingAccessor(
@@ -497,6 +501,10 @@ class DisplayListBuilder final : public virtual DlCanvas,
   DisplayListStorage storage_;
   size_t used_ = 0u;
   size_t allocated_ = 0u;
+  // The offset of the last op in |storage_|, only valid if it is less
+  // than |used_|.
+  size_t last_op_offset_ = 0u;
+  DisplayListAttributes attributes_;
   uint32_t render_op_count_ = 0u;
   uint32_t depth_ = 0u;
   // Most rendering ops will use 1 depth value, but some attributes may
@@ -509,10 +517,17 @@ class DisplayListBuilder final : public virtual DlCanvas,
   uint32_t nested_op_count_ = 0;
 
   bool is_ui_thread_safe_ = true;
+  bool has_texture_images_ = false;
+
+  void Reserve(size_t size);
 
   template <typename T, typename... Args>
   void* Push(size_t extra, Args&&... args);
 
+  // Records a drawRect, extending the previous op instead of pushing a
+  // new one if it is a run of rects.
+  void PushDrawRect(const SkRect& rect);
+
   struct RTreeData {
     std::vector<SkRect> rects;
     std::vector<int> indices;
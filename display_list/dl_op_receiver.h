@@ -346,6 +346,15 @@ class DlOpReceiver {
                               DlScalar on_length,
                               DlScalar off_length) = 0;
   virtual void drawRect(const SkRect& rect) = 0;
+  // Draws a run of |count| rects with the same attributes, equivalent to
+  // calling |drawRect| for each of them in order. The DisplayList stores
+  // consecutive drawRect calls as one run and plays them back through
+  // this method so that a receiver can batch them.
+  virtual void drawRects(const SkRect rects[], uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+      drawRect(rects[i]);
+    }
+  }
   virtual void drawOval(const SkRect& bounds) = 0;
   virtual void drawCircle(const SkPoint& center, SkScalar radius) = 0;
   virtual void drawRRect(const SkRRect& rrect) = 0;
@@ -41,6 +41,7 @@ namespace flutter {
 // determine if they will be used.
 struct DispatchContext {
   DlOpReceiver& receiver;
+  const DisplayListAttributes& attributes;
 
   int cur_index;
   int next_render_index;
@@ -203,117 +204,37 @@ struct SetBlendModeOp final : DLOp {
 
 // Clear: 4 byte header + unused 4 byte payload uses 8 bytes
 //        (4 bytes unused)
-// Set: 4 byte header + unused 4 byte struct padding + Dl<name>
-//      instance copied to the memory following the record
-//      yields a size and efficiency that has somewhere between
-//      4 and 8 bytes unused
-#define DEFINE_SET_CLEAR_DLATTR_OP(name, sk_name, field)                    \
-  struct Clear##name##Op final : DLOp {                                     \
-    static constexpr auto kType = DisplayListOpType::kClear##name;          \
-                                                                            \
-    Clear##name##Op() {}                                                    \
-                                                                            \
-    void dispatch(DispatchContext& ctx) const {                             \
-      ctx.receiver.set##name(nullptr);                                      \
-    }                                                                       \
-  };                                                                        \
-  struct SetPod##name##Op final : DLOp {                                    \
-    static constexpr auto kType = DisplayListOpType::kSetPod##name;         \
-                                                                            \
-    SetPod##name##Op() {}                                                   \
-                                                                            \
-    void dispatch(DispatchContext& ctx) const {                             \
-      const Dl##name* filter = reinterpret_cast<const Dl##name*>(this + 1); \
-      ctx.receiver.set##name(filter);                                       \
-    }                                                                       \
+// Set: 4 byte header + 4 byte index into the matching table of the
+//      DisplayListAttributes packs into 8 bytes however large the
+//      attribute is, and the attribute itself is only stored once
+//      per DisplayList
+#define DEFINE_SET_CLEAR_DLATTR_OP(name, table)                    \
+  struct Clear##name##Op final : DLOp {                            \
+    static constexpr auto kType = DisplayListOpType::kClear##name; \
+                                                                   \
+    Clear##name##Op() {}                                           \
+                                                                   \
+    void dispatch(DispatchContext& ctx) const {                    \
+      ctx.receiver.set##name(nullptr);                             \
+    }                                                              \
+  };                                                               \
+  struct Set##name##Op final : DLOp {                              \
+    static constexpr auto kType = DisplayListOpType::kSet##name;   \
+                                                                   \
+    explicit Set##name##Op(uint32_t index) : index(index) {}       \
+                                                                   \
+    const uint32_t index;                                          \
+                                                                   \
+    void dispatch(DispatchContext& ctx) const {                    \
+      ctx.receiver.set##name(ctx.attributes.table[index].get());   \
+    }                                                              \
   };
-DEFINE_SET_CLEAR_DLATTR_OP(ColorFilter, ColorFilter, filter)
-DEFINE_SET_CLEAR_DLATTR_OP(ImageFilter, ImageFilter, filter)
-DEFINE_SET_CLEAR_DLATTR_OP(MaskFilter, MaskFilter, filter)
-DEFINE_SET_CLEAR_DLATTR_OP(ColorSource, Shader, source)
+DEFINE_SET_CLEAR_DLATTR_OP(ColorFilter, color_filters)
+DEFINE_SET_CLEAR_DLATTR_OP(ImageFilter, image_filters)
+DEFINE_SET_CLEAR_DLATTR_OP(MaskFilter, mask_filters)
+DEFINE_SET_CLEAR_DLATTR_OP(ColorSource, color_sources)
 #undef DEFINE_SET_CLEAR_DLATTR_OP
 
-// 4 byte header + 80 bytes for the embedded DlImageColorSource
-// uses 84 total bytes (4 bytes unused)
-struct SetImageColorSourceOp : DLOp {
-  static constexpr auto kType = DisplayListOpType::kSetImageColorSource;
-
-  explicit SetImageColorSourceOp(const DlImageColorSource* source)
-      : source(source->image(),
-               source->horizontal_tile_mode(),
-               source->vertical_tile_mode(),
-               source->sampling(),
-               source->matrix_ptr()) {}
-
-  const DlImageColorSource source;
-
-  void dispatch(DispatchContext& ctx) const {
-    ctx.receiver.setColorSource(&source);
-  }
-};
-
-// 56 bytes: 4 byte header, 4 byte padding, 8 for vtable, 8 * 2 for sk_sps, 24
-// for the std::vector.
-struct SetRuntimeEffectColorSourceOp : DLOp {
-  static constexpr auto kType = DisplayListOpType::kSetRuntimeEffectColorSource;
-
-  explicit SetRuntimeEffectColorSourceOp(
-      const DlRuntimeEffectColorSource* source)
-      : source(source->runtime_effect(),
-               source->samplers(),
-               source->uniform_data()) {}
-
-  const DlRuntimeEffectColorSource source;
-
-  void dispatch(DispatchContext& ctx) const {
-    ctx.receiver.setColorSource(&source);
-  }
-
-  DisplayListCompare equals(const SetRuntimeEffectColorSourceOp* other) const {
-    return (source == other->source) ? DisplayListCompare::kEqual
-                                     : DisplayListCompare::kNotEqual;
-  }
-};
-
-#ifdef IMPELLER_ENABLE_3D
-struct SetSceneColorSourceOp : DLOp {
-  static constexpr auto kType = DisplayListOpType::kSetSceneColorSource;
-
-  explicit SetSceneColorSourceOp(const DlSceneColorSource* source)
-      : source(source->scene_node(), source->camera_matrix()) {}
-
-  const DlSceneColorSource source;
-
-  void dispatch(DispatchContext& ctx) const {
-    ctx.receiver.setColorSource(&source);
-  }
-
-  DisplayListCompare equals(const SetSceneColorSourceOp* other) const {
-    return (source == other->source) ? DisplayListCompare::kEqual
-                                     : DisplayListCompare::kNotEqual;
-  }
-};
-#endif  // IMPELLER_ENABLE_3D
-
-// 4 byte header + 16 byte payload uses 24 total bytes (4 bytes unused)
-struct SetSharedImageFilterOp : DLOp {
-  static constexpr auto kType = DisplayListOpType::kSetSharedImageFilter;
-
-  explicit SetSharedImageFilterOp(const DlImageFilter* filter)
-      : filter(filter->shared()) {}
-
-  const std::shared_ptr<DlImageFilter> filter;
-
-  void dispatch(DispatchContext& ctx) const {
-    ctx.receiver.setImageFilter(filter.get());
-  }
-
-  DisplayListCompare equals(const SetSharedImageFilterOp* other) const {
-    return Equals(filter, other->filter) ? DisplayListCompare::kEqual
-                                         : DisplayListCompare::kNotEqual;
-  }
-};
-
 // The base struct for all save() and saveLayer() ops
 // 4 byte header + 12 byte payload packs exactly into 16 bytes
 struct SaveOpBase : DLOp {
@@ -660,9 +581,8 @@ struct DrawColorOp final : DrawOpBase {
 };
 
 // The common data is a 4 byte header with an unused 4 bytes
-// SkRect is 16 more bytes, using 20 bytes which rounds up to 24 bytes total
+// SkOval is 16 more bytes, using 20 bytes which rounds up to 24 bytes total
 //        (4 bytes unused)
-// SkOval is same as SkRect
 // SkRRect is 52 more bytes, which packs efficiently into 56 bytes total
 #define DEFINE_DRAW_1ARG_OP(op_name, arg_type, arg_name)                  \
   struct Draw##op_name##Op final : DrawOpBase {                           \
@@ -678,11 +598,40 @@ struct DrawColorOp final : DrawOpBase {
       }                                                                   \
     }                                                                     \
   };
-DEFINE_DRAW_1ARG_OP(Rect, SkRect, rect)
 DEFINE_DRAW_1ARG_OP(Oval, SkRect, oval)
 DEFINE_DRAW_1ARG_OP(RRect, SkRRect, rrect)
 #undef DEFINE_DRAW_1ARG_OP
 
+// 4 byte header + 4 byte count packs into 8 bytes, followed by the
+// rects of a run of consecutive drawRect calls at 16 bytes each.
+// A single rect uses 24 bytes total and every further rect of the
+// run only adds its 16 bytes.
+// Each rect of the run uses its own op index so that a culled
+// dispatch can still skip the rects that are not needed.
+struct DrawRectsOp final : DrawOpBase {
+  static constexpr auto kType = DisplayListOpType::kDrawRects;
+
+  explicit DrawRectsOp(uint32_t count) : count(count) {}
+
+  // Not const, the DisplayListBuilder appends to the last run of rects
+  // as long as no other op has been recorded after it.
+  uint32_t count;
+
+  const SkRect* rects() const {
+    return reinterpret_cast<const SkRect*>(this + 1);
+  }
+
+  void dispatch(DispatchContext& ctx) const {
+    if (op_needed(ctx)) {
+      if (count == 1) {
+        ctx.receiver.drawRect(rects()[0]);
+      } else {
+        ctx.receiver.drawRects(rects(), count);
+      }
+    }
+  }
+};
+
 // 4 byte header + 128 byte payload uses 132 bytes but is rounded
 // up to 136 bytes (4 bytes unused)
 struct DrawPathOp final : DrawOpBase {
@@ -58,19 +58,26 @@ void DlRegion::SpanBuffer::reserve(size_t capacity) {
 DlRegion::SpanChunkHandle DlRegion::SpanBuffer::storeChunk(const Span* begin,
                                                            const Span* end) {
   size_t chunk_size = end - begin;
-  size_t min_capacity = size_ + chunk_size + 1;
+  auto* dst = reserveChunk(chunk_size);
+  memmove(dst, begin, chunk_size * sizeof(Span));
+  return commitChunk(chunk_size);
+}
+
+DlRegion::Span* DlRegion::SpanBuffer::reserveChunk(size_t max_size) {
+  size_t min_capacity = size_ + max_size + 1;
   if (capacity_ < min_capacity) {
     size_t new_capacity = std::max(min_capacity, capacity_ * 2);
     new_capacity = std::max(new_capacity, size_t(512));
     reserve(new_capacity);
   }
-  SpanChunkHandle res = size_;
-  size_ += chunk_size + 1;
-  setChunkSize(res, chunk_size);
-
-  auto* dst = spans_ + res + 1;
-  memmove(dst, begin, chunk_size * sizeof(Span));
+  return spans_ + size_ + 1;
+}
 
+DlRegion::SpanChunkHandle DlRegion::SpanBuffer::commitChunk(size_t size) {
+  FML_DCHECK(size_ + size + 1 <= capacity_);
+  SpanChunkHandle res = size_;
+  size_ += size + 1;
+  setChunkSize(res, size);
   return res;
 }
 
@@ -103,7 +110,7 @@ DlRegion::DlRegion(const SkIRect& rect) : bounds_(rect) {
   lines_.push_back(makeLine(rect.top(), rect.bottom(), &span, &span + 1));
 }
 
-bool DlRegion::spansEqual(SpanLine& line,
+bool DlRegion::spansEqual(const SpanLine& line,
                           const Span* begin,
                           const Span* end) const {
   const Span *our_begin, *our_end;
@@ -117,12 +124,6 @@ bool DlRegion::spansEqual(SpanLine& line,
   return memcmp(our_begin, begin, our_size * sizeof(Span)) == 0;
 }
 
-DlRegion::SpanLine DlRegion::makeLine(int32_t top,
-                                      int32_t bottom,
-                                      const SpanVec& v) {
-  return makeLine(top, bottom, v.data(), v.data() + v.size());
-}
-
 DlRegion::SpanLine DlRegion::makeLine(int32_t top,
                                       int32_t bottom,
                                       const Span* begin,
@@ -131,16 +132,16 @@ DlRegion::SpanLine DlRegion::makeLine(int32_t top,
   return {top, bottom, handle};
 }
 
-// Returns number of valid spans in res. For performance reasons res is never
-// downsized.
-size_t DlRegion::unionLineSpans(std::vector<Span>& res,
+// Returns number of valid spans in res, which must have room for the spans of
+// both lines.
+size_t DlRegion::unionLineSpans(Span* res,
                                 const SpanBuffer& a_buffer,
                                 SpanChunkHandle a_handle,
                                 const SpanBuffer& b_buffer,
                                 SpanChunkHandle b_handle) {
   class OrderedSpanAccumulator {
    public:
-    explicit OrderedSpanAccumulator(std::vector<Span>& res) : res(res) {}
+    explicit OrderedSpanAccumulator(Span* res) : res(res) {}
 
     void accumulate(const Span& span) {
       if (span.left > last_ || len == 0) {
@@ -154,7 +155,7 @@ size_t DlRegion::unionLineSpans(std::vector<Span>& res,
     }
 
     size_t len = 0;
-    std::vector<Span>& res;
+    Span* res;
 
    private:
     int32_t last_ = std::numeric_limits<int32_t>::min();
@@ -166,11 +167,6 @@ size_t DlRegion::unionLineSpans(std::vector<Span>& res,
   const Span *begin2, *end2;
   b_buffer.getSpans(b_handle, begin2, end2);
 
-  size_t min_size = (end1 - begin1) + (end2 - begin2);
-  if (res.size() < min_size) {
-    res.resize(min_size);
-  }
-
   OrderedSpanAccumulator accumulator(res);
 
   while (true) {
@@ -203,7 +199,9 @@ size_t DlRegion::unionLineSpans(std::vector<Span>& res,
   return accumulator.len;
 }
 
-size_t DlRegion::intersectLineSpans(std::vector<Span>& res,
+// Returns number of valid spans in res, which must have room for the spans of
+// both lines.
+size_t DlRegion::intersectLineSpans(Span* res,
                                     const SpanBuffer& a_buffer,
                                     SpanChunkHandle a_handle,
                                     const SpanBuffer& b_buffer,
@@ -217,13 +215,11 @@ size_t DlRegion::intersectLineSpans(std::vector<Span>& res,
   // Worst case scenario, interleaved overlapping spans
   //   AAAA  BBBB  CCCC
   // XXX  YYYY  XXXX
-  size_t min_size = (end1 - begin1) + (end2 - begin2) - 1;
-  if (res.size() < min_size) {
-    res.resize(min_size);
-  }
+  FML_DCHECK(end1 > begin1 && end2 > begin2);
+  Span* res_end = res + (end1 - begin1) + (end2 - begin2) - 1;
 
   // Pointer to the next span to be written.
-  Span* new_span = res.data();
+  Span* new_span = res;
 
   while (begin1 != end1 && begin2 != end2) {
     if (begin1->right <= begin2->left) {
@@ -234,7 +230,7 @@ size_t DlRegion::intersectLineSpans(std::vector<Span>& res,
       int32_t left = std::max(begin1->left, begin2->left);
       int32_t right = std::min(begin1->right, begin2->right);
       FML_DCHECK(left < right);
-      FML_DCHECK(new_span < res.data() + res.size());
+      FML_DCHECK(new_span < res_end);
       *new_span++ = {left, right};
       if (begin1->right == right) {
         ++begin1;
@@ -245,7 +241,8 @@ size_t DlRegion::intersectLineSpans(std::vector<Span>& res,
     }
   }
 
-  return new_span - res.data();
+  (void)res_end;  // Suppress unused variable warning in release builds.
+  return new_span - res;
 }
 
 void DlRegion::setRects(const std::vector<SkIRect>& unsorted_rects) {
@@ -271,7 +268,6 @@ void DlRegion::setRects(const std::vector<SkIRect>& unsorted_rects) {
   size_t active_end = 0;
   size_t next_rect = 0;
   int32_t cur_y = std::numeric_limits<int32_t>::min();
-  SpanVec working_spans;
 
 #ifdef DlRegion_DO_STATS
   size_t active_rect_count = 0;
@@ -326,8 +322,11 @@ void DlRegion::setRects(const std::vector<SkIRect>& unsorted_rects) {
     // We either preserved some rects in the active list or added more from
     // the remaining input rects, or we would have exited the loop above.
     FML_DCHECK(active_end != 0);
-    working_spans.clear();
-    FML_DCHECK(working_spans.empty());
+
+    // The spans are written directly to the span buffer, there can not be
+    // more of them than there are active rects.
+    Span* working_spans = span_buffer_.reserveChunk(active_end);
+    size_t working_span_count = 0;
 
 #ifdef DlRegion_DO_STATS
     active_rect_count += active_end;
@@ -342,7 +341,7 @@ void DlRegion::setRects(const std::vector<SkIRect>& unsorted_rects) {
     for (size_t i = 1; i < active_end; i++) {
       const SkIRect* r = rects[i];
       if (r->left() > end_x) {
-        working_spans.emplace_back(start_x, end_x);
+        working_spans[working_span_count++] = {start_x, end_x};
         start_x = r->left();
         end_x = r->right();
       } else if (end_x < r->right()) {
@@ -352,7 +351,7 @@ void DlRegion::setRects(const std::vector<SkIRect>& unsorted_rects) {
         end_y = r->bottom();
       }
     }
-    working_spans.emplace_back(start_x, end_x);
+    working_spans[working_span_count++] = {start_x, end_x};
 
     // end_y must not pass by the top of the next input rect
     if (next_rect < count && end_y > rects[next_rect]->top()) {
@@ -363,17 +362,16 @@ void DlRegion::setRects(const std::vector<SkIRect>& unsorted_rects) {
     // current range of Y coordinates to empty
     FML_DCHECK(end_y > cur_y);
 
-    if (!lines_.empty() && lines_.back().bottom == cur_y &&
-        spansEqual(lines_.back(), working_spans.data(),
-                   working_spans.data() + working_spans.size())) {
-      lines_.back().bottom = end_y;
-    } else {
 #ifdef DlRegion_DO_STATS
-      span_count += working_spans.size();
-      line_count++;
+    size_t line_count_before = lines_.size();
 #endif
-      lines_.push_back(makeLine(cur_y, end_y, working_spans));
+    appendReservedLine(cur_y, end_y, working_span_count);
+#ifdef DlRegion_DO_STATS
+    if (lines_.size() > line_count_before) {
+      span_count += working_span_count;
+      line_count++;
     }
+#endif
     cur_y = end_y;
   }
 
@@ -387,6 +385,16 @@ void DlRegion::setRects(const std::vector<SkIRect>& unsorted_rects) {
 #endif
 }
 
+void DlRegion::appendReservedLine(int32_t top, int32_t bottom, size_t size) {
+  const Span* begin = span_buffer_.reserveChunk(size);
+  if (!lines_.empty() && lines_.back().bottom == top &&
+      spansEqual(lines_.back(), begin, begin + size)) {
+    lines_.back().bottom = bottom;
+  } else {
+    lines_.push_back({top, bottom, span_buffer_.commitChunk(size)});
+  }
+}
+
 void DlRegion::appendLine(int32_t top,
                           int32_t bottom,
                           const Span* begin,
@@ -432,8 +440,6 @@ DlRegion DlRegion::MakeUnion(const DlRegion& a, const DlRegion& b) {
   auto& a_buffer = a.span_buffer_;
   auto& b_buffer = b.span_buffer_;
 
-  std::vector<Span> tmp;
-
   int32_t cur_top = std::numeric_limits<int32_t>::min();
 
   while (a_it != a_end && b_it != b_end) {
@@ -463,9 +469,12 @@ DlRegion DlRegion::MakeUnion(const DlRegion& a, const DlRegion& b) {
         FML_DCHECK(a_top == b_top);
         FML_DCHECK(new_bottom > a_top);
         FML_DCHECK(new_bottom > b_top);
-        auto size = unionLineSpans(tmp, a_buffer, a_it->chunk_handle, b_buffer,
-                                   b_it->chunk_handle);
-        res.appendLine(a_top, new_bottom, tmp.data(), tmp.data() + size);
+        auto* spans = res.span_buffer_.reserveChunk(
+            a_buffer.getChunkSize(a_it->chunk_handle) +
+            b_buffer.getChunkSize(b_it->chunk_handle));
+        auto size = unionLineSpans(spans, a_buffer, a_it->chunk_handle,
+                                   b_buffer, b_it->chunk_handle);
+        res.appendReservedLine(a_top, new_bottom, size);
         cur_top = new_bottom;
         if (cur_top == a_it->bottom) {
           ++a_it;
@@ -525,8 +534,6 @@ DlRegion DlRegion::MakeIntersection(const DlRegion& a, const DlRegion& b) {
   auto& a_buffer = a.span_buffer_;
   auto& b_buffer = b.span_buffer_;
 
-  std::vector<Span> tmp;
-
   int32_t cur_top = std::numeric_limits<int32_t>::min();
 
   while (a_it != a_end && b_it != b_end) {
@@ -540,12 +547,15 @@ DlRegion DlRegion::MakeIntersection(const DlRegion& a, const DlRegion& b) {
       auto top = std::max(a_top, b_top);
       auto bottom = std::min(a_it->bottom, b_it->bottom);
       FML_DCHECK(top < bottom);
-      auto size = intersectLineSpans(tmp, a_buffer, a_it->chunk_handle,
+      auto* spans = res.span_buffer_.reserveChunk(
+          a_buffer.getChunkSize(a_it->chunk_handle) +
+          b_buffer.getChunkSize(b_it->chunk_handle) - 1);
+      auto size = intersectLineSpans(spans, a_buffer, a_it->chunk_handle,
                                      b_buffer, b_it->chunk_handle);
       if (size > 0) {
-        res.appendLine(top, bottom, tmp.data(), tmp.data() + size);
-        res.bounds_.join(SkIRect::MakeLTRB(
-            tmp.data()->left, top, (tmp.data() + size - 1)->right, bottom));
+        res.bounds_.join(
+            SkIRect::MakeLTRB(spans->left, top, spans[size - 1].right, bottom));
+        res.appendReservedLine(top, bottom, size);
       }
       cur_top = bottom;
       if (cur_top == a_it->bottom) {
@@ -560,6 +570,141 @@ DlRegion DlRegion::MakeIntersection(const DlRegion& a, const DlRegion& b) {
   return res;
 }
 
+void DlRegion::addRect(const SkIRect& rect) {
+  if (rect.isEmpty()) {
+    return;
+  } else if (isEmpty()) {
+    *this = DlRegion(rect);
+    return;
+  } else if (isSimple() && bounds_.contains(rect)) {
+    return;
+  }
+  bounds_.join(rect);
+
+  // Lines above the rect are kept as they are. The line above the first
+  // line that the rect overlaps is included in |band| so that it can be
+  // extended by the first new line.
+  auto first = std::lower_bound(
+      lines_.begin(), lines_.end(), rect.fTop,
+      [](const SpanLine& line, int32_t top) { return line.bottom <= top; });
+  if (first != lines_.begin()) {
+    --first;
+  }
+  std::vector<SpanLine> band;
+  auto it = first;
+  if (it != lines_.end() && it->bottom <= rect.fTop) {
+    band.push_back(*it++);
+  }
+
+  // Lines that only partially overlap the rect are split, and the parts
+  // outside of the rect keep their spans.
+  Span span(rect.fLeft, rect.fRight);
+  int32_t cur_top = rect.fTop;
+  for (; it != lines_.end() && it->top < rect.fBottom; ++it) {
+    if (cur_top < it->top) {
+      appendLine(band, makeLine(cur_top, it->top, &span, &span + 1));
+      cur_top = it->top;
+    } else if (it->top < cur_top) {
+      appendLine(band, {it->top, cur_top, it->chunk_handle});
+    }
+    int32_t bottom = std::min(it->bottom, rect.fBottom);
+    appendLine(band, addLineSpan(cur_top, bottom, it->chunk_handle, span));
+    if (bottom < it->bottom) {
+      appendLine(band, {bottom, it->bottom, it->chunk_handle});
+    }
+    cur_top = it->bottom;
+  }
+  if (cur_top < rect.fBottom) {
+    appendLine(band, makeLine(cur_top, rect.fBottom, &span, &span + 1));
+  }
+
+  // The first line below the rect may now extend the last new line.
+  if (it != lines_.end()) {
+    appendLine(band, *it++);
+  }
+  it = lines_.erase(first, it);
+  lines_.insert(it, band.begin(), band.end());
+
+  // Every call leaves the spans of the lines it replaced in the buffer.
+  if (span_buffer_.size() > compacted_size_ * 2 + 512) {
+    compactSpans();
+  }
+}
+
+DlRegion::SpanLine DlRegion::addLineSpan(int32_t top,
+                                         int32_t bottom,
+                                         SpanChunkHandle handle,
+                                         const Span& span) {
+  // Reserve the chunk before getting the spans of the line, which are in the
+  // same buffer.
+  Span* res = span_buffer_.reserveChunk(span_buffer_.getChunkSize(handle) + 1);
+  const Span *begin, *end;
+  span_buffer_.getSpans(handle, begin, end);
+
+  // The spans are sorted and do not touch, so both their left and right
+  // edges are in increasing order. Spans that touch the new span merge
+  // with it.
+  const Span* merge_begin = std::lower_bound(
+      begin, end, span.left,
+      [](const Span& s, int32_t left) { return s.right < left; });
+  const Span* merge_end = std::upper_bound(
+      merge_begin, end, span.right,
+      [](int32_t right, const Span& s) { return right < s.left; });
+  if (merge_end - merge_begin == 1 && merge_begin->left <= span.left &&
+      merge_begin->right >= span.right) {
+    // The line already covers the span.
+    return {top, bottom, handle};
+  }
+
+  Span merged = span;
+  if (merge_begin != merge_end) {
+    merged.left = std::min(merged.left, merge_begin->left);
+    merged.right = std::max(merged.right, (merge_end - 1)->right);
+  }
+  size_t before = merge_begin - begin;
+  size_t after = end - merge_end;
+  memcpy(res, begin, before * sizeof(Span));
+  res[before] = merged;
+  memcpy(res + before + 1, merge_end, after * sizeof(Span));
+  return {top, bottom, span_buffer_.commitChunk(before + 1 + after)};
+}
+
+void DlRegion::appendLine(std::vector<SpanLine>& lines,
+                          const SpanLine& line) const {
+  if (!lines.empty() && lines.back().bottom == line.top) {
+    const Span *begin, *end;
+    span_buffer_.getSpans(line.chunk_handle, begin, end);
+    if (lines.back().chunk_handle == line.chunk_handle ||
+        spansEqual(lines.back(), begin, end)) {
+      lines.back().bottom = line.bottom;
+      return;
+    }
+  }
+  lines.push_back(line);
+}
+
+void DlRegion::compactSpans() {
+  SpanBuffer buffer;
+  buffer.reserve(span_buffer_.size());
+  SpanChunkHandle last_handle = 0;
+  SpanChunkHandle last_compacted_handle = 0;
+  for (size_t i = 0; i < lines_.size(); i++) {
+    SpanLine& line = lines_[i];
+    // Lines that were split by addRect share their spans.
+    if (i > 0 && line.chunk_handle == last_handle) {
+      line.chunk_handle = last_compacted_handle;
+      continue;
+    }
+    const Span *begin, *end;
+    span_buffer_.getSpans(line.chunk_handle, begin, end);
+    last_handle = line.chunk_handle;
+    line.chunk_handle = buffer.storeChunk(begin, end);
+    last_compacted_handle = line.chunk_handle;
+  }
+  span_buffer_ = std::move(buffer);
+  compacted_size_ = span_buffer_.size();
+}
+
 std::vector<SkIRect> DlRegion::getRects(bool deband) const {
   std::vector<SkIRect> rects;
   if (isEmpty()) {
@@ -41,6 +41,13 @@ class DlRegion {
   /// Matches SkRegion a; a.op(b, SkRegion::kIntersect_Op) behavior.
   static DlRegion MakeIntersection(const DlRegion& a, const DlRegion& b);
 
+  /// Adds the area of a rectangle to this region.
+  /// Matches SkRegion::op(rect, SkRegion::kUnion_Op) behavior.
+  /// Only the span lines that the rectangle overlaps are rebuilt, which makes
+  /// this much faster than MakeUnion with a region for the rectangle when
+  /// regions are accumulated one rectangle at a time.
+  void addRect(const SkIRect& rect);
+
   /// Returns list of non-overlapping rectangles that cover current region.
   /// If |deband| is false, each span line will result in separate rectangles,
   /// closely matching SkRegion::Iterator behavior.
@@ -92,8 +99,16 @@ class DlRegion {
 
     void reserve(size_t capacity);
     size_t capacity() const { return capacity_; }
+    size_t size() const { return size_; }
 
     SpanChunkHandle storeChunk(const Span* begin, const Span* end);
+
+    /// Makes room for a chunk of up to |max_size| spans at the end of the
+    /// buffer and returns where the spans of the chunk should be written,
+    /// which lets span merging write its output directly to the buffer.
+    /// The chunk is only stored once it is committed.
+    Span* reserveChunk(size_t max_size);
+    SpanChunkHandle commitChunk(size_t size);
     size_t getChunkSize(SpanChunkHandle handle) const;
     void getSpans(SpanChunkHandle handle,
                   const DlRegion::Span*& begin,
@@ -133,24 +148,43 @@ class DlRegion {
     appendLine(top, bottom, begin, end);
   }
 
-  typedef std::vector<Span> SpanVec;
-  SpanLine makeLine(int32_t top, int32_t bottom, const SpanVec&);
+  /// Appends a line with the |size| spans written to the chunk reserved in
+  /// the span buffer, or extends the last line if it has the same spans.
+  void appendReservedLine(int32_t top, int32_t bottom, size_t size);
+
+  /// Appends a line to |lines| or extends the last line of |lines| if it has
+  /// the same spans.
+  void appendLine(std::vector<SpanLine>& lines, const SpanLine& line) const;
+
   SpanLine makeLine(int32_t top,
                     int32_t bottom,
                     const Span* begin,
                     const Span* end);
-  static size_t unionLineSpans(std::vector<Span>& res,
+  static size_t unionLineSpans(Span* res,
                                const SpanBuffer& a_buffer,
                                SpanChunkHandle a_handle,
                                const SpanBuffer& b_buffer,
                                SpanChunkHandle b_handle);
-  static size_t intersectLineSpans(std::vector<Span>& res,
+  static size_t intersectLineSpans(Span* res,
                                    const SpanBuffer& a_buffer,
                                    SpanChunkHandle a_handle,
                                    const SpanBuffer& b_buffer,
                                    SpanChunkHandle b_handle);
 
-  bool spansEqual(SpanLine& line, const Span* begin, const Span* end) const;
+  /// Returns the line with the spans of |handle| and |span| over
+  /// [top, bottom).
+  SpanLine addLineSpan(int32_t top,
+                       int32_t bottom,
+                       SpanChunkHandle handle,
+                       const Span& span);
+
+  /// Copies the spans of the lines to a new buffer, dropping the spans that
+  /// addRect replaced.
+  void compactSpans();
+
+  bool spansEqual(const SpanLine& line,
+                  const Span* begin,
+                  const Span* end) const;
 
   static bool spansIntersect(const Span* begin1,
                              const Span* end1,
@@ -166,6 +200,8 @@ class DlRegion {
   std::vector<SpanLine> lines_;
   SkIRect bounds_ = SkIRect::MakeEmpty();
   SpanBuffer span_buffer_;
+  // Size of the span buffer after it was last compacted by addRect.
+  size_t compacted_size_ = 0;
 };
 
 }  // namespace flutter
@@ -341,6 +341,73 @@ TEST(DisplayListRegion, UnionEmpty) {
   }
 }
 
+TEST(DisplayListRegion, AddRect) {
+  DlRegion region;
+  region.addRect(SkIRect::MakeEmpty());
+  EXPECT_TRUE(region.isEmpty());
+
+  region.addRect(SkIRect::MakeXYWH(0, 0, 20, 20));
+  EXPECT_TRUE(region.isSimple());
+  EXPECT_EQ(region.bounds(), SkIRect::MakeXYWH(0, 0, 20, 20));
+
+  // Contained in the region.
+  region.addRect(SkIRect::MakeXYWH(5, 5, 10, 10));
+  EXPECT_TRUE(region.isSimple());
+
+  // Touching the right edge.
+  region.addRect(SkIRect::MakeXYWH(20, 0, 10, 20));
+  EXPECT_TRUE(region.isSimple());
+  EXPECT_EQ(region.bounds(), SkIRect::MakeXYWH(0, 0, 30, 20));
+
+  // Splits the only line into 3 lines.
+  region.addRect(SkIRect::MakeXYWH(40, 5, 10, 10));
+  std::vector<SkIRect> expected{
+      SkIRect::MakeLTRB(0, 0, 30, 5),
+      SkIRect::MakeLTRB(0, 5, 30, 15),
+      SkIRect::MakeLTRB(40, 5, 50, 15),
+      SkIRect::MakeLTRB(0, 15, 30, 20),
+  };
+  EXPECT_EQ(region.getRects(false), expected);
+
+  // Bridges the gap, which joins the lines back together, and adds a line
+  // below the region.
+  region.addRect(SkIRect::MakeXYWH(25, 5, 20, 30));
+  expected = {
+      SkIRect::MakeLTRB(0, 0, 30, 5),
+      SkIRect::MakeLTRB(0, 5, 50, 15),
+      SkIRect::MakeLTRB(0, 15, 45, 20),
+      SkIRect::MakeLTRB(25, 20, 45, 35),
+  };
+  EXPECT_EQ(region.getRects(false), expected);
+  EXPECT_EQ(region.bounds(), SkIRect::MakeLTRB(0, 0, 50, 35));
+
+  // A line above the region with a gap.
+  region.addRect(SkIRect::MakeXYWH(0, -20, 10, 10));
+  EXPECT_EQ(region.getRects(false).front(), SkIRect::MakeLTRB(0, -20, 10, -10));
+  EXPECT_EQ(region.bounds(), SkIRect::MakeLTRB(0, -20, 50, 35));
+}
+
+TEST(DisplayListRegion, AddRectMatchesBulkConstruction) {
+  std::seed_seq seed{::testing::UnitTest::GetInstance()->random_seed()};
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution pos(0, 400);
+  std::uniform_int_distribution size(1, 100);
+
+  std::vector<SkIRect> rects;
+  DlRegion region;
+  // Enough rects to compact the span buffer several times.
+  for (int i = 0; i < 2000; ++i) {
+    SkIRect rect = SkIRect::MakeXYWH(pos(rng), pos(rng), size(rng), size(rng));
+    rects.push_back(rect);
+    region.addRect(rect);
+    if (i % 100 == 0) {
+      DlRegion expected(rects);
+      EXPECT_EQ(region.bounds(), expected.bounds());
+      EXPECT_EQ(region.getRects(false), expected.getRects(false));
+    }
+  }
+}
+
 void CheckEquality(const DlRegion& dl_region, const SkRegion& sk_region) {
   EXPECT_EQ(dl_region.bounds(), sk_region.getBounds());
 
@@ -398,6 +465,12 @@ TEST(DisplayListRegion, TestAgainstSkRegion) {
         sk_region1.setRects(rects_in1.data(), rects_in1.size());
         CheckEquality(region1, sk_region1);
 
+        DlRegion added_region1;
+        for (const auto& rect : rects_in1) {
+          added_region1.addRect(rect);
+        }
+        CheckEquality(added_region1, sk_region1);
+
         DlRegion region2(rects_in2);
         sk_region2.setRects(rects_in2.data(), rects_in2.size());
         CheckEquality(region2, sk_region2);
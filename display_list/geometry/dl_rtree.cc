@@ -5,10 +5,86 @@
 #include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/display_list/geometry/dl_region.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
 #include "flutter/fml/logging.h"
 
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace flutter {
 
+namespace {
+
+float Area(const SkRect& rect) {
+  return rect.width() * rect.height();
+}
+
+}  // namespace
+
+bool DlRTree::ShouldSortTiles(const Node leaves[], int leaf_count) {
+  // Sort the tiles when the bounds of the groups of |kMaxChildren|
+  // consecutive leaf nodes cover the bounds of all of the leaf nodes
+  // more than this many times over.
+  constexpr float kMaxOverlap = 4.0f;
+
+  if (leaf_count <= kMaxChildren) {
+    return false;
+  }
+  SkRect bounds = leaves[0].bounds;
+  float family_area = 0.0f;
+  for (int start = 0; start < leaf_count; start += kMaxChildren) {
+    int end = std::min(start + kMaxChildren, leaf_count);
+    SkRect family = leaves[start].bounds;
+    for (int i = start + 1; i < end; i++) {
+      family.joinNonEmptyArg(leaves[i].bounds);
+    }
+    family_area += Area(family);
+    bounds.joinNonEmptyArg(family);
+  }
+  return family_area > Area(bounds) * kMaxOverlap;
+}
+
+void DlRTree::SortTiles(int order[],
+                        uint32_t count,
+                        uint32_t family_count) const {
+  // Each vertical slice holds a whole number of families and there are
+  // about as many slices as there are families in each slice.
+  uint32_t slice_count =
+      static_cast<uint32_t>(std::ceil(std::sqrt(family_count)));
+  uint32_t slice_size =
+      (family_count + slice_count - 1u) / slice_count * kMaxChildren;
+
+  // Sorting the centers along with the nodes is much faster than looking
+  // up the bounds of the nodes in each comparison.
+  struct Center {
+    float x;
+    float y;
+    int node;
+  };
+  std::vector<Center> centers(count);
+  for (uint32_t i = 0; i < count; i++) {
+    const SkRect& bounds = nodes_[order[i]].bounds;
+    centers[i] = {bounds.fLeft + bounds.fRight, bounds.fTop + bounds.fBottom,
+                  order[i]};
+  }
+  std::sort(centers.begin(), centers.end(),
+            [](const Center& a, const Center& b) { return a.x < b.x; });
+  for (uint32_t i = 0; i < count; i += slice_size) {
+    std::sort(centers.begin() + i,
+              centers.begin() + std::min(i + slice_size, count),
+              [](const Center& a, const Center& b) { return a.y < b.y; });
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    order[i] = centers[i].node;
+  }
+}
+
 DlRTree::DlRTree(const SkRect rects[],
                  int N,
                  const int ids[],
@@ -76,9 +152,30 @@ DlRTree::DlRTree(const SkRect rects[],
   // top to bottom (and left to right or right to left), the rectangles
   // are likely nearly sorted when they are delivered to this constructor
   // so leaving them in their original order should show similar results
-  // to what Skia found in their empirical browser tests.
+  // to what Skia found in their empirical browser tests. It also lets
+  // the search report its results in their original order for free.
+  //
+  // When the rectangles are not drawn in such an order, though, the
+  // groups of consecutive rectangles each span most of the content and
+  // a search has to visit most of the tree. So if the parents of the
+  // leaf nodes would overlap each other too much, every generation is
+  // instead grouped using Sort-Tile-Recursive (STR) packing, which sorts
+  // the nodes into vertical slices by the X coordinate of their centers
+  // and then by the Y coordinate within each slice so that each parent
+  // covers a compact tile. The leaf nodes stay in their original order
+  // at the start of |nodes_| and only their slots are reordered, which
+  // costs a sort of the results of each search.
   // ---
 
+  // If the tiles are sorted, the node in each slot of the generation
+  // being grouped.
+  bool sort_tiles = ShouldSortTiles(nodes_.data(), leaf_count);
+  std::vector<int> order;
+  if (sort_tiles) {
+    order.resize(total_node_count);
+    std::iota(order.begin(), order.end(), 0);
+  }
+
   // Continually process the previous level (generation) of nodes,
   // combining them into a new generation of parent groups each grouping
   // at most |kMaxChildren| children and joining their bounds into its
@@ -94,6 +191,21 @@ DlRTree::DlRTree(const SkRect rects[],
     uint32_t family_count = (gen_count + kMaxChildren - 1u) / kMaxChildren;
     FML_DCHECK(gen_end + family_count <= total_node_count);
 
+    if (sort_tiles) {
+      SortTiles(&order[gen_start], gen_count, family_count);
+      // The internal nodes of this generation have no parent yet, so
+      // they can be moved into their sorted order, which keeps the slot
+      // of an internal node equal to its index.
+      if (gen_start > 0) {
+        std::vector<Node> sorted(gen_count);
+        for (uint32_t i = 0; i < gen_count; i++) {
+          sorted[i] = nodes_[order[gen_start + i]];
+        }
+        std::copy(sorted.begin(), sorted.end(), nodes_.begin() + gen_start);
+        std::iota(&order[gen_start], &order[gen_end], gen_start);
+      }
+    }
+
     // D here is similar to the variable in a Bresenham line algorithm where
     // we want to slowly move |family_count| steps along the minor axis as
     // we move |gen_count| steps along the major axis.
@@ -127,7 +239,9 @@ DlRTree::DlRTree(const SkRect rects[],
         parent->child.count = 0;
       }
       FML_DCHECK(parent != nullptr);
-      parent->bounds.join(nodes_[sibling_index++].bounds);
+      parent->bounds.join(
+          nodes_[sort_tiles ? order[sibling_index] : sibling_index].bounds);
+      sibling_index++;
       parent->child.count++;
     }
     FML_DCHECK(D == 0);
@@ -137,6 +251,27 @@ DlRTree::DlRTree(const SkRect rects[],
     gen_count = family_count;
   }
   FML_DCHECK(gen_start + gen_count == total_node_count);
+
+  if (sort_tiles) {
+    order.resize(leaf_count);
+    leaf_order_ = std::move(order);
+  }
+
+  // Store the bounds of each slot in separate arrays, padded so that the
+  // last slots can be loaded 4 at a time.
+  size_t slot_count = total_node_count + 3u;
+  lefts_.resize(slot_count);
+  tops_.resize(slot_count);
+  rights_.resize(slot_count);
+  bottoms_.resize(slot_count);
+  for (uint32_t slot = 0; slot < total_node_count; slot++) {
+    const SkRect& rect =
+        nodes_[slot < leaf_order_.size() ? leaf_order_[slot] : slot].bounds;
+    lefts_[slot] = rect.fLeft;
+    tops_[slot] = rect.fTop;
+    rights_[slot] = rect.fRight;
+    bottoms_[slot] = rect.fBottom;
+  }
 }
 
 void DlRTree::search(const SkRect& query, std::vector<int>* results) const {
@@ -155,16 +290,53 @@ void DlRTree::search(const SkRect& query, std::vector<int>* results) const {
       // The root node is the only node and it is a leaf node
       results->push_back(0);
     } else {
+      size_t start = results->size();
       search(root, query, results);
+      if (!leaf_order_.empty()) {
+        // The leaf slots were sorted into tiles, restore the order in
+        // which the rects were passed to the constructor.
+        std::sort(results->begin() + start, results->end());
+      }
     }
   }
 }
 
+void DlRTree::search(const SkRect queries[],
+                     int count,
+                     std::vector<int>* results,
+                     std::vector<int>* offsets) const {
+  FML_DCHECK(results != nullptr);
+  FML_DCHECK(offsets != nullptr);
+  FML_DCHECK(count >= 0);
+  FML_DCHECK(queries != nullptr || count == 0);
+  results->clear();
+  offsets->resize(std::max(count, 0) + 1);
+  (*offsets)[0] = 0;
+  for (int i = 0; i < count; i++) {
+    search(queries[i], results);
+    (*offsets)[i + 1] = results->size();
+  }
+}
+
 std::list<SkRect> DlRTree::searchAndConsolidateRects(const SkRect& query,
                                                      bool deband) const {
+  std::vector<SkRect> results;
+  searchAndConsolidateRects(query, &results, deband);
+  return std::list<SkRect>(results.begin(), results.end());
+}
+
+void DlRTree::searchAndConsolidateRects(const SkRect& query,
+                                        std::vector<SkRect>* results,
+                                        bool deband) const {
+  FML_DCHECK(results != nullptr);
+  results->clear();
+
   // Get the indexes for the operations that intersect with the query rect.
   std::vector<int> intermediary_results;
   search(query, &intermediary_results);
+  if (intermediary_results.empty()) {
+    return;
+  }
 
   std::vector<SkIRect> rects;
   rects.reserve(intermediary_results.size());
@@ -176,31 +348,70 @@ std::list<SkRect> DlRTree::searchAndConsolidateRects(const SkRect& query,
   DlRegion region(rects);
 
   auto non_overlapping_rects = region.getRects(deband);
-  std::list<SkRect> final_results;
+  results->reserve(non_overlapping_rects.size());
   for (const auto& rect : non_overlapping_rects) {
-    final_results.push_back(SkRect::Make(rect));
+    results->push_back(SkRect::Make(rect));
   }
-  return final_results;
 }
 
 void DlRTree::search(const Node& parent,
                      const SkRect& query,
                      std::vector<int>* results) const {
   // Caller protects against empty query
-  int start = parent.child.index;
-  int end = start + parent.child.count;
-  for (int i = start; i < end; i++) {
-    const Node& node = nodes_[i];
-    if (node.bounds.intersects(query)) {
-      if (i < leaf_count_) {
-        results->push_back(i);
-      } else {
-        search(node, query, results);
+  uint32_t start = parent.child.index;
+  uint32_t end = start + parent.child.count;
+  for (uint32_t slot = start; slot < end; slot += 4) {
+    uint32_t hits = intersects4(slot, query);
+    if (end - slot < 4) {
+      hits &= (1u << (end - slot)) - 1u;
+    }
+    for (uint32_t i = 0; hits != 0; i++, hits >>= 1) {
+      if (hits & 1u) {
+        int index = slot + i;
+        if (index < leaf_count_) {
+          results->push_back(leaf_order_.empty() ? index : leaf_order_[index]);
+        } else {
+          search(nodes_[index], query, results);
+        }
       }
     }
   }
 }
 
+uint32_t DlRTree::intersects4(uint32_t slot, const SkRect& query) const {
+  // Same test as SkRect::intersects for a non-empty query.
+#if defined(__SSE__) || defined(_M_X64)
+  __m128 hit = _mm_and_ps(
+      _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&lefts_[slot]),
+                              _mm_set1_ps(query.fRight)),
+                 _mm_cmplt_ps(_mm_set1_ps(query.fLeft),
+                              _mm_loadu_ps(&rights_[slot]))),
+      _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&tops_[slot]),
+                              _mm_set1_ps(query.fBottom)),
+                 _mm_cmplt_ps(_mm_set1_ps(query.fTop),
+                              _mm_loadu_ps(&bottoms_[slot]))));
+  return _mm_movemask_ps(hit);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  uint32x4_t hit = vandq_u32(
+      vandq_u32(vcltq_f32(vld1q_f32(&lefts_[slot]), vdupq_n_f32(query.fRight)),
+                vcltq_f32(vdupq_n_f32(query.fLeft), vld1q_f32(&rights_[slot]))),
+      vandq_u32(
+          vcltq_f32(vld1q_f32(&tops_[slot]), vdupq_n_f32(query.fBottom)),
+          vcltq_f32(vdupq_n_f32(query.fTop), vld1q_f32(&bottoms_[slot]))));
+  static const uint32_t kLaneBits[4] = {1u, 2u, 4u, 8u};
+  return vaddvq_u32(vandq_u32(hit, vld1q_u32(kLaneBits)));
+#else
+  uint32_t hits = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    if (lefts_[slot + i] < query.fRight && query.fLeft < rights_[slot + i] &&
+        tops_[slot + i] < query.fBottom && query.fTop < bottoms_[slot + i]) {
+      hits |= 1u << i;
+    }
+  }
+  return hits;
+#endif
+}
+
 const DlRegion& DlRTree::region() const {
   if (!region_) {
     std::vector<SkIRect> rects;
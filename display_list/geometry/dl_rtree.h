@@ -21,7 +21,8 @@ namespace flutter {
 /// associated IDs.
 ///
 /// The R-Tree can be searched in one of two ways:
-/// - Query for a list of hits among the original rectangles
+/// - Query for a list of hits among the original rectangles, either
+///   one query at a time or for a batch of queries
 ///   @see |search|
 /// - Query for a set of non-overlapping rectangles that are joined
 ///   from the original rectangles that intersect a query rect
@@ -32,6 +33,14 @@ class DlRTree : public SkRefCnt {
 
   // Leaf nodes at start of vector have an ID,
   // Internal nodes after that have child index and count.
+  //
+  // The children of an internal node are identified by a contiguous
+  // range of "slots" whose bounds are also stored in the |lefts_|,
+  // |tops_|, |rights_| and |bottoms_| arrays so that several children
+  // can be tested against a query at once. Slots from |leaf_count_| on
+  // are the internal nodes with the same index. Slots below it are the
+  // leaf nodes with the same index, or, if the leaf nodes were sorted
+  // into tiles, the leaf nodes listed in |leaf_order_|.
   struct Node {
     SkRect bounds;
     union {
@@ -73,13 +82,28 @@ class DlRTree : public SkRefCnt {
   ///
   /// Note that the indices are internal indices of the stored data
   /// and not the index of the rectangles or ids in the constructor.
-  /// The returned indices may not themselves be in numerical order,
-  /// but they will represent the rectangles and IDs in the order in
-  /// which they were passed into the constructor. The actual rectangle
-  /// and ID associated with each index can be retrieved using the
-  /// |DlRTree::id| and |DlRTree::bounds| methods.
+  /// The returned indices will be in numerical order and will represent
+  /// the rectangles and IDs in the order in which they were passed into
+  /// the constructor. The actual rectangle and ID associated with each
+  /// index can be retrieved using the |DlRTree::id| and |DlRTree::bounds|
+  /// methods.
   void search(const SkRect& query, std::vector<int>* results) const;
 
+  /// Search the rectangles for each of the |count| queries and append
+  /// the leaf node indices that intersect them to a single |results|
+  /// vector.
+  ///
+  /// The |offsets| vector is filled with |count| + 1 entries such that
+  /// the results of |queries[i]| are found in |results| from index
+  /// |(*offsets)[i]| up to, but not including, |(*offsets)[i + 1]|, in
+  /// the same order that |search| would return them. Reusing the same
+  /// vectors from one batch to the next avoids allocating storage for
+  /// each query.
+  void search(const SkRect queries[],
+              int count,
+              std::vector<int>* results,
+              std::vector<int>* offsets) const;
+
   /// Return the ID for the indicated result of a query or
   /// invalid_id if the index is not a valid leaf node index.
   int id(int result_index) const {
@@ -102,7 +126,10 @@ class DlRTree : public SkRefCnt {
 
   /// Returns the bytes used by the object and all of its node data.
   size_t bytes_used() const {
-    return sizeof(DlRTree) + sizeof(Node) * nodes_.size();
+    return sizeof(DlRTree) + sizeof(Node) * nodes_.size() +
+           sizeof(int) * leaf_order_.size() +
+           sizeof(float) * (lefts_.size() + tops_.size() + rights_.size() +
+                            bottoms_.size());
   }
 
   /// Returns the number of leaf nodes corresponding to non-empty
@@ -126,6 +153,14 @@ class DlRTree : public SkRefCnt {
   std::list<SkRect> searchAndConsolidateRects(const SkRect& query,
                                               bool deband = true) const;
 
+  /// Finds the rects in the tree that intersect with the query rect
+  /// as with the version of this method that returns a list, but
+  /// replaces the contents of the |results| vector instead so that
+  /// callers can reuse its storage.
+  void searchAndConsolidateRects(const SkRect& query,
+                                 std::vector<SkRect>* results,
+                                 bool deband = true) const;
+
   /// Returns DlRegion that represents the union of all rectangles in the
   /// R-Tree.
   const DlRegion& region() const;
@@ -143,7 +178,20 @@ class DlRTree : public SkRefCnt {
               const SkRect& query,
               std::vector<int>* results) const;
 
+  // Returns a bit mask of which of the 4 slots starting at |slot|
+  // intersect the query.
+  uint32_t intersects4(uint32_t slot, const SkRect& query) const;
+
+  static bool ShouldSortTiles(const Node leaves[], int leaf_count);
+
+  void SortTiles(int order[], uint32_t count, uint32_t family_count) const;
+
   std::vector<Node> nodes_;
+  std::vector<int> leaf_order_;
+  std::vector<float> lefts_;
+  std::vector<float> tops_;
+  std::vector<float> rights_;
+  std::vector<float> bottoms_;
   int leaf_count_ = 0;
   int invalid_id_;
   mutable std::optional<DlRegion> region_;
@@ -319,5 +319,102 @@ TEST(DisplayListRTree, Region) {
   EXPECT_EQ(rects.size(), expected_rects.size());
 }
 
+TEST(DisplayListRTree, OutOfOrderRects) {
+  // The same grid of 10x10 rects spaced 20 pixels apart as in the
+  // Grid test, but passed to the R-Tree in a scattered order so that
+  // it sorts them into tiles.
+  const int ROWS = 40;
+  const int COLS = 40;
+  const int N = ROWS * COLS;
+  SkRect rects[N];
+  int ids[N];
+  for (int i = 0; i < N; i++) {
+    int cell = (i * 37) % N;
+    rects[i] = SkRect::MakeXYWH((cell % COLS) * 20, (cell / COLS) * 20, 10, 10);
+    ids[i] = i + 42;
+  }
+  DlRTree tree(rects, N, ids);
+  EXPECT_EQ(tree.leaf_count(), N);
+  EXPECT_GE(tree.node_count(), N);
+  EXPECT_EQ(tree.bounds(), SkRect::MakeLTRB(0, 0, 790, 790));
+  std::vector<int> results;
+  for (int r = 1; r < ROWS; r++) {
+    for (int c = 1; c < COLS; c++) {
+      auto desc =
+          "row " + std::to_string(r + 1) + ", col " + std::to_string(c + 1);
+      // Spanning the gap to the above and left of each rect for a quad
+      // of hits, which are returned in the order of the rects.
+      auto query = SkRect::MakeXYWH(c * 20 - 11, r * 20 - 11, 12, 12);
+      std::vector<int> expected;
+      for (int i = 0; i < N; i++) {
+        if (rects[i].intersects(query)) {
+          expected.push_back(i);
+        }
+      }
+      ASSERT_EQ(expected.size(), 4u) << desc;
+      results.clear();
+      tree.search(query, &results);
+      EXPECT_EQ(results, expected) << desc;
+      for (int index : results) {
+        EXPECT_EQ(tree.id(index), ids[index]) << desc;
+        EXPECT_EQ(tree.bounds(index), rects[index]) << desc;
+      }
+    }
+  }
+}
+
+TEST(DisplayListRTree, BatchSearch) {
+  const int N = 100;
+  SkRect rects[N];
+  for (int i = 0; i < N; i++) {
+    rects[i] = SkRect::MakeXYWH((i % 10) * 20, (i / 10) * 20, 15, 15);
+  }
+  DlRTree tree(rects, N);
+  SkRect queries[] = {
+      SkRect::MakeLTRB(0, 0, 1000, 1000),  // all of the rects
+      SkRect::MakeLTRB(16, 16, 19, 19),    // a gap between the rects
+      SkRect::MakeEmpty(),                 // an empty query
+      SkRect::MakeLTRB(25, 25, 50, 50),    // 4 rects
+      SkRect::MakeLTRB(-10, -10, 5, 5),    // the first rect
+  };
+  const int count = sizeof(queries) / sizeof(queries[0]);
+  std::vector<int> results = {1, 2, 3};
+  std::vector<int> offsets;
+  tree.search(queries, count, &results, &offsets);
+  ASSERT_EQ(offsets.size(), count + 1u);
+  EXPECT_EQ(offsets[0], 0);
+  EXPECT_EQ(offsets[count], static_cast<int>(results.size()));
+  for (int i = 0; i < count; i++) {
+    std::vector<int> expected;
+    tree.search(queries[i], &expected);
+    std::vector<int> batch(results.begin() + offsets[i],
+                           results.begin() + offsets[i + 1]);
+    EXPECT_EQ(batch, expected) << "query " << i;
+  }
+  EXPECT_EQ(offsets[1] - offsets[0], N);
+  EXPECT_EQ(offsets[2] - offsets[1], 0);
+  EXPECT_EQ(offsets[3] - offsets[2], 0);
+  EXPECT_EQ(offsets[4] - offsets[3], 4);
+  EXPECT_EQ(offsets[5] - offsets[4], 1);
+}
+
+TEST(DisplayListRTree, ConsolidateRectsIntoVector) {
+  SkRect rects[9];
+  for (int i = 0; i < 9; i++) {
+    rects[i] = SkRect::MakeXYWH(i * 10, i * 10, 20, 20);
+  }
+  DlRTree tree(rects, 9);
+  auto query = SkRect::MakeLTRB(0, 0, 55, 55);
+  std::vector<SkRect> results = {SkRect::MakeLTRB(1, 2, 3, 4)};
+  for (bool deband : {true, false}) {
+    tree.searchAndConsolidateRects(query, &results, deband);
+    auto list = tree.searchAndConsolidateRects(query, deband);
+    EXPECT_EQ(results, std::vector<SkRect>(list.begin(), list.end()));
+  }
+  tree.searchAndConsolidateRects(SkRect::MakeLTRB(200, 200, 300, 300),
+                                 &results);
+  EXPECT_TRUE(results.empty());
+}
+
 }  // namespace testing
 }  // namespace flutter
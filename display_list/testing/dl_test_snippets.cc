@@ -118,76 +118,75 @@ std::vector<DisplayListInvocationGroup> CreateAllAttributesOps() {
        }},
       {"SetColorSource",
        {
-           {0, 96, 0, [](DlOpReceiver& r) { r.setColorSource(&kTestSource1); }},
-           // stop_count * (sizeof(float) + sizeof(uint32_t)) = 80
-           {0, 80 + 6 * 4, 0,
+           {0, 8, 0, [](DlOpReceiver& r) { r.setColorSource(&kTestSource1); }},
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setColorSource(kTestSource2.get()); }},
-           {0, 80 + 6 * 4, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setColorSource(kTestSource3.get()); }},
-           {0, 88 + 6 * 4, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setColorSource(kTestSource4.get()); }},
-           {0, 80 + 6 * 4, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setColorSource(kTestSource5.get()); }},
            {0, 0, 0, [](DlOpReceiver& r) { r.setColorSource(nullptr); }},
        }},
       {"SetImageFilter",
        {
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestBlurImageFilter1); }},
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestBlurImageFilter2); }},
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestBlurImageFilter3); }},
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestBlurImageFilter4); }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestDilateImageFilter1);
             }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestDilateImageFilter2);
             }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestDilateImageFilter3);
             }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestErodeImageFilter1); }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestErodeImageFilter2); }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestErodeImageFilter3); }},
-           {0, 64, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestMatrixImageFilter1);
             }},
-           {0, 64, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestMatrixImageFilter2);
             }},
-           {0, 64, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestMatrixImageFilter3);
             }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestComposeImageFilter1);
             }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestComposeImageFilter2);
             }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(&kTestComposeImageFilter3);
             }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestCFImageFilter1); }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setImageFilter(&kTestCFImageFilter2); }},
            {0, 0, 0, [](DlOpReceiver& r) { r.setImageFilter(nullptr); }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setImageFilter(
                   kTestBlurImageFilter1
@@ -197,25 +196,25 @@ std::vector<DisplayListInvocationGroup> CreateAllAttributesOps() {
        }},
       {"SetColorFilter",
        {
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setColorFilter(&kTestBlendColorFilter1); }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setColorFilter(&kTestBlendColorFilter2); }},
-           {0, 24, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setColorFilter(&kTestBlendColorFilter3); }},
-           {0, 96, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setColorFilter(&kTestMatrixColorFilter1);
             }},
-           {0, 96, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setColorFilter(&kTestMatrixColorFilter2);
             }},
-           {0, 16, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setColorFilter(DlSrgbToLinearGammaColorFilter::kInstance.get());
             }},
-           {0, 16, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) {
               r.setColorFilter(DlLinearToSrgbGammaColorFilter::kInstance.get());
             }},
@@ -223,19 +222,19 @@ std::vector<DisplayListInvocationGroup> CreateAllAttributesOps() {
        }},
       {"SetMaskFilter",
        {
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setMaskFilter(&kTestMaskFilter1); }, 0u,
             2u},
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setMaskFilter(&kTestMaskFilter2); }, 0u,
             2u},
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setMaskFilter(&kTestMaskFilter3); }, 0u,
             2u},
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setMaskFilter(&kTestMaskFilter4); }, 0u,
             2u},
-           {0, 32, 0,
+           {0, 8, 0,
             [](DlOpReceiver& r) { r.setMaskFilter(&kTestMaskFilter5); }, 0u,
             2u},
            {0, 0, 0, [](DlOpReceiver& r) { r.setMaskFilter(nullptr); }, 0u, 1u},
@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_FORMAT_H_
+#define FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_FORMAT_H_
+
+#include <cstdint>
+
+#include "third_party/skia/include/core/SkRect.h"
+
+// The DisplayList binary format, used to persist display lists for capture
+// and offline replay. See DlBinaryWriter and DlBinaryReader.
+//
+// A serialized display list is laid out as:
+//
+//   DlBinaryHeader
+//   side tables, |image_count| images, then |effect_count| runtime effects,
+//       then |display_list_count| nested display lists
+//   op records, |ops_size| bytes
+//
+// Each side table entry is a uint32_t byte size followed by the entry data:
+//
+//   image         int32_t width, int32_t height, then width * height
+//                 premultiplied RGBA 8888 pixels, or no pixels for a
+//                 placeholder of an image that was not readable on the CPU,
+//                 such as a GPU texture
+//   effect        the SkSL source of a Skia runtime effect
+//   display list  a complete serialized display list, with its own header
+//
+// Each op record starts with a DlBinaryOpHeader and is followed by the
+// arguments of the op, in the order of the matching DlOpReceiver method.
+// Attribute objects (color sources, filters) are written as a uint32_t type
+// tag followed by their fields, images, runtime effects and nested display
+// lists as the uint32_t index of their side table entry.
+//
+// Impeller text frames can not be rebuilt without their fonts, so they are
+// written as placeholder records with their bounds, which readers replay as
+// rectangles drawn with the text paint.
+//
+// All values are in the native byte order, and every entry and record is
+// padded to a multiple of 4 bytes so that arrays of points, rects and colors
+// can be used directly from a memory mapped file.
+
+namespace flutter {
+
+static constexpr uint32_t kDlBinaryMagic = 0x46424C44;  // "DLBF"
+
+// Incremented whenever the format changes in an incompatible way. Readers
+// reject files with a different version.
+static constexpr uint32_t kDlBinaryVersion = 2;
+
+struct DlBinaryHeader {
+  uint32_t magic;
+  uint32_t version;
+  SkRect bounds;
+  uint32_t op_count;
+  uint32_t image_count;
+  uint32_t effect_count;
+  uint32_t display_list_count;
+  uint32_t tables_size;
+  uint32_t ops_size;
+};
+
+// New ops must only be appended, existing values are part of the format.
+enum class DlBinaryOp : uint16_t {
+  kSetAntiAlias,
+  kSetInvertColors,
+  kSetStrokeCap,
+  kSetStrokeJoin,
+  kSetDrawStyle,
+  kSetStrokeWidth,
+  kSetStrokeMiter,
+  kSetColor,
+  kSetBlendMode,
+  kSetColorSource,
+  kSetColorFilter,
+  kSetMaskFilter,
+  kSetImageFilter,
+
+  kSave,
+  kSaveLayer,
+  kRestore,
+
+  kTranslate,
+  kScale,
+  kRotate,
+  kSkew,
+  kTransform2DAffine,
+  kTransformFullPerspective,
+  kTransformReset,
+
+  kClipRect,
+  kClipRRect,
+  kClipPath,
+
+  kDrawColor,
+  kDrawPaint,
+  kDrawLine,
+  kDrawDashedLine,
+  kDrawRect,
+  kDrawOval,
+  kDrawCircle,
+  kDrawRRect,
+  kDrawDRRect,
+  kDrawPath,
+  kDrawArc,
+  kDrawPoints,
+  kDrawVertices,
+  kDrawImage,
+  kDrawImageRect,
+  kDrawImageNine,
+  kDrawAtlas,
+  kDrawDisplayList,
+  kDrawTextBlob,
+  kDrawShadow,
+  kDrawTextFrame,
+
+  kLastOp = kDrawTextFrame,
+};
+
+struct DlBinaryOpHeader {
+  DlBinaryOp op;
+  uint16_t reserved;
+  // Size of the record including this header.
+  uint32_t size;
+};
+
+// Type tags of attribute objects. Zero is a null object.
+enum class DlBinaryColorSource : uint32_t {
+  kNone,
+  kColor,
+  kImage,
+  kLinearGradient,
+  kRadialGradient,
+  kConicalGradient,
+  kSweepGradient,
+  kRuntimeEffect,
+};
+
+enum class DlBinaryColorFilter : uint32_t {
+  kNone,
+  kBlend,
+  kMatrix,
+  kSrgbToLinearGamma,
+  kLinearToSrgbGamma,
+};
+
+enum class DlBinaryImageFilter : uint32_t {
+  kNone,
+  kBlur,
+  kDilate,
+  kErode,
+  kMatrix,
+  kCompose,
+  kColorFilter,
+  kLocalMatrix,
+};
+
+enum class DlBinaryMaskFilter : uint32_t {
+  kNone,
+  kBlur,
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_FORMAT_H_
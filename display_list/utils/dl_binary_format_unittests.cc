@@ -0,0 +1,222 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstring>
+#include <set>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/display_list/utils/dl_binary_reader.h"
+#include "flutter/display_list/utils/dl_binary_writer.h"
+#include "flutter/impeller/typographer/backends/skia/text_frame_skia.h"
+#include "flutter/testing/testing.h"
+#include "txt/platform.h"
+
+namespace flutter {
+
+DlOpReceiver& DisplayListBuilderTestingAccessor(DisplayListBuilder& builder);
+
+namespace testing {
+
+namespace {
+
+sk_sp<DisplayList> Build(DisplayListInvocation& invocation) {
+  DisplayListBuilder builder;
+  invocation.Invoke(DisplayListBuilderTestingAccessor(builder));
+  return builder.Build();
+}
+
+std::shared_ptr<fml::Mapping> Copy(const fml::Mapping& mapping, size_t size) {
+  std::vector<uint8_t> data(mapping.GetMapping(),
+                            mapping.GetMapping() + size);
+  return std::make_shared<fml::DataMapping>(std::move(data));
+}
+
+// An image whose pixels are only on the GPU.
+class TextureImage final : public DlImage {
+ public:
+  explicit TextureImage(SkISize size) : size_(size) {}
+
+  sk_sp<SkImage> skia_image() const override { return nullptr; }
+  std::shared_ptr<impeller::Texture> impeller_texture() const override {
+    return nullptr;
+  }
+  bool isOpaque() const override { return false; }
+  bool isTextureBacked() const override { return true; }
+  bool isUIThreadSafe() const override { return true; }
+  SkISize dimensions() const override { return size_; }
+  size_t GetApproximateByteSize() const override { return sizeof(*this); }
+
+ private:
+  const SkISize size_;
+};
+
+sk_sp<DisplayList> Nest(sk_sp<DisplayList> display_list, int depth) {
+  for (int i = 0; i < depth; i++) {
+    DisplayListBuilder builder;
+    builder.DrawDisplayList(display_list);
+    display_list = builder.Build();
+  }
+  return display_list;
+}
+
+}  // namespace
+
+TEST(DlBinaryFormatTest, SingleOpDisplayListsRoundTrip) {
+  // Images, text blobs and the image color source are compared by reference
+  // in DisplayList::Equals, while reading them back creates new objects.
+  const std::set<std::string> compared_by_reference = {
+      "SetColorSource", "DrawImage",  "DrawImageRect",
+      "DrawImageNine",  "DrawAtlas",  "DrawTextBlob",
+  };
+  for (auto& group : CreateAllGroups()) {
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      auto desc = group.op_name + "(variant " + std::to_string(i + 1) + ")";
+      sk_sp<DisplayList> dl = Build(group.variants[i]);
+
+      std::shared_ptr<fml::Mapping> data = DlBinaryWriter::Serialize(*dl);
+      ASSERT_NE(data, nullptr) << desc;
+      DlBinaryReader reader(data, txt::GetDefaultFontManager());
+      ASSERT_TRUE(reader.IsValid()) << desc;
+      EXPECT_EQ(reader.bounds(), dl->bounds()) << desc;
+
+      sk_sp<DisplayList> copy = reader.Build();
+      ASSERT_NE(copy, nullptr) << desc;
+      EXPECT_EQ(copy->op_count(true), dl->op_count(true)) << desc;
+      EXPECT_EQ(copy->bytes(true), dl->bytes(true)) << desc;
+      EXPECT_EQ(copy->bounds(), dl->bounds()) << desc;
+      if (compared_by_reference.count(group.op_name) == 0) {
+        EXPECT_TRUE(copy->Equals(*dl)) << desc;
+      }
+    }
+  }
+}
+
+TEST(DlBinaryFormatTest, SharedImagesAreStoredOnce) {
+  auto image = MakeTestImage(40, 40, 5);
+  DisplayListBuilder builder;
+  builder.DrawImage(image, SkPoint::Make(0, 0), DlImageSampling::kLinear);
+  builder.DrawImage(image, SkPoint::Make(50, 0), DlImageSampling::kLinear);
+  auto dl = builder.Build();
+
+  std::shared_ptr<fml::Mapping> data = DlBinaryWriter::Serialize(*dl);
+  ASSERT_NE(data, nullptr);
+  DlBinaryHeader header;
+  memcpy(&header, data->GetMapping(), sizeof(header));
+  EXPECT_EQ(header.image_count, 1u);
+  EXPECT_EQ(header.op_count, 2u);
+  EXPECT_GT(header.tables_size, 40u * 40u * 4u);
+
+  DlBinaryReader reader(data);
+  ASSERT_TRUE(reader.IsValid());
+  auto copy = reader.Build();
+  ASSERT_NE(copy, nullptr);
+  EXPECT_EQ(copy->op_count(), 2u);
+  EXPECT_EQ(copy->bounds(), dl->bounds());
+}
+
+TEST(DlBinaryFormatTest, TextureImagesAreWrittenAsPlaceholders) {
+  auto image = sk_make_sp<TextureImage>(SkISize::Make(30, 20));
+  DisplayListBuilder builder;
+  builder.DrawImage(image, SkPoint::Make(10, 10), DlImageSampling::kLinear);
+  builder.DrawRect(SkRect::MakeLTRB(50, 50, 60, 60), DlPaint());
+  auto dl = builder.Build();
+
+  std::shared_ptr<fml::Mapping> data = DlBinaryWriter::Serialize(*dl);
+  ASSERT_NE(data, nullptr);
+  DlBinaryHeader header;
+  memcpy(&header, data->GetMapping(), sizeof(header));
+  EXPECT_EQ(header.image_count, 1u);
+  EXPECT_LT(header.tables_size, 30u * 20u * 4u);
+
+  DlBinaryReader reader(data);
+  ASSERT_TRUE(reader.IsValid());
+  auto copy = reader.Build();
+  ASSERT_NE(copy, nullptr);
+  EXPECT_EQ(copy->op_count(), 2u);
+  EXPECT_EQ(copy->bounds(), dl->bounds());
+  EXPECT_EQ(copy->bounds(), SkRect::MakeLTRB(10, 10, 60, 60));
+}
+
+TEST(DlBinaryFormatTest, TextFramesAreWrittenAsPlaceholders) {
+  auto text_frame =
+      impeller::MakeTextFrameFromTextBlobSkia(GetTestTextBlob(1));
+  DisplayListBuilder builder;
+  builder.DrawTextFrame(text_frame, 10, 20, DlPaint());
+  builder.DrawRect(SkRect::MakeLTRB(50, 50, 60, 60), DlPaint());
+  auto dl = builder.Build();
+
+  std::shared_ptr<fml::Mapping> data = DlBinaryWriter::Serialize(*dl);
+  ASSERT_NE(data, nullptr);
+  DlBinaryReader reader(data);
+  ASSERT_TRUE(reader.IsValid());
+  auto copy = reader.Build();
+  ASSERT_NE(copy, nullptr);
+  EXPECT_EQ(copy->op_count(), dl->op_count());
+  EXPECT_EQ(copy->bounds(), dl->bounds());
+}
+
+TEST(DlBinaryFormatTest, LimitsDisplayListNesting) {
+  std::shared_ptr<fml::Mapping> data =
+      DlBinaryWriter::Serialize(*Nest(GetSampleDisplayList(), 16));
+  ASSERT_NE(data, nullptr);
+  EXPECT_TRUE(DlBinaryReader(data).IsValid());
+
+  data = DlBinaryWriter::Serialize(*Nest(GetSampleDisplayList(), 100));
+  ASSERT_NE(data, nullptr);
+  EXPECT_FALSE(DlBinaryReader(data).IsValid());
+}
+
+TEST(DlBinaryFormatTest, RejectsOtherData) {
+  std::vector<uint8_t> zeros(sizeof(DlBinaryHeader) + 64, 0);
+  DlBinaryReader reader(std::make_shared<fml::DataMapping>(zeros));
+  EXPECT_FALSE(reader.IsValid());
+  EXPECT_EQ(reader.Build(), nullptr);
+}
+
+TEST(DlBinaryFormatTest, RejectsOtherVersions) {
+  std::shared_ptr<fml::Mapping> data =
+      DlBinaryWriter::Serialize(*GetSampleDisplayList());
+  ASSERT_NE(data, nullptr);
+  std::vector<uint8_t> bytes(data->GetMapping(),
+                             data->GetMapping() + data->GetSize());
+  uint32_t version = kDlBinaryVersion + 1;
+  memcpy(bytes.data() + offsetof(DlBinaryHeader, version), &version,
+         sizeof(version));
+  DlBinaryReader reader(std::make_shared<fml::DataMapping>(bytes));
+  EXPECT_FALSE(reader.IsValid());
+}
+
+TEST(DlBinaryFormatTest, RejectsTruncatedData) {
+  std::shared_ptr<fml::Mapping> data =
+      DlBinaryWriter::Serialize(*GetSampleDisplayList());
+  ASSERT_NE(data, nullptr);
+  for (size_t size = 0; size < data->GetSize(); size += 4) {
+    DlBinaryReader reader(Copy(*data, size));
+    EXPECT_FALSE(reader.IsValid()) << size;
+  }
+}
+
+TEST(DlBinaryFormatTest, RejectsMalformedOps) {
+  std::shared_ptr<fml::Mapping> data =
+      DlBinaryWriter::Serialize(*GetSampleDisplayList());
+  ASSERT_NE(data, nullptr);
+  std::vector<uint8_t> bytes(data->GetMapping(),
+                             data->GetMapping() + data->GetSize());
+  DlBinaryHeader header;
+  memcpy(&header, bytes.data(), sizeof(header));
+  ASSERT_GT(header.op_count, 0u);
+
+  // Make the first op claim to extend past the end of the ops.
+  size_t first_op = sizeof(header) + header.tables_size;
+  uint32_t size = header.ops_size + 4;
+  memcpy(bytes.data() + first_op + offsetof(DlBinaryOpHeader, size), &size,
+         sizeof(size));
+  DlBinaryReader reader(std::make_shared<fml::DataMapping>(bytes));
+  ASSERT_TRUE(reader.IsValid());
+  EXPECT_EQ(reader.Build(), nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
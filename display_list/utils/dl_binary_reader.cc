@@ -0,0 +1,962 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/utils/dl_binary_reader.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+#include "third_party/skia/include/effects/SkRuntimeEffect.h"
+
+namespace flutter {
+
+namespace {
+
+// Limits the recursion of nested filters and color sources in malformed
+// files.
+constexpr int kMaxAttributeDepth = 32;
+
+// Limits the recursion of nested display lists in malformed files.
+constexpr int kMaxDisplayListDepth = 64;
+
+// Limits the size of the placeholders of images that were not readable when
+// they were written, which take no space in the file.
+constexpr int32_t kMaxPlaceholderDimension = 16384;
+
+// The color of image placeholders.
+constexpr SkColor kPlaceholderColor = SK_ColorMAGENTA;
+
+sk_sp<SkTypeface> DeserializeTypeface(const void* data,
+                                      size_t length,
+                                      void* ctx) {
+  SkMemoryStream stream(data, length, false);
+  return SkTypeface::MakeDeserialize(&stream,
+                                     sk_ref_sp(static_cast<SkFontMgr*>(ctx)));
+}
+
+}  // namespace
+
+// Bounds checked reads from a range of the mapping. Once a read fails, every
+// later read returns zeros and |ok| returns false.
+class DlBinaryReader::Cursor {
+ public:
+  Cursor(const uint8_t* data, size_t size) : data_(data), end_(data + size) {}
+
+  bool ok() const { return ok_; }
+  const uint8_t* position() const { return data_; }
+  size_t remaining() const { return end_ - data_; }
+
+  const uint8_t* ReadBytes(size_t size) {
+    if (!ok_ || size > remaining()) {
+      ok_ = false;
+      return nullptr;
+    }
+    const uint8_t* bytes = data_;
+    data_ += size;
+    return bytes;
+  }
+
+  template <class T>
+  T Read() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value = {};
+    const uint8_t* bytes = ReadBytes(sizeof(T));
+    if (bytes) {
+      memcpy(&value, bytes, sizeof(T));
+    }
+    return value;
+  }
+
+  // Returns the array in place, which the writer aligned to 4 bytes.
+  template <class T>
+  const T* ReadArray(size_t count) {
+    static_assert(alignof(T) <= 4);
+    if (count > remaining() / sizeof(T)) {
+      ok_ = false;
+      return nullptr;
+    }
+    return reinterpret_cast<const T*>(ReadBytes(count * sizeof(T)));
+  }
+
+  bool ReadBool() { return Read<uint32_t>() != 0; }
+
+  template <class E>
+  E ReadEnum(E last) {
+    uint32_t value = Read<uint32_t>();
+    if (value > static_cast<uint32_t>(last)) {
+      ok_ = false;
+      return static_cast<E>(0);
+    }
+    return static_cast<E>(value);
+  }
+
+  DlImageSampling ReadSampling() {
+    return ReadEnum(DlImageSampling::kCubic);
+  }
+
+  // A uint32_t index into a side table of |size| entries.
+  uint32_t ReadIndex(size_t size) {
+    uint32_t index = Read<uint32_t>();
+    if (index >= size) {
+      ok_ = false;
+      return 0;
+    }
+    return index;
+  }
+
+  SkMatrix ReadMatrix() {
+    const SkScalar* values = ReadArray<SkScalar>(9);
+    SkMatrix matrix;
+    if (values) {
+      matrix.set9(values);
+    }
+    return matrix;
+  }
+
+  SkRRect ReadRRect() {
+    SkRRect rrect;
+    const uint8_t* data = ReadBytes(SkRRect::kSizeInMemory);
+    if (data && rrect.readFromMemory(data, SkRRect::kSizeInMemory) == 0) {
+      ok_ = false;
+    }
+    return rrect;
+  }
+
+  SkPath ReadPath() {
+    SkPath path;
+    uint32_t size = Read<uint32_t>();
+    const uint8_t* data = ReadBytes(size);
+    if (data && path.readFromMemory(data, size) == 0) {
+      ok_ = false;
+    }
+    Pad();
+    return path;
+  }
+
+  void Pad() {
+    size_t padding = (4 - (reinterpret_cast<uintptr_t>(data_) & 3)) & 3;
+    if (padding > 0 && padding <= remaining()) {
+      data_ += padding;
+    }
+  }
+
+  bool EnterAttribute() {
+    if (++depth_ > kMaxAttributeDepth) {
+      ok_ = false;
+    }
+    return ok_;
+  }
+  void ExitAttribute() { depth_--; }
+
+ private:
+  const uint8_t* data_;
+  const uint8_t* end_;
+  int depth_ = 0;
+  bool ok_ = true;
+};
+
+DlBinaryReader::DlBinaryReader(std::shared_ptr<const fml::Mapping> mapping,
+                               sk_sp<SkFontMgr> font_manager)
+    : DlBinaryReader(std::move(mapping), std::move(font_manager), 0) {}
+
+DlBinaryReader::DlBinaryReader(std::shared_ptr<const fml::Mapping> mapping,
+                               sk_sp<SkFontMgr> font_manager,
+                               int depth)
+    : mapping_(std::move(mapping)),
+      font_manager_(std::move(font_manager)),
+      depth_(depth) {
+  if (!mapping_ || !mapping_->GetMapping()) {
+    return;
+  }
+  if (depth_ > kMaxDisplayListDepth) {
+    FML_LOG(ERROR) << "Serialized display list is nested too deeply.";
+    return;
+  }
+  if (reinterpret_cast<uintptr_t>(mapping_->GetMapping()) & 3) {
+    FML_LOG(ERROR) << "Serialized display list is not aligned.";
+    return;
+  }
+  Cursor cursor(mapping_->GetMapping(), mapping_->GetSize());
+  header_ = cursor.Read<DlBinaryHeader>();
+  if (!cursor.ok() || header_.magic != kDlBinaryMagic) {
+    FML_LOG(ERROR) << "Not a serialized display list.";
+    return;
+  }
+  if (header_.version != kDlBinaryVersion) {
+    FML_LOG(ERROR) << "Unsupported serialized display list version "
+                   << header_.version << ", expected " << kDlBinaryVersion
+                   << ".";
+    return;
+  }
+  if (header_.tables_size > cursor.remaining() ||
+      header_.ops_size != cursor.remaining() - header_.tables_size) {
+    FML_LOG(ERROR) << "Serialized display list is truncated.";
+    return;
+  }
+  Cursor tables(cursor.position(), header_.tables_size);
+  if (!ReadTables(tables) || tables.remaining() != 0) {
+    FML_LOG(ERROR) << "Serialized display list has malformed side tables.";
+    return;
+  }
+  ops_ = cursor.position() + header_.tables_size;
+  is_valid_ = true;
+}
+
+DlBinaryReader::~DlBinaryReader() = default;
+
+bool DlBinaryReader::ReadTables(Cursor& cursor) {
+  for (uint32_t i = 0; i < header_.image_count; i++) {
+    uint32_t size = cursor.Read<uint32_t>();
+    int32_t width = cursor.Read<int32_t>();
+    int32_t height = cursor.Read<int32_t>();
+    if (!cursor.ok() || width <= 0 || height <= 0 ||
+        size < 2 * sizeof(int32_t)) {
+      return false;
+    }
+    SkImageInfo info = SkImageInfo::Make(width, height, kRGBA_8888_SkColorType,
+                                         kPremul_SkAlphaType);
+    size_t pixels_size = size - 2 * sizeof(int32_t);
+    sk_sp<SkImage> image;
+    if (pixels_size == 0) {
+      if (width > kMaxPlaceholderDimension ||
+          height > kMaxPlaceholderDimension) {
+        return false;
+      }
+      SkBitmap bitmap;
+      if (!bitmap.tryAllocPixels(info)) {
+        return false;
+      }
+      bitmap.eraseColor(kPlaceholderColor);
+      bitmap.setImmutable();
+      image = bitmap.asImage();
+    } else {
+      if (pixels_size != info.computeMinByteSize()) {
+        return false;
+      }
+      const uint8_t* pixels = cursor.ReadBytes(pixels_size);
+      cursor.Pad();
+      if (!pixels) {
+        return false;
+      }
+      image = SkImages::RasterFromData(
+          info, SkData::MakeWithCopy(pixels, pixels_size), info.minRowBytes());
+    }
+    if (!image) {
+      return false;
+    }
+    images_.push_back(DlImage::Make(std::move(image)));
+  }
+
+  for (uint32_t i = 0; i < header_.effect_count; i++) {
+    uint32_t size = cursor.Read<uint32_t>();
+    const uint8_t* source = cursor.ReadBytes(size);
+    cursor.Pad();
+    if (!source) {
+      return false;
+    }
+    auto result = SkRuntimeEffect::MakeForShader(
+        SkString(reinterpret_cast<const char*>(source), size));
+    if (!result.effect) {
+      FML_LOG(ERROR) << "Could not compile runtime effect: "
+                     << result.errorText.c_str();
+      return false;
+    }
+    effects_.push_back(DlRuntimeEffect::MakeSkia(result.effect));
+  }
+
+  for (uint32_t i = 0; i < header_.display_list_count; i++) {
+    uint32_t size = cursor.Read<uint32_t>();
+    const uint8_t* data = cursor.ReadBytes(size);
+    cursor.Pad();
+    if (!data) {
+      return false;
+    }
+    // The nested reader is only used to build the display list, so it can
+    // borrow the bytes of this mapping.
+    DlBinaryReader nested(std::make_shared<fml::NonOwnedMapping>(data, size),
+                          font_manager_, depth_ + 1);
+    sk_sp<DisplayList> display_list = nested.Build();
+    if (!display_list) {
+      return false;
+    }
+    display_lists_.push_back(std::move(display_list));
+  }
+  return cursor.ok();
+}
+
+sk_sp<DisplayList> DlBinaryReader::Build() const {
+  if (!is_valid_) {
+    return nullptr;
+  }
+  DisplayListBuilder builder;
+  if (!Dispatch(builder.asReceiver())) {
+    return nullptr;
+  }
+  return builder.Build();
+}
+
+bool DlBinaryReader::Dispatch(DlOpReceiver& receiver) const {
+  if (!is_valid_) {
+    return false;
+  }
+  Cursor cursor(ops_, header_.ops_size);
+  for (uint32_t i = 0; i < header_.op_count; i++) {
+    auto header = cursor.Read<DlBinaryOpHeader>();
+    if (!cursor.ok() || header.op > DlBinaryOp::kLastOp ||
+        header.size < sizeof(header) ||
+        header.size - sizeof(header) > cursor.remaining()) {
+      FML_LOG(ERROR) << "Malformed op " << i << " in serialized display list.";
+      return false;
+    }
+    Cursor record(cursor.position(), header.size - sizeof(header));
+    if (!DispatchOp(header.op, record, receiver)) {
+      FML_LOG(ERROR) << "Malformed op " << i << " in serialized display list.";
+      return false;
+    }
+    cursor.ReadBytes(header.size - sizeof(header));
+  }
+  return true;
+}
+
+sk_sp<DlImage> DlBinaryReader::ReadImage(Cursor& cursor) const {
+  uint32_t index = cursor.ReadIndex(images_.size());
+  return cursor.ok() ? images_[index] : nullptr;
+}
+
+std::shared_ptr<DlColorSource> DlBinaryReader::ReadColorSource(
+    Cursor& cursor) const {
+  if (!cursor.EnterAttribute()) {
+    return nullptr;
+  }
+  std::shared_ptr<DlColorSource> source;
+  auto type = cursor.ReadEnum(DlBinaryColorSource::kRuntimeEffect);
+  switch (type) {
+    case DlBinaryColorSource::kNone:
+      break;
+    case DlBinaryColorSource::kColor:
+      source = std::make_shared<DlColorColorSource>(cursor.Read<DlColor>());
+      break;
+    case DlBinaryColorSource::kImage: {
+      sk_sp<DlImage> image = ReadImage(cursor);
+      auto h_tile = cursor.ReadEnum(DlTileMode::kDecal);
+      auto v_tile = cursor.ReadEnum(DlTileMode::kDecal);
+      DlImageSampling sampling = cursor.ReadSampling();
+      SkMatrix matrix = cursor.ReadMatrix();
+      if (cursor.ok()) {
+        source = std::make_shared<DlImageColorSource>(image, h_tile, v_tile,
+                                                      sampling, &matrix);
+      }
+      break;
+    }
+    case DlBinaryColorSource::kLinearGradient:
+    case DlBinaryColorSource::kRadialGradient:
+    case DlBinaryColorSource::kConicalGradient:
+    case DlBinaryColorSource::kSweepGradient: {
+      SkPoint p0 = cursor.Read<SkPoint>();
+      SkScalar r0 = 0;
+      SkPoint p1 = SkPoint::Make(0, 0);
+      SkScalar r1 = 0;
+      if (type != DlBinaryColorSource::kLinearGradient) {
+        r0 = cursor.Read<SkScalar>();
+      }
+      if (type == DlBinaryColorSource::kLinearGradient ||
+          type == DlBinaryColorSource::kConicalGradient) {
+        p1 = cursor.Read<SkPoint>();
+      }
+      if (type == DlBinaryColorSource::kConicalGradient ||
+          type == DlBinaryColorSource::kSweepGradient) {
+        r1 = cursor.Read<SkScalar>();
+      }
+      uint32_t stop_count = cursor.Read<uint32_t>();
+      const DlColor* colors = cursor.ReadArray<DlColor>(stop_count);
+      const float* stops = cursor.ReadArray<float>(stop_count);
+      auto tile_mode = cursor.ReadEnum(DlTileMode::kDecal);
+      SkMatrix matrix = cursor.ReadMatrix();
+      if (!cursor.ok()) {
+        break;
+      }
+      switch (type) {
+        case DlBinaryColorSource::kLinearGradient:
+          source = DlColorSource::MakeLinear(p0, p1, stop_count, colors, stops,
+                                             tile_mode, &matrix);
+          break;
+        case DlBinaryColorSource::kRadialGradient:
+          source = DlColorSource::MakeRadial(p0, r0, stop_count, colors, stops,
+                                             tile_mode, &matrix);
+          break;
+        case DlBinaryColorSource::kConicalGradient:
+          source = DlColorSource::MakeConical(p0, r0, p1, r1, stop_count,
+                                              colors, stops, tile_mode,
+                                              &matrix);
+          break;
+        default:
+          source = DlColorSource::MakeSweep(p0, r0, r1, stop_count, colors,
+                                            stops, tile_mode, &matrix);
+          break;
+      }
+      break;
+    }
+    case DlBinaryColorSource::kRuntimeEffect: {
+      uint32_t effect_index = cursor.ReadIndex(effects_.size());
+      uint32_t sampler_count = cursor.Read<uint32_t>();
+      std::vector<std::shared_ptr<DlColorSource>> samplers;
+      for (uint32_t i = 0; i < sampler_count && cursor.ok(); i++) {
+        samplers.push_back(ReadColorSource(cursor));
+      }
+      uint32_t uniform_size = cursor.Read<uint32_t>();
+      const uint8_t* uniforms = cursor.ReadBytes(uniform_size);
+      cursor.Pad();
+      if (cursor.ok()) {
+        source = DlColorSource::MakeRuntimeEffect(
+            effects_[effect_index], std::move(samplers),
+            std::make_shared<std::vector<uint8_t>>(uniforms,
+                                                   uniforms + uniform_size));
+      }
+      break;
+    }
+  }
+  cursor.ExitAttribute();
+  return source;
+}
+
+std::shared_ptr<DlColorFilter> DlBinaryReader::ReadColorFilter(
+    Cursor& cursor) const {
+  switch (cursor.ReadEnum(DlBinaryColorFilter::kLinearToSrgbGamma)) {
+    case DlBinaryColorFilter::kNone:
+      return nullptr;
+    case DlBinaryColorFilter::kBlend: {
+      DlColor color = cursor.Read<DlColor>();
+      DlBlendMode mode = cursor.ReadEnum(DlBlendMode::kLastMode);
+      return std::make_shared<DlBlendColorFilter>(color, mode);
+    }
+    case DlBinaryColorFilter::kMatrix: {
+      const float* matrix = cursor.ReadArray<float>(20);
+      if (!matrix) {
+        return nullptr;
+      }
+      return std::make_shared<DlMatrixColorFilter>(matrix);
+    }
+    case DlBinaryColorFilter::kSrgbToLinearGamma:
+      return DlSrgbToLinearGammaColorFilter::kInstance;
+    case DlBinaryColorFilter::kLinearToSrgbGamma:
+      return DlLinearToSrgbGammaColorFilter::kInstance;
+  }
+}
+
+std::shared_ptr<DlImageFilter> DlBinaryReader::ReadImageFilter(
+    Cursor& cursor) const {
+  if (!cursor.EnterAttribute()) {
+    return nullptr;
+  }
+  std::shared_ptr<DlImageFilter> filter;
+  switch (cursor.ReadEnum(DlBinaryImageFilter::kLocalMatrix)) {
+    case DlBinaryImageFilter::kNone:
+      break;
+    case DlBinaryImageFilter::kBlur: {
+      SkScalar sigma_x = cursor.Read<SkScalar>();
+      SkScalar sigma_y = cursor.Read<SkScalar>();
+      DlTileMode tile_mode = cursor.ReadEnum(DlTileMode::kDecal);
+      filter =
+          std::make_shared<DlBlurImageFilter>(sigma_x, sigma_y, tile_mode);
+      break;
+    }
+    case DlBinaryImageFilter::kDilate: {
+      SkScalar radius_x = cursor.Read<SkScalar>();
+      SkScalar radius_y = cursor.Read<SkScalar>();
+      filter = std::make_shared<DlDilateImageFilter>(radius_x, radius_y);
+      break;
+    }
+    case DlBinaryImageFilter::kErode: {
+      SkScalar radius_x = cursor.Read<SkScalar>();
+      SkScalar radius_y = cursor.Read<SkScalar>();
+      filter = std::make_shared<DlErodeImageFilter>(radius_x, radius_y);
+      break;
+    }
+    case DlBinaryImageFilter::kMatrix: {
+      SkMatrix matrix = cursor.ReadMatrix();
+      DlImageSampling sampling = cursor.ReadSampling();
+      filter = std::make_shared<DlMatrixImageFilter>(matrix, sampling);
+      break;
+    }
+    case DlBinaryImageFilter::kCompose: {
+      auto outer = ReadImageFilter(cursor);
+      auto inner = ReadImageFilter(cursor);
+      filter = std::make_shared<DlComposeImageFilter>(outer, inner);
+      break;
+    }
+    case DlBinaryImageFilter::kColorFilter:
+      filter = std::make_shared<DlColorFilterImageFilter>(
+          std::shared_ptr<const DlColorFilter>(ReadColorFilter(cursor)));
+      break;
+    case DlBinaryImageFilter::kLocalMatrix: {
+      SkMatrix matrix = cursor.ReadMatrix();
+      auto inner = ReadImageFilter(cursor);
+      filter = std::make_shared<DlLocalMatrixImageFilter>(matrix, inner);
+      break;
+    }
+  }
+  cursor.ExitAttribute();
+  return cursor.ok() ? filter : nullptr;
+}
+
+bool DlBinaryReader::DispatchOp(DlBinaryOp op,
+                                Cursor& cursor,
+                                DlOpReceiver& receiver) const {
+  using ClipOp = DlCanvas::ClipOp;
+  using PointMode = DlCanvas::PointMode;
+  using SrcRectConstraint = DlCanvas::SrcRectConstraint;
+
+  // Every case reads all of the arguments of the op and only sends it to the
+  // receiver if they could all be read.
+  switch (op) {
+    case DlBinaryOp::kSetAntiAlias: {
+      bool aa = cursor.ReadBool();
+      if (cursor.ok()) {
+        receiver.setAntiAlias(aa);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetInvertColors: {
+      bool invert = cursor.ReadBool();
+      if (cursor.ok()) {
+        receiver.setInvertColors(invert);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetStrokeCap: {
+      auto cap = cursor.ReadEnum(DlStrokeCap::kLastCap);
+      if (cursor.ok()) {
+        receiver.setStrokeCap(cap);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetStrokeJoin: {
+      auto join = cursor.ReadEnum(DlStrokeJoin::kLastJoin);
+      if (cursor.ok()) {
+        receiver.setStrokeJoin(join);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetDrawStyle: {
+      auto style = cursor.ReadEnum(DlDrawStyle::kLastStyle);
+      if (cursor.ok()) {
+        receiver.setDrawStyle(style);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetStrokeWidth: {
+      float width = cursor.Read<float>();
+      if (cursor.ok()) {
+        receiver.setStrokeWidth(width);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetStrokeMiter: {
+      float limit = cursor.Read<float>();
+      if (cursor.ok()) {
+        receiver.setStrokeMiter(limit);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetColor: {
+      DlColor color = cursor.Read<DlColor>();
+      if (cursor.ok()) {
+        receiver.setColor(color);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetBlendMode: {
+      auto mode = cursor.ReadEnum(DlBlendMode::kLastMode);
+      if (cursor.ok()) {
+        receiver.setBlendMode(mode);
+      }
+      break;
+    }
+    case DlBinaryOp::kSetColorSource: {
+      auto source = ReadColorSource(cursor);
+      if (cursor.ok()) {
+        receiver.setColorSource(source.get());
+      }
+      break;
+    }
+    case DlBinaryOp::kSetColorFilter: {
+      auto filter = ReadColorFilter(cursor);
+      if (cursor.ok()) {
+        receiver.setColorFilter(filter.get());
+      }
+      break;
+    }
+    case DlBinaryOp::kSetMaskFilter: {
+      std::shared_ptr<DlMaskFilter> filter;
+      if (cursor.ReadEnum(DlBinaryMaskFilter::kBlur) ==
+          DlBinaryMaskFilter::kBlur) {
+        auto style = cursor.ReadEnum(DlBlurStyle::kInner);
+        SkScalar sigma = cursor.Read<SkScalar>();
+        bool respect_ctm = cursor.ReadBool();
+        filter = std::make_shared<DlBlurMaskFilter>(style, sigma, respect_ctm);
+      }
+      if (cursor.ok()) {
+        receiver.setMaskFilter(filter.get());
+      }
+      break;
+    }
+    case DlBinaryOp::kSetImageFilter: {
+      auto filter = ReadImageFilter(cursor);
+      if (cursor.ok()) {
+        receiver.setImageFilter(filter.get());
+      }
+      break;
+    }
+
+    case DlBinaryOp::kSave:
+      receiver.save();
+      break;
+    case DlBinaryOp::kSaveLayer: {
+      SkRect bounds = cursor.Read<SkRect>();
+      SaveLayerOptions options;
+      if (cursor.ReadBool()) {
+        options = options.with_renders_with_attributes();
+      }
+      if (cursor.ReadBool()) {
+        options = options.with_bounds_from_caller();
+      }
+      auto backdrop = ReadImageFilter(cursor);
+      if (cursor.ok()) {
+        receiver.saveLayer(bounds, options, backdrop.get());
+      }
+      break;
+    }
+    case DlBinaryOp::kRestore:
+      receiver.restore();
+      break;
+
+    case DlBinaryOp::kTranslate: {
+      SkScalar tx = cursor.Read<SkScalar>();
+      SkScalar ty = cursor.Read<SkScalar>();
+      if (cursor.ok()) {
+        receiver.translate(tx, ty);
+      }
+      break;
+    }
+    case DlBinaryOp::kScale: {
+      SkScalar sx = cursor.Read<SkScalar>();
+      SkScalar sy = cursor.Read<SkScalar>();
+      if (cursor.ok()) {
+        receiver.scale(sx, sy);
+      }
+      break;
+    }
+    case DlBinaryOp::kRotate: {
+      SkScalar degrees = cursor.Read<SkScalar>();
+      if (cursor.ok()) {
+        receiver.rotate(degrees);
+      }
+      break;
+    }
+    case DlBinaryOp::kSkew: {
+      SkScalar sx = cursor.Read<SkScalar>();
+      SkScalar sy = cursor.Read<SkScalar>();
+      if (cursor.ok()) {
+        receiver.skew(sx, sy);
+      }
+      break;
+    }
+    case DlBinaryOp::kTransform2DAffine: {
+      const SkScalar* m = cursor.ReadArray<SkScalar>(6);
+      if (cursor.ok()) {
+        receiver.transform2DAffine(m[0], m[1], m[2], m[3], m[4], m[5]);
+      }
+      break;
+    }
+    case DlBinaryOp::kTransformFullPerspective: {
+      const SkScalar* m = cursor.ReadArray<SkScalar>(16);
+      if (cursor.ok()) {
+        // clang-format off
+        receiver.transformFullPerspective(m[0],  m[1],  m[2],  m[3],
+                                          m[4],  m[5],  m[6],  m[7],
+                                          m[8],  m[9],  m[10], m[11],
+                                          m[12], m[13], m[14], m[15]);
+        // clang-format on
+      }
+      break;
+    }
+    case DlBinaryOp::kTransformReset:
+      receiver.transformReset();
+      break;
+
+    case DlBinaryOp::kClipRect: {
+      SkRect rect = cursor.Read<SkRect>();
+      auto clip_op = cursor.ReadEnum(ClipOp::kIntersect);
+      bool is_aa = cursor.ReadBool();
+      if (cursor.ok()) {
+        receiver.clipRect(rect, clip_op, is_aa);
+      }
+      break;
+    }
+    case DlBinaryOp::kClipRRect: {
+      SkRRect rrect = cursor.ReadRRect();
+      auto clip_op = cursor.ReadEnum(ClipOp::kIntersect);
+      bool is_aa = cursor.ReadBool();
+      if (cursor.ok()) {
+        receiver.clipRRect(rrect, clip_op, is_aa);
+      }
+      break;
+    }
+    case DlBinaryOp::kClipPath: {
+      auto clip_op = cursor.ReadEnum(ClipOp::kIntersect);
+      bool is_aa = cursor.ReadBool();
+      SkPath path = cursor.ReadPath();
+      if (!cursor.ok()) {
+        break;
+      }
+      if (receiver.PrefersImpellerPaths()) {
+        receiver.clipPath(DlOpReceiver::CacheablePath(path), clip_op, is_aa);
+      } else {
+        receiver.clipPath(path, clip_op, is_aa);
+      }
+      break;
+    }
+
+    case DlBinaryOp::kDrawColor: {
+      DlColor color = cursor.Read<DlColor>();
+      auto mode = cursor.ReadEnum(DlBlendMode::kLastMode);
+      if (cursor.ok()) {
+        receiver.drawColor(color, mode);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawPaint:
+      receiver.drawPaint();
+      break;
+    case DlBinaryOp::kDrawLine: {
+      SkPoint p0 = cursor.Read<SkPoint>();
+      SkPoint p1 = cursor.Read<SkPoint>();
+      if (cursor.ok()) {
+        receiver.drawLine(p0, p1);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawDashedLine: {
+      DlPoint p0 = cursor.Read<DlPoint>();
+      DlPoint p1 = cursor.Read<DlPoint>();
+      DlScalar on_length = cursor.Read<DlScalar>();
+      DlScalar off_length = cursor.Read<DlScalar>();
+      if (cursor.ok()) {
+        receiver.drawDashedLine(p0, p1, on_length, off_length);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawRect: {
+      SkRect rect = cursor.Read<SkRect>();
+      if (cursor.ok()) {
+        receiver.drawRect(rect);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawOval: {
+      SkRect bounds = cursor.Read<SkRect>();
+      if (cursor.ok()) {
+        receiver.drawOval(bounds);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawCircle: {
+      SkPoint center = cursor.Read<SkPoint>();
+      SkScalar radius = cursor.Read<SkScalar>();
+      if (cursor.ok()) {
+        receiver.drawCircle(center, radius);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawRRect: {
+      SkRRect rrect = cursor.ReadRRect();
+      if (cursor.ok()) {
+        receiver.drawRRect(rrect);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawDRRect: {
+      SkRRect outer = cursor.ReadRRect();
+      SkRRect inner = cursor.ReadRRect();
+      if (cursor.ok()) {
+        receiver.drawDRRect(outer, inner);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawPath: {
+      SkPath path = cursor.ReadPath();
+      if (!cursor.ok()) {
+        break;
+      }
+      if (receiver.PrefersImpellerPaths()) {
+        receiver.drawPath(DlOpReceiver::CacheablePath(path));
+      } else {
+        receiver.drawPath(path);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawArc: {
+      SkRect bounds = cursor.Read<SkRect>();
+      SkScalar start = cursor.Read<SkScalar>();
+      SkScalar sweep = cursor.Read<SkScalar>();
+      bool use_center = cursor.ReadBool();
+      if (cursor.ok()) {
+        receiver.drawArc(bounds, start, sweep, use_center);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawPoints: {
+      auto mode = cursor.ReadEnum(PointMode::kPolygon);
+      uint32_t count = cursor.Read<uint32_t>();
+      const SkPoint* points = cursor.ReadArray<SkPoint>(count);
+      if (cursor.ok()) {
+        receiver.drawPoints(mode, count, points);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawVertices: {
+      auto mode = cursor.ReadEnum(DlBlendMode::kLastMode);
+      auto vertex_mode = cursor.ReadEnum(DlVertexMode::kTriangleFan);
+      uint32_t vertex_count = cursor.Read<uint32_t>();
+      uint32_t index_count = cursor.Read<uint32_t>();
+      uint32_t flags = cursor.Read<uint32_t>();
+      const SkPoint* vertices = cursor.ReadArray<SkPoint>(vertex_count);
+      const SkPoint* texture_coordinates =
+          (flags & 1) ? cursor.ReadArray<SkPoint>(vertex_count) : nullptr;
+      const DlColor* colors =
+          (flags & 2) ? cursor.ReadArray<DlColor>(vertex_count) : nullptr;
+      const uint16_t* indices = cursor.ReadArray<uint16_t>(index_count);
+      if (cursor.ok()) {
+        receiver.drawVertices(
+            DlVertices::Make(vertex_mode, vertex_count, vertices,
+                             texture_coordinates, colors, index_count,
+                             index_count > 0 ? indices : nullptr),
+            mode);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawImage: {
+      sk_sp<DlImage> image = ReadImage(cursor);
+      SkPoint point = cursor.Read<SkPoint>();
+      DlImageSampling sampling = cursor.ReadSampling();
+      bool with_attributes = cursor.ReadBool();
+      if (cursor.ok()) {
+        receiver.drawImage(image, point, sampling, with_attributes);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawImageRect: {
+      sk_sp<DlImage> image = ReadImage(cursor);
+      SkRect src = cursor.Read<SkRect>();
+      SkRect dst = cursor.Read<SkRect>();
+      DlImageSampling sampling = cursor.ReadSampling();
+      bool with_attributes = cursor.ReadBool();
+      auto constraint = cursor.ReadEnum(SrcRectConstraint::kFast);
+      if (cursor.ok()) {
+        receiver.drawImageRect(image, src, dst, sampling, with_attributes,
+                               constraint);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawImageNine: {
+      sk_sp<DlImage> image = ReadImage(cursor);
+      SkIRect center = cursor.Read<SkIRect>();
+      SkRect dst = cursor.Read<SkRect>();
+      auto filter = cursor.ReadEnum(DlFilterMode::kLast);
+      bool with_attributes = cursor.ReadBool();
+      if (cursor.ok()) {
+        receiver.drawImageNine(image, center, dst, filter, with_attributes);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawAtlas: {
+      sk_sp<DlImage> atlas = ReadImage(cursor);
+      uint32_t count = cursor.Read<uint32_t>();
+      auto mode = cursor.ReadEnum(DlBlendMode::kLastMode);
+      DlImageSampling sampling = cursor.ReadSampling();
+      bool with_attributes = cursor.ReadBool();
+      bool has_colors = cursor.ReadBool();
+      bool has_cull_rect = cursor.ReadBool();
+      SkRect cull_rect = cursor.Read<SkRect>();
+      const SkRSXform* xform = cursor.ReadArray<SkRSXform>(count);
+      const SkRect* tex = cursor.ReadArray<SkRect>(count);
+      const DlColor* colors =
+          has_colors ? cursor.ReadArray<DlColor>(count) : nullptr;
+      if (cursor.ok()) {
+        receiver.drawAtlas(atlas, xform, tex, colors, count, mode, sampling,
+                           has_cull_rect ? &cull_rect : nullptr,
+                           with_attributes);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawDisplayList: {
+      uint32_t index = cursor.ReadIndex(display_lists_.size());
+      SkScalar opacity = cursor.Read<SkScalar>();
+      if (cursor.ok()) {
+        receiver.drawDisplayList(display_lists_[index], opacity);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawTextBlob: {
+      SkScalar x = cursor.Read<SkScalar>();
+      SkScalar y = cursor.Read<SkScalar>();
+      uint32_t size = cursor.Read<uint32_t>();
+      const uint8_t* data = cursor.ReadBytes(size);
+      if (!cursor.ok()) {
+        break;
+      }
+      if (!font_manager_) {
+        FML_LOG(ERROR) << "A font manager is required to read text blobs.";
+        return false;
+      }
+      SkDeserialProcs procs;
+      procs.fTypefaceProc = DeserializeTypeface;
+      procs.fTypefaceCtx = font_manager_.get();
+      sk_sp<SkTextBlob> blob = SkTextBlob::Deserialize(data, size, procs);
+      if (!blob) {
+        return false;
+      }
+      receiver.drawTextBlob(blob, x, y);
+      break;
+    }
+    case DlBinaryOp::kDrawShadow: {
+      DlColor color = cursor.Read<DlColor>();
+      SkScalar elevation = cursor.Read<SkScalar>();
+      bool transparent_occluder = cursor.ReadBool();
+      SkScalar dpr = cursor.Read<SkScalar>();
+      SkPath path = cursor.ReadPath();
+      if (!cursor.ok()) {
+        break;
+      }
+      if (receiver.PrefersImpellerPaths()) {
+        receiver.drawShadow(DlOpReceiver::CacheablePath(path), color,
+                            elevation, transparent_occluder, dpr);
+      } else {
+        receiver.drawShadow(path, color, elevation, transparent_occluder, dpr);
+      }
+      break;
+    }
+    case DlBinaryOp::kDrawTextFrame: {
+      SkScalar x = cursor.Read<SkScalar>();
+      SkScalar y = cursor.Read<SkScalar>();
+      SkRect bounds = cursor.Read<SkRect>();
+      if (cursor.ok()) {
+        receiver.drawRect(bounds.makeOffset(x, y));
+      }
+      break;
+    }
+  }
+  return cursor.ok();
+}
+
+}  // namespace flutter
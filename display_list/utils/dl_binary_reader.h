@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_READER_H_
+#define FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_READER_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/dl_op_receiver.h"
+#include "flutter/display_list/utils/dl_binary_format.h"
+#include "flutter/fml/mapping.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Reads display lists written by a DlBinaryWriter.
+///
+///             The op records are read in place from the mapping, which is
+///             typically a memory mapped capture file, so replaying a display
+///             list only copies the side tables (images, runtime effects and
+///             nested display lists), which are decoded once when the reader
+///             is created.
+///
+///             Every read is bounds checked, a malformed or truncated file
+///             makes the reader invalid rather than crash. Placeholder images
+///             are replaced by solid images of the same size, and text frame
+///             placeholders by their bounds.
+///
+class DlBinaryReader {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a reader for a serialized display list.
+  ///
+  /// @param[in]  mapping       The serialized display list. It must outlive
+  ///                           the reader.
+  /// @param[in]  font_manager  Used to deserialize the typefaces of text
+  ///                           blobs. Text blobs can not be read without one.
+  ///
+  explicit DlBinaryReader(std::shared_ptr<const fml::Mapping> mapping,
+                          sk_sp<SkFontMgr> font_manager = nullptr);
+
+  ~DlBinaryReader();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the header and side tables could be read.
+  ///
+  bool IsValid() const { return is_valid_; }
+
+  const SkRect& bounds() const { return header_.bounds; }
+
+  uint32_t op_count() const { return header_.op_count; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Replays the ops to the receiver.
+  ///
+  /// @return     False if the ops are malformed, in which case the receiver
+  ///             will have been sent all of the ops up to the malformed one.
+  ///
+  bool Dispatch(DlOpReceiver& receiver) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Rebuilds the serialized display list.
+  ///
+  /// @return     The display list, or nullptr if the ops are malformed.
+  ///
+  sk_sp<DisplayList> Build() const;
+
+ private:
+  class Cursor;
+
+  std::shared_ptr<const fml::Mapping> mapping_;
+  sk_sp<SkFontMgr> font_manager_;
+  DlBinaryHeader header_ = {};
+  const uint8_t* ops_ = nullptr;
+  std::vector<sk_sp<DlImage>> images_;
+  std::vector<sk_sp<DlRuntimeEffect>> effects_;
+  std::vector<sk_sp<DisplayList>> display_lists_;
+  // The number of display lists this one is nested in.
+  int depth_ = 0;
+  bool is_valid_ = false;
+
+  DlBinaryReader(std::shared_ptr<const fml::Mapping> mapping,
+                 sk_sp<SkFontMgr> font_manager,
+                 int depth);
+
+  bool ReadTables(Cursor& cursor);
+
+  bool DispatchOp(DlBinaryOp op, Cursor& cursor, DlOpReceiver& receiver) const;
+
+  sk_sp<DlImage> ReadImage(Cursor& cursor) const;
+  std::shared_ptr<DlColorSource> ReadColorSource(Cursor& cursor) const;
+  std::shared_ptr<DlColorFilter> ReadColorFilter(Cursor& cursor) const;
+  std::shared_ptr<DlImageFilter> ReadImageFilter(Cursor& cursor) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DlBinaryReader);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_READER_H_
@@ -0,0 +1,810 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/utils/dl_binary_writer.h"
+
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/impeller/typographer/text_frame.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+#include "third_party/skia/include/effects/SkRuntimeEffect.h"
+
+namespace flutter {
+
+namespace {
+
+sk_sp<SkData> SerializeTypeface(SkTypeface* typeface, void* ctx) {
+  return typeface->serialize(SkTypeface::SerializeBehavior::kDoIncludeData);
+}
+
+size_t PaddedSize(size_t size) {
+  return (size + 3) & ~static_cast<size_t>(3);
+}
+
+void AppendEntry(std::vector<uint8_t>& buffer, const void* data, size_t size) {
+  uint32_t entry_size = static_cast<uint32_t>(size);
+  size_t offset = buffer.size();
+  buffer.resize(offset + sizeof(entry_size) + PaddedSize(size), 0);
+  memcpy(buffer.data() + offset, &entry_size, sizeof(entry_size));
+  if (size > 0) {
+    memcpy(buffer.data() + offset + sizeof(entry_size), data, size);
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<fml::Mapping> DlBinaryWriter::Serialize(
+    const DisplayList& display_list) {
+  DlBinaryWriter writer;
+  display_list.Dispatch(writer);
+  return writer.Finish(display_list);
+}
+
+std::unique_ptr<fml::Mapping> DlBinaryWriter::Finish(
+    const DisplayList& display_list) {
+  if (!is_valid_) {
+    return nullptr;
+  }
+
+  std::vector<uint8_t> tables;
+  for (const auto& image : images_) {
+    AppendEntry(tables, image.data(), image.size());
+  }
+  for (const auto& effect : effects_) {
+    AppendEntry(tables, effect.data(), effect.size());
+  }
+  for (const auto& nested : display_lists_) {
+    AppendEntry(tables, nested->GetMapping(), nested->GetSize());
+  }
+
+  DlBinaryHeader header = {};
+  header.magic = kDlBinaryMagic;
+  header.version = kDlBinaryVersion;
+  header.bounds = display_list.bounds();
+  header.op_count = op_count_;
+  header.image_count = images_.size();
+  header.effect_count = effects_.size();
+  header.display_list_count = display_lists_.size();
+  header.tables_size = tables.size();
+  header.ops_size = ops_.size();
+
+  std::vector<uint8_t> buffer(sizeof(header) + tables.size() + ops_.size());
+  uint8_t* ptr = buffer.data();
+  memcpy(ptr, &header, sizeof(header));
+  ptr += sizeof(header);
+  if (!tables.empty()) {
+    memcpy(ptr, tables.data(), tables.size());
+    ptr += tables.size();
+  }
+  if (!ops_.empty()) {
+    memcpy(ptr, ops_.data(), ops_.size());
+  }
+  return std::make_unique<fml::DataMapping>(std::move(buffer));
+}
+
+void DlBinaryWriter::Unsupported(const char* what) {
+  if (is_valid_) {
+    FML_LOG(ERROR) << "Could not serialize display list: " << what
+                   << " is not supported.";
+  }
+  is_valid_ = false;
+}
+
+void DlBinaryWriter::BeginOp(DlBinaryOp op) {
+  FML_DCHECK(op_start_ == ops_.size());
+  DlBinaryOpHeader header = {op, 0, 0};
+  Write(header);
+}
+
+void DlBinaryWriter::EndOp() {
+  Pad();
+  uint32_t size = static_cast<uint32_t>(ops_.size() - op_start_);
+  memcpy(ops_.data() + op_start_ + offsetof(DlBinaryOpHeader, size), &size,
+         sizeof(size));
+  op_start_ = ops_.size();
+  op_count_++;
+}
+
+void DlBinaryWriter::WriteBytes(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  ops_.insert(ops_.end(), bytes, bytes + size);
+}
+
+void DlBinaryWriter::Pad() {
+  ops_.resize(PaddedSize(ops_.size()), 0);
+}
+
+void DlBinaryWriter::WriteMatrix(const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  WriteArray(values, 9);
+}
+
+void DlBinaryWriter::WriteRRect(const SkRRect& rrect) {
+  uint8_t data[SkRRect::kSizeInMemory];
+  rrect.writeToMemory(data);
+  WriteArray(data, SkRRect::kSizeInMemory);
+}
+
+void DlBinaryWriter::WritePath(const SkPath& path) {
+  size_t size = path.writeToMemory(nullptr);
+  std::vector<uint8_t> data(size);
+  path.writeToMemory(data.data());
+  Write(static_cast<uint32_t>(size));
+  WriteArray(data.data(), size);
+  Pad();
+}
+
+void DlBinaryWriter::WriteSampling(DlImageSampling sampling) {
+  WriteEnum(sampling);
+}
+
+void DlBinaryWriter::WriteImage(const DlImage* image) {
+  auto found = image_indices_.find(image);
+  if (found != image_indices_.end()) {
+    Write(found->second);
+    return;
+  }
+  uint32_t index = images_.size();
+  image_indices_[image] = index;
+  Write(index);
+
+  std::vector<uint8_t> entry;
+  // Texture backed images are not asked for an SkImage, which can create a
+  // texture object, as the writer may not run on the raster thread.
+  sk_sp<SkImage> sk_image =
+      image->isTextureBacked() ? nullptr : image->skia_image();
+  SkISize size = sk_image ? sk_image->dimensions() : image->dimensions();
+  if (size.isEmpty()) {
+    Unsupported("an image without dimensions");
+    images_.push_back(std::move(entry));
+    return;
+  }
+  int32_t dimensions[2] = {size.width(), size.height()};
+  entry.resize(sizeof(dimensions));
+  memcpy(entry.data(), dimensions, sizeof(dimensions));
+  if (!sk_image || sk_image->isTextureBacked()) {
+    // Only the dimensions are written, the reader substitutes a placeholder.
+    images_.push_back(std::move(entry));
+    return;
+  }
+  SkImageInfo info = SkImageInfo::Make(dimensions[0], dimensions[1],
+                                       kRGBA_8888_SkColorType,
+                                       kPremul_SkAlphaType);
+  entry.resize(sizeof(dimensions) + info.computeMinByteSize());
+  if (!sk_image->readPixels(nullptr, info, entry.data() + sizeof(dimensions),
+                            info.minRowBytes(), 0, 0)) {
+    entry.resize(sizeof(dimensions));
+  }
+  images_.push_back(std::move(entry));
+}
+
+void DlBinaryWriter::WriteRuntimeEffect(const sk_sp<DlRuntimeEffect>& effect) {
+  auto found = effect_indices_.find(effect.get());
+  if (found != effect_indices_.end()) {
+    Write(found->second);
+    return;
+  }
+  uint32_t index = effects_.size();
+  effect_indices_[effect.get()] = index;
+  Write(index);
+
+  std::vector<uint8_t> entry;
+  sk_sp<SkRuntimeEffect> sk_effect =
+      effect ? effect->skia_runtime_effect() : nullptr;
+  if (!sk_effect) {
+    Unsupported("a runtime effect without SkSL source");
+  } else {
+    const std::string& source = sk_effect->source();
+    entry.assign(source.begin(), source.end());
+  }
+  effects_.push_back(std::move(entry));
+}
+
+void DlBinaryWriter::WriteColorSource(const DlColorSource* source) {
+  if (!source) {
+    WriteEnum(DlBinaryColorSource::kNone);
+    return;
+  }
+  auto write_stops = [this](const DlGradientColorSourceBase* gradient) {
+    Write(static_cast<uint32_t>(gradient->stop_count()));
+    WriteArray(gradient->colors(), gradient->stop_count());
+    WriteArray(gradient->stops(), gradient->stop_count());
+    WriteEnum(gradient->tile_mode());
+    WriteMatrix(gradient->matrix());
+  };
+  switch (source->type()) {
+    case DlColorSourceType::kColor:
+      WriteEnum(DlBinaryColorSource::kColor);
+      Write(source->asColor()->color());
+      break;
+    case DlColorSourceType::kImage: {
+      const DlImageColorSource* image_source = source->asImage();
+      WriteEnum(DlBinaryColorSource::kImage);
+      WriteImage(image_source->image().get());
+      WriteEnum(image_source->horizontal_tile_mode());
+      WriteEnum(image_source->vertical_tile_mode());
+      WriteSampling(image_source->sampling());
+      WriteMatrix(image_source->matrix());
+      break;
+    }
+    case DlColorSourceType::kLinearGradient: {
+      const DlLinearGradientColorSource* linear = source->asLinearGradient();
+      WriteEnum(DlBinaryColorSource::kLinearGradient);
+      Write(linear->start_point());
+      Write(linear->end_point());
+      write_stops(linear);
+      break;
+    }
+    case DlColorSourceType::kRadialGradient: {
+      const DlRadialGradientColorSource* radial = source->asRadialGradient();
+      WriteEnum(DlBinaryColorSource::kRadialGradient);
+      Write(radial->center());
+      Write(radial->radius());
+      write_stops(radial);
+      break;
+    }
+    case DlColorSourceType::kConicalGradient: {
+      const DlConicalGradientColorSource* conical = source->asConicalGradient();
+      WriteEnum(DlBinaryColorSource::kConicalGradient);
+      Write(conical->start_center());
+      Write(conical->start_radius());
+      Write(conical->end_center());
+      Write(conical->end_radius());
+      write_stops(conical);
+      break;
+    }
+    case DlColorSourceType::kSweepGradient: {
+      const DlSweepGradientColorSource* sweep = source->asSweepGradient();
+      WriteEnum(DlBinaryColorSource::kSweepGradient);
+      Write(sweep->center());
+      Write(sweep->start());
+      Write(sweep->end());
+      write_stops(sweep);
+      break;
+    }
+    case DlColorSourceType::kRuntimeEffect: {
+      const DlRuntimeEffectColorSource* effect = source->asRuntimeEffect();
+      WriteEnum(DlBinaryColorSource::kRuntimeEffect);
+      WriteRuntimeEffect(effect->runtime_effect());
+      auto samplers = effect->samplers();
+      Write(static_cast<uint32_t>(samplers.size()));
+      for (const auto& sampler : samplers) {
+        WriteColorSource(sampler.get());
+      }
+      auto uniforms = effect->uniform_data();
+      uint32_t uniform_size = uniforms ? uniforms->size() : 0;
+      Write(uniform_size);
+      if (uniform_size > 0) {
+        WriteArray(uniforms->data(), uniform_size);
+      }
+      Pad();
+      break;
+    }
+#ifdef IMPELLER_ENABLE_3D
+    case DlColorSourceType::kScene:
+      Unsupported("a scene color source");
+      WriteEnum(DlBinaryColorSource::kNone);
+      break;
+#endif  // IMPELLER_ENABLE_3D
+  }
+}
+
+void DlBinaryWriter::WriteColorFilter(const DlColorFilter* filter) {
+  if (!filter) {
+    WriteEnum(DlBinaryColorFilter::kNone);
+    return;
+  }
+  switch (filter->type()) {
+    case DlColorFilterType::kBlend:
+      WriteEnum(DlBinaryColorFilter::kBlend);
+      Write(filter->asBlend()->color());
+      WriteEnum(filter->asBlend()->mode());
+      break;
+    case DlColorFilterType::kMatrix: {
+      float matrix[20];
+      filter->asMatrix()->get_matrix(matrix);
+      WriteEnum(DlBinaryColorFilter::kMatrix);
+      WriteArray(matrix, 20);
+      break;
+    }
+    case DlColorFilterType::kSrgbToLinearGamma:
+      WriteEnum(DlBinaryColorFilter::kSrgbToLinearGamma);
+      break;
+    case DlColorFilterType::kLinearToSrgbGamma:
+      WriteEnum(DlBinaryColorFilter::kLinearToSrgbGamma);
+      break;
+  }
+}
+
+void DlBinaryWriter::WriteImageFilter(const DlImageFilter* filter) {
+  if (!filter) {
+    WriteEnum(DlBinaryImageFilter::kNone);
+    return;
+  }
+  switch (filter->type()) {
+    case DlImageFilterType::kBlur:
+      WriteEnum(DlBinaryImageFilter::kBlur);
+      Write(filter->asBlur()->sigma_x());
+      Write(filter->asBlur()->sigma_y());
+      WriteEnum(filter->asBlur()->tile_mode());
+      break;
+    case DlImageFilterType::kDilate:
+      WriteEnum(DlBinaryImageFilter::kDilate);
+      Write(filter->asDilate()->radius_x());
+      Write(filter->asDilate()->radius_y());
+      break;
+    case DlImageFilterType::kErode:
+      WriteEnum(DlBinaryImageFilter::kErode);
+      Write(filter->asErode()->radius_x());
+      Write(filter->asErode()->radius_y());
+      break;
+    case DlImageFilterType::kMatrix:
+      WriteEnum(DlBinaryImageFilter::kMatrix);
+      WriteMatrix(filter->asMatrix()->matrix());
+      WriteSampling(filter->asMatrix()->sampling());
+      break;
+    case DlImageFilterType::kCompose:
+      WriteEnum(DlBinaryImageFilter::kCompose);
+      WriteImageFilter(filter->asCompose()->outer().get());
+      WriteImageFilter(filter->asCompose()->inner().get());
+      break;
+    case DlImageFilterType::kColorFilter:
+      WriteEnum(DlBinaryImageFilter::kColorFilter);
+      WriteColorFilter(filter->asColorFilter()->color_filter().get());
+      break;
+    case DlImageFilterType::kLocalMatrix:
+      WriteEnum(DlBinaryImageFilter::kLocalMatrix);
+      WriteMatrix(filter->asLocalMatrix()->matrix());
+      WriteImageFilter(filter->asLocalMatrix()->image_filter().get());
+      break;
+  }
+}
+
+void DlBinaryWriter::setAntiAlias(bool aa) {
+  BeginOp(DlBinaryOp::kSetAntiAlias);
+  WriteBool(aa);
+  EndOp();
+}
+
+void DlBinaryWriter::setDrawStyle(DlDrawStyle style) {
+  BeginOp(DlBinaryOp::kSetDrawStyle);
+  WriteEnum(style);
+  EndOp();
+}
+
+void DlBinaryWriter::setColor(DlColor color) {
+  BeginOp(DlBinaryOp::kSetColor);
+  Write(color);
+  EndOp();
+}
+
+void DlBinaryWriter::setStrokeWidth(float width) {
+  BeginOp(DlBinaryOp::kSetStrokeWidth);
+  Write(width);
+  EndOp();
+}
+
+void DlBinaryWriter::setStrokeMiter(float limit) {
+  BeginOp(DlBinaryOp::kSetStrokeMiter);
+  Write(limit);
+  EndOp();
+}
+
+void DlBinaryWriter::setStrokeCap(DlStrokeCap cap) {
+  BeginOp(DlBinaryOp::kSetStrokeCap);
+  WriteEnum(cap);
+  EndOp();
+}
+
+void DlBinaryWriter::setStrokeJoin(DlStrokeJoin join) {
+  BeginOp(DlBinaryOp::kSetStrokeJoin);
+  WriteEnum(join);
+  EndOp();
+}
+
+void DlBinaryWriter::setColorSource(const DlColorSource* source) {
+  BeginOp(DlBinaryOp::kSetColorSource);
+  WriteColorSource(source);
+  EndOp();
+}
+
+void DlBinaryWriter::setColorFilter(const DlColorFilter* filter) {
+  BeginOp(DlBinaryOp::kSetColorFilter);
+  WriteColorFilter(filter);
+  EndOp();
+}
+
+void DlBinaryWriter::setInvertColors(bool invert) {
+  BeginOp(DlBinaryOp::kSetInvertColors);
+  WriteBool(invert);
+  EndOp();
+}
+
+void DlBinaryWriter::setBlendMode(DlBlendMode mode) {
+  BeginOp(DlBinaryOp::kSetBlendMode);
+  WriteEnum(mode);
+  EndOp();
+}
+
+void DlBinaryWriter::setMaskFilter(const DlMaskFilter* filter) {
+  BeginOp(DlBinaryOp::kSetMaskFilter);
+  if (filter && filter->asBlur()) {
+    WriteEnum(DlBinaryMaskFilter::kBlur);
+    WriteEnum(filter->asBlur()->style());
+    Write(filter->asBlur()->sigma());
+    WriteBool(filter->asBlur()->respectCTM());
+  } else {
+    WriteEnum(DlBinaryMaskFilter::kNone);
+  }
+  EndOp();
+}
+
+void DlBinaryWriter::setImageFilter(const DlImageFilter* filter) {
+  BeginOp(DlBinaryOp::kSetImageFilter);
+  WriteImageFilter(filter);
+  EndOp();
+}
+
+void DlBinaryWriter::save() {
+  BeginOp(DlBinaryOp::kSave);
+  EndOp();
+}
+
+void DlBinaryWriter::saveLayer(const SkRect& bounds,
+                               const SaveLayerOptions options,
+                               const DlImageFilter* backdrop) {
+  BeginOp(DlBinaryOp::kSaveLayer);
+  Write(bounds);
+  WriteBool(options.renders_with_attributes());
+  WriteBool(options.bounds_from_caller());
+  WriteImageFilter(backdrop);
+  EndOp();
+}
+
+void DlBinaryWriter::restore() {
+  BeginOp(DlBinaryOp::kRestore);
+  EndOp();
+}
+
+void DlBinaryWriter::translate(SkScalar tx, SkScalar ty) {
+  BeginOp(DlBinaryOp::kTranslate);
+  Write(tx);
+  Write(ty);
+  EndOp();
+}
+
+void DlBinaryWriter::scale(SkScalar sx, SkScalar sy) {
+  BeginOp(DlBinaryOp::kScale);
+  Write(sx);
+  Write(sy);
+  EndOp();
+}
+
+void DlBinaryWriter::rotate(SkScalar degrees) {
+  BeginOp(DlBinaryOp::kRotate);
+  Write(degrees);
+  EndOp();
+}
+
+void DlBinaryWriter::skew(SkScalar sx, SkScalar sy) {
+  BeginOp(DlBinaryOp::kSkew);
+  Write(sx);
+  Write(sy);
+  EndOp();
+}
+
+// clang-format off
+void DlBinaryWriter::transform2DAffine(
+    SkScalar mxx, SkScalar mxy, SkScalar mxt,
+    SkScalar myx, SkScalar myy, SkScalar myt) {
+  const SkScalar values[] = {mxx, mxy, mxt, myx, myy, myt};
+  BeginOp(DlBinaryOp::kTransform2DAffine);
+  WriteArray(values, 6);
+  EndOp();
+}
+
+void DlBinaryWriter::transformFullPerspective(
+    SkScalar mxx, SkScalar mxy, SkScalar mxz, SkScalar mxt,
+    SkScalar myx, SkScalar myy, SkScalar myz, SkScalar myt,
+    SkScalar mzx, SkScalar mzy, SkScalar mzz, SkScalar mzt,
+    SkScalar mwx, SkScalar mwy, SkScalar mwz, SkScalar mwt) {
+  const SkScalar values[] = {
+      mxx, mxy, mxz, mxt,
+      myx, myy, myz, myt,
+      mzx, mzy, mzz, mzt,
+      mwx, mwy, mwz, mwt,
+  };
+  BeginOp(DlBinaryOp::kTransformFullPerspective);
+  WriteArray(values, 16);
+  EndOp();
+}
+// clang-format on
+
+void DlBinaryWriter::transformReset() {
+  BeginOp(DlBinaryOp::kTransformReset);
+  EndOp();
+}
+
+void DlBinaryWriter::clipRect(const SkRect& rect, ClipOp clip_op, bool is_aa) {
+  BeginOp(DlBinaryOp::kClipRect);
+  Write(rect);
+  WriteEnum(clip_op);
+  WriteBool(is_aa);
+  EndOp();
+}
+
+void DlBinaryWriter::clipRRect(const SkRRect& rrect,
+                               ClipOp clip_op,
+                               bool is_aa) {
+  BeginOp(DlBinaryOp::kClipRRect);
+  WriteRRect(rrect);
+  WriteEnum(clip_op);
+  WriteBool(is_aa);
+  EndOp();
+}
+
+void DlBinaryWriter::clipPath(const SkPath& path, ClipOp clip_op, bool is_aa) {
+  BeginOp(DlBinaryOp::kClipPath);
+  WriteEnum(clip_op);
+  WriteBool(is_aa);
+  WritePath(path);
+  EndOp();
+}
+
+void DlBinaryWriter::drawColor(DlColor color, DlBlendMode mode) {
+  BeginOp(DlBinaryOp::kDrawColor);
+  Write(color);
+  WriteEnum(mode);
+  EndOp();
+}
+
+void DlBinaryWriter::drawPaint() {
+  BeginOp(DlBinaryOp::kDrawPaint);
+  EndOp();
+}
+
+void DlBinaryWriter::drawLine(const SkPoint& p0, const SkPoint& p1) {
+  BeginOp(DlBinaryOp::kDrawLine);
+  Write(p0);
+  Write(p1);
+  EndOp();
+}
+
+void DlBinaryWriter::drawDashedLine(const DlPoint& p0,
+                                    const DlPoint& p1,
+                                    DlScalar on_length,
+                                    DlScalar off_length) {
+  BeginOp(DlBinaryOp::kDrawDashedLine);
+  Write(p0);
+  Write(p1);
+  Write(on_length);
+  Write(off_length);
+  EndOp();
+}
+
+void DlBinaryWriter::drawRect(const SkRect& rect) {
+  BeginOp(DlBinaryOp::kDrawRect);
+  Write(rect);
+  EndOp();
+}
+
+void DlBinaryWriter::drawOval(const SkRect& bounds) {
+  BeginOp(DlBinaryOp::kDrawOval);
+  Write(bounds);
+  EndOp();
+}
+
+void DlBinaryWriter::drawCircle(const SkPoint& center, SkScalar radius) {
+  BeginOp(DlBinaryOp::kDrawCircle);
+  Write(center);
+  Write(radius);
+  EndOp();
+}
+
+void DlBinaryWriter::drawRRect(const SkRRect& rrect) {
+  BeginOp(DlBinaryOp::kDrawRRect);
+  WriteRRect(rrect);
+  EndOp();
+}
+
+void DlBinaryWriter::drawDRRect(const SkRRect& outer, const SkRRect& inner) {
+  BeginOp(DlBinaryOp::kDrawDRRect);
+  WriteRRect(outer);
+  WriteRRect(inner);
+  EndOp();
+}
+
+void DlBinaryWriter::drawPath(const SkPath& path) {
+  BeginOp(DlBinaryOp::kDrawPath);
+  WritePath(path);
+  EndOp();
+}
+
+void DlBinaryWriter::drawArc(const SkRect& oval_bounds,
+                             SkScalar start_degrees,
+                             SkScalar sweep_degrees,
+                             bool use_center) {
+  BeginOp(DlBinaryOp::kDrawArc);
+  Write(oval_bounds);
+  Write(start_degrees);
+  Write(sweep_degrees);
+  WriteBool(use_center);
+  EndOp();
+}
+
+void DlBinaryWriter::drawPoints(PointMode mode,
+                                uint32_t count,
+                                const SkPoint points[]) {
+  BeginOp(DlBinaryOp::kDrawPoints);
+  WriteEnum(mode);
+  Write(count);
+  WriteArray(points, count);
+  EndOp();
+}
+
+void DlBinaryWriter::drawVertices(const std::shared_ptr<DlVertices>& vertices,
+                                  DlBlendMode mode) {
+  uint32_t flags = (vertices->texture_coordinates() ? 1 : 0) |
+                   (vertices->colors() ? 2 : 0);
+  BeginOp(DlBinaryOp::kDrawVertices);
+  WriteEnum(mode);
+  WriteEnum(vertices->mode());
+  Write(static_cast<uint32_t>(vertices->vertex_count()));
+  Write(static_cast<uint32_t>(vertices->index_count()));
+  Write(flags);
+  WriteArray(vertices->vertices(), vertices->vertex_count());
+  if (vertices->texture_coordinates()) {
+    WriteArray(vertices->texture_coordinates(), vertices->vertex_count());
+  }
+  if (vertices->colors()) {
+    WriteArray(vertices->colors(), vertices->vertex_count());
+  }
+  if (vertices->indices()) {
+    WriteArray(vertices->indices(), vertices->index_count());
+  }
+  EndOp();
+}
+
+void DlBinaryWriter::drawImage(const sk_sp<DlImage> image,
+                               const SkPoint point,
+                               DlImageSampling sampling,
+                               bool render_with_attributes) {
+  BeginOp(DlBinaryOp::kDrawImage);
+  WriteImage(image.get());
+  Write(point);
+  WriteSampling(sampling);
+  WriteBool(render_with_attributes);
+  EndOp();
+}
+
+void DlBinaryWriter::drawImageRect(const sk_sp<DlImage> image,
+                                   const SkRect& src,
+                                   const SkRect& dst,
+                                   DlImageSampling sampling,
+                                   bool render_with_attributes,
+                                   SrcRectConstraint constraint) {
+  BeginOp(DlBinaryOp::kDrawImageRect);
+  WriteImage(image.get());
+  Write(src);
+  Write(dst);
+  WriteSampling(sampling);
+  WriteBool(render_with_attributes);
+  WriteEnum(constraint);
+  EndOp();
+}
+
+void DlBinaryWriter::drawImageNine(const sk_sp<DlImage> image,
+                                   const SkIRect& center,
+                                   const SkRect& dst,
+                                   DlFilterMode filter,
+                                   bool render_with_attributes) {
+  BeginOp(DlBinaryOp::kDrawImageNine);
+  WriteImage(image.get());
+  Write(center);
+  Write(dst);
+  WriteEnum(filter);
+  WriteBool(render_with_attributes);
+  EndOp();
+}
+
+void DlBinaryWriter::drawAtlas(const sk_sp<DlImage> atlas,
+                               const SkRSXform xform[],
+                               const SkRect tex[],
+                               const DlColor colors[],
+                               int count,
+                               DlBlendMode mode,
+                               DlImageSampling sampling,
+                               const SkRect* cull_rect,
+                               bool render_with_attributes) {
+  BeginOp(DlBinaryOp::kDrawAtlas);
+  WriteImage(atlas.get());
+  Write(static_cast<uint32_t>(count));
+  WriteEnum(mode);
+  WriteSampling(sampling);
+  WriteBool(render_with_attributes);
+  WriteBool(colors != nullptr);
+  WriteBool(cull_rect != nullptr);
+  Write(cull_rect ? *cull_rect : SkRect::MakeEmpty());
+  WriteArray(xform, count);
+  WriteArray(tex, count);
+  if (colors) {
+    WriteArray(colors, count);
+  }
+  EndOp();
+}
+
+void DlBinaryWriter::drawDisplayList(const sk_sp<DisplayList> display_list,
+                                     SkScalar opacity) {
+  BeginOp(DlBinaryOp::kDrawDisplayList);
+  auto found = display_list_indices_.find(display_list.get());
+  if (found != display_list_indices_.end()) {
+    Write(found->second);
+  } else {
+    uint32_t index = display_lists_.size();
+    display_list_indices_[display_list.get()] = index;
+    Write(index);
+    auto nested = Serialize(*display_list);
+    if (!nested) {
+      Unsupported("a nested display list with unsupported content");
+      nested = std::make_unique<fml::DataMapping>(std::vector<uint8_t>());
+    }
+    display_lists_.push_back(std::move(nested));
+  }
+  Write(opacity);
+  EndOp();
+}
+
+void DlBinaryWriter::drawTextBlob(const sk_sp<SkTextBlob> blob,
+                                  SkScalar x,
+                                  SkScalar y) {
+  SkSerialProcs procs;
+  procs.fTypefaceProc = SerializeTypeface;
+  sk_sp<SkData> data = blob->serialize(procs);
+  if (!data) {
+    Unsupported("a text blob that can not be serialized");
+  }
+  BeginOp(DlBinaryOp::kDrawTextBlob);
+  Write(x);
+  Write(y);
+  Write(static_cast<uint32_t>(data ? data->size() : 0));
+  if (data) {
+    WriteArray(data->bytes(), data->size());
+  }
+  EndOp();
+}
+
+void DlBinaryWriter::drawTextFrame(
+    const std::shared_ptr<impeller::TextFrame>& text_frame,
+    SkScalar x,
+    SkScalar y) {
+  BeginOp(DlBinaryOp::kDrawTextFrame);
+  Write(x);
+  Write(y);
+  impeller::Rect bounds = text_frame->GetBounds();
+  Write(SkRect::MakeLTRB(bounds.GetLeft(), bounds.GetTop(), bounds.GetRight(),
+                         bounds.GetBottom()));
+  EndOp();
+}
+
+void DlBinaryWriter::drawShadow(const SkPath& path,
+                                const DlColor color,
+                                const SkScalar elevation,
+                                bool transparent_occluder,
+                                SkScalar dpr) {
+  BeginOp(DlBinaryOp::kDrawShadow);
+  Write(color);
+  Write(elevation);
+  WriteBool(transparent_occluder);
+  Write(dpr);
+  WritePath(path);
+  EndOp();
+}
+
+}  // namespace flutter
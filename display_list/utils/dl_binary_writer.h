@@ -0,0 +1,263 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_WRITER_H_
+#define FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_WRITER_H_
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/dl_op_receiver.h"
+#include "flutter/display_list/utils/dl_binary_format.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Writes display lists in the DisplayList binary format (see
+///             dl_binary_format.h) so that they can be persisted and replayed
+///             offline with a DlBinaryReader.
+///
+///             Images that are not readable on the CPU, such as textures,
+///             and Impeller text frames are written as placeholders (see
+///             dl_binary_format.h). Display lists containing Impeller-only
+///             runtime effects can not be serialized.
+///
+class DlBinaryWriter final : public virtual DlOpReceiver {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes the display list.
+  ///
+  /// @return     The serialized display list, or nullptr if it contains
+  ///             content that can not be serialized.
+  ///
+  static std::unique_ptr<fml::Mapping> Serialize(
+      const DisplayList& display_list);
+
+  // |DlOpReceiver|
+  void setAntiAlias(bool aa) override;
+  // |DlOpReceiver|
+  void setDrawStyle(DlDrawStyle style) override;
+  // |DlOpReceiver|
+  void setColor(DlColor color) override;
+  // |DlOpReceiver|
+  void setStrokeWidth(float width) override;
+  // |DlOpReceiver|
+  void setStrokeMiter(float limit) override;
+  // |DlOpReceiver|
+  void setStrokeCap(DlStrokeCap cap) override;
+  // |DlOpReceiver|
+  void setStrokeJoin(DlStrokeJoin join) override;
+  // |DlOpReceiver|
+  void setColorSource(const DlColorSource* source) override;
+  // |DlOpReceiver|
+  void setColorFilter(const DlColorFilter* filter) override;
+  // |DlOpReceiver|
+  void setInvertColors(bool invert) override;
+  // |DlOpReceiver|
+  void setBlendMode(DlBlendMode mode) override;
+  // |DlOpReceiver|
+  void setMaskFilter(const DlMaskFilter* filter) override;
+  // |DlOpReceiver|
+  void setImageFilter(const DlImageFilter* filter) override;
+
+  // |DlOpReceiver|
+  void save() override;
+  // |DlOpReceiver|
+  void saveLayer(const SkRect& bounds,
+                 const SaveLayerOptions options,
+                 const DlImageFilter* backdrop) override;
+  // |DlOpReceiver|
+  void restore() override;
+
+  // |DlOpReceiver|
+  void translate(SkScalar tx, SkScalar ty) override;
+  // |DlOpReceiver|
+  void scale(SkScalar sx, SkScalar sy) override;
+  // |DlOpReceiver|
+  void rotate(SkScalar degrees) override;
+  // |DlOpReceiver|
+  void skew(SkScalar sx, SkScalar sy) override;
+  // |DlOpReceiver|
+  void transform2DAffine(SkScalar mxx,
+                         SkScalar mxy,
+                         SkScalar mxt,
+                         SkScalar myx,
+                         SkScalar myy,
+                         SkScalar myt) override;
+  // |DlOpReceiver|
+  void transformFullPerspective(SkScalar mxx,
+                                SkScalar mxy,
+                                SkScalar mxz,
+                                SkScalar mxt,
+                                SkScalar myx,
+                                SkScalar myy,
+                                SkScalar myz,
+                                SkScalar myt,
+                                SkScalar mzx,
+                                SkScalar mzy,
+                                SkScalar mzz,
+                                SkScalar mzt,
+                                SkScalar mwx,
+                                SkScalar mwy,
+                                SkScalar mwz,
+                                SkScalar mwt) override;
+  // |DlOpReceiver|
+  void transformReset() override;
+
+  // |DlOpReceiver|
+  void clipRect(const SkRect& rect, ClipOp clip_op, bool is_aa) override;
+  // |DlOpReceiver|
+  void clipRRect(const SkRRect& rrect, ClipOp clip_op, bool is_aa) override;
+  // |DlOpReceiver|
+  void clipPath(const SkPath& path, ClipOp clip_op, bool is_aa) override;
+
+  // |DlOpReceiver|
+  void drawColor(DlColor color, DlBlendMode mode) override;
+  // |DlOpReceiver|
+  void drawPaint() override;
+  // |DlOpReceiver|
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override;
+  // |DlOpReceiver|
+  void drawDashedLine(const DlPoint& p0,
+                      const DlPoint& p1,
+                      DlScalar on_length,
+                      DlScalar off_length) override;
+  // |DlOpReceiver|
+  void drawRect(const SkRect& rect) override;
+  // |DlOpReceiver|
+  void drawOval(const SkRect& bounds) override;
+  // |DlOpReceiver|
+  void drawCircle(const SkPoint& center, SkScalar radius) override;
+  // |DlOpReceiver|
+  void drawRRect(const SkRRect& rrect) override;
+  // |DlOpReceiver|
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override;
+  // |DlOpReceiver|
+  void drawPath(const SkPath& path) override;
+  // |DlOpReceiver|
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override;
+  // |DlOpReceiver|
+  void drawPoints(PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override;
+  // |DlOpReceiver|
+  void drawVertices(const std::shared_ptr<DlVertices>& vertices,
+                    DlBlendMode mode) override;
+  // |DlOpReceiver|
+  void drawImage(const sk_sp<DlImage> image,
+                 const SkPoint point,
+                 DlImageSampling sampling,
+                 bool render_with_attributes) override;
+  // |DlOpReceiver|
+  void drawImageRect(const sk_sp<DlImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     DlImageSampling sampling,
+                     bool render_with_attributes,
+                     SrcRectConstraint constraint) override;
+  // |DlOpReceiver|
+  void drawImageNine(const sk_sp<DlImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     DlFilterMode filter,
+                     bool render_with_attributes) override;
+  // |DlOpReceiver|
+  void drawAtlas(const sk_sp<DlImage> atlas,
+                 const SkRSXform xform[],
+                 const SkRect tex[],
+                 const DlColor colors[],
+                 int count,
+                 DlBlendMode mode,
+                 DlImageSampling sampling,
+                 const SkRect* cull_rect,
+                 bool render_with_attributes) override;
+  // |DlOpReceiver|
+  void drawDisplayList(const sk_sp<DisplayList> display_list,
+                       SkScalar opacity) override;
+  // |DlOpReceiver|
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override;
+  // |DlOpReceiver|
+  void drawTextFrame(const std::shared_ptr<impeller::TextFrame>& text_frame,
+                     SkScalar x,
+                     SkScalar y) override;
+  // |DlOpReceiver|
+  void drawShadow(const SkPath& path,
+                  const DlColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override;
+
+ private:
+  DlBinaryWriter() = default;
+
+  std::vector<uint8_t> ops_;
+  size_t op_start_ = 0;
+  uint32_t op_count_ = 0;
+  bool is_valid_ = true;
+
+  // Side tables, with the index of each entry.
+  std::vector<std::vector<uint8_t>> images_;
+  std::unordered_map<const DlImage*, uint32_t> image_indices_;
+  std::vector<std::vector<uint8_t>> effects_;
+  std::unordered_map<const DlRuntimeEffect*, uint32_t> effect_indices_;
+  std::vector<std::unique_ptr<fml::Mapping>> display_lists_;
+  std::unordered_map<const DisplayList*, uint32_t> display_list_indices_;
+
+  void BeginOp(DlBinaryOp op);
+  void EndOp();
+
+  void WriteBytes(const void* data, size_t size);
+  void Pad();
+
+  template <class T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    WriteBytes(&value, sizeof(T));
+  }
+
+  template <class T>
+  void WriteArray(const T* values, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (count > 0) {
+      WriteBytes(values, sizeof(T) * count);
+    }
+  }
+
+  template <class E>
+  void WriteEnum(E value) {
+    Write(static_cast<uint32_t>(value));
+  }
+
+  void WriteBool(bool value) { Write(static_cast<uint32_t>(value)); }
+  void WriteMatrix(const SkMatrix& matrix);
+  void WriteRRect(const SkRRect& rrect);
+  void WritePath(const SkPath& path);
+  void WriteSampling(DlImageSampling sampling);
+  void WriteColorSource(const DlColorSource* source);
+  void WriteColorFilter(const DlColorFilter* filter);
+  void WriteImageFilter(const DlImageFilter* filter);
+  void WriteImage(const DlImage* image);
+  void WriteRuntimeEffect(const sk_sp<DlRuntimeEffect>& effect);
+
+  // Marks the display list as unserializable.
+  void Unsupported(const char* what);
+
+  std::unique_ptr<fml::Mapping> Finish(const DisplayList& display_list);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DlBinaryWriter);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_UTILS_DL_BINARY_WRITER_H_
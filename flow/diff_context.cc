@@ -9,6 +9,8 @@
 
 namespace flutter {
 
+PaintRegionMap::PaintRegionMap() : entries_(std::make_shared<Entries>()) {}
+
 DiffContext::DiffContext(SkISize frame_size,
                          PaintRegionMap& this_frame_paint_region_map,
                          const PaintRegionMap& last_frame_paint_region_map,
@@ -16,10 +18,11 @@ DiffContext::DiffContext(SkISize frame_size,
                          bool impeller_enabled)
     : rects_(std::make_shared<std::vector<SkRect>>()),
       frame_size_(frame_size),
-      this_frame_paint_region_map_(this_frame_paint_region_map),
-      last_frame_paint_region_map_(last_frame_paint_region_map),
       has_raster_cache_(has_raster_cache),
-      impeller_enabled_(impeller_enabled) {}
+      impeller_enabled_(impeller_enabled) {
+  children_.this_frame = this_frame_paint_region_map.entries_;
+  children_.last_frame = last_frame_paint_region_map.entries_;
+}
 
 void DiffContext::BeginSubtree() {
   state_stack_.push_back(state_);
@@ -222,6 +225,53 @@ void DiffContext::AddExistingPaintRegion(const PaintRegion& region) {
   }
 }
 
+void DiffContext::PreserveLayerPaintRegion(const Layer* layer) {
+  FML_DCHECK(!IsSubtreeDirty());
+  auto old_entry = FindOldEntry(layer);
+  auto& entry = (*children_.this_frame)[layer->unique_id()];
+  if (!old_entry || !old_entry->region.is_valid()) {
+    // This is valid for retained layers with zero sized parent clip in
+    // previous frame (these layers are not diffed)
+    entry = PaintRegionMap::Entry();
+    return;
+  }
+
+  // Retained subtree has no readback, and otherwise only the union of paint
+  // region rects contributes to damage, so the bounds can stand in for them.
+  const PaintRegion& old_region = old_entry->region;
+  SkRect bounds = old_region.ComputeBounds();
+  size_t from = rects_->size();
+  if (!bounds.isEmpty()) {
+    rects_->push_back(bounds);
+  }
+  entry.region = PaintRegion(rects_, from, rects_->size(),
+                             old_region.has_readback(),
+                             old_region.has_texture());
+  entry.children = old_entry->children;
+  statistics_.AddRetainedSubtree();
+}
+
+void DiffContext::BeginChildren(const Layer* layer, const Layer* old_layer) {
+  std::shared_ptr<const PaintRegionMap::Entries> old_children;
+  if (old_layer) {
+    auto old_entry = FindOldEntry(old_layer);
+    if (old_entry) {
+      old_children = old_entry->children;
+    }
+  }
+  auto children = std::make_shared<PaintRegionMap::Entries>();
+  (*children_.this_frame)[layer->unique_id()].children = children;
+  children_stack_.push_back(std::move(children_));
+  children_.this_frame = std::move(children);
+  children_.last_frame = std::move(old_children);
+}
+
+void DiffContext::EndChildren() {
+  FML_DCHECK(!children_stack_.empty());
+  children_ = std::move(children_stack_.back());
+  children_stack_.pop_back();
+}
+
 void DiffContext::AddReadbackRegion(const SkIRect& paint_rect,
                                     const SkIRect& readback_rect) {
   Readback readback;
@@ -254,16 +304,26 @@ void DiffContext::AddDamage(const SkRect& rect) {
 
 void DiffContext::SetLayerPaintRegion(const Layer* layer,
                                       const PaintRegion& region) {
-  this_frame_paint_region_map_[layer->unique_id()] = region;
+  // Children (if any) were stored by BeginChildren.
+  (*children_.this_frame)[layer->unique_id()].region = region;
+}
+
+const PaintRegionMap::Entry* DiffContext::FindOldEntry(
+    const Layer* layer) const {
+  if (!children_.last_frame) {
+    return nullptr;
+  }
+  auto i = children_.last_frame->find(layer->unique_id());
+  return i != children_.last_frame->end() ? &i->second : nullptr;
 }
 
 PaintRegion DiffContext::GetOldLayerPaintRegion(const Layer* layer) const {
-  auto i = last_frame_paint_region_map_.find(layer->unique_id());
-  if (i != last_frame_paint_region_map_.end()) {
-    return i->second;
+  auto entry = FindOldEntry(layer);
+  if (entry) {
+    return entry->region;
   } else {
-    // This is valid when Layer::PreservePaintRegion is called for retained
-    // layer with zero sized parent clip (these layers are not diffed)
+    // This is valid when the layer was not diffed in previous frame, i.e.
+    // because of zero sized parent clip
     return PaintRegion();
   }
 }
@@ -276,7 +336,8 @@ void DiffContext::Statistics::LogStatistics() {
                     deep_compare_pictures_, "SameInstancePictures",
                     same_instance_pictures_,
                     "DifferentInstanceButEqualPictures",
-                    different_instance_but_equal_pictures_);
+                    different_instance_but_equal_pictures_, "RetainedSubtrees",
+                    retained_subtrees_);
 #endif  // !FLUTTER_RELEASE
 }
 
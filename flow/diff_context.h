@@ -6,8 +6,9 @@
 #define FLUTTER_FLOW_DIFF_CONTEXT_H_
 
 #include <functional>
-#include <map>
+#include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 #include "display_list/utils/dl_matrix_clip_tracker.h"
 #include "flutter/flow/paint_region.h"
@@ -37,8 +38,35 @@ struct Damage {
   SkIRect buffer_damage;
 };
 
-// Layer Unique Id to PaintRegion
-using PaintRegionMap = std::map<uint64_t, PaintRegion>;
+// Paint regions of the layers of one layer tree, by layer unique id.
+//
+// The map mirrors the layer tree: the paint regions of the children of a
+// container layer are stored along with the paint region of the container.
+// When a retained layer is not diffed, its children are shared with the map of
+// the previous frame instead of being copied, so preserving the paint region of
+// a retained subtree takes constant time regardless of its size.
+class PaintRegionMap {
+ public:
+  PaintRegionMap();
+
+  // Whether no paint region was set for any layer in this tree.
+  bool empty() const { return entries_->empty(); }
+
+ private:
+  friend class DiffContext;
+
+  struct Entry;
+  using Entries = std::unordered_map<uint64_t, Entry>;
+
+  struct Entry {
+    PaintRegion region;
+
+    // Paint regions of the children of a container layer.
+    std::shared_ptr<const Entries> children;
+  };
+
+  std::shared_ptr<Entries> entries_;
+};
 
 // Tracks state during tree diffing process and computes resulting damage
 class DiffContext {
@@ -120,6 +148,42 @@ class DiffContext {
   // or clips may result in different paint region.
   void AddExistingPaintRegion(const PaintRegion& region);
 
+  // Adds the paint region of a retained layer from previous frame to current
+  // subtree and associates it with the layer in current layer tree, without
+  // diffing the layer. Like AddExistingPaintRegion, this can only be used in
+  // subtrees that are not dirty.
+  //
+  // The region is stored as its bounds, and the paint regions of the layer
+  // descendants are shared with previous frame, so this takes constant time
+  // once the layer has been retained for one frame.
+  void PreserveLayerPaintRegion(const Layer* layer);
+
+  // Starts the scope in which the children of a container layer are diffed.
+  // Paint regions set in this scope are stored with the paint region of
+  // |layer|, and paint regions of old layers are retrieved from those stored
+  // with |old_layer| in previous frame (if any).
+  void BeginChildren(const Layer* layer, const Layer* old_layer);
+
+  // Ends current children scope.
+  void EndChildren();
+
+  // Creates children scope and closes it on scope exit
+  class AutoChildrenRestore {
+    FML_DISALLOW_COPY_ASSIGN_AND_MOVE(AutoChildrenRestore);
+
+   public:
+    AutoChildrenRestore(DiffContext* context,
+                        const Layer* layer,
+                        const Layer* old_layer)
+        : context_(context) {
+      context->BeginChildren(layer, old_layer);
+    }
+    ~AutoChildrenRestore() { context_->EndChildren(); }
+
+   private:
+    DiffContext* context_;
+  };
+
   // The idea of readback region is that if any part of the readback region
   // needs to be repainted, then the whole readback region must be repainted;
   //
@@ -189,6 +253,12 @@ class DiffContext {
       ++different_instance_but_equal_pictures_;
     };
 
+    // Retained layer whose paint region was preserved without diffing its
+    // subtree
+    void AddRetainedSubtree() { ++retained_subtrees_; }
+
+    int retained_subtrees() const { return retained_subtrees_; }
+
     // Logs the statistics to trace counter
     void LogStatistics();
 
@@ -198,6 +268,7 @@ class DiffContext {
     int same_instance_pictures_ = 0;
     int deep_compare_pictures_ = 0;
     int different_instance_but_equal_pictures_ = 0;
+    int retained_subtrees_ = 0;
   };
 
   Statistics& statistics() { return statistics_; }
@@ -248,8 +319,19 @@ class DiffContext {
 
   SkRect damage_ = SkRect::MakeEmpty();
 
-  PaintRegionMap& this_frame_paint_region_map_;
-  const PaintRegionMap& last_frame_paint_region_map_;
+  struct ChildrenScope {
+    // Paint regions set in this scope.
+    std::shared_ptr<PaintRegionMap::Entries> this_frame;
+
+    // Paint regions of old layers in this scope, may be null.
+    std::shared_ptr<const PaintRegionMap::Entries> last_frame;
+  };
+
+  ChildrenScope children_;
+  std::vector<ChildrenScope> children_stack_;
+
+  const PaintRegionMap::Entry* FindOldEntry(const Layer* layer) const;
+
   bool has_raster_cache_;
   bool impeller_enabled_;
 
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/flow/diff_context.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/testing/diff_context_test.h"
+
+namespace flutter {
+namespace {
+
+using testing::MockLayerTree;
+
+// 10 ^ 4 display list layers in total.
+constexpr int kFanOut = 10;
+constexpr int kDepth = 4;
+
+std::shared_ptr<Layer> CreateSubtree(int depth, SkPoint origin) {
+  if (depth == 0) {
+    DisplayListBuilder builder;
+    builder.DrawRect(SkRect::MakeXYWH(origin.x(), origin.y(), 8, 8),
+                     DlPaint());
+    return std::make_shared<DisplayListLayer>(SkPoint::Make(0, 0),
+                                              builder.Build(), false, false);
+  }
+  auto container = std::make_shared<ContainerLayer>();
+  for (int i = 0; i < kFanOut; ++i) {
+    SkPoint child_origin = origin + SkPoint::Make(i * 10 * depth, i * depth);
+    container->Add(CreateSubtree(depth - 1, child_origin));
+  }
+  return container;
+}
+
+Damage Diff(MockLayerTree& layer_tree, const MockLayerTree& old_layer_tree) {
+  DiffContext context(layer_tree.size(), layer_tree.paint_region_map(),
+                      old_layer_tree.paint_region_map(), true, false);
+  context.PushCullRect(
+      SkRect::MakeIWH(layer_tree.size().width(), layer_tree.size().height()));
+  layer_tree.root()->Diff(&context, old_layer_tree.root());
+  return context.ComputeDamage(SkIRect::MakeEmpty());
+}
+
+}  // namespace
+
+// Diffs a tree of new layers, where every layer is visited.
+static void BM_DiffNewLayerTree(benchmark::State& state) {
+  auto subtree = CreateSubtree(kDepth, SkPoint::Make(0, 0));
+  MockLayerTree empty;
+  for (auto _ : state) {
+    MockLayerTree tree;
+    tree.root()->Add(subtree);
+    benchmark::DoNotOptimize(Diff(tree, empty));
+  }
+}
+
+// Diffs frames that retain all subtrees of the previous frame, as when a
+// widget above repaint boundaries rebuilds without changing them.
+static void BM_DiffRetainedLayerTree(benchmark::State& state) {
+  std::vector<std::shared_ptr<Layer>> subtrees;
+  for (int i = 0; i < kFanOut; ++i) {
+    subtrees.push_back(CreateSubtree(kDepth - 1, SkPoint::Make(0, i * 10)));
+  }
+  auto build_frame = [&](MockLayerTree& tree) {
+    for (const auto& subtree : subtrees) {
+      tree.root()->Add(subtree);
+    }
+  };
+  MockLayerTree last_frame;
+  build_frame(last_frame);
+  Diff(last_frame, MockLayerTree());
+  for (auto _ : state) {
+    MockLayerTree frame;
+    build_frame(frame);
+    benchmark::DoNotOptimize(Diff(frame, last_frame));
+    last_frame = std::move(frame);
+  }
+}
+
+// Diffs frames where one subtree out of the retained ones changes a single
+// display list layer, which requires the paint regions of the children of the
+// changed subtree from the frame in which they were last diffed.
+static void BM_DiffLayerTreeWithSingleChange(benchmark::State& state) {
+  std::vector<std::shared_ptr<Layer>> subtrees;
+  for (int i = 0; i < kFanOut; ++i) {
+    subtrees.push_back(CreateSubtree(kDepth - 1, SkPoint::Make(0, i * 10)));
+  }
+  MockLayerTree last_frame;
+  for (const auto& subtree : subtrees) {
+    last_frame.root()->Add(subtree);
+  }
+  Diff(last_frame, MockLayerTree());
+  int frame_index = 0;
+  for (auto _ : state) {
+    // Replace the first child of one of the subtrees with a new layer.
+    int changed = frame_index++ % kFanOut;
+    auto old_subtree =
+        std::static_pointer_cast<ContainerLayer>(subtrees[changed]);
+    auto new_subtree = std::make_shared<ContainerLayer>();
+    new_subtree->AssignOldLayer(old_subtree.get());
+    new_subtree->Add(CreateSubtree(kDepth - 2, SkPoint::Make(500, 500)));
+    for (size_t i = 1; i < old_subtree->layers().size(); ++i) {
+      new_subtree->Add(old_subtree->layers()[i]);
+    }
+    subtrees[changed] = new_subtree;
+
+    MockLayerTree frame;
+    for (const auto& subtree : subtrees) {
+      frame.root()->Add(subtree);
+    }
+    benchmark::DoNotOptimize(Diff(frame, last_frame));
+    last_frame = std::move(frame);
+  }
+}
+
+BENCHMARK(BM_DiffNewLayerTree)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DiffRetainedLayerTree)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DiffLayerTreeWithSingleChange)->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
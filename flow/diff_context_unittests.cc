@@ -32,5 +32,70 @@ TEST_F(DiffContextTest, ClipAlignment) {
   EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(16, 16, 64, 64));
 }
 
+TEST_F(DiffContextTest, RetainedSubtreeIsNotDiffed) {
+  auto l1 =
+      CreateDisplayListLayer(CreateDisplayList(SkRect::MakeLTRB(0, 0, 50, 50)));
+  auto l2 = CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(100, 0, 150, 50)));
+  auto c1 = CreateContainerLayer({l1, l2});
+
+  MockLayerTree t1;
+  t1.root()->Add(c1);
+  auto damage = DiffLayerTree(t1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(0, 0, 150, 50));
+
+  MockLayerTree t2;
+  t2.root()->Add(c1);
+  t2.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(200, 0, 250, 50))));
+
+  DiffContext dc(t2.size(), t2.paint_region_map(), t1.paint_region_map(),
+                 true, false);
+  dc.PushCullRect(SkRect::MakeIWH(t2.size().width(), t2.size().height()));
+  t2.root()->Diff(&dc, t1.root());
+  EXPECT_EQ(dc.statistics().retained_subtrees(), 1);
+  EXPECT_EQ(dc.ComputeDamage(SkIRect::MakeEmpty()).frame_damage,
+            SkIRect::MakeLTRB(200, 0, 250, 50));
+}
+
+TEST_F(DiffContextTest, RetainedSubtreeKeepsPaintRegionsOfChildren) {
+  auto l1 =
+      CreateDisplayListLayer(CreateDisplayList(SkRect::MakeLTRB(0, 0, 50, 50)));
+  auto l2 = CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(100, 0, 150, 50)));
+  auto c1 = CreateContainerLayer({l1, l2});
+
+  MockLayerTree t1;
+  t1.root()->Add(c1);
+  DiffLayerTree(t1, MockLayerTree());
+
+  // Retain the container for a couple of frames, which shares the paint
+  // regions of its children with the first frame.
+  MockLayerTree t2;
+  t2.root()->Add(c1);
+  auto damage = DiffLayerTree(t2, t1);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+
+  MockLayerTree t3;
+  t3.root()->Add(c1);
+  damage = DiffLayerTree(t3, t2);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+
+  // Replace the container, keeping the first child and replacing the second.
+  auto l3 = CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(200, 0, 250, 50)));
+  auto c2 = CreateContainerLayer({l1, l3});
+  c2->AssignOldLayer(c1.get());
+  MockLayerTree t4;
+  t4.root()->Add(c2);
+  damage = DiffLayerTree(t4, t3);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(100, 0, 250, 50));
+
+  // Removing the container damages the area of both children.
+  MockLayerTree t5;
+  damage = DiffLayerTree(t5, t4);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(0, 0, 250, 50));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -126,6 +126,22 @@ size_t FrameTimingsRecorder::GetPictureCacheBytes() const {
   return picture_cache_bytes_;
 }
 
+fml::TimeDelta FrameTimingsRecorder::GetPipelineLatency() const {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ >= State::kRasterStart);
+  return raster_start_ - build_end_;
+}
+
+uint32_t FrameTimingsRecorder::GetPipelineDepth() const {
+  std::scoped_lock state_lock(state_mutex_);
+  return pipeline_depth_;
+}
+
+uint32_t FrameTimingsRecorder::GetDroppedFrameCount() const {
+  std::scoped_lock state_lock(state_mutex_);
+  return dropped_frame_count_;
+}
+
 void FrameTimingsRecorder::RecordVsync(fml::TimePoint vsync_start,
                                        fml::TimePoint vsync_target) {
   fml::Status status = RecordVsyncImpl(vsync_start, vsync_target);
@@ -151,6 +167,13 @@ void FrameTimingsRecorder::RecordRasterStart(fml::TimePoint raster_start) {
   (void)status;
 }
 
+void FrameTimingsRecorder::RecordPipelineState(uint32_t pipeline_depth,
+                                               uint32_t dropped_frame_count) {
+  std::scoped_lock state_lock(state_mutex_);
+  pipeline_depth_ = pipeline_depth;
+  dropped_frame_count_ = dropped_frame_count;
+}
+
 fml::Status FrameTimingsRecorder::RecordVsyncImpl(fml::TimePoint vsync_start,
                                                   fml::TimePoint vsync_target) {
   std::scoped_lock state_lock(state_mutex_);
@@ -243,6 +266,8 @@ std::unique_ptr<FrameTimingsRecorder> FrameTimingsRecorder::CloneUntil(
       std::make_unique<FrameTimingsRecorder>(frame_number_);
   FML_DCHECK(state_ >= state);
   recorder->state_ = state;
+  recorder->pipeline_depth_ = pipeline_depth_;
+  recorder->dropped_frame_count_ = dropped_frame_count_;
 
   if (state >= State::kVsync) {
     recorder->vsync_start_ = vsync_start_;
@@ -87,6 +87,17 @@ class FrameTimingsRecorder {
   /// Total Bytes in all picture cache entries
   size_t GetPictureCacheBytes() const;
 
+  /// Time the frame spent in the frame pipeline, from the end of its build to
+  /// the start of its rasterization.
+  fml::TimeDelta GetPipelineLatency() const;
+
+  /// Depth of the frame pipeline when this frame was submitted to it.
+  uint32_t GetPipelineDepth() const;
+
+  /// Number of vsyncs since the previous frame at which no frame could be
+  /// built because the frame pipeline was full.
+  uint32_t GetDroppedFrameCount() const;
+
   /// Records a vsync event.
   void RecordVsync(fml::TimePoint vsync_start, fml::TimePoint vsync_target);
 
@@ -99,6 +110,11 @@ class FrameTimingsRecorder {
   /// Records a raster start event.
   void RecordRasterStart(fml::TimePoint raster_start);
 
+  /// Records the state of the frame pipeline at the time this frame was
+  /// submitted to it.
+  void RecordPipelineState(uint32_t pipeline_depth,
+                           uint32_t dropped_frame_count);
+
   /// Clones the recorder until (and including) the specified state.
   std::unique_ptr<FrameTimingsRecorder> CloneUntil(State state);
 
@@ -158,6 +174,9 @@ class FrameTimingsRecorder {
   size_t picture_cache_count_;
   size_t picture_cache_bytes_;
 
+  uint32_t pipeline_depth_ = 0;
+  uint32_t dropped_frame_count_ = 0;
+
   // Set when `RecordRasterEnd` is called. Cannot be reset once set.
   FrameTiming timing_;
 
@@ -285,6 +285,27 @@ TEST(FrameTimingsRecorderTest, ClonedHasSameRasterEndWithCache) {
   ASSERT_EQ(recorder->GetPictureCacheBytes(), cloned->GetPictureCacheBytes());
 }
 
+TEST(FrameTimingsRecorderTest, RecordPipelineState) {
+  auto recorder = std::make_unique<FrameTimingsRecorder>();
+
+  const auto now = fml::TimePoint::Now();
+  recorder->RecordVsync(now, now + fml::TimeDelta::FromMilliseconds(16));
+  recorder->RecordBuildStart(now);
+  recorder->RecordBuildEnd(now + fml::TimeDelta::FromMilliseconds(4));
+  recorder->RecordPipelineState(/*pipeline_depth=*/3,
+                                /*dropped_frame_count=*/2);
+  recorder->RecordRasterStart(now + fml::TimeDelta::FromMilliseconds(10));
+
+  ASSERT_EQ(recorder->GetPipelineDepth(), 3u);
+  ASSERT_EQ(recorder->GetDroppedFrameCount(), 2u);
+  ASSERT_EQ(recorder->GetPipelineLatency(),
+            fml::TimeDelta::FromMilliseconds(6));
+
+  auto cloned = recorder->CloneUntil(FrameTimingsRecorder::State::kBuildEnd);
+  ASSERT_EQ(cloned->GetPipelineDepth(), 3u);
+  ASSERT_EQ(cloned->GetDroppedFrameCount(), 2u);
+}
+
 TEST(FrameTimingsRecorderTest, FrameNumberTraceArgIsValid) {
   auto recorder = std::make_unique<FrameTimingsRecorder>();
 
@@ -17,15 +17,9 @@ void ContainerLayer::Diff(DiffContext* context, const Layer* old_layer) {
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
 
-void ContainerLayer::PreservePaintRegion(DiffContext* context) {
-  Layer::PreservePaintRegion(context);
-  for (auto& layer : layers_) {
-    layer->PreservePaintRegion(context);
-  }
-}
-
 void ContainerLayer::DiffChildren(DiffContext* context,
                                   const ContainerLayer* old_layer) {
+  DiffContext::AutoChildrenRestore children(context, this, old_layer);
   if (context->IsSubtreeDirty()) {
     for (auto& layer : layers_) {
       layer->Diff(context, nullptr);
@@ -84,9 +78,8 @@ void ContainerLayer::DiffChildren(DiffContext* context,
         // here matches) so the retained subtree will render identically to
         // previous frame; We can only do this if there is no readback in the
         // subtree. Layers that do readback must be able to register readback
-        // inside Diff
-        context->AddExistingPaintRegion(paint_region);
-
+        // inside Diff.
+        //
         // While we don't need to diff retained layers, we still need to
         // associate their paint region with current layer tree so that we can
         // retrieve it in next frame diff
@@ -24,7 +24,8 @@ static bool IsDisplayListWorthRasterizing(
     const DisplayList* display_list,
     bool will_change,
     bool is_complex,
-    DisplayListComplexityCalculator* complexity_calculator) {
+    DisplayListComplexityCalculator* complexity_calculator,
+    unsigned int* complexity_score) {
   if (will_change) {
     // If the display list is going to change in the future, there is no point
     // in doing to extra work to rasterize.
@@ -44,8 +45,8 @@ static bool IsDisplayListWorthRasterizing(
     return true;
   }
 
-  unsigned int complexity_score = complexity_calculator->Compute(display_list);
-  return complexity_calculator->ShouldBeCached(complexity_score);
+  *complexity_score = complexity_calculator->Compute(display_list);
+  return complexity_calculator->ShouldBeCached(*complexity_score);
 }
 
 DisplayListRasterCacheItem::DisplayListRasterCacheItem(
@@ -73,13 +74,15 @@ std::unique_ptr<DisplayListRasterCacheItem> DisplayListRasterCacheItem::Make(
 void DisplayListRasterCacheItem::PrerollSetup(PrerollContext* context,
                                               const SkMatrix& matrix) {
   cache_state_ = CacheState::kNone;
+  complexity_score_ = 0;
   DisplayListComplexityCalculator* complexity_calculator =
       context->gr_context ? DisplayListComplexityCalculator::GetForBackend(
                                 context->gr_context->backend())
                           : DisplayListComplexityCalculator::GetForSoftware();
 
   if (!IsDisplayListWorthRasterizing(display_list(), will_change_, is_complex_,
-                                     complexity_calculator)) {
+                                     complexity_calculator,
+                                     &complexity_score_)) {
     // We only deal with display lists that are worthy of rasterization.
     return;
   }
@@ -166,14 +169,20 @@ bool DisplayListRasterCacheItem::TryToPrepareRasterCache(
       .matrix             = transformation_matrix_,
       .logical_rect       = bounds,
       .flow_type          = flow_type,
+      .complexity         = complexity_score_,
       // clang-format on
   };
+  auto render_function = [display_list = display_list_](DlCanvas* canvas) {
+    canvas->DrawDisplayList(display_list);
+  };
+  // Display lists are immutable, so they can be rendered off the raster
+  // thread as long as they do not reference textures.
+  if (!display_list_->has_texture_images()) {
+    return context.raster_cache->ScheduleCacheEntry(
+        id.value(), r_context, render_function, display_list_->rtree());
+  }
   return context.raster_cache->UpdateCacheEntry(
-      id.value(), r_context,
-      [display_list = display_list_](DlCanvas* canvas) {
-        canvas->DrawDisplayList(display_list);
-      },
-      display_list_->rtree());
+      id.value(), r_context, render_function, display_list_->rtree());
 }
 }  // namespace flutter
 
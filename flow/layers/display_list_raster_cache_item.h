@@ -57,6 +57,9 @@ class DisplayListRasterCacheItem : public RasterCacheItem {
   SkPoint offset_;
   bool is_complex_;
   bool will_change_;
+  // The complexity score computed by the last preroll, or 0 if it was not
+  // needed to decide whether to cache the display list.
+  unsigned int complexity_score_ = 0;
 };
 
 }  // namespace flutter
@@ -158,12 +158,13 @@ class Layer {
   virtual void Diff(DiffContext* context, const Layer* old_layer) {}
 
   // Used when diffing retained layer; In case the layer is identical, it
-  // doesn't need to be diffed, but the paint region needs to be stored in diff
-  // context so that it can be used in next frame
+  // doesn't need to be diffed, but the paint region needs to be added to the
+  // current subtree and stored in diff context so that it can be used in next
+  // frame
   virtual void PreservePaintRegion(DiffContext* context) {
     // retained layer means same instance so 'this' is used to index into both
     // current and old region
-    context->SetLayerPaintRegion(this, context->GetOldLayerPaintRegion(this));
+    context->PreserveLayerPaintRegion(this);
   }
 
   virtual void Preroll(PrerollContext* context) = 0;
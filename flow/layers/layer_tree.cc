@@ -146,6 +146,7 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
   if (cache) {
     cache->EvictUnusedCacheEntries();
     TryToRasterCache(raster_cache_items_, &context, ignore_raster_cache);
+    cache->ResolvePendingCacheEntries();
   }
 #endif  //  !SLIMPELLER
 
@@ -12,6 +12,8 @@
 #include "flow/stopwatch.h"
 #include "flow/stopwatch_dl.h"
 #include "flow/stopwatch_sk.h"
+#include "flutter/common/constants.h"
+#include "flutter/flow/raster_cache.h"
 #include "third_party/skia/include/core/SkFont.h"
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
@@ -24,6 +26,23 @@
 namespace flutter {
 namespace {
 
+// Historically SK_ColorGRAY (== 0xFF888888) was used for the labels.
+constexpr DlColor kLabelColor = DlColor(0xFF888888);
+
+SkFont MakeStatisticsFont(const std::string& font_path) {
+  sk_sp<SkFontMgr> font_mgr = txt::GetDefaultFontManager();
+  if (font_path == "") {
+    if (sk_sp<SkTypeface> face = font_mgr->matchFamilyStyle(nullptr, {})) {
+      return SkFont(face, 15);
+    }
+    // In Skia's Android fontmgr, matchFamilyStyle can return null instead
+    // of falling back to a default typeface. If that's the case, we can use
+    // legacyMakeTypeface, which *does* use that default typeface.
+    return SkFont(font_mgr->legacyMakeTypeface(nullptr, {}), 15);
+  }
+  return SkFont(font_mgr->makeFromFile(font_path.c_str()), 15);
+}
+
 void VisualizeStopWatch(DlCanvas* canvas,
                         const bool impeller_enabled,
                         const Stopwatch& stopwatch,
@@ -54,8 +73,7 @@ void VisualizeStopWatch(DlCanvas* canvas,
   if (show_labels) {
     auto text = PerformanceOverlayLayer::MakeStatisticsText(
         stopwatch, label_prefix, font_path);
-    // Historically SK_ColorGRAY (== 0xFF888888) was used here
-    DlPaint paint(DlColor(0xFF888888));
+    DlPaint paint(kLabelColor);
 #ifdef IMPELLER_SUPPORTS_RENDERING
     if (impeller_enabled) {
       canvas->DrawTextFrame(impeller::MakeTextFrameFromTextBlobSkia(text),
@@ -73,20 +91,7 @@ sk_sp<SkTextBlob> PerformanceOverlayLayer::MakeStatisticsText(
     const Stopwatch& stopwatch,
     const std::string& label_prefix,
     const std::string& font_path) {
-  SkFont font;
-  sk_sp<SkFontMgr> font_mgr = txt::GetDefaultFontManager();
-  if (font_path == "") {
-    if (sk_sp<SkTypeface> face = font_mgr->matchFamilyStyle(nullptr, {})) {
-      font = SkFont(face, 15);
-    } else {
-      // In Skia's Android fontmgr, matchFamilyStyle can return null instead
-      // of falling back to a default typeface. If that's the case, we can use
-      // legacyMakeTypeface, which *does* use that default typeface.
-      font = SkFont(font_mgr->legacyMakeTypeface(nullptr, {}), 15);
-    }
-  } else {
-    font = SkFont(font_mgr->makeFromFile(font_path.c_str()), 15);
-  }
+  SkFont font = MakeStatisticsFont(font_path);
   // Make sure there's not an empty typeface returned, or we won't see any text.
   FML_DCHECK(font.getTypeface()->countGlyphs() > 0);
 
@@ -102,6 +107,37 @@ sk_sp<SkTextBlob> PerformanceOverlayLayer::MakeStatisticsText(
                                   SkTextEncoding::kUTF8);
 }
 
+#if !SLIMPELLER
+sk_sp<SkTextBlob> PerformanceOverlayLayer::MakeRasterCacheStatisticsText(
+    const RasterCache& raster_cache,
+    const std::string& font_path) {
+  SkFont font = MakeStatisticsFont(font_path);
+  FML_DCHECK(font.getTypeface()->countGlyphs() > 0);
+
+  const RasterCacheMetrics& layers = raster_cache.layer_metrics();
+  const RasterCacheMetrics& pictures = raster_cache.picture_metrics();
+  double cache_mbytes = (raster_cache.EstimateLayerCacheByteSize() +
+                         raster_cache.EstimatePictureCacheByteSize()) /
+                        kMegaByteSizeInBytes;
+  double evicted_mbytes =
+      (layers.eviction_bytes + pictures.eviction_bytes) / kMegaByteSizeInBytes;
+  std::stringstream stream;
+  stream.setf(std::ios::fixed | std::ios::showpoint);
+  stream << std::setprecision(1);
+  stream << "Raster cache  " << cache_mbytes << " MB";
+  if (const RasterCachePolicy* policy = raster_cache.policy();
+      policy && policy->byte_budget() > 0) {
+    stream << " / " << policy->byte_budget() / kMegaByteSizeInBytes << " MB";
+  }
+  stream << ", " << layers.hit_count + pictures.hit_count << " hits, "
+         << layers.miss_count + pictures.miss_count << " misses, "
+         << evicted_mbytes << " MB evicted";
+  auto text = stream.str();
+  return SkTextBlob::MakeFromText(text.c_str(), text.size(), font,
+                                  SkTextEncoding::kUTF8);
+}
+#endif  //  !SLIMPELLER
+
 PerformanceOverlayLayer::PerformanceOverlayLayer(uint64_t options,
                                                  const char* font_path)
     : options_(options) {
@@ -144,6 +180,19 @@ void PerformanceOverlayLayer::Paint(PaintContext& context) const {
                      x, y + height, width, height - padding,
                      options_ & kVisualizeEngineStatistics,
                      options_ & kDisplayEngineStatistics, "UI", font_path_);
+
+#if !SLIMPELLER
+  // The raster cache is only used when rendering with Skia.
+  if ((options_ & kDisplayRasterCacheStatistics) && context.raster_cache &&
+      !context.impeller_enabled) {
+    const int label_x = 8;
+    const int label_y = 20;
+    auto text = MakeRasterCacheStatisticsText(*context.raster_cache,
+                                              font_path_);
+    context.canvas->DrawTextBlob(text, x + label_x, y + label_y,
+                                 DlPaint(kLabelColor));
+  }
+#endif  //  !SLIMPELLER
 }
 
 }  // namespace flutter
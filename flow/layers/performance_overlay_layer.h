@@ -19,6 +19,7 @@ const int kDisplayRasterizerStatistics = 1 << 0;
 const int kVisualizeRasterizerStatistics = 1 << 1;
 const int kDisplayEngineStatistics = 1 << 2;
 const int kVisualizeEngineStatistics = 1 << 3;
+const int kDisplayRasterCacheStatistics = 1 << 4;
 
 class PerformanceOverlayLayer : public Layer {
  public:
@@ -26,6 +27,14 @@ class PerformanceOverlayLayer : public Layer {
                                               const std::string& label_prefix,
                                               const std::string& font_path);
 
+#if !SLIMPELLER
+  // The size, hits, misses and evictions of the raster cache in the current
+  // frame.
+  static sk_sp<SkTextBlob> MakeRasterCacheStatisticsText(
+      const RasterCache& raster_cache,
+      const std::string& font_path);
+#endif  //  !SLIMPELLER
+
   bool IsReplacing(DiffContext* context, const Layer* layer) const override {
     return layer->as_performance_overlay_layer() != nullptr;
   }
@@ -194,6 +194,33 @@ TEST_F(PerformanceOverlayLayerTest, SimpleRasterizerStatistics) {
                                             text_position}}}));
 }
 
+TEST_F(PerformanceOverlayLayerTest, RasterCacheStatistics) {
+  const SkRect layer_bounds = SkRect::MakeLTRB(0.0f, 0.0f, 64.0f, 64.0f);
+  const uint64_t overlay_opts = kDisplayRasterCacheStatistics;
+  auto layer = std::make_shared<PerformanceOverlayLayer>(overlay_opts);
+  layer->set_paint_bounds(layer_bounds);
+
+  // Nothing to show without a raster cache.
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(), std::vector<MockCanvas::DrawCall>());
+
+  use_mock_raster_cache();
+  layer->Paint(paint_context());
+  auto overlay_text = PerformanceOverlayLayer::MakeRasterCacheStatisticsText(
+      *paint_context().raster_cache, "");
+  auto overlay_text_data = overlay_text->serialize(SkSerialProcs{});
+  DlPaint text_paint(DlColor(0xFF888888));
+  SkPoint text_position = SkPoint::Make(16.0f, 28.0f);
+
+#if defined(OS_FUCHSIA)
+  GTEST_SKIP() << "Expectation requires a valid default font manager";
+#endif  // OS_FUCHSIA
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawTextData{overlay_text_data, text_paint,
+                                            text_position}}}));
+}
+
 TEST_F(PerformanceOverlayLayerTest, MarkAsDirtyWhenResized) {
   // Regression test for https://github.com/flutter/flutter/issues/54188
 
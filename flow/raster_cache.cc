@@ -6,6 +6,8 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <vector>
 
@@ -16,16 +18,80 @@
 #include "flutter/flow/paint_utils.h"
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColorSpace.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
+#include "third_party/skia/include/gpu/ganesh/SkImageGanesh.h"
 #include "third_party/skia/include/gpu/ganesh/SkSurfaceGanesh.h"
 
 namespace flutter {
 
+namespace {
+
+sk_sp<SkImage> RasterizeToImage(
+    const RasterCache::Context& context,
+    const std::function<void(DlCanvas*)>& draw_function,
+    const std::function<void(DlCanvas*, const SkRect& rect)>& draw_checkerboard,
+    bool checkerboard) {
+  auto matrix = RasterCacheUtil::GetIntegralTransCTM(context.matrix);
+  SkRect dest_rect =
+      RasterCacheUtil::GetRoundedOutDeviceBounds(context.logical_rect, matrix);
+
+  const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
+      dest_rect.width(), dest_rect.height(), context.dst_color_space);
+
+  sk_sp<SkSurface> surface =
+      context.gr_context
+          ? SkSurfaces::RenderTarget(context.gr_context, skgpu::Budgeted::kYes,
+                                     image_info)
+          : SkSurfaces::Raster(image_info);
+
+  if (!surface) {
+    return nullptr;
+  }
+
+  DlSkCanvasAdapter canvas(surface->getCanvas());
+  canvas.Clear(DlColor::kTransparent());
+
+  canvas.Translate(-dest_rect.left(), -dest_rect.top());
+  canvas.Transform(matrix);
+  draw_function(&canvas);
+
+  if (checkerboard) {
+    draw_checkerboard(&canvas, context.logical_rect);
+  }
+
+  return surface->makeImageSnapshot();
+}
+
+size_t EstimateImageByteSize(const RasterCache::Context& context) {
+  auto matrix = RasterCacheUtil::GetIntegralTransCTM(context.matrix);
+  SkRect dest_rect =
+      RasterCacheUtil::GetRoundedOutDeviceBounds(context.logical_rect, matrix);
+  return SkImageInfo::MakeN32Premul(dest_rect.width(), dest_rect.height())
+      .computeMinByteSize();
+}
+
+}  // namespace
+
+struct RasterCache::PendingResult {
+  // Only used on the raster thread, to upload the image when it is installed.
+  GrDirectContext* gr_context;
+  SkRect logical_rect;
+  const char* flow_type;
+  sk_sp<const DlRTree> rtree;
+  size_t byte_size;
+
+  // Written by the worker task before |ready| is signaled.
+  sk_sp<SkImage> image;
+  std::atomic<bool> is_ready = false;
+  fml::ManualResetWaitableEvent ready;
+};
+
 RasterCacheResult::RasterCacheResult(sk_sp<DlImage> image,
                                      const SkRect& logical_rect,
                                      const char* type,
@@ -82,37 +148,15 @@ std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
     const std::function<void(DlCanvas*)>& draw_function,
     const std::function<void(DlCanvas*, const SkRect& rect)>& draw_checkerboard)
     const {
-  auto matrix = RasterCacheUtil::GetIntegralTransCTM(context.matrix);
-  SkRect dest_rect =
-      RasterCacheUtil::GetRoundedOutDeviceBounds(context.logical_rect, matrix);
-
-  const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
-      dest_rect.width(), dest_rect.height(), context.dst_color_space);
-
-  sk_sp<SkSurface> surface =
-      context.gr_context
-          ? SkSurfaces::RenderTarget(context.gr_context, skgpu::Budgeted::kYes,
-                                     image_info)
-          : SkSurfaces::Raster(image_info);
-
-  if (!surface) {
+  sk_sp<SkImage> image = RasterizeToImage(
+      context, draw_function, draw_checkerboard, checkerboard_images_);
+  if (!image) {
     return nullptr;
   }
-
-  DlSkCanvasAdapter canvas(surface->getCanvas());
-  canvas.Clear(DlColor::kTransparent());
-
-  canvas.Translate(-dest_rect.left(), -dest_rect.top());
-  canvas.Transform(matrix);
-  draw_function(&canvas);
-
-  if (checkerboard_images_) {
-    draw_checkerboard(&canvas, context.logical_rect);
-  }
-
-  auto image = DlImage::Make(surface->makeImageSnapshot());
-  return std::make_unique<RasterCacheResult>(
-      image, context.logical_rect, context.flow_type, std::move(rtree));
+  return std::make_unique<RasterCacheResult>(DlImage::Make(std::move(image)),
+                                             context.logical_rect,
+                                             context.flow_type,
+                                             std::move(rtree));
 }
 
 bool RasterCache::UpdateCacheEntry(
@@ -123,6 +167,11 @@ bool RasterCache::UpdateCacheEntry(
   RasterCacheKey key = RasterCacheKey(id, raster_cache_context.matrix);
   Entry& entry = cache_[key];
   if (!entry.image) {
+    if (!MakeRoomForEntry(key, raster_cache_context)) {
+      return false;
+    }
+    entry.complexity = raster_cache_context.complexity;
+    entry.last_used_frame = frame_count_;
     void (*func)(DlCanvas*, const SkRect& rect) = DrawCheckerboard;
     entry.image = Rasterize(raster_cache_context, std::move(rtree),
                             render_function, func);
@@ -141,6 +190,226 @@ bool RasterCache::UpdateCacheEntry(
   return entry.image != nullptr;
 }
 
+void RasterCache::SetPopulation(
+    RasterCachePopulation population,
+    std::shared_ptr<fml::BasicTaskRunner> worker_task_runner) {
+  population_ = worker_task_runner ? population
+                                   : RasterCachePopulation::kSynchronous;
+  worker_task_runner_ = std::move(worker_task_runner);
+}
+
+bool RasterCache::ScheduleCacheEntry(
+    const RasterCacheKeyID& id,
+    const Context& raster_cache_context,
+    std::function<void(DlCanvas*)> render_function,
+    sk_sp<const DlRTree> rtree) const {
+  if (population_ == RasterCachePopulation::kSynchronous) {
+    return UpdateCacheEntry(id, raster_cache_context, render_function,
+                            std::move(rtree));
+  }
+  RasterCacheKey key = RasterCacheKey(id, raster_cache_context.matrix);
+  Entry& entry = cache_[key];
+  if (entry.image) {
+    return true;
+  }
+  if (!entry.pending) {
+    if (!MakeRoomForEntry(key, raster_cache_context)) {
+      return false;
+    }
+    entry.complexity = raster_cache_context.complexity;
+    auto pending = std::make_shared<PendingResult>();
+    pending->gr_context = raster_cache_context.gr_context;
+    pending->logical_rect = raster_cache_context.logical_rect;
+    pending->flow_type = raster_cache_context.flow_type;
+    pending->rtree = std::move(rtree);
+    pending->byte_size = EstimateImageByteSize(raster_cache_context);
+    entry.pending = pending;
+    if (id.type() == RasterCacheKeyType::kDisplayList) {
+      display_list_cached_this_frame_++;
+    }
+    // The context only holds references to the matrix and bounds, which
+    // must be copied into the task.
+    worker_task_runner_->PostTask(
+        [pending, matrix = raster_cache_context.matrix,
+         color_space = raster_cache_context.dst_color_space,
+         render_function = std::move(render_function),
+         checkerboard = checkerboard_images_]() {
+          TRACE_EVENT0("flutter", "RasterCache::RasterizeOnWorker");
+          // Rasterized to a CPU surface since the raster thread's context
+          // cannot be used here. The image is uploaded when it is installed.
+          const Context context = {
+              // clang-format off
+              .gr_context         = nullptr,
+              .dst_color_space    = color_space,
+              .matrix             = matrix,
+              .logical_rect       = pending->logical_rect,
+              .flow_type          = pending->flow_type,
+              // clang-format on
+          };
+          pending->image = RasterizeToImage(context, render_function,
+                                            DrawCheckerboard, checkerboard);
+          pending->is_ready.store(true, std::memory_order_release);
+          pending->ready.Signal();
+        });
+  }
+  return population_ == RasterCachePopulation::kConcurrentJoin;
+}
+
+void RasterCache::ResolvePendingCacheEntries() const {
+  if (population_ == RasterCachePopulation::kSynchronous) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "RasterCache::ResolvePendingCacheEntries");
+  const bool wait = population_ == RasterCachePopulation::kConcurrentJoin;
+  for (auto& [key, entry] : cache_) {
+    if (!entry.pending) {
+      continue;
+    }
+    if (wait) {
+      entry.pending->ready.Wait();
+    } else if (!entry.pending->is_ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+    InstallPendingResult(entry);
+  }
+}
+
+void RasterCache::InstallPendingResult(Entry& entry) const {
+  std::shared_ptr<PendingResult> pending = std::move(entry.pending);
+  sk_sp<SkImage> image = std::move(pending->image);
+  if (!image) {
+    // Rasterization failed. Like a failed |UpdateCacheEntry|, the entry is
+    // tried again the next time it is prepared.
+    return;
+  }
+  if (pending->gr_context) {
+    sk_sp<SkImage> texture = SkImages::TextureFromImage(
+        pending->gr_context, image.get(), skgpu::Mipmapped::kNo,
+        skgpu::Budgeted::kYes);
+    if (texture) {
+      image = std::move(texture);
+    }
+  }
+  entry.image = std::make_unique<RasterCacheResult>(
+      DlImage::Make(std::move(image)), pending->logical_rect,
+      pending->flow_type, std::move(pending->rtree));
+  entry.last_used_frame = frame_count_;
+}
+
+void RasterCache::SetPolicy(std::unique_ptr<RasterCachePolicy> policy) {
+  policy_ = std::move(policy);
+}
+
+size_t RasterCache::GetEntryByteSize(const Entry& entry) const {
+  if (entry.image) {
+    return entry.image->image_bytes();
+  }
+  if (entry.pending) {
+    return entry.pending->byte_size;
+  }
+  return 0;
+}
+
+size_t RasterCache::GetFramesSinceUsed(const Entry& entry) const {
+  // Entries are only marked as used when they are drawn, which happens after
+  // the entries of the frame are prepared. Entries that are visible in this
+  // frame will be drawn again, so they are not aged.
+  if (entry.encountered_this_frame && entry.visible_this_frame) {
+    return 0;
+  }
+  return frame_count_ - entry.last_used_frame;
+}
+
+bool RasterCache::MakeRoomForEntry(const RasterCacheKey& key,
+                                   const Context& raster_cache_context) const {
+  if (!policy_ || policy_->byte_budget() == 0) {
+    return true;
+  }
+  const size_t byte_budget = policy_->byte_budget();
+  const size_t byte_size = EstimateImageByteSize(raster_cache_context);
+
+  size_t cache_bytes = 0;
+  for (const auto& [other_key, other] : cache_) {
+    cache_bytes += GetEntryByteSize(other);
+  }
+  if (cache_bytes + byte_size <= byte_budget) {
+    return true;
+  }
+
+  RasterCachePolicy::Candidate candidate = {
+      .kind = key.kind(),
+      .byte_size = byte_size,
+      .complexity = raster_cache_context.complexity,
+      .frames_since_used = 0,
+  };
+  const double score = policy_->Score(candidate);
+
+  // Only the entries that score lower than the new entry can be evicted, and
+  // usually only a few of them need to be, so they are kept in a min-heap
+  // instead of being sorted.
+  struct Evictable {
+    Entry* entry;
+    RasterCacheKeyKind kind;
+    size_t byte_size;
+    double score;
+  };
+  auto higher_score = [](const Evictable& a, const Evictable& b) {
+    return a.score > b.score;
+  };
+  std::vector<Evictable> evictable;
+  size_t evictable_bytes = 0;
+  for (auto& [other_key, other] : cache_) {
+    size_t other_bytes = GetEntryByteSize(other);
+    if (other_bytes == 0) {
+      continue;
+    }
+    RasterCachePolicy::Candidate other_candidate = {
+        .kind = other_key.kind(),
+        .byte_size = other_bytes,
+        .complexity = other.complexity,
+        .frames_since_used = GetFramesSinceUsed(other),
+    };
+    double other_score = policy_->Score(other_candidate);
+    if (other_score < score) {
+      evictable.push_back({&other, other_key.kind(), other_bytes, other_score});
+      evictable_bytes += other_bytes;
+    }
+  }
+  if (cache_bytes - evictable_bytes + byte_size > byte_budget) {
+    GetMetricsForKind(key.kind()).budget_rejection_count++;
+    return false;
+  }
+
+  std::make_heap(evictable.begin(), evictable.end(), higher_score);
+  auto heap_end = evictable.end();
+  while (cache_bytes + byte_size > byte_budget) {
+    std::pop_heap(evictable.begin(), heap_end, higher_score);
+    --heap_end;
+    cache_bytes -= heap_end->byte_size;
+  }
+
+  // Only the images are dropped so that the access counts of the evicted
+  // entries are kept, as the entries are likely still in use.
+  for (auto it = heap_end; it != evictable.end(); ++it) {
+    RasterCacheMetrics& metrics = GetMetricsForKind(it->kind);
+    metrics.eviction_count++;
+    metrics.eviction_bytes += it->byte_size;
+    it->entry->image.reset();
+    it->entry->pending.reset();
+  }
+  return true;
+}
+
+size_t RasterCache::GetPendingEntriesCount() const {
+  size_t pending_entries_count = 0;
+  for (const auto& item : cache_) {
+    if (item.second.pending) {
+      pending_entries_count++;
+    }
+  }
+  return pending_entries_count;
+}
+
 RasterCache::CacheInfo RasterCache::MarkSeen(const RasterCacheKeyID& id,
                                              const SkMatrix& matrix,
                                              bool visible) const {
@@ -177,8 +446,11 @@ bool RasterCache::Draw(const RasterCacheKeyID& id,
                        DlCanvas& canvas,
                        const DlPaint* paint,
                        bool preserve_rtree) const {
-  auto it = cache_.find(RasterCacheKey(id, canvas.GetTransform()));
+  RasterCacheKey key = RasterCacheKey(id, canvas.GetTransform());
+  RasterCacheMetrics& metrics = GetMetricsForKind(key.kind());
+  auto it = cache_.find(key);
   if (it == cache_.end()) {
+    metrics.miss_count++;
     return false;
   }
 
@@ -186,13 +458,17 @@ bool RasterCache::Draw(const RasterCacheKeyID& id,
 
   if (entry.image) {
     entry.image->draw(canvas, paint, preserve_rtree);
+    entry.last_used_frame = frame_count_;
+    metrics.hit_count++;
     return true;
   }
 
+  metrics.miss_count++;
   return false;
 }
 
 void RasterCache::BeginFrame() {
+  frame_count_++;
   display_list_cached_this_frame_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
@@ -268,13 +544,21 @@ size_t RasterCache::GetPictureCachedEntriesCount() const {
 
 void RasterCache::TraceStatsToTimeline() const {
 #if !FLUTTER_RELEASE
+  const size_t hits = layer_metrics_.hit_count + picture_metrics_.hit_count;
+  const size_t misses = layer_metrics_.miss_count + picture_metrics_.miss_count;
+  const double evicted_mbytes =
+      (layer_metrics_.eviction_bytes + picture_metrics_.eviction_bytes) /
+      kMegaByteSizeInBytes;
   FML_TRACE_COUNTER(
       "flutter",                                                           //
       "RasterCache", reinterpret_cast<int64_t>(this),                      //
       "LayerCount", layer_metrics_.total_count(),                          //
       "LayerMBytes", layer_metrics_.total_bytes() / kMegaByteSizeInBytes,  //
       "PictureCount", picture_metrics_.total_count(),                      //
-      "PictureMBytes", picture_metrics_.total_bytes() / kMegaByteSizeInBytes);
+      "PictureMBytes", picture_metrics_.total_bytes() / kMegaByteSizeInBytes,
+      "Hits", hits,                                                        //
+      "Misses", misses,                                                    //
+      "EvictedMBytes", evicted_mbytes);
 
 #endif  // !FLUTTER_RELEASE
 }
@@ -301,7 +585,8 @@ size_t RasterCache::EstimatePictureCacheByteSize() const {
   return picture_cache_bytes;
 }
 
-RasterCacheMetrics& RasterCache::GetMetricsForKind(RasterCacheKeyKind kind) {
+RasterCacheMetrics& RasterCache::GetMetricsForKind(
+    RasterCacheKeyKind kind) const {
   switch (kind) {
     case RasterCacheKeyKind::kDisplayListMetrics:
       return picture_metrics_;
@@ -10,11 +10,14 @@
 #include <memory>
 #include <unordered_map>
 
+#include "flutter/common/settings.h"
 #include "flutter/display_list/dl_canvas.h"
 #include "flutter/flow/raster_cache_key.h"
+#include "flutter/flow/raster_cache_policy.h"
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_runner.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -80,6 +83,23 @@ struct RasterCacheMetrics {
    */
   size_t in_use_bytes = 0;
 
+  /**
+   * The number of times entries were drawn from their images in this frame.
+   */
+  size_t hit_count = 0;
+
+  /**
+   * The number of times entries could not be drawn in this frame because
+   * they did not have images.
+   */
+  size_t miss_count = 0;
+
+  /**
+   * The number of entries that were not cached in this frame because their
+   * images did not fit in the byte budget of the cache policy.
+   */
+  size_t budget_rejection_count = 0;
+
   /**
    * The total cache entries that had images during this frame.
    */
@@ -109,6 +129,11 @@ struct RasterCacheMetrics {
  *       Evict cached images that are no longer used.
  *   - LayerTree::TryToPrepareRasterCache
  *       Create cache image for each cache entry if it does not exist.
+ *       Display list entries may instead be scheduled on the worker task
+ *       runner, see |RasterCachePopulation|.
+ *   - RasterCache::ResolvePendingCacheEntries
+ *       Install the images of scheduled entries, waiting for the ones that
+ *       are not ready yet if the cache is in |kConcurrentJoin| mode.
  *   - LayerTree::Paint - for each layer in the tree:
  *       If layers or display lists are cached as cached images, the method
  *       `RasterCache::Draw` will be used to draw those cache images.
@@ -123,6 +148,9 @@ class RasterCache {
     const SkMatrix& matrix;
     const SkRect& logical_rect;
     const char* flow_type;
+    // The complexity score of the cached content, or 0 if it is unknown. See
+    // |RasterCachePolicy::Candidate|.
+    unsigned int complexity = 0;
   };
   struct CacheInfo {
     const size_t accesses_since_visible;
@@ -246,25 +274,103 @@ class RasterCache {
                         const std::function<void(DlCanvas*)>& render_function,
                         sk_sp<const DlRTree> rtree = nullptr) const;
 
+  /**
+   * @brief Selects how |ScheduleCacheEntry| populates entries. The concurrent
+   * modes rasterize entries on |worker_task_runner| and fall back to
+   * |kSynchronous| if it is null.
+   */
+  void SetPopulation(
+      RasterCachePopulation population,
+      std::shared_ptr<fml::BasicTaskRunner> worker_task_runner);
+
+  RasterCachePopulation population() const { return population_; }
+
+  /**
+   * @brief Sets the policy that bounds the total size of the cached images.
+   * Without a policy, the size of the cache is only limited by the number of
+   * entries that can be created per frame.
+   */
+  void SetPolicy(std::unique_ptr<RasterCachePolicy> policy);
+
+  const RasterCachePolicy* policy() const { return policy_.get(); }
+
+  /**
+   * @brief Like |UpdateCacheEntry|, except that in the concurrent population
+   * modes the entry is rasterized to a CPU surface on the worker task runner
+   * and installed by a later call to |ResolvePendingCacheEntries|. Until then
+   * the entry has no image and |Draw| returns false for it.
+   *
+   * The |render_function| must be safe to call on any thread, so it may only
+   * draw immutable content that does not reference GPU resources.
+   *
+   * @return true if the entry has an image, or in |kConcurrentJoin| mode, if
+   * it will have one once the pending entries are resolved.
+   */
+  bool ScheduleCacheEntry(const RasterCacheKeyID& id,
+                          const Context& raster_cache_context,
+                          std::function<void(DlCanvas*)> render_function,
+                          sk_sp<const DlRTree> rtree = nullptr) const;
+
+  /**
+   * @brief Installs the images of entries rasterized on the worker task
+   * runner. In |kConcurrentJoin| mode this waits for all pending entries,
+   * otherwise it only installs the ones that are already done. The cache
+   * only changes here, on the raster thread, and never while a frame is
+   * being painted.
+   */
+  void ResolvePendingCacheEntries() const;
+
+  /**
+   * Return the number of entries scheduled on the worker task runner whose
+   * images have not been installed yet.
+   */
+  size_t GetPendingEntriesCount() const;
+
  private:
+  // The result of rasterizing an entry on the worker task runner. Shared
+  // with the worker task so that entries evicted or cleared while their
+  // rasterization is in flight can be dropped without waiting for it.
+  struct PendingResult;
+
   struct Entry {
     bool encountered_this_frame = false;
     bool visible_this_frame = false;
     size_t accesses_since_visible = 0;
     std::unique_ptr<RasterCacheResult> image;
+    std::shared_ptr<PendingResult> pending;
+    unsigned int complexity = 0;
+    size_t last_used_frame = 0;
   };
 
+  void InstallPendingResult(Entry& entry) const;
+
+  // Evicts the images of entries that score lower than the new entry under
+  // |policy_| until the new entry fits in its byte budget. Returns false,
+  // without evicting anything, if the new entry cannot be made to fit.
+  bool MakeRoomForEntry(const RasterCacheKey& key,
+                        const Context& raster_cache_context) const;
+
+  size_t GetEntryByteSize(const Entry& entry) const;
+
+  // The age of |entry| that |MakeRoomForEntry| gives to |policy_|.
+  size_t GetFramesSinceUsed(const Entry& entry) const;
+
   void UpdateMetrics();
 
-  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind);
+  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind) const;
 
   const size_t access_threshold_;
   const size_t display_list_cache_limit_per_frame_;
   mutable size_t display_list_cached_this_frame_ = 0;
-  RasterCacheMetrics layer_metrics_;
-  RasterCacheMetrics picture_metrics_;
+  // Mutable since hits and misses are counted by |Draw|.
+  mutable RasterCacheMetrics layer_metrics_;
+  mutable RasterCacheMetrics picture_metrics_;
   mutable RasterCacheKey::Map<Entry> cache_;
   bool checkerboard_images_ = false;
+  RasterCachePopulation population_ = RasterCachePopulation::kSynchronous;
+  std::shared_ptr<fml::BasicTaskRunner> worker_task_runner_;
+  std::unique_ptr<RasterCachePolicy> policy_;
+  size_t frame_count_ = 0;
 
   void TraceStatsToTimeline() const;
 
@@ -0,0 +1,31 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#if !SLIMPELLER
+
+#include "flutter/flow/raster_cache_policy.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flutter {
+
+// Raster cache images are N32, so 4 bytes per pixel.
+static constexpr double kBytesPerPixel = 4.0;
+
+ByteBudgetRasterCachePolicy::ByteBudgetRasterCachePolicy(size_t byte_budget,
+                                                         double age_decay)
+    : byte_budget_(byte_budget), age_decay_(age_decay) {}
+
+double ByteBudgetRasterCachePolicy::Score(const Candidate& candidate) const {
+  double pixels = std::max(candidate.byte_size / kBytesPerPixel, 1.0);
+  double work_per_pixel = candidate.complexity > 0
+                              ? candidate.complexity / pixels
+                              : kUnknownComplexityPerPixel;
+  return work_per_pixel * std::pow(age_decay_, candidate.frames_since_used);
+}
+
+}  // namespace flutter
+
+#endif  //  !SLIMPELLER
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_RASTER_CACHE_POLICY_H_
+#define FLUTTER_FLOW_RASTER_CACHE_POLICY_H_
+
+#if !SLIMPELLER
+
+#include <cstddef>
+
+#include "flutter/flow/raster_cache_key.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+/**
+ * Decides which entries the |RasterCache| keeps once their images no longer
+ * fit in its byte budget.
+ *
+ * Before an entry is rasterized, the cache compares its score against the
+ * scores of the entries already holding images and evicts the lowest scoring
+ * ones to make room. The entry is not cached if that is not possible without
+ * evicting entries that score at least as high.
+ */
+class RasterCachePolicy {
+ public:
+  struct Candidate {
+    RasterCacheKeyKind kind;
+    // The estimated size of the entry's image.
+    size_t byte_size;
+    // The complexity score of the cached content, or 0 if it is unknown.
+    unsigned int complexity;
+    // The number of frames since the entry was last drawn from the cache, or
+    // 0 if it is visible in the current frame.
+    size_t frames_since_used;
+  };
+
+  virtual ~RasterCachePolicy() = default;
+
+  /**
+   * The maximum total size of the images held by the cache, or 0 if it is
+   * unlimited.
+   */
+  virtual size_t byte_budget() const = 0;
+
+  /**
+   * The value of keeping |candidate| in the cache. Candidates with lower
+   * scores are evicted first.
+   */
+  virtual double Score(const Candidate& candidate) const = 0;
+};
+
+/**
+ * A |RasterCachePolicy| that prefers the entries that save the most
+ * rendering work per pixel, as estimated by the complexity score of their
+ * content, and ages entries that have not been drawn recently.
+ */
+class ByteBudgetRasterCachePolicy : public RasterCachePolicy {
+ public:
+  /**
+   * The work assumed to be saved per pixel of entries whose complexity is not
+   * known, such as layers.
+   */
+  static constexpr double kUnknownComplexityPerPixel = 1.0;
+
+  /**
+   * @param byte_budget The total size of the cached images, or 0 for
+   * unlimited.
+   * @param age_decay The factor applied to the score of an entry for every
+   * frame in which it was not drawn.
+   */
+  explicit ByteBudgetRasterCachePolicy(size_t byte_budget,
+                                       double age_decay = 0.5);
+
+  // |RasterCachePolicy|
+  size_t byte_budget() const override { return byte_budget_; }
+
+  // |RasterCachePolicy|
+  double Score(const Candidate& candidate) const override;
+
+ private:
+  const size_t byte_budget_;
+  const double age_decay_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ByteBudgetRasterCachePolicy);
+};
+
+}  // namespace flutter
+
+#endif  //  !SLIMPELLER
+
+#endif  // FLUTTER_FLOW_RASTER_CACHE_POLICY_H_
@@ -0,0 +1,58 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_policy.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+RasterCachePolicy::Candidate MakeCandidate(size_t pixels,
+                                           unsigned int complexity,
+                                           size_t frames_since_used = 0) {
+  return {
+      .kind = RasterCacheKeyKind::kDisplayListMetrics,
+      .byte_size = pixels * 4,
+      .complexity = complexity,
+      .frames_since_used = frames_since_used,
+  };
+}
+
+}  // namespace
+
+TEST(ByteBudgetRasterCachePolicy, ReportsBudget) {
+  EXPECT_EQ(ByteBudgetRasterCachePolicy(0).byte_budget(), 0u);
+  EXPECT_EQ(ByteBudgetRasterCachePolicy(1024).byte_budget(), 1024u);
+}
+
+TEST(ByteBudgetRasterCachePolicy, ScoresWorkSavedPerPixel) {
+  ByteBudgetRasterCachePolicy policy(1024);
+  EXPECT_DOUBLE_EQ(policy.Score(MakeCandidate(100, 1000)), 10.0);
+  // The same work spread over more pixels is worth less.
+  EXPECT_LT(policy.Score(MakeCandidate(1000, 1000)),
+            policy.Score(MakeCandidate(100, 1000)));
+  // More work over the same pixels is worth more.
+  EXPECT_GT(policy.Score(MakeCandidate(100, 5000)),
+            policy.Score(MakeCandidate(100, 1000)));
+}
+
+TEST(ByteBudgetRasterCachePolicy, UnknownComplexityUsesDefault) {
+  ByteBudgetRasterCachePolicy policy(1024);
+  RasterCachePolicy::Candidate layer = MakeCandidate(100, 0);
+  layer.kind = RasterCacheKeyKind::kLayerMetrics;
+  EXPECT_DOUBLE_EQ(policy.Score(layer),
+                   ByteBudgetRasterCachePolicy::kUnknownComplexityPerPixel);
+}
+
+TEST(ByteBudgetRasterCachePolicy, ScoresDecayWithAge) {
+  ByteBudgetRasterCachePolicy policy(1024, 0.5);
+  EXPECT_DOUBLE_EQ(policy.Score(MakeCandidate(100, 1000, 1)), 5.0);
+  EXPECT_DOUBLE_EQ(policy.Score(MakeCandidate(100, 1000, 3)), 1.25);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -15,6 +15,7 @@
 #include "flutter/flow/raster_cache_item.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_raster_cache.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/testing/assertions_skia.h"
 #include "gtest/gtest.h"
 #include "third_party/skia/include/core/SkMatrix.h"
@@ -320,6 +321,368 @@ TEST(RasterCache, EvictUnusedCacheEntries) {
   cache.EndFrame();
 }
 
+namespace {
+
+// Holds the tasks posted to it until the test runs them.
+class ManualTaskRunner : public fml::BasicTaskRunner {
+ public:
+  void PostTask(fml::UniqueTask task) override {
+    tasks_.push_back(std::move(task));
+  }
+
+  size_t GetPendingTaskCount() const { return tasks_.size(); }
+
+  void RunPendingTasks() {
+    auto tasks = std::move(tasks_);
+    tasks_.clear();
+    for (const auto& task : tasks) {
+      task();
+    }
+  }
+
+ private:
+  std::vector<fml::UniqueTask> tasks_;
+};
+
+// The state the population tests below need to preroll, cache and draw
+// one sample display list with |cache|.
+struct DisplayListItemContext {
+  explicit DisplayListItemContext(RasterCache* cache)
+      : preroll_context_holder(GetSamplePrerollContextHolder(
+            preroll_state_stack, cache, &raster_time, &ui_time)),
+        paint_context_holder(GetSamplePaintContextHolder(
+            paint_state_stack, cache, &raster_time, &ui_time)),
+        display_list_item(GetSampleDisplayList(), SkPoint(), true, false) {
+    preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+    preroll_state_stack.set_delegate(&canvas);
+  }
+
+  SkMatrix matrix = SkMatrix::I();
+  MockCanvas canvas{1000, 1000};
+  DlPaint paint;
+  LayerStateStack preroll_state_stack;
+  LayerStateStack paint_state_stack;
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder;
+  PaintContextHolder paint_context_holder;
+  DisplayListRasterCacheItem display_list_item;
+};
+
+}  // namespace
+
+TEST(RasterCache, DeferredPopulationOnlyInstallsEntriesWhenResolved) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto runner = std::make_shared<ManualTaskRunner>();
+  cache.SetPopulation(RasterCachePopulation::kConcurrentDeferred, runner);
+
+  DisplayListItemContext context(&cache);
+  SkMatrix& matrix = context.matrix;
+  auto& preroll_context = context.preroll_context_holder.preroll_context;
+  auto& paint_context = context.paint_context_holder.paint_context;
+  DisplayListRasterCacheItem& display_list_item = context.display_list_item;
+  MockCanvas* canvas = &context.canvas;
+  const DlPaint* paint = &context.paint;
+
+  // 1st access.
+  cache.BeginFrame();
+  ASSERT_FALSE(RasterCacheItemPrerollAndTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_EQ(runner->GetPendingTaskCount(), 0u);
+  cache.EndFrame();
+
+  // 2nd access schedules the entry, and the frame paints it uncached.
+  cache.BeginFrame();
+  ASSERT_FALSE(RasterCacheItemPrerollAndTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_EQ(runner->GetPendingTaskCount(), 1u);
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 1u);
+
+  // Preparing the entry again does not schedule it again.
+  ASSERT_FALSE(RasterCacheItemTryToRasterCache(display_list_item,
+                                               paint_context));
+  ASSERT_EQ(runner->GetPendingTaskCount(), 1u);
+
+  // Entries that are not ready are left pending.
+  cache.ResolvePendingCacheEntries();
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 1u);
+  ASSERT_FALSE(display_list_item.Draw(paint_context, canvas, paint));
+
+  // Finishing the rasterization does not change the cache by itself.
+  runner->RunPendingTasks();
+  ASSERT_FALSE(display_list_item.Draw(paint_context, canvas, paint));
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 0u);
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_count(), 0u);
+
+  // 3rd access installs the entry at the join point.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.ResolvePendingCacheEntries();
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 0u);
+  ASSERT_TRUE(RasterCacheItemTryToRasterCache(display_list_item,
+                                              paint_context));
+  ASSERT_EQ(runner->GetPendingTaskCount(), 0u);
+  ASSERT_TRUE(display_list_item.Draw(paint_context, canvas, paint));
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+}
+
+TEST(RasterCache, JoinPopulationWaitsForEntriesBeforePainting) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  cache.SetPopulation(RasterCachePopulation::kConcurrentJoin,
+                      loop->GetTaskRunner());
+
+  DisplayListItemContext context(&cache);
+  SkMatrix& matrix = context.matrix;
+  auto& preroll_context = context.preroll_context_holder.preroll_context;
+  auto& paint_context = context.paint_context_holder.paint_context;
+  DisplayListRasterCacheItem& display_list_item = context.display_list_item;
+  MockCanvas* canvas = &context.canvas;
+  const DlPaint* paint = &context.paint;
+
+  // 1st access.
+  cache.BeginFrame();
+  ASSERT_FALSE(RasterCacheItemPrerollAndTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  cache.EndFrame();
+
+  // 2nd access reports the entry as cached since the frame will wait for it.
+  cache.BeginFrame();
+  ASSERT_TRUE(RasterCacheItemPrerollAndTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  cache.ResolvePendingCacheEntries();
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 0u);
+  ASSERT_TRUE(display_list_item.Draw(paint_context, canvas, paint));
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+}
+
+TEST(RasterCache, PendingEntriesAreDroppedWhenEvicted) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto runner = std::make_shared<ManualTaskRunner>();
+  cache.SetPopulation(RasterCachePopulation::kConcurrentDeferred, runner);
+
+  DisplayListItemContext context(&cache);
+  SkMatrix& matrix = context.matrix;
+  auto& preroll_context = context.preroll_context_holder.preroll_context;
+  auto& paint_context = context.paint_context_holder.paint_context;
+  DisplayListRasterCacheItem& display_list_item = context.display_list_item;
+  MockCanvas* canvas = &context.canvas;
+  const DlPaint* paint = &context.paint;
+
+  cache.BeginFrame();
+  ASSERT_FALSE(RasterCacheItemPrerollAndTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  cache.EndFrame();
+
+  cache.BeginFrame();
+  ASSERT_FALSE(RasterCacheItemPrerollAndTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 1u);
+  cache.EndFrame();
+
+  // The display list is not part of this frame.
+  cache.BeginFrame();
+  cache.EvictUnusedCacheEntries();
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+
+  // The rasterization still completes, but its result is discarded.
+  runner->RunPendingTasks();
+  cache.ResolvePendingCacheEntries();
+  cache.EndFrame();
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 0u);
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 0u);
+}
+
+TEST(RasterCache, ConcurrentPopulationWithoutWorkersIsSynchronous) {
+  flutter::RasterCache cache;
+  cache.SetPopulation(RasterCachePopulation::kConcurrentJoin, nullptr);
+  ASSERT_EQ(cache.population(), RasterCachePopulation::kSynchronous);
+}
+
+TEST(RasterCache, ByteBudgetEvictsLowerScoringEntries) {
+  flutter::RasterCache cache;
+  // Room for one 100x100 entry but not two.
+  cache.SetPolicy(std::make_unique<ByteBudgetRasterCachePolicy>(60000));
+
+  SkMatrix matrix = SkMatrix::I();
+  SkRect bounds = SkRect::MakeWH(100, 100);
+  auto render_function = [](DlCanvas* canvas) {};
+  auto context_with_complexity = [&](unsigned int complexity) {
+    return RasterCache::Context{
+        // clang-format off
+        .gr_context         = nullptr,
+        .dst_color_space    = nullptr,
+        .matrix             = matrix,
+        .logical_rect       = bounds,
+        .flow_type          = "RasterCacheFlow::DisplayList",
+        .complexity         = complexity,
+        // clang-format on
+    };
+  };
+  RasterCacheKeyID complex_id(1, RasterCacheKeyType::kDisplayList);
+  RasterCacheKeyID simple_id(2, RasterCacheKeyType::kDisplayList);
+  RasterCacheKeyID very_complex_id(3, RasterCacheKeyType::kDisplayList);
+
+  cache.BeginFrame();
+  cache.MarkSeen(complex_id, matrix, true);
+  cache.MarkSeen(simple_id, matrix, true);
+  cache.MarkSeen(very_complex_id, matrix, true);
+  ASSERT_TRUE(cache.UpdateCacheEntry(
+      complex_id, context_with_complexity(1000), render_function));
+
+  // Not worth evicting the more complex entry for.
+  ASSERT_FALSE(cache.UpdateCacheEntry(
+      simple_id, context_with_complexity(100), render_function));
+  ASSERT_EQ(cache.picture_metrics().budget_rejection_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 0u);
+
+  ASSERT_TRUE(cache.UpdateCacheEntry(
+      very_complex_id, context_with_complexity(100000), render_function));
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_bytes, 40024u);
+  cache.EndFrame();
+
+  // The evicted entry is kept without its image.
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 3u);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 40024u);
+}
+
+TEST(RasterCache, ByteBudgetPrefersRecentlyDrawnEntries) {
+  flutter::RasterCache cache;
+  cache.SetPolicy(std::make_unique<ByteBudgetRasterCachePolicy>(60000));
+
+  SkMatrix matrix = SkMatrix::I();
+  SkRect bounds = SkRect::MakeWH(100, 100);
+  auto render_function = [](DlCanvas* canvas) {};
+  RasterCache::Context r_context = {
+      // clang-format off
+      .gr_context         = nullptr,
+      .dst_color_space    = nullptr,
+      .matrix             = matrix,
+      .logical_rect       = bounds,
+      .flow_type          = "RasterCacheFlow::DisplayList",
+      .complexity         = 1000,
+      // clang-format on
+  };
+  RasterCacheKeyID drawn_id(1, RasterCacheKeyType::kDisplayList);
+  RasterCacheKeyID offscreen_id(2, RasterCacheKeyType::kDisplayList);
+  RasterCacheKeyID new_id(3, RasterCacheKeyType::kDisplayList);
+  MockCanvas dummy_canvas(1000, 1000);
+
+  cache.BeginFrame();
+  cache.MarkSeen(offscreen_id, matrix, true);
+  cache.MarkSeen(drawn_id, matrix, true);
+  ASSERT_TRUE(cache.UpdateCacheEntry(offscreen_id, r_context, render_function));
+  cache.EndFrame();
+
+  // The first entry scrolls out of view while still being prerolled. A new
+  // entry of the same complexity replaces it since it has not been drawn.
+  cache.BeginFrame();
+  cache.MarkSeen(offscreen_id, matrix, false);
+  cache.MarkSeen(drawn_id, matrix, true);
+  cache.MarkSeen(new_id, matrix, true);
+  ASSERT_TRUE(cache.UpdateCacheEntry(new_id, r_context, render_function));
+  ASSERT_FALSE(cache.Draw(offscreen_id, dummy_canvas, nullptr));
+  ASSERT_TRUE(cache.Draw(new_id, dummy_canvas, nullptr));
+
+  // An entry drawn in this frame is not replaced by an equal one.
+  ASSERT_FALSE(cache.UpdateCacheEntry(drawn_id, r_context, render_function));
+  ASSERT_EQ(cache.picture_metrics().hit_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().miss_count, 1u);
+  cache.EndFrame();
+}
+
+TEST(RasterCache, ByteBudgetDoesNotAgeVisibleEntries) {
+  flutter::RasterCache cache;
+  cache.SetPolicy(std::make_unique<ByteBudgetRasterCachePolicy>(60000));
+
+  SkMatrix matrix = SkMatrix::I();
+  SkRect bounds = SkRect::MakeWH(100, 100);
+  auto render_function = [](DlCanvas* canvas) {};
+  RasterCache::Context r_context = {
+      // clang-format off
+      .gr_context         = nullptr,
+      .dst_color_space    = nullptr,
+      .matrix             = matrix,
+      .logical_rect       = bounds,
+      .flow_type          = "RasterCacheFlow::DisplayList",
+      .complexity         = 1000,
+      // clang-format on
+  };
+  RasterCacheKeyID first_id(1, RasterCacheKeyType::kDisplayList);
+  RasterCacheKeyID second_id(2, RasterCacheKeyType::kDisplayList);
+  MockCanvas dummy_canvas(1000, 1000);
+
+  // Both entries stay on screen, but only one of them fits in the budget.
+  // Entries are prepared before they are drawn, so the one that was drawn in
+  // the previous frame must not be evicted for the other one every frame.
+  for (int i = 0; i < 3; i++) {
+    cache.BeginFrame();
+    cache.MarkSeen(first_id, matrix, true);
+    cache.MarkSeen(second_id, matrix, true);
+    ASSERT_TRUE(cache.UpdateCacheEntry(first_id, r_context, render_function));
+    ASSERT_FALSE(cache.UpdateCacheEntry(second_id, r_context, render_function));
+    ASSERT_TRUE(cache.Draw(first_id, dummy_canvas, nullptr));
+    ASSERT_FALSE(cache.Draw(second_id, dummy_canvas, nullptr));
+    ASSERT_EQ(cache.picture_metrics().eviction_count, 0u);
+    cache.EndFrame();
+  }
+}
+
+TEST(RasterCache, ByteBudgetEvictsOnlyTheLowestScoringEntries) {
+  flutter::RasterCache cache;
+  // Room for four 100x100 entries but not five.
+  cache.SetPolicy(std::make_unique<ByteBudgetRasterCachePolicy>(180000));
+
+  SkMatrix matrix = SkMatrix::I();
+  SkRect bounds = SkRect::MakeWH(100, 100);
+  auto render_function = [](DlCanvas* canvas) {};
+  auto context_with_complexity = [&](unsigned int complexity) {
+    return RasterCache::Context{
+        // clang-format off
+        .gr_context         = nullptr,
+        .dst_color_space    = nullptr,
+        .matrix             = matrix,
+        .logical_rect       = bounds,
+        .flow_type          = "RasterCacheFlow::DisplayList",
+        .complexity         = complexity,
+        // clang-format on
+    };
+  };
+  const unsigned int complexities[] = {4000, 1000, 3000, 2000, 5000};
+  const size_t entry_count = std::size(complexities);
+
+  cache.BeginFrame();
+  for (size_t i = 0; i < entry_count; i++) {
+    cache.MarkSeen(RasterCacheKeyID(i, RasterCacheKeyType::kDisplayList),
+                   matrix, true);
+  }
+  for (size_t i = 0; i < entry_count; i++) {
+    ASSERT_TRUE(cache.UpdateCacheEntry(
+        RasterCacheKeyID(i, RasterCacheKeyType::kDisplayList),
+        context_with_complexity(complexities[i]), render_function));
+  }
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+  cache.EndFrame();
+
+  MockCanvas dummy_canvas(1000, 1000);
+  for (size_t i = 0; i < entry_count; i++) {
+    // Only the entry with the lowest complexity was evicted.
+    EXPECT_EQ(cache.Draw(RasterCacheKeyID(i, RasterCacheKeyType::kDisplayList),
+                         dummy_canvas, nullptr),
+              complexities[i] != 1000);
+  }
+}
+
 TEST(RasterCache, ComputeDeviceRectBasedOnFractionalTranslation) {
   SkRect logical_rect = SkRect::MakeLTRB(0, 0, 300.2, 300.3);
   SkMatrix ctm = SkMatrix::MakeAll(2.0, 0, 0, 0, 2.0, 0, 0, 0, 1);
@@ -5,32 +5,77 @@
 #include "flutter/fml/concurrent_message_loop.h"
 
 #include <algorithm>
+#include <deque>
 
 #include "flutter/fml/thread.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/work_stealing_deque.h"
 
 namespace fml {
 
+// The loop and worker the current thread belongs to, if any. Used to route
+// posts from a worker to its own deque.
+static thread_local ConcurrentMessageLoop* tls_loop = nullptr;
+static thread_local size_t tls_worker_index = 0;
+
+struct ConcurrentMessageLoop::Worker {
+  explicit Worker(size_t p_index) : index(p_index) {}
+
+  ~Worker() {
+    // Tasks that were never run at shutdown.
+    while (fml::UniqueTask* task = deque.Pop()) {
+      delete task;
+    }
+  }
+
+  const size_t index;
+
+  // Tasks posted by this worker. Only this worker pushes and pops, everyone
+  // else steals.
+  WorkStealingDeque<fml::UniqueTask*> deque;
+
+  // Tasks posted from threads that are not workers of this loop.
+  std::mutex inbox_mutex;
+  std::deque<fml::UniqueTask> inbox;
+  // Mirrors |inbox.size()| so that thieves can skip empty inboxes without
+  // taking their lock.
+  std::atomic_size_t inbox_size = 0;
+  // Tasks that must run on this worker, guarded by |inbox_mutex|.
+  std::vector<fml::closure> thread_tasks;
+  std::atomic_bool has_thread_tasks = false;
+
+  // Guarded by |ConcurrentMessageLoop::idle_mutex_|.
+  std::condition_variable wake_condition;
+  bool woken = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  // All workers must exist before any thread starts since threads steal from
+  // each other.
+  workers_.reserve(worker_count_);
+  for (size_t i = 0; i < worker_count_; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>(i));
+  }
+
+  searching_worker_count_ = worker_count_;
+  threads_.reserve(worker_count_);
   for (size_t i = 0; i < worker_count_; ++i) {
-    workers_.emplace_back([i, this]() {
+    threads_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
-      WorkerMain();
+      WorkerMain(*workers_[i]);
     });
   }
-
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
-  }
 }
 
 ConcurrentMessageLoop::~ConcurrentMessageLoop() {
   Terminate();
-  for (auto& worker : workers_) {
-    FML_DCHECK(worker.joinable());
-    worker.join();
+  for (auto& thread : threads_) {
+    FML_DCHECK(thread.joinable());
+    thread.join();
   }
 }
 
@@ -42,84 +87,262 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+void ConcurrentMessageLoop::PostTask(fml::UniqueTask task) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     ExecuteTask(task);
     return;
   }
 
-  tasks_.push(task);
+  if (tls_loop == this) {
+    workers_[tls_worker_index]->deque.Push(
+        new fml::UniqueTask(std::move(task)));
+  } else {
+    Worker& worker = *workers_[next_inbox_++ % worker_count_];
+    std::scoped_lock lock(worker.inbox_mutex);
+    worker.inbox.push_back(std::move(task));
+    ++worker.inbox_size;
+  }
+
+  // Publish the task before looking for idle workers. See |WaitForWork|.
+  ++pending_tasks_;
+  // A worker that is already looking for work will find this task, and will
+  // wake another worker once it does if there is more left.
+  if (searching_worker_count_ == 0) {
+    WakeWorkers(1);
+  }
+}
+
+void ConcurrentMessageLoop::PostTasks(std::vector<fml::UniqueTask> tasks) {
+  tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                             [](const fml::UniqueTask& task) { return !task; }),
+              tasks.end());
+  if (tasks.empty()) {
+    return;
+  }
+
+  // Don't just drop tasks on the floor in case of shutdown.
+  if (shutdown_) {
+    FML_DLOG(WARNING)
+        << "Tried to post tasks to shutdown concurrent message "
+           "loop. The tasks will be executed on the callers thread.";
+    for (const auto& task : tasks) {
+      ExecuteTask(task);
+    }
+    return;
+  }
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  const size_t task_count = tasks.size();
+  if (tls_loop == this) {
+    Worker& worker = *workers_[tls_worker_index];
+    for (auto& task : tasks) {
+      worker.deque.Push(new fml::UniqueTask(std::move(task)));
+    }
+  } else {
+    // Hand each inbox a contiguous slice so every lock is taken at most once.
+    const size_t slice = (task_count + worker_count_ - 1) / worker_count_;
+    const size_t first_inbox = next_inbox_.fetch_add(worker_count_);
+    for (size_t i = 0, begin = 0; begin < task_count; ++i, begin += slice) {
+      const size_t end = std::min(begin + slice, task_count);
+      Worker& worker = *workers_[(first_inbox + i) % worker_count_];
+      std::scoped_lock lock(worker.inbox_mutex);
+      for (size_t j = begin; j < end; ++j) {
+        worker.inbox.push_back(std::move(tasks[j]));
+      }
+      worker.inbox_size += end - begin;
+    }
+  }
 
-  tasks_condition_.notify_one();
+  pending_tasks_ += task_count;
+  WakeWorkers(task_count);
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return !tasks_.empty() || shutdown_ || HasThreadTasksLocked();
-    });
+// Takes the first task from the worker's inbox if there is one. Must be called
+// with the worker's |inbox_mutex| held.
+static bool TakeInboxTaskLocked(std::deque<fml::UniqueTask>& inbox,
+                                std::atomic_size_t& inbox_size,
+                                fml::UniqueTask& task) {
+  if (inbox.empty()) {
+    return false;
+  }
+  task = std::move(inbox.front());
+  inbox.pop_front();
+  --inbox_size;
+  return true;
+}
 
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+bool ConcurrentMessageLoop::TakeTask(Worker& worker, fml::UniqueTask& task) {
+  // Most recently posted local work first, it is the most likely to be hot in
+  // the cache.
+  if (fml::UniqueTask* local_task = worker.deque.Pop()) {
+    task = std::move(*local_task);
+    delete local_task;
+    return true;
+  }
 
-    if (!tasks_.empty()) {
-      task = tasks_.front();
-      tasks_.pop();
+  if (worker.inbox_size > 0) {
+    std::scoped_lock lock(worker.inbox_mutex);
+    if (TakeInboxTaskLocked(worker.inbox, worker.inbox_size, task)) {
+      return true;
     }
+  }
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+  // Steal from the other workers.
+  for (size_t i = 1; i < worker_count_; ++i) {
+    Worker& victim = *workers_[(worker.index + i) % worker_count_];
+    if (fml::UniqueTask* stolen_task = victim.deque.Steal()) {
+      task = std::move(*stolen_task);
+      delete stolen_task;
+      return true;
     }
+    if (victim.inbox_size > 0) {
+      std::scoped_lock lock(victim.inbox_mutex);
+      if (TakeInboxTaskLocked(victim.inbox, victim.inbox_size, task)) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
+void ConcurrentMessageLoop::WorkerMain(Worker& worker) {
+  tls_loop = this;
+  tls_worker_index = worker.index;
+  // Workers start out counted as searching. See the constructor.
+  bool searching = true;
 
-    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
-    // Execute the primary task we woke up for.
-    if (task) {
+  while (true) {
+    if (worker.has_thread_tasks) {
+      std::vector<fml::closure> thread_tasks;
+      {
+        std::scoped_lock lock(worker.inbox_mutex);
+        std::swap(thread_tasks, worker.thread_tasks);
+        worker.has_thread_tasks = false;
+      }
+      for (auto& thread_task : thread_tasks) {
+        ExecuteTask(std::move(thread_task));
+      }
+    }
+
+    if (shutdown_) {
+      break;
+    }
+
+    fml::UniqueTask task;
+    if (TakeTask(worker, task)) {
+      --pending_tasks_;
+      if (searching) {
+        searching = false;
+        // This may have been the last searching worker. Hand the search off
+        // so that any remaining tasks do not wait on this one.
+        if (--searching_worker_count_ == 0 && HasQueuedTasks()) {
+          WakeWorkers(1);
+        }
+      }
+      TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
       ExecuteTask(task);
+      continue;
     }
 
-    // Execute any thread tasks.
-    for (const auto& thread_task : thread_tasks) {
-      ExecuteTask(thread_task);
+    if (searching) {
+      searching = false;
+      --searching_worker_count_;
     }
+    WaitForWork(worker);
+    searching = true;
+    ++searching_worker_count_;
+  }
 
-    if (shutdown_now) {
-      break;
+  if (searching) {
+    --searching_worker_count_;
+  }
+
+  tls_loop = nullptr;
+}
+
+bool ConcurrentMessageLoop::HasQueuedTasks() const {
+  // Reading the count first makes every task it accounts for visible below.
+  // The count alone is not enough since it includes tasks that have already
+  // been taken by a worker that has not yet decremented it.
+  if (pending_tasks_ == 0) {
+    return false;
+  }
+  for (const auto& worker : workers_) {
+    if (!worker->deque.IsEmpty() || worker->inbox_size > 0) {
+      return true;
     }
   }
+  return false;
+}
+
+void ConcurrentMessageLoop::WaitForWork(Worker& worker) {
+  std::unique_lock lock(idle_mutex_);
+
+  // Announce that this worker is about to go idle before checking for work.
+  // Posters publish work before checking for idle workers, so either this
+  // check sees the work or the poster sees this worker and wakes it.
+  ++idle_worker_count_;
+  if (HasQueuedTasks() || worker.has_thread_tasks || shutdown_) {
+    --idle_worker_count_;
+    return;
+  }
+
+  worker.woken = false;
+  idle_workers_.push_back(&worker);
+  worker.wake_condition.wait(lock, [&worker]() { return worker.woken; });
 }
 
-void ConcurrentMessageLoop::ExecuteTask(const fml::closure& task) {
+void ConcurrentMessageLoop::WakeWorkers(size_t count) {
+  for (; count > 0 && idle_worker_count_ > 0; --count) {
+    Worker* worker = nullptr;
+    {
+      std::scoped_lock lock(idle_mutex_);
+      if (idle_workers_.empty()) {
+        return;
+      }
+      // The most recently idle workers are the most likely to still be
+      // running on an awake core, so wake those first.
+      worker = idle_workers_.back();
+      idle_workers_.pop_back();
+      --idle_worker_count_;
+      worker->woken = true;
+    }
+    // Notify with the lock released since the woken worker has to acquire it
+    // anyway. Workers outlive the loop's threads so this is safe.
+    worker->wake_condition.notify_one();
+  }
+}
+
+void ConcurrentMessageLoop::WakeAllWorkers() {
+  std::vector<Worker*> idle_workers;
+  {
+    std::scoped_lock lock(idle_mutex_);
+    std::swap(idle_workers, idle_workers_);
+    for (Worker* worker : idle_workers) {
+      worker->woken = true;
+    }
+    idle_worker_count_ -= idle_workers.size();
+  }
+  for (Worker* worker : idle_workers) {
+    worker->wake_condition.notify_one();
+  }
+}
+
+void ConcurrentMessageLoop::ExecuteTask(const fml::UniqueTask& task) {
   task();
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  WakeAllWorkers();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
@@ -127,24 +350,12 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (auto& worker : workers_) {
+    std::scoped_lock lock(worker->inbox_mutex);
+    worker->thread_tasks.emplace_back(task);
+    worker->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  WakeAllWorkers();
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -153,13 +364,13 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
-void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
+void ConcurrentTaskRunner::PostTask(fml::UniqueTask task) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(std::move(task));
     return;
   }
 
@@ -169,14 +380,24 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
   task();
 }
 
-bool ConcurrentMessageLoop::RunsTasksOnCurrentThread() {
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    if (worker_thread_id == std::this_thread::get_id()) {
-      return true;
+void ConcurrentTaskRunner::PostTasks(std::vector<fml::UniqueTask> tasks) {
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTasks(std::move(tasks));
+    return;
+  }
+
+  FML_DLOG(WARNING)
+      << "Tried to post to a concurrent message loop that has already died. "
+         "Executing the tasks on the callers thread.";
+  for (const auto& task : tasks) {
+    if (task) {
+      task();
     }
   }
-  return false;
+}
+
+bool ConcurrentMessageLoop::RunsTasksOnCurrentThread() {
+  return tls_loop == this;
 }
 
 }  // namespace fml
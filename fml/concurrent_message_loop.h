@@ -5,19 +5,38 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/unique_task.h"
 
 namespace fml {
 
 class ConcurrentTaskRunner;
 
+//------------------------------------------------------------------------------
+/// @brief      A pool of worker threads that run tasks concurrently.
+///
+///             Each worker owns a lock-free work stealing deque for tasks that
+///             are posted from the worker itself, and a small mutex guarded
+///             inbox for tasks posted from other threads. Posts from other
+///             threads are spread over the inboxes round robin so that
+///             posting threads do not all contend on one lock. Idle workers
+///             take from their own deque, then their own inbox, and then
+///             steal from the other workers before going to sleep.
+///
+///             Sleeping workers are woken most recently idle first, which
+///             keeps work on the cores that are already awake and clocked up
+///             rather than spreading it over every core the workers have
+///             affinity for.
+///
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -34,31 +53,55 @@ class ConcurrentMessageLoop
 
   void PostTaskToAllWorkers(const fml::closure& task);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Post a number of tasks at once. This is cheaper than posting
+  ///             them one at a time since each inbox lock is taken at most
+  ///             once and at most one worker per task is woken.
+  ///
+  void PostTasks(std::vector<fml::UniqueTask> tasks);
+
   bool RunsTasksOnCurrentThread();
 
  protected:
   explicit ConcurrentMessageLoop(size_t worker_count);
-  virtual void ExecuteTask(const fml::closure& task);
+  virtual void ExecuteTask(const fml::UniqueTask& task);
 
  private:
   friend ConcurrentTaskRunner;
 
+  struct Worker;
+
   size_t worker_count_ = 0;
-  std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  // Round robin cursor used to pick the inbox for posts from other threads.
+  std::atomic_size_t next_inbox_ = 0;
+  // The number of tasks in all deques and inboxes. Does not include tasks
+  // posted with |PostTaskToAllWorkers| since only one worker can run those.
+  std::atomic_size_t pending_tasks_ = 0;
+  // The number of workers that are awake and looking for a task. Posting only
+  // wakes an idle worker when there are none.
+  std::atomic_size_t searching_worker_count_ = 0;
+  std::atomic_bool shutdown_ = false;
+  // Guards the idle list. Workers only take this lock when they have run out
+  // of work and posters only take it when there are idle workers to wake.
+  std::mutex idle_mutex_;
+  std::vector<Worker*> idle_workers_;
+  std::atomic_size_t idle_worker_count_ = 0;
+
+  void WorkerMain(Worker& worker);
 
-  void WorkerMain();
+  void PostTask(fml::UniqueTask task);
 
-  void PostTask(const fml::closure& task);
+  bool TakeTask(Worker& worker, fml::UniqueTask& task);
 
-  bool HasThreadTasksLocked() const;
+  bool HasQueuedTasks() const;
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  void WaitForWork(Worker& worker);
+
+  void WakeWorkers(size_t count);
+
+  void WakeAllWorkers();
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -69,7 +112,14 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   virtual ~ConcurrentTaskRunner();
 
-  void PostTask(const fml::closure& task) override;
+  void PostTask(fml::UniqueTask task) override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Post a number of tasks at once.
+  ///
+  /// @see        ConcurrentMessageLoop::PostTasks
+  ///
+  void PostTasks(std::vector<fml::UniqueTask> tasks);
 
  private:
   friend ConcurrentMessageLoop;
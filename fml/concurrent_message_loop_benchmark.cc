@@ -0,0 +1,195 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+// The design ConcurrentMessageLoop used before it switched to per-worker
+// deques: one queue behind one mutex and condition variable shared by every
+// worker and poster. Kept here as the baseline for the contention benchmarks.
+class SingleQueueLoop {
+ public:
+  explicit SingleQueueLoop(size_t worker_count) {
+    for (size_t i = 0; i < worker_count; ++i) {
+      workers_.emplace_back([this]() { WorkerMain(); });
+    }
+  }
+
+  ~SingleQueueLoop() {
+    {
+      std::scoped_lock lock(mutex_);
+      shutdown_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void PostTask(fml::UniqueTask task) {
+    {
+      std::scoped_lock lock(mutex_);
+      tasks_.push(std::move(task));
+    }
+    condition_.notify_one();
+  }
+
+  void PostTasks(std::vector<fml::UniqueTask> tasks) {
+    for (auto& task : tasks) {
+      PostTask(std::move(task));
+    }
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::queue<fml::UniqueTask> tasks_;
+  bool shutdown_ = false;
+
+  void WorkerMain() {
+    while (true) {
+      std::unique_lock lock(mutex_);
+      condition_.wait(lock, [&]() { return !tasks_.empty() || shutdown_; });
+      if (tasks_.empty()) {
+        return;
+      }
+      fml::UniqueTask task = std::move(tasks_.front());
+      tasks_.pop();
+      lock.unlock();
+      task();
+    }
+  }
+};
+
+class WorkStealingLoop {
+ public:
+  explicit WorkStealingLoop(size_t worker_count)
+      : loop_(ConcurrentMessageLoop::Create(worker_count)),
+        runner_(loop_->GetTaskRunner()) {}
+
+  void PostTask(fml::UniqueTask task) { runner_->PostTask(std::move(task)); }
+
+  void PostTasks(std::vector<fml::UniqueTask> tasks) {
+    runner_->PostTasks(std::move(tasks));
+  }
+
+ private:
+  std::shared_ptr<ConcurrentMessageLoop> loop_;
+  std::shared_ptr<ConcurrentTaskRunner> runner_;
+};
+
+constexpr size_t kWorkerCount = 8;
+constexpr size_t kTasksPerProducer = 10000;
+
+}  // namespace
+
+// Several threads (e.g. the UI, raster and IO threads) posting small tasks at
+// the same time.
+template <class Loop>
+static void BM_ConcurrentLoopMultiProducer(benchmark::State& state) {
+  const size_t producer_count = state.range(0);
+  Loop loop(kWorkerCount);
+  for (auto _ : state) {
+    CountDownLatch done(producer_count * kTasksPerProducer);
+    std::vector<std::thread> producers;
+    producers.reserve(producer_count);
+    for (size_t i = 0; i < producer_count; ++i) {
+      producers.emplace_back([&loop, &done]() {
+        for (size_t j = 0; j < kTasksPerProducer; ++j) {
+          loop.PostTask([&done]() { done.CountDown(); });
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * producer_count *
+                          kTasksPerProducer);
+}
+
+// A single thread posting a batch of tasks, as when fanning out tessellation
+// or decode work.
+template <class Loop>
+static void BM_ConcurrentLoopBatch(benchmark::State& state) {
+  const size_t task_count = state.range(0);
+  Loop loop(kWorkerCount);
+  for (auto _ : state) {
+    CountDownLatch done(task_count);
+    std::vector<fml::UniqueTask> tasks;
+    tasks.reserve(task_count);
+    for (size_t i = 0; i < task_count; ++i) {
+      tasks.emplace_back([&done]() { done.CountDown(); });
+    }
+    loop.PostTasks(std::move(tasks));
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * task_count);
+}
+
+// Tasks that themselves post more tasks, which lands in the posting worker's
+// own deque in the work stealing loop.
+template <class Loop>
+static void BM_ConcurrentLoopNestedFanOut(benchmark::State& state) {
+  const size_t fan_out = state.range(0);
+  Loop loop(kWorkerCount);
+  for (auto _ : state) {
+    CountDownLatch outer(fan_out);
+    CountDownLatch inner(fan_out * fan_out);
+    for (size_t i = 0; i < fan_out; ++i) {
+      loop.PostTask([&]() {
+        for (size_t j = 0; j < fan_out; ++j) {
+          loop.PostTask([&inner]() { inner.CountDown(); });
+        }
+        outer.CountDown();
+      });
+    }
+    outer.Wait();
+    inner.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * fan_out * fan_out);
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopMultiProducer, SingleQueueLoop)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopMultiProducer, WorkStealingLoop)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopBatch, SingleQueueLoop)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopBatch, WorkStealingLoop)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopNestedFanOut, SingleQueueLoop)
+    ->Arg(10)
+    ->Arg(100)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopNestedFanOut, WorkStealingLoop)
+    ->Arg(10)
+    ->Arg(100)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
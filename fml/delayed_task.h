@@ -5,26 +5,34 @@
 #ifndef FLUTTER_FML_DELAYED_TASK_H_
 #define FLUTTER_FML_DELAYED_TASK_H_
 
+#include <algorithm>
 #include <queue>
+#include <vector>
 
-#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
 #include "flutter/fml/task_source_grade.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_task.h"
 
 namespace fml {
 
 class DelayedTask {
  public:
   DelayedTask(size_t order,
-              const fml::closure& task,
+              fml::UniqueTask task,
               fml::TimePoint target_time,
               fml::TaskSourceGrade task_source_grade);
 
-  DelayedTask(const DelayedTask& other);
+  DelayedTask(DelayedTask&& other);
+
+  DelayedTask& operator=(DelayedTask&& other);
 
   ~DelayedTask();
 
-  const fml::closure& GetTask() const;
+  const fml::UniqueTask& GetTask() const;
+
+  /// Moves the task out, leaving this one empty.
+  fml::UniqueTask TakeTask();
 
   fml::TimePoint GetTargetTime() const;
 
@@ -34,14 +42,28 @@ class DelayedTask {
 
  private:
   size_t order_;
-  fml::closure task_;
+  fml::UniqueTask task_;
   fml::TimePoint target_time_;
   fml::TaskSourceGrade task_source_grade_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DelayedTask);
 };
 
-using DelayedTaskQueue = std::priority_queue<DelayedTask,
-                                             std::deque<DelayedTask>,
-                                             std::greater<DelayedTask>>;
+/// A min-heap of tasks ordered by target time, then by order of registration.
+/// Since tasks are move-only, the top task is moved out by `Pop` rather than
+/// being copied from `top()`.
+class DelayedTaskQueue
+    : public std::priority_queue<DelayedTask,
+                                 std::vector<DelayedTask>,
+                                 std::greater<DelayedTask>> {
+ public:
+  DelayedTask Pop() {
+    std::pop_heap(c.begin(), c.end(), comp);
+    DelayedTask task = std::move(c.back());
+    c.pop_back();
+    return task;
+  }
+};
 
 }  // namespace fml
 
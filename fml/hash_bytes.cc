@@ -0,0 +1,57 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/hash_bytes.h"
+
+#include <cstring>
+
+namespace fml {
+
+namespace {
+
+constexpr uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ull;
+
+uint64_t MixHash(uint64_t hash, uint64_t word) {
+  hash ^= word;
+  hash *= kHashMultiplier;
+  return hash ^ (hash >> 29);
+}
+
+}  // namespace
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  // Four independent lanes keep the multiplies of consecutive words from
+  // waiting on each other when hashing large buffers.
+  constexpr size_t kLaneCount = 4u;
+  uint64_t lanes[kLaneCount];
+  for (size_t lane = 0; lane < kLaneCount; lane++) {
+    lanes[lane] = seed + lane * kHashMultiplier;
+  }
+  size_t offset = 0u;
+  for (; offset + sizeof(lanes) <= size; offset += sizeof(lanes)) {
+    uint64_t words[kLaneCount];
+    std::memcpy(words, bytes + offset, sizeof(words));
+    for (size_t lane = 0; lane < kLaneCount; lane++) {
+      lanes[lane] = MixHash(lanes[lane], words[lane]);
+    }
+  }
+  uint64_t hash = MixHash(seed, size);
+  for (size_t lane = 0; lane < kLaneCount; lane++) {
+    hash = MixHash(hash, lanes[lane]);
+  }
+  for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + offset, sizeof(word));
+    hash = MixHash(hash, word);
+  }
+  if (offset < size) {
+    uint64_t tail = 0u;
+    std::memcpy(&tail, bytes + offset, size - offset);
+    hash = MixHash(hash, tail);
+  }
+  return hash;
+}
+
+}  // namespace fml
@@ -0,0 +1,30 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_HASH_BYTES_H_
+#define FLUTTER_FML_HASH_BYTES_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fml {
+
+static constexpr uint64_t kHashBytesSeed = 14695981039346656037ull;
+
+//------------------------------------------------------------------------------
+/// @brief      A fast, non-cryptographic 64-bit hash of `data` that consumes
+///             it eight bytes at a time. Pass the hash of a previous buffer as
+///             the `seed` to combine the hashes of both.
+///
+///             The result only depends on the bytes, their size and the seed,
+///             so it may be persisted, as long as it is read back on a device
+///             with the same byte order.
+///
+uint64_t HashBytes(const void* data,
+                   size_t size,
+                   uint64_t seed = kHashBytesSeed);
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_HASH_BYTES_H_
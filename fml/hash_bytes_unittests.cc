@@ -0,0 +1,40 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/hash_bytes.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+
+namespace fml {
+namespace testing {
+
+TEST(HashBytesTest, DependsOnEveryByte) {
+  // Long enough to be hashed in whole lanes, whole words, and a tail.
+  std::vector<uint8_t> bytes(77u);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = static_cast<uint8_t>(i * 13u);
+  }
+  const uint64_t hash = HashBytes(bytes.data(), bytes.size());
+  EXPECT_EQ(hash, HashBytes(bytes.data(), bytes.size()));
+  EXPECT_NE(hash, HashBytes(bytes.data(), bytes.size() - 1));
+  EXPECT_NE(hash, HashBytes(bytes.data(), bytes.size(), 1u));
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] ^= 0x10;
+    EXPECT_NE(hash, HashBytes(bytes.data(), bytes.size())) << i;
+    bytes[i] ^= 0x10;
+  }
+}
+
+TEST(HashBytesTest, DependsOnTheSizeOfTrailingZeros) {
+  std::vector<uint8_t> zeros(16u, 0u);
+  EXPECT_NE(HashBytes(zeros.data(), 0u), HashBytes(zeros.data(), 1u));
+  EXPECT_NE(HashBytes(zeros.data(), 7u), HashBytes(zeros.data(), 8u));
+  EXPECT_NE(HashBytes(zeros.data(), 8u), HashBytes(zeros.data(), 16u));
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -19,6 +19,7 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_task.h"
 #include "flutter/fml/wakeable.h"
 
 namespace fml {
@@ -39,7 +40,7 @@ class MessageLoopImpl : public Wakeable,
 
   virtual void Terminate() = 0;
 
-  void PostTask(const fml::closure& task, fml::TimePoint target_time);
+  void PostTask(fml::UniqueTask task, fml::TimePoint target_time);
 
   void AddTaskObserver(intptr_t key, const fml::closure& callback);
 
@@ -47,10 +47,17 @@ MessageLoopTaskQueues* MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
-  TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
-  ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
+  std::scoped_lock registry_lock(registry_mutex_);
+  TaskQueueId loop_id = TaskQueueId(queue_count_++);
+  const size_t chunk_index = loop_id / kEntriesPerChunk;
+  FML_CHECK(chunk_index < kMaxEntryChunks) << "Too many task queues.";
+  EntryChunk* chunk = entry_chunks_[chunk_index].load(std::memory_order_relaxed);
+  if (!chunk) {
+    chunk = new EntryChunk();
+    entry_chunks_[chunk_index].store(chunk, std::memory_order_release);
+  }
+  (*chunk)[loop_id % kEntriesPerChunk].store(new TaskQueueEntry(loop_id),
+                                             std::memory_order_release);
   return loop_id;
 }
 
@@ -59,28 +66,38 @@ MessageLoopTaskQueues::MessageLoopTaskQueues() : order_(0) {
       new TaskSourceGradeHolder{TaskSourceGrade::kUnspecified});
 }
 
-MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
+MessageLoopTaskQueues::~MessageLoopTaskQueues() {
+  for (auto& chunk_slot : entry_chunks_) {
+    std::unique_ptr<EntryChunk> chunk(chunk_slot.load());
+    if (!chunk) {
+      break;
+    }
+    for (auto& entry : *chunk) {
+      delete entry.load();
+    }
+  }
+}
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
-  auto& subsumed_set = queue_entry->owner_of;
+  std::scoped_lock registry_lock(registry_mutex_);
+  const auto& queue_entry = GetEntry(queue_id);
+  FML_DCHECK(queue_entry.subsumed_by.load() == kUnmerged);
+  auto& subsumed_set = queue_entry.owner_of;
   for (auto& subsumed : subsumed_set) {
-    queue_entries_.erase(subsumed);
+    TakeEntryLocked(subsumed);
   }
   // Erase owner queue_id at last to avoid &subsumed_set from being invalid
-  queue_entries_.erase(queue_id);
+  TakeEntryLocked(queue_id);
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
-  auto& subsumed_set = queue_entry->owner_of;
-  queue_entry->task_source->ShutDown();
+  auto group_lock = LockGroup(queue_id);
+  const auto& queue_entry = GetEntry(queue_id);
+  FML_DCHECK(queue_entry.subsumed_by.load() == kUnmerged);
+  auto& subsumed_set = queue_entry.owner_of;
+  queue_entry.task_source->ShutDown();
   for (auto& subsumed : subsumed_set) {
-    queue_entries_.at(subsumed)->task_source->ShutDown();
+    GetEntry(subsumed).task_source->ShutDown();
   }
 }
 
@@ -90,17 +107,17 @@ TaskSourceGrade MessageLoopTaskQueues::GetCurrentTaskSourceGrade() {
 
 void MessageLoopTaskQueues::RegisterTask(
     TaskQueueId queue_id,
-    const fml::closure& task,
+    fml::UniqueTask task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
+  auto group_lock = LockGroup(queue_id);
   size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->task_source->RegisterTask(
-      {order, task, target_time, task_source_grade});
+  const auto& queue_entry = GetEntry(queue_id);
+  queue_entry.task_source->RegisterTask(
+      {order, std::move(task), target_time, task_source_grade});
   TaskQueueId loop_to_wake = queue_id;
-  if (queue_entry->subsumed_by != kUnmerged) {
-    loop_to_wake = queue_entry->subsumed_by;
+  if (queue_entry.subsumed_by.load() != kUnmerged) {
+    loop_to_wake = queue_entry.subsumed_by.load();
   }
 
   // This can happen when the secondary tasks are paused.
@@ -110,13 +127,14 @@ void MessageLoopTaskQueues::RegisterTask(
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  auto group_lock = LockGroup(queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
-fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
-                                                     fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
+fml::UniqueTask MessageLoopTaskQueues::GetNextTaskToRun(
+    TaskQueueId queue_id,
+    fml::TimePoint from_time) {
+  auto group_lock = LockGroup(queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return nullptr;
   }
@@ -131,35 +149,42 @@ fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
   if (top.task.GetTargetTime() > from_time) {
     return nullptr;
   }
-  fml::closure invocation = top.task.GetTask();
-  queue_entries_.at(top.task_queue_id)
-      ->task_source->PopTask(top.task.GetTaskSourceGrade());
+  // |top| refers to the task in the heap, so read it before popping.
   const auto task_source_grade = top.task.GetTaskSourceGrade();
-  tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
+  fml::UniqueTask invocation = GetEntry(top.task_queue_id)
+                                   .task_source->PopTask(task_source_grade)
+                                   .TakeTask();
+  // Reuse this thread's holder so that running a task does not allocate.
+  if (tls_task_source_grade) {
+    tls_task_source_grade->task_source_grade = task_source_grade;
+  } else {
+    tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
+  }
   return invocation;
 }
 
 void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
                                            fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+  const auto& queue_entry = GetEntry(queue_id);
+  if (queue_entry.wakeable) {
+    queue_entry.wakeable->WakeUp(time);
   }
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  if (queue_entry->subsumed_by != kUnmerged) {
+  auto group_lock = LockGroup(queue_id);
+  const auto& queue_entry = GetEntry(queue_id);
+  if (queue_entry.subsumed_by.load() != kUnmerged) {
     return 0;
   }
 
   size_t total_tasks = 0;
-  total_tasks += queue_entry->task_source->GetNumPendingTasks();
+  total_tasks += queue_entry.task_source->GetNumPendingTasks();
 
-  auto& subsumed_set = queue_entry->owner_of;
+  auto& subsumed_set = queue_entry.owner_of;
   for (auto& subsumed : subsumed_set) {
-    const auto& subsumed_entry = queue_entries_.at(subsumed);
-    total_tasks += subsumed_entry->task_source->GetNumPendingTasks();
+    const auto& subsumed_entry = GetEntry(subsumed);
+    total_tasks += subsumed_entry.task_source->GetNumPendingTasks();
   }
   return total_tasks;
 }
@@ -167,33 +192,34 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
+  auto group_lock = LockGroup(queue_id);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  GetEntry(queue_id).task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  auto group_lock = LockGroup(queue_id);
+  GetEntry(queue_id).task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  auto group_lock = LockGroup(queue_id);
   std::vector<fml::closure> observers;
 
-  if (queue_entries_.at(queue_id)->subsumed_by != kUnmerged) {
+  const auto& queue_entry = GetEntry(queue_id);
+  if (queue_entry.subsumed_by.load() != kUnmerged) {
     return observers;
   }
 
-  for (const auto& observer : queue_entries_.at(queue_id)->task_observers) {
+  for (const auto& observer : queue_entry.task_observers) {
     observers.push_back(observer.second);
   }
 
-  auto& subsumed_set = queue_entries_.at(queue_id)->owner_of;
+  auto& subsumed_set = queue_entry.owner_of;
   for (auto& subsumed : subsumed_set) {
-    for (const auto& observer : queue_entries_.at(subsumed)->task_observers) {
+    for (const auto& observer : GetEntry(subsumed).task_observers) {
       observers.push_back(observer.second);
     }
   }
@@ -203,19 +229,21 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  auto group_lock = LockGroup(queue_id);
+  auto& queue_entry = GetEntry(queue_id);
+  FML_CHECK(!queue_entry.wakeable) << "Wakeable can only be set once.";
+  queue_entry.wakeable = wakeable;
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
-  auto& owner_entry = queue_entries_.at(owner);
-  auto& subsumed_entry = queue_entries_.at(subsumed);
+  // The registry lock keeps the topology from changing under the checks
+  // below.
+  std::scoped_lock registry_lock(registry_mutex_);
+  auto* owner_entry = &GetEntry(owner);
+  auto* subsumed_entry = &GetEntry(subsumed);
   auto& subsumed_set = owner_entry->owner_of;
   if (subsumed_set.find(subsumed) != subsumed_set.end()) {
     return true;
@@ -225,11 +253,12 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   // merged with other different queues.
 
   // Ensure owner_entry->subsumed_by being kUnmerged
-  if (owner_entry->subsumed_by != kUnmerged) {
+  if (owner_entry->subsumed_by.load() != kUnmerged) {
     FML_LOG(WARNING) << "Thread merging failed: owner_entry was already "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed
-                     << ", owner->subsumed_by=" << owner_entry->subsumed_by;
+                     << ", owner->subsumed_by="
+                     << owner_entry->subsumed_by.load();
     return false;
   }
   // Ensure subsumed_entry->owner_of being empty
@@ -241,17 +270,20 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
     return false;
   }
   // Ensure subsumed_entry->subsumed_by being kUnmerged
-  if (subsumed_entry->subsumed_by != kUnmerged) {
+  if (subsumed_entry->subsumed_by.load() != kUnmerged) {
     FML_LOG(WARNING) << "Thread merging failed: subsumed_entry was already "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed
                      << ", subsumed->subsumed_by="
-                     << subsumed_entry->subsumed_by;
+                     << subsumed_entry->subsumed_by.load();
     return false;
   }
-  // All checking is OK, set merged state.
+  // All checking is OK, set merged state. Both queues are the roots of their
+  // groups, so their own mutexes are the group mutexes. Posters that looked
+  // up the subsumed queue's group before this recheck it once locked.
+  std::scoped_lock group_locks(owner_entry->mutex, subsumed_entry->mutex);
   owner_entry->owner_of.insert(subsumed);
-  subsumed_entry->subsumed_by = owner;
+  subsumed_entry->subsumed_by.store(owner);
 
   if (HasPendingTasksUnlocked(owner)) {
     WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
@@ -261,22 +293,23 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& owner_entry = queue_entries_.at(owner);
+  std::scoped_lock registry_lock(registry_mutex_);
+  auto* owner_entry = &GetEntry(owner);
+  auto* subsumed_entry = &GetEntry(subsumed);
   if (owner_entry->owner_of.empty()) {
     FML_LOG(WARNING)
         << "Thread unmerging failed: owner_entry doesn't own anyone, owner="
         << owner << ", subsumed=" << subsumed;
     return false;
   }
-  if (owner_entry->subsumed_by != kUnmerged) {
+  if (owner_entry->subsumed_by.load() != kUnmerged) {
     FML_LOG(WARNING)
         << "Thread unmerging failed: owner_entry was subsumed by others, owner="
         << owner << ", subsumed=" << subsumed
-        << ", owner_entry->subsumed_by=" << owner_entry->subsumed_by;
+        << ", owner_entry->subsumed_by=" << owner_entry->subsumed_by.load();
     return false;
   }
-  if (queue_entries_.at(subsumed)->subsumed_by == kUnmerged) {
+  if (subsumed_entry->subsumed_by.load() == kUnmerged) {
     FML_LOG(WARNING) << "Thread unmerging failed: subsumed_entry wasn't "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed;
@@ -289,7 +322,10 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
     return false;
   }
 
-  queue_entries_.at(subsumed)->subsumed_by = kUnmerged;
+  // The owner's mutex guards the merged group and the subsumed queue's own
+  // mutex guards it once it is split off.
+  std::scoped_lock group_locks(owner_entry->mutex, subsumed_entry->mutex);
+  subsumed_entry->subsumed_by.store(kUnmerged);
   owner_entry->owner_of.erase(subsumed);
 
   if (HasPendingTasksUnlocked(owner)) {
@@ -305,52 +341,91 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
   if (owner == kUnmerged || subsumed == kUnmerged) {
     return false;
   }
-  auto& subsumed_set = queue_entries_.at(owner)->owner_of;
+  auto group_lock = LockGroup(owner);
+  auto& subsumed_set = GetEntry(owner).owner_of;
   return subsumed_set.find(subsumed) != subsumed_set.end();
 }
 
 std::set<TaskQueueId> MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
-  std::lock_guard guard(queue_mutex_);
-  return queue_entries_.at(owner)->owner_of;
+  auto group_lock = LockGroup(owner);
+  return GetEntry(owner).owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->PauseSecondary();
+  auto group_lock = LockGroup(queue_id);
+  GetEntry(queue_id).task_source->PauseSecondary();
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->ResumeSecondary();
+  auto group_lock = LockGroup(queue_id);
+  GetEntry(queue_id).task_source->ResumeSecondary();
   // Schedule a wake as needed.
   if (HasPendingTasksUnlocked(queue_id)) {
     WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
   }
 }
 
+TaskQueueEntry& MessageLoopTaskQueues::GetEntry(TaskQueueId queue_id) const {
+  const size_t chunk_index = queue_id / kEntriesPerChunk;
+  EntryChunk* chunk =
+      chunk_index < kMaxEntryChunks
+          ? entry_chunks_[chunk_index].load(std::memory_order_acquire)
+          : nullptr;
+  TaskQueueEntry* entry =
+      chunk ? (*chunk)[queue_id % kEntriesPerChunk].load(
+                  std::memory_order_acquire)
+            : nullptr;
+  FML_CHECK(entry) << "Unknown or disposed task queue " << queue_id;
+  return *entry;
+}
+
+std::unique_ptr<TaskQueueEntry> MessageLoopTaskQueues::TakeEntryLocked(
+    TaskQueueId queue_id) {
+  GetEntry(queue_id);
+  EntryChunk* chunk = entry_chunks_[queue_id / kEntriesPerChunk].load(
+      std::memory_order_relaxed);
+  return std::unique_ptr<TaskQueueEntry>(
+      (*chunk)[queue_id % kEntriesPerChunk].exchange(
+          nullptr, std::memory_order_acq_rel));
+}
+
+std::unique_lock<std::mutex> MessageLoopTaskQueues::LockGroup(
+    TaskQueueId queue_id) const {
+  auto& entry = GetEntry(queue_id);
+  while (true) {
+    const TaskQueueId root = entry.subsumed_by.load();
+    auto& root_entry = root == kUnmerged ? entry : GetEntry(root);
+    std::unique_lock<std::mutex> lock(root_entry.mutex);
+    // Merge and Unmerge hold the mutexes of both queues while they change
+    // |subsumed_by|, so if it still names |root| then |root| is the group.
+    if (entry.subsumed_by.load() == root) {
+      return lock;
+    }
+  }
+}
+
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     TaskQueueId queue_id) const {
-  const auto& entry = queue_entries_.at(queue_id);
-  bool is_subsumed = entry->subsumed_by != kUnmerged;
+  const auto& entry = GetEntry(queue_id);
+  bool is_subsumed = entry.subsumed_by.load() != kUnmerged;
   if (is_subsumed) {
     return false;
   }
 
-  if (!entry->task_source->IsEmpty()) {
+  if (!entry.task_source->IsEmpty()) {
     return true;
   }
 
-  auto& subsumed_set = entry->owner_of;
+  auto& subsumed_set = entry.owner_of;
   return std::any_of(
       subsumed_set.begin(), subsumed_set.end(), [&](const auto& subsumed) {
-        return !queue_entries_.at(subsumed)->task_source->IsEmpty();
+        return !GetEntry(subsumed).task_source->IsEmpty();
       });
 }
 
@@ -362,10 +437,10 @@ fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
 TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
     TaskQueueId owner) const {
   FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
-  if (entry->owner_of.empty()) {
-    FML_CHECK(!entry->task_source->IsEmpty());
-    return entry->task_source->Top();
+  const auto& entry = GetEntry(owner);
+  if (entry.owner_of.empty()) {
+    FML_CHECK(!entry.task_source->IsEmpty());
+    return entry.task_source->Top();
   }
 
   // Use optional for the memory of TopTask object.
@@ -381,11 +456,11 @@ TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
         }
       };
 
-  TaskSource* owner_tasks = entry->task_source.get();
+  TaskSource* owner_tasks = entry.task_source.get();
   top_task_updater(owner_tasks);
 
-  for (TaskQueueId subsumed : entry->owner_of) {
-    TaskSource* subsumed_tasks = queue_entries_.at(subsumed)->task_source.get();
+  for (TaskQueueId subsumed : entry.owner_of) {
+    TaskSource* subsumed_tasks = GetEntry(subsumed).task_source.get();
     top_task_updater(subsumed_tasks);
   }
   // At least one task at the top because PeekNextTaskUnlocked() is called after
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -15,9 +17,9 @@
 #include "flutter/fml/delayed_task.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
-#include "flutter/fml/synchronization/shared_mutex.h"
 #include "flutter/fml/task_queue_id.h"
 #include "flutter/fml/task_source.h"
+#include "flutter/fml/unique_task.h"
 #include "flutter/fml/wakeable.h"
 
 namespace fml {
@@ -29,9 +31,16 @@ static const TaskQueueId kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 /// Often a TaskQueue has a one-to-one relationship with a fml::MessageLoop,
 /// this isn't the case when TaskQueues are merged via
 /// \p fml::MessageLoopTaskQueues::Merge.
+///
+/// \p owner_of and \p subsumed_by only change while
+/// \p fml::MessageLoopTaskQueues holds its registry mutex and the mutexes of
+/// both entries involved. The other fields are guarded by the \p mutex of the
+/// entry at the root of the merge group, i.e. this entry's own mutex unless it
+/// is subsumed, in which case the mutex of its owner.
 class TaskQueueEntry {
  public:
   using TaskObservers = std::map<intptr_t, fml::closure>;
+  std::mutex mutex;
   Wakeable* wakeable;
   TaskObservers task_observers;
   std::unique_ptr<TaskSource> task_source;
@@ -42,7 +51,7 @@ class TaskQueueEntry {
 
   /// Identifies the TaskQueue that subsumes this TaskQueue. If it is kUnmerged
   /// it indicates that this TaskQueue is not owned by any other TaskQueue.
-  TaskQueueId subsumed_by;
+  std::atomic<TaskQueueId> subsumed_by;
 
   TaskQueueId created_for;
 
@@ -61,6 +70,14 @@ enum class FlushType {
 /// fml::MessageLoops.
 ///
 /// This also wakes up the loop at the required times.
+///
+/// There is no lock shared by all the queues on the posting path. Entries are
+/// published in chunks that never move, so looking one up takes no lock. Tasks
+/// and observers are guarded by a lock per merge group, so threads posting to
+/// or draining independent queues never contend with each other. A registry
+/// mutex only serializes creating, disposing, merging and unmerging queues.
+///
+/// As before, a queue must not be used once it has been disposed.
 /// \see fml::MessageLoop
 /// \see fml::Wakeable
 class MessageLoopTaskQueues {
@@ -78,14 +95,15 @@ class MessageLoopTaskQueues {
   // Tasks methods.
 
   void RegisterTask(TaskQueueId queue_id,
-                    const fml::closure& task,
+                    fml::UniqueTask task,
                     fml::TimePoint target_time,
                     fml::TaskSourceGrade task_source_grade =
                         fml::TaskSourceGrade::kUnspecified);
 
   bool HasPendingTasks(TaskQueueId queue_id) const;
 
-  fml::closure GetNextTaskToRun(TaskQueueId queue_id, fml::TimePoint from_time);
+  fml::UniqueTask GetNextTaskToRun(TaskQueueId queue_id,
+                                   fml::TimePoint from_time);
 
   size_t GetNumPendingTasks(TaskQueueId queue_id) const;
 
@@ -144,6 +162,24 @@ class MessageLoopTaskQueues {
 
   ~MessageLoopTaskQueues();
 
+  static constexpr size_t kEntriesPerChunk = 256;
+  static constexpr size_t kMaxEntryChunks = 4096;
+  using EntryChunk =
+      std::array<std::atomic<TaskQueueEntry*>, kEntriesPerChunk>;
+
+  // Returns the entry for the queue, which must not have been disposed.
+  TaskQueueEntry& GetEntry(TaskQueueId queue_id) const;
+
+  // Unpublishes the entry for the queue and returns it. The caller must hold
+  // |registry_mutex_|.
+  std::unique_ptr<TaskQueueEntry> TakeEntryLocked(TaskQueueId queue_id);
+
+  // Locks the mutex guarding the merge group |queue_id| belongs to.
+  std::unique_lock<std::mutex> LockGroup(TaskQueueId queue_id) const;
+
+  // Methods suffixed with Unlocked expect the caller to hold the mutex of the
+  // merge group of the queues they touch.
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
@@ -152,10 +188,13 @@ class MessageLoopTaskQueues {
 
   fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
 
-  mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
-
-  size_t task_queue_id_counter_ = 0;
+  std::mutex registry_mutex_;
+  // The number of queues ever created. Guarded by |registry_mutex_|.
+  size_t queue_count_ = 0;
+  // Indexed by TaskQueueId / kEntriesPerChunk, then TaskQueueId %
+  // kEntriesPerChunk. Chunks are allocated on demand and live as long as this
+  // object. Disposed entries are left null since ids are never reused.
+  std::array<std::atomic<EntryChunk*>, kMaxEntryChunks> entry_chunks_ = {};
 
   std::atomic_int order_;
 
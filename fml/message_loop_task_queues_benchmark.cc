@@ -44,7 +44,7 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
         const auto now = fml::TimePoint::Now();
         int num_invocations = 0;
         for (;;) {
-          fml::closure invocation =
+          fml::UniqueTask invocation =
               task_queue->GetNextTaskToRun(TaskQueueId(task_runner_id), now);
           if (!invocation) {
             break;
@@ -66,5 +66,89 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Each producer posts to and drains its own queue, the way the platform, UI,
+// raster and IO threads use their loops. Producers should not contend with
+// each other since every queue has its own lock.
+static void BM_RegisterAndGetTasksOnIndependentQueues(
+    benchmark::State& state) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  std::vector<TaskQueueId> queue_ids;
+  for (int i = 0; i < num_producers; i++) {
+    queue_ids.push_back(task_queue->CreateTaskQueue());
+  }
+
+  for (auto _ : state) {
+    std::vector<std::thread> producers;
+    producers.reserve(num_producers);
+    for (int i = 0; i < num_producers; i++) {
+      producers.emplace_back([task_queue, queue_id = queue_ids[i], past]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queue->RegisterTask(queue_id, [] {}, past);
+          fml::UniqueTask invocation =
+              task_queue->GetNextTaskToRun(queue_id, past);
+          benchmark::DoNotOptimize(invocation);
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+
+  for (auto queue_id : queue_ids) {
+    task_queue->Dispose(queue_id);
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          num_tasks_per_producer);
+}
+
+// Several producers posting to one queue, e.g. many threads posting to the
+// platform thread, while its loop drains it.
+static void BM_RegisterTasksFromMultipleProducers(benchmark::State& state) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 1000;
+  const int num_tasks = num_producers * num_tasks_per_producer;
+  const fml::TimePoint past = fml::TimePoint::Now();
+  const TaskQueueId queue_id = task_queue->CreateTaskQueue();
+
+  for (auto _ : state) {
+    std::vector<std::thread> producers;
+    producers.reserve(num_producers);
+    for (int i = 0; i < num_producers; i++) {
+      producers.emplace_back([task_queue, queue_id, past]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queue->RegisterTask(queue_id, [] {}, past);
+        }
+      });
+    }
+    int num_invocations = 0;
+    while (num_invocations < num_tasks) {
+      if (task_queue->GetNextTaskToRun(queue_id, past)) {
+        num_invocations++;
+      }
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+
+  task_queue->Dispose(queue_id);
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+BENCHMARK(BM_RegisterAndGetTasksOnIndependentQueues)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_RegisterTasksFromMultipleProducers)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
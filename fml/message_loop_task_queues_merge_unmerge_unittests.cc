@@ -6,6 +6,7 @@
 
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
@@ -33,7 +34,7 @@ static int CountRemainingTasks(fml::MessageLoopTaskQueues* task_queue,
                                bool run_invocation = false) {
   const auto now = ChronoTicksSinceEpoch();
   int count = 0;
-  fml::closure invocation;
+  fml::UniqueTask invocation;
   do {
     invocation = task_queue->GetNextTaskToRun(queue_id, now);
     if (!invocation) {
@@ -306,5 +307,35 @@ TEST(MessageLoopTaskQueueMergeUnmerge,
   latch.Wait();
 }
 
+TEST(MessageLoopTaskQueueMergeUnmerge, TasksPostedWhileMergingAreNotLost) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+
+  auto queue_id_1 = task_queue->CreateTaskQueue();
+  auto queue_id_2 = task_queue->CreateTaskQueue();
+
+  const int num_tasks_per_queue = 1000;
+  std::vector<std::thread> producers;
+  for (auto queue_id : {queue_id_1, queue_id_2}) {
+    producers.emplace_back([task_queue, queue_id]() {
+      for (int i = 0; i < num_tasks_per_queue; i++) {
+        task_queue->RegisterTask(queue_id, []() {}, ChronoTicksSinceEpoch());
+      }
+    });
+  }
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(task_queue->Merge(queue_id_1, queue_id_2));
+    ASSERT_TRUE(task_queue->Unmerge(queue_id_1, queue_id_2));
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  ASSERT_EQ(CountRemainingTasks(task_queue, queue_id_1) +
+                CountRemainingTasks(task_queue, queue_id_2),
+            2 * num_tasks_per_queue);
+}
+
 }  // namespace testing
 }  // namespace fml
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <memory>
 #include <thread>
 #include <utility>
 
@@ -103,7 +104,7 @@ TEST(MessageLoopTaskQueue, PreserveTaskOrdering) {
   const auto now = ChronoTicksSinceEpoch();
   int expected_value = 1;
   while (true) {
-    fml::closure invocation = task_queue->GetNextTaskToRun(queue_id, now);
+    fml::UniqueTask invocation = task_queue->GetNextTaskToRun(queue_id, now);
     if (!invocation) {
       break;
     }
@@ -143,7 +144,8 @@ TEST(MessageLoopTaskQueue, RegisterTasksOnMergedQueuesPreserveTaskOrdering) {
   // "test_val = 1" in platform_queue
   // "test_val = 2" in raster2_queue
   while (true) {
-    fml::closure invocation = task_queue->GetNextTaskToRun(platform_queue, now);
+    fml::UniqueTask invocation =
+        task_queue->GetNextTaskToRun(platform_queue, now);
     if (!invocation) {
       break;
     }
@@ -186,7 +188,8 @@ TEST(MessageLoopTaskQueue, UnmergeRespectTheOriginalTaskOrderingInQueues) {
   // "test_val = 1" in platform_queue
   // "test_val = 2" in raster_queue (running on platform)
   for (int i = 0; i < 3; i++) {
-    fml::closure invocation = task_queue->GetNextTaskToRun(platform_queue, now);
+    fml::UniqueTask invocation =
+        task_queue->GetNextTaskToRun(platform_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == i);
@@ -205,7 +208,8 @@ TEST(MessageLoopTaskQueue, UnmergeRespectTheOriginalTaskOrderingInQueues) {
   // platform_queue has 1 task left: "test_val = 4"
   {
     ASSERT_TRUE(task_queue->GetNumPendingTasks(platform_queue) == 1);
-    fml::closure invocation = task_queue->GetNextTaskToRun(platform_queue, now);
+    fml::UniqueTask invocation =
+        task_queue->GetNextTaskToRun(platform_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == 4);
@@ -215,14 +219,16 @@ TEST(MessageLoopTaskQueue, UnmergeRespectTheOriginalTaskOrderingInQueues) {
   // raster_queue has 2 tasks left: "test_val = 3" and "test_val = 5"
   {
     ASSERT_TRUE(task_queue->GetNumPendingTasks(raster_queue) == 2);
-    fml::closure invocation = task_queue->GetNextTaskToRun(raster_queue, now);
+    fml::UniqueTask invocation =
+        task_queue->GetNextTaskToRun(raster_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == 3);
   }
   {
     ASSERT_TRUE(task_queue->GetNumPendingTasks(raster_queue) == 1);
-    fml::closure invocation = task_queue->GetNextTaskToRun(raster_queue, now);
+    fml::UniqueTask invocation =
+        task_queue->GetNextTaskToRun(raster_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == 5);
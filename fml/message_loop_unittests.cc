@@ -6,7 +6,10 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <set>
 #include <thread>
 
 #include "flutter/fml/build_config.h"
@@ -14,7 +17,9 @@
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/thread.h"
 #include "flutter/fml/time/chrono_timestamp_provider.h"
+#include "flutter/fml/unique_task.h"
 #include "gtest/gtest.h"
 
 TEST(MessageLoop, GetCurrent) {
@@ -212,3 +217,102 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsBatchOfTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 1000;
+  fml::CountDownLatch latch(kCount);
+  std::atomic_size_t run_count = 0;
+  std::vector<fml::UniqueTask> tasks;
+  for (size_t i = 0; i < kCount; ++i) {
+    tasks.emplace_back([&]() {
+      run_count++;
+      latch.CountDown();
+    });
+  }
+  // Empty closures are ignored.
+  tasks.emplace_back();
+  task_runner->PostTasks(std::move(tasks));
+  latch.Wait();
+  ASSERT_EQ(run_count, kCount);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsTasksPostedFromWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kFanOut = 100;
+  fml::CountDownLatch outer_latch(kFanOut);
+  fml::CountDownLatch inner_latch(kFanOut * kFanOut);
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  for (size_t i = 0; i < kFanOut; ++i) {
+    task_runner->PostTask([&]() {
+      // These land in the posting worker's own deque and are stolen by the
+      // other workers.
+      EXPECT_TRUE(loop->RunsTasksOnCurrentThread());
+      for (size_t j = 0; j < kFanOut; ++j) {
+        task_runner->PostTask([&]() {
+          {
+            std::scoped_lock lock(thread_ids_mutex);
+            thread_ids.insert(std::this_thread::get_id());
+          }
+          inner_latch.CountDown();
+        });
+      }
+      outer_latch.CountDown();
+    });
+  }
+  // Wait for the outer tasks too so that the loop is not collected while a
+  // worker is still posting to it.
+  outer_latch.Wait();
+  inner_latch.Wait();
+  ASSERT_GE(thread_ids.size(), 1u);
+  ASSERT_FALSE(loop->RunsTasksOnCurrentThread());
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopPostTaskToAllWorkers) {
+  const size_t kWorkerCount = 4;
+  auto loop = fml::ConcurrentMessageLoop::Create(kWorkerCount);
+  fml::CountDownLatch latch(kWorkerCount);
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    {
+      std::scoped_lock lock(thread_ids_mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    }
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), kWorkerCount);
+}
+
+TEST(MessageLoop, PostingFramesToAnotherThreadKeepsTasksInline) {
+  fml::Thread ui_thread("ui");
+  fml::Thread raster_thread("raster");
+  auto ui_task_runner = ui_thread.GetTaskRunner();
+  auto raster_task_runner = raster_thread.GetTaskRunner();
+
+  // Stand-ins for what the UI thread hands the raster thread every frame.
+  auto pipeline = std::make_shared<int>(0);
+  std::weak_ptr<int> weak_rasterizer = pipeline;
+
+  const size_t kFrames = 100;
+  const size_t heap_allocations = fml::UniqueTask::GetHeapAllocationCount();
+  fml::CountDownLatch latch(kFrames);
+  ui_task_runner->PostTask([&]() {
+    for (size_t i = 0; i < kFrames; i++) {
+      raster_task_runner->PostTask([pipeline, weak_rasterizer, &latch]() {
+        if (auto rasterizer = weak_rasterizer.lock()) {
+          (*pipeline)++;
+        }
+        latch.CountDown();
+      });
+    }
+  });
+  latch.Wait();
+
+  ASSERT_EQ(*pipeline, static_cast<int>(kFrames));
+  ASSERT_EQ(fml::UniqueTask::GetHeapAllocationCount(), heap_allocations);
+}
@@ -21,18 +21,17 @@ TaskRunner::TaskRunner(fml::RefPtr<MessageLoopImpl> loop)
 
 TaskRunner::~TaskRunner() = default;
 
-void TaskRunner::PostTask(const fml::closure& task) {
-  loop_->PostTask(task, fml::TimePoint::Now());
+void TaskRunner::PostTask(fml::UniqueTask task) {
+  loop_->PostTask(std::move(task), fml::TimePoint::Now());
 }
 
-void TaskRunner::PostTaskForTime(const fml::closure& task,
+void TaskRunner::PostTaskForTime(fml::UniqueTask task,
                                  fml::TimePoint target_time) {
-  loop_->PostTask(task, target_time);
+  loop_->PostTask(std::move(task), target_time);
 }
 
-void TaskRunner::PostDelayedTask(const fml::closure& task,
-                                 fml::TimeDelta delay) {
-  loop_->PostTask(task, fml::TimePoint::Now() + delay);
+void TaskRunner::PostDelayedTask(fml::UniqueTask task, fml::TimeDelta delay) {
+  loop_->PostTask(std::move(task), fml::TimePoint::Now() + delay);
 }
 
 TaskQueueId TaskRunner::GetTaskQueueId() {
@@ -53,12 +52,12 @@ bool TaskRunner::RunsTasksOnCurrentThread() {
 }
 
 void TaskRunner::RunNowOrPostTask(const fml::RefPtr<fml::TaskRunner>& runner,
-                                  const fml::closure& task) {
+                                  fml::UniqueTask task) {
   FML_DCHECK(runner);
   if (runner->RunsTasksOnCurrentThread()) {
     task();
   } else {
-    runner->PostTask(task);
+    runner->PostTask(std::move(task));
   }
 }
 
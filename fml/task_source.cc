@@ -20,32 +20,30 @@ void TaskSource::ShutDown() {
   secondary_task_queue_ = {};
 }
 
-void TaskSource::RegisterTask(const DelayedTask& task) {
+void TaskSource::RegisterTask(DelayedTask task) {
   switch (task.GetTaskSourceGrade()) {
     case TaskSourceGrade::kUserInteraction:
-      primary_task_queue_.push(task);
+      primary_task_queue_.push(std::move(task));
       break;
     case TaskSourceGrade::kUnspecified:
-      primary_task_queue_.push(task);
+      primary_task_queue_.push(std::move(task));
       break;
     case TaskSourceGrade::kDartEventLoop:
-      secondary_task_queue_.push(task);
+      secondary_task_queue_.push(std::move(task));
       break;
   }
 }
 
-void TaskSource::PopTask(TaskSourceGrade grade) {
+DelayedTask TaskSource::PopTask(TaskSourceGrade grade) {
   switch (grade) {
     case TaskSourceGrade::kUserInteraction:
-      primary_task_queue_.pop();
-      break;
+      return primary_task_queue_.Pop();
     case TaskSourceGrade::kUnspecified:
-      primary_task_queue_.pop();
-      break;
+      return primary_task_queue_.Pop();
     case TaskSourceGrade::kDartEventLoop:
-      secondary_task_queue_.pop();
-      break;
+      return secondary_task_queue_.Pop();
   }
+  FML_UNREACHABLE();
 }
 
 size_t TaskSource::GetNumPendingTasks() const {
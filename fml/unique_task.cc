@@ -0,0 +1,21 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/unique_task.h"
+
+#include <atomic>
+
+namespace fml {
+
+static std::atomic<size_t> gHeapAllocationCount = 0;
+
+size_t UniqueTask::GetHeapAllocationCount() {
+  return gHeapAllocationCount.load(std::memory_order_relaxed);
+}
+
+void UniqueTask::RecordHeapAllocation() {
+  gHeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace fml
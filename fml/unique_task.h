@@ -0,0 +1,173 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_UNIQUE_TASK_H_
+#define FLUTTER_FML_UNIQUE_TASK_H_
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      A move-only `void()` callable used to hold tasks while they are
+///             queued.
+///
+///             Unlike `std::function`, callables of up to `kInlineCapacity`
+///             bytes (which includes a `std::function` itself, or a lambda
+///             capturing a few smart pointers) are stored inline, so moving
+///             the task between the queues of the task dispatcher never
+///             allocates. Larger callables are moved to the heap once, which
+///             is counted by `GetHeapAllocationCount`.
+///
+///             `fml::TaskRunner` takes tasks as `UniqueTask`s by value, so a
+///             lambda passed to `PostTask` is constructed in place and moved
+///             into the queue without ever becoming a `std::function`.
+///
+class UniqueTask {
+ public:
+  static constexpr size_t kInlineCapacity = 6 * sizeof(void*);
+
+  UniqueTask() = default;
+
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  UniqueTask(std::nullptr_t) {}
+
+  template <class Callable,
+            class = std::enable_if_t<
+                !std::is_same_v<std::decay_t<Callable>, UniqueTask> &&
+                std::is_invocable_r_v<void, std::decay_t<Callable>&>>>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  UniqueTask(Callable&& callable) {
+    using Stored = std::decay_t<Callable>;
+    if constexpr (IsNullable<Stored>::value) {
+      // Empty std::functions and null function pointers make empty tasks.
+      if (!callable) {
+        return;
+      }
+    }
+    if constexpr (FitsInline<Stored>()) {
+      new (&storage_) Stored(std::forward<Callable>(callable));
+      ops_ = &kInlineOps<Stored>;
+    } else {
+      RecordHeapAllocation();
+      *reinterpret_cast<Stored**>(&storage_) =
+          new Stored(std::forward<Callable>(callable));
+      ops_ = &kHeapOps<Stored>;
+    }
+  }
+
+  UniqueTask(UniqueTask&& other) noexcept { MoveFrom(other); }
+
+  UniqueTask& operator=(UniqueTask&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  UniqueTask& operator=(std::nullptr_t) {
+    Reset();
+    return *this;
+  }
+
+  ~UniqueTask() { Reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void operator()() const {
+    FML_DCHECK(ops_ != nullptr);
+    ops_->invoke(const_cast<Storage*>(&storage_));
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of tasks so far whose callable did not fit inline
+  ///             and had to be moved to the heap, across all threads.
+  ///
+  static size_t GetHeapAllocationCount();
+
+ private:
+  struct alignas(void*) Storage {
+    std::byte bytes[kInlineCapacity];
+  };
+
+  template <class T>
+  struct IsNullable : std::is_pointer<T> {};
+
+  template <class R, class... Args>
+  struct IsNullable<std::function<R(Args...)>> : std::true_type {};
+
+  struct Ops {
+    void (*invoke)(Storage* storage);
+    // Move constructs the callable into |to| and destroys the one in |from|.
+    void (*relocate)(Storage* from, Storage* to);
+    void (*destroy)(Storage* storage);
+  };
+
+  template <class Stored>
+  static constexpr bool FitsInline() {
+    return sizeof(Stored) <= sizeof(Storage) &&
+           alignof(Stored) <= alignof(Storage) &&
+           std::is_nothrow_move_constructible_v<Stored>;
+  }
+
+  template <class Stored>
+  static constexpr Ops kInlineOps = {
+      [](Storage* storage) {
+        (*std::launder(reinterpret_cast<Stored*>(storage)))();
+      },
+      [](Storage* from, Storage* to) {
+        Stored* stored = std::launder(reinterpret_cast<Stored*>(from));
+        new (to) Stored(std::move(*stored));
+        stored->~Stored();
+      },
+      [](Storage* storage) {
+        std::launder(reinterpret_cast<Stored*>(storage))->~Stored();
+      },
+  };
+
+  template <class Stored>
+  static constexpr Ops kHeapOps = {
+      [](Storage* storage) { (**reinterpret_cast<Stored**>(storage))(); },
+      [](Storage* from, Storage* to) {
+        *reinterpret_cast<Stored**>(to) = *reinterpret_cast<Stored**>(from);
+      },
+      [](Storage* storage) { delete *reinterpret_cast<Stored**>(storage); },
+  };
+
+  static void RecordHeapAllocation();
+
+  void MoveFrom(UniqueTask& other) {
+    if (other.ops_) {
+      other.ops_->relocate(&other.storage_, &storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  void Reset() {
+    if (ops_) {
+      // Clear first in case the callable's destructor drops the last
+      // reference to something that owns this task.
+      const Ops* ops = std::exchange(ops_, nullptr);
+      ops->destroy(&storage_);
+    }
+  }
+
+  Storage storage_;
+  const Ops* ops_ = nullptr;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(UniqueTask);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_UNIQUE_TASK_H_
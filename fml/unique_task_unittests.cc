@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/unique_task.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+
+#include "flutter/fml/closure.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(UniqueTaskTest, DefaultAndNullTasksAreEmpty) {
+  ASSERT_FALSE(UniqueTask());
+  ASSERT_FALSE(UniqueTask(nullptr));
+  ASSERT_FALSE(UniqueTask(fml::closure()));
+  void (*function)() = nullptr;
+  ASSERT_FALSE(UniqueTask(function));
+}
+
+TEST(UniqueTaskTest, SmallCallablesAreStoredInline) {
+  auto value = std::make_shared<int>(0);
+  const size_t heap_allocations = UniqueTask::GetHeapAllocationCount();
+
+  UniqueTask lambda_task([value]() { (*value)++; });
+  UniqueTask closure_task(fml::closure([value]() { (*value)++; }));
+  lambda_task();
+  closure_task();
+
+  ASSERT_EQ(*value, 2);
+  ASSERT_EQ(UniqueTask::GetHeapAllocationCount(), heap_allocations);
+}
+
+TEST(UniqueTaskTest, LargeCallablesAreCountedAsHeapAllocations) {
+  std::array<char, UniqueTask::kInlineCapacity + 1> payload = {};
+  payload[0] = 'a';
+  char seen = 0;
+  const size_t heap_allocations = UniqueTask::GetHeapAllocationCount();
+
+  UniqueTask task([payload, &seen]() { seen = payload[0]; });
+  UniqueTask moved(std::move(task));
+  moved();
+
+  ASSERT_EQ(seen, 'a');
+  ASSERT_EQ(UniqueTask::GetHeapAllocationCount(), heap_allocations + 1);
+}
+
+TEST(UniqueTaskTest, MoveTransfersOwnership) {
+  auto value = std::make_shared<int>(0);
+  UniqueTask task([value]() { (*value)++; });
+  ASSERT_EQ(value.use_count(), 2);
+
+  UniqueTask moved(std::move(task));
+  ASSERT_FALSE(task);  // NOLINT(bugprone-use-after-move)
+  ASSERT_TRUE(moved);
+  ASSERT_EQ(value.use_count(), 2);
+
+  UniqueTask assigned;
+  assigned = std::move(moved);
+  assigned();
+  ASSERT_EQ(*value, 1);
+
+  assigned = nullptr;
+  ASSERT_FALSE(assigned);
+  ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST(UniqueTaskTest, CanHoldMoveOnlyCallables) {
+  auto value = std::make_unique<int>(7);
+  int seen = 0;
+  UniqueTask task(
+      [value = std::move(value), &seen]() mutable { seen = *value; });
+  UniqueTask moved(std::move(task));
+  moved();
+  ASSERT_EQ(seen, 7);
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -0,0 +1,187 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_WORK_STEALING_DEQUE_H_
+#define FLUTTER_FML_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      A single producer, multiple consumer deque of pointers.
+///
+///             This is the Chase-Lev work stealing deque, using the memory
+///             orderings described in "Correct and Efficient Work-Stealing for
+///             Weak Memory Models" (Lê et al., PPoPP 2013).
+///
+///             Only the thread that owns the deque may call `Push` and `Pop`,
+///             which operate on the bottom of the deque in LIFO order. Any
+///             thread may call `Steal`, which takes from the top of the deque
+///             in FIFO order. None of the operations take a lock.
+///
+///             The deque does not own the pointees. Items still in the deque
+///             when it is collected must be drained by the owner beforehand.
+///
+template <class T>
+class WorkStealingDeque {
+  static_assert(std::is_pointer_v<T>,
+                "WorkStealingDeque only holds pointers since thieves may read "
+                "items concurrently with the owner overwriting them.");
+
+ public:
+  explicit WorkStealingDeque(size_t initial_capacity = 64) {
+    size_t capacity = 1;
+    while (capacity < initial_capacity) {
+      capacity <<= 1;
+    }
+    arrays_.push_back(std::make_unique<Array>(capacity));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  ~WorkStealingDeque() = default;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds an item to the bottom of the deque, growing it if
+  ///             necessary. May only be called by the owner.
+  ///
+  void Push(T item) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    Array* array = array_.load(std::memory_order_relaxed);
+    if (bottom - top > array->Capacity() - 1) {
+      array = Grow(array, top, bottom);
+    }
+    array->Put(bottom, item);
+    // A release store rather than the paper's release fence followed by a
+    // relaxed store. They are equivalent here, and this form is understood by
+    // ThreadSanitizer.
+    bottom_.store(bottom + 1, std::memory_order_release);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Removes the most recently pushed item. May only be called by
+  ///             the owner.
+  ///
+  /// @return     The item, or nullptr if the deque is empty.
+  ///
+  T Pop() {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      // Empty.
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T item = array->Get(bottom);
+    if (top == bottom) {
+      // Last item, race against thieves for it.
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Removes the least recently pushed item. May be called from
+  ///             any thread.
+  ///
+  /// @return     The item, or nullptr if the deque is empty or another thread
+  ///             took the item first.
+  ///
+  T Steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+      return nullptr;
+    }
+
+    Array* array = array_.load(std::memory_order_acquire);
+    T item = array->Get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the deque appeared empty at the time of the call.
+  ///             Only a hint when called concurrently with other operations.
+  ///
+  bool IsEmpty() const {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    return top >= bottom;
+  }
+
+ private:
+  class Array {
+   public:
+    explicit Array(int64_t capacity)
+        : capacity_(capacity),
+          mask_(capacity - 1),
+          items_(new std::atomic<T>[capacity]) {}
+
+    int64_t Capacity() const { return capacity_; }
+
+    T Get(int64_t index) const {
+      return items_[index & mask_].load(std::memory_order_relaxed);
+    }
+
+    void Put(int64_t index, T item) {
+      items_[index & mask_].store(item, std::memory_order_relaxed);
+    }
+
+   private:
+    const int64_t capacity_;
+    const int64_t mask_;
+    std::unique_ptr<std::atomic<T>[]> items_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Array);
+  };
+
+  // Thieves may still be reading from the old array after a grow, so arrays
+  // are retired rather than freed until the deque itself is collected. Growth
+  // doubles the capacity so this wastes at most as much as the live array.
+  Array* Grow(Array* array, int64_t top, int64_t bottom) {
+    auto grown = std::make_unique<Array>(array->Capacity() * 2);
+    for (int64_t i = top; i < bottom; i++) {
+      grown->Put(i, array->Get(i));
+    }
+    Array* result = grown.get();
+    arrays_.push_back(std::move(grown));
+    array_.store(result, std::memory_order_release);
+    return result;
+  }
+
+  std::atomic<int64_t> top_ = 0;
+  std::atomic<int64_t> bottom_ = 0;
+  std::atomic<Array*> array_;
+  // Only touched by the owner.
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_WORK_STEALING_DEQUE_H_
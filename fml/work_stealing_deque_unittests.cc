@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/work_stealing_deque.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(WorkStealingDequeTest, EmptyDequeReturnsNull) {
+  WorkStealingDeque<int*> deque;
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_EQ(deque.Pop(), nullptr);
+  EXPECT_EQ(deque.Steal(), nullptr);
+}
+
+TEST(WorkStealingDequeTest, PopIsLifoAndStealIsFifo) {
+  int items[3] = {0, 1, 2};
+  WorkStealingDeque<int*> deque;
+  for (int& item : items) {
+    deque.Push(&item);
+  }
+  EXPECT_FALSE(deque.IsEmpty());
+  EXPECT_EQ(deque.Pop(), &items[2]);
+  EXPECT_EQ(deque.Steal(), &items[0]);
+  EXPECT_EQ(deque.Pop(), &items[1]);
+  EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(WorkStealingDequeTest, GrowsPastInitialCapacity) {
+  std::vector<int> items(100);
+  WorkStealingDeque<int*> deque(4);
+  for (int& item : items) {
+    deque.Push(&item);
+  }
+  for (size_t i = 0; i < items.size(); i++) {
+    EXPECT_EQ(deque.Steal(), &items[i]);
+  }
+  EXPECT_EQ(deque.Pop(), nullptr);
+}
+
+TEST(WorkStealingDequeTest, EveryItemIsTakenExactlyOnce) {
+  constexpr size_t kItemCount = 100000;
+  constexpr size_t kThiefCount = 4;
+  std::vector<std::atomic_int> taken(kItemCount);
+  std::vector<size_t> indices(kItemCount);
+  WorkStealingDeque<size_t*> deque(16);
+  std::atomic_size_t taken_count = 0;
+  std::atomic_bool done = false;
+
+  std::vector<std::thread> thieves;
+  for (size_t i = 0; i < kThiefCount; i++) {
+    thieves.emplace_back([&]() {
+      while (!done) {
+        if (size_t* index = deque.Steal()) {
+          taken[*index]++;
+          taken_count++;
+        }
+      }
+    });
+  }
+
+  for (size_t i = 0; i < kItemCount; i++) {
+    indices[i] = i;
+    deque.Push(&indices[i]);
+    // Interleave pops with pushes so the owner races thieves for the last
+    // item.
+    if (i % 3 == 0) {
+      if (size_t* index = deque.Pop()) {
+        taken[*index]++;
+        taken_count++;
+      }
+    }
+  }
+  while (size_t* index = deque.Pop()) {
+    taken[*index]++;
+    taken_count++;
+  }
+  while (taken_count < kItemCount) {
+    std::this_thread::yield();
+  }
+  done = true;
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+
+  for (size_t i = 0; i < kItemCount; i++) {
+    ASSERT_EQ(taken[i], 1) << "Item " << i;
+  }
+}
+
+}  // namespace testing
+}  // namespace fml
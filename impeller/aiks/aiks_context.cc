@@ -54,7 +54,7 @@ bool AiksContext::Render(const Picture& picture,
 
   fml::ScopedCleanupClosure closure([&]() {
     if (reset_host_buffer) {
-      content_context_->GetTransientsBuffer().Reset();
+      content_context_->ResetTransientsBuffers();
     }
   });
   if (picture.pass) {
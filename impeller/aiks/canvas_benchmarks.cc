@@ -2,10 +2,29 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <iterator>
+
 #include "flutter/benchmarking/benchmarking.h"
 
+#include "impeller/aiks/aiks_context.h"
 #include "impeller/aiks/canvas.h"
 
+#if IMPELLER_ENABLE_VULKAN
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/native_library.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/vulkan/swiftshader_path.h"
+#include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/vk/entity_shaders_vk.h"
+#include "impeller/entity/vk/framebuffer_blend_shaders_vk.h"
+#include "impeller/entity/vk/modern_shaders_vk.h"
+#include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/pipeline_library_vk.h"
+#include "impeller/typographer/backends/skia/typographer_context_skia.h"
+#endif  // IMPELLER_ENABLE_VULKAN
+
 namespace impeller {
 
 namespace {
@@ -33,6 +52,117 @@ size_t DrawLine(Canvas& canvas) {
   }
   return 500;
 }
+
+#if IMPELLER_ENABLE_VULKAN
+// Splits |bounds| into two translucent save layers and recurses into both, so
+// that every layer has a sibling that can be rendered independently of it.
+size_t DrawNestedSaveLayers(Canvas& canvas, Rect bounds, int depth) {
+  if (depth == 0) {
+    canvas.DrawRect(bounds.Expand(-2.0f), {.color = Color::DarkKhaki()});
+    return 1;
+  }
+  size_t op_count = 0;
+  Point center = bounds.GetCenter();
+  Rect halves[2];
+  if (bounds.GetWidth() > bounds.GetHeight()) {
+    halves[0] = Rect::MakeLTRB(bounds.GetLeft(), bounds.GetTop(), center.x,
+                               bounds.GetBottom());
+    halves[1] = Rect::MakeLTRB(center.x, bounds.GetTop(), bounds.GetRight(),
+                               bounds.GetBottom());
+  } else {
+    halves[0] = Rect::MakeLTRB(bounds.GetLeft(), bounds.GetTop(),
+                               bounds.GetRight(), center.y);
+    halves[1] = Rect::MakeLTRB(bounds.GetLeft(), center.y, bounds.GetRight(),
+                               bounds.GetBottom());
+  }
+  for (const Rect& half : halves) {
+    canvas.SaveLayer({.color = Color::White().WithAlpha(0.9)}, half);
+    canvas.DrawRect(half, {.color = Color::CornflowerBlue().WithAlpha(0.1)});
+    op_count += DrawNestedSaveLayers(canvas, half, depth - 1) + 2;
+    canvas.Restore();
+  }
+  return op_count;
+}
+
+// Creates a Vulkan context on SwiftShader. If |cache_directory| is valid, the
+// pipeline cache is read from and persisted to it.
+std::shared_ptr<Context> CreateSwiftShaderContext(
+    fml::UniqueFD cache_directory = {}) {
+  static fml::RefPtr<fml::NativeLibrary> swiftshader =
+      fml::NativeLibrary::Create(VULKAN_SO_PATH);
+  if (!swiftshader) {
+    return nullptr;
+  }
+  auto proc_address =
+      swiftshader->ResolveFunction<PFN_vkGetInstanceProcAddr>(
+          "vkGetInstanceProcAddr");
+  if (!proc_address.has_value()) {
+    return nullptr;
+  }
+
+  ContextVK::Settings settings;
+  settings.proc_address_callback = proc_address.value();
+  settings.cache_directory = std::move(cache_directory);
+  settings.shader_libraries_data = {
+      std::make_shared<fml::NonOwnedMapping>(impeller_entity_shaders_vk_data,
+                                             impeller_entity_shaders_vk_length),
+      std::make_shared<fml::NonOwnedMapping>(impeller_modern_shaders_vk_data,
+                                             impeller_modern_shaders_vk_length),
+      std::make_shared<fml::NonOwnedMapping>(
+          impeller_framebuffer_blend_shaders_vk_data,
+          impeller_framebuffer_blend_shaders_vk_length),
+  };
+  std::shared_ptr<ContextVK> context = ContextVK::Create(std::move(settings));
+  if (!context || !context->IsValid()) {
+    return nullptr;
+  }
+  return context;
+}
+
+// Waits for all of the work submitted to the queue of |context| so far.
+void WaitForGPU(const std::shared_ptr<Context>& context) {
+  auto done = std::make_shared<fml::AutoResetWaitableEvent>();
+  auto status = context->GetCommandQueue()->Submit(
+      {context->CreateCommandBuffer()},
+      [done](CommandBuffer::Status) { done->Signal(); });
+  if (status.ok()) {
+    done->Wait();
+  }
+}
+
+template <class PipelineHandleT>
+bool CreatePipeline(const Context& context) {
+  auto desc = PipelineHandleT::Builder::MakeDefaultPipelineDescriptor(context);
+  if (!desc.has_value()) {
+    return false;
+  }
+  auto pipeline =
+      context.GetPipelineLibrary()->GetPipeline(*desc, /*async=*/false).Get();
+  return pipeline && pipeline->IsValid();
+}
+
+// Creates the pipelines for the most common contents, returning the number of
+// pipelines that were created.
+size_t CreateCommonPipelines(const Context& context) {
+  bool results[] = {
+      CreatePipeline<SolidFillPipeline>(context),
+      CreatePipeline<TexturePipeline>(context),
+      CreatePipeline<TextureStrictSrcPipeline>(context),
+      CreatePipeline<LinearGradientFillPipeline>(context),
+      CreatePipeline<RadialGradientFillPipeline>(context),
+      CreatePipeline<ConicalGradientFillPipeline>(context),
+      CreatePipeline<SweepGradientFillPipeline>(context),
+      CreatePipeline<RRectBlurPipeline>(context),
+      CreatePipeline<BorderMaskBlurPipeline>(context),
+      CreatePipeline<ColorMatrixColorFilterPipeline>(context),
+      CreatePipeline<LinearToSrgbFilterPipeline>(context),
+      CreatePipeline<SrgbToLinearFilterPipeline>(context),
+      CreatePipeline<YUVToRGBFilterPipeline>(context),
+      CreatePipeline<ClipPipeline>(context),
+  };
+  return std::count(std::begin(results), std::end(results), true);
+}
+#endif  // IMPELLER_ENABLE_VULKAN
 }  // namespace
 
 // A set of benchmarks that measures the CPU cost of encoding canvas operations.
@@ -60,4 +190,107 @@ BENCHMARK_CAPTURE(BM_CanvasRecord, draw_rect, &DrawRect);
 BENCHMARK_CAPTURE(BM_CanvasRecord, draw_circle, &DrawCircle);
 BENCHMARK_CAPTURE(BM_CanvasRecord, draw_line, &DrawLine);
 
+#if IMPELLER_ENABLE_VULKAN
+// Measures the CPU cost of rendering a tree of sibling save layers with the
+// Vulkan backend on SwiftShader, with the offscreen passes recorded either on
+// the calling thread or on the workers of the content context.
+static void BM_CanvasRender(benchmark::State& state, bool concurrent) {
+  std::shared_ptr<Context> context = CreateSwiftShaderContext();
+  if (!context) {
+    state.SkipWithError("Could not create a SwiftShader Vulkan context.");
+    return;
+  }
+  AiksContext aiks_context(context, TypographerContextSkia::Make());
+  if (!concurrent) {
+    aiks_context.GetContentContext().SetWorkerTaskRunner(nullptr);
+  }
+
+  static constexpr int kLayerDepth = 6;
+  Canvas canvas;
+  size_t op_count = DrawNestedSaveLayers(
+      canvas, Rect::MakeXYWH(0, 0, 1024, 1024), kLayerDepth);
+  Picture picture = canvas.EndRecordingAsPicture();
+
+  RenderTargetAllocator render_target_allocator(
+      context->GetResourceAllocator());
+  RenderTarget render_target = render_target_allocator.CreateOffscreenMSAA(
+      *context, {1024, 1024}, /*mip_count=*/1);
+
+  size_t frame_count = 0u;
+  while (state.KeepRunning()) {
+    if (!aiks_context.Render(picture, render_target,
+                             /*reset_host_buffer=*/true)) {
+      state.SkipWithError("Failed to render the picture.");
+      break;
+    }
+    frame_count++;
+
+    state.PauseTiming();
+    WaitForGPU(context);
+    context->DisposeThreadLocalCachedResources();
+    state.ResumeTiming();
+  }
+  state.counters["TotalOpCount"] = op_count * frame_count;
+  state.counters["TotalFrameCount"] = frame_count;
+  context->Shutdown();
+}
+
+BENCHMARK_CAPTURE(BM_CanvasRender, nested_save_layers_serial, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_CanvasRender, nested_save_layers_concurrent, true)
+    ->Unit(benchmark::kMillisecond);
+
+// Measures the time it takes to create the pipelines of a fresh context, either
+// from scratch or with the pipeline cache that an earlier run of the same
+// context persisted to disk.
+static void BM_PipelineCreation(benchmark::State& state, bool warm) {
+  fml::ScopedTemporaryDirectory cache_directory;
+  auto open_cache_directory = [&]() -> fml::UniqueFD {
+    if (!warm) {
+      return {};
+    }
+    return fml::OpenDirectory(cache_directory.path().c_str(), false,
+                              fml::FilePermission::kReadWrite);
+  };
+
+  if (warm) {
+    std::shared_ptr<Context> context =
+        CreateSwiftShaderContext(open_cache_directory());
+    if (!context) {
+      state.SkipWithError("Could not create a SwiftShader Vulkan context.");
+      return;
+    }
+    CreateCommonPipelines(*context);
+    PipelineLibraryVK::Cast(*context->GetPipelineLibrary())
+        .GetPSOCache()
+        ->PersistCacheToDisk();
+    context->Shutdown();
+  }
+
+  size_t pipeline_count = 0u;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    std::shared_ptr<Context> context =
+        CreateSwiftShaderContext(open_cache_directory());
+    if (!context) {
+      state.SkipWithError("Could not create a SwiftShader Vulkan context.");
+      break;
+    }
+    state.ResumeTiming();
+
+    pipeline_count += CreateCommonPipelines(*context);
+
+    state.PauseTiming();
+    context->Shutdown();
+    state.ResumeTiming();
+  }
+  state.counters["TotalPipelineCount"] = pipeline_count;
+}
+
+BENCHMARK_CAPTURE(BM_PipelineCreation, cold_start, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PipelineCreation, warm_start, true)
+    ->Unit(benchmark::kMillisecond);
+#endif  // IMPELLER_ENABLE_VULKAN
+
 }  // namespace impeller
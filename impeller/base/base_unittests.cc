@@ -2,8 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <atomic>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/testing/testing.h"
 #include "impeller/base/mask.h"
+#include "impeller/base/parallel_for_each.h"
 #include "impeller/base/promise.h"
 #include "impeller/base/strings.h"
 #include "impeller/base/thread.h"
@@ -447,5 +452,34 @@ TEST(BaseTest, CanUseTypedMasks) {
   }
 }
 
+TEST(ParallelForEachTest, RunsEveryIndexOnceWithoutWorkers) {
+  std::vector<int> counts(17, 0);
+  ParallelForEach(nullptr, counts.size(),
+                  [&counts](size_t index) { counts[index]++; });
+  for (int count : counts) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(ParallelForEachTest, RunsEveryIndexOnceWithWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  std::vector<std::atomic_int> counts(257);
+  ParallelForEach(loop->GetTaskRunner(), counts.size(),
+                  [&counts](size_t index) { counts[index]++; });
+  for (const std::atomic_int& count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(ParallelForEachTest, CanBeNested) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2u);
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic_int count = 0;
+  ParallelForEach(task_runner, 8u, [&](size_t) {
+    ParallelForEach(task_runner, 8u, [&](size_t) { count++; });
+  });
+  EXPECT_EQ(count.load(), 64);
+}
+
 }  // namespace testing
 }  // namespace impeller
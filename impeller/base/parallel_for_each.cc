@@ -0,0 +1,56 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/base/parallel_for_each.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace impeller {
+
+void ParallelForEach(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner,
+    size_t count,
+    const std::function<void(size_t)>& task) {
+  if (!worker_task_runner || count <= 1u) {
+    for (size_t index = 0; index < count; index++) {
+      task(index);
+    }
+    return;
+  }
+
+  struct State {
+    explicit State(size_t count) : latch(count) {}
+    std::atomic_size_t next_index = 0u;
+    fml::CountDownLatch latch;
+  };
+  auto state = std::make_shared<State>(count);
+  // Only indices that were claimed reference |task|, and the calling thread
+  // waits for all of them, so a worker task that starts after all the indices
+  // were claimed returns without touching it.
+  auto run_indices = [state, &task, count]() {
+    size_t index;
+    while ((index = state->next_index.fetch_add(1u)) < count) {
+      task(index);
+      state->latch.CountDown();
+    }
+  };
+
+  size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+  size_t worker_count = std::min<size_t>(count, thread_count) - 1u;
+  std::vector<fml::UniqueTask> worker_tasks;
+  worker_tasks.reserve(worker_count);
+  for (size_t i = 0; i < worker_count; i++) {
+    worker_tasks.emplace_back(run_indices);
+  }
+  worker_task_runner->PostTasks(std::move(worker_tasks));
+  run_indices();
+  state->latch.Wait();
+}
+
+}  // namespace impeller
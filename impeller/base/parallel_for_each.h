@@ -0,0 +1,38 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_BASE_PARALLEL_FOR_EACH_H_
+#define FLUTTER_IMPELLER_BASE_PARALLEL_FOR_EACH_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Invoke `task` once for every index in `[0, count)` and wait for
+///             all of the invocations to finish.
+///
+///             When a worker task runner is available, the indices are offered
+///             to its workers. The calling thread also takes indices until none
+///             are left, so the work completes even if the workers are busy,
+///             or if this is called from one of them.
+///
+/// @param[in]  worker_task_runner  The workers to share the indices with. May
+///                                 be null, in which case every index is
+///                                 processed on the calling thread.
+/// @param[in]  count               The number of indices.
+/// @param[in]  task                The task to invoke for each index.
+///
+void ParallelForEach(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner,
+    size_t count,
+    const std::function<void(size_t)>& task);
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_BASE_PARALLEL_FOR_EACH_H_
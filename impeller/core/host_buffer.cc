@@ -4,9 +4,11 @@
 
 #include "impeller/core/host_buffer.h"
 
+#include <algorithm>
 #include <cstring>
 #include <tuple>
 
+#include "flutter/fml/trace_event.h"
 #include "impeller/core/allocator.h"
 #include "impeller/core/buffer_view.h"
 #include "impeller/core/device_buffer.h"
@@ -17,6 +19,10 @@ namespace impeller {
 
 constexpr size_t kAllocatorBlockSize = 1024000;  // 1024 Kb.
 
+// A dedicated buffer is only reused for allocations that fill at least half
+// of it.
+constexpr size_t kMaxDedicatedBufferWaste = 2u;
+
 std::shared_ptr<HostBuffer> HostBuffer::Create(
     const std::shared_ptr<Allocator>& allocator) {
   return std::shared_ptr<HostBuffer>(new HostBuffer(allocator));
@@ -40,11 +46,13 @@ void HostBuffer::SetLabel(std::string label) {
 
 BufferView HostBuffer::Emplace(const void* buffer,
                                size_t length,
-                               size_t align) {
+                               size_t align,
+                               DataKind kind) {
   auto [range, device_buffer] = EmplaceInternal(buffer, length, align);
   if (!device_buffer) {
     return {};
   }
+  RecordEmplace(kind, length);
   return BufferView{std::move(device_buffer), range};
 }
 
@@ -58,14 +66,33 @@ BufferView HostBuffer::Emplace(const void* buffer, size_t length) {
 
 BufferView HostBuffer::Emplace(size_t length,
                                size_t align,
-                               const EmplaceProc& cb) {
+                               const EmplaceProc& cb,
+                               DataKind kind) {
   auto [range, device_buffer] = EmplaceInternal(length, align, cb);
   if (!device_buffer) {
     return {};
   }
+  RecordEmplace(kind, length);
   return BufferView{std::move(device_buffer), range};
 }
 
+void HostBuffer::RecordEmplace(DataKind kind, size_t length) {
+  switch (kind) {
+    case DataKind::kUniform:
+      frame_statistics_.uniform_bytes += length;
+      break;
+    case DataKind::kVertex:
+      frame_statistics_.vertex_bytes += length;
+      break;
+    case DataKind::kIndex:
+      frame_statistics_.index_bytes += length;
+      break;
+    case DataKind::kOther:
+      frame_statistics_.other_bytes += length;
+      break;
+  }
+}
+
 HostBuffer::TestStateQuery HostBuffer::GetStateForTest() {
   return HostBuffer::TestStateQuery{
       .current_frame = frame_index_,
@@ -75,6 +102,7 @@ HostBuffer::TestStateQuery HostBuffer::GetStateForTest() {
 }
 
 void HostBuffer::MaybeCreateNewBuffer() {
+  frame_statistics_.padding_bytes += kAllocatorBlockSize - offset_;
   current_buffer_++;
   if (current_buffer_ >= device_buffers_[frame_index_].size()) {
     DeviceBufferDescriptor desc;
@@ -93,14 +121,10 @@ std::tuple<Range, std::shared_ptr<DeviceBuffer>> HostBuffer::EmplaceInternal(
     return {};
   }
 
-  // If the requested allocation is bigger than the block size, create a one-off
-  // device buffer and write to that.
+  // If the requested allocation is bigger than the block size, write to a
+  // dedicated device buffer.
   if (length > kAllocatorBlockSize) {
-    DeviceBufferDescriptor desc;
-    desc.size = length;
-    desc.storage_mode = StorageMode::kHostVisible;
-    std::shared_ptr<DeviceBuffer> device_buffer =
-        allocator_->CreateBuffer(desc);
+    std::shared_ptr<DeviceBuffer> device_buffer = GetDedicatedBuffer(length);
     if (!device_buffer) {
       return {};
     }
@@ -119,6 +143,7 @@ std::tuple<Range, std::shared_ptr<DeviceBuffer>> HostBuffer::EmplaceInternal(
     MaybeCreateNewBuffer();
   } else {
     offset_ += padding;
+    frame_statistics_.padding_bytes += padding;
   }
 
   const std::shared_ptr<DeviceBuffer>& current_buffer = GetCurrentBuffer();
@@ -134,14 +159,10 @@ std::tuple<Range, std::shared_ptr<DeviceBuffer>> HostBuffer::EmplaceInternal(
 std::tuple<Range, std::shared_ptr<DeviceBuffer>> HostBuffer::EmplaceInternal(
     const void* buffer,
     size_t length) {
-  // If the requested allocation is bigger than the block size, create a one-off
-  // device buffer and write to that.
+  // If the requested allocation is bigger than the block size, write to a
+  // dedicated device buffer.
   if (length > kAllocatorBlockSize) {
-    DeviceBufferDescriptor desc;
-    desc.size = length;
-    desc.storage_mode = StorageMode::kHostVisible;
-    std::shared_ptr<DeviceBuffer> device_buffer =
-        allocator_->CreateBuffer(desc);
+    std::shared_ptr<DeviceBuffer> device_buffer = GetDedicatedBuffer(length);
     if (!device_buffer) {
       return {};
     }
@@ -176,10 +197,13 @@ HostBuffer::EmplaceInternal(const void* buffer, size_t length, size_t align) {
     return EmplaceInternal(buffer, length);
   }
 
-  {
+  // Allocations larger than a block get a dedicated buffer, which is always
+  // aligned.
+  if (length <= kAllocatorBlockSize) {
     auto padding = align - (GetLength() % align);
     if (offset_ + padding < kAllocatorBlockSize) {
       offset_ += padding;
+      frame_statistics_.padding_bytes += padding;
     } else {
       MaybeCreateNewBuffer();
     }
@@ -188,19 +212,72 @@ HostBuffer::EmplaceInternal(const void* buffer, size_t length, size_t align) {
   return EmplaceInternal(buffer, length);
 }
 
+std::shared_ptr<DeviceBuffer> HostBuffer::GetDedicatedBuffer(size_t length) {
+  // This arena was last used |kHostBufferArenaSize| frames ago, so the GPU is
+  // done with its dedicated buffers. Reuse the smallest one that fits.
+  std::vector<std::shared_ptr<DeviceBuffer>>& buffers =
+      dedicated_buffers_[frame_index_];
+  size_t best = buffers.size();
+  for (size_t i = dedicated_buffer_count_; i < buffers.size(); i++) {
+    size_t size = buffers[i]->GetDeviceBufferDescriptor().size;
+    if (size >= length && size / kMaxDedicatedBufferWaste <= length &&
+        (best == buffers.size() ||
+         size < buffers[best]->GetDeviceBufferDescriptor().size)) {
+      best = i;
+    }
+  }
+  if (best == buffers.size()) {
+    DeviceBufferDescriptor desc;
+    desc.size = length;
+    desc.storage_mode = StorageMode::kHostVisible;
+    std::shared_ptr<DeviceBuffer> device_buffer =
+        allocator_->CreateBuffer(desc);
+    if (!device_buffer) {
+      return nullptr;
+    }
+    buffers.push_back(std::move(device_buffer));
+    frame_statistics_.dedicated_buffer_allocations++;
+  }
+  std::swap(buffers[best], buffers[dedicated_buffer_count_]);
+  return buffers[dedicated_buffer_count_++];
+}
+
 const std::shared_ptr<DeviceBuffer>& HostBuffer::GetCurrentBuffer() const {
   return device_buffers_[frame_index_][current_buffer_];
 }
 
 void HostBuffer::Reset() {
-  // When resetting the host buffer state at the end of the frame, check if
-  // there are any unused buffers and remove them.
-  while (device_buffers_[frame_index_].size() > current_buffer_ + 1) {
+  frame_statistics_.block_count = current_buffer_ + 1;
+  frame_statistics_.padding_bytes += kAllocatorBlockSize - offset_;
+  FML_TRACE_COUNTER("impeller",                                         //
+                    "HostBuffer",                                       //
+                    reinterpret_cast<int64_t>(this),                    //
+                    "UniformBytes", frame_statistics_.uniform_bytes,    //
+                    "VertexBytes", frame_statistics_.vertex_bytes,      //
+                    "IndexBytes", frame_statistics_.index_bytes,        //
+                    "OtherBytes", frame_statistics_.other_bytes,        //
+                    "PaddingBytes", frame_statistics_.padding_bytes,    //
+                    "Blocks", frame_statistics_.block_count,            //
+                    "DedicatedBuffers", dedicated_buffer_count_         //
+  );
+
+  // When resetting the host buffer state at the end of the frame, remove the
+  // blocks that none of the recent frames needed, and the dedicated buffers
+  // that this frame didn't reuse.
+  block_count_history_[history_index_] = frame_statistics_.block_count;
+  history_index_ = (history_index_ + 1) % kHostBufferHighWaterFrames;
+  size_t high_water = *std::max_element(block_count_history_.begin(),
+                                        block_count_history_.end());
+  while (device_buffers_[frame_index_].size() > high_water) {
     device_buffers_[frame_index_].pop_back();
   }
+  dedicated_buffers_[frame_index_].resize(dedicated_buffer_count_);
 
+  last_frame_statistics_ = frame_statistics_;
+  frame_statistics_ = {};
   offset_ = 0u;
   current_buffer_ = 0u;
+  dedicated_buffer_count_ = 0u;
   frame_index_ = (frame_index_ + 1) % kHostBufferArenaSize;
 }
 
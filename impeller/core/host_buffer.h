@@ -21,12 +21,45 @@ namespace impeller {
 /// Approximately the same size as the max frames in flight.
 static const constexpr size_t kHostBufferArenaSize = 3u;
 
+/// The number of recent frames whose peak block usage decides how many blocks
+/// each arena keeps when it is reset.
+static const constexpr size_t kHostBufferHighWaterFrames = 60u;
+
 /// The host buffer class manages one more 1024 Kb blocks of device buffer
 /// allocations.
 ///
-/// These are reset per-frame.
+/// These are reset per-frame. Each of the |kHostBufferArenaSize| frame arenas
+/// keeps as many blocks as the busiest of the last
+/// |kHostBufferHighWaterFrames| frames used, so that frames with fluctuating
+/// usage don't reallocate blocks. Allocations larger than a block get a
+/// dedicated buffer that is reused by later frames of the same arena.
 class HostBuffer {
  public:
+  /// The kind of data that is emplaced, used to attribute the emplaced bytes
+  /// in the |FrameStatistics|.
+  enum class DataKind {
+    kUniform,
+    kVertex,
+    kIndex,
+    kOther,
+  };
+
+  /// The usage of the host buffer over one frame.
+  struct FrameStatistics {
+    size_t uniform_bytes = 0u;
+    size_t vertex_bytes = 0u;
+    size_t index_bytes = 0u;
+    size_t other_bytes = 0u;
+    /// The bytes skipped to align emplaced data, and the bytes left unused at
+    /// the end of blocks.
+    size_t padding_bytes = 0u;
+    /// The number of blocks used, not counting dedicated buffers.
+    size_t block_count = 0u;
+    /// The number of dedicated buffers that had to be allocated because no
+    /// dedicated buffer of an earlier frame could be reused.
+    size_t dedicated_buffer_allocations = 0u;
+  };
+
   static std::shared_ptr<HostBuffer> Create(
       const std::shared_ptr<Allocator>& allocator);
 
@@ -52,7 +85,8 @@ class HostBuffer {
         std::max(alignof(UniformType), DefaultUniformAlignment());
     return Emplace(reinterpret_cast<const void*>(&uniform),  // buffer
                    sizeof(UniformType),                      // size
-                   alignment                                 // alignment
+                   alignment,                                // alignment
+                   DataKind::kUniform                        // kind
     );
   }
 
@@ -75,7 +109,8 @@ class HostBuffer {
         std::max(alignof(StorageBufferType), DefaultUniformAlignment());
     return Emplace(&buffer,                    // buffer
                    sizeof(StorageBufferType),  // size
-                   alignment                   // alignment
+                   alignment,                  // alignment
+                   DataKind::kUniform          // kind
     );
   }
 
@@ -100,9 +135,21 @@ class HostBuffer {
     );
   }
 
+  //----------------------------------------------------------------------------
+  /// @brief      Emplace a copy of the given data onto the host buffer.
+  ///
+  /// @param[in]  buffer     The data to copy, or nullptr to leave the emplaced
+  ///                        bytes undefined.
+  /// @param[in]  length     The number of bytes to emplace.
+  /// @param[in]  align      Minimum alignment of the data being emplaced.
+  /// @param[in]  kind       The kind of data, for the frame statistics.
+  ///
+  /// @return     The buffer view.
+  ///
   [[nodiscard]] BufferView Emplace(const void* buffer,
                                    size_t length,
-                                   size_t align);
+                                   size_t align,
+                                   DataKind kind = DataKind::kOther);
 
   using EmplaceProc = std::function<void(uint8_t* buffer)>;
 
@@ -115,16 +162,27 @@ class HostBuffer {
   ///
   /// @param[in]  cb            A callback that will be passed a ptr to the
   ///                           underlying host buffer.
+  /// @param[in]  kind          The kind of data, for the frame statistics.
   ///
   /// @return     The buffer view.
   ///
-  BufferView Emplace(size_t length, size_t align, const EmplaceProc& cb);
+  BufferView Emplace(size_t length,
+                     size_t align,
+                     const EmplaceProc& cb,
+                     DataKind kind = DataKind::kOther);
 
   //----------------------------------------------------------------------------
   /// @brief Resets the contents of the HostBuffer to nothing so it can be
   ///        reused.
   void Reset();
 
+  //----------------------------------------------------------------------------
+  /// @brief Returns the usage of the frame that was last completed by
+  ///        |Reset|.
+  const FrameStatistics& GetLastFrameStatistics() const {
+    return last_frame_statistics_;
+  }
+
   /// Test only internal state.
   struct TestStateQuery {
     size_t current_frame;
@@ -149,6 +207,12 @@ class HostBuffer {
 
   void MaybeCreateNewBuffer();
 
+  /// Returns a buffer for an allocation that is larger than a block, reusing
+  /// a dedicated buffer of an earlier frame of this arena when possible.
+  std::shared_ptr<DeviceBuffer> GetDedicatedBuffer(size_t length);
+
+  void RecordEmplace(DataKind kind, size_t length);
+
   const std::shared_ptr<DeviceBuffer>& GetCurrentBuffer() const;
 
   [[nodiscard]] BufferView Emplace(const void* buffer, size_t length);
@@ -162,9 +226,18 @@ class HostBuffer {
   std::shared_ptr<Allocator> allocator_;
   std::array<std::vector<std::shared_ptr<DeviceBuffer>>, kHostBufferArenaSize>
       device_buffers_;
+  // The dedicated buffers of each arena. The ones used by the current frame
+  // come first.
+  std::array<std::vector<std::shared_ptr<DeviceBuffer>>, kHostBufferArenaSize>
+      dedicated_buffers_;
   size_t current_buffer_ = 0u;
+  size_t dedicated_buffer_count_ = 0u;
   size_t offset_ = 0u;
   size_t frame_index_ = 0u;
+  std::array<size_t, kHostBufferHighWaterFrames> block_count_history_ = {};
+  size_t history_index_ = 0u;
+  FrameStatistics frame_statistics_;
+  FrameStatistics last_frame_statistics_;
   std::string label_;
 };
 
@@ -60,7 +60,7 @@ bool DlPlayground::OpenPlaygroundHere(DisplayListPlaygroundCallback callback) {
             IRect::MakeMaximum());
         list->Dispatch(impeller_dispatcher);
         impeller_dispatcher.FinishRecording();
-        context.GetContentContext().GetTransientsBuffer().Reset();
+        context.GetContentContext().ResetTransientsBuffers();
         context.GetContentContext().GetLazyGlyphAtlas()->ResetTextFrames();
         return true;
 #else
@@ -4,7 +4,9 @@
 
 #include "impeller/entity/contents/content_context.h"
 
+#include <algorithm>
 #include <memory>
+#include <thread>
 #include <utility>
 
 #include "fml/trace_event.h"
@@ -13,6 +15,7 @@
 #include "impeller/core/formats.h"
 #include "impeller/core/texture_descriptor.h"
 #include "impeller/entity/contents/framebuffer_blend_contents.h"
+#include "impeller/entity/contents/pipeline_usage_profile.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/render_target_cache.h"
 #include "impeller/renderer/command_buffer.h"
@@ -25,6 +28,13 @@
 
 namespace impeller {
 
+// How often the pipeline usage profile is persisted if it changed.
+static constexpr size_t kPipelineUsageProfilePersistFrameInterval = 50u;
+
+// The innermost worker scope of the calling thread, if any.
+static thread_local const ContentContext::WorkerScope* tls_worker_scope =
+    nullptr;
+
 void ContentContextOptions::ApplyToPipelineDescriptor(
     PipelineDescriptor& desc) const {
   auto pipeline_blend = blend_mode;
@@ -253,7 +263,8 @@ ContentContext::ContentContext(
                                ? std::make_shared<RenderTargetCache>(
                                      context_->GetResourceAllocator())
                                : std::move(render_target_allocator)),
-      host_buffer_(HostBuffer::Create(context_->GetResourceAllocator())) {
+      host_buffer_(HostBuffer::Create(context_->GetResourceAllocator())),
+      pipeline_usage_profile_(std::make_unique<PipelineUsageProfile>()) {
   if (!context_ || !context_->IsValid()) {
     return;
   }
@@ -458,11 +469,178 @@ ContentContext::ContentContext(
   }
 #endif  // IMPELLER_ENABLE_OPENGLES
 
+  RegisterVariantsForPrecompilation({
+      &solid_fill_pipelines_,
+      &fast_gradient_pipelines_,
+      &linear_gradient_fill_pipelines_,
+      &radial_gradient_fill_pipelines_,
+      &conical_gradient_fill_pipelines_,
+      &sweep_gradient_fill_pipelines_,
+      &linear_gradient_ssbo_fill_pipelines_,
+      &radial_gradient_ssbo_fill_pipelines_,
+      &conical_gradient_ssbo_fill_pipelines_,
+      &sweep_gradient_ssbo_fill_pipelines_,
+      &rrect_blur_pipelines_,
+      &texture_pipelines_,
+      &texture_strict_src_pipelines_,
+#ifdef IMPELLER_ENABLE_OPENGLES
+      &tiled_texture_external_pipelines_,
+#endif  // IMPELLER_ENABLE_OPENGLES
+      &tiled_texture_pipelines_,
+      &gaussian_blur_pipelines_,
+      &border_mask_blur_pipelines_,
+      &morphology_filter_pipelines_,
+      &color_matrix_color_filter_pipelines_,
+      &linear_to_srgb_filter_pipelines_,
+      &srgb_to_linear_filter_pipelines_,
+      &clip_pipelines_,
+      &glyph_atlas_pipelines_,
+      &yuv_to_rgb_filter_pipelines_,
+      &porter_duff_blend_pipelines_,
+      &blend_color_pipelines_,
+      &blend_colorburn_pipelines_,
+      &blend_colordodge_pipelines_,
+      &blend_darken_pipelines_,
+      &blend_difference_pipelines_,
+      &blend_exclusion_pipelines_,
+      &blend_hardlight_pipelines_,
+      &blend_hue_pipelines_,
+      &blend_lighten_pipelines_,
+      &blend_luminosity_pipelines_,
+      &blend_multiply_pipelines_,
+      &blend_overlay_pipelines_,
+      &blend_saturation_pipelines_,
+      &blend_screen_pipelines_,
+      &blend_softlight_pipelines_,
+      &framebuffer_blend_color_pipelines_,
+      &framebuffer_blend_colorburn_pipelines_,
+      &framebuffer_blend_colordodge_pipelines_,
+      &framebuffer_blend_darken_pipelines_,
+      &framebuffer_blend_difference_pipelines_,
+      &framebuffer_blend_exclusion_pipelines_,
+      &framebuffer_blend_hardlight_pipelines_,
+      &framebuffer_blend_hue_pipelines_,
+      &framebuffer_blend_lighten_pipelines_,
+      &framebuffer_blend_luminosity_pipelines_,
+      &framebuffer_blend_multiply_pipelines_,
+      &framebuffer_blend_overlay_pipelines_,
+      &framebuffer_blend_saturation_pipelines_,
+      &framebuffer_blend_screen_pipelines_,
+      &framebuffer_blend_softlight_pipelines_,
+      &vertices_uber_shader_,
+  });
+
+  if (std::shared_ptr<PipelineLibrary> pipeline_library =
+          context_->GetPipelineLibrary()) {
+    if (std::unique_ptr<fml::Mapping> profile =
+            pipeline_library->LoadPipelineUsageProfile()) {
+      pipeline_usage_profile_->Load(*profile);
+    }
+  }
+
+  const bool supports_concurrent_recording =
+      context_->GetCapabilities()->SupportsConcurrentCommandRecording();
+  if (supports_concurrent_recording ||
+      pipeline_usage_profile_->GetEntryCount() > 0u) {
+    // A single worker is enough to request the precompiled variants, the
+    // backend compiles them on its own workers.
+    worker_message_loop_ = fml::ConcurrentMessageLoop::Create(
+        supports_concurrent_recording
+            ? std::clamp(std::thread::hardware_concurrency() / 2u, 1u, 4u)
+            : 1u);
+  }
+  if (supports_concurrent_recording) {
+    worker_task_runner_ = worker_message_loop_->GetTaskRunner();
+  }
+
   is_valid_ = true;
+  PrecompilePipelineVariants();
   InitializeCommonlyUsedShadersIfNeeded();
 }
 
-ContentContext::~ContentContext() = default;
+ContentContext::~ContentContext() {
+  // Stop precompiling variants and join the workers before the variants are
+  // destroyed.
+  precompilation_canceled_ = true;
+  worker_task_runner_.reset();
+  worker_message_loop_.reset();
+  PersistPipelineUsageProfileIfNeeded();
+}
+
+ContentContext::WorkerScope::WorkerScope(const ContentContext& content_context)
+    : content_context_(content_context),
+      transients_(content_context.AcquireWorkerTransients()),
+      previous_scope_(tls_worker_scope) {
+  tls_worker_scope = this;
+}
+
+ContentContext::WorkerScope::~WorkerScope() {
+  FML_DCHECK(tls_worker_scope == this);
+  tls_worker_scope = previous_scope_;
+  content_context_.ReleaseWorkerTransients(transients_);
+}
+
+const ContentContext::WorkerTransients* ContentContext::GetWorkerTransients()
+    const {
+  for (const WorkerScope* scope = tls_worker_scope; scope != nullptr;
+       scope = scope->previous_scope_) {
+    if (&scope->content_context_ == this) {
+      return scope->transients_;
+    }
+  }
+  return nullptr;
+}
+
+ContentContext::WorkerTransients* ContentContext::AcquireWorkerTransients()
+    const {
+  Lock lock(worker_transients_mutex_);
+  if (!idle_worker_transients_.empty()) {
+    WorkerTransients* transients = idle_worker_transients_.back();
+    idle_worker_transients_.pop_back();
+    return transients;
+  }
+  auto transients = std::make_unique<WorkerTransients>();
+  transients->host_buffer =
+      HostBuffer::Create(context_->GetResourceAllocator());
+  transients->tessellator = std::make_shared<Tessellator>();
+  worker_transients_.push_back(std::move(transients));
+  return worker_transients_.back().get();
+}
+
+void ContentContext::ReleaseWorkerTransients(
+    WorkerTransients* transients) const {
+  Lock lock(worker_transients_mutex_);
+  idle_worker_transients_.push_back(transients);
+}
+
+HostBuffer& ContentContext::GetTransientsBuffer() const {
+  if (const WorkerTransients* transients = GetWorkerTransients()) {
+    return *transients->host_buffer;
+  }
+  return *host_buffer_;
+}
+
+void ContentContext::ResetTransientsBuffers() const {
+  if (++frames_since_profile_persisted_ >=
+      kPipelineUsageProfilePersistFrameInterval) {
+    frames_since_profile_persisted_ = 0u;
+    PersistPipelineUsageProfileIfNeeded();
+  }
+
+  host_buffer_->Reset();
+  Lock lock(worker_transients_mutex_);
+  // All worker scopes have ended by the time the frame is done.
+  FML_DCHECK(idle_worker_transients_.size() == worker_transients_.size());
+  for (const std::unique_ptr<WorkerTransients>& transients :
+       worker_transients_) {
+    transients->host_buffer->Reset();
+  }
+}
+
+void ContentContext::SetWorkerTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  worker_task_runner_ = std::move(worker_task_runner);
+}
 
 bool ContentContext::IsValid() const {
   return is_valid_;
@@ -547,6 +725,9 @@ std::shared_ptr<scene::SceneContext> ContentContext::GetSceneContext() const {
 #endif  // IMPELLER_ENABLE_3D
 
 std::shared_ptr<Tessellator> ContentContext::GetTessellator() const {
+  if (const WorkerTransients* transients = GetWorkerTransients()) {
+    return transients->tessellator;
+  }
   return tessellator_;
 }
 
@@ -569,6 +750,7 @@ ContentContext::GetCachedRuntimeEffectPipeline(
     const std::function<std::shared_ptr<Pipeline<PipelineDescriptor>>()>&
         create_callback) const {
   RuntimeEffectPipelineKey key{unique_entrypoint_name, options};
+  Lock lock(runtime_effect_pipelines_mutex_);
   auto it = runtime_effect_pipelines_.find(key);
   if (it == runtime_effect_pipelines_.end()) {
     it = runtime_effect_pipelines_.insert(it, {key, create_callback()});
@@ -578,6 +760,7 @@ ContentContext::GetCachedRuntimeEffectPipeline(
 
 void ContentContext::ClearCachedRuntimeEffectPipeline(
     const std::string& unique_entrypoint_name) const {
+  Lock lock(runtime_effect_pipelines_mutex_);
   for (auto it = runtime_effect_pipelines_.begin();
        it != runtime_effect_pipelines_.end();) {
     if (it->first.unique_entrypoint_name == unique_entrypoint_name) {
@@ -588,6 +771,88 @@ void ContentContext::ClearCachedRuntimeEffectPipeline(
   }
 }
 
+const PipelineUsageProfile& ContentContext::GetPipelineUsageProfile() const {
+  return *pipeline_usage_profile_;
+}
+
+std::string ContentContext::GetVariantsName(
+    const std::optional<PipelineDescriptor>& descriptor) {
+  if (!descriptor.has_value()) {
+    return "";
+  }
+  // Some variants share their shaders and only differ by the specialization
+  // constants of their default pipeline.
+  std::string name = descriptor->GetLabel();
+  for (Scalar constant : descriptor->GetSpecializationConstants()) {
+    name += SPrintF(" %g", constant);
+  }
+  return name;
+}
+
+void ContentContext::DidCreatePipelineVariant(
+    const std::string& name,
+    const ContentContextOptions& options,
+    bool precompiled) const {
+  if (precompiled) {
+    ++precompiled_pipeline_variant_count_;
+  } else {
+    ++pipeline_variant_stall_count_;
+    // Wireframe variants are a debugging aid that is not worth precompiling.
+    if (!options.wireframe && pipeline_usage_profile_->Record(name, options)) {
+      pipeline_usage_profile_dirty_ = true;
+    }
+  }
+  FML_TRACE_COUNTER(
+      "flutter", "ContentContext",
+      reinterpret_cast<int64_t>(this),  // Trace Counter ID
+      "PipelineVariantStalls",
+      static_cast<int64_t>(pipeline_variant_stall_count_.load()),
+      "PrecompiledPipelineVariants",
+      static_cast<int64_t>(precompiled_pipeline_variant_count_.load()));
+}
+
+void ContentContext::RegisterVariantsForPrecompilation(
+    std::initializer_list<VariantsBase*> variants) {
+  for (VariantsBase* item : variants) {
+    // Only the variants with a default pipeline can create other variants.
+    if (!item->GetName().empty()) {
+      variants_by_name_[item->GetName()] = item;
+    }
+  }
+}
+
+void ContentContext::PrecompilePipelineVariants() {
+  std::vector<PipelineUsageProfile::Entry> entries =
+      pipeline_usage_profile_->GetEntries();
+  if (entries.empty() || !worker_message_loop_) {
+    return;
+  }
+  worker_message_loop_->GetTaskRunner()->PostTask(
+      [this, entries = std::move(entries)]() {
+        TRACE_EVENT0("flutter", "ContentContext::PrecompilePipelineVariants");
+        for (const PipelineUsageProfile::Entry& entry : entries) {
+          if (precompilation_canceled_) {
+            return;
+          }
+          auto found = variants_by_name_.find(entry.pipeline_name);
+          if (found != variants_by_name_.end()) {
+            found->second->Precompile(*this, entry.options);
+          }
+        }
+      });
+}
+
+void ContentContext::PersistPipelineUsageProfileIfNeeded() const {
+  if (!pipeline_usage_profile_dirty_.exchange(false)) {
+    return;
+  }
+  if (std::shared_ptr<PipelineLibrary> pipeline_library =
+          context_->GetPipelineLibrary()) {
+    pipeline_library->PersistPipelineUsageProfile(
+        pipeline_usage_profile_->Serialize());
+  }
+}
+
 void ContentContext::InitializeCommonlyUsedShadersIfNeeded() const {
   TRACE_EVENT0("flutter", "InitializeCommonlyUsedShadersIfNeeded");
   GetContext()->InitializeCommonlyUsedShadersIfNeeded();
@@ -5,13 +5,17 @@
 #ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_CONTENT_CONTEXT_H_
 #define FLUTTER_IMPELLER_ENTITY_CONTENTS_CONTENT_CONTEXT_H_
 
+#include <atomic>
 #include <initializer_list>
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/status_or.h"
+#include "impeller/base/thread.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/host_buffer.h"
@@ -362,6 +366,7 @@ struct ContentContextOptions {
 
 class Tessellator;
 class RenderTargetCache;
+class PipelineUsageProfile;
 
 class ContentContext {
  public:
@@ -747,9 +752,74 @@ class ContentContext {
 
   /// @brief Retrieve the currnent host buffer for transient storage.
   ///
-  /// This is only safe to use from the raster threads. Other threads should
-  /// allocate their own device buffers.
-  HostBuffer& GetTransientsBuffer() const { return *host_buffer_; }
+  /// This is only safe to use from the raster threads and from threads that
+  /// hold a `WorkerScope` for this context. Other threads should allocate
+  /// their own device buffers.
+  HostBuffer& GetTransientsBuffer() const;
+
+  /// @brief Reset the host buffers for transient storage, including the ones
+  ///        used by worker threads, at the end of a frame.
+  ///
+  /// This also periodically persists the pipeline usage profile if new
+  /// pipeline variants were used.
+  void ResetTransientsBuffers() const;
+
+  /// @brief The pipeline variants that were used by this context and the ones
+  ///        that were loaded from the profile of a previous run.
+  const PipelineUsageProfile& GetPipelineUsageProfile() const;
+
+  /// @brief The number of pipeline variants that had to be created when they
+  ///        were first used because they were not precompiled.
+  uint64_t GetPipelineVariantStallCount() const {
+    return pipeline_variant_stall_count_;
+  }
+
+  /// @brief The task runner used to record independent offscreen passes
+  ///        concurrently, or null if passes are recorded on the raster thread.
+  ///
+  /// The workers are only used when the backend supports concurrent command
+  /// recording. They are dedicated to this context so that they never wait on
+  /// work, such as pipeline compilation, that is queued behind them.
+  const std::shared_ptr<fml::ConcurrentTaskRunner>& GetWorkerTaskRunner()
+      const {
+    return worker_task_runner_;
+  }
+
+  /// @brief Override the task runner returned by `GetWorkerTaskRunner`. A null
+  ///        task runner records all passes on the raster thread.
+  void SetWorkerTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
+ private:
+  struct WorkerTransients;
+
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      While alive, routes the transients buffer and the tessellator
+  ///             of the content context to instances that are reserved for the
+  ///             calling thread.
+  ///
+  ///             Worker threads must hold a scope while recording commands
+  ///             with the content context. The instances are recycled across
+  ///             scopes and frames.
+  ///
+  class WorkerScope {
+   public:
+    explicit WorkerScope(const ContentContext& content_context);
+
+    ~WorkerScope();
+
+   private:
+    friend class ContentContext;
+
+    const ContentContext& content_context_;
+    WorkerTransients* transients_;
+    const WorkerScope* previous_scope_;
+
+    WorkerScope(const WorkerScope&) = delete;
+
+    WorkerScope& operator=(const WorkerScope&) = delete;
+  };
 
  private:
   std::shared_ptr<Context> context_;
@@ -783,11 +853,32 @@ class ContentContext {
     };
   };
 
+  mutable Mutex runtime_effect_pipelines_mutex_;
   mutable std::unordered_map<RuntimeEffectPipelineKey,
                              std::shared_ptr<Pipeline<PipelineDescriptor>>,
                              RuntimeEffectPipelineKey::Hash,
                              RuntimeEffectPipelineKey::Equal>
-      runtime_effect_pipelines_;
+      runtime_effect_pipelines_
+          IPLR_GUARDED_BY(runtime_effect_pipelines_mutex_);
+
+  /// The part of `Variants` that doesn't depend on the pipeline type, used to
+  /// precompile the variants in a pipeline usage profile.
+  class VariantsBase {
+   public:
+    virtual ~VariantsBase() = default;
+
+    /// A name derived from the default pipeline that identifies the variants
+    /// across runs, or empty if there is no default pipeline.
+    const std::string& GetName() const { return name_; }
+
+    /// Start compiling the variant for `options` in the background, unless it
+    /// exists already.
+    virtual void Precompile(const ContentContext& content_context,
+                            const ContentContextOptions& options) = 0;
+
+   protected:
+    std::string name_;
+  };
 
   /// Holds multiple Pipelines associated with the same PipelineHandle types.
   ///
@@ -803,7 +894,7 @@ class ContentContext {
   ///  - impeller::RenderPipelineHandle<> - The type of objects this typically
   ///    contains.
   template <class PipelineHandleT>
-  class Variants {
+  class Variants final : public VariantsBase {
    public:
     Variants() = default;
 
@@ -815,6 +906,7 @@ class ContentContext {
     void SetDefault(const ContentContextOptions& options,
                     std::unique_ptr<PipelineHandleT> pipeline) {
       default_options_ = options;
+      name_ = GetVariantsName(pipeline->GetDescriptor());
       Set(options, std::move(pipeline));
     }
 
@@ -847,6 +939,12 @@ class ContentContext {
 
     size_t GetPipelineCount() const { return pipelines_.size(); }
 
+    // |VariantsBase|
+    void Precompile(const ContentContext& content_context,
+                    const ContentContextOptions& options) override {
+      content_context.CreateIfNeeded(*this, options, /*precompile=*/true);
+    }
+
    private:
     std::optional<ContentContextOptions> default_options_;
     std::unordered_map<ContentContextOptions,
@@ -862,7 +960,8 @@ class ContentContext {
 
   // These are mutable because while the prototypes are created eagerly, any
   // variants requested from that are lazily created and cached in the variants
-  // map.
+  // map. Lookups and insertions of variants are guarded by |pipeline_mutex_|.
+  mutable RWMutex pipeline_mutex_;
 
   mutable Variants<SolidFillPipeline> solid_fill_pipelines_;
   mutable Variants<FastGradientPipeline> fast_gradient_pipelines_;
@@ -958,10 +1057,14 @@ class ContentContext {
     return pipeline->WaitAndGet();
   }
 
+  static std::string GetVariantsName(
+      const std::optional<PipelineDescriptor>& descriptor);
+
   template <class RenderPipelineHandleT>
   RenderPipelineHandleT* CreateIfNeeded(
       Variants<RenderPipelineHandleT>& container,
-      ContentContextOptions opts) const {
+      ContentContextOptions opts,
+      bool precompile = false) const {
     if (!IsValid()) {
       return nullptr;
     }
@@ -970,12 +1073,17 @@ class ContentContext {
       opts.wireframe = true;
     }
 
-    if (RenderPipelineHandleT* found = container.Get(opts)) {
-      return found;
+    RenderPipelineHandleT* default_handle = nullptr;
+    size_t variants_count = 0u;
+    {
+      ReaderLock lock(pipeline_mutex_);
+      if (RenderPipelineHandleT* found = container.Get(opts)) {
+        return found;
+      }
+      default_handle = container.GetDefault();
+      variants_count = container.GetPipelineCount();
     }
 
-    RenderPipelineHandleT* default_handle = container.GetDefault();
-
     // The default must always be initialized in the constructor.
     FML_CHECK(default_handle != nullptr);
 
@@ -985,19 +1093,56 @@ class ContentContext {
       return nullptr;
     }
 
+    // Variants that are used right away are created on the calling thread
+    // because it would have to wait for them anyway.
     auto variant_future = pipeline->CreateVariant(
-        /*async=*/false, [&opts, variants_count = container.GetPipelineCount()](
-                             PipelineDescriptor& desc) {
+        /*async=*/precompile,
+        [&opts, variants_count](PipelineDescriptor& desc) {
           opts.ApplyToPipelineDescriptor(desc);
           desc.SetLabel(
               SPrintF("%s V#%zu", desc.GetLabel().c_str(), variants_count));
         });
     std::unique_ptr<RenderPipelineHandleT> variant =
         std::make_unique<RenderPipelineHandleT>(std::move(variant_future));
-    container.Set(opts, std::move(variant));
-    return container.Get(opts);
+
+    // The variant is created without holding the lock so that threads looking
+    // up other variants are not blocked. If another thread created the same
+    // variant in the meantime, that one wins.
+    RenderPipelineHandleT* created = nullptr;
+    {
+      WriterLock lock(pipeline_mutex_);
+      if (RenderPipelineHandleT* found = container.Get(opts)) {
+        return found;
+      }
+      container.Set(opts, std::move(variant));
+      created = container.Get(opts);
+    }
+    DidCreatePipelineVariant(container.GetName(), opts, precompile);
+    return created;
   }
 
+  void DidCreatePipelineVariant(const std::string& name,
+                                const ContentContextOptions& options,
+                                bool precompiled) const;
+
+  void RegisterVariantsForPrecompilation(
+      std::initializer_list<VariantsBase*> variants);
+
+  void PrecompilePipelineVariants();
+
+  void PersistPipelineUsageProfileIfNeeded() const;
+
+  struct WorkerTransients {
+    std::shared_ptr<HostBuffer> host_buffer;
+    std::shared_ptr<Tessellator> tessellator;
+  };
+
+  const WorkerTransients* GetWorkerTransients() const;
+
+  WorkerTransients* AcquireWorkerTransients() const;
+
+  void ReleaseWorkerTransients(WorkerTransients* transients) const;
+
   bool is_valid_ = false;
   std::shared_ptr<Tessellator> tessellator_;
 #if IMPELLER_ENABLE_3D
@@ -1007,6 +1152,22 @@ class ContentContext {
   std::shared_ptr<HostBuffer> host_buffer_;
   std::shared_ptr<Texture> empty_texture_;
   bool wireframe_ = false;
+  mutable Mutex worker_transients_mutex_;
+  mutable std::vector<std::unique_ptr<WorkerTransients>> worker_transients_
+      IPLR_GUARDED_BY(worker_transients_mutex_);
+  mutable std::vector<WorkerTransients*> idle_worker_transients_
+      IPLR_GUARDED_BY(worker_transients_mutex_);
+  std::unique_ptr<PipelineUsageProfile> pipeline_usage_profile_;
+  std::unordered_map<std::string, VariantsBase*> variants_by_name_;
+  mutable std::atomic_bool pipeline_usage_profile_dirty_ = false;
+  mutable std::atomic_size_t frames_since_profile_persisted_ = 0u;
+  mutable std::atomic_uint64_t pipeline_variant_stall_count_ = 0u;
+  mutable std::atomic_uint64_t precompiled_pipeline_variant_count_ = 0u;
+  std::atomic_bool precompilation_canceled_ = false;
+  // Declared after the state used by its tasks so that the workers are joined
+  // before that state is destroyed.
+  std::shared_ptr<fml::ConcurrentMessageLoop> worker_message_loop_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
 
   ContentContext(const ContentContext&) = delete;
 
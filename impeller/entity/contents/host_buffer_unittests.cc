@@ -135,9 +135,21 @@ TEST_P(HostBufferTest, UnusedBuffersAreDiscardedWhenResetting) {
   EXPECT_EQ(buffer->GetStateForTest().total_buffer_count, 2u);
   EXPECT_EQ(buffer->GetStateForTest().current_frame, 0u);
 
+  // The buffer is kept while the busy frame is among the recent frames.
+  for (auto i = 0; i < 3; i++) {
+    buffer->Reset();
+  }
+
+  EXPECT_EQ(buffer->GetStateForTest().current_buffer, 0u);
+  EXPECT_EQ(buffer->GetStateForTest().total_buffer_count, 2u);
+  EXPECT_EQ(buffer->GetStateForTest().current_frame, 0u);
+
   // Now when we reset, the buffer should get dropped.
   // Reset until we get back to this frame.
-  for (auto i = 0; i < 3; i++) {
+  for (auto i = 0u; i < kHostBufferHighWaterFrames; i++) {
+    buffer->Reset();
+  }
+  while (buffer->GetStateForTest().current_frame != 0u) {
     buffer->Reset();
   }
 
@@ -146,6 +158,73 @@ TEST_P(HostBufferTest, UnusedBuffersAreDiscardedWhenResetting) {
   EXPECT_EQ(buffer->GetStateForTest().current_frame, 0u);
 }
 
+TEST_P(HostBufferTest, DedicatedBuffersAreReusedByLaterFrames) {
+  auto buffer = HostBuffer::Create(GetContext()->GetResourceAllocator());
+
+  BufferView first = buffer->Emplace(nullptr, 1024000 + 10, 0);
+  ASSERT_TRUE(first);
+  for (auto i = 0u; i < kHostBufferArenaSize; i++) {
+    buffer->Reset();
+  }
+  EXPECT_EQ(buffer->GetLastFrameStatistics().dedicated_buffer_allocations,
+            0u);
+
+  // A smaller allocation that fills most of the buffer reuses it.
+  BufferView second = buffer->Emplace(nullptr, 1024000 + 5, 0);
+  ASSERT_TRUE(second);
+  EXPECT_EQ(second.buffer, first.buffer);
+  EXPECT_EQ(second.range, Range(0, 1024000 + 5));
+
+  // The buffer is already used by this frame.
+  BufferView third = buffer->Emplace(nullptr, 1024000 + 5, 0);
+  ASSERT_TRUE(third);
+  EXPECT_NE(third.buffer, first.buffer);
+
+  buffer->Reset();
+  EXPECT_EQ(buffer->GetLastFrameStatistics().dedicated_buffer_allocations,
+            1u);
+}
+
+TEST_P(HostBufferTest, RecordsFrameStatistics) {
+  auto buffer = HostBuffer::Create(GetContext()->GetResourceAllocator());
+
+  struct alignas(16) Uniform {
+    float value[4];
+  };
+  std::array<float, 6> vertices = {};
+  std::array<uint16_t, 3> indices = {};
+
+  BufferView view = buffer->Emplace(indices.data(), sizeof(indices),
+                                    alignof(uint16_t),
+                                    HostBuffer::DataKind::kIndex);
+  EXPECT_EQ(view.range, Range(0, 6));
+  view = buffer->EmplaceUniform(Uniform{});
+  EXPECT_EQ(view.range.offset % DefaultUniformAlignment(), 0u);
+  view = buffer->Emplace(vertices.data(), sizeof(vertices), alignof(float),
+                         HostBuffer::DataKind::kVertex);
+  view = buffer->Emplace(12, alignof(float), [](uint8_t*) {},
+                         HostBuffer::DataKind::kVertex);
+  view = buffer->Emplace(std::array<char, 3>());
+
+  buffer->Reset();
+  const HostBuffer::FrameStatistics& statistics =
+      buffer->GetLastFrameStatistics();
+  EXPECT_EQ(statistics.uniform_bytes, sizeof(Uniform));
+  EXPECT_EQ(statistics.vertex_bytes, sizeof(vertices) + 12u);
+  EXPECT_EQ(statistics.index_bytes, sizeof(indices));
+  EXPECT_EQ(statistics.other_bytes, 3u);
+  EXPECT_EQ(statistics.block_count, 1u);
+  EXPECT_EQ(statistics.uniform_bytes + statistics.vertex_bytes +
+                statistics.index_bytes + statistics.other_bytes +
+                statistics.padding_bytes,
+            1024000u);
+
+  // The next frame starts from scratch.
+  buffer->Reset();
+  EXPECT_EQ(buffer->GetLastFrameStatistics().uniform_bytes, 0u);
+  EXPECT_EQ(buffer->GetLastFrameStatistics().padding_bytes, 1024000u);
+}
+
 TEST_P(HostBufferTest, EmplaceWithProcIsAligned) {
   auto buffer = HostBuffer::Create(GetContext()->GetResourceAllocator());
 
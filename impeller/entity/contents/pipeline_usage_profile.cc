@@ -0,0 +1,152 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/pipeline_usage_profile.h"
+
+#include <optional>
+#include <sstream>
+
+#include "impeller/base/strings.h"
+#include "impeller/entity/entity.h"
+
+namespace impeller {
+
+// Bump the version whenever the meaning of the serialized options changes.
+static constexpr std::string_view kProfileHeader =
+    "impeller-pipeline-usage-profile 1";
+
+// Each entry is one line with the options as integers followed by the name of
+// the variants container, which may contain spaces.
+static std::string SerializeEntry(std::string_view pipeline_name,
+                                  const ContentContextOptions& options) {
+  return SPrintF("%u %u %u %u %u %u %u %u %u %s",
+                 static_cast<uint32_t>(options.sample_count),
+                 static_cast<uint32_t>(options.blend_mode),
+                 static_cast<uint32_t>(options.depth_compare),
+                 static_cast<uint32_t>(options.stencil_mode),
+                 static_cast<uint32_t>(options.primitive_type),
+                 static_cast<uint32_t>(options.color_attachment_pixel_format),
+                 options.has_depth_stencil_attachments ? 1u : 0u,
+                 options.depth_write_enabled ? 1u : 0u,
+                 options.is_for_rrect_blur_clear ? 1u : 0u,
+                 std::string(pipeline_name).c_str());
+}
+
+static std::optional<PipelineUsageProfile::Entry> ParseEntry(
+    const std::string& line) {
+  std::istringstream stream(line);
+  uint32_t values[9] = {};
+  for (uint32_t& value : values) {
+    if (!(stream >> value)) {
+      return std::nullopt;
+    }
+  }
+  auto [sample_count, blend_mode, depth_compare, stencil_mode, primitive_type,
+        pixel_format, has_depth_stencil, depth_write, rrect_blur_clear] =
+      values;
+
+  // The profile is read from disk and may have been written by a different
+  // version of the engine, so only accept options that can be applied to a
+  // pipeline descriptor.
+  if ((sample_count != static_cast<uint32_t>(SampleCount::kCount1) &&
+       sample_count != static_cast<uint32_t>(SampleCount::kCount4)) ||
+      blend_mode > static_cast<uint32_t>(Entity::kLastPipelineBlendMode) ||
+      depth_compare > static_cast<uint32_t>(CompareFunction::kGreaterEqual) ||
+      stencil_mode >
+          static_cast<uint32_t>(ContentContextOptions::StencilMode::
+                                    kOverdrawPreventionRestore) ||
+      primitive_type > static_cast<uint32_t>(PrimitiveType::kPoint) ||
+      pixel_format > static_cast<uint32_t>(PixelFormat::kD32FloatS8UInt) ||
+      has_depth_stencil > 1u || depth_write > 1u || rrect_blur_clear > 1u) {
+    return std::nullopt;
+  }
+
+  std::string pipeline_name;
+  stream.ignore(1);
+  std::getline(stream, pipeline_name);
+  if (pipeline_name.empty()) {
+    return std::nullopt;
+  }
+
+  return PipelineUsageProfile::Entry{
+      .pipeline_name = std::move(pipeline_name),
+      .options = ContentContextOptions{
+          .sample_count = static_cast<SampleCount>(sample_count),
+          .blend_mode = static_cast<BlendMode>(blend_mode),
+          .depth_compare = static_cast<CompareFunction>(depth_compare),
+          .stencil_mode =
+              static_cast<ContentContextOptions::StencilMode>(stencil_mode),
+          .primitive_type = static_cast<PrimitiveType>(primitive_type),
+          .color_attachment_pixel_format =
+              static_cast<PixelFormat>(pixel_format),
+          .has_depth_stencil_attachments = has_depth_stencil == 1u,
+          .depth_write_enabled = depth_write == 1u,
+          .is_for_rrect_blur_clear = rrect_blur_clear == 1u,
+      }};
+}
+
+PipelineUsageProfile::PipelineUsageProfile() = default;
+
+PipelineUsageProfile::~PipelineUsageProfile() = default;
+
+bool PipelineUsageProfile::Load(const fml::Mapping& mapping) {
+  std::istringstream stream(
+      std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                  mapping.GetSize()));
+
+  Lock lock(mutex_);
+  entries_.clear();
+  keys_.clear();
+
+  std::string line;
+  if (!std::getline(stream, line) || line != kProfileHeader) {
+    return false;
+  }
+  while (std::getline(stream, line) && entries_.size() < kMaxEntries) {
+    std::optional<Entry> entry = ParseEntry(line);
+    if (!entry.has_value()) {
+      continue;
+    }
+    if (keys_.insert(SerializeEntry(entry->pipeline_name, entry->options))
+            .second) {
+      entries_.push_back(std::move(entry.value()));
+    }
+  }
+  return true;
+}
+
+bool PipelineUsageProfile::Record(std::string_view pipeline_name,
+                                  const ContentContextOptions& options) {
+  std::string key = SerializeEntry(pipeline_name, options);
+  Lock lock(mutex_);
+  if (entries_.size() >= kMaxEntries || !keys_.insert(std::move(key)).second) {
+    return false;
+  }
+  entries_.push_back(Entry{std::string(pipeline_name), options});
+  return true;
+}
+
+std::vector<PipelineUsageProfile::Entry> PipelineUsageProfile::GetEntries()
+    const {
+  Lock lock(mutex_);
+  return entries_;
+}
+
+size_t PipelineUsageProfile::GetEntryCount() const {
+  Lock lock(mutex_);
+  return entries_.size();
+}
+
+std::shared_ptr<fml::Mapping> PipelineUsageProfile::Serialize() const {
+  std::string data(kProfileHeader);
+  data.push_back('\n');
+  Lock lock(mutex_);
+  for (const Entry& entry : entries_) {
+    data.append(SerializeEntry(entry.pipeline_name, entry.options));
+    data.push_back('\n');
+  }
+  return std::make_shared<fml::DataMapping>(data);
+}
+
+}  // namespace impeller
@@ -0,0 +1,86 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_USAGE_PROFILE_H_
+#define FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_USAGE_PROFILE_H_
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "flutter/fml/mapping.h"
+#include "impeller/base/thread.h"
+#include "impeller/entity/contents/content_context.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      The pipeline variants that an application used, in the order in
+///             which they were first used.
+///
+///             The content context records every variant that it had to
+///             create while rendering. The profile is persisted by the
+///             pipeline library so that the next launch of the application
+///             can compile the same variants in the background before they
+///             are needed.
+///
+///             Recording is safe from multiple threads.
+///
+class PipelineUsageProfile {
+ public:
+  struct Entry {
+    /// The name of the default pipeline of the variant, which is stable
+    /// across runs.
+    std::string pipeline_name;
+    ContentContextOptions options;
+  };
+
+  /// The maximum number of variants that are recorded.
+  static constexpr size_t kMaxEntries = 512u;
+
+  PipelineUsageProfile();
+
+  ~PipelineUsageProfile();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the entries of the profile with the ones serialized in
+  ///             `mapping`.
+  ///
+  /// @return     If the mapping contained a profile of the current version.
+  ///             Entries that are malformed or have out of range options are
+  ///             skipped.
+  ///
+  bool Load(const fml::Mapping& mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Add a variant to the profile.
+  ///
+  /// @return     If the variant was not in the profile already and there was
+  ///             room for it.
+  ///
+  bool Record(std::string_view pipeline_name,
+              const ContentContextOptions& options);
+
+  std::vector<Entry> GetEntries() const;
+
+  size_t GetEntryCount() const;
+
+  std::shared_ptr<fml::Mapping> Serialize() const;
+
+ private:
+  mutable Mutex mutex_;
+  std::vector<Entry> entries_ IPLR_GUARDED_BY(mutex_);
+  // The serialized form of each entry.
+  std::unordered_set<std::string> keys_ IPLR_GUARDED_BY(mutex_);
+
+  PipelineUsageProfile(const PipelineUsageProfile&) = delete;
+
+  PipelineUsageProfile& operator=(const PipelineUsageProfile&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_USAGE_PROFILE_H_
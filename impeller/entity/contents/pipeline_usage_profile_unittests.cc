@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "flutter/fml/mapping.h"
+#include "flutter/testing/testing.h"
+#include "impeller/entity/contents/pipeline_usage_profile.h"
+
+namespace impeller {
+namespace testing {
+
+static const ContentContextOptions kOptions = {
+    .sample_count = SampleCount::kCount4,
+    .blend_mode = BlendMode::kModulate,
+    .stencil_mode = ContentContextOptions::StencilMode::kCoverCompare,
+    .primitive_type = PrimitiveType::kTriangleStrip,
+    .color_attachment_pixel_format = PixelFormat::kB8G8R8A8UNormInt,
+    .depth_write_enabled = true,
+};
+
+TEST(PipelineUsageProfileTest, RecordsEachVariantOnce) {
+  PipelineUsageProfile profile;
+  EXPECT_TRUE(profile.Record("SolidFill Pipeline", kOptions));
+  EXPECT_FALSE(profile.Record("SolidFill Pipeline", kOptions));
+  EXPECT_TRUE(profile.Record("Texture Pipeline", kOptions));
+  EXPECT_TRUE(profile.Record("SolidFill Pipeline", ContentContextOptions{}));
+  EXPECT_EQ(profile.GetEntryCount(), 3u);
+}
+
+TEST(PipelineUsageProfileTest, CanRoundTripThroughSerialization) {
+  PipelineUsageProfile profile;
+  profile.Record("AdvancedBlend Pipeline 3 1", kOptions);
+  profile.Record("SolidFill Pipeline", ContentContextOptions{});
+
+  PipelineUsageProfile loaded;
+  ASSERT_TRUE(loaded.Load(*profile.Serialize()));
+
+  std::vector<PipelineUsageProfile::Entry> entries = loaded.GetEntries();
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries[0].pipeline_name, "AdvancedBlend Pipeline 3 1");
+  EXPECT_TRUE(ContentContextOptions::Equal{}(entries[0].options, kOptions));
+  EXPECT_EQ(entries[1].pipeline_name, "SolidFill Pipeline");
+  EXPECT_TRUE(ContentContextOptions::Equal{}(entries[1].options,
+                                             ContentContextOptions{}));
+}
+
+TEST(PipelineUsageProfileTest, RejectsProfilesOfOtherVersions) {
+  PipelineUsageProfile profile;
+  profile.Record("SolidFill Pipeline", kOptions);
+
+  fml::DataMapping mapping(
+      std::string("impeller-pipeline-usage-profile 0\n"
+                  "4 3 1 0 0 6 1 0 0 SolidFill Pipeline\n"));
+  EXPECT_FALSE(profile.Load(mapping));
+  EXPECT_EQ(profile.GetEntryCount(), 0u);
+}
+
+TEST(PipelineUsageProfileTest, SkipsMalformedEntries) {
+  fml::DataMapping mapping(
+      std::string("impeller-pipeline-usage-profile 1\n"
+                  "4 3 1 0 0 6 1 0 0 SolidFill Pipeline\n"
+                  // Sample count.
+                  "2 3 1 0 0 6 1 0 0 SolidFill Pipeline\n"
+                  // Advanced blend modes are not pipeline blend modes.
+                  "4 20 1 0 0 6 1 0 0 SolidFill Pipeline\n"
+                  // Pixel format.
+                  "4 3 1 0 0 200 1 0 0 SolidFill Pipeline\n"
+                  // Missing name.
+                  "4 3 1 0 0 6 1 0 0\n"
+                  // Truncated.
+                  "4 3 1\n"
+                  "garbage\n"
+                  "1 3 1 0 1 6 1 0 0 Texture Pipeline\n"));
+  PipelineUsageProfile profile;
+  ASSERT_TRUE(profile.Load(mapping));
+
+  std::vector<PipelineUsageProfile::Entry> entries = profile.GetEntries();
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries[0].pipeline_name, "SolidFill Pipeline");
+  EXPECT_EQ(entries[0].options.blend_mode, BlendMode::kSourceOver);
+  EXPECT_EQ(entries[1].pipeline_name, "Texture Pipeline");
+  EXPECT_EQ(entries[1].options.sample_count, SampleCount::kCount1);
+  EXPECT_EQ(entries[1].options.primitive_type, PrimitiveType::kTriangleStrip);
+}
+
+TEST(PipelineUsageProfileTest, StopsRecordingWhenFull) {
+  PipelineUsageProfile profile;
+  for (size_t i = 0; i < PipelineUsageProfile::kMaxEntries; i++) {
+    ASSERT_TRUE(profile.Record(std::to_string(i), kOptions));
+  }
+  EXPECT_FALSE(profile.Record("SolidFill Pipeline", kOptions));
+  EXPECT_EQ(profile.GetEntryCount(), PipelineUsageProfile::kMaxEntries);
+}
+
+}  // namespace testing
+}  // namespace impeller
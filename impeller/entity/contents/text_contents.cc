@@ -7,6 +7,7 @@
 #include <cstring>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "impeller/core/buffer_view.h"
 #include "impeller/core/formats.h"
@@ -109,10 +110,8 @@ bool TextContents::Render(const ContentContext& renderer,
   }
 
   // Information shared by all glyph draw calls.
-  pass.SetCommandLabel("TextFrame");
   auto opts = OptionsFromPassAndEntity(pass, entity);
   opts.primitive_type = PrimitiveType::kTriangle;
-  pass.SetPipeline(renderer.GetGlyphAtlasPipeline(opts));
 
   using VS = GlyphAtlasPipeline::VertexShader;
   using FS = GlyphAtlasPipeline::FragmentShader;
@@ -121,21 +120,20 @@ bool TextContents::Render(const ContentContext& renderer,
   VS::FrameInfo frame_info;
   frame_info.mvp =
       Entity::GetShaderTransform(entity.GetShaderClipDepth(), pass, Matrix());
-  ISize atlas_size = atlas->GetTexture()->GetSize();
   bool is_translation_scale = entity.GetTransform().IsTranslationScaleOnly();
   Matrix entity_transform = entity.GetTransform();
   Matrix basis_transform = entity_transform.Basis();
 
-  VS::BindFrameInfo(pass,
-                    renderer.GetTransientsBuffer().EmplaceUniform(frame_info));
+  BufferView frame_info_view =
+      renderer.GetTransientsBuffer().EmplaceUniform(frame_info);
 
   FS::FragInfo frag_info;
   frag_info.use_text_color = force_text_color_ ? 1.0 : 0.0;
   frag_info.text_color = ToVector(color.Premultiply());
   frag_info.is_color_glyph = type == GlyphAtlas::Type::kColorBitmap;
 
-  FS::BindFragInfo(pass,
-                   renderer.GetTransientsBuffer().EmplaceUniform(frag_info));
+  BufferView frag_info_view =
+      renderer.GetTransientsBuffer().EmplaceUniform(frag_info);
 
   SamplerDescriptor sampler_desc;
   if (is_translation_scale) {
@@ -154,12 +152,8 @@ bool TextContents::Render(const ContentContext& renderer,
   // No mipmaps for glyph atlas (glyphs are generated at exact scales).
   sampler_desc.mip_filter = MipFilter::kBase;
 
-  FS::BindGlyphAtlasSampler(
-      pass,                 // command
-      atlas->GetTexture(),  // texture
-      renderer.GetContext()->GetSamplerLibrary()->GetSampler(
-          sampler_desc)  // sampler
-  );
+  const std::unique_ptr<const Sampler>& sampler =
+      renderer.GetContext()->GetSamplerLibrary()->GetSampler(sampler_desc);
 
   // Common vertex information for all glyphs.
   // All glyphs are given the same vertex information in the form of a
@@ -172,20 +166,57 @@ bool TextContents::Render(const ContentContext& renderer,
                                                 Point{0, 1}, Point{1, 0},
                                                 Point{0, 1}, Point{1, 1}};
 
-  auto& host_buffer = renderer.GetTransientsBuffer();
+  // The vertices of the glyphs are grouped by the atlas page that holds them,
+  // so that each page is drawn with a single texture binding.
+  const size_t page_count = atlas->GetPageCount();
+  std::vector<ISize> page_sizes(page_count);
+  for (size_t page = 0; page < page_count; page++) {
+    page_sizes[page] = atlas->GetTexture(page)->GetSize();
+  }
+  std::vector<size_t> page_vertex_counts(page_count, 0u);
+  if (page_count == 1u) {
+    size_t vertex_count = 0;
+    for (const auto& run : frame_->GetRuns()) {
+      vertex_count += run.GetGlyphPositions().size();
+    }
+    page_vertex_counts[0] = vertex_count * 6;
+  } else {
+    for (const TextRun& run : frame_->GetRuns()) {
+      const Font& font = run.GetFont();
+      Scalar rounded_scale = TextFrame::RoundScaledFontSize(
+          scale_, font.GetMetrics().point_size);
+      const FontGlyphAtlas* font_atlas =
+          atlas->GetFontGlyphAtlas(font, rounded_scale);
+      if (!font_atlas) {
+        continue;
+      }
+      for (const TextRun::GlyphPosition& glyph_position :
+           run.GetGlyphPositions()) {
+        Point subpixel = TextFrame::ComputeSubpixelPosition(
+            glyph_position, font.GetAxisAlignment(), offset_, scale_);
+        const GlyphAtlasLocation* location = font_atlas->FindGlyphLocation(
+            SubpixelGlyph{glyph_position.glyph, subpixel, properties_});
+        if (location) {
+          page_vertex_counts[location->page] += 6;
+        }
+      }
+    }
+  }
+  std::vector<size_t> page_offsets(page_count, 0u);
   size_t vertex_count = 0;
-  for (const auto& run : frame_->GetRuns()) {
-    vertex_count += run.GetGlyphPositions().size();
+  for (size_t page = 0; page < page_count; page++) {
+    page_offsets[page] = vertex_count;
+    vertex_count += page_vertex_counts[page];
   }
-  vertex_count *= 6;
 
+  auto& host_buffer = renderer.GetTransientsBuffer();
   BufferView buffer_view = host_buffer.Emplace(
       vertex_count * sizeof(VS::PerVertexData), alignof(VS::PerVertexData),
       [&](uint8_t* contents) {
         VS::PerVertexData vtx;
         VS::PerVertexData* vtx_contents =
             reinterpret_cast<VS::PerVertexData*>(contents);
-        size_t i = 0u;
+        std::vector<size_t> page_cursors = page_offsets;
         for (const TextRun& run : frame_->GetRuns()) {
           const Font& font = run.GetFont();
           Scalar rounded_scale = TextFrame::RoundScaledFontSize(
@@ -221,16 +252,15 @@ bool TextContents::Render(const ContentContext& renderer,
             // Note: uses unrounded scale for more accurate subpixel position.
             Point subpixel = TextFrame::ComputeSubpixelPosition(
                 glyph_position, font.GetAxisAlignment(), offset_, scale_);
-            std::optional<std::pair<Rect, Rect>> maybe_atlas_glyph_bounds =
-                font_atlas->FindGlyphBounds(
-                    SubpixelGlyph{glyph_position.glyph, subpixel, properties_});
-            if (!maybe_atlas_glyph_bounds.has_value()) {
+            const GlyphAtlasLocation* location = font_atlas->FindGlyphLocation(
+                SubpixelGlyph{glyph_position.glyph, subpixel, properties_});
+            if (!location) {
               VALIDATION_LOG << "Could not find glyph position in the atlas.";
               continue;
             }
-            const Rect& atlas_glyph_bounds =
-                maybe_atlas_glyph_bounds.value().first;
-            Rect glyph_bounds = maybe_atlas_glyph_bounds.value().second;
+            const Rect& atlas_glyph_bounds = location->position;
+            const ISize& atlas_size = page_sizes[location->page];
+            Rect glyph_bounds = location->bounds;
             Rect scaled_bounds = glyph_bounds.Scale(1.0 / rounded_scale);
             // For each glyph, we compute two rectangles. One for the vertex
             // positions and one for the texture coordinates (UVs). The atlas
@@ -251,6 +281,7 @@ bool TextContents::Render(const ContentContext& renderer,
                 (screen_offset + unrounded_glyph_position + subpixel_adjustment)
                     .Floor();
 
+            size_t& i = page_cursors[location->page];
             for (const Point& point : unit_points) {
               Point position;
               if (is_translation_scale) {
@@ -268,16 +299,37 @@ bool TextContents::Render(const ContentContext& renderer,
             }
           }
         }
-      });
-
-  pass.SetVertexBuffer({
-      .vertex_buffer = std::move(buffer_view),
-      .index_buffer = {},
-      .vertex_count = vertex_count,
-      .index_type = IndexType::kNone,
-  });
-
-  return pass.Draw().ok();
+      },
+      HostBuffer::DataKind::kVertex);
+
+  for (size_t page = 0; page < page_count; page++) {
+    if (page_vertex_counts[page] == 0) {
+      continue;
+    }
+    pass.SetCommandLabel("TextFrame");
+    pass.SetPipeline(renderer.GetGlyphAtlasPipeline(opts));
+    VS::BindFrameInfo(pass, frame_info_view);
+    FS::BindFragInfo(pass, frag_info_view);
+    FS::BindGlyphAtlasSampler(pass,                     // command
+                              atlas->GetTexture(page),  // texture
+                              sampler                   // sampler
+    );
+    pass.SetVertexBuffer({
+        .vertex_buffer =
+            BufferView{
+                buffer_view.buffer,
+                Range(buffer_view.range.offset +
+                          page_offsets[page] * sizeof(VS::PerVertexData),
+                      page_vertex_counts[page] * sizeof(VS::PerVertexData))},
+        .index_buffer = {},
+        .vertex_count = page_vertex_counts[page],
+        .index_type = IndexType::kNone,
+    });
+    if (!pass.Draw().ok()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 }  // namespace impeller
@@ -4,14 +4,18 @@
 
 #include "impeller/entity/entity_pass.h"
 
+#include <atomic>
 #include <limits>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
+#include "impeller/base/parallel_for_each.h"
 #include "impeller/base/strings.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
@@ -594,132 +598,278 @@ EntityPass::EntityResult EntityPass::GetEntityForElement(
       pass_context.EndPass();
     }
 
-    if (!clip_coverage_stack.HasCoverage()) {
-      // The current clip is empty. This means the pass texture won't be
-      // visible, so skip it.
-      return EntityPass::EntityResult::Skip();
-    }
-    auto clip_coverage_back = clip_coverage_stack.CurrentClipCoverage();
-    if (!clip_coverage_back.has_value()) {
-      return EntityPass::EntityResult::Skip();
+    OffscreenSubpass offscreen;
+    offscreen.subpass = subpass;
+    offscreen.backdrop_filter_contents =
+        std::move(subpass_backdrop_filter_contents);
+    EntityResult::Status status = PrepareOffscreenSubpass(
+        renderer, pass_context, root_pass_size, global_pass_position,
+        clip_coverage_stack, offscreen);
+    if (status != EntityResult::kSuccess) {
+      return {{}, status};
     }
 
-    // The maximum coverage of the subpass. Subpasses textures should never
-    // extend outside the parent pass texture or the current clip coverage.
-    auto coverage_limit = Rect::MakeOriginSize(global_pass_position,
-                                               Size(pass_context.GetPassTarget()
-                                                        .GetRenderTarget()
-                                                        .GetRenderTargetSize()))
-                              .Intersection(clip_coverage_back.value());
-    if (!coverage_limit.has_value()) {
-      return EntityPass::EntityResult::Skip();
+    if (!RecordOffscreenSubpass(renderer,              // renderer
+                                root_pass_size,        // root_pass_size
+                                global_pass_position,  // global_pass_position
+                                pass_depth + 1,        // pass_depth
+                                clip_coverage_stack,   // clip_coverage_stack
+                                offscreen)) {
+      // Validation error messages are triggered for all `OnRender()` failure
+      // cases.
+      return EntityPass::EntityResult::Failure();
     }
 
-    coverage_limit =
-        coverage_limit->Intersection(Rect::MakeSize(root_pass_size));
-    if (!coverage_limit.has_value()) {
-      return EntityPass::EntityResult::Skip();
-    }
+    return FinishOffscreenSubpass(offscreen, global_pass_position);
+  }
+  FML_UNREACHABLE();
+}
 
-    auto subpass_coverage =
-        (subpass->flood_clip_ || subpass_backdrop_filter_contents)
-            ? coverage_limit
-            : GetSubpassCoverage(*subpass, coverage_limit);
-    if (!subpass_coverage.has_value()) {
-      return EntityPass::EntityResult::Skip();
-    }
+bool EntityPass::CanRecordConcurrently(const Element& element) {
+  const auto* subpass_ptr = std::get_if<std::unique_ptr<EntityPass>>(&element);
+  if (!subpass_ptr) {
+    return false;
+  }
+  EntityPass* subpass = subpass_ptr->get();
+  // Backdrop filters read from the parent pass texture, so they depend on
+  // everything rendered to the parent pass before them.
+  return !subpass->backdrop_filter_proc_ && !subpass->delegate_->CanElide() &&
+         !subpass->delegate_->CanCollapseIntoParentPass(subpass);
+}
 
-    auto subpass_size = ISize(subpass_coverage->GetSize());
-    if (subpass_size.IsEmpty()) {
-      return EntityPass::EntityResult::Skip();
-    }
+EntityPass::EntityResult::Status EntityPass::PrepareOffscreenSubpass(
+    ContentContext& renderer,
+    InlinePassContext& pass_context,
+    ISize root_pass_size,
+    Point global_pass_position,
+    const EntityPassClipStack& clip_coverage_stack,
+    OffscreenSubpass& offscreen) const {
+  const EntityPass* subpass = offscreen.subpass;
+  if (!clip_coverage_stack.HasCoverage()) {
+    // The current clip is empty. This means the pass texture won't be
+    // visible, so skip it.
+    return EntityResult::kSkip;
+  }
+  auto clip_coverage_back = clip_coverage_stack.CurrentClipCoverage();
+  if (!clip_coverage_back.has_value()) {
+    return EntityResult::kSkip;
+  }
 
-    auto subpass_target = CreateRenderTarget(
-        renderer,      // renderer
-        subpass_size,  // size
-        subpass->GetRequiredMipCount(),
-        subpass->GetClearColorOrDefault(subpass_size));  // clear_color
+  // The maximum coverage of the subpass. Subpasses textures should never
+  // extend outside the parent pass texture or the current clip coverage.
+  auto coverage_limit = Rect::MakeOriginSize(global_pass_position,
+                                             Size(pass_context.GetPassTarget()
+                                                      .GetRenderTarget()
+                                                      .GetRenderTargetSize()))
+                            .Intersection(clip_coverage_back.value());
+  if (!coverage_limit.has_value()) {
+    return EntityResult::kSkip;
+  }
 
-    if (!subpass_target.IsValid()) {
-      VALIDATION_LOG << "Subpass render target is invalid.";
-      return EntityPass::EntityResult::Failure();
-    }
+  coverage_limit = coverage_limit->Intersection(Rect::MakeSize(root_pass_size));
+  if (!coverage_limit.has_value()) {
+    return EntityResult::kSkip;
+  }
 
-    // Start non-collapsed subpasses with a fresh clip coverage stack limited by
-    // the subpass coverage. This is important because image filters applied to
-    // save layers may transform the subpass texture after it's rendered,
-    // causing parent clip coverage to get misaligned with the actual area that
-    // the subpass will affect in the parent pass.
-    clip_coverage_stack.PushSubpass(subpass_coverage, subpass->clip_height_);
-
-    // Stencil textures aren't shared between EntityPasses (as much of the
-    // time they are transient).
-    if (!subpass->OnRender(
-            renderer,                       // renderer
-            root_pass_size,                 // root_pass_size
-            subpass_target,                 // pass_target
-            subpass_coverage->GetOrigin(),  // global_pass_position
-            subpass_coverage->GetOrigin() -
-                global_pass_position,         // local_pass_position
-            ++pass_depth,                     // pass_depth
-            clip_coverage_stack,              // clip_coverage_stack
-            subpass->clip_height_,            // clip_height_floor
-            subpass_backdrop_filter_contents  // backdrop_filter_contents
-            )) {
-      // Validation error messages are triggered for all `OnRender()` failure
-      // cases.
-      return EntityPass::EntityResult::Failure();
-    }
+  auto subpass_coverage =
+      (subpass->flood_clip_ || offscreen.backdrop_filter_contents)
+          ? coverage_limit
+          : GetSubpassCoverage(*subpass, coverage_limit);
+  if (!subpass_coverage.has_value()) {
+    return EntityResult::kSkip;
+  }
 
-    clip_coverage_stack.PopSubpass();
+  auto subpass_size = ISize(subpass_coverage->GetSize());
+  if (subpass_size.IsEmpty()) {
+    return EntityResult::kSkip;
+  }
 
-    // The subpass target's texture may have changed during OnRender.
-    auto subpass_texture =
-        subpass_target.GetRenderTarget().GetRenderTargetTexture();
+  auto subpass_target = CreateRenderTarget(
+      renderer,      // renderer
+      subpass_size,  // size
+      subpass->GetRequiredMipCount(),
+      subpass->GetClearColorOrDefault(subpass_size));  // clear_color
 
-    auto offscreen_texture_contents =
-        subpass->delegate_->CreateContentsForSubpassTarget(
-            subpass_texture,
-            Matrix::MakeTranslation(Vector3{-global_pass_position}) *
-                subpass->transform_);
+  if (!subpass_target.IsValid()) {
+    VALIDATION_LOG << "Subpass render target is invalid.";
+    return EntityResult::kFailure;
+  }
 
-    if (!offscreen_texture_contents) {
-      // This is an error because the subpass delegate said the pass couldn't
-      // be collapsed into its parent. Yet, when asked how it want's to
-      // postprocess the offscreen texture, it couldn't give us an answer.
-      //
-      // Theoretically, we could collapse the pass now. But that would be
-      // wasteful as we already have the offscreen texture and we don't want
-      // to discard it without ever using it. Just make the delegate do the
-      // right thing.
-      return EntityPass::EntityResult::Failure();
-    }
+  offscreen.target.emplace(std::move(subpass_target));
+  offscreen.coverage = subpass_coverage.value();
+  return EntityResult::kSuccess;
+}
 
-    // Round the subpass texture position for pixel alignment with the parent
-    // pass render target. By default, we draw subpass textures with nearest
-    // sampling, so aligning here is important for avoiding visual nearest
-    // sampling errors caused by limited floating point precision when
-    // straddling a half pixel boundary.
-    //
-    // We do this in lieu of expanding/rounding out the subpass coverage in
-    // order to keep the bounds wrapping consistently tight around subpass
-    // elements. Which is necessary to avoid intense flickering in cases
-    // where a subpass texture has a large blur filter with clamp sampling.
+bool EntityPass::RecordOffscreenSubpass(
+    ContentContext& renderer,
+    ISize root_pass_size,
+    Point global_pass_position,
+    uint32_t pass_depth,
+    EntityPassClipStack& clip_coverage_stack,
+    const OffscreenSubpass& offscreen) const {
+  const EntityPass* subpass = offscreen.subpass;
+
+  // Start non-collapsed subpasses with a fresh clip coverage stack limited by
+  // the subpass coverage. This is important because image filters applied to
+  // save layers may transform the subpass texture after it's rendered,
+  // causing parent clip coverage to get misaligned with the actual area that
+  // the subpass will affect in the parent pass.
+  clip_coverage_stack.PushSubpass(offscreen.coverage, subpass->clip_height_);
+
+  // Stencil textures aren't shared between EntityPasses (as much of the
+  // time they are transient).
+  if (!subpass->OnRender(
+          renderer,                        // renderer
+          root_pass_size,                  // root_pass_size
+          *offscreen.target,               // pass_target
+          offscreen.coverage.GetOrigin(),  // global_pass_position
+          offscreen.coverage.GetOrigin() -
+              global_pass_position,           // local_pass_position
+          pass_depth,                         // pass_depth
+          clip_coverage_stack,                // clip_coverage_stack
+          subpass->clip_height_,              // clip_height_floor
+          offscreen.backdrop_filter_contents  // backdrop_filter_contents
+          )) {
+    return false;
+  }
+
+  clip_coverage_stack.PopSubpass();
+  return true;
+}
+
+EntityPass::EntityResult EntityPass::FinishOffscreenSubpass(
+    const OffscreenSubpass& offscreen,
+    Point global_pass_position) const {
+  const EntityPass* subpass = offscreen.subpass;
+
+  // The subpass target's texture may have changed during OnRender.
+  auto subpass_texture =
+      offscreen.target->GetRenderTarget().GetRenderTargetTexture();
+
+  auto offscreen_texture_contents =
+      subpass->delegate_->CreateContentsForSubpassTarget(
+          subpass_texture,
+          Matrix::MakeTranslation(Vector3{-global_pass_position}) *
+              subpass->transform_);
+
+  if (!offscreen_texture_contents) {
+    // This is an error because the subpass delegate said the pass couldn't
+    // be collapsed into its parent. Yet, when asked how it want's to
+    // postprocess the offscreen texture, it couldn't give us an answer.
     //
-    // See also this bug: https://github.com/flutter/flutter/issues/144213
-    Point subpass_texture_position =
-        (subpass_coverage->GetOrigin() - global_pass_position).Round();
+    // Theoretically, we could collapse the pass now. But that would be
+    // wasteful as we already have the offscreen texture and we don't want
+    // to discard it without ever using it. Just make the delegate do the
+    // right thing.
+    return EntityPass::EntityResult::Failure();
+  }
 
-    Entity element_entity;
-    element_entity.SetClipDepth(subpass->clip_depth_);
-    element_entity.SetContents(std::move(offscreen_texture_contents));
-    element_entity.SetBlendMode(subpass->blend_mode_);
-    element_entity.SetTransform(
-        Matrix::MakeTranslation(Vector3(subpass_texture_position)));
+  // Round the subpass texture position for pixel alignment with the parent
+  // pass render target. By default, we draw subpass textures with nearest
+  // sampling, so aligning here is important for avoiding visual nearest
+  // sampling errors caused by limited floating point precision when
+  // straddling a half pixel boundary.
+  //
+  // We do this in lieu of expanding/rounding out the subpass coverage in
+  // order to keep the bounds wrapping consistently tight around subpass
+  // elements. Which is necessary to avoid intense flickering in cases
+  // where a subpass texture has a large blur filter with clamp sampling.
+  //
+  // See also this bug: https://github.com/flutter/flutter/issues/144213
+  Point subpass_texture_position =
+      (offscreen.coverage.GetOrigin() - global_pass_position).Round();
+
+  Entity element_entity;
+  element_entity.SetClipDepth(subpass->clip_depth_);
+  element_entity.SetContents(std::move(offscreen_texture_contents));
+  element_entity.SetBlendMode(subpass->blend_mode_);
+  element_entity.SetTransform(
+      Matrix::MakeTranslation(Vector3(subpass_texture_position)));
+
+  return EntityPass::EntityResult::Success(std::move(element_entity));
+}
 
-    return EntityPass::EntityResult::Success(std::move(element_entity));
+bool EntityPass::RenderSubpassesConcurrently(
+    size_t begin,
+    size_t end,
+    ContentContext& renderer,
+    InlinePassContext& pass_context,
+    ISize root_pass_size,
+    Point global_pass_position,
+    uint32_t pass_depth,
+    EntityPassClipStack& clip_coverage_stack,
+    size_t clip_height_floor) const {
+  TRACE_EVENT0("impeller", "EntityPass::RenderSubpassesConcurrently");
+
+  // Sibling subpasses don't change the clip state of this pass, so all of
+  // their targets can be set up before any of them is rendered.
+  std::vector<OffscreenSubpass> offscreens;
+  offscreens.reserve(end - begin);
+  for (size_t i = begin; i < end; i++) {
+    OffscreenSubpass offscreen;
+    offscreen.subpass =
+        std::get<std::unique_ptr<EntityPass>>(elements_[i]).get();
+    switch (PrepareOffscreenSubpass(renderer, pass_context, root_pass_size,
+                                    global_pass_position, clip_coverage_stack,
+                                    offscreen)) {
+      case EntityResult::kSuccess:
+        offscreens.push_back(std::move(offscreen));
+        break;
+      case EntityResult::kFailure:
+        return false;
+      case EntityResult::kSkip:
+        break;
+    }
   }
-  FML_UNREACHABLE();
+
+  // Each subpass records and submits its own command buffers, and only
+  // touches its own render target and clip stack. Workers use transient
+  // buffers of their own and release their command pools once they are done.
+  std::atomic_bool success = true;
+  const std::thread::id calling_thread = std::this_thread::get_id();
+  ParallelForEach(
+      renderer.GetWorkerTaskRunner(), offscreens.size(), [&](size_t index) {
+        const OffscreenSubpass& offscreen = offscreens[index];
+        EntityPassClipStack clip_stack(offscreen.coverage);
+        bool recorded = false;
+        if (std::this_thread::get_id() == calling_thread) {
+          recorded = RecordOffscreenSubpass(renderer, root_pass_size,
+                                            global_pass_position,
+                                            pass_depth + 1, clip_stack,
+                                            offscreen);
+        } else {
+          {
+            ContentContext::WorkerScope worker_scope(renderer);
+            recorded = RecordOffscreenSubpass(renderer, root_pass_size,
+                                              global_pass_position,
+                                              pass_depth + 1, clip_stack,
+                                              offscreen);
+          }
+          renderer.GetContext()->DisposeThreadLocalCachedResources();
+        }
+        if (!recorded) {
+          success = false;
+        }
+      });
+  if (!success) {
+    // Validation error messages are triggered for all `OnRender()` failure
+    // cases.
+    return false;
+  }
+
+  for (const OffscreenSubpass& offscreen : offscreens) {
+    EntityResult result =
+        FinishOffscreenSubpass(offscreen, global_pass_position);
+    if (result.status != EntityResult::kSuccess) {
+      return false;
+    }
+    if (!RenderElement(result.entity, clip_height_floor, pass_context,
+                       pass_depth, renderer, clip_coverage_stack,
+                       global_pass_position)) {
+      return false;
+    }
+  }
+  return true;
 }
 
 static void SetClipScissor(std::optional<Rect> clip_coverage,
@@ -745,6 +895,56 @@ bool EntityPass::RenderElement(Entity& element_entity,
                                ContentContext& renderer,
                                EntityPassClipStack& clip_coverage_stack,
                                Point global_pass_position) const {
+  //--------------------------------------------------------------------------
+  /// Setup advanced blends.
+  ///
+
+  if (element_entity.GetBlendMode() > Entity::kLastPipelineBlendMode) {
+    if (renderer.GetDeviceCapabilities().SupportsFramebufferFetch()) {
+      auto src_contents = element_entity.GetContents();
+      auto contents = std::make_shared<FramebufferBlendContents>();
+      contents->SetChildContents(src_contents);
+      contents->SetBlendMode(element_entity.GetBlendMode());
+      element_entity.SetContents(std::move(contents));
+      element_entity.SetBlendMode(BlendMode::kSource);
+    } else {
+      // End the active pass and flush the buffer before rendering "advanced"
+      // blends. Advanced blends work by binding the current render target
+      // texture as an input ("destination"), blending with a second texture
+      // input ("source"), writing the result to an intermediate texture, and
+      // finally copying the data from the intermediate texture back to the
+      // render target texture. And so all of the commands that have written
+      // to the render target texture so far need to execute before it's bound
+      // for blending (otherwise the blend pass will end up executing before
+      // all the previous commands in the active pass).
+
+      if (!pass_context.EndPass()) {
+        VALIDATION_LOG
+            << "Failed to end the current render pass in order to read from "
+               "the backdrop texture and apply an advanced blend.";
+        return false;
+      }
+
+      // Amend an advanced blend filter to the contents, attaching the pass
+      // texture.
+      auto texture = pass_context.GetTexture();
+      if (!texture) {
+        VALIDATION_LOG << "Failed to fetch the color texture in order to "
+                          "apply an advanced blend.";
+        return false;
+      }
+
+      FilterInput::Vector inputs = {
+          FilterInput::Make(texture, element_entity.GetTransform().Invert()),
+          FilterInput::Make(element_entity.GetContents())};
+      auto contents = ColorFilterContents::MakeBlend(
+          element_entity.GetBlendMode(), inputs);
+      contents->SetCoverageHint(element_entity.GetCoverage());
+      element_entity.SetContents(std::move(contents));
+      element_entity.SetBlendMode(BlendMode::kSource);
+    }
+  }
+
   auto result = pass_context.GetRenderPass(pass_depth);
   if (!result.pass) {
     // Failure to produce a render pass should be explained by specific errors
@@ -896,7 +1096,10 @@ bool EntityPass::OnRender(
                                     // Backdrop filters act as a entity before
                                     // everything and disrupt the optimization.
                                     !backdrop_filter_proc_;
-  for (const auto& element : elements_) {
+  const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner =
+      renderer.GetWorkerTaskRunner();
+  for (size_t index = 0; index < elements_.size(); index++) {
+    const Element& element = elements_[index];
     // Skip elements that are incorporated into the clear color.
     if (is_collapsing_clear_colors) {
       auto [entity_color, _] =
@@ -907,6 +1110,34 @@ bool EntityPass::OnRender(
       is_collapsing_clear_colors = false;
     }
 
+    //--------------------------------------------------------------------------
+    /// Record runs of independent sibling subpasses concurrently.
+    ///
+
+    if (worker_task_runner) {
+      size_t run_end = index;
+      while (run_end < elements_.size() &&
+             CanRecordConcurrently(elements_[run_end])) {
+        run_end++;
+      }
+      if (run_end - index > 1) {
+        if (!RenderSubpassesConcurrently(
+                index,                 // begin
+                run_end,               // end
+                renderer,              // renderer
+                pass_context,          // pass_context
+                root_pass_size,        // root_pass_size
+                global_pass_position,  // global_pass_position
+                pass_depth,            // pass_depth
+                clip_coverage_stack,   // clip_coverage_stack
+                clip_height_floor)) {  // clip_height_floor
+          return false;
+        }
+        index = run_end - 1;
+        continue;
+      }
+    }
+
     EntityResult result =
         GetEntityForElement(element,               // element
                             renderer,              // renderer
@@ -928,56 +1159,6 @@ bool EntityPass::OnRender(
         continue;
     };
 
-    //--------------------------------------------------------------------------
-    /// Setup advanced blends.
-    ///
-
-    if (result.entity.GetBlendMode() > Entity::kLastPipelineBlendMode) {
-      if (renderer.GetDeviceCapabilities().SupportsFramebufferFetch()) {
-        auto src_contents = result.entity.GetContents();
-        auto contents = std::make_shared<FramebufferBlendContents>();
-        contents->SetChildContents(src_contents);
-        contents->SetBlendMode(result.entity.GetBlendMode());
-        result.entity.SetContents(std::move(contents));
-        result.entity.SetBlendMode(BlendMode::kSource);
-      } else {
-        // End the active pass and flush the buffer before rendering "advanced"
-        // blends. Advanced blends work by binding the current render target
-        // texture as an input ("destination"), blending with a second texture
-        // input ("source"), writing the result to an intermediate texture, and
-        // finally copying the data from the intermediate texture back to the
-        // render target texture. And so all of the commands that have written
-        // to the render target texture so far need to execute before it's bound
-        // for blending (otherwise the blend pass will end up executing before
-        // all the previous commands in the active pass).
-
-        if (!pass_context.EndPass()) {
-          VALIDATION_LOG
-              << "Failed to end the current render pass in order to read from "
-                 "the backdrop texture and apply an advanced blend.";
-          return false;
-        }
-
-        // Amend an advanced blend filter to the contents, attaching the pass
-        // texture.
-        auto texture = pass_context.GetTexture();
-        if (!texture) {
-          VALIDATION_LOG << "Failed to fetch the color texture in order to "
-                            "apply an advanced blend.";
-          return false;
-        }
-
-        FilterInput::Vector inputs = {
-            FilterInput::Make(texture, result.entity.GetTransform().Invert()),
-            FilterInput::Make(result.entity.GetContents())};
-        auto contents = ColorFilterContents::MakeBlend(
-            result.entity.GetBlendMode(), inputs);
-        contents->SetCoverageHint(result.entity.GetCoverage());
-        result.entity.SetContents(std::move(contents));
-        result.entity.SetBlendMode(BlendMode::kSource);
-      }
-    }
-
     //--------------------------------------------------------------------------
     /// Render the Element.
     ///
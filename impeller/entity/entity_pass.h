@@ -226,6 +226,56 @@ class EntityPass {
     static EntityResult Skip() { return {{}, kSkip}; }
   };
 
+  /// An offscreen subpass whose render target was created but not yet
+  /// rendered to.
+  struct OffscreenSubpass {
+    const EntityPass* subpass = nullptr;
+    /// The target that the subpass is rendered to.
+    std::optional<EntityPassTarget> target;
+    /// The coverage of the subpass target in root pass space.
+    Rect coverage;
+    std::shared_ptr<Contents> backdrop_filter_contents;
+  };
+
+  /// Whether the element is a subpass that is rendered to an offscreen target
+  /// without depending on anything else in this pass, and so can be recorded
+  /// concurrently with its sibling subpasses.
+  static bool CanRecordConcurrently(const Element& element);
+
+  /// Compute the coverage of `offscreen.subpass` and create its render target.
+  EntityResult::Status PrepareOffscreenSubpass(
+      ContentContext& renderer,
+      InlinePassContext& pass_context,
+      ISize root_pass_size,
+      Point global_pass_position,
+      const EntityPassClipStack& clip_coverage_stack,
+      OffscreenSubpass& offscreen) const;
+
+  /// Render the elements of a prepared subpass to its target.
+  bool RecordOffscreenSubpass(ContentContext& renderer,
+                              ISize root_pass_size,
+                              Point global_pass_position,
+                              uint32_t pass_depth,
+                              EntityPassClipStack& clip_coverage_stack,
+                              const OffscreenSubpass& offscreen) const;
+
+  /// Create the entity that draws a recorded subpass into this pass.
+  EntityResult FinishOffscreenSubpass(const OffscreenSubpass& offscreen,
+                                      Point global_pass_position) const;
+
+  /// Record the subpasses in `[begin, end)`, which must all satisfy
+  /// `CanRecordConcurrently`, on the worker threads of the renderer, then
+  /// render their targets to this pass in order.
+  bool RenderSubpassesConcurrently(size_t begin,
+                                   size_t end,
+                                   ContentContext& renderer,
+                                   InlinePassContext& pass_context,
+                                   ISize root_pass_size,
+                                   Point global_pass_position,
+                                   uint32_t pass_depth,
+                                   EntityPassClipStack& clip_coverage_stack,
+                                   size_t clip_height_floor) const;
+
   bool RenderElement(Entity& element_entity,
                      size_t clip_height_floor,
                      InlinePassContext& pass_context,
@@ -59,7 +59,7 @@ bool EntityPlayground::OpenPlaygroundHere(Entity entity) {
     content_context->GetRenderTargetCache()->Start();
     bool result = entity.Render(*content_context, pass);
     content_context->GetRenderTargetCache()->End();
-    content_context->GetTransientsBuffer().Reset();
+    content_context->ResetTransientsBuffers();
     return result;
   };
   return Playground::OpenPlaygroundHere(callback);
@@ -83,7 +83,7 @@ bool EntityPlayground::OpenPlaygroundHere(EntityPlaygroundCallback callback) {
     content_context.GetRenderTargetCache()->Start();
     bool result = callback(content_context, pass);
     content_context.GetRenderTargetCache()->End();
-    content_context.GetTransientsBuffer().Reset();
+    content_context.ResetTransientsBuffers();
     return result;
   };
   return Playground::OpenPlaygroundHere(pass_callback);
@@ -5,11 +5,14 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "fml/logging.h"
 #include "gtest/gtest.h"
 #include "impeller/core/device_buffer.h"
@@ -25,6 +28,7 @@
 #include "impeller/entity/contents/filters/gaussian_blur_filter_contents.h"
 #include "impeller/entity/contents/filters/inputs/filter_input.h"
 #include "impeller/entity/contents/linear_gradient_contents.h"
+#include "impeller/entity/contents/pipeline_usage_profile.h"
 #include "impeller/entity/contents/radial_gradient_contents.h"
 #include "impeller/entity/contents/runtime_effect_contents.h"
 #include "impeller/entity/contents/solid_color_contents.h"
@@ -2417,6 +2421,170 @@ TEST_P(EntityTest, AdvancedBlendCoverageHintIsNotResetByEntityPass) {
       << "The ColorBurned texture wasn't allocated (100x100 scales up 2x)";
 }
 
+TEST_P(EntityTest, SiblingSubpassesRenderToTheirOwnTargets) {
+  class OffscreenPassDelegate final : public EntityPassDelegate {
+   public:
+    // |EntityPassDelegate|
+    bool CanElide() override { return false; }
+
+    // |EntityPassDelegate|
+    bool CanCollapseIntoParentPass(EntityPass* entity_pass) override {
+      return false;
+    }
+
+    // |EntityPassDelegate|
+    std::shared_ptr<Contents> CreateContentsForSubpassTarget(
+        std::shared_ptr<Texture> target,
+        const Matrix& transform) override {
+      Rect bounds = Rect::MakeSize(target->GetSize());
+      auto contents = TextureContents::MakeRect(bounds);
+      contents->SetTexture(std::move(target));
+      contents->SetSourceRect(bounds);
+      return contents;
+    }
+
+    // |EntityPassDelegate|
+    std::shared_ptr<FilterContents> WithImageFilter(
+        const FilterInput::Variant& input,
+        const Matrix& effect_transform) const override {
+      return nullptr;
+    }
+  };
+
+  // Records the threads that the subpass entities are rendered on.
+  class ThreadRecordingContents final : public Contents {
+   public:
+    ThreadRecordingContents(std::shared_ptr<Contents> contents,
+                            std::shared_ptr<std::vector<std::thread::id>> ids,
+                            std::shared_ptr<std::mutex> mutex)
+        : contents_(std::move(contents)),
+          ids_(std::move(ids)),
+          mutex_(std::move(mutex)) {}
+
+    // |Contents|
+    bool Render(const ContentContext& renderer,
+                const Entity& entity,
+                RenderPass& pass) const override {
+      {
+        std::scoped_lock lock(*mutex_);
+        ids_->push_back(std::this_thread::get_id());
+      }
+      return contents_->Render(renderer, entity, pass);
+    }
+
+    // |Contents|
+    std::optional<Rect> GetCoverage(const Entity& entity) const override {
+      return contents_->GetCoverage(entity);
+    }
+
+   private:
+    std::shared_ptr<Contents> contents_;
+    std::shared_ptr<std::vector<std::thread::id>> ids_;
+    std::shared_ptr<std::mutex> mutex_;
+  };
+
+  auto thread_ids = std::make_shared<std::vector<std::thread::id>>();
+  auto thread_ids_mutex = std::make_shared<std::mutex>();
+  auto make_pass = [&](Scalar size) {
+    auto pass = std::make_unique<EntityPass>();
+    Entity entity;
+    auto path =
+        PathBuilder{}.AddRect(Rect::MakeXYWH(10, 10, size, size)).TakePath();
+    entity.SetContents(std::make_shared<ThreadRecordingContents>(
+        SolidColorContents::Make(std::move(path), Color::Red()), thread_ids,
+        thread_ids_mutex));
+    pass->AddEntity(std::move(entity));
+    pass->SetDelegate(std::make_unique<OffscreenPassDelegate>());
+    return pass;
+  };
+
+  std::shared_ptr<RenderTargetCache> render_target_allocator =
+      std::make_shared<RenderTargetCache>(GetContext()->GetResourceAllocator());
+  auto rt = render_target_allocator->CreateOffscreen(
+      *GetContext(), ISize::MakeWH(500, 500), /*mip_count=*/1);
+  auto content_context = ContentContext(
+      GetContext(), TypographerContextSkia::Make(), render_target_allocator);
+
+  // The content context only creates workers for the backends that report
+  // SupportsConcurrentCommandRecording, so the test provides its own to cover
+  // the concurrent path on the other backends too. OpenGL ES contexts are
+  // bound to a single thread.
+  auto worker_loop = fml::ConcurrentMessageLoop::Create(2u);
+  std::vector<bool> worker_modes = {false};
+  if (GetBackend() != PlaygroundBackend::kOpenGLES) {
+    worker_modes.push_back(true);
+  }
+  for (bool use_workers : worker_modes) {
+    content_context.SetWorkerTaskRunner(
+        use_workers ? worker_loop->GetTaskRunner() : nullptr);
+    thread_ids->clear();
+    EntityPass pass;
+    for (int i = 1; i <= 4; i++) {
+      auto subpass = make_pass(i * 20);
+      // Nest a sibling pair in one of the subpasses.
+      if (i == 4) {
+        subpass->AddSubpass(make_pass(13));
+        subpass->AddSubpass(make_pass(17));
+      }
+      pass.AddSubpass(std::move(subpass));
+    }
+
+    EXPECT_TRUE(pass.Render(content_context, rt));
+    content_context.ResetTransientsBuffers();
+
+    // The calling thread also records subpasses, so with workers the
+    // subpasses may or may not be spread over several threads.
+    ASSERT_EQ(thread_ids->size(), 6u);
+    if (!use_workers) {
+      for (std::thread::id id : *thread_ids) {
+        EXPECT_EQ(id, std::this_thread::get_id());
+      }
+    }
+
+    for (ISize size : {ISize(20, 20), ISize(40, 40), ISize(60, 60),
+                       ISize(80, 80), ISize(13, 13), ISize(17, 17)}) {
+      EXPECT_NE(
+          std::find_if(render_target_allocator->GetRenderTargetDataBegin(),
+                       render_target_allocator->GetRenderTargetDataEnd(),
+                       [&size](const auto& data) {
+                         return data.config.size == size;
+                       }),
+          render_target_allocator->GetRenderTargetDataEnd())
+          << "No subpass texture of size " << size;
+    }
+  }
+  content_context.SetWorkerTaskRunner(nullptr);
+}
+
+TEST_P(EntityTest, WorkerScopeRoutesTransientsToThreadLocalInstances) {
+  auto content_context =
+      ContentContext(GetContext(), TypographerContextSkia::Make());
+  HostBuffer* raster_buffer = &content_context.GetTransientsBuffer();
+  std::shared_ptr<Tessellator> raster_tessellator =
+      content_context.GetTessellator();
+
+  HostBuffer* worker_buffer = nullptr;
+  std::shared_ptr<Tessellator> worker_tessellator;
+  std::thread([&]() {
+    ContentContext::WorkerScope scope(content_context);
+    worker_buffer = &content_context.GetTransientsBuffer();
+    worker_tessellator = content_context.GetTessellator();
+  }).join();
+  EXPECT_NE(worker_buffer, raster_buffer);
+  EXPECT_NE(worker_tessellator, raster_tessellator);
+
+  // Threads without a scope use the instances of the raster thread.
+  EXPECT_EQ(&content_context.GetTransientsBuffer(), raster_buffer);
+
+  // Instances are recycled once the scope that used them ends.
+  HostBuffer* recycled_buffer = nullptr;
+  std::thread([&]() {
+    ContentContext::WorkerScope scope(content_context);
+    recycled_buffer = &content_context.GetTransientsBuffer();
+  }).join();
+  EXPECT_EQ(recycled_buffer, worker_buffer);
+}
+
 TEST_P(EntityTest, SpecializationConstantsAreAppliedToVariants) {
   auto content_context = GetContentContext();
 
@@ -2474,6 +2642,40 @@ TEST_P(EntityTest, ContentContextOptionsHasReasonableHashFunctions) {
   EXPECT_NE(hash_c, hash_d);
 }
 
+TEST_P(EntityTest, ContentContextRecordsUsedPipelineVariants) {
+  auto content_context = GetContentContext();
+  ASSERT_TRUE(content_context->IsValid());
+
+  ContentContextOptions options{
+      .sample_count = SampleCount::kCount4,
+      .blend_mode = BlendMode::kModulate,
+      .stencil_mode =
+          ContentContextOptions::StencilMode::kOverdrawPreventionRestore,
+      .color_attachment_pixel_format =
+          GetContext()->GetCapabilities()->GetDefaultColorFormat()};
+
+  // The variant may have been precompiled from the profile of a previous run,
+  // in which case it doesn't stall.
+  uint64_t initial_stall_count =
+      content_context->GetPipelineVariantStallCount();
+  ASSERT_TRUE(content_context->GetSolidFillPipeline(options));
+  uint64_t stall_count = content_context->GetPipelineVariantStallCount();
+  EXPECT_LE(stall_count, initial_stall_count + 1u);
+
+  ASSERT_TRUE(content_context->GetSolidFillPipeline(options));
+  EXPECT_EQ(content_context->GetPipelineVariantStallCount(), stall_count);
+
+  std::vector<PipelineUsageProfile::Entry> entries =
+      content_context->GetPipelineUsageProfile().GetEntries();
+  auto found = std::find_if(
+      entries.begin(), entries.end(),
+      [&options](const PipelineUsageProfile::Entry& entry) {
+        return entry.pipeline_name == "SolidFill Pipeline" &&
+               ContentContextOptions::Equal{}(entry.options, options);
+      });
+  EXPECT_NE(found, entries.end());
+}
+
 #ifdef FML_OS_LINUX
 TEST_P(EntityTest, FramebufferFetchVulkanBindingOffsetIsTheSame) {
   // Using framebuffer fetch on Vulkan requires that we maintain a subpass input
@@ -45,7 +45,8 @@ GeometryResult Geometry::ComputePositionGeometry(
                     });
                     FML_DCHECK(vertices == reinterpret_cast<VT*>(buffer) +
                                                generator.GetVertexCount());
-                  }),
+                  },
+                  HostBuffer::DataKind::kVertex),
               .vertex_count = count,
               .index_type = IndexType::kNone,
           },
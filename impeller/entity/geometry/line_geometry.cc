@@ -87,14 +87,16 @@ GeometryResult LineGeometry::GetPositionBuffer(const ContentContext& renderer,
 
   size_t count = 4;
   BufferView vertex_buffer = host_buffer.Emplace(
-      count * sizeof(VT), alignof(VT), [&corners](uint8_t* buffer) {
+      count * sizeof(VT), alignof(VT),
+      [&corners](uint8_t* buffer) {
         auto vertices = reinterpret_cast<VT*>(buffer);
         for (auto& corner : corners) {
           *vertices++ = {
               .position = corner,
           };
         }
-      });
+      },
+      HostBuffer::DataKind::kVertex);
 
   return GeometryResult{
       .type = PrimitiveType::kTriangleStrip,
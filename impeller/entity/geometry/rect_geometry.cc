@@ -17,7 +17,8 @@ GeometryResult RectGeometry::GetPositionBuffer(const ContentContext& renderer,
       .vertex_buffer =
           {
               .vertex_buffer = host_buffer.Emplace(
-                  rect_.GetPoints().data(), 8 * sizeof(float), alignof(float)),
+                  rect_.GetPoints().data(), 8 * sizeof(float), alignof(float),
+                  HostBuffer::DataKind::kVertex),
               .vertex_count = 4,
               .index_type = IndexType::kNone,
           },
@@ -609,7 +609,8 @@ GeometryResult StrokePathGeometry::GetPositionBuffer(
       host_buffer.Emplace(position_writer.GetData().data(),
                           position_writer.GetData().size() *
                               sizeof(SolidFillVertexShader::PerVertexData),
-                          alignof(SolidFillVertexShader::PerVertexData));
+                          alignof(SolidFillVertexShader::PerVertexData),
+                          HostBuffer::DataKind::kVertex);
 
   return GeometryResult{
       .type = PrimitiveType::kTriangleStrip,
@@ -122,12 +122,13 @@ GeometryResult VerticesGeometry::GetPositionBuffer(
 
   auto vertex_buffer = renderer.GetTransientsBuffer().Emplace(
       reinterpret_cast<const uint8_t*>(vertices_.data()), total_vtx_bytes,
-      alignof(float));
+      alignof(float), HostBuffer::DataKind::kVertex);
 
   BufferView index_buffer = {};
   if (index_count) {
     index_buffer = renderer.GetTransientsBuffer().Emplace(
-        indices_.data(), total_idx_bytes, alignof(uint16_t));
+        indices_.data(), total_idx_bytes, alignof(uint16_t),
+        HostBuffer::DataKind::kIndex);
   }
 
   return GeometryResult{
@@ -175,14 +176,16 @@ GeometryResult VerticesGeometry::GetPositionUVColorBuffer(
           };
           std::memcpy(vtx_contents++, &vertex_data, sizeof(VS::PerVertexData));
         }
-      });
+      },
+      HostBuffer::DataKind::kVertex);
 
   BufferView index_buffer = {};
   auto index_count = indices_.size();
   size_t total_idx_bytes = index_count * sizeof(uint16_t);
   if (index_count > 0) {
     index_buffer = renderer.GetTransientsBuffer().Emplace(
-        indices_.data(), total_idx_bytes, alignof(uint16_t));
+        indices_.data(), total_idx_bytes, alignof(uint16_t),
+        HostBuffer::DataKind::kIndex);
   }
 
   return GeometryResult{
@@ -11,12 +11,14 @@ RenderTargetCache::RenderTargetCache(std::shared_ptr<Allocator> allocator)
     : RenderTargetAllocator(std::move(allocator)) {}
 
 void RenderTargetCache::Start() {
+  Lock lock(render_target_data_mutex_);
   for (auto& td : render_target_data_) {
     td.used_this_frame = false;
   }
 }
 
 void RenderTargetCache::End() {
+  Lock lock(render_target_data_mutex_);
   std::vector<RenderTargetData> retain;
 
   for (const auto& td : render_target_data_) {
@@ -48,19 +50,13 @@ RenderTarget RenderTargetCache::CreateOffscreen(
       .has_msaa = false,
       .has_depth_stencil = stencil_attachment_config.has_value(),
   };
-  for (auto& render_target_data : render_target_data_) {
-    const auto other_config = render_target_data.config;
-    if (!render_target_data.used_this_frame && other_config == config) {
-      render_target_data.used_this_frame = true;
-      auto color0 = render_target_data.render_target.GetColorAttachments()
-                        .find(0u)
-                        ->second;
-      auto depth = render_target_data.render_target.GetDepthAttachment();
-      std::shared_ptr<Texture> depth_tex = depth ? depth->texture : nullptr;
-      return RenderTargetAllocator::CreateOffscreen(
-          context, size, mip_count, label, color_attachment_config,
-          stencil_attachment_config, color0.texture, depth_tex);
-    }
+  if (std::optional<RenderTarget> cached = ClaimCachedRenderTarget(config)) {
+    auto color0 = cached->GetColorAttachments().find(0u)->second;
+    auto depth = cached->GetDepthAttachment();
+    std::shared_ptr<Texture> depth_tex = depth ? depth->texture : nullptr;
+    return RenderTargetAllocator::CreateOffscreen(
+        context, size, mip_count, label, color_attachment_config,
+        stencil_attachment_config, color0.texture, depth_tex);
   }
   RenderTarget created_target = RenderTargetAllocator::CreateOffscreen(
       context, size, mip_count, label, color_attachment_config,
@@ -68,10 +64,7 @@ RenderTarget RenderTargetCache::CreateOffscreen(
   if (!created_target.IsValid()) {
     return created_target;
   }
-  render_target_data_.push_back(
-      RenderTargetData{.used_this_frame = true,
-                       .config = config,
-                       .render_target = created_target});
+  AddCachedRenderTarget(config, created_target);
   return created_target;
 }
 
@@ -98,20 +91,14 @@ RenderTarget RenderTargetCache::CreateOffscreenMSAA(
       .has_msaa = true,
       .has_depth_stencil = stencil_attachment_config.has_value(),
   };
-  for (auto& render_target_data : render_target_data_) {
-    const auto other_config = render_target_data.config;
-    if (!render_target_data.used_this_frame && other_config == config) {
-      render_target_data.used_this_frame = true;
-      auto color0 = render_target_data.render_target.GetColorAttachments()
-                        .find(0u)
-                        ->second;
-      auto depth = render_target_data.render_target.GetDepthAttachment();
-      std::shared_ptr<Texture> depth_tex = depth ? depth->texture : nullptr;
-      return RenderTargetAllocator::CreateOffscreenMSAA(
-          context, size, mip_count, label, color_attachment_config,
-          stencil_attachment_config, color0.texture, color0.resolve_texture,
-          depth_tex);
-    }
+  if (std::optional<RenderTarget> cached = ClaimCachedRenderTarget(config)) {
+    auto color0 = cached->GetColorAttachments().find(0u)->second;
+    auto depth = cached->GetDepthAttachment();
+    std::shared_ptr<Texture> depth_tex = depth ? depth->texture : nullptr;
+    return RenderTargetAllocator::CreateOffscreenMSAA(
+        context, size, mip_count, label, color_attachment_config,
+        stencil_attachment_config, color0.texture, color0.resolve_texture,
+        depth_tex);
   }
   RenderTarget created_target = RenderTargetAllocator::CreateOffscreenMSAA(
       context, size, mip_count, label, color_attachment_config,
@@ -119,14 +106,35 @@ RenderTarget RenderTargetCache::CreateOffscreenMSAA(
   if (!created_target.IsValid()) {
     return created_target;
   }
+  AddCachedRenderTarget(config, created_target);
+  return created_target;
+}
+
+std::optional<RenderTarget> RenderTargetCache::ClaimCachedRenderTarget(
+    const RenderTargetConfig& config) {
+  Lock lock(render_target_data_mutex_);
+  for (auto& render_target_data : render_target_data_) {
+    if (!render_target_data.used_this_frame &&
+        render_target_data.config == config) {
+      render_target_data.used_this_frame = true;
+      return render_target_data.render_target;
+    }
+  }
+  return std::nullopt;
+}
+
+void RenderTargetCache::AddCachedRenderTarget(
+    const RenderTargetConfig& config,
+    const RenderTarget& render_target) {
+  Lock lock(render_target_data_mutex_);
   render_target_data_.push_back(
       RenderTargetData{.used_this_frame = true,
                        .config = config,
-                       .render_target = created_target});
-  return created_target;
+                       .render_target = render_target});
 }
 
 size_t RenderTargetCache::CachedTextureCount() const {
+  Lock lock(render_target_data_mutex_);
   return render_target_data_.size();
 }
 
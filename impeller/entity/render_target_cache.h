@@ -5,6 +5,9 @@
 #ifndef FLUTTER_IMPELLER_ENTITY_RENDER_TARGET_CACHE_H_
 #define FLUTTER_IMPELLER_ENTITY_RENDER_TARGET_CACHE_H_
 
+#include <optional>
+
+#include "impeller/base/thread.h"
 #include "impeller/renderer/render_target.h"
 
 namespace impeller {
@@ -13,6 +16,9 @@ namespace impeller {
 ///        allocated texture data for one frame.
 ///
 ///        Any textures unused after a frame are immediately discarded.
+///
+///        Render targets may be created from several threads at once while
+///        offscreen passes are recorded concurrently.
 class RenderTargetCache : public RenderTargetAllocator {
  public:
   explicit RenderTargetCache(std::shared_ptr<Allocator> allocator);
@@ -62,8 +68,19 @@ class RenderTargetCache : public RenderTargetAllocator {
     RenderTarget render_target;
   };
 
+  /// Guards |render_target_data_| during a frame. The testing accessors below
+  /// must not be used while a frame is in progress.
+  mutable Mutex render_target_data_mutex_;
   std::vector<RenderTargetData> render_target_data_;
 
+  /// Marks a cached render target with |config| as used and returns it, or
+  /// returns std::nullopt if none is available.
+  std::optional<RenderTarget> ClaimCachedRenderTarget(
+      const RenderTargetConfig& config);
+
+  void AddCachedRenderTarget(const RenderTargetConfig& config,
+                             const RenderTarget& render_target);
+
   RenderTargetCache(const RenderTargetCache&) = delete;
 
   RenderTargetCache& operator=(const RenderTargetCache&) = delete;
@@ -9,6 +9,7 @@
 #include "impeller/entity/geometry/stroke_path_geometry.h"
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/path_builder.h"
+#include "impeller/geometry/wangs_formula.h"
 #include "impeller/tessellator/tessellator_libtess.h"
 
 namespace impeller {
@@ -35,6 +36,20 @@ Path CreateCubic(bool closed);
 Path CreateQuadratic(bool closed);
 /// Create a rounded rect.
 Path CreateRRect();
+/// A line chart of many short, smooth cubic components.
+Path CreateChart();
+
+std::vector<CubicPathComponent> GetCubics(const Path& path) {
+  std::vector<CubicPathComponent> cubics;
+  path.EnumerateComponents(
+      [](size_t, const LinearPathComponent&) {},
+      [](size_t, const QuadraticPathComponent&) {},
+      [&cubics](size_t, const CubicPathComponent& cubic) {
+        cubics.push_back(cubic);
+      },
+      [](size_t, const ContourComponent&) {});
+  return cubics;
+}
 }  // namespace
 
 static TessellatorLibtess tess;
@@ -64,6 +79,60 @@ static void BM_Polyline(benchmark::State& state, Args&&... args) {
   state.counters["TotalPointCount"] = point_count;
 }
 
+/// Compares evaluating Wang's formula for one cubic at a time with evaluating
+/// it for batches of cubics.
+template <class... Args>
+static void BM_CubicSubdivisions(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple);
+  bool batched = std::get<bool>(args_tuple);
+
+  std::vector<CubicPathComponent> cubics = GetCubics(path);
+  std::vector<const CubicPathComponent*> cubic_ptrs;
+  for (const CubicPathComponent& cubic : cubics) {
+    cubic_ptrs.push_back(&cubic);
+  }
+  std::vector<Scalar> subdivisions(cubics.size());
+  while (state.KeepRunning()) {
+    if (batched) {
+      ComputeCubicSubdivisions(1.0f, cubic_ptrs.data(), cubic_ptrs.size(),
+                               subdivisions.data());
+    } else {
+      for (size_t i = 0; i < cubics.size(); i++) {
+        subdivisions[i] = ComputeCubicSubdivisions(1.0f, cubics[i]);
+      }
+    }
+    benchmark::DoNotOptimize(subdivisions.data());
+  }
+  state.counters["CurveCount"] = cubics.size();
+}
+
+/// Compares flattening cubics one point at a time with flattening them into a
+/// presized buffer four points at a time.
+template <class... Args>
+static void BM_CubicPolylinePoints(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple);
+  bool batched = std::get<bool>(args_tuple);
+
+  std::vector<CubicPathComponent> cubics = GetCubics(path);
+  std::vector<Point> points;
+  points.reserve(2048);
+  while (state.KeepRunning()) {
+    points.clear();
+    for (const CubicPathComponent& cubic : cubics) {
+      if (batched) {
+        cubic.AppendPolylinePoints(1.0f, points);
+      } else {
+        cubic.ToLinearPathComponents(
+            1.0f, [&points](const Point& point) { points.push_back(point); });
+      }
+    }
+    benchmark::DoNotOptimize(points.data());
+  }
+  state.counters["SinglePointCount"] = points.size();
+}
+
 template <class... Args>
 static void BM_StrokePolyline(benchmark::State& state, Args&&... args) {
   auto args_tuple = std::make_tuple(std::move(args)...);
@@ -135,6 +204,24 @@ BENCHMARK_CAPTURE(BM_Polyline, quad_polyline, CreateQuadratic(true));
 BENCHMARK_CAPTURE(BM_Polyline, unclosed_quad_polyline, CreateQuadratic(false));
 MAKE_STROKE_BENCHMARK_CAPTURE_ALL_CAPS_JOINS(Quadratic, false);
 
+BENCHMARK_CAPTURE(BM_Polyline, chart_polyline, CreateChart());
+BENCHMARK_CAPTURE(BM_CubicSubdivisions,
+                  chart_subdivisions_single,
+                  CreateChart(),
+                  false);
+BENCHMARK_CAPTURE(BM_CubicSubdivisions,
+                  chart_subdivisions_batched,
+                  CreateChart(),
+                  true);
+BENCHMARK_CAPTURE(BM_CubicPolylinePoints,
+                  chart_points_single,
+                  CreateChart(),
+                  false);
+BENCHMARK_CAPTURE(BM_CubicPolylinePoints,
+                  chart_points_batched,
+                  CreateChart(),
+                  true);
+
 BENCHMARK_CAPTURE(BM_Convex, rrect_convex, CreateRRect(), true);
 // A round rect has no ends so we don't need to try it with all cap values
 // but it does have joins and even though they should all be almost
@@ -151,6 +238,32 @@ Path CreateRRect() {
       .TakePath();
 }
 
+Path CreateChart() {
+  // A smooth curve through 1000 samples of a few summed sine waves, with
+  // control points along the tangents at the samples.
+  constexpr int kSampleCount = 1000;
+  constexpr Scalar kStep = 2.0f;
+  auto sample = [](Scalar x) {
+    return 200 + 80 * std::sin(x * 0.01f) + 30 * std::sin(x * 0.07f) +
+           10 * std::sin(x * 0.31f);
+  };
+  auto slope = [](Scalar x) {
+    return 0.8f * std::cos(x * 0.01f) + 2.1f * std::cos(x * 0.07f) +
+           3.1f * std::cos(x * 0.31f);
+  };
+  auto builder = PathBuilder{};
+  builder.MoveTo({0, sample(0)});
+  for (int i = 1; i < kSampleCount; i++) {
+    Scalar x0 = (i - 1) * kStep;
+    Scalar x1 = i * kStep;
+    Scalar third = kStep / 3;
+    builder.CubicCurveTo({x0 + third, sample(x0) + slope(x0) * third},
+                         {x1 - third, sample(x1) - slope(x1) * third},
+                         {x1, sample(x1)});
+  }
+  return builder.TakePath();
+}
+
 Path CreateCubic(bool closed) {
   auto builder = PathBuilder{};
   builder  //
@@ -10,6 +10,7 @@
 #include "flutter/fml/logging.h"
 #include "impeller/geometry/path_component.h"
 #include "impeller/geometry/point.h"
+#include "impeller/geometry/wangs_formula.h"
 
 namespace impeller {
 
@@ -345,38 +346,114 @@ Path::Polyline Path::CreatePolyline(
     }
   };
 
+  // The curves are split into line segments in a first pass, evaluating
+  // Wang's formula for batches of quadratics and cubics at once. That gives
+  // the number of points of every component, so the point buffer is sized once
+  // and the curves are flattened into it without reallocating.
+  constexpr size_t kCurveBatchSize = 16;
+  std::vector<Scalar> line_counts(path_components.size());
+  const QuadraticPathComponent* quads[kCurveBatchSize];
+  const CubicPathComponent* cubics[kCurveBatchSize];
+  size_t quad_indices[kCurveBatchSize];
+  size_t cubic_indices[kCurveBatchSize];
+  size_t quad_count = 0;
+  size_t cubic_count = 0;
+  auto flush_quads = [&]() {
+    Scalar subdivisions[kCurveBatchSize];
+    ComputeQuadradicSubdivisions(scale, quads, quad_count, subdivisions);
+    for (size_t i = 0; i < quad_count; i++) {
+      line_counts[quad_indices[i]] = std::ceilf(subdivisions[i]);
+    }
+    quad_count = 0;
+  };
+  auto flush_cubics = [&]() {
+    Scalar subdivisions[kCurveBatchSize];
+    ComputeCubicSubdivisions(scale, cubics, cubic_count, subdivisions);
+    for (size_t i = 0; i < cubic_count; i++) {
+      line_counts[cubic_indices[i]] = std::ceilf(subdivisions[i]);
+    }
+    cubic_count = 0;
+  };
   for (size_t component_i = 0; component_i < path_components.size();
        component_i++) {
     const auto& path_component = path_components[component_i];
-    switch (path_component.type) {
+    if (path_component.type == ComponentType::kQuadratic) {
+      quads[quad_count] = reinterpret_cast<const QuadraticPathComponent*>(
+          &path_points[path_component.index]);
+      quad_indices[quad_count++] = component_i;
+      if (quad_count == kCurveBatchSize) {
+        flush_quads();
+      }
+    } else if (path_component.type == ComponentType::kCubic) {
+      cubics[cubic_count] = reinterpret_cast<const CubicPathComponent*>(
+          &path_points[path_component.index]);
+      cubic_indices[cubic_count++] = component_i;
+      if (cubic_count == kCurveBatchSize) {
+        flush_cubics();
+      }
+    }
+  }
+  flush_quads();
+  flush_cubics();
+
+  // Every contour and line adds at most one point, which makes this exact
+  // unless lines repeat the previous point.
+  size_t point_count = polyline.points->size();
+  for (size_t component_i = 0; component_i < path_components.size();
+       component_i++) {
+    switch (path_components[component_i].type) {
       case ComponentType::kLinear:
+      case ComponentType::kContour:
+        point_count++;
+        break;
+      case ComponentType::kQuadratic:
+      case ComponentType::kCubic:
+        point_count += CountPolylinePoints(line_counts[component_i]);
+        break;
+    }
+  }
+  size_t point_index = polyline.points->size();
+  polyline.points->resize(point_count);
+  Point* points = polyline.points->data();
+
+  for (size_t component_i = 0; component_i < path_components.size();
+       component_i++) {
+    const auto& path_component = path_components[component_i];
+    switch (path_component.type) {
+      case ComponentType::kLinear: {
         poly_components.push_back({
-            .component_start_index = polyline.points->size() - 1,
+            .component_start_index = point_index - 1,
             .is_curve = false,
         });
-        reinterpret_cast<const LinearPathComponent*>(
-            &path_points[path_component.index])
-            ->AppendPolylinePoints(*polyline.points);
+        const Point& p2 = reinterpret_cast<const LinearPathComponent*>(
+                              &path_points[path_component.index])
+                              ->p2;
+        if (point_index == 0 || points[point_index - 1] != p2) {
+          points[point_index++] = p2;
+        }
         previous_path_component_index = component_i;
         break;
+      }
       case ComponentType::kQuadratic:
         poly_components.push_back({
-            .component_start_index = polyline.points->size() - 1,
+            .component_start_index = point_index - 1,
             .is_curve = true,
         });
-        reinterpret_cast<const QuadraticPathComponent*>(
-            &path_points[path_component.index])
-            ->AppendPolylinePoints(scale, *polyline.points);
+        point_index += reinterpret_cast<const QuadraticPathComponent*>(
+                           &path_points[path_component.index])
+                           ->WritePolylinePoints(line_counts[component_i],
+                                                 points + point_index);
         previous_path_component_index = component_i;
         break;
       case ComponentType::kCubic:
         poly_components.push_back({
-            .component_start_index = polyline.points->size() - 1,
+            .component_start_index = point_index - 1,
             .is_curve = true,
         });
-        reinterpret_cast<const CubicPathComponent*>(
-            &path_points[path_component.index])
-            ->AppendPolylinePoints(scale, *polyline.points);
+        point_index += reinterpret_cast<const CubicPathComponent*>(
+                           &path_points[path_component.index])
+                           ->WritePolylinePoints(line_counts[component_i],
+                                                 points + point_index);
         previous_path_component_index = component_i;
         break;
       case ComponentType::kContour:
@@ -389,15 +466,16 @@ Path::Polyline Path::CreatePolyline(
 
         Vector2 start_direction = compute_contour_start_direction(component_i);
         const auto& contour = data_->contours[path_component.index];
-        polyline.contours.push_back({.start_index = polyline.points->size(),
+        polyline.contours.push_back({.start_index = point_index,
                                      .is_closed = contour.is_closed,
                                      .start_direction = start_direction,
                                      .components = poly_components});
 
-        polyline.points->push_back(contour.destination);
+        points[point_index++] = contour.destination;
         break;
     }
   }
+  polyline.points->resize(point_index);
   end_contour();
   return polyline;
 }
@@ -8,6 +8,12 @@
 
 #include "impeller/geometry/wangs_formula.h"
 
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace impeller {
 
 VertexWriter::VertexWriter(std::vector<Point>& points,
@@ -112,6 +118,154 @@ static inline Scalar CubicSolveDerivative(Scalar t,
          3 * p3 * t * t;
 }
 
+/*
+ *  The points of a flattened curve are evaluated four at a time, with the same
+ *  order of operations as |QuadraticSolve| and |CubicSolve|.
+ */
+
+static constexpr size_t kLanes = 4;
+
+#if defined(__SSE__) || defined(_M_X64)
+using Lanes = __m128;
+
+static inline Lanes Splat(Scalar value) {
+  return _mm_set1_ps(value);
+}
+
+static inline Lanes Add(Lanes a, Lanes b) {
+  return _mm_add_ps(a, b);
+}
+
+static inline Lanes Sub(Lanes a, Lanes b) {
+  return _mm_sub_ps(a, b);
+}
+
+static inline Lanes Mul(Lanes a, Lanes b) {
+  return _mm_mul_ps(a, b);
+}
+
+static inline Lanes Div(Lanes a, Lanes b) {
+  return _mm_div_ps(a, b);
+}
+
+static inline Lanes Steps(size_t first) {
+  return _mm_setr_ps(static_cast<Scalar>(first), static_cast<Scalar>(first + 1),
+                     static_cast<Scalar>(first + 2),
+                     static_cast<Scalar>(first + 3));
+}
+
+static inline void StorePoints(Lanes x, Lanes y, Point* points) {
+  Scalar* out = reinterpret_cast<Scalar*>(points);
+  _mm_storeu_ps(out, _mm_unpacklo_ps(x, y));
+  _mm_storeu_ps(out + kLanes, _mm_unpackhi_ps(x, y));
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+using Lanes = float32x4_t;
+
+static inline Lanes Splat(Scalar value) {
+  return vdupq_n_f32(value);
+}
+
+static inline Lanes Add(Lanes a, Lanes b) {
+  return vaddq_f32(a, b);
+}
+
+static inline Lanes Sub(Lanes a, Lanes b) {
+  return vsubq_f32(a, b);
+}
+
+static inline Lanes Mul(Lanes a, Lanes b) {
+  return vmulq_f32(a, b);
+}
+
+static inline Lanes Div(Lanes a, Lanes b) {
+  return vdivq_f32(a, b);
+}
+
+static inline Lanes Steps(size_t first) {
+  const Scalar steps[kLanes] = {
+      static_cast<Scalar>(first), static_cast<Scalar>(first + 1),
+      static_cast<Scalar>(first + 2), static_cast<Scalar>(first + 3)};
+  return vld1q_f32(steps);
+}
+
+static inline void StorePoints(Lanes x, Lanes y, Point* points) {
+  vst2q_f32(reinterpret_cast<Scalar*>(points), (float32x4x2_t{{x, y}}));
+}
+#else
+struct Lanes {
+  Scalar v[kLanes];
+};
+
+static inline Lanes Splat(Scalar value) {
+  return {{value, value, value, value}};
+}
+
+template <typename Op>
+static inline Lanes Map(Lanes a, Lanes b, Op op) {
+  Lanes result;
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    result.v[lane] = op(a.v[lane], b.v[lane]);
+  }
+  return result;
+}
+
+static inline Lanes Add(Lanes a, Lanes b) {
+  return Map(a, b, [](Scalar x, Scalar y) { return x + y; });
+}
+
+static inline Lanes Sub(Lanes a, Lanes b) {
+  return Map(a, b, [](Scalar x, Scalar y) { return x - y; });
+}
+
+static inline Lanes Mul(Lanes a, Lanes b) {
+  return Map(a, b, [](Scalar x, Scalar y) { return x * y; });
+}
+
+static inline Lanes Div(Lanes a, Lanes b) {
+  return Map(a, b, [](Scalar x, Scalar y) { return x / y; });
+}
+
+static inline Lanes Steps(size_t first) {
+  return {{static_cast<Scalar>(first), static_cast<Scalar>(first + 1),
+           static_cast<Scalar>(first + 2), static_cast<Scalar>(first + 3)}};
+}
+
+static inline void StorePoints(Lanes x, Lanes y, Point* points) {
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    points[lane] = {x.v[lane], y.v[lane]};
+  }
+}
+#endif
+
+static inline Lanes QuadraticSolveLanes(Lanes t,
+                                        Scalar p0,
+                                        Scalar p1,
+                                        Scalar p2) {
+  const Lanes mt = Sub(Splat(1), t);
+  return Add(Add(Mul(Mul(mt, mt), Splat(p0)),                  //
+                 Mul(Mul(Mul(Splat(2), mt), t), Splat(p1))),   //
+             Mul(Mul(t, t), Splat(p2)));
+}
+
+static inline Lanes CubicSolveLanes(Lanes t,
+                                    Scalar p0,
+                                    Scalar p1,
+                                    Scalar p2,
+                                    Scalar p3) {
+  const Lanes mt = Sub(Splat(1), t);
+  return Add(Add(Add(Mul(Mul(Mul(mt, mt), mt), Splat(p0)),              //
+                     Mul(Mul(Mul(Mul(Splat(3), mt), mt), t), Splat(p1))),  //
+                 Mul(Mul(Mul(Mul(Splat(3), mt), t), t), Splat(p2))),       //
+             Mul(Mul(Mul(t, t), t), Splat(p3)));
+}
+
+size_t CountPolylinePoints(Scalar line_count) {
+  // The curve is always written as at least its end point, even if the count
+  // is zero or not a number.
+  return line_count > 1 ? static_cast<size_t>(std::ceil(line_count)) : 1u;
+}
+
 Point LinearPathComponent::Solve(Scalar time) const {
   return {
       LinearSolve(time, p1.x, p2.x),  // x
@@ -171,9 +325,29 @@ void QuadraticPathComponent::ToLinearPathComponents(
 void QuadraticPathComponent::AppendPolylinePoints(
     Scalar scale_factor,
     std::vector<Point>& points) const {
-  ToLinearPathComponents(scale_factor, [&points](const Point& point) {
-    points.emplace_back(point);
-  });
+  Scalar line_count =
+      std::ceilf(ComputeQuadradicSubdivisions(scale_factor, *this));
+  size_t start = points.size();
+  points.resize(start + CountPolylinePoints(line_count));
+  WritePolylinePoints(line_count, points.data() + start);
+}
+
+size_t QuadraticPathComponent::WritePolylinePoints(Scalar line_count,
+                                                  Point* points) const {
+  Point* out = points;
+  size_t i = 1;
+  const Lanes count = Splat(line_count);
+  for (; i + (kLanes - 1) < line_count; i += kLanes) {
+    const Lanes t = Div(Steps(i), count);
+    StorePoints(QuadraticSolveLanes(t, p1.x, cp.x, p2.x),
+                QuadraticSolveLanes(t, p1.y, cp.y, p2.y), out);
+    out += kLanes;
+  }
+  for (; i < line_count; i++) {
+    *out++ = Solve(i / line_count);
+  }
+  *out++ = p2;
+  return out - points;
 }
 
 void QuadraticPathComponent::ToLinearPathComponents(
@@ -229,8 +403,28 @@ Point CubicPathComponent::SolveDerivative(Scalar time) const {
 void CubicPathComponent::AppendPolylinePoints(
     Scalar scale,
     std::vector<Point>& points) const {
-  ToLinearPathComponents(
-      scale, [&points](const Point& point) { points.emplace_back(point); });
+  Scalar line_count = std::ceilf(ComputeCubicSubdivisions(scale, *this));
+  size_t start = points.size();
+  points.resize(start + CountPolylinePoints(line_count));
+  WritePolylinePoints(line_count, points.data() + start);
+}
+
+size_t CubicPathComponent::WritePolylinePoints(Scalar line_count,
+                                              Point* points) const {
+  Point* out = points;
+  size_t i = 1;
+  const Lanes count = Splat(line_count);
+  for (; i + (kLanes - 1) < line_count; i += kLanes) {
+    const Lanes t = Div(Steps(i), count);
+    StorePoints(CubicSolveLanes(t, p1.x, cp1.x, cp2.x, p2.x),
+                CubicSolveLanes(t, p1.y, cp1.y, cp2.y, p2.y), out);
+    out += kLanes;
+  }
+  for (; i < line_count; i++) {
+    *out++ = Solve(i / line_count);
+  }
+  *out++ = p2;
+  return out - points;
 }
 
 void CubicPathComponent::ToLinearPathComponents(Scalar scale,
@@ -36,6 +36,10 @@ class VertexWriter {
   std::vector<uint16_t>& indices_;
 };
 
+/// Returns the number of points that a curve split into |line_count| line
+/// segments adds to a polyline, one for the end of each segment.
+size_t CountPolylinePoints(Scalar line_count);
+
 struct LinearPathComponent {
   Point p1;
   Point p2;
@@ -80,6 +84,13 @@ struct QuadraticPathComponent {
   void AppendPolylinePoints(Scalar scale_factor,
                             std::vector<Point>& points) const;
 
+  /// Writes the points of the curve split into |line_count| line segments,
+  /// which must have room for |CountPolylinePoints(line_count)| points. The
+  /// points are evaluated four at a time with SSE or NEON where available.
+  ///
+  /// @return The number of points written.
+  size_t WritePolylinePoints(Scalar line_count, Point* points) const;
+
   using PointProc = std::function<void(const Point& point)>;
 
   void ToLinearPathComponents(Scalar scale_factor, const PointProc& proc) const;
@@ -125,6 +136,13 @@ struct CubicPathComponent {
 
   void AppendPolylinePoints(Scalar scale, std::vector<Point>& points) const;
 
+  /// Writes the points of the curve split into |line_count| line segments,
+  /// which must have room for |CountPolylinePoints(line_count)| points. The
+  /// points are evaluated four at a time with SSE or NEON where available.
+  ///
+  /// @return The number of points written.
+  size_t WritePolylinePoints(Scalar line_count, Point* points) const;
+
   std::vector<Point> Extrema() const;
 
   using PointProc = std::function<void(const Point& point)>;
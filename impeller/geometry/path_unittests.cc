@@ -8,6 +8,7 @@
 #include "impeller/geometry/geometry_asserts.h"
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/path_builder.h"
+#include "impeller/geometry/wangs_formula.h"
 
 namespace impeller {
 namespace testing {
@@ -22,6 +23,102 @@ TEST(PathTest, CubicPathComponentPolylineDoesNotIncludePointOne) {
   ASSERT_EQ(polyline.back().y, 40);
 }
 
+TEST(PathTest, BatchedSubdivisionsMatchSingleCurves) {
+  // Not a multiple of the four curves that are evaluated at once.
+  std::vector<QuadraticPathComponent> quads;
+  std::vector<CubicPathComponent> cubics;
+  for (int i = 0; i < 11; i++) {
+    Scalar s = i * 7.5f;
+    quads.emplace_back(Point(s, -s), Point(100 - s, s * 2), Point(s * 3, 50));
+    cubics.emplace_back(Point(s, -s), Point(100 - s, s * 2),
+                        Point(-s, 200 - s), Point(s * 3, 50));
+  }
+  std::vector<const QuadraticPathComponent*> quad_ptrs;
+  std::vector<const CubicPathComponent*> cubic_ptrs;
+  for (size_t i = 0; i < quads.size(); i++) {
+    quad_ptrs.push_back(&quads[i]);
+    cubic_ptrs.push_back(&cubics[i]);
+  }
+
+  for (Scalar scale : {0.0f, 1.0f, 2.5f}) {
+    std::vector<Scalar> quad_subdivisions(quads.size());
+    std::vector<Scalar> cubic_subdivisions(cubics.size());
+    ComputeQuadradicSubdivisions(scale, quad_ptrs.data(), quad_ptrs.size(),
+                                 quad_subdivisions.data());
+    ComputeCubicSubdivisions(scale, cubic_ptrs.data(), cubic_ptrs.size(),
+                             cubic_subdivisions.data());
+    for (size_t i = 0; i < quads.size(); i++) {
+      EXPECT_FLOAT_EQ(quad_subdivisions[i],
+                      ComputeQuadradicSubdivisions(scale, quads[i]));
+      EXPECT_FLOAT_EQ(cubic_subdivisions[i],
+                      ComputeCubicSubdivisions(scale, cubics[i]));
+    }
+  }
+}
+
+TEST(PathTest, CurvePolylinePointsMatchSolve) {
+  QuadraticPathComponent quad({10, 10}, {100, 200}, {300, 20});
+  CubicPathComponent cubic({10, 10}, {20, 350}, {350, -200}, {400, 40});
+
+  std::vector<Point> quad_points = {{1, 1}};
+  quad.AppendPolylinePoints(1.0f, quad_points);
+  Scalar quad_line_count = std::ceil(ComputeQuadradicSubdivisions(1.0f, quad));
+  ASSERT_EQ(quad_points.size(), 1u + CountPolylinePoints(quad_line_count));
+  // Enough points for some of them to be evaluated four at a time.
+  ASSERT_GT(quad_line_count, 8);
+  EXPECT_EQ(quad_points[0], Point(1, 1));
+  for (size_t i = 1; i < quad_line_count; i++) {
+    EXPECT_POINT_NEAR(quad_points[i], quad.Solve(i / quad_line_count));
+  }
+  EXPECT_EQ(quad_points.back(), quad.p2);
+
+  std::vector<Point> cubic_points;
+  cubic.AppendPolylinePoints(1.0f, cubic_points);
+  Scalar cubic_line_count = std::ceil(ComputeCubicSubdivisions(1.0f, cubic));
+  ASSERT_EQ(cubic_points.size(), CountPolylinePoints(cubic_line_count));
+  ASSERT_GT(cubic_line_count, 8);
+  for (size_t i = 1; i < cubic_line_count; i++) {
+    EXPECT_POINT_NEAR(cubic_points[i - 1], cubic.Solve(i / cubic_line_count));
+  }
+  EXPECT_EQ(cubic_points.back(), cubic.p2);
+
+  // A zero scale flattens curves to their end point.
+  std::vector<Point> end_points;
+  quad.AppendPolylinePoints(0.0f, end_points);
+  cubic.AppendPolylinePoints(0.0f, end_points);
+  ASSERT_EQ(end_points.size(), 2u);
+  EXPECT_EQ(end_points[0], quad.p2);
+  EXPECT_EQ(end_points[1], cubic.p2);
+}
+
+TEST(PathTest, PathCreatePolylineOfCurvesHasExactSize) {
+  QuadraticPathComponent quad({10, 10}, {100, 200}, {300, 20});
+  CubicPathComponent cubic({300, 20}, {20, 350}, {350, -200}, {400, 40});
+  PathBuilder builder;
+  builder.MoveTo(quad.p1);
+  for (int i = 0; i < 5; i++) {
+    builder.QuadraticCurveTo(quad.cp, quad.p2);
+    builder.CubicCurveTo(cubic.cp1, cubic.cp2, cubic.p2);
+    builder.LineTo(quad.p1);
+  }
+  builder.Close();
+
+  auto polyline = builder.TakePath().CreatePolyline(1.0f);
+
+  std::vector<Point> expected = {quad.p1};
+  for (int i = 0; i < 5; i++) {
+    quad.AppendPolylinePoints(1.0f, expected);
+    cubic.AppendPolylinePoints(1.0f, expected);
+    expected.push_back(quad.p1);
+  }
+  ASSERT_EQ(polyline.contours.size(), 1u);
+  ASSERT_EQ(polyline.contours[0].components.size(), 15u);
+  ASSERT_EQ(polyline.points->size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(polyline.GetPoint(i), expected[i]);
+  }
+}
+
 TEST(PathTest, PathCreatePolyLineDoesNotDuplicatePoints) {
   PathBuilder builder;
   builder.MoveTo({10, 10});
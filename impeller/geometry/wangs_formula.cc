@@ -4,6 +4,14 @@
 
 #include "impeller/geometry/wangs_formula.h"
 
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace impeller {
 
 namespace {
@@ -18,6 +26,131 @@ constexpr Scalar length(Point n) {
   return std::sqrt(nn.x + nn.y);
 }
 
+// The number of curves that the batched overloads evaluate at once.
+constexpr size_t kLanes = 4;
+
+// The control points of |kLanes| curves, with the coordinates of the same
+// control point of each curve stored next to each other. Unused lanes are
+// zero, for which the formula gives zero subdivisions.
+struct CurveLanes {
+  Scalar x[4][kLanes] = {};
+  Scalar y[4][kLanes] = {};
+
+  void Set(size_t lane, size_t point, Point p) {
+    x[point][lane] = p.x;
+    y[point][lane] = p.y;
+  }
+};
+
+// Evaluates |std::sqrt(k * length(n))| for each lane, in the same order of
+// operations as the scalar overloads so that the results are identical.
+#if defined(__SSE__) || defined(_M_X64)
+void WangsFormulaLanes(Scalar k, __m128 nx, __m128 ny, Scalar results[]) {
+  __m128 length =
+      _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)));
+  _mm_storeu_ps(results, _mm_sqrt_ps(_mm_mul_ps(_mm_set1_ps(k), length)));
+}
+
+// |p0 - p1 * 2 + p2| of one coordinate of each lane.
+__m128 SecondDifference(const Scalar p0[],
+                        const Scalar p1[],
+                        const Scalar p2[]) {
+  return _mm_add_ps(_mm_sub_ps(_mm_loadu_ps(p0), _mm_mul_ps(_mm_loadu_ps(p1),
+                                                            _mm_set1_ps(2))),
+                    _mm_loadu_ps(p2));
+}
+
+__m128 Abs(__m128 v) {
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+void QuadraticSubdivisionLanes(Scalar k,
+                               const CurveLanes& quads,
+                               Scalar results[]) {
+  WangsFormulaLanes(k, SecondDifference(quads.x[0], quads.x[1], quads.x[2]),
+                    SecondDifference(quads.y[0], quads.y[1], quads.y[2]),
+                    results);
+}
+
+void CubicSubdivisionLanes(Scalar k,
+                           const CurveLanes& cubics,
+                           Scalar results[]) {
+  __m128 nx = _mm_max_ps(
+      Abs(SecondDifference(cubics.x[0], cubics.x[1], cubics.x[2])),
+      Abs(SecondDifference(cubics.x[1], cubics.x[2], cubics.x[3])));
+  __m128 ny = _mm_max_ps(
+      Abs(SecondDifference(cubics.y[0], cubics.y[1], cubics.y[2])),
+      Abs(SecondDifference(cubics.y[1], cubics.y[2], cubics.y[3])));
+  WangsFormulaLanes(k, nx, ny, results);
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+void WangsFormulaLanes(Scalar k,
+                       float32x4_t nx,
+                       float32x4_t ny,
+                       Scalar results[]) {
+  float32x4_t length =
+      vsqrtq_f32(vaddq_f32(vmulq_f32(nx, nx), vmulq_f32(ny, ny)));
+  vst1q_f32(results, vsqrtq_f32(vmulq_f32(vdupq_n_f32(k), length)));
+}
+
+// |p0 - p1 * 2 + p2| of one coordinate of each lane.
+float32x4_t SecondDifference(const Scalar p0[],
+                             const Scalar p1[],
+                             const Scalar p2[]) {
+  return vaddq_f32(
+      vsubq_f32(vld1q_f32(p0), vmulq_f32(vld1q_f32(p1), vdupq_n_f32(2))),
+      vld1q_f32(p2));
+}
+
+void QuadraticSubdivisionLanes(Scalar k,
+                               const CurveLanes& quads,
+                               Scalar results[]) {
+  WangsFormulaLanes(k, SecondDifference(quads.x[0], quads.x[1], quads.x[2]),
+                    SecondDifference(quads.y[0], quads.y[1], quads.y[2]),
+                    results);
+}
+
+void CubicSubdivisionLanes(Scalar k,
+                           const CurveLanes& cubics,
+                           Scalar results[]) {
+  float32x4_t nx = vmaxq_f32(
+      vabsq_f32(SecondDifference(cubics.x[0], cubics.x[1], cubics.x[2])),
+      vabsq_f32(SecondDifference(cubics.x[1], cubics.x[2], cubics.x[3])));
+  float32x4_t ny = vmaxq_f32(
+      vabsq_f32(SecondDifference(cubics.y[0], cubics.y[1], cubics.y[2])),
+      vabsq_f32(SecondDifference(cubics.y[1], cubics.y[2], cubics.y[3])));
+  WangsFormulaLanes(k, nx, ny, results);
+}
+#else
+Point LanePoint(const CurveLanes& curves, size_t point, size_t lane) {
+  return {curves.x[point][lane], curves.y[point][lane]};
+}
+
+void QuadraticSubdivisionLanes(Scalar k,
+                               const CurveLanes& quads,
+                               Scalar results[]) {
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    Point n = LanePoint(quads, 0, lane) - LanePoint(quads, 1, lane) * 2 +
+              LanePoint(quads, 2, lane);
+    results[lane] = std::sqrt(k * length(n));
+  }
+}
+
+void CubicSubdivisionLanes(Scalar k,
+                           const CurveLanes& cubics,
+                           Scalar results[]) {
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    Point a = (LanePoint(cubics, 0, lane) - LanePoint(cubics, 1, lane) * 2 +
+               LanePoint(cubics, 2, lane))
+                  .Abs();
+    Point b = (LanePoint(cubics, 1, lane) - LanePoint(cubics, 2, lane) * 2 +
+               LanePoint(cubics, 3, lane))
+                  .Abs();
+    results[lane] = std::sqrt(k * length(a.Max(b)));
+  }
+}
+#endif
+
 }  // namespace
 
 Scalar ComputeCubicSubdivisions(Scalar scale_factor,
@@ -50,4 +183,45 @@ Scalar ComputeCubicSubdivisions(float scale_factor,
                                   cub.p2);
 }
 
+void ComputeQuadradicSubdivisions(Scalar scale_factor,
+                                  const QuadraticPathComponent* const quads[],
+                                  size_t count,
+                                  Scalar subdivisions[]) {
+  Scalar k = scale_factor * .25f * kPrecision;
+  for (size_t i = 0; i < count; i += kLanes) {
+    size_t lane_count = std::min(kLanes, count - i);
+    CurveLanes lanes;
+    for (size_t lane = 0; lane < lane_count; lane++) {
+      const QuadraticPathComponent& quad = *quads[i + lane];
+      lanes.Set(lane, 0, quad.p1);
+      lanes.Set(lane, 1, quad.cp);
+      lanes.Set(lane, 2, quad.p2);
+    }
+    Scalar results[kLanes];
+    QuadraticSubdivisionLanes(k, lanes, results);
+    std::copy(results, results + lane_count, subdivisions + i);
+  }
+}
+
+void ComputeCubicSubdivisions(Scalar scale_factor,
+                              const CubicPathComponent* const cubics[],
+                              size_t count,
+                              Scalar subdivisions[]) {
+  Scalar k = scale_factor * .75f * kPrecision;
+  for (size_t i = 0; i < count; i += kLanes) {
+    size_t lane_count = std::min(kLanes, count - i);
+    CurveLanes lanes;
+    for (size_t lane = 0; lane < lane_count; lane++) {
+      const CubicPathComponent& cubic = *cubics[i + lane];
+      lanes.Set(lane, 0, cubic.p1);
+      lanes.Set(lane, 1, cubic.cp1);
+      lanes.Set(lane, 2, cubic.cp2);
+      lanes.Set(lane, 3, cubic.p2);
+    }
+    Scalar results[kLanes];
+    CubicSubdivisionLanes(k, lanes, results);
+    std::copy(results, results + lane_count, subdivisions + i);
+  }
+}
+
 }  // namespace impeller
@@ -60,6 +60,27 @@ Scalar ComputeQuadradicSubdivisions(Scalar scale_factor,
 /// The scale_factor should be the max basis XY of the current transform.
 Scalar ComputeCubicSubdivisions(float scale_factor,
                                 const CubicPathComponent& cub);
+
+/// Computes the subdivisions of |count| quadratics into |subdivisions|,
+/// evaluating four quadratics at a time with SSE or NEON where available. The
+/// results are the same as those of the single quadratic overloads.
+///
+/// The scale_factor should be the max basis XY of the current transform.
+void ComputeQuadradicSubdivisions(Scalar scale_factor,
+                                  const QuadraticPathComponent* const quads[],
+                                  size_t count,
+                                  Scalar subdivisions[]);
+
+/// Computes the subdivisions of |count| cubics into |subdivisions|, evaluating
+/// four cubics at a time with SSE or NEON where available. The results are the
+/// same as those of the single cubic overloads.
+///
+/// The scale_factor should be the max basis XY of the current transform.
+void ComputeCubicSubdivisions(Scalar scale_factor,
+                              const CubicPathComponent* const cubics[],
+                              size_t count,
+                              Scalar subdivisions[]);
+
 }  // namespace impeller
 
 #endif  // FLUTTER_IMPELLER_GEOMETRY_WANGS_FORMULA_H_
@@ -181,6 +181,11 @@ bool CapabilitiesGLES::SupportsDeviceTransientTextures() const {
   return false;
 }
 
+bool CapabilitiesGLES::SupportsConcurrentCommandRecording() const {
+  // All GL calls are made on the thread of the reactor.
+  return false;
+}
+
 PixelFormat CapabilitiesGLES::GetDefaultColorFormat() const {
   return PixelFormat::kR8G8B8A8UNormInt;
 }
@@ -107,6 +107,9 @@ class CapabilitiesGLES final
   // |Capabilities|
   bool SupportsDeviceTransientTextures() const override;
 
+  // |Capabilities|
+  bool SupportsConcurrentCommandRecording() const override;
+
   // |Capabilities|
   PixelFormat GetDefaultColorFormat() const override;
 
@@ -572,6 +572,12 @@ bool CapabilitiesVK::SupportsDeviceTransientTextures() const {
   return supports_device_transient_textures_;
 }
 
+// |Capabilities|
+bool CapabilitiesVK::SupportsConcurrentCommandRecording() const {
+  // Command pools are per-thread and submissions to the queue are serialized.
+  return true;
+}
+
 // |Capabilities|
 PixelFormat CapabilitiesVK::GetDefaultColorFormat() const {
   return default_color_format_;
@@ -207,6 +207,9 @@ class CapabilitiesVK final : public Capabilities,
   // |Capabilities|
   bool SupportsDeviceTransientTextures() const override;
 
+  // |Capabilities|
+  bool SupportsConcurrentCommandRecording() const override;
+
   // |Capabilities|
   PixelFormat GetDefaultColorFormat() const override;
 
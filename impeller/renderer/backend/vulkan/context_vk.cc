@@ -33,6 +33,7 @@
 #include "impeller/renderer/backend/vulkan/debug_report_vk.h"
 #include "impeller/renderer/backend/vulkan/fence_waiter_vk.h"
 #include "impeller/renderer/backend/vulkan/gpu_tracer_vk.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_data_vk.h"
 #include "impeller/renderer/backend/vulkan/resource_manager_vk.h"
 #include "impeller/renderer/backend/vulkan/surface_context_vk.h"
 #include "impeller/renderer/backend/vulkan/yuv_conversion_library_vk.h"
@@ -363,11 +364,22 @@ void ContextVK::Setup(Settings settings) {
   //----------------------------------------------------------------------------
   /// Setup the pipeline library.
   ///
+  // Pipeline caches persisted by a build of the engine with different shaders
+  // are discarded.
+  uint64_t shader_libraries_hash = kPipelineCacheDataHashSeed;
+  for (const std::shared_ptr<fml::Mapping>& library :
+       settings.shader_libraries_data) {
+    if (library) {
+      shader_libraries_hash = PipelineCacheDataHash(
+          library->GetMapping(), library->GetSize(), shader_libraries_hash);
+    }
+  }
   auto pipeline_library = std::shared_ptr<PipelineLibraryVK>(
-      new PipelineLibraryVK(device_holder,                         //
-                            caps,                                  //
-                            std::move(settings.cache_directory),   //
-                            raster_message_loop_->GetTaskRunner()  //
+      new PipelineLibraryVK(device_holder,                          //
+                            caps,                                   //
+                            std::move(settings.cache_directory),    //
+                            raster_message_loop_->GetTaskRunner(),  //
+                            shader_libraries_hash                   //
                             ));
 
   if (!pipeline_library->IsValid()) {
@@ -578,6 +590,10 @@ std::shared_ptr<CommandQueue> ContextVK::GetCommandQueue() const {
   return command_queue_vk_;
 }
 
+void ContextVK::DisposeThreadLocalCachedResources() {
+  command_pool_recycler_->Dispose();
+}
+
 // Creating a render pass is observed to take an additional 6ms on a Pixel 7
 // device as the driver will lazily bootstrap and compile shaders to do so.
 // The render pass does not need to be begun or executed.
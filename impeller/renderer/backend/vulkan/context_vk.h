@@ -168,6 +168,9 @@ class ContextVK final : public Context,
 
   void InitializeCommonlyUsedShadersIfNeeded() const override;
 
+  // |Context|
+  void DisposeThreadLocalCachedResources() override;
+
  private:
   struct DeviceHolderImpl : public DeviceHolderVK {
     // |DeviceHolder|
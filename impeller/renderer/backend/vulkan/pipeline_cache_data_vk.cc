@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/vulkan/pipeline_cache_data_vk.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "flutter/fml/hash_bytes.h"
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+// The header is written to disk as is, so it must not have implicit padding.
+static_assert(std::is_trivially_copyable_v<PipelineCacheHeaderVK>);
+static_assert(sizeof(PipelineCacheHeaderVK) == 72u);
+
+PipelineCacheHeaderVK::PipelineCacheHeaderVK() = default;
+
+PipelineCacheHeaderVK::PipelineCacheHeaderVK(
+    const vk::PhysicalDeviceProperties& props,
+    uint64_t p_engine_hash)
+    : vendor_id(props.vendorID),
+      device_id(props.deviceID),
+      driver_version(props.driverVersion),
+      api_version(props.apiVersion),
+      engine_hash(p_engine_hash) {
+  std::copy(props.pipelineCacheUUID.begin(), props.pipelineCacheUUID.end(),
+            uuid);
+}
+
+bool PipelineCacheHeaderVK::IsCompatibleWith(
+    const PipelineCacheHeaderVK& other) const {
+  return magic == other.magic &&                    //
+         version == other.version &&                //
+         abi == other.abi &&                        //
+         vendor_id == other.vendor_id &&            //
+         device_id == other.device_id &&            //
+         driver_version == other.driver_version &&  //
+         api_version == other.api_version &&        //
+         std::memcmp(uuid, other.uuid, sizeof(uuid)) == 0 &&
+         engine_hash == other.engine_hash;
+}
+
+uint64_t PipelineCacheDataHash(const uint8_t* data,
+                               size_t size,
+                               uint64_t seed) {
+  return fml::HashBytes(data, size, seed);
+}
+
+std::shared_ptr<fml::Mapping> PipelineCacheDataEncode(
+    PipelineCacheHeaderVK header,
+    const fml::Mapping& data,
+    uint64_t data_hash) {
+  header.data_size = data.GetSize();
+  header.data_hash = data_hash;
+
+  std::vector<uint8_t> encoded(sizeof(header) + data.GetSize());
+  std::memcpy(encoded.data(), &header, sizeof(header));
+  if (data.GetSize() > 0u) {
+    std::memcpy(encoded.data() + sizeof(header), data.GetMapping(),
+                data.GetSize());
+  }
+  return std::make_shared<fml::DataMapping>(std::move(encoded));
+}
+
+std::unique_ptr<fml::Mapping> PipelineCacheDataDecode(
+    std::unique_ptr<fml::Mapping> file,
+    const PipelineCacheHeaderVK& expected_header) {
+  if (!file || file->GetSize() < sizeof(PipelineCacheHeaderVK)) {
+    return nullptr;
+  }
+
+  PipelineCacheHeaderVK header;
+  std::memcpy(&header, file->GetMapping(), sizeof(header));
+  if (!header.IsCompatibleWith(expected_header)) {
+    FML_LOG(INFO) << "Pipeline cache was created for a different device, "
+                     "driver, or engine. Starting with a fresh cache.";
+    return nullptr;
+  }
+
+  const uint8_t* data = file->GetMapping() + sizeof(header);
+  const size_t data_size = file->GetSize() - sizeof(header);
+  if (header.data_size != data_size ||
+      header.data_hash != PipelineCacheDataHash(data, data_size)) {
+    FML_LOG(INFO) << "Pipeline cache was corrupt. Starting with a fresh cache.";
+    return nullptr;
+  }
+
+  std::shared_ptr<fml::Mapping> shared_file = std::move(file);
+  return std::make_unique<fml::NonOwnedMapping>(
+      data, data_size, [shared_file](auto, auto) {});
+}
+
+}  // namespace impeller
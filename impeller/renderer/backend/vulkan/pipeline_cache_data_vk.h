@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_PIPELINE_CACHE_DATA_VK_H_
+#define FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_PIPELINE_CACHE_DATA_VK_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "flutter/fml/hash_bytes.h"
+#include "flutter/fml/mapping.h"
+#include "impeller/renderer/backend/vulkan/vk.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      The largest pipeline cache that is persisted to disk. Larger
+///             caches are not merged with the one on disk, and are not
+///             written at all if they exceed the limit on their own.
+///
+static constexpr size_t kMaxPersistedPipelineCacheSize = 16u * 1024u * 1024u;
+
+//------------------------------------------------------------------------------
+/// @brief      The header that precedes the pipeline cache data in the file on
+///             disk.
+///
+///             The driver validates the cache data it is handed too, but the
+///             drivers in the wild can't be trusted to reject a cache that was
+///             created by another device, driver, or version of the engine
+///             shaders. A cache is only used if everything except its size
+///             and hash matches the header for the current device.
+///
+struct PipelineCacheHeaderVK {
+  static constexpr uint32_t kMagic = 0x49504356;  // 'IPCV'
+  /// Bump when the layout of this header or the data hash changes.
+  static constexpr uint32_t kVersion = 2u;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  /// The size of a pointer, caches are not shared between 32 and 64 bit
+  /// processes.
+  uint32_t abi = sizeof(void*);
+  uint32_t vendor_id = 0u;
+  uint32_t device_id = 0u;
+  uint32_t driver_version = 0u;
+  uint32_t api_version = 0u;
+  uint32_t padding = 0u;
+  uint8_t uuid[VK_UUID_SIZE] = {};
+  /// A hash of the shaders that ship with the engine.
+  uint64_t engine_hash = 0u;
+  /// The size of the cache data that follows the header.
+  uint64_t data_size = 0u;
+  /// A hash of the cache data that follows the header.
+  uint64_t data_hash = 0u;
+
+  PipelineCacheHeaderVK();
+
+  PipelineCacheHeaderVK(const vk::PhysicalDeviceProperties& props,
+                        uint64_t engine_hash);
+
+  //----------------------------------------------------------------------------
+  /// @brief      If a cache with this header can be used by a device and engine
+  ///             described by `other`.
+  ///
+  bool IsCompatibleWith(const PipelineCacheHeaderVK& other) const;
+};
+
+static constexpr uint64_t kPipelineCacheDataHashSeed = fml::kHashBytesSeed;
+
+//------------------------------------------------------------------------------
+/// @brief      The `fml::HashBytes` of `data`, which is stored in the header of
+///             the cache to detect corrupt caches.
+///
+uint64_t PipelineCacheDataHash(const uint8_t* data,
+                               size_t size,
+                               uint64_t seed = kPipelineCacheDataHashSeed);
+
+//------------------------------------------------------------------------------
+/// @brief      Prefix the pipeline cache data with `header`, after filling in
+///             the size of the data and its `data_hash`, which must be the
+///             `PipelineCacheDataHash` of the data. Callers usually already
+///             have it to tell if the data changed.
+///
+std::shared_ptr<fml::Mapping> PipelineCacheDataEncode(
+    PipelineCacheHeaderVK header,
+    const fml::Mapping& data,
+    uint64_t data_hash);
+
+//------------------------------------------------------------------------------
+/// @brief      Validate the header of a cache file against the one expected for
+///             this device and return the cache data that follows it.
+///
+/// @return     The cache data, or null if the file was written for another
+///             device, driver, or engine, or is corrupt.
+///
+std::unique_ptr<fml::Mapping> PipelineCacheDataDecode(
+    std::unique_ptr<fml::Mapping> file,
+    const PipelineCacheHeaderVK& expected_header);
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_PIPELINE_CACHE_DATA_VK_H_
@@ -0,0 +1,166 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/testing/testing.h"  // IWYU pragma: keep
+#include "gtest/gtest.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_data_vk.h"
+#include "impeller/renderer/backend/vulkan/pipeline_library_vk.h"
+#include "impeller/renderer/backend/vulkan/test/mock_vulkan.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+vk::PhysicalDeviceProperties MakeProperties() {
+  vk::PhysicalDeviceProperties props;
+  props.vendorID = 0x1AE0;
+  props.deviceID = 0xC0DE;
+  props.driverVersion = 42u;
+  props.apiVersion = VK_API_VERSION_1_1;
+  std::fill(props.pipelineCacheUUID.begin(), props.pipelineCacheUUID.end(), 7u);
+  return props;
+}
+
+std::unique_ptr<fml::Mapping> CopyMapping(const fml::Mapping& mapping) {
+  return std::make_unique<fml::DataMapping>(std::vector<uint8_t>(
+      mapping.GetMapping(), mapping.GetMapping() + mapping.GetSize()));
+}
+
+}  // namespace
+
+TEST(PipelineCacheDataVKTest, CanRoundTripCacheData) {
+  PipelineCacheHeaderVK header(MakeProperties(), /*engine_hash=*/99u);
+  fml::DataMapping data(std::vector<uint8_t>{1, 2, 3, 4, 5});
+
+  std::shared_ptr<fml::Mapping> file = PipelineCacheDataEncode(
+      header, data, PipelineCacheDataHash(data.GetMapping(), data.GetSize()));
+  ASSERT_EQ(file->GetSize(), sizeof(PipelineCacheHeaderVK) + 5u);
+
+  std::unique_ptr<fml::Mapping> decoded =
+      PipelineCacheDataDecode(CopyMapping(*file), header);
+  ASSERT_NE(decoded, nullptr);
+  ASSERT_EQ(decoded->GetSize(), 5u);
+  EXPECT_EQ(std::memcmp(decoded->GetMapping(), data.GetMapping(), 5u), 0);
+}
+
+TEST(PipelineCacheDataVKTest, RejectsCachesOfOtherDevicesAndEngines) {
+  PipelineCacheHeaderVK header(MakeProperties(), /*engine_hash=*/99u);
+  fml::DataMapping data(std::vector<uint8_t>{1, 2, 3, 4, 5});
+  std::shared_ptr<fml::Mapping> file = PipelineCacheDataEncode(
+      header, data, PipelineCacheDataHash(data.GetMapping(), data.GetSize()));
+
+  PipelineCacheHeaderVK other_engine(MakeProperties(), /*engine_hash=*/98u);
+  EXPECT_EQ(PipelineCacheDataDecode(CopyMapping(*file), other_engine),
+            nullptr);
+
+  vk::PhysicalDeviceProperties props = MakeProperties();
+  props.driverVersion = 43u;
+  EXPECT_EQ(PipelineCacheDataDecode(CopyMapping(*file),
+                                    PipelineCacheHeaderVK(props, 99u)),
+            nullptr);
+
+  props = MakeProperties();
+  props.deviceID = 0xBEEF;
+  EXPECT_EQ(PipelineCacheDataDecode(CopyMapping(*file),
+                                    PipelineCacheHeaderVK(props, 99u)),
+            nullptr);
+
+  props = MakeProperties();
+  props.pipelineCacheUUID[3] = 0u;
+  EXPECT_EQ(PipelineCacheDataDecode(CopyMapping(*file),
+                                    PipelineCacheHeaderVK(props, 99u)),
+            nullptr);
+}
+
+TEST(PipelineCacheDataVKTest, HashDependsOnEveryByte) {
+  // Long enough to be hashed in whole lanes, whole words, and a tail.
+  std::vector<uint8_t> bytes(77u);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = static_cast<uint8_t>(i * 13u);
+  }
+  const uint64_t hash = PipelineCacheDataHash(bytes.data(), bytes.size());
+  EXPECT_EQ(hash, PipelineCacheDataHash(bytes.data(), bytes.size()));
+  EXPECT_NE(hash, PipelineCacheDataHash(bytes.data(), bytes.size() - 1));
+  EXPECT_NE(hash, PipelineCacheDataHash(bytes.data(), bytes.size(), 1u));
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] ^= 0x10;
+    EXPECT_NE(hash, PipelineCacheDataHash(bytes.data(), bytes.size())) << i;
+    bytes[i] ^= 0x10;
+  }
+}
+
+TEST(PipelineCacheDataVKTest, RejectsCorruptCaches) {
+  PipelineCacheHeaderVK header(MakeProperties(), /*engine_hash=*/99u);
+  fml::DataMapping data(std::vector<uint8_t>{1, 2, 3, 4, 5});
+  std::shared_ptr<fml::Mapping> file = PipelineCacheDataEncode(
+      header, data, PipelineCacheDataHash(data.GetMapping(), data.GetSize()));
+
+  std::vector<uint8_t> bytes(file->GetMapping(),
+                             file->GetMapping() + file->GetSize());
+  bytes.back() ^= 0xff;
+  EXPECT_EQ(PipelineCacheDataDecode(
+                std::make_unique<fml::DataMapping>(bytes), header),
+            nullptr);
+
+  bytes.back() ^= 0xff;
+  bytes.pop_back();
+  EXPECT_EQ(PipelineCacheDataDecode(
+                std::make_unique<fml::DataMapping>(bytes), header),
+            nullptr);
+
+  bytes.resize(sizeof(PipelineCacheHeaderVK) / 2);
+  EXPECT_EQ(PipelineCacheDataDecode(
+                std::make_unique<fml::DataMapping>(bytes), header),
+            nullptr);
+
+  // Caches written before the header was introduced are discarded too.
+  EXPECT_EQ(PipelineCacheDataDecode(CopyMapping(data), header), nullptr);
+}
+
+TEST(PipelineCacheDataVKTest, PersistsCacheWithHeaderAndMergesExistingFile) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  auto context =
+      MockVulkanContextBuilder()
+          .SetSettingsCallback([&temp_dir](ContextVK::Settings& settings) {
+            settings.cache_directory =
+                fml::OpenDirectory(temp_dir.path().c_str(), false,
+                                   fml::FilePermission::kReadWrite);
+          })
+          .Build();
+  ASSERT_TRUE(context);
+  const std::shared_ptr<PipelineCacheVK>& pso_cache =
+      PipelineLibraryVK::Cast(*context->GetPipelineLibrary()).GetPSOCache();
+
+  pso_cache->PersistCacheToDisk();
+  auto functions = GetMockVulkanFunctions(context->GetDevice());
+  EXPECT_EQ(std::count(functions->begin(), functions->end(),
+                       "vkMergePipelineCaches"),
+            0);
+
+  std::unique_ptr<fml::Mapping> file = fml::FileMapping::CreateReadOnly(
+      temp_dir.fd(), "flutter.impeller.vkcache");
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->GetSize(), sizeof(PipelineCacheHeaderVK) + 4u);
+  PipelineCacheHeaderVK header;
+  std::memcpy(&header, file->GetMapping(), sizeof(header));
+  EXPECT_EQ(header.magic, PipelineCacheHeaderVK::kMagic);
+  EXPECT_EQ(header.data_size, 4u);
+
+  // The cache on disk is now merged into the persisted one.
+  pso_cache->PersistCacheToDisk();
+  functions = GetMockVulkanFunctions(context->GetDevice());
+  EXPECT_EQ(std::count(functions->begin(), functions->end(),
+                       "vkMergePipelineCaches"),
+            1);
+}
+
+}  // namespace testing
+}  // namespace impeller
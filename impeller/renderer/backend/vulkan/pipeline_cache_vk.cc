@@ -16,25 +16,13 @@ namespace impeller {
 static constexpr const char* kPipelineCacheFileName =
     "flutter.impeller.vkcache";
 
-static bool VerifyExistingCache(const fml::Mapping& mapping,
-                                const CapabilitiesVK& caps) {
-  return true;
-}
-
-static std::shared_ptr<fml::Mapping> DecorateCacheWithMetadata(
-    std::shared_ptr<fml::Mapping> data) {
-  return data;
-}
-
-static std::unique_ptr<fml::Mapping> RemoveMetadataFromCache(
-    std::unique_ptr<fml::Mapping> data) {
-  return data;
-}
+static constexpr const char* kPipelineUsageProfileFileName =
+    "flutter.impeller.vkusage";
 
 static std::unique_ptr<fml::Mapping> OpenCacheFile(
     const fml::UniqueFD& base_directory,
     const std::string& cache_file_name,
-    const CapabilitiesVK& caps) {
+    const PipelineCacheHeaderVK& expected_header) {
   if (!base_directory.is_valid()) {
     return nullptr;
   }
@@ -43,19 +31,13 @@ static std::unique_ptr<fml::Mapping> OpenCacheFile(
   if (!mapping) {
     return nullptr;
   }
-  if (!VerifyExistingCache(*mapping, caps)) {
-    return nullptr;
-  }
-  mapping = RemoveMetadataFromCache(std::move(mapping));
-  if (!mapping) {
-    return nullptr;
-  }
-  return mapping;
+  return PipelineCacheDataDecode(std::move(mapping), expected_header);
 }
 
 PipelineCacheVK::PipelineCacheVK(std::shared_ptr<const Capabilities> caps,
                                  std::shared_ptr<DeviceHolderVK> device_holder,
-                                 fml::UniqueFD cache_directory)
+                                 fml::UniqueFD cache_directory,
+                                 uint64_t engine_hash)
     : caps_(std::move(caps)),
       device_holder_(device_holder),
       cache_directory_(std::move(cache_directory)) {
@@ -64,9 +46,11 @@ PipelineCacheVK::PipelineCacheVK(std::shared_ptr<const Capabilities> caps,
   }
 
   const auto& vk_caps = CapabilitiesVK::Cast(*caps_);
+  header_ =
+      PipelineCacheHeaderVK(vk_caps.GetPhysicalDeviceProperties(), engine_hash);
 
   auto existing_cache_data =
-      OpenCacheFile(cache_directory_, kPipelineCacheFileName, vk_caps);
+      OpenCacheFile(cache_directory_, kPipelineCacheFileName, header_);
 
   vk::PipelineCacheCreateInfo cache_info;
   if (existing_cache_data) {
@@ -154,8 +138,43 @@ std::shared_ptr<fml::Mapping> PipelineCacheVK::CopyPipelineCacheData() const {
   if (!IsValid()) {
     return nullptr;
   }
-  auto [result, data] =
-      strong_device->GetDevice().getPipelineCacheData(*cache_);
+  const vk::Device& device = strong_device->GetDevice();
+
+  // Other contexts of this application may have persisted pipelines that this
+  // one didn't create. Merge them in so that they are not lost when the file
+  // is replaced. The cache in use may not be the destination of a merge
+  // because it is not externally synchronized.
+  vk::UniquePipelineCache merged_cache;
+  if (auto disk_data =
+          OpenCacheFile(cache_directory_, kPipelineCacheFileName, header_);
+      disk_data && disk_data->GetSize() <= kMaxPersistedPipelineCacheSize) {
+    vk::PipelineCacheCreateInfo disk_cache_info;
+    disk_cache_info.initialDataSize = disk_data->GetSize();
+    disk_cache_info.pInitialData = disk_data->GetMapping();
+    auto [disk_result, disk_cache] =
+        device.createPipelineCacheUnique(disk_cache_info);
+    auto [merged_result, cache] =
+        device.createPipelineCacheUnique(vk::PipelineCacheCreateInfo{});
+    if (disk_result == vk::Result::eSuccess &&
+        merged_result == vk::Result::eSuccess &&
+        device.mergePipelineCaches(*cache, {*cache_, *disk_cache}) ==
+            vk::Result::eSuccess) {
+      merged_cache = std::move(cache);
+    }
+  }
+
+  auto [result, data] = device.getPipelineCacheData(*cache_);
+  if (merged_cache) {
+    auto [merged_result, merged_data] =
+        device.getPipelineCacheData(*merged_cache);
+    // Prefer dropping the pipelines of other contexts over exceeding the size
+    // limit.
+    if (merged_result == vk::Result::eSuccess &&
+        merged_data.size() <= kMaxPersistedPipelineCacheSize) {
+      result = merged_result;
+      data = std::move(merged_data);
+    }
+  }
   if (result != vk::Result::eSuccess) {
     VALIDATION_LOG << "Could not get pipeline cache data to persist.";
     return nullptr;
@@ -170,21 +189,49 @@ void PipelineCacheVK::PersistCacheToDisk() const {
   if (!cache_directory_.is_valid()) {
     return;
   }
+  // Both the merge with the file on disk and the write must not interleave
+  // with another persist of this cache.
+  Lock lock(persist_mutex_);
   auto data = CopyPipelineCacheData();
   if (!data) {
     VALIDATION_LOG << "Could not copy pipeline cache data.";
     return;
   }
-  data = DecorateCacheWithMetadata(std::move(data));
-  if (!data) {
-    VALIDATION_LOG
-        << "Could not decorate pipeline cache with additional metadata.";
+  if (data->GetSize() > kMaxPersistedPipelineCacheSize) {
+    FML_LOG(INFO) << "Pipeline cache of " << data->GetSize()
+                  << " bytes exceeds the size limit and was not persisted.";
+    return;
+  }
+  const uint64_t data_hash =
+      PipelineCacheDataHash(data->GetMapping(), data->GetSize());
+  if (data_hash == last_persisted_data_hash_) {
     return;
   }
-  if (!fml::WriteAtomically(cache_directory_, kPipelineCacheFileName, *data)) {
+  auto file = PipelineCacheDataEncode(header_, *data, data_hash);
+  if (!fml::WriteAtomically(cache_directory_, kPipelineCacheFileName, *file)) {
     VALIDATION_LOG << "Could not persist pipeline cache to disk.";
     return;
   }
+  last_persisted_data_hash_ = data_hash;
+}
+
+std::unique_ptr<fml::Mapping> PipelineCacheVK::ReadUsageProfile() const {
+  if (!cache_directory_.is_valid()) {
+    return nullptr;
+  }
+  return fml::FileMapping::CreateReadOnly(cache_directory_,
+                                          kPipelineUsageProfileFileName);
+}
+
+void PipelineCacheVK::PersistUsageProfileToDisk(
+    const fml::Mapping& profile) const {
+  if (!cache_directory_.is_valid()) {
+    return;
+  }
+  if (!fml::WriteAtomically(cache_directory_, kPipelineUsageProfileFileName,
+                            profile)) {
+    VALIDATION_LOG << "Could not persist pipeline usage profile to disk.";
+  }
 }
 
 const CapabilitiesVK* PipelineCacheVK::GetCapabilities() const {
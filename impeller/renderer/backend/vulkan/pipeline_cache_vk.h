@@ -6,8 +6,10 @@
 #define FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_PIPELINE_CACHE_VK_H_
 
 #include "flutter/fml/file.h"
+#include "impeller/base/thread.h"
 #include "impeller/renderer/backend/vulkan/capabilities_vk.h"
 #include "impeller/renderer/backend/vulkan/device_holder_vk.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_data_vk.h"
 
 namespace impeller {
 
@@ -17,9 +19,13 @@ class PipelineCacheVK {
   // constructor directly. The [device_holder] isn't guaranteed to be valid
   // at the time of executing `PipelineCacheVK` because of how `ContextVK` does
   // initialization.
+  //
+  // The [engine_hash] identifies the shaders of the engine. Caches persisted
+  // with a different hash are discarded.
   explicit PipelineCacheVK(std::shared_ptr<const Capabilities> caps,
                            std::shared_ptr<DeviceHolderVK> device_holder,
-                           fml::UniqueFD cache_directory);
+                           fml::UniqueFD cache_directory,
+                           uint64_t engine_hash = 0u);
 
   ~PipelineCacheVK();
 
@@ -31,14 +37,25 @@ class PipelineCacheVK {
 
   const CapabilitiesVK* GetCapabilities() const;
 
+  // Writes the cache, merged with the one that is currently on disk, to the
+  // cache directory. Safe to call from any thread. Concurrent calls are
+  // serialized.
   void PersistCacheToDisk() const;
 
+  std::unique_ptr<fml::Mapping> ReadUsageProfile() const;
+
+  void PersistUsageProfileToDisk(const fml::Mapping& profile) const;
+
  private:
   const std::shared_ptr<const Capabilities> caps_;
   std::weak_ptr<DeviceHolderVK> device_holder_;
   const fml::UniqueFD cache_directory_;
+  PipelineCacheHeaderVK header_;
   vk::UniquePipelineCache cache_;
   bool is_valid_ = false;
+  mutable Mutex persist_mutex_;
+  mutable uint64_t last_persisted_data_hash_ IPLR_GUARDED_BY(persist_mutex_) =
+      0u;
 
   std::shared_ptr<fml::Mapping> CopyPipelineCacheData() const;
 
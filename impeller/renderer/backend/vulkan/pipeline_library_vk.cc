@@ -28,11 +28,13 @@ PipelineLibraryVK::PipelineLibraryVK(
     const std::shared_ptr<DeviceHolderVK>& device_holder,
     std::shared_ptr<const Capabilities> caps,
     fml::UniqueFD cache_directory,
-    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+    uint64_t engine_hash)
     : device_holder_(device_holder),
       pso_cache_(std::make_shared<PipelineCacheVK>(std::move(caps),
                                                    device_holder,
-                                                   std::move(cache_directory))),
+                                                   std::move(cache_directory),
+                                                   engine_hash)),
       worker_task_runner_(std::move(worker_task_runner)) {
   FML_DCHECK(worker_task_runner_);
   if (!pso_cache_->IsValid() || !worker_task_runner_) {
@@ -272,8 +274,7 @@ void PipelineLibraryVK::RemovePipelinesWithEntryPoint(
 
 void PipelineLibraryVK::DidAcquireSurfaceFrame() {
   if (++frames_acquired_ == 50u) {
-    if (cache_dirty_) {
-      cache_dirty_ = false;
+    if (cache_dirty_.exchange(false)) {
       PersistPipelineCacheToDisk();
     }
     frames_acquired_ = 0;
@@ -291,6 +292,29 @@ void PipelineLibraryVK::PersistPipelineCacheToDisk() {
       });
 }
 
+// |PipelineLibrary|
+std::unique_ptr<fml::Mapping> PipelineLibraryVK::LoadPipelineUsageProfile()
+    const {
+  return pso_cache_->ReadUsageProfile();
+}
+
+// |PipelineLibrary|
+void PipelineLibraryVK::PersistPipelineUsageProfile(
+    std::shared_ptr<const fml::Mapping> profile) {
+  if (!profile) {
+    return;
+  }
+  worker_task_runner_->PostTask(
+      [weak_cache = decltype(pso_cache_)::weak_type(pso_cache_),
+       profile = std::move(profile)]() {
+        auto cache = weak_cache.lock();
+        if (!cache) {
+          return;
+        }
+        cache->PersistUsageProfileToDisk(*profile);
+      });
+}
+
 const std::shared_ptr<PipelineCacheVK>& PipelineLibraryVK::GetPSOCache() const {
   return pso_cache_;
 }
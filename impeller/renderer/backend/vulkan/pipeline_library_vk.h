@@ -47,13 +47,14 @@ class PipelineLibraryVK final
       compute_pipelines_mutex_);
   std::atomic_size_t frames_acquired_ = 0u;
   bool is_valid_ = false;
-  bool cache_dirty_ = false;
+  std::atomic_bool cache_dirty_ = false;
 
   PipelineLibraryVK(
       const std::shared_ptr<DeviceHolderVK>& device_holder,
       std::shared_ptr<const Capabilities> caps,
       fml::UniqueFD cache_directory,
-      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+      uint64_t engine_hash = 0u);
 
   // |PipelineLibrary|
   bool IsValid() const override;
@@ -71,6 +72,13 @@ class PipelineLibraryVK final
   void RemovePipelinesWithEntryPoint(
       std::shared_ptr<const ShaderFunction> function) override;
 
+  // |PipelineLibrary|
+  std::unique_ptr<fml::Mapping> LoadPipelineUsageProfile() const override;
+
+  // |PipelineLibrary|
+  void PersistPipelineUsageProfile(
+      std::shared_ptr<const fml::Mapping> profile) override;
+
   std::unique_ptr<ComputePipelineVK> CreateComputePipeline(
       const ComputePipelineDescriptor& desc);
 
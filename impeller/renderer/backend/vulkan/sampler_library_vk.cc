@@ -20,16 +20,24 @@ static const std::unique_ptr<const Sampler> kNullSampler = nullptr;
 
 const std::unique_ptr<const Sampler>& SamplerLibraryVK::GetSampler(
     SamplerDescriptor desc) {
-  auto found = samplers_.find(desc);
-  if (found != samplers_.end()) {
-    return found->second;
+  {
+    ReaderLock lock(samplers_mutex_);
+    auto found = samplers_.find(desc);
+    if (found != samplers_.end()) {
+      return found->second;
+    }
   }
   auto device_holder = device_holder_.lock();
   if (!device_holder || !device_holder->GetDevice()) {
     return kNullSampler;
   }
-  return (samplers_[desc] =
-              std::make_unique<SamplerVK>(device_holder->GetDevice(), desc));
+  WriterLock lock(samplers_mutex_);
+  // Another thread may have created the sampler in the meantime.
+  std::unique_ptr<const Sampler>& sampler = samplers_[desc];
+  if (!sampler) {
+    sampler = std::make_unique<SamplerVK>(device_holder->GetDevice(), desc);
+  }
+  return sampler;
 }
 
 }  // namespace impeller
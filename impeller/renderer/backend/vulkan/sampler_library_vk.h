@@ -6,6 +6,7 @@
 #define FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_SAMPLER_LIBRARY_VK_H_
 
 #include "impeller/base/backend_cast.h"
+#include "impeller/base/thread.h"
 #include "impeller/core/sampler_descriptor.h"
 #include "impeller/renderer/backend/vulkan/device_holder_vk.h"
 #include "impeller/renderer/sampler_library.h"
@@ -23,7 +24,8 @@ class SamplerLibraryVK final
   friend class ContextVK;
 
   std::weak_ptr<DeviceHolderVK> device_holder_;
-  SamplerMap samplers_;
+  RWMutex samplers_mutex_;
+  SamplerMap samplers_ IPLR_GUARDED_BY(samplers_mutex_);
 
   explicit SamplerLibraryVK(const std::weak_ptr<DeviceHolderVK>& device_holder);
 
@@ -82,6 +82,9 @@ class SurfaceContextVK : public Context,
 
   void InitializeCommonlyUsedShadersIfNeeded() const override;
 
+  // |Context|
+  void DisposeThreadLocalCachedResources() override;
+
   const vk::Device& GetDevice() const;
 
   const std::shared_ptr<ContextVK>& GetParent() const;
@@ -4,6 +4,7 @@
 
 #include "impeller/renderer/backend/vulkan/test/mock_vulkan.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <utility>
@@ -421,6 +422,31 @@ void vkDestroyPipelineCache(VkDevice device,
   mock_device->AddCalledFunction("vkDestroyPipelineCache");
 }
 
+VkResult vkGetPipelineCacheData(VkDevice device,
+                                VkPipelineCache pipelineCache,
+                                size_t* pDataSize,
+                                void* pData) {
+  MockDevice* mock_device = reinterpret_cast<MockDevice*>(device);
+  mock_device->AddCalledFunction("vkGetPipelineCacheData");
+  static constexpr uint8_t kCacheData[] = {0xc, 0xa, 0xc, 0xe};
+  if (!pData) {
+    *pDataSize = sizeof(kCacheData);
+    return VK_SUCCESS;
+  }
+  *pDataSize = std::min(*pDataSize, sizeof(kCacheData));
+  std::memcpy(pData, kCacheData, *pDataSize);
+  return VK_SUCCESS;
+}
+
+VkResult vkMergePipelineCaches(VkDevice device,
+                               VkPipelineCache dstCache,
+                               uint32_t srcCacheCount,
+                               const VkPipelineCache* pSrcCaches) {
+  MockDevice* mock_device = reinterpret_cast<MockDevice*>(device);
+  mock_device->AddCalledFunction("vkMergePipelineCaches");
+  return VK_SUCCESS;
+}
+
 void vkDestroySurfaceKHR(VkInstance instance,
                          VkSurfaceKHR surface,
                          const VkAllocationCallbacks* pAllocator) {
@@ -815,6 +841,10 @@ PFN_vkVoidFunction GetMockVulkanProcAddress(VkInstance instance,
     return (PFN_vkVoidFunction)vkDestroyShaderModule;
   } else if (strcmp("vkDestroyPipelineCache", pName) == 0) {
     return (PFN_vkVoidFunction)vkDestroyPipelineCache;
+  } else if (strcmp("vkGetPipelineCacheData", pName) == 0) {
+    return (PFN_vkVoidFunction)vkGetPipelineCacheData;
+  } else if (strcmp("vkMergePipelineCaches", pName) == 0) {
+    return (PFN_vkVoidFunction)vkMergePipelineCaches;
   } else if (strcmp("vkCmdBindPipeline", pName) == 0) {
     return (PFN_vkVoidFunction)vkCmdBindPipeline;
   } else if (strcmp("vkCmdSetStencilReference", pName) == 0) {
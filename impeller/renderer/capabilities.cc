@@ -75,6 +75,11 @@ class StandardCapabilities final : public Capabilities {
     return supports_device_transient_textures_;
   }
 
+  // |Capabilities|
+  bool SupportsConcurrentCommandRecording() const override {
+    return supports_concurrent_command_recording_;
+  }
+
   // |Capabilities|
   PixelFormat GetDefaultGlyphAtlasFormat() const override {
     return default_glyph_atlas_format_;
@@ -90,6 +95,7 @@ class StandardCapabilities final : public Capabilities {
                        bool supports_read_from_resolve,
                        bool supports_decal_sampler_address_mode,
                        bool supports_device_transient_textures,
+                       bool supports_concurrent_command_recording,
                        PixelFormat default_color_format,
                        PixelFormat default_stencil_format,
                        PixelFormat default_depth_stencil_format,
@@ -104,6 +110,8 @@ class StandardCapabilities final : public Capabilities {
         supports_decal_sampler_address_mode_(
             supports_decal_sampler_address_mode),
         supports_device_transient_textures_(supports_device_transient_textures),
+        supports_concurrent_command_recording_(
+            supports_concurrent_command_recording),
         default_color_format_(default_color_format),
         default_stencil_format_(default_stencil_format),
         default_depth_stencil_format_(default_depth_stencil_format),
@@ -120,6 +128,7 @@ class StandardCapabilities final : public Capabilities {
   bool supports_read_from_resolve_ = false;
   bool supports_decal_sampler_address_mode_ = false;
   bool supports_device_transient_textures_ = false;
+  bool supports_concurrent_command_recording_ = false;
   PixelFormat default_color_format_ = PixelFormat::kUnknown;
   PixelFormat default_stencil_format_ = PixelFormat::kUnknown;
   PixelFormat default_depth_stencil_format_ = PixelFormat::kUnknown;
@@ -203,6 +212,12 @@ CapabilitiesBuilder& CapabilitiesBuilder::SetSupportsDeviceTransientTextures(
   return *this;
 }
 
+CapabilitiesBuilder& CapabilitiesBuilder::SetSupportsConcurrentCommandRecording(
+    bool value) {
+  supports_concurrent_command_recording_ = value;
+  return *this;
+}
+
 CapabilitiesBuilder& CapabilitiesBuilder::SetDefaultGlyphAtlasFormat(
     PixelFormat value) {
   default_glyph_atlas_format_ = value;
@@ -220,6 +235,7 @@ std::unique_ptr<Capabilities> CapabilitiesBuilder::Build() {
       supports_read_from_resolve_,                                        //
       supports_decal_sampler_address_mode_,                               //
       supports_device_transient_textures_,                                //
+      supports_concurrent_command_recording_,                             //
       default_color_format_.value_or(PixelFormat::kUnknown),              //
       default_stencil_format_.value_or(PixelFormat::kUnknown),            //
       default_depth_stencil_format_.value_or(PixelFormat::kUnknown),      //
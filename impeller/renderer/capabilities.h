@@ -83,6 +83,14 @@ class Capabilities {
   ///         This feature is especially useful for MSAA and stencils.
   virtual bool SupportsDeviceTransientTextures() const = 0;
 
+  /// @brief  Whether command buffers and the passes they encode may be created
+  ///         and recorded on several threads at once, as long as each one is
+  ///         only used by a single thread.
+  ///
+  ///         When supported, the entity renderer records independent offscreen
+  ///         passes on worker threads.
+  virtual bool SupportsConcurrentCommandRecording() const = 0;
+
   /// @brief  Returns a supported `PixelFormat` for textures that store
   ///         4-channel colors (red/green/blue/alpha).
   virtual PixelFormat GetDefaultColorFormat() const = 0;
@@ -143,6 +151,8 @@ class CapabilitiesBuilder {
 
   CapabilitiesBuilder& SetSupportsDeviceTransientTextures(bool value);
 
+  CapabilitiesBuilder& SetSupportsConcurrentCommandRecording(bool value);
+
   CapabilitiesBuilder& SetDefaultGlyphAtlasFormat(PixelFormat value);
 
   std::unique_ptr<Capabilities> Build();
@@ -157,6 +167,7 @@ class CapabilitiesBuilder {
   bool supports_read_from_resolve_ = false;
   bool supports_decal_sampler_address_mode_ = false;
   bool supports_device_transient_textures_ = false;
+  bool supports_concurrent_command_recording_ = false;
   std::optional<PixelFormat> default_color_format_ = std::nullopt;
   std::optional<PixelFormat> default_stencil_format_ = std::nullopt;
   std::optional<PixelFormat> default_depth_stencil_format_ = std::nullopt;
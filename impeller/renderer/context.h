@@ -191,6 +191,13 @@ class Context {
   /// shader variants, as well as forcing driver initialization.
   virtual void InitializeCommonlyUsedShadersIfNeeded() const {}
 
+  /// Release the resources that the backend caches for the calling thread,
+  /// such as command pools.
+  ///
+  /// Worker threads that created command buffers call this once they are done
+  /// recording so that the cached resources do not outlive the frame.
+  virtual void DisposeThreadLocalCachedResources() {}
+
  protected:
   Context();
 
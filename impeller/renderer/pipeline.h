@@ -6,6 +6,7 @@
 #define FLUTTER_IMPELLER_RENDERER_PIPELINE_H_
 
 #include <future>
+#include <mutex>
 
 #include "compute_pipeline_descriptor.h"
 #include "impeller/renderer/compute_pipeline_builder.h"
@@ -120,13 +121,12 @@ class RenderPipelineHandle {
       : pipeline_future_(std::move(future)) {}
 
   std::shared_ptr<Pipeline<PipelineDescriptor>> WaitAndGet() {
-    if (did_wait_) {
-      return pipeline_;
-    }
-    did_wait_ = true;
-    if (pipeline_future_.IsValid()) {
-      pipeline_ = pipeline_future_.Get();
-    }
+    // Handles are shared by the threads that record commands concurrently.
+    std::call_once(wait_flag_, [this]() {
+      if (pipeline_future_.IsValid()) {
+        pipeline_ = pipeline_future_.Get();
+      }
+    });
     return pipeline_;
   }
 
@@ -137,7 +137,7 @@ class RenderPipelineHandle {
  private:
   PipelineFuture<PipelineDescriptor> pipeline_future_;
   std::shared_ptr<Pipeline<PipelineDescriptor>> pipeline_;
-  bool did_wait_ = false;
+  std::once_flag wait_flag_;
 
   RenderPipelineHandle(const RenderPipelineHandle&) = delete;
 
@@ -165,20 +165,18 @@ class ComputePipelineHandle {
       : pipeline_future_(std::move(future)) {}
 
   std::shared_ptr<Pipeline<ComputePipelineDescriptor>> WaitAndGet() {
-    if (did_wait_) {
-      return pipeline_;
-    }
-    did_wait_ = true;
-    if (pipeline_future_.IsValid()) {
-      pipeline_ = pipeline_future_.Get();
-    }
+    std::call_once(wait_flag_, [this]() {
+      if (pipeline_future_.IsValid()) {
+        pipeline_ = pipeline_future_.Get();
+      }
+    });
     return pipeline_;
   }
 
  private:
   PipelineFuture<ComputePipelineDescriptor> pipeline_future_;
   std::shared_ptr<Pipeline<ComputePipelineDescriptor>> pipeline_;
-  bool did_wait_ = false;
+  std::once_flag wait_flag_;
 
   ComputePipelineHandle(const ComputePipelineHandle&) = delete;
 
@@ -34,4 +34,12 @@ PipelineFuture<ComputePipelineDescriptor> PipelineLibrary::GetPipeline(
   return {descriptor, promise->get_future()};
 }
 
+std::unique_ptr<fml::Mapping> PipelineLibrary::LoadPipelineUsageProfile()
+    const {
+  return nullptr;
+}
+
+void PipelineLibrary::PersistPipelineUsageProfile(
+    std::shared_ptr<const fml::Mapping> profile) {}
+
 }  // namespace impeller
@@ -5,9 +5,11 @@
 #ifndef FLUTTER_IMPELLER_RENDERER_PIPELINE_LIBRARY_H_
 #define FLUTTER_IMPELLER_RENDERER_PIPELINE_LIBRARY_H_
 
+#include <memory>
 #include <optional>
 
 #include "compute_pipeline_descriptor.h"
+#include "flutter/fml/mapping.h"
 #include "impeller/renderer/pipeline.h"
 #include "impeller/renderer/pipeline_descriptor.h"
 
@@ -51,6 +53,24 @@ class PipelineLibrary : public std::enable_shared_from_this<PipelineLibrary> {
   virtual void RemovePipelinesWithEntryPoint(
       std::shared_ptr<const ShaderFunction> function) = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Read the pipeline usage profile that a previous run of the
+  ///             application persisted with `PersistPipelineUsageProfile`.
+  ///
+  /// @return     The profile, or null if there is none or the backend has no
+  ///             place to persist it.
+  ///
+  virtual std::unique_ptr<fml::Mapping> LoadPipelineUsageProfile() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Persist an opaque description of the pipelines that were used
+  ///             by the application alongside the pipeline cache of the
+  ///             backend, if it has one. The data may be written
+  ///             asynchronously.
+  ///
+  virtual void PersistPipelineUsageProfile(
+      std::shared_ptr<const fml::Mapping> profile);
+
  protected:
   PipelineLibrary();
 
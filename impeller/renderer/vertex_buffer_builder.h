@@ -111,7 +111,7 @@ class VertexBufferBuilder {
   BufferView CreateVertexBufferView(HostBuffer& buffer) const {
     return buffer.Emplace(vertices_.data(),
                           vertices_.size() * sizeof(VertexType),
-                          alignof(VertexType));
+                          alignof(VertexType), HostBuffer::DataKind::kVertex);
   }
 
   BufferView CreateVertexBufferView(Allocator& allocator) const {
@@ -136,7 +136,7 @@ class VertexBufferBuilder {
     }
     return buffer.Emplace(index_buffer.data(),
                           index_buffer.size() * sizeof(IndexType),
-                          alignof(IndexType));
+                          alignof(IndexType), HostBuffer::DataKind::kIndex);
   }
 
   BufferView CreateIndexBufferView(Allocator& allocator) const {
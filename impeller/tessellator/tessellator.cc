@@ -45,11 +45,11 @@ VertexBuffer Tessellator::TessellateConvex(const Path& path,
 
   BufferView vertex_buffer = host_buffer.Emplace(
       point_buffer_->data(), sizeof(Point) * point_buffer_->size(),
-      alignof(Point));
+      alignof(Point), HostBuffer::DataKind::kVertex);
 
   BufferView index_buffer = host_buffer.Emplace(
       index_buffer_->data(), sizeof(uint16_t) * index_buffer_->size(),
-      alignof(uint16_t));
+      alignof(uint16_t), HostBuffer::DataKind::kIndex);
 
   return VertexBuffer{
       .vertex_buffer = std::move(vertex_buffer),
@@ -4,9 +4,13 @@
 
 #include "impeller/typographer/backends/skia/typographer_context_skia.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -14,6 +18,7 @@
 #include "flutter/fml/trace_event.h"
 #include "fml/closure.h"
 
+#include "impeller/base/parallel_for_each.h"
 #include "impeller/core/allocator.h"
 #include "impeller/core/buffer_view.h"
 #include "impeller/core/formats.h"
@@ -79,8 +84,18 @@ std::shared_ptr<TypographerContext> TypographerContextSkia::Make() {
   return std::make_shared<TypographerContextSkia>();
 }
 
+std::shared_ptr<TypographerContext> TypographerContextSkia::Make(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  return std::make_shared<TypographerContextSkia>(
+      std::move(worker_task_runner));
+}
+
 TypographerContextSkia::TypographerContextSkia() = default;
 
+TypographerContextSkia::TypographerContextSkia(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+    : worker_task_runner_(std::move(worker_task_runner)) {}
+
 TypographerContextSkia::~TypographerContextSkia() = default;
 
 std::shared_ptr<GlyphAtlasContext>
@@ -99,111 +114,94 @@ static SkImageInfo GetImageInfo(const GlyphAtlas& atlas, Size size) {
   FML_UNREACHABLE();
 }
 
-/// Append as many glyphs to the texture as will fit, and return the first index
-/// of [extra_pairs] that did not fit.
-static size_t AppendToExistingAtlas(
-    const std::shared_ptr<GlyphAtlas>& atlas,
-    const std::vector<FontGlyphPair>& extra_pairs,
-    std::vector<Rect>& glyph_positions,
-    const std::vector<Rect>& glyph_sizes,
-    ISize atlas_size,
-    int64_t height_adjustment,
-    const std::shared_ptr<RectanglePacker>& rect_packer) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!rect_packer || atlas_size.IsEmpty()) {
-    return 0;
-  }
-
-  for (size_t i = 0; i < extra_pairs.size(); i++) {
+// Because we can't grow the skyline packer horizontally, pick a reasonable
+// large width for all atlas pages.
+static constexpr int64_t kAtlasWidth = 4096;
+static constexpr int64_t kMinAtlasHeight = 1024;
+
+// The number of pages that an atlas may use before the least recently used
+// page is evicted to make room for new glyphs.
+static constexpr size_t kMaxAtlasPages = 4u;
+
+/// Place as many glyphs into the open page of the atlas as will fit, starting
+/// at [start_index], and return the first index of [glyph_sizes] that did not
+/// fit.
+static size_t PlaceGlyphsInOpenPage(RectanglePacker& rect_packer,
+                                    int64_t height_adjustment,
+                                    std::vector<Rect>& glyph_positions,
+                                    const std::vector<Rect>& glyph_sizes,
+                                    size_t start_index) {
+  for (size_t i = start_index; i < glyph_sizes.size(); i++) {
     ISize glyph_size = ISize::Ceil(glyph_sizes[i].GetSize());
     IPoint16 location_in_atlas;
-    if (!rect_packer->AddRect(glyph_size.width + kPadding,   //
-                              glyph_size.height + kPadding,  //
-                              &location_in_atlas             //
-                              )) {
+    if (!rect_packer.AddRect(glyph_size.width + kPadding,   //
+                             glyph_size.height + kPadding,  //
+                             &location_in_atlas             //
+                             )) {
       return i;
     }
     // Position the glyph in the center of the 1px padding.
-    glyph_positions.push_back(Rect::MakeXYWH(
+    glyph_positions[i] = Rect::MakeXYWH(
         location_in_atlas.x() + 1,                      //
         location_in_atlas.y() + height_adjustment + 1,  //
         glyph_size.width,                               //
         glyph_size.height                               //
-        ));
+    );
   }
-
-  return extra_pairs.size();
+  return glyph_sizes.size();
 }
 
-static size_t PairsFitInAtlasOfSize(
-    const std::vector<FontGlyphPair>& pairs,
-    const ISize& atlas_size,
-    std::vector<Rect>& glyph_positions,
-    const std::vector<Rect>& glyph_sizes,
-    int64_t height_adjustment,
-    const std::shared_ptr<RectanglePacker>& rect_packer,
-    size_t start_index) {
-  FML_DCHECK(!atlas_size.IsEmpty());
-
-  for (size_t i = start_index; i < pairs.size(); i++) {
-    ISize glyph_size = ISize::Ceil(glyph_sizes[i].GetSize());
-    IPoint16 location_in_atlas;
-    if (!rect_packer->AddRect(glyph_size.width + kPadding,   //
-                              glyph_size.height + kPadding,  //
-                              &location_in_atlas             //
-                              )) {
-      return i;
-    }
-    glyph_positions.push_back(Rect::MakeXYWH(
-        location_in_atlas.x() + 1,                      //
-        location_in_atlas.y() + height_adjustment + 1,  //
-        glyph_size.width,                               //
-        glyph_size.height                               //
-        ));
+static int64_t GetTotalPageHeight(const GlyphAtlas& atlas) {
+  int64_t height = 0;
+  for (size_t page = 0; page < atlas.GetPageCount(); page++) {
+    height += atlas.GetTexture(page)->GetSize().height;
   }
-
-  return pairs.size();
+  return height;
 }
 
-static ISize ComputeNextAtlasSize(
-    const std::shared_ptr<GlyphAtlasContext>& atlas_context,
-    const std::vector<FontGlyphPair>& extra_pairs,
-    std::vector<Rect>& glyph_positions,
-    const std::vector<Rect>& glyph_sizes,
-    size_t glyph_index_start,
-    int64_t max_texture_height) {
-  // Because we can't grow the skyline packer horizontally, pick a reasonable
-  // large width for all atlases.
-  static constexpr int64_t kAtlasWidth = 4096;
-  static constexpr int64_t kMinAtlasHeight = 1024;
-
-  ISize current_size = ISize(kAtlasWidth, kMinAtlasHeight);
-  if (atlas_context->GetAtlasSize().height > current_size.height) {
-    current_size.height = atlas_context->GetAtlasSize().height * 2;
+static std::shared_ptr<Texture> CreateAtlasPageTexture(
+    Context& context,
+    GlyphAtlas::Type type,
+    ISize size,
+    HostBuffer& host_buffer,
+    BlitPass& blit_pass) {
+  TextureDescriptor descriptor;
+  switch (type) {
+    case GlyphAtlas::Type::kAlphaBitmap:
+      descriptor.format =
+          context.GetCapabilities()->GetDefaultGlyphAtlasFormat();
+      break;
+    case GlyphAtlas::Type::kColorBitmap:
+      descriptor.format = PixelFormat::kR8G8B8A8UNormInt;
+      break;
+  }
+  descriptor.size = size;
+  descriptor.storage_mode = StorageMode::kDevicePrivate;
+  descriptor.usage = TextureUsage::kShaderRead;
+  std::shared_ptr<Texture> texture =
+      context.GetResourceAllocator()->CreateTexture(descriptor);
+  if (!texture) {
+    return nullptr;
   }
 
-  auto height_adjustment = atlas_context->GetAtlasSize().height;
-  while (current_size.height <= max_texture_height) {
-    std::shared_ptr<RectanglePacker> rect_packer;
-    if (atlas_context->GetRectPacker() || glyph_index_start) {
-      rect_packer = RectanglePacker::Factory(
-          kAtlasWidth,
-          current_size.height - atlas_context->GetAtlasSize().height);
-    } else {
-      rect_packer = RectanglePacker::Factory(kAtlasWidth, current_size.height);
-    }
-    glyph_positions.erase(glyph_positions.begin() + glyph_index_start,
-                          glyph_positions.end());
-    atlas_context->UpdateRectPacker(rect_packer);
-    auto next_index = PairsFitInAtlasOfSize(
-        extra_pairs, current_size, glyph_positions, glyph_sizes,
-        height_adjustment, rect_packer, glyph_index_start);
-    if (next_index == extra_pairs.size()) {
-      return current_size;
-    }
-    current_size = ISize(current_size.width, current_size.height * 2);
+  texture->SetLabel("GlyphAtlas");
+
+  // The R8/A8 textures used for certain glyphs is not supported as color
+  // attachments in most graphics drivers. For other textures, most framebuffer
+  // attachments have a much smaller size limit than the max texture size.
+  {
+    TRACE_EVENT0("flutter", "ClearGlyphAtlas");
+    size_t byte_size =
+        texture->GetTextureDescriptor().GetByteSizeOfBaseMipLevel();
+    BufferView buffer_view =
+        host_buffer.Emplace(nullptr, byte_size, DefaultUniformAlignment());
+
+    ::memset(buffer_view.buffer->OnGetContents() + buffer_view.range.offset, 0,
+             byte_size);
+    buffer_view.buffer->Flush();
+    blit_pass.AddCopy(buffer_view, texture);
   }
-  return {};
+  return texture;
 }
 
 static void DrawGlyph(SkCanvas* canvas,
@@ -249,70 +247,116 @@ static void DrawGlyph(SkCanvas* canvas,
   );
 }
 
-static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
-                              std::shared_ptr<BlitPass>& blit_pass,
-                              HostBuffer& host_buffer,
-                              const std::shared_ptr<Texture>& texture,
-                              const std::vector<FontGlyphPair>& new_pairs,
-                              size_t start_index,
-                              size_t end_index) {
+// The number of glyphs that a worker rasterizes at a time. Glyph atlas
+// updates with fewer glyphs than this are rasterized on the calling thread.
+static constexpr size_t kGlyphsPerRasterTask = 16u;
+
+static bool UpdateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    GlyphAtlasContext& atlas_context,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner,
+    std::shared_ptr<BlitPass>& blit_pass,
+    HostBuffer& host_buffer,
+    const std::shared_ptr<Texture>& texture,
+    const std::vector<FontGlyphPair>& new_pairs,
+    const std::vector<Rect>& glyph_positions,
+    const std::vector<Rect>& glyph_sizes,
+    size_t start_index,
+    size_t end_index) {
   TRACE_EVENT0("impeller", __FUNCTION__);
 
   bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
-
+  size_t bytes_per_pixel =
+      BytesPerPixelForPixelFormat(texture->GetTextureDescriptor().format);
+  size_t alignment = DefaultUniformAlignment();
+
+  // Lay out the uploads of all glyphs in one staging allocation so that
+  // workers can fill in their glyphs without touching the host buffer.
+  struct GlyphUpload {
+    size_t index;
+    IRect region;
+    size_t offset;
+    size_t length;
+  };
+  std::vector<GlyphUpload> uploads;
+  uploads.reserve(end_index - start_index);
+  size_t staging_size = 0u;
   for (size_t i = start_index; i < end_index; i++) {
-    const FontGlyphPair& pair = new_pairs[i];
-    auto data = atlas.FindFontGlyphBounds(pair);
-    if (!data.has_value()) {
-      continue;
-    }
-    auto [pos, bounds] = data.value();
-    Size size = pos.GetSize();
-    if (size.IsEmpty()) {
+    const Rect& pos = glyph_positions[i];
+    if (pos.IsEmpty()) {
       continue;
     }
     // The uploaded bitmap is expanded by 1px of padding
     // on each side.
-    size.width += 2;
-    size.height += 2;
-
-    SkBitmap bitmap;
-    bitmap.setInfo(GetImageInfo(atlas, size));
-    if (!bitmap.tryAllocPixels()) {
-      return false;
-    }
-
-    auto surface = SkSurfaces::WrapPixels(bitmap.pixmap());
-    if (!surface) {
-      return false;
-    }
-    auto canvas = surface->getCanvas();
-    if (!canvas) {
-      return false;
-    }
-
-    DrawGlyph(canvas, pair.scaled_font, pair.glyph, bounds,
-              pair.glyph.properties, has_color);
-
-    // Writing to a malloc'd buffer and then copying to the staging buffers
-    // benchmarks as substantially faster on a number of Android devices.
-    BufferView buffer_view = host_buffer.Emplace(
-        bitmap.getAddr(0, 0),
-        size.Area() * BytesPerPixelForPixelFormat(
-                          atlas.GetTexture()->GetTextureDescriptor().format),
-        DefaultUniformAlignment());
+    IRect region = IRect::MakeXYWH(pos.GetLeft() - 1, pos.GetTop() - 1,
+                                   pos.GetWidth() + 2, pos.GetHeight() + 2);
+    size_t offset = (staging_size + alignment - 1) / alignment * alignment;
+    size_t length = region.Area() * bytes_per_pixel;
+    uploads.push_back({i, region, offset, length});
+    staging_size = offset + length;
+  }
+  if (uploads.empty()) {
+    return blit_pass->ConvertTextureToShaderRead(texture);
+  }
 
-    // convert_to_read is set to false so that the texture remains in a transfer
-    // dst layout until we finish writing to it below. This only has an impact
-    // on Vulkan where we are responsible for managing image layouts.
+  BufferView staging =
+      host_buffer.Emplace(nullptr, staging_size, DefaultUniformAlignment());
+  uint8_t* staging_contents =
+      staging.buffer->OnGetContents() + staging.range.offset;
+
+  // Each task draws its glyphs into a malloc'd tile that it reuses, and then
+  // copies them to the staging buffer. Writing to a malloc'd buffer and then
+  // copying to the staging buffers benchmarks as substantially faster on a
+  // number of Android devices.
+  std::atomic_bool success = true;
+  size_t chunk_count =
+      (uploads.size() + kGlyphsPerRasterTask - 1) / kGlyphsPerRasterTask;
+  ParallelForEach(
+      worker_task_runner, chunk_count, [&](size_t chunk) {
+        TRACE_EVENT0("impeller", "RasterizeGlyphs");
+        size_t begin = chunk * kGlyphsPerRasterTask;
+        size_t end = std::min(begin + kGlyphsPerRasterTask, uploads.size());
+        std::vector<uint8_t> tile;
+        for (size_t u = begin; u < end; u++) {
+          const GlyphUpload& upload = uploads[u];
+          const FontGlyphPair& pair = new_pairs[upload.index];
+          SkImageInfo info = GetImageInfo(
+              atlas, Size(upload.region.GetWidth(), upload.region.GetHeight()));
+          // The padding, and any pixels the glyph does not cover, may still
+          // hold the glyphs of an evicted page.
+          tile.assign(upload.length, 0u);
+          auto surface =
+              SkSurfaces::WrapPixels(info, tile.data(), info.minRowBytes());
+          if (!surface || !surface->getCanvas()) {
+            success = false;
+            return;
+          }
+          DrawGlyph(surface->getCanvas(), pair.scaled_font, pair.glyph,
+                    glyph_sizes[upload.index], pair.glyph.properties,
+                    has_color);
+          ::memcpy(staging_contents + upload.offset, tile.data(),
+                   upload.length);
+        }
+      });
+  if (!success) {
+    return false;
+  }
+  staging.buffer->Flush(staging.range);
+  atlas_context.RecordUpload(staging_size);
+
+  for (const GlyphUpload& upload : uploads) {
+    BufferView buffer_view{
+        staging.buffer,
+        Range(staging.range.offset + upload.offset, upload.length)};
+    // convert_to_read is set to false so that the texture remains in a
+    // transfer dst layout until we finish writing to it below. This only has
+    // an impact on Vulkan where we are responsible for managing image layouts.
     if (!blit_pass->AddCopy(std::move(buffer_view),  //
                             texture,                 //
-                            IRect::MakeXYWH(pos.GetLeft() - 1, pos.GetTop() - 1,
-                                            size.width, size.height),  //
-                            /*label=*/"",                              //
-                            /*slice=*/0,                               //
-                            /*convert_to_read=*/false                  //
-                            )) {
+                            upload.region,           //
+                            /*label=*/"",            //
+                            /*slice=*/0,             //
+                            /*convert_to_read=*/false)) {
       return false;
     }
   }
@@ -343,34 +387,19 @@ static Rect ComputeGlyphSize(const SkFont& font,
                         scaled_bounds.fBottom);
 };
 
-std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
-    Context& context,
-    GlyphAtlas::Type type,
-    HostBuffer& host_buffer,
-    const std::shared_ptr<GlyphAtlasContext>& atlas_context,
-    const FontGlyphMap& font_glyph_map) const {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!IsValid()) {
-    return nullptr;
-  }
-  std::shared_ptr<GlyphAtlas> last_atlas = atlas_context->GetGlyphAtlas();
-  FML_DCHECK(last_atlas->GetType() == type);
-
-  if (font_glyph_map.empty()) {
-    return last_atlas;
-  }
-
-  // ---------------------------------------------------------------------------
-  // Step 1: Determine if the atlas type and font glyph pairs are compatible
-  //         with the current atlas and reuse if possible. For each new font and
-  //         glyph pair, compute the glyph size at scale.
-  // ---------------------------------------------------------------------------
-  std::vector<Rect> glyph_sizes;
-  std::vector<FontGlyphPair> new_glyphs;
+/// Collect the glyphs of [font_glyph_map] that are missing from [atlas] along
+/// with their sizes at scale, and mark the pages holding the others as used.
+static void CollectNewGlyphs(const GlyphAtlas& atlas,
+                             GlyphAtlasContext& atlas_context,
+                             const FontGlyphMap& font_glyph_map,
+                             std::vector<FontGlyphPair>& new_glyphs,
+                             std::vector<Rect>& glyph_sizes) {
+  new_glyphs.clear();
+  glyph_sizes.clear();
   for (const auto& font_value : font_glyph_map) {
     const ScaledFont& scaled_font = font_value.first;
     const FontGlyphAtlas* font_glyph_atlas =
-        last_atlas->GetFontGlyphAtlas(scaled_font.font, scaled_font.scale);
+        atlas.GetFontGlyphAtlas(scaled_font.font, scaled_font.scale);
 
     auto metrics = scaled_font.font.GetMetrics();
 
@@ -388,7 +417,11 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
 
     if (font_glyph_atlas) {
       for (const SubpixelGlyph& glyph : font_value.second) {
-        if (!font_glyph_atlas->FindGlyphBounds(glyph)) {
+        const GlyphAtlasLocation* location =
+            font_glyph_atlas->FindGlyphLocation(glyph);
+        if (location) {
+          atlas_context.MarkPageUsed(location->page);
+        } else {
           new_glyphs.emplace_back(scaled_font, glyph);
           glyph_sizes.push_back(
               ComputeGlyphSize(sk_font, glyph, scaled_font.scale));
@@ -402,173 +435,210 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
       }
     }
   }
-  if (new_glyphs.size() == 0) {
-    return last_atlas;
-  }
-
-  // ---------------------------------------------------------------------------
-  // Step 2: Determine if the additional missing glyphs can be appended to the
-  //         existing bitmap without recreating the atlas.
-  // ---------------------------------------------------------------------------
-  std::vector<Rect> glyph_positions;
-  glyph_positions.reserve(new_glyphs.size());
-  size_t first_missing_index = 0;
-
-  if (last_atlas->GetTexture()) {
-    // Append all glyphs that fit into the current atlas.
-    first_missing_index = AppendToExistingAtlas(
-        last_atlas, new_glyphs, glyph_positions, glyph_sizes,
-        atlas_context->GetAtlasSize(), atlas_context->GetHeightAdjustment(),
-        atlas_context->GetRectPacker());
-
-    // ---------------------------------------------------------------------------
-    // Step 3a: Record the positions in the glyph atlas of the newly added
-    //          glyphs.
-    // ---------------------------------------------------------------------------
-    for (size_t i = 0; i < first_missing_index; i++) {
-      last_atlas->AddTypefaceGlyphPositionAndBounds(
-          new_glyphs[i], glyph_positions[i], glyph_sizes[i]);
-    }
-
-    std::shared_ptr<CommandBuffer> cmd_buffer = context.CreateCommandBuffer();
-    std::shared_ptr<BlitPass> blit_pass = cmd_buffer->CreateBlitPass();
-
-    fml::ScopedCleanupClosure closure([&]() {
-      blit_pass->EncodeCommands(context.GetResourceAllocator());
-      context.GetCommandQueue()->Submit({std::move(cmd_buffer)});
-    });
-
-    // ---------------------------------------------------------------------------
-    // Step 4a: Draw new font-glyph pairs into the a host buffer and encode
-    // the uploads into the blit pass.
-    // ---------------------------------------------------------------------------
-    if (!UpdateAtlasBitmap(*last_atlas, blit_pass, host_buffer,
-                           last_atlas->GetTexture(), new_glyphs, 0,
-                           first_missing_index)) {
-      return nullptr;
-    }
-
-    // If all glyphs fit, just return the old atlas.
-    if (first_missing_index == new_glyphs.size()) {
-      return last_atlas;
-    }
-  }
-
-  int64_t height_adjustment = atlas_context->GetAtlasSize().height;
-  const int64_t max_texture_height =
-      context.GetResourceAllocator()->GetMaxTextureSizeSupported().height;
-
-  // IF the current atlas size is as big as it can get, then "GC" and create an
-  // atlas with only the required glyphs. OpenGLES cannot reliably perform the
-  // blit required here, as 1) it requires attaching textures as read and write
-  // framebuffers which has substantially smaller size limits that max textures
-  // and 2) is missing a GLES 2.0 implementation and cap check.
-  bool blit_old_atlas = true;
-  std::shared_ptr<GlyphAtlas> new_atlas = last_atlas;
-  if (atlas_context->GetAtlasSize().height >= max_texture_height ||
-      context.GetBackendType() == Context::BackendType::kOpenGLES) {
-    blit_old_atlas = false;
-    first_missing_index = 0;
-    glyph_positions.clear();
-    height_adjustment = 0;
-    new_atlas = std::make_shared<GlyphAtlas>(type);
-    atlas_context->UpdateRectPacker(nullptr);
-    atlas_context->UpdateGlyphAtlas(new_atlas, {0, 0}, 0);
-  }
+}
 
-  // A new glyph atlas must be created.
-  ISize atlas_size = ComputeNextAtlasSize(atlas_context,        //
-                                          new_glyphs,           //
-                                          glyph_positions,      //
-                                          glyph_sizes,          //
-                                          first_missing_index,  //
-                                          max_texture_height    //
+static void TraceGlyphAtlasStatistics(const GlyphAtlasContext& atlas_context,
+                                      const GlyphAtlas& atlas) {
+  const GlyphAtlasContext::Statistics& statistics =
+      atlas_context.GetStatistics();
+  FML_TRACE_COUNTER("impeller",                                   //
+                    "GlyphAtlas",                                 //
+                    reinterpret_cast<int64_t>(&atlas_context),    //
+                    "Pages", atlas.GetPageCount(),                //
+                    "Rebuilds", statistics.rebuild_count,         //
+                    "Evictions", statistics.eviction_count,       //
+                    "UploadBytes", statistics.upload_bytes        //
   );
+}
 
-  atlas_context->UpdateGlyphAtlas(new_atlas, atlas_size, height_adjustment);
-  if (atlas_size.IsEmpty()) {
+std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
+    Context& context,
+    GlyphAtlas::Type type,
+    HostBuffer& host_buffer,
+    const std::shared_ptr<GlyphAtlasContext>& atlas_context,
+    const FontGlyphMap& font_glyph_map) const {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  if (!IsValid()) {
     return nullptr;
   }
-  FML_DCHECK(new_glyphs.size() == glyph_positions.size());
+  std::shared_ptr<GlyphAtlas> atlas = atlas_context->GetGlyphAtlas();
+  FML_DCHECK(atlas->GetType() == type);
 
-  TextureDescriptor descriptor;
-  switch (type) {
-    case GlyphAtlas::Type::kAlphaBitmap:
-      descriptor.format =
-          context.GetCapabilities()->GetDefaultGlyphAtlasFormat();
-      break;
-    case GlyphAtlas::Type::kColorBitmap:
-      descriptor.format = PixelFormat::kR8G8B8A8UNormInt;
-      break;
-  }
-  descriptor.size = atlas_size;
-  descriptor.storage_mode = StorageMode::kDevicePrivate;
-  descriptor.usage = TextureUsage::kShaderRead;
-  std::shared_ptr<Texture> new_texture =
-      context.GetResourceAllocator()->CreateTexture(descriptor);
-  if (!new_texture) {
-    return nullptr;
+  if (font_glyph_map.empty()) {
+    return atlas;
   }
 
-  new_texture->SetLabel("GlyphAtlas");
+  // ---------------------------------------------------------------------------
+  // Step 1: Determine if the font glyph pairs are already in the current atlas
+  //         and mark the pages they are on as used by this frame. For each new
+  //         font and glyph pair, compute the glyph size at scale.
+  // ---------------------------------------------------------------------------
+  atlas_context->AdvanceFrame();
+  std::vector<Rect> glyph_sizes;
+  std::vector<FontGlyphPair> new_glyphs;
+  CollectNewGlyphs(*atlas, *atlas_context, font_glyph_map, new_glyphs,
+                   glyph_sizes);
+  if (new_glyphs.size() == 0) {
+    return atlas;
+  }
 
   std::shared_ptr<CommandBuffer> cmd_buffer = context.CreateCommandBuffer();
   std::shared_ptr<BlitPass> blit_pass = cmd_buffer->CreateBlitPass();
 
-  // The R8/A8 textures used for certain glyphs is not supported as color
-  // attachments in most graphics drivers. For other textures, most framebuffer
-  // attachments have a much smaller size limit than the max texture size.
-  {
-    TRACE_EVENT0("flutter", "ClearGlyphAtlas");
-    size_t byte_size =
-        new_texture->GetTextureDescriptor().GetByteSizeOfBaseMipLevel();
-    BufferView buffer_view =
-        host_buffer.Emplace(nullptr, byte_size, DefaultUniformAlignment());
-
-    ::memset(buffer_view.buffer->OnGetContents() + buffer_view.range.offset, 0,
-             byte_size);
-    buffer_view.buffer->Flush();
-    blit_pass->AddCopy(buffer_view, new_texture);
-  }
-
   fml::ScopedCleanupClosure closure([&]() {
     blit_pass->EncodeCommands(context.GetResourceAllocator());
     context.GetCommandQueue()->Submit({std::move(cmd_buffer)});
   });
 
-  // Blit the old texture to the top left of the new atlas.
-  if (new_atlas->GetTexture() && blit_old_atlas) {
-    blit_pass->AddCopy(new_atlas->GetTexture(), new_texture,
-                       IRect::MakeSize(new_atlas->GetTexture()->GetSize()),
-                       {0, 0});
-  }
+  const int64_t max_texture_height =
+      context.GetResourceAllocator()->GetMaxTextureSizeSupported().height;
+  // Pages only grow beyond this height for glyphs that would not fit
+  // otherwise, so that evicting a page only discards part of the atlas.
+  const int64_t page_height_limit =
+      std::max(kMinAtlasHeight,
+               max_texture_height / static_cast<int64_t>(kMaxAtlasPages));
+  // OpenGLES cannot reliably perform the blit required to grow a page, as 1)
+  // it requires attaching textures as read and write framebuffers which has
+  // substantially smaller size limits that max textures and 2) is missing a
+  // GLES 2.0 implementation and cap check. New pages are added instead.
+  const bool can_grow_pages =
+      context.GetBackendType() != Context::BackendType::kOpenGLES;
+
+  std::vector<Rect> glyph_positions(new_glyphs.size());
+  bool rebuilt = false;
+  size_t start_index = 0;
+  while (start_index < new_glyphs.size()) {
+    // -------------------------------------------------------------------------
+    // Step 2: Append as many of the missing glyphs as fit to the open page of
+    //         the atlas, record their positions and draw them into a host
+    //         buffer to encode their uploads into the blit pass.
+    // -------------------------------------------------------------------------
+    size_t page = atlas_context->GetOpenPage();
+    std::shared_ptr<Texture> page_texture = atlas->GetTexture(page);
+    std::shared_ptr<RectanglePacker> rect_packer =
+        atlas_context->GetRectPacker();
+    if (page_texture && rect_packer) {
+      size_t end_index = PlaceGlyphsInOpenPage(
+          *rect_packer, atlas_context->GetHeightAdjustment(), glyph_positions,
+          glyph_sizes, start_index);
+      if (end_index > start_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+          atlas->AddTypefaceGlyphPositionAndBounds(
+              new_glyphs[i], glyph_positions[i], glyph_sizes[i], page);
+        }
+        if (!UpdateAtlasBitmap(*atlas, *atlas_context, worker_task_runner_,
+                               blit_pass, host_buffer, page_texture,
+                               new_glyphs, glyph_positions, glyph_sizes,
+                               start_index, end_index)) {
+          return nullptr;
+        }
+        atlas_context->MarkPageUsed(page);
+        start_index = end_index;
+        continue;
+      }
+    }
 
-  // Now append all remaining glyphs. This should never have any missing data...
-  new_atlas->SetTexture(std::move(new_texture));
+    // -------------------------------------------------------------------------
+    // Step 3: The open page is full. Make room for the remaining glyphs by,
+    //         in order of preference, growing the open page, adding a page,
+    //         evicting the least recently used page or, if every page is used
+    //         by this frame, rebuilding the atlas with only the glyphs of this
+    //         frame.
+    // -------------------------------------------------------------------------
+    const int64_t glyph_height =
+        ISize::Ceil(glyph_sizes[start_index].GetSize()).height + kPadding;
+    const int64_t free_height = max_texture_height - GetTotalPageHeight(*atlas);
+
+    // Step 3a: Grow the open page by blitting it into the top of a texture
+    //          of at least twice the height. Only glyphs that are too tall
+    //          for a page of the height limit grow a page past it.
+    if (can_grow_pages && page_texture) {
+      int64_t height = page_texture->GetSize().height;
+      int64_t max_height = glyph_height > page_height_limit
+                               ? height + free_height
+                               : page_height_limit;
+      int64_t new_height = height * 2;
+      while (new_height - height < glyph_height &&
+             new_height * 2 <= max_height) {
+        new_height *= 2;
+      }
+      if (new_height <= max_height && new_height - height <= free_height) {
+        ISize size(kAtlasWidth, new_height);
+        std::shared_ptr<Texture> texture = CreateAtlasPageTexture(
+            context, type, size, host_buffer, *blit_pass);
+        if (!texture) {
+          return nullptr;
+        }
+        blit_pass->AddCopy(page_texture, texture,
+                           IRect::MakeSize(page_texture->GetSize()), {0, 0});
+        atlas->SetTexture(page, std::move(texture));
+        atlas_context->UpdateRectPacker(
+            RectanglePacker::Factory(kAtlasWidth, size.height - height));
+        atlas_context->UpdateGlyphAtlas(atlas, size, height);
+        continue;
+      }
+    }
 
-  // ---------------------------------------------------------------------------
-  // Step 3a: Record the positions in the glyph atlas of the newly added
-  //          glyphs.
-  // ---------------------------------------------------------------------------
-  for (size_t i = first_missing_index; i < glyph_positions.size(); i++) {
-    new_atlas->AddTypefaceGlyphPositionAndBounds(
-        new_glyphs[i], glyph_positions[i], glyph_sizes[i]);
-  }
+    // Step 3b: Add a new page.
+    if (atlas->GetPageCount() < kMaxAtlasPages &&
+        free_height >= kMinAtlasHeight) {
+      int64_t height = atlas->GetPageCount() == 0 || can_grow_pages
+                           ? kMinAtlasHeight
+                           : page_height_limit;
+      while (height < glyph_height && height * 2 <= free_height) {
+        height *= 2;
+      }
+      height = std::min(height, free_height);
+      ISize size(kAtlasWidth, height);
+      std::shared_ptr<Texture> texture =
+          CreateAtlasPageTexture(context, type, size, host_buffer, *blit_pass);
+      if (!texture) {
+        return nullptr;
+      }
+      size_t new_page = atlas->GetPageCount();
+      atlas->SetTexture(new_page, std::move(texture));
+      atlas_context->UpdateRectPacker(
+          RectanglePacker::Factory(kAtlasWidth, height));
+      atlas_context->UpdateGlyphAtlas(atlas, size, 0);
+      atlas_context->UpdateOpenPage(new_page);
+      atlas_context->MarkPageUsed(new_page);
+      continue;
+    }
 
-  // ---------------------------------------------------------------------------
-  // Step 4a: Draw new font-glyph pairs into the a host buffer and encode
-  // the uploads into the blit pass.
-  // ---------------------------------------------------------------------------
-  if (!UpdateAtlasBitmap(*new_atlas, blit_pass, host_buffer,
-                         new_atlas->GetTexture(), new_glyphs,
-                         first_missing_index, new_glyphs.size())) {
-    return nullptr;
+    // Step 3c: Evict the least recently used page that this frame does not
+    //          use and repack it with the remaining glyphs.
+    std::optional<size_t> victim =
+        atlas_context->GetLeastRecentlyUsedPage(atlas->GetPageCount());
+    if (victim.has_value()) {
+      atlas->EvictPage(victim.value());
+      atlas_context->RecordEviction();
+      ISize size = atlas->GetTexture(victim.value())->GetSize();
+      atlas_context->UpdateRectPacker(
+          RectanglePacker::Factory(size.width, size.height));
+      atlas_context->UpdateGlyphAtlas(atlas, size, 0);
+      atlas_context->UpdateOpenPage(victim.value());
+      atlas_context->MarkPageUsed(victim.value());
+      continue;
+    }
+
+    // Step 3d: Rebuild the atlas from scratch, which discards the glyphs of
+    //          earlier frames and packs those of this frame tightly.
+    if (rebuilt) {
+      return nullptr;
+    }
+    rebuilt = true;
+    atlas_context->RecordRebuild();
+    atlas = std::make_shared<GlyphAtlas>(type);
+    atlas_context->UpdateRectPacker(nullptr);
+    atlas_context->UpdateGlyphAtlas(atlas, {0, 0}, 0);
+    CollectNewGlyphs(*atlas, *atlas_context, font_glyph_map, new_glyphs,
+                     glyph_sizes);
+    glyph_positions.assign(new_glyphs.size(), Rect());
+    start_index = 0;
   }
-  // ---------------------------------------------------------------------------
-  // Step 8b: Record the texture in the glyph atlas.
-  // ---------------------------------------------------------------------------
 
-  return new_atlas;
+  TraceGlyphAtlasStatistics(*atlas_context, *atlas);
+  return atlas;
 }
 
 }  // namespace impeller
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_TYPOGRAPHER_CONTEXT_SKIA_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_TYPOGRAPHER_CONTEXT_SKIA_H_
 
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "impeller/typographer/typographer_context.h"
 
 namespace impeller {
@@ -13,8 +16,22 @@ class TypographerContextSkia : public TypographerContext {
  public:
   static std::shared_ptr<TypographerContext> Make();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Create a typographer context that rasterizes the glyphs added
+  ///             to an atlas on the given worker task runner.
+  ///
+  /// @param[in]  worker_task_runner  The task runner of a pool of worker
+  ///                                 threads, or nullptr to rasterize glyphs
+  ///                                 on the calling thread.
+  ///
+  static std::shared_ptr<TypographerContext> Make(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
   TypographerContextSkia();
 
+  explicit TypographerContextSkia(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
   ~TypographerContextSkia() override;
 
   // |TypographerContext|
@@ -30,6 +47,8 @@ class TypographerContextSkia : public TypographerContext {
       const FontGlyphMap& font_glyph_map) const override;
 
  private:
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+
   TypographerContextSkia(const TypographerContextSkia&) = delete;
 
   TypographerContextSkia& operator=(const TypographerContextSkia&) = delete;
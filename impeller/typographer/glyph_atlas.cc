@@ -7,8 +7,12 @@
 #include <numeric>
 #include <utility>
 
+#include "flutter/fml/logging.h"
+
 namespace impeller {
 
+static const std::shared_ptr<Texture> kNullTexture = nullptr;
+
 GlyphAtlasContext::GlyphAtlasContext(GlyphAtlas::Type type)
     : atlas_(std::make_shared<GlyphAtlas>(type)), atlas_size_(ISize(0, 0)) {}
 
@@ -33,6 +37,10 @@ std::shared_ptr<RectanglePacker> GlyphAtlasContext::GetRectPacker() const {
 void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas,
                                          ISize size,
                                          int64_t height_adjustment) {
+  if (atlas != atlas_) {
+    open_page_ = 0u;
+    page_last_used_.clear();
+  }
   atlas_ = std::move(atlas);
   atlas_size_ = size;
   height_adjustment_ = height_adjustment;
@@ -43,12 +51,63 @@ void GlyphAtlasContext::UpdateRectPacker(
   rect_packer_ = std::move(rect_packer);
 }
 
+size_t GlyphAtlasContext::GetOpenPage() const {
+  return open_page_;
+}
+
+void GlyphAtlasContext::UpdateOpenPage(size_t page) {
+  open_page_ = page;
+}
+
+void GlyphAtlasContext::AdvanceFrame() {
+  frame_++;
+  statistics_.upload_bytes = 0u;
+}
+
+void GlyphAtlasContext::MarkPageUsed(size_t page) {
+  if (page >= page_last_used_.size()) {
+    page_last_used_.resize(page + 1, 0u);
+  }
+  page_last_used_[page] = frame_;
+}
+
+std::optional<size_t> GlyphAtlasContext::GetLeastRecentlyUsedPage(
+    size_t page_count) const {
+  std::optional<size_t> result;
+  uint64_t oldest = frame_;
+  for (size_t page = 0; page < page_count; page++) {
+    uint64_t last_used =
+        page < page_last_used_.size() ? page_last_used_[page] : 0u;
+    if (last_used < oldest) {
+      oldest = last_used;
+      result = page;
+    }
+  }
+  return result;
+}
+
+const GlyphAtlasContext::Statistics& GlyphAtlasContext::GetStatistics() const {
+  return statistics_;
+}
+
+void GlyphAtlasContext::RecordRebuild() {
+  statistics_.rebuild_count++;
+}
+
+void GlyphAtlasContext::RecordEviction() {
+  statistics_.eviction_count++;
+}
+
+void GlyphAtlasContext::RecordUpload(size_t bytes) {
+  statistics_.upload_bytes += bytes;
+}
+
 GlyphAtlas::GlyphAtlas(Type type) : type_(type) {}
 
 GlyphAtlas::~GlyphAtlas() = default;
 
 bool GlyphAtlas::IsValid() const {
-  return !!texture_;
+  return !textures_.empty() && !!textures_[0];
 }
 
 GlyphAtlas::Type GlyphAtlas::GetType() const {
@@ -56,18 +115,58 @@ GlyphAtlas::Type GlyphAtlas::GetType() const {
 }
 
 const std::shared_ptr<Texture>& GlyphAtlas::GetTexture() const {
-  return texture_;
+  return GetTexture(0u);
+}
+
+const std::shared_ptr<Texture>& GlyphAtlas::GetTexture(size_t page) const {
+  return page < textures_.size() ? textures_[page] : kNullTexture;
+}
+
+size_t GlyphAtlas::GetPageCount() const {
+  return textures_.size();
 }
 
 void GlyphAtlas::SetTexture(std::shared_ptr<Texture> texture) {
-  texture_ = std::move(texture);
+  SetTexture(0u, std::move(texture));
+}
+
+void GlyphAtlas::SetTexture(size_t page, std::shared_ptr<Texture> texture) {
+  FML_DCHECK(page <= textures_.size());
+  if (page == textures_.size()) {
+    textures_.push_back(std::move(texture));
+  } else {
+    textures_[page] = std::move(texture);
+  }
 }
 
 void GlyphAtlas::AddTypefaceGlyphPositionAndBounds(const FontGlyphPair& pair,
                                                    Rect position,
-                                                   Rect bounds) {
+                                                   Rect bounds,
+                                                   size_t page) {
   font_atlas_map_[pair.scaled_font].positions_[pair.glyph] =
-      std::make_pair(position, bounds);
+      GlyphAtlasLocation{position, bounds, page};
+}
+
+size_t GlyphAtlas::EvictPage(size_t page) {
+  size_t count = 0u;
+  for (auto font_it = font_atlas_map_.begin();
+       font_it != font_atlas_map_.end();) {
+    auto& positions = font_it->second.positions_;
+    for (auto it = positions.begin(); it != positions.end();) {
+      if (it->second.page == page) {
+        it = positions.erase(it);
+        count++;
+      } else {
+        ++it;
+      }
+    }
+    if (positions.empty()) {
+      font_it = font_atlas_map_.erase(font_it);
+    } else {
+      ++font_it;
+    }
+  }
+  return count;
 }
 
 std::optional<std::pair<Rect, Rect>> GlyphAtlas::FindFontGlyphBounds(
@@ -108,7 +207,7 @@ size_t GlyphAtlas::IterateGlyphs(
     for (const auto& glyph_value : font_value.second.positions_) {
       count++;
       if (!iterator(font_value.first, glyph_value.first,
-                    glyph_value.second.first)) {
+                    glyph_value.second.position)) {
         return count;
       }
     }
@@ -118,11 +217,20 @@ size_t GlyphAtlas::IterateGlyphs(
 
 std::optional<std::pair<Rect, Rect>> FontGlyphAtlas::FindGlyphBounds(
     const SubpixelGlyph& glyph) const {
+  const GlyphAtlasLocation* location = FindGlyphLocation(glyph);
+  if (!location) {
+    return std::nullopt;
+  }
+  return std::make_pair(location->position, location->bounds);
+}
+
+const GlyphAtlasLocation* FontGlyphAtlas::FindGlyphLocation(
+    const SubpixelGlyph& glyph) const {
   const auto& found = positions_.find(glyph);
   if (found == positions_.end()) {
-    return std::nullopt;
+    return nullptr;
   }
-  return found->second;
+  return &found->second;
 }
 
 }  // namespace impeller
@@ -9,6 +9,7 @@
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "impeller/core/texture.h"
 #include "impeller/geometry/rect.h"
@@ -20,9 +21,25 @@ namespace impeller {
 class FontGlyphAtlas;
 
 //------------------------------------------------------------------------------
-/// @brief      A texture containing the bitmap representation of glyphs in
-///             different fonts along with the ability to query the location of
-///             specific font glyphs within the texture.
+/// @brief      The location of a glyph within a glyph atlas.
+///
+struct GlyphAtlasLocation {
+  /// The position of the glyph in the texture of its page.
+  Rect position;
+  /// The bounds of the glyph at scale.
+  Rect bounds;
+  /// The index of the atlas page that contains the glyph.
+  size_t page = 0u;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      One or more textures containing the bitmap representation of
+///             glyphs in different fonts along with the ability to query the
+///             location of specific font glyphs within the textures.
+///
+///             Each texture is a page of the atlas. Glyphs never span pages,
+///             so all the glyphs on one page can be drawn with a single
+///             texture binding.
 ///
 class GlyphAtlas {
  public:
@@ -61,30 +78,66 @@ class GlyphAtlas {
   Type GetType() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Set the texture for the glyph atlas.
+  /// @brief      Set the texture for the first page of the glyph atlas.
   ///
   /// @param[in]  texture  The texture
   ///
   void SetTexture(std::shared_ptr<Texture> texture);
 
   //----------------------------------------------------------------------------
-  /// @brief      Get the texture for the glyph atlas.
+  /// @brief      Set the texture for a page of the glyph atlas.
+  ///
+  /// @param[in]  page     The page index. This may be the current page count
+  ///                      to add a new page.
+  /// @param[in]  texture  The texture
+  ///
+  void SetTexture(size_t page, std::shared_ptr<Texture> texture);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the texture for the first page of the glyph atlas.
   ///
   /// @return     The texture.
   ///
   const std::shared_ptr<Texture>& GetTexture() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get the texture for a page of the glyph atlas.
+  ///
+  /// @param[in]  page  The page index.
+  ///
+  /// @return     The texture, or nullptr if there is no such page.
+  ///
+  const std::shared_ptr<Texture>& GetTexture(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the number of pages (textures) in the glyph atlas.
+  ///
+  size_t GetPageCount() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Record the location of a specific font-glyph pair within the
   ///             atlas.
   ///
   /// @param[in]  pair  The font-glyph pair
-  /// @param[in]  rect  The position in the atlas
+  /// @param[in]  rect  The position in the atlas page
   /// @param[in]  bounds The bounds of the glyph at scale
+  /// @param[in]  page  The page that the glyph was placed on
   ///
   void AddTypefaceGlyphPositionAndBounds(const FontGlyphPair& pair,
                                          Rect position,
-                                         Rect bounds);
+                                         Rect bounds,
+                                         size_t page = 0u);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget all of the glyphs that were placed on a page so that
+  ///             the page can be packed with other glyphs. The texture of the
+  ///             page is kept.
+  ///
+  /// @param[in]  page  The page index.
+  ///
+  /// @return     The number of glyphs removed.
+  ///
+  size_t EvictPage(size_t page);
 
   //----------------------------------------------------------------------------
   /// @brief      Get the number of unique font-glyph pairs in this atlas.
@@ -134,7 +187,7 @@ class GlyphAtlas {
 
  private:
   const Type type_;
-  std::shared_ptr<Texture> texture_;
+  std::vector<std::shared_ptr<Texture>> textures_;
 
   std::unordered_map<ScaledFont, FontGlyphAtlas> font_atlas_map_;
 
@@ -182,11 +235,62 @@ class GlyphAtlasContext {
 
   void UpdateRectPacker(std::shared_ptr<RectanglePacker> rect_packer);
 
+  //----------------------------------------------------------------------------
+  /// @brief      The page of the atlas that new glyphs are appended to. The
+  ///             atlas size, rect packer and height adjustment all describe
+  ///             this page.
+  size_t GetOpenPage() const;
+
+  void UpdateOpenPage(size_t page);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Start tracking the page usage and statistics of a new frame.
+  void AdvanceFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark a page as holding glyphs that are used by the current
+  ///             frame.
+  void MarkPageUsed(size_t page);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find the page that was least recently used, ignoring pages
+  ///             that are used by the current frame.
+  ///
+  /// @param[in]  page_count  The number of pages in the atlas.
+  ///
+  /// @return     The page, or `std::nullopt` if all pages are in use.
+  ///
+  std::optional<size_t> GetLeastRecentlyUsedPage(size_t page_count) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counters describing the work done to keep the atlas up to
+  ///             date.
+  struct Statistics {
+    /// The number of times all glyphs were discarded to rebuild the atlas.
+    size_t rebuild_count = 0u;
+    /// The number of pages that were evicted to make room for new glyphs.
+    size_t eviction_count = 0u;
+    /// The number of bytes uploaded to the atlas in the current frame.
+    size_t upload_bytes = 0u;
+  };
+
+  const Statistics& GetStatistics() const;
+
+  void RecordRebuild();
+
+  void RecordEviction();
+
+  void RecordUpload(size_t bytes);
+
  private:
   std::shared_ptr<GlyphAtlas> atlas_;
   ISize atlas_size_;
   std::shared_ptr<RectanglePacker> rect_packer_;
-  int64_t height_adjustment_;
+  int64_t height_adjustment_ = 0;
+  size_t open_page_ = 0u;
+  uint64_t frame_ = 0u;
+  std::vector<uint64_t> page_last_used_;
+  Statistics statistics_;
 
   GlyphAtlasContext(const GlyphAtlasContext&) = delete;
 
@@ -212,9 +316,21 @@ class FontGlyphAtlas {
   std::optional<std::pair<Rect, Rect>> FindGlyphBounds(
       const SubpixelGlyph& glyph) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find the location of a glyph in the atlas, including the
+  ///             page that holds it.
+  ///
+  /// @param[in]  glyph The glyph
+  ///
+  /// @return     The location of the glyph in the atlas, or nullptr if the
+  ///             glyph is not in the atlas. The pointer is only valid until
+  ///             the atlas is next updated.
+  ///
+  const GlyphAtlasLocation* FindGlyphLocation(const SubpixelGlyph& glyph) const;
+
  private:
   friend class GlyphAtlas;
-  std::unordered_map<SubpixelGlyph, std::pair<Rect, Rect>> positions_;
+  std::unordered_map<SubpixelGlyph, GlyphAtlasLocation> positions_;
 
   FontGlyphAtlas(const FontGlyphAtlas&) = delete;
 
@@ -55,6 +55,7 @@ const std::shared_ptr<GlyphAtlas>& LazyGlyphAtlas::CreateOrGetGlyphAtlas(
     Context& context,
     HostBuffer& host_buffer,
     GlyphAtlas::Type type) const {
+  Lock lock(atlas_mutex_);
   {
     if (type == GlyphAtlas::Type::kAlphaBitmap && alpha_atlas_) {
       return alpha_atlas_;
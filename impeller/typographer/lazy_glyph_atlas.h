@@ -5,6 +5,7 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_LAZY_GLYPH_ATLAS_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_LAZY_GLYPH_ATLAS_H_
 
+#include "impeller/base/thread.h"
 #include "impeller/renderer/context.h"
 #include "impeller/typographer/glyph_atlas.h"
 #include "impeller/typographer/text_frame.h"
@@ -26,6 +27,11 @@ class LazyGlyphAtlas {
 
   void ResetTextFrames();
 
+  /// Create the atlas of the given type for the text frames of this frame, or
+  /// return the one that was already created.
+  ///
+  /// May be called from several threads at once while text frames are not
+  /// being added or reset.
   const std::shared_ptr<GlyphAtlas>& CreateOrGetGlyphAtlas(
       Context& context,
       HostBuffer& host_buffer,
@@ -38,6 +44,7 @@ class LazyGlyphAtlas {
   FontGlyphMap color_glyph_map_;
   std::shared_ptr<GlyphAtlasContext> alpha_context_;
   std::shared_ptr<GlyphAtlasContext> color_context_;
+  mutable Mutex atlas_mutex_;
   mutable std::shared_ptr<GlyphAtlas> alpha_atlas_;
   mutable std::shared_ptr<GlyphAtlas> color_atlas_;
 
@@ -5,9 +5,11 @@
 #include "impeller/typographer/rectangle_packer.h"
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "flutter/fml/logging.h"
+#include "impeller/geometry/rect.h"
 
 namespace impeller {
 
@@ -29,10 +31,17 @@ class SkylineRectanglePacker final : public RectanglePacker {
 
   bool AddRect(int w, int h, IPoint16* loc) final;
 
+  bool RemoveRect(int w, int h, IPoint16 loc) final;
+
   Scalar PercentFull() const final {
     return area_so_far_ / ((float)width() * height());
   }
 
+ protected:
+  int64_t UsedArea() const final { return area_so_far_; }
+
+  int64_t LargestFreeArea() const final;
+
  private:
   struct SkylineSegment {
     int x_;
@@ -56,6 +65,8 @@ class SkylineRectanglePacker final : public RectanglePacker {
                        int y,
                        int width,
                        int height);
+  // Merge neighboring skyline segments of the same height.
+  void MergeSkylineLevels();
 };
 
 bool SkylineRectanglePacker::AddRect(int p_width, int p_height, IPoint16* loc) {
@@ -161,7 +172,10 @@ void SkylineRectanglePacker::AddSkylineLevel(size_t skyline_index,
     }
   }
 
-  // merge skylines
+  MergeSkylineLevels();
+}
+
+void SkylineRectanglePacker::MergeSkylineLevels() {
   for (auto i = 0u; i < skyline_.size() - 1; ++i) {
     if (skyline_[i].y_ == skyline_[i + 1].y_) {
       skyline_[i].width_ += skyline_[i + 1].width_;
@@ -171,9 +185,424 @@ void SkylineRectanglePacker::AddSkylineLevel(size_t skyline_index,
   }
 }
 
+bool SkylineRectanglePacker::RemoveRect(int p_width,
+                                        int p_height,
+                                        IPoint16 loc) {
+  int left = loc.x();
+  int right = left + p_width;
+  int top = loc.y() + p_height;
+  if (p_width <= 0 || p_height <= 0 || left < 0 || loc.y() < 0 ||
+      right > width() || top > height()) {
+    return false;
+  }
+
+  // The area below the skyline can't be tracked, so the rect can only be
+  // freed if nothing was placed on top of it.
+  for (const auto& segment : skyline_) {
+    if (segment.x_ < right && segment.x_ + segment.width_ > left &&
+        segment.y_ != top) {
+      return false;
+    }
+  }
+
+  // Lower the skyline to the bottom of the rect, splitting the segments that
+  // extend past its left or right side.
+  std::vector<SkylineSegment> skyline;
+  skyline.reserve(skyline_.size() + 2);
+  for (const auto& segment : skyline_) {
+    int segment_right = segment.x_ + segment.width_;
+    if (segment.x_ >= right || segment_right <= left) {
+      skyline.push_back(segment);
+      continue;
+    }
+    if (segment.x_ < left) {
+      skyline.push_back(SkylineSegment{segment.x_, segment.y_,  //
+                                       left - segment.x_});
+    }
+    int lowered_left = std::max(segment.x_, left);
+    int lowered_right = std::min(segment_right, right);
+    skyline.push_back(SkylineSegment{lowered_left, loc.y(),  //
+                                     lowered_right - lowered_left});
+    if (segment_right > right) {
+      skyline.push_back(SkylineSegment{right, segment.y_,  //
+                                       segment_right - right});
+    }
+  }
+  skyline_.swap(skyline);
+  MergeSkylineLevels();
+
+  area_so_far_ -= p_width * p_height;
+  return true;
+}
+
+int64_t SkylineRectanglePacker::LargestFreeArea() const {
+  // The largest rect that fits starts at the left of one of the segments and
+  // sits on the highest segment that it spans.
+  int64_t largest = 0;
+  for (auto i = 0u; i < skyline_.size(); ++i) {
+    int y = skyline_[i].y_;
+    int64_t span = 0;
+    for (auto j = i; j < skyline_.size(); ++j) {
+      y = std::max(y, skyline_[j].y_);
+      span += skyline_[j].width_;
+      largest = std::max(largest, span * (height() - y));
+    }
+  }
+  return largest;
+}
+
+// Packs rectangles into the maximal free rectangles of the area, which may
+// overlap each other, choosing the free rectangle that leaves the shortest
+// side free (Best Short Side Fit).
+// Based on Jukka Jylanki's "A Thousand Ways to Pack the Bin".
+class MaxRectsRectanglePacker final : public RectanglePacker {
+ public:
+  MaxRectsRectanglePacker(int w, int h) : RectanglePacker(w, h) { Reset(); }
+
+  ~MaxRectsRectanglePacker() final {}
+
+  void Reset() final {
+    area_so_far_ = 0;
+    free_rects_.clear();
+    free_rects_.push_back(IRect::MakeXYWH(0, 0, width(), height()));
+  }
+
+  bool AddRect(int w, int h, IPoint16* loc) final;
+
+  bool RemoveRect(int w, int h, IPoint16 loc) final;
+
+  Scalar PercentFull() const final {
+    return area_so_far_ / ((float)width() * height());
+  }
+
+ protected:
+  int64_t UsedArea() const final { return area_so_far_; }
+
+  int64_t LargestFreeArea() const final {
+    int64_t largest = 0;
+    for (const auto& free_rect : free_rects_) {
+      largest = std::max(largest, free_rect.Area());
+    }
+    return largest;
+  }
+
+ private:
+  std::vector<IRect> free_rects_;
+
+  int64_t area_so_far_;
+
+  // Replace every free rect that overlaps |used| by the up to four maximal
+  // rects of its area around |used|.
+  void SplitFreeRects(const IRect& used);
+  // Add |rects| to the free rects, leaving out every rect that is contained
+  // in another one. The free rects are never contained in each other, so only
+  // the added rects need to be compared with the others.
+  void AddFreeRects(const std::vector<IRect>& rects);
+};
+
+bool MaxRectsRectanglePacker::AddRect(int p_width,
+                                      int p_height,
+                                      IPoint16* loc) {
+  loc->x_ = 0;
+  loc->y_ = 0;
+  if (p_width <= 0 || p_height <= 0 || p_width > width() ||
+      p_height > height()) {
+    return false;
+  }
+
+  int64_t best_short_side = std::numeric_limits<int64_t>::max();
+  int64_t best_long_side = std::numeric_limits<int64_t>::max();
+  const IRect* best = nullptr;
+  for (const auto& free_rect : free_rects_) {
+    int64_t leftover_x = free_rect.GetWidth() - p_width;
+    int64_t leftover_y = free_rect.GetHeight() - p_height;
+    if (leftover_x < 0 || leftover_y < 0) {
+      continue;
+    }
+    int64_t short_side = std::min(leftover_x, leftover_y);
+    int64_t long_side = std::max(leftover_x, leftover_y);
+    if (short_side < best_short_side ||
+        (short_side == best_short_side && long_side < best_long_side)) {
+      best = &free_rect;
+      best_short_side = short_side;
+      best_long_side = long_side;
+    }
+  }
+  if (best == nullptr) {
+    return false;
+  }
+
+  IRect used =
+      IRect::MakeXYWH(best->GetX(), best->GetY(), p_width, p_height);
+  SplitFreeRects(used);
+
+  loc->x_ = static_cast<int16_t>(used.GetX());
+  loc->y_ = static_cast<int16_t>(used.GetY());
+  area_so_far_ += used.Area();
+  return true;
+}
+
+bool MaxRectsRectanglePacker::RemoveRect(int p_width,
+                                         int p_height,
+                                         IPoint16 loc) {
+  IRect freed = IRect::MakeXYWH(loc.x(), loc.y(), p_width, p_height);
+  if (freed.IsEmpty() ||
+      !IRect::MakeXYWH(0, 0, width(), height()).Contains(freed)) {
+    return false;
+  }
+
+  // Grow the freed rect over the free rects that share a whole side with it,
+  // so that the freed area joins up with the free area around it.
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (const auto& free_rect : free_rects_) {
+      bool same_rows = free_rect.GetY() == freed.GetY() &&
+                       free_rect.GetBottom() == freed.GetBottom();
+      bool same_columns = free_rect.GetX() == freed.GetX() &&
+                          free_rect.GetRight() == freed.GetRight();
+      if ((same_rows && (free_rect.GetRight() == freed.GetX() ||
+                         free_rect.GetX() == freed.GetRight())) ||
+          (same_columns && (free_rect.GetBottom() == freed.GetY() ||
+                            free_rect.GetY() == freed.GetBottom()))) {
+        freed = freed.Union(free_rect);
+        merged = true;
+      }
+    }
+  }
+  AddFreeRects({freed});
+
+  area_so_far_ -= static_cast<int64_t>(p_width) * p_height;
+  return true;
+}
+
+void MaxRectsRectanglePacker::SplitFreeRects(const IRect& used) {
+  std::vector<IRect> split_rects;
+  size_t kept = 0u;
+  for (size_t i = 0; i < free_rects_.size(); i++) {
+    const IRect free_rect = free_rects_[i];
+    if (!free_rect.IntersectsWithRect(used)) {
+      free_rects_[kept++] = free_rect;
+      continue;
+    }
+    if (used.GetX() > free_rect.GetX()) {
+      split_rects.push_back(IRect::MakeLTRB(free_rect.GetX(), free_rect.GetY(),
+                                            used.GetX(),
+                                            free_rect.GetBottom()));
+    }
+    if (used.GetRight() < free_rect.GetRight()) {
+      split_rects.push_back(IRect::MakeLTRB(used.GetRight(), free_rect.GetY(),
+                                            free_rect.GetRight(),
+                                            free_rect.GetBottom()));
+    }
+    if (used.GetY() > free_rect.GetY()) {
+      split_rects.push_back(IRect::MakeLTRB(free_rect.GetX(), free_rect.GetY(),
+                                            free_rect.GetRight(),
+                                            used.GetY()));
+    }
+    if (used.GetBottom() < free_rect.GetBottom()) {
+      split_rects.push_back(IRect::MakeLTRB(free_rect.GetX(), used.GetBottom(),
+                                            free_rect.GetRight(),
+                                            free_rect.GetBottom()));
+    }
+  }
+  free_rects_.resize(kept);
+  AddFreeRects(split_rects);
+}
+
+void MaxRectsRectanglePacker::AddFreeRects(const std::vector<IRect>& rects) {
+  size_t old_count = free_rects_.size();
+  for (size_t i = 0; i < rects.size(); i++) {
+    const IRect& rect = rects[i];
+    bool contained = false;
+    // Of several equal rects, only the first one is added.
+    for (size_t j = 0; j < rects.size() && !contained; j++) {
+      contained = j != i && rects[j].Contains(rect) &&  //
+                  (j < i || !(rects[j] == rect));
+    }
+    for (size_t j = 0; j < old_count && !contained; j++) {
+      contained = free_rects_[j].Contains(rect);
+    }
+    if (!contained) {
+      free_rects_.push_back(rect);
+    }
+  }
+
+  auto old_end = free_rects_.begin() + old_count;
+  auto kept_end = std::remove_if(
+      free_rects_.begin(), old_end, [this, old_end](const IRect& free_rect) {
+        return std::any_of(old_end, free_rects_.end(),
+                           [&free_rect](const IRect& added) {
+                             return added.Contains(free_rect);
+                           });
+      });
+  free_rects_.erase(kept_end, old_end);
+}
+
+// Packs rectangles into disjoint free rectangles. Each rectangle is placed in
+// the free rectangle that it fills the most of, and the rest of that free
+// rectangle is cut in two along the shorter leftover axis. Free rectangles
+// that line up are merged again so that large areas stay available.
+class GuillotineRectanglePacker final : public RectanglePacker {
+ public:
+  GuillotineRectanglePacker(int w, int h) : RectanglePacker(w, h) { Reset(); }
+
+  ~GuillotineRectanglePacker() final {}
+
+  void Reset() final {
+    area_so_far_ = 0;
+    free_rects_.clear();
+    free_rects_.push_back(IRect::MakeXYWH(0, 0, width(), height()));
+  }
+
+  bool AddRect(int w, int h, IPoint16* loc) final;
+
+  bool RemoveRect(int w, int h, IPoint16 loc) final;
+
+  Scalar PercentFull() const final {
+    return area_so_far_ / ((float)width() * height());
+  }
+
+ protected:
+  int64_t UsedArea() const final { return area_so_far_; }
+
+  int64_t LargestFreeArea() const final {
+    int64_t largest = 0;
+    for (const auto& free_rect : free_rects_) {
+      largest = std::max(largest, free_rect.Area());
+    }
+    return largest;
+  }
+
+ private:
+  std::vector<IRect> free_rects_;
+
+  int64_t area_so_far_;
+
+  // Add a free rect and merge it with the free rects that share a whole side
+  // with it.
+  void AddFreeRect(IRect free_rect);
+};
+
+bool GuillotineRectanglePacker::AddRect(int p_width,
+                                        int p_height,
+                                        IPoint16* loc) {
+  loc->x_ = 0;
+  loc->y_ = 0;
+  if (p_width <= 0 || p_height <= 0 || p_width > width() ||
+      p_height > height()) {
+    return false;
+  }
+
+  int64_t area = static_cast<int64_t>(p_width) * p_height;
+  int64_t best_leftover_area = std::numeric_limits<int64_t>::max();
+  int64_t best_short_side = std::numeric_limits<int64_t>::max();
+  size_t best_index = free_rects_.size();
+  for (size_t i = 0; i < free_rects_.size(); i++) {
+    const IRect& free_rect = free_rects_[i];
+    int64_t leftover_x = free_rect.GetWidth() - p_width;
+    int64_t leftover_y = free_rect.GetHeight() - p_height;
+    if (leftover_x < 0 || leftover_y < 0) {
+      continue;
+    }
+    int64_t leftover_area = free_rect.Area() - area;
+    int64_t short_side = std::min(leftover_x, leftover_y);
+    if (leftover_area < best_leftover_area ||
+        (leftover_area == best_leftover_area && short_side < best_short_side)) {
+      best_index = i;
+      best_leftover_area = leftover_area;
+      best_short_side = short_side;
+    }
+  }
+  if (best_index == free_rects_.size()) {
+    return false;
+  }
+
+  IRect free_rect = free_rects_[best_index];
+  free_rects_[best_index] = free_rects_.back();
+  free_rects_.pop_back();
+
+  // Cut along the shorter leftover axis, which keeps the larger of the two
+  // leftover rects as large as possible.
+  int64_t x = free_rect.GetX();
+  int64_t y = free_rect.GetY();
+  IRect right;
+  IRect bottom;
+  if (free_rect.GetWidth() - p_width < free_rect.GetHeight() - p_height) {
+    right = IRect::MakeLTRB(x + p_width, y, free_rect.GetRight(), y + p_height);
+    bottom = IRect::MakeLTRB(x, y + p_height, free_rect.GetRight(),
+                             free_rect.GetBottom());
+  } else {
+    right = IRect::MakeLTRB(x + p_width, y, free_rect.GetRight(),
+                            free_rect.GetBottom());
+    bottom = IRect::MakeLTRB(x, y + p_height, x + p_width,
+                             free_rect.GetBottom());
+  }
+  if (!right.IsEmpty()) {
+    AddFreeRect(right);
+  }
+  if (!bottom.IsEmpty()) {
+    AddFreeRect(bottom);
+  }
+
+  loc->x_ = static_cast<int16_t>(x);
+  loc->y_ = static_cast<int16_t>(y);
+  area_so_far_ += area;
+  return true;
+}
+
+bool GuillotineRectanglePacker::RemoveRect(int p_width,
+                                           int p_height,
+                                           IPoint16 loc) {
+  IRect freed = IRect::MakeXYWH(loc.x(), loc.y(), p_width, p_height);
+  if (freed.IsEmpty() ||
+      !IRect::MakeXYWH(0, 0, width(), height()).Contains(freed)) {
+    return false;
+  }
+  AddFreeRect(freed);
+  area_so_far_ -= freed.Area();
+  return true;
+}
+
+void GuillotineRectanglePacker::AddFreeRect(IRect free_rect) {
+  // Each merge may line the grown rect up with another free rect, so keep
+  // going until no free rect shares a whole side with it.
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < free_rects_.size(); i++) {
+      const IRect& other = free_rects_[i];
+      bool same_rows = other.GetY() == free_rect.GetY() &&
+                       other.GetBottom() == free_rect.GetBottom();
+      bool same_columns = other.GetX() == free_rect.GetX() &&
+                          other.GetRight() == free_rect.GetRight();
+      if ((same_rows && (other.GetRight() == free_rect.GetX() ||
+                         other.GetX() == free_rect.GetRight())) ||
+          (same_columns && (other.GetBottom() == free_rect.GetY() ||
+                            other.GetY() == free_rect.GetBottom()))) {
+        free_rect = free_rect.Union(other);
+        free_rects_[i] = free_rects_.back();
+        free_rects_.pop_back();
+        merged = true;
+        break;
+      }
+    }
+  }
+  free_rects_.push_back(free_rect);
+}
+
 std::shared_ptr<RectanglePacker> RectanglePacker::Factory(int width,
-                                                          int height) {
-  return std::make_shared<SkylineRectanglePacker>(width, height);
+                                                          int height,
+                                                          Type type) {
+  switch (type) {
+    case Type::kSkyline:
+      return std::make_shared<SkylineRectanglePacker>(width, height);
+    case Type::kMaxRects:
+      return std::make_shared<MaxRectsRectanglePacker>(width, height);
+    case Type::kGuillotine:
+      return std::make_shared<GuillotineRectanglePacker>(width, height);
+  }
+  FML_UNREACHABLE();
 }
 
 }  // namespace impeller
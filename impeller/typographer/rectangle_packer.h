@@ -9,6 +9,7 @@
 #include "impeller/geometry/scalar.h"
 
 #include <cstdint>
+#include <memory>
 
 namespace impeller {
 
@@ -25,10 +26,27 @@ struct IPoint16 {
 ///
 class RectanglePacker {
  public:
+  /// The strategy a packer uses to place rectangles.
+  enum class Type {
+    /// Places each rectangle as low as possible on a skyline of the placed
+    /// rectangles. Fast, and packs rectangles of similar heights well, but
+    /// the space below the skyline can only be reused after a |Reset|.
+    kSkyline,
+    /// Tracks the maximal free rectangles and places each rectangle in the
+    /// one that leaves the shortest side free (MaxRects-BSSF). Packs the
+    /// tightest, at the highest cost per rectangle.
+    kMaxRects,
+    /// Tracks disjoint free rectangles that are split along the shorter
+    /// leftover axis and merged with their neighbors when freed.
+    kGuillotine,
+  };
+
   //----------------------------------------------------------------------------
   /// @brief     Return an empty packer with area specified by width and height.
   ///
-  static std::shared_ptr<RectanglePacker> Factory(int width, int height);
+  static std::shared_ptr<RectanglePacker> Factory(int width,
+                                                  int height,
+                                                  Type type = Type::kSkyline);
 
   virtual ~RectanglePacker() {}
 
@@ -44,6 +62,20 @@ class RectanglePacker {
   ///
   virtual bool AddRect(int width, int height, IPoint16* loc) = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief     Attempt to free the area of a rect that was added before so
+  ///            that later rects can be placed there.
+  ///
+  /// @param[in]  width   The width of the rectangle that was added.
+  /// @param[in]  height  The height of the rectangle that was added.
+  /// @param[in]  loc     The position that |AddRect| returned for it.
+  ///
+  /// @return     Return true if the area was freed; false if this packer
+  ///             cannot reuse the area before the next |Reset|. The skyline
+  ///             packer can only free rects that nothing was placed on.
+  ///
+  virtual bool RemoveRect(int width, int height, IPoint16 loc) = 0;
+
   //----------------------------------------------------------------------------
   /// @brief     Returns how much area has been filled with rectangles.
   ///
@@ -51,6 +83,24 @@ class RectanglePacker {
   ///
   virtual Scalar PercentFull() const = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief     Returns how fragmented the free area is.
+  ///
+  ///            This is the fraction of the free area that lies outside of the
+  ///            largest rectangle that could still be added. A packer whose
+  ///            free area is one rectangle returns 0.0, while a packer whose
+  ///            free area is scattered in small holes approaches 1.0.
+  ///
+  /// @return    Percentage as a decimal between 0.0 and 1.0
+  ///
+  Scalar Fragmentation() const {
+    int64_t free_area = static_cast<int64_t>(width_) * height_ - UsedArea();
+    if (free_area <= 0) {
+      return 0.0f;
+    }
+    return 1.0f - static_cast<Scalar>(LargestFreeArea()) / free_area;
+  }
+
   //----------------------------------------------------------------------------
   /// @brief     Empty out all previously added rectangles.
   ///
@@ -65,6 +115,12 @@ class RectanglePacker {
   int width() const { return width_; }
   int height() const { return height_; }
 
+  /// The total area of the rectangles added since the last |Reset|.
+  virtual int64_t UsedArea() const = 0;
+
+  /// The area of the largest rectangle that could still be added.
+  virtual int64_t LargestFreeArea() const = 0;
+
  private:
   const int width_;
   const int height_;
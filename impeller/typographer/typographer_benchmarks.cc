@@ -0,0 +1,225 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <memory>
+#include <vector>
+
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "impeller/core/host_buffer.h"
+#include "impeller/renderer/testing/mocks.h"
+#include "impeller/typographer/backends/skia/text_frame_skia.h"
+#include "impeller/typographer/backends/skia/typographer_context_skia.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "txt/platform.h"
+
+namespace impeller {
+
+namespace {
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+using testing::MockAllocator;
+using testing::MockBlitPass;
+using testing::MockCapabilities;
+using testing::MockCommandBuffer;
+using testing::MockCommandQueue;
+using testing::MockDeviceBuffer;
+using testing::MockImpellerContext;
+using testing::MockTexture;
+
+/// A context whose buffers are backed by host memory and whose blit passes
+/// accept every command, so that the benchmarks measure the CPU cost of
+/// rasterizing glyphs into the atlas without a GPU.
+class BenchmarkContext {
+ public:
+  BenchmarkContext()
+      : context_(std::make_shared<NiceMock<MockImpellerContext>>()),
+        allocator_(std::make_shared<NiceMock<MockAllocator>>()),
+        capabilities_mock_(std::make_shared<NiceMock<MockCapabilities>>()),
+        capabilities_(capabilities_mock_),
+        command_queue_(std::make_shared<NiceMock<MockCommandQueue>>()) {
+    ON_CALL(*allocator_, GetMaxTextureSizeSupported)
+        .WillByDefault(Return(ISize(16384, 16384)));
+    ON_CALL(*allocator_, OnCreateBuffer)
+        .WillByDefault([this](const DeviceBufferDescriptor& desc) {
+          auto& storage = buffer_storage_.emplace_back(desc.size);
+          auto buffer = std::make_shared<NiceMock<MockDeviceBuffer>>(desc);
+          ON_CALL(*buffer, OnGetContents)
+              .WillByDefault(Return(storage.data()));
+          return buffer;
+        });
+    ON_CALL(*allocator_, OnCreateTexture)
+        .WillByDefault([](const TextureDescriptor& desc) {
+          auto texture = std::make_shared<NiceMock<MockTexture>>(desc);
+          ON_CALL(*texture, IsValid).WillByDefault(Return(true));
+          ON_CALL(*texture, GetSize).WillByDefault(Return(desc.size));
+          return texture;
+        });
+    ON_CALL(*capabilities_mock_, GetDefaultGlyphAtlasFormat)
+        .WillByDefault(Return(PixelFormat::kA8UNormInt));
+
+    ON_CALL(*context_, GetBackendType)
+        .WillByDefault(Return(Context::BackendType::kVulkan));
+    ON_CALL(*context_, IsValid).WillByDefault(Return(true));
+    ON_CALL(*context_, GetResourceAllocator).WillByDefault(Return(allocator_));
+    ON_CALL(*context_, GetCapabilities).WillByDefault(ReturnRef(capabilities_));
+    ON_CALL(*context_, GetCommandQueue).WillByDefault(Return(command_queue_));
+    ON_CALL(*context_, CreateCommandBuffer).WillByDefault([this]() {
+      auto command_buffer =
+          std::make_shared<NiceMock<MockCommandBuffer>>(context_);
+      ON_CALL(*command_buffer, IsValid).WillByDefault(Return(true));
+      ON_CALL(*command_buffer, OnCreateBlitPass).WillByDefault([]() {
+        auto blit_pass = std::make_shared<NiceMock<MockBlitPass>>();
+        ON_CALL(*blit_pass, IsValid).WillByDefault(Return(true));
+        ON_CALL(*blit_pass, OnCopyBufferToTextureCommand(_, _, _, _, _, _))
+            .WillByDefault(Return(true));
+        return blit_pass;
+      });
+      return command_buffer;
+    });
+  }
+
+  Context& GetContext() const { return *context_; }
+
+  std::shared_ptr<HostBuffer> CreateHostBuffer() const {
+    return HostBuffer::Create(allocator_);
+  }
+
+  /// Release the memory of the buffers created so far.
+  void ReleaseBuffers() { buffer_storage_.clear(); }
+
+ private:
+  std::shared_ptr<NiceMock<MockImpellerContext>> context_;
+  std::shared_ptr<NiceMock<MockAllocator>> allocator_;
+  std::shared_ptr<NiceMock<MockCapabilities>> capabilities_mock_;
+  std::shared_ptr<const Capabilities> capabilities_;
+  std::shared_ptr<NiceMock<MockCommandQueue>> command_queue_;
+  std::vector<std::vector<uint8_t>> buffer_storage_;
+};
+
+FontGlyphMap CollectGlyphs(const SkFont& font,
+                           const std::vector<SkUnichar>& characters) {
+  std::vector<SkGlyphID> glyphs(characters.size());
+  font.unicharsToGlyphs(characters.data(), characters.size(), glyphs.data());
+  std::vector<SkPoint> positions(glyphs.size());
+  for (size_t i = 0; i < positions.size(); i++) {
+    positions[i] = SkPoint::Make(i * font.getSize(), 0);
+  }
+  auto blob = SkTextBlob::MakeFromPosText(glyphs.data(),
+                                          glyphs.size() * sizeof(SkGlyphID),
+                                          positions.data(), font,
+                                          SkTextEncoding::kGlyphID);
+  FontGlyphMap font_glyph_map;
+  if (blob) {
+    MakeTextFrameFromTextBlobSkia(blob)->CollectUniqueFontGlyphPairs(
+        font_glyph_map, 1.0f, {0, 0}, {});
+  }
+  return font_glyph_map;
+}
+
+size_t CountGlyphs(const FontGlyphMap& font_glyph_map) {
+  size_t count = 0u;
+  for (const auto& pair : font_glyph_map) {
+    count += pair.second.size();
+  }
+  return count;
+}
+
+std::vector<SkUnichar> LatinCharacters() {
+  std::vector<SkUnichar> characters;
+  for (SkUnichar c = 0x21; c < 0x7F; c++) {
+    characters.push_back(c);
+  }
+  for (SkUnichar c = 0xC0; c < 0x180; c++) {
+    characters.push_back(c);
+  }
+  return characters;
+}
+
+std::vector<SkUnichar> CJKCharacters() {
+  std::vector<SkUnichar> characters;
+  for (SkUnichar c = 0x4E00; c < 0x4E00 + 1024; c++) {
+    characters.push_back(c);
+  }
+  return characters;
+}
+
+}  // namespace
+
+// Measures the number of glyphs per second that can be rasterized into a new
+// glyph atlas, either on the calling thread or with the help of a pool of
+// worker threads.
+static void BM_CreateGlyphAtlas(benchmark::State& state,
+                                bool is_cjk,
+                                bool parallel) {
+  SkFont font;
+  if (is_cjk) {
+    sk_sp<SkTypeface> typeface =
+        txt::GetDefaultFontManager()->matchFamilyStyleCharacter(
+            nullptr, SkFontStyle(), nullptr, 0, 0x4E2D);
+    if (!typeface) {
+      state.SkipWithError("No CJK font is available.");
+      return;
+    }
+    font = SkFont(typeface, 24);
+  } else {
+    font = flutter::testing::CreateTestFontOfSize(24);
+  }
+  FontGlyphMap font_glyph_map =
+      CollectGlyphs(font, is_cjk ? CJKCharacters() : LatinCharacters());
+  size_t glyph_count = CountGlyphs(font_glyph_map);
+
+  std::shared_ptr<fml::ConcurrentMessageLoop> worker_loop;
+  std::shared_ptr<TypographerContext> typographer_context;
+  if (parallel) {
+    worker_loop = fml::ConcurrentMessageLoop::Create();
+    typographer_context =
+        TypographerContextSkia::Make(worker_loop->GetTaskRunner());
+  } else {
+    typographer_context = TypographerContextSkia::Make();
+  }
+
+  BenchmarkContext context;
+  size_t total_glyphs = 0u;
+  while (state.KeepRunning()) {
+    // A new atlas context is used for each iteration so that every glyph is
+    // rasterized again.
+    auto atlas_context = typographer_context->CreateGlyphAtlasContext(
+        GlyphAtlas::Type::kAlphaBitmap);
+    auto host_buffer = context.CreateHostBuffer();
+    auto atlas = typographer_context->CreateGlyphAtlas(
+        context.GetContext(), GlyphAtlas::Type::kAlphaBitmap, *host_buffer,
+        atlas_context, font_glyph_map);
+    if (!atlas) {
+      state.SkipWithError("Could not create the glyph atlas.");
+      return;
+    }
+    total_glyphs += glyph_count;
+
+    state.PauseTiming();
+    host_buffer.reset();
+    context.ReleaseBuffers();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(total_glyphs);
+}
+
+BENCHMARK_CAPTURE(BM_CreateGlyphAtlas, latin_serial, false, false)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CreateGlyphAtlas, latin_parallel, false, true)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CreateGlyphAtlas, cjk_serial, true, false)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CreateGlyphAtlas, cjk_parallel, true, true)
+    ->UseRealTime();
+
+}  // namespace impeller
@@ -2,7 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/testing/testing.h"
 #include "gtest/gtest.h"
 #include "impeller/core/host_buffer.h"
@@ -416,7 +419,141 @@ TEST(TypographerTest, RectanglePackerFillsRows) {
   EXPECT_EQ(loc.y(), 16);
 }
 
-TEST_P(TypographerTest, GlyphAtlasTextureWillGrowTilMaxTextureSize) {
+static std::vector<ISize> GetTestGlyphSizes() {
+  // The padded sizes of the printable ASCII glyphs of the test font at a
+  // range of common text sizes.
+  std::vector<ISize> sizes;
+  for (SkScalar text_size : {10, 12, 14, 16, 20, 24, 32, 48}) {
+    SkFont font = flutter::testing::CreateTestFontOfSize(text_size);
+    for (SkUnichar c = 0x21; c < 0x7F; c++) {
+      SkGlyphID glyph = font.unicharToGlyph(c);
+      SkRect bounds;
+      font.getBounds(&glyph, 1, &bounds, nullptr);
+      SkIRect rounded = bounds.roundOut();
+      sizes.push_back(ISize(rounded.width() + 2, rounded.height() + 2));
+    }
+  }
+  return sizes;
+}
+
+TEST(TypographerTest, RectanglePackerTypesAddNonoverlappingRectangles) {
+  const SkIRect packer_area = SkIRect::MakeWH(512, 512);
+  std::vector<ISize> sizes = GetTestGlyphSizes();
+  for (auto type :
+       {RectanglePacker::Type::kSkyline, RectanglePacker::Type::kMaxRects,
+        RectanglePacker::Type::kGuillotine}) {
+    auto packer = RectanglePacker::Factory(512, 512, type);
+    ASSERT_NE(packer, nullptr);
+    EXPECT_EQ(packer->Fragmentation(), 0);
+
+    std::vector<SkIRect> placed;
+    IPoint16 loc;
+    for (const auto& size : sizes) {
+      if (!packer->AddRect(size.width, size.height, &loc)) {
+        continue;
+      }
+      SkIRect rect =
+          SkIRect::MakeXYWH(loc.x(), loc.y(), size.width, size.height);
+      ASSERT_TRUE(packer_area.contains(rect));
+      for (const auto& other : placed) {
+        ASSERT_FALSE(SkIRect::Intersects(rect, other));
+      }
+      placed.push_back(rect);
+    }
+    EXPECT_EQ(placed.size(), sizes.size());
+  }
+}
+
+TEST(TypographerTest, RectanglePackerRemoveRectFreesArea) {
+  for (auto type :
+       {RectanglePacker::Type::kMaxRects, RectanglePacker::Type::kGuillotine}) {
+    auto packer = RectanglePacker::Factory(64, 64, type);
+    std::vector<IPoint16> locs(16);
+    for (auto& loc : locs) {
+      ASSERT_TRUE(packer->AddRect(16, 16, &loc));
+    }
+    EXPECT_TRUE(flutter::testing::NumberNear(packer->PercentFull(), 1.0));
+    IPoint16 loc;
+    EXPECT_FALSE(packer->AddRect(16, 16, &loc));
+
+    // Two free cells that are not next to each other can't hold a rect that
+    // is two cells wide.
+    auto find = [&locs](int x, int y) {
+      return *std::find_if(locs.begin(), locs.end(), [x, y](IPoint16 loc) {
+        return loc.x() == x && loc.y() == y;
+      });
+    };
+    ASSERT_TRUE(packer->RemoveRect(16, 16, find(0, 0)));
+    ASSERT_TRUE(packer->RemoveRect(16, 16, find(32, 32)));
+    EXPECT_TRUE(flutter::testing::NumberNear(packer->PercentFull(), 0.875));
+    EXPECT_TRUE(flutter::testing::NumberNear(packer->Fragmentation(), 0.5));
+    EXPECT_FALSE(packer->AddRect(32, 16, &loc));
+
+    // Once its neighbor is freed, the freed areas are merged.
+    ASSERT_TRUE(packer->RemoveRect(16, 16, find(16, 0)));
+    EXPECT_TRUE(packer->AddRect(32, 16, &loc));
+    EXPECT_EQ(loc.x(), 0);
+    EXPECT_EQ(loc.y(), 0);
+    EXPECT_TRUE(packer->AddRect(16, 16, &loc));
+    EXPECT_EQ(loc.x(), 32);
+    EXPECT_EQ(loc.y(), 32);
+    EXPECT_TRUE(flutter::testing::NumberNear(packer->PercentFull(), 1.0));
+  }
+}
+
+TEST(TypographerTest, SkylineRectanglePackerOnlyRemovesUncoveredRects) {
+  auto packer = RectanglePacker::Factory(64, 64);
+  IPoint16 bottom;
+  IPoint16 top;
+  ASSERT_TRUE(packer->AddRect(64, 16, &bottom));
+  ASSERT_TRUE(packer->AddRect(32, 16, &top));
+  EXPECT_EQ(top.y(), 16);
+
+  // The first rect is covered by the second one.
+  EXPECT_FALSE(packer->RemoveRect(64, 16, bottom));
+  EXPECT_TRUE(packer->RemoveRect(32, 16, top));
+  EXPECT_TRUE(flutter::testing::NumberNear(packer->PercentFull(), 0.25));
+  EXPECT_EQ(packer->Fragmentation(), 0);
+
+  IPoint16 loc;
+  ASSERT_TRUE(packer->AddRect(64, 48, &loc));
+  EXPECT_EQ(loc.y(), 16);
+}
+
+TEST(TypographerTest, RectanglePackerTypesPackGlyphSizes) {
+  // Fill a packer with glyph sizes until one doesn't fit, and record how
+  // well and how quickly each type packs them.
+  std::vector<ISize> sizes = GetTestGlyphSizes();
+  for (auto [type, name] :
+       std::initializer_list<std::pair<RectanglePacker::Type, const char*>>{
+           {RectanglePacker::Type::kSkyline, "Skyline"},
+           {RectanglePacker::Type::kMaxRects, "MaxRects"},
+           {RectanglePacker::Type::kGuillotine, "Guillotine"},
+       }) {
+    auto packer = RectanglePacker::Factory(1024, 1024, type);
+    fml::TimePoint start = fml::TimePoint::Now();
+    size_t count = 0u;
+    IPoint16 loc;
+    while (packer->AddRect(sizes[count % sizes.size()].width,
+                           sizes[count % sizes.size()].height, &loc)) {
+      count++;
+    }
+    fml::TimeDelta elapsed = fml::TimePoint::Now() - start;
+
+    std::string prefix = name;
+    RecordProperty(prefix + "PercentFull",
+                   std::to_string(packer->PercentFull()));
+    RecordProperty(prefix + "Fragmentation",
+                   std::to_string(packer->Fragmentation()));
+    RecordProperty(prefix + "RectsPerMillisecond",
+                   std::to_string(count / std::max(elapsed.ToMillisecondsF(),
+                                                   0.001)));
+    EXPECT_GT(count, sizes.size()) << name;
+    EXPECT_GT(packer->PercentFull(), 0.75) << name;
+  }
+}
+
+TEST_P(TypographerTest, GlyphAtlasTextureWillGrowTilPageHeightLimit) {
   if (GetBackend() == PlaygroundBackend::kOpenGLES) {
     GTEST_SKIP() << "Atlas growth isn't supported for OpenGLES currently.";
   }
@@ -433,27 +570,17 @@ TEST_P(TypographerTest, GlyphAtlasTextureWillGrowTilMaxTextureSize) {
       CreateGlyphAtlas(*GetContext(), context.get(), *host_buffer,
                        GlyphAtlas::Type::kAlphaBitmap, 1.0f, atlas_context,
                        *MakeTextFrameFromTextBlobSkia(blob));
-  // Continually append new glyphs until the glyph size grows to the maximum.
-  // Note that the sizes here are more or less experimentally determined, but
-  // the important expectation is that the atlas size will shrink again after
-  // growing to the maximum size.
-  constexpr ISize expected_sizes[13] = {
-      {4096, 4096},   //
-      {4096, 4096},   //
-      {4096, 8192},   //
-      {4096, 8192},   //
-      {4096, 8192},   //
-      {4096, 8192},   //
-      {4096, 16384},  //
-      {4096, 16384},  //
-      {4096, 16384},  //
-      {4096, 16384},  //
-      {4096, 16384},  //
-      {4096, 16384},  //
-      {4096, 4096}    // Shrinks!
-  };
-
-  for (int i = 0; i < 13; i++) {
+  ASSERT_TRUE(!!atlas);
+  EXPECT_EQ(atlas->GetPageCount(), 1u);
+  EXPECT_EQ(atlas->GetTexture()->GetSize(), ISize(4096, 1024));
+
+  // Append a few large glyphs. The first page grows until it reaches its
+  // height limit, after which the atlas adds pages instead of growing the
+  // first page any further.
+  int64_t max_height =
+      GetContext()->GetResourceAllocator()->GetMaxTextureSizeSupported().height;
+  int64_t page_height_limit = std::max<int64_t>(1024, max_height / 4);
+  for (int i = 0; i < 8; i++) {
     SkFont sk_font = flutter::testing::CreateTestFontOfSize(50 + i);
     auto blob = SkTextBlob::MakeFromString("A", sk_font);
 
@@ -462,9 +589,58 @@ TEST_P(TypographerTest, GlyphAtlasTextureWillGrowTilMaxTextureSize) {
                          GlyphAtlas::Type::kAlphaBitmap, 50 + i, atlas_context,
                          *MakeTextFrameFromTextBlobSkia(blob));
     ASSERT_TRUE(!!atlas);
-    EXPECT_EQ(atlas->GetTexture()->GetTextureDescriptor().size,
-              expected_sizes[i]);
+    EXPECT_EQ(atlas->GetTexture()->GetSize().width, 4096);
+    EXPECT_LE(atlas->GetTexture()->GetSize().height, page_height_limit);
+  }
+  EXPECT_GT(atlas->GetPageCount(), 1u);
+  EXPECT_EQ(atlas_context->GetStatistics().rebuild_count, 0u);
+}
+
+TEST_P(TypographerTest, GlyphAtlasEvictsLeastRecentlyUsedPage) {
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator());
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context =
+      context->CreateGlyphAtlasContext(GlyphAtlas::Type::kAlphaBitmap);
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(50);
+
+  // Every frame draws a different large glyph, so the atlas eventually runs
+  // out of pages and has to evict the glyphs of earlier frames.
+  const std::string letters =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+  std::shared_ptr<GlyphAtlas> first_atlas;
+  for (char letter : letters) {
+    auto blob = SkTextBlob::MakeFromString(std::string(1, letter).c_str(),
+                                           sk_font);
+    ASSERT_TRUE(blob);
+    auto frame = MakeTextFrameFromTextBlobSkia(blob);
+    auto atlas = CreateGlyphAtlas(*GetContext(), context.get(), *host_buffer,
+                                  GlyphAtlas::Type::kAlphaBitmap, 50.0f,
+                                  atlas_context, *frame);
+    ASSERT_TRUE(!!atlas);
+    if (!first_atlas) {
+      first_atlas = atlas;
+    }
+    // Pages are evicted and repacked instead of rebuilding the whole atlas.
+    EXPECT_EQ(atlas, first_atlas);
+    EXPECT_LE(atlas->GetPageCount(), 4u);
+
+    // The glyphs of the current frame are always in the atlas.
+    FontGlyphMap font_glyph_map;
+    frame->CollectUniqueFontGlyphPairs(font_glyph_map, 50.0f, {0, 0}, {});
+    for (const auto& [scaled_font, glyphs] : font_glyph_map) {
+      for (const SubpixelGlyph& glyph : glyphs) {
+        EXPECT_TRUE(
+            atlas->FindFontGlyphBounds({scaled_font, glyph}).has_value());
+      }
+    }
+
+    if (atlas_context->GetStatistics().eviction_count > 0u) {
+      break;
+    }
   }
+  EXPECT_GT(atlas_context->GetStatistics().eviction_count, 0u);
+  EXPECT_EQ(atlas_context->GetStatistics().rebuild_count, 0u);
 }
 
 }  // namespace testing
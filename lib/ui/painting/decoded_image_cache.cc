@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include "flutter/fml/hash_bytes.h"
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+std::size_t DecodedImageCache::Key::Hash::operator()(const Key& key) const {
+  return fml::HashCombine(key.content_hash, key.content_size, key.target_width,
+                          key.target_height);
+}
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  return content_hash == other.content_hash &&
+         content_size == other.content_size &&
+         target_width == other.target_width &&
+         target_height == other.target_height;
+}
+
+DecodedImageCache::DecodedImageCache(size_t byte_budget)
+    : byte_budget_(byte_budget) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+DecodedImageCache::Key DecodedImageCache::MakeKey(const SkData& encoded_data,
+                                                  uint32_t target_width,
+                                                  uint32_t target_height) {
+  TRACE_EVENT0("flutter", "DecodedImageCache::MakeKey");
+  return Key{
+      .content_hash = fml::HashBytes(encoded_data.bytes(), encoded_data.size()),
+      .content_size = encoded_data.size(),
+      .target_width = target_width,
+      .target_height = target_height,
+  };
+}
+
+sk_sp<DlImage> DecodedImageCache::Get(const Key& key) {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->image;
+}
+
+void DecodedImageCache::Put(const Key& key, sk_sp<DlImage> image) {
+  if (!image) {
+    return;
+  }
+  const size_t byte_size = image->GetApproximateByteSize();
+  if (byte_size > byte_budget_) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  if (auto found = index_.find(key); found != index_.end()) {
+    // Another decode of the same image finished first.
+    byte_size_ -= found->second->byte_size;
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+  entries_.push_front(
+      Entry{.key = key, .image = std::move(image), .byte_size = byte_size});
+  index_[key] = entries_.begin();
+  byte_size_ += byte_size;
+  EvictToBudget();
+}
+
+void DecodedImageCache::EvictToBudget() {
+  while (byte_size_ > byte_budget_ && !entries_.empty()) {
+    const Entry& entry = entries_.back();
+    byte_size_ -= entry.byte_size;
+    index_.erase(entry.key);
+    entries_.pop_back();
+    eviction_count_++;
+  }
+}
+
+void DecodedImageCache::Purge() {
+  TRACE_EVENT0("flutter", "DecodedImageCache::Purge");
+  std::list<Entry> entries;
+  {
+    std::scoped_lock lock(mutex_);
+    eviction_count_ += entries_.size();
+    entries.swap(entries_);
+    index_.clear();
+    byte_size_ = 0u;
+  }
+  // The images are released outside of the lock.
+}
+
+DecodedImageCache::Stats DecodedImageCache::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  return Stats{
+      .hit_count = hit_count_,
+      .miss_count = miss_count_,
+      .eviction_count = eviction_count_,
+      .entry_count = entries_.size(),
+      .byte_size = byte_size_,
+      .byte_budget = byte_budget_,
+  };
+}
+
+}  // namespace flutter
@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/display_list/image/dl_image.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+/// @brief  A byte budgeted, least recently used cache of decoded images, keyed
+///         by a hash of their encoded bytes and the size they were decoded to.
+///
+///         This lets the engine skip decoding the same encoded image at the
+///         same size again, for example when another route or another engine
+///         in the same group loads it through a different `ImmutableBuffer`.
+///         The cache is safe to use from any thread.
+class DecodedImageCache {
+ public:
+  struct Key {
+    uint64_t content_hash = 0u;
+    size_t content_size = 0u;
+    uint32_t target_width = 0u;
+    uint32_t target_height = 0u;
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const;
+    };
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct Stats {
+    size_t hit_count = 0u;
+    size_t miss_count = 0u;
+    size_t eviction_count = 0u;
+    size_t entry_count = 0u;
+    size_t byte_size = 0u;
+    size_t byte_budget = 0u;
+  };
+
+  explicit DecodedImageCache(size_t byte_budget);
+
+  ~DecodedImageCache();
+
+  /// @brief  Hash the encoded bytes of an image into the key of its decode at
+  ///         the given target size. This reads all of the bytes, and so
+  ///         should not be called on the UI thread.
+  static Key MakeKey(const SkData& encoded_data,
+                     uint32_t target_width,
+                     uint32_t target_height);
+
+  /// @brief  Look up a decoded image and mark it as the most recently used.
+  /// @return The image, or null if it is not in the cache.
+  sk_sp<DlImage> Get(const Key& key);
+
+  /// @brief  Add a decoded image, evicting the least recently used images
+  ///         until the cache fits in its budget. Images that are larger than
+  ///         the whole budget are not cached.
+  void Put(const Key& key, sk_sp<DlImage> image);
+
+  /// @brief  Drop all of the cached images, for example in response to a low
+  ///         memory warning. The statistics are kept.
+  void Purge();
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    Key key;
+    sk_sp<DlImage> image;
+    size_t byte_size;
+  };
+
+  void EvictToBudget();
+
+  const size_t byte_budget_;
+  mutable std::mutex mutex_;
+  // Ordered from the most to the least recently used.
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, Key::Hash> index_;
+  size_t byte_size_ = 0u;
+  size_t hit_count_ = 0u;
+  size_t miss_count_ = 0u;
+  size_t eviction_count_ = 0u;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<DlImage> MakeImage(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height);
+  bitmap.eraseColor(SK_ColorRED);
+  bitmap.setImmutable();
+  return DlImage::Make(SkImages::RasterFromBitmap(bitmap));
+}
+
+DecodedImageCache::Key MakeKey(uint64_t content_hash) {
+  return DecodedImageCache::Key{.content_hash = content_hash,
+                                .content_size = 100u,
+                                .target_width = 10u,
+                                .target_height = 10u};
+}
+
+}  // namespace
+
+TEST(DecodedImageCacheTest, KeysDependOnContentAndTargetSize) {
+  const uint8_t bytes[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  const uint8_t other_bytes[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12};
+  sk_sp<SkData> data = SkData::MakeWithCopy(bytes, sizeof(bytes));
+  sk_sp<SkData> same_data = SkData::MakeWithCopy(bytes, sizeof(bytes));
+  sk_sp<SkData> other_data =
+      SkData::MakeWithCopy(other_bytes, sizeof(other_bytes));
+  sk_sp<SkData> shorter_data = SkData::MakeWithCopy(bytes, sizeof(bytes) - 1);
+
+  const auto key = DecodedImageCache::MakeKey(*data, 10, 20);
+  EXPECT_EQ(key, DecodedImageCache::MakeKey(*same_data, 10, 20));
+  EXPECT_EQ(DecodedImageCache::Key::Hash{}(key),
+            DecodedImageCache::Key::Hash{}(
+                DecodedImageCache::MakeKey(*same_data, 10, 20)));
+  EXPECT_FALSE(key == DecodedImageCache::MakeKey(*other_data, 10, 20));
+  EXPECT_FALSE(key == DecodedImageCache::MakeKey(*shorter_data, 10, 20));
+  EXPECT_FALSE(key == DecodedImageCache::MakeKey(*data, 20, 10));
+}
+
+TEST(DecodedImageCacheTest, CountsHitsAndMisses) {
+  DecodedImageCache cache(1024 * 1024);
+  sk_sp<DlImage> image = MakeImage(10, 10);
+
+  EXPECT_EQ(cache.Get(MakeKey(1)), nullptr);
+  cache.Put(MakeKey(1), image);
+  EXPECT_EQ(cache.Get(MakeKey(1)), image);
+  EXPECT_EQ(cache.Get(MakeKey(2)), nullptr);
+
+  DecodedImageCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.hit_count, 1u);
+  EXPECT_EQ(stats.miss_count, 2u);
+  EXPECT_EQ(stats.eviction_count, 0u);
+  EXPECT_EQ(stats.entry_count, 1u);
+  EXPECT_EQ(stats.byte_size, image->GetApproximateByteSize());
+  EXPECT_EQ(stats.byte_budget, 1024u * 1024u);
+}
+
+TEST(DecodedImageCacheTest, EvictsLeastRecentlyUsedImages) {
+  sk_sp<DlImage> image_1 = MakeImage(10, 10);
+  sk_sp<DlImage> image_2 = MakeImage(10, 10);
+  sk_sp<DlImage> image_3 = MakeImage(10, 10);
+  const size_t image_size = image_1->GetApproximateByteSize();
+  DecodedImageCache cache(image_size * 2);
+
+  cache.Put(MakeKey(1), image_1);
+  cache.Put(MakeKey(2), image_2);
+  // Makes the first image the most recently used one.
+  EXPECT_EQ(cache.Get(MakeKey(1)), image_1);
+  cache.Put(MakeKey(3), image_3);
+
+  EXPECT_EQ(cache.Get(MakeKey(1)), image_1);
+  EXPECT_EQ(cache.Get(MakeKey(2)), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey(3)), image_3);
+
+  DecodedImageCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.eviction_count, 1u);
+  EXPECT_EQ(stats.entry_count, 2u);
+  EXPECT_EQ(stats.byte_size, image_size * 2);
+}
+
+TEST(DecodedImageCacheTest, ReplacesImagesWithTheSameKey) {
+  sk_sp<DlImage> image_1 = MakeImage(10, 10);
+  sk_sp<DlImage> image_2 = MakeImage(10, 10);
+  DecodedImageCache cache(1024 * 1024);
+
+  cache.Put(MakeKey(1), image_1);
+  cache.Put(MakeKey(1), image_2);
+
+  EXPECT_EQ(cache.Get(MakeKey(1)), image_2);
+  DecodedImageCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.entry_count, 1u);
+  EXPECT_EQ(stats.byte_size, image_2->GetApproximateByteSize());
+}
+
+TEST(DecodedImageCacheTest, DoesNotCacheImagesLargerThanTheBudget) {
+  sk_sp<DlImage> small_image = MakeImage(10, 10);
+  sk_sp<DlImage> large_image = MakeImage(100, 100);
+  DecodedImageCache cache(small_image->GetApproximateByteSize());
+
+  cache.Put(MakeKey(1), small_image);
+  cache.Put(MakeKey(2), large_image);
+
+  // The small image was not evicted to make room for the large one.
+  EXPECT_EQ(cache.Get(MakeKey(1)), small_image);
+  EXPECT_EQ(cache.Get(MakeKey(2)), nullptr);
+  EXPECT_EQ(cache.GetStats().eviction_count, 0u);
+}
+
+TEST(DecodedImageCacheTest, PurgeDropsAllImages) {
+  DecodedImageCache cache(1024 * 1024);
+  cache.Put(MakeKey(1), MakeImage(10, 10));
+  cache.Put(MakeKey(2), MakeImage(10, 10));
+  ASSERT_NE(cache.Get(MakeKey(1)), nullptr);
+
+  cache.Purge();
+
+  EXPECT_EQ(cache.Get(MakeKey(1)), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey(2)), nullptr);
+  DecodedImageCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.hit_count, 1u);
+  EXPECT_EQ(stats.miss_count, 2u);
+  EXPECT_EQ(stats.eviction_count, 2u);
+  EXPECT_EQ(stats.entry_count, 0u);
+  EXPECT_EQ(stats.byte_size, 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -55,6 +55,76 @@ ImageDecoder::ImageDecoder(
 
 ImageDecoder::~ImageDecoder() = default;
 
+void ImageDecoder::DecodeWithCache(fml::RefPtr<ImageDescriptor> descriptor,
+                                   uint32_t target_width,
+                                   uint32_t target_height,
+                                   const ImageResult& result) {
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  // Only encoded images are cached, the pixels of raw images would have to be
+  // hashed with their layout.
+  if (!decoded_image_cache_ || !descriptor->is_compressed() ||
+      !descriptor->data()) {
+    Decode(std::move(descriptor), target_width, target_height, result);
+    return;
+  }
+
+  // The descriptor must only be referenced and released on the UI thread.
+  auto raw_descriptor = descriptor.get();
+  raw_descriptor->AddRef();
+  concurrent_task_runner_->PostTask(
+      [cache = decoded_image_cache_, data = descriptor->data(),
+       ui_runner = runners_.GetUITaskRunner(), weak_decoder = GetWeakPtr(),
+       raw_descriptor, target_width, target_height, result]() {
+        auto key =
+            DecodedImageCache::MakeKey(*data, target_width, target_height);
+        sk_sp<DlImage> cached_image = cache->Get(key);
+        ui_runner->PostTask([cache, key, cached_image, weak_decoder,
+                             raw_descriptor, target_width, target_height,
+                             result]() {
+          fml::RefPtr<ImageDescriptor> descriptor(raw_descriptor);
+          raw_descriptor->Release();
+          if (cached_image) {
+            result(cached_image, std::string());
+            return;
+          }
+          if (!weak_decoder) {
+            result(nullptr, "The image decoder was collected.");
+            return;
+          }
+          weak_decoder->Decode(std::move(descriptor), target_width,
+                               target_height,
+                               [cache, key, result](sk_sp<DlImage> image,
+                                                    std::string decode_error) {
+                                 if (image) {
+                                   cache->Put(key, image);
+                                 }
+                                 result(std::move(image),
+                                        std::move(decode_error));
+                               });
+        });
+      });
+}
+
+void ImageDecoder::SetDecodedImageCache(
+    std::shared_ptr<DecodedImageCache> cache) {
+  decoded_image_cache_ = std::move(cache);
+}
+
+const std::shared_ptr<DecodedImageCache>& ImageDecoder::GetDecodedImageCache()
+    const {
+  return decoded_image_cache_;
+}
+
+void ImageDecoder::SetMultiFrameCodecOptions(
+    const MultiFrameCodec::Options& options) {
+  multi_frame_codec_options_ = options;
+}
+
+const MultiFrameCodec::Options& ImageDecoder::GetMultiFrameCodecOptions()
+    const {
+  return multi_frame_codec_options_;
+}
+
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
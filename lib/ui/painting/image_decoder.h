@@ -12,7 +12,9 @@
 #include "flutter/display_list/image/dl_image.h"
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
+#include "flutter/lib/ui/painting/multi_frame_codec.h"
 
 namespace flutter {
 
@@ -44,6 +46,27 @@ class ImageDecoder {
                       uint32_t target_height,
                       const ImageResult& result) = 0;
 
+  // Like |Decode|, but first looks for an image decoded from the same encoded
+  // bytes at the same target size in the decoded image cache, and adds the
+  // image to the cache once it is decoded. The encoded bytes are hashed on a
+  // worker thread. Without a cache, this is the same as |Decode|.
+  void DecodeWithCache(fml::RefPtr<ImageDescriptor> descriptor,
+                       uint32_t target_width,
+                       uint32_t target_height,
+                       const ImageResult& result);
+
+  // Sets the cache that |DecodeWithCache| uses, which may be shared with the
+  // decoders of other engines. Null disables caching.
+  void SetDecodedImageCache(std::shared_ptr<DecodedImageCache> cache);
+
+  const std::shared_ptr<DecodedImageCache>& GetDecodedImageCache() const;
+
+  // Animated images are decoded frame by frame by their codec rather than by
+  // this decoder, but take their decode ahead and caching options from it.
+  void SetMultiFrameCodecOptions(const MultiFrameCodec::Options& options);
+
+  const MultiFrameCodec::Options& GetMultiFrameCodecOptions() const;
+
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
  protected:
@@ -57,6 +80,8 @@ class ImageDecoder {
       fml::WeakPtr<IOManager> io_manager);
 
  private:
+  std::shared_ptr<DecodedImageCache> decoded_image_cache_;
+  MultiFrameCodec::Options multi_frame_codec_options_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
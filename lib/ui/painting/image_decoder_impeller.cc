@@ -4,7 +4,10 @@
 
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/make_copyable.h"
@@ -73,6 +76,108 @@ bool IsWideGamut(const SkColorSpace* color_space) {
   float area = CalculateArea(rgb);
   return area > kSrgbGamutArea;
 }
+
+// The number of rows that are decoded at once when scaling the rows of an image
+// as they are decoded.
+static constexpr int kDecodeScaleStripRows = 16;
+
+// The sums of the 8-bit channels of all the decoded pixels that are averaged
+// into one pixel of the target size must fit into 32 bits.
+static constexpr int64_t kMaxDecodeScalePixelsPerTargetPixel =
+    std::numeric_limits<uint32_t>::max() / 255;
+
+/// Whether an image decoded into `decode_info` can be scaled down to
+/// `target_size` row by row with `DecodeScaleScanlines`.
+bool CanDecodeScaleScanlines(const SkImageInfo& decode_info,
+                             const SkISize& target_size) {
+  if (decode_info.colorType() != kRGBA_8888_SkColorType ||
+      decode_info.alphaType() == kUnpremul_SkAlphaType) {
+    return false;
+  }
+  if (target_size.isEmpty() || decode_info.dimensions() == target_size ||
+      decode_info.width() < target_size.width() ||
+      decode_info.height() < target_size.height()) {
+    return false;
+  }
+  const int64_t span_x = (decode_info.width() + target_size.width() - 1) /
+                         target_size.width();
+  const int64_t span_y = (decode_info.height() + target_size.height() - 1) /
+                         target_size.height();
+  return span_x * span_y <= kMaxDecodeScalePixelsPerTargetPixel;
+}
+
+/// Decodes the image in strips of rows and averages each strip into the rows
+/// of `target` that it covers, so that the full size image is never held in
+/// memory. Every decoded pixel contributes to exactly one target pixel.
+bool DecodeScaleScanlines(ImageDescriptor* descriptor,
+                          const SkImageInfo& decode_info,
+                          const SkPixmap& target) {
+  if (!descriptor->start_scanline_decode(decode_info)) {
+    return false;
+  }
+  const int src_width = decode_info.width();
+  const int src_height = decode_info.height();
+  const int dst_width = target.width();
+  const int dst_height = target.height();
+
+  std::vector<int> dst_columns(src_width);
+  std::vector<uint32_t> column_counts(dst_width, 0u);
+  for (int x = 0; x < src_width; x++) {
+    dst_columns[x] = static_cast<int64_t>(x) * dst_width / src_width;
+    column_counts[dst_columns[x]]++;
+  }
+
+  const size_t strip_row_bytes = decode_info.minRowBytes();
+  std::vector<uint8_t> strip(strip_row_bytes * kDecodeScaleStripRows);
+  std::vector<uint32_t> sums(dst_width * 4u, 0u);
+  uint32_t row_count = 0u;
+  int dst_y = 0;
+  for (int strip_y = 0; strip_y < src_height;
+       strip_y += kDecodeScaleStripRows) {
+    const int strip_rows =
+        std::min(kDecodeScaleStripRows, src_height - strip_y);
+    if (descriptor->get_scanlines(strip.data(), strip_rows, strip_row_bytes) !=
+        strip_rows) {
+      FML_DLOG(ERROR) << "Could not decode image rows.";
+      return false;
+    }
+    for (int row = 0; row < strip_rows; row++) {
+      const uint8_t* src = strip.data() + row * strip_row_bytes;
+      for (int x = 0; x < src_width; x++, src += 4) {
+        uint32_t* sum = &sums[dst_columns[x] * 4];
+        sum[0] += src[0];
+        sum[1] += src[1];
+        sum[2] += src[2];
+        sum[3] += src[3];
+      }
+      row_count++;
+
+      // Write out the target row once the next decoded row belongs to another.
+      const int src_y = strip_y + row;
+      const int next_dst_y =
+          static_cast<int64_t>(src_y + 1) * dst_height / src_height;
+      if (next_dst_y == dst_y) {
+        continue;
+      }
+      uint8_t* dst = static_cast<uint8_t*>(target.writable_addr(0, dst_y));
+      for (int x = 0; x < dst_width; x++) {
+        const uint32_t count = column_counts[x] * row_count;
+        for (int channel = 0; channel < 4; channel++, dst++) {
+          *dst = (sums[x * 4 + channel] + count / 2) / count;
+        }
+      }
+      std::fill(sums.begin(), sums.end(), 0u);
+      row_count = 0u;
+      dst_y = next_dst_y;
+    }
+  }
+  return true;
+}
+
+// How long the images that finished decoding are held back so that they can be
+// uploaded together with the images that finish decoding right after them.
+static constexpr fml::TimeDelta kUploadBatchWindow =
+    fml::TimeDelta::FromMilliseconds(2);
 }  // namespace
 
 ImageDecoderImpeller::ImageDecoderImpeller(
@@ -83,7 +188,11 @@ ImageDecoderImpeller::ImageDecoderImpeller(
     const std::shared_ptr<fml::SyncSwitch>& gpu_disabled_switch)
     : ImageDecoder(runners, std::move(concurrent_task_runner), io_manager),
       supports_wide_gamut_(supports_wide_gamut),
-      gpu_disabled_switch_(gpu_disabled_switch) {
+      gpu_disabled_switch_(gpu_disabled_switch),
+      upload_batcher_(std::make_shared<ImpellerUploadBatcher>(
+          runners.GetIOTaskRunner(),
+          gpu_disabled_switch,
+          kUploadBatchWindow)) {
   std::promise<std::shared_ptr<impeller::Context>> context_promise;
   context_ = context_promise.get_future();
   runners_.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
@@ -171,6 +280,29 @@ DecompressResult ImageDecoderImpeller::DecompressTexture(
     return DecompressResult{.decode_error = decode_error};
   }
 
+  if (descriptor->is_compressed() &&
+      CanDecodeScaleScanlines(image_info, target_size)) {
+    TRACE_EVENT0("impeller", "DecodeScaleScanlines");
+    auto scaled_bitmap = std::make_shared<SkBitmap>();
+    auto scaled_allocator = std::make_shared<ImpellerAllocator>(allocator);
+    scaled_bitmap->setInfo(image_info.makeDimensions(target_size));
+    if (scaled_bitmap->tryAllocPixels(scaled_allocator.get()) &&
+        DecodeScaleScanlines(descriptor, image_info,
+                             scaled_bitmap->pixmap())) {
+      scaled_bitmap->setImmutable();
+      std::shared_ptr<impeller::DeviceBuffer> buffer =
+          scaled_allocator->GetDeviceBuffer();
+      if (!buffer) {
+        return DecompressResult{.decode_error = "Unable to get device buffer"};
+      }
+      buffer->Flush();
+      return DecompressResult{.device_buffer = std::move(buffer),
+                              .sk_bitmap = scaled_bitmap,
+                              .image_info = scaled_bitmap->info()};
+    }
+    // Fall back to decoding the whole image and scaling it afterwards.
+  }
+
   auto bitmap = std::make_shared<SkBitmap>();
   bitmap->setInfo(image_info);
   auto bitmap_allocator = std::make_shared<ImpellerAllocator>(allocator);
@@ -254,69 +386,103 @@ DecompressResult ImageDecoderImpeller::DecompressTexture(
 }
 
 /// Only call this method if the GPU is available.
-static std::pair<sk_sp<DlImage>, std::string> UnsafeUploadTextureToPrivate(
+static std::vector<std::pair<sk_sp<DlImage>, std::string>>
+UnsafeUploadTexturesToPrivate(
     const std::shared_ptr<impeller::Context>& context,
-    const std::shared_ptr<impeller::DeviceBuffer>& buffer,
-    const SkImageInfo& image_info) {
-  const auto pixel_format =
-      impeller::skia_conversions::ToPixelFormat(image_info.colorType());
-  if (!pixel_format) {
-    std::string decode_error(impeller::SPrintF(
-        "Unsupported pixel format (SkColorType=%d)", image_info.colorType()));
-    FML_DLOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
-  }
+    const std::vector<ImpellerTextureUpload>& uploads) {
+  std::vector<std::pair<sk_sp<DlImage>, std::string>> results(uploads.size());
+  std::vector<std::shared_ptr<impeller::Texture>> textures(uploads.size());
+  size_t texture_count = 0u;
+  for (size_t i = 0; i < uploads.size(); i++) {
+    if (!uploads[i].buffer) {
+      results[i] =
+          std::make_pair(nullptr, "No Impeller device buffer is available");
+      continue;
+    }
+    const SkImageInfo& image_info = uploads[i].image_info;
+    const auto pixel_format =
+        impeller::skia_conversions::ToPixelFormat(image_info.colorType());
+    if (!pixel_format) {
+      std::string decode_error(
+          impeller::SPrintF("Unsupported pixel format (SkColorType=%d)",
+                            image_info.colorType()));
+      FML_DLOG(ERROR) << decode_error;
+      results[i] = std::make_pair(nullptr, decode_error);
+      continue;
+    }
 
-  impeller::TextureDescriptor texture_descriptor;
-  texture_descriptor.storage_mode = impeller::StorageMode::kDevicePrivate;
-  texture_descriptor.format = pixel_format.value();
-  texture_descriptor.size = {image_info.width(), image_info.height()};
-  texture_descriptor.mip_count = texture_descriptor.size.MipCount();
-  texture_descriptor.compression_type = impeller::CompressionType::kLossy;
+    impeller::TextureDescriptor texture_descriptor;
+    texture_descriptor.storage_mode = impeller::StorageMode::kDevicePrivate;
+    texture_descriptor.format = pixel_format.value();
+    texture_descriptor.size = {image_info.width(), image_info.height()};
+    texture_descriptor.mip_count = texture_descriptor.size.MipCount();
+    texture_descriptor.compression_type = impeller::CompressionType::kLossy;
+
+    auto dest_texture =
+        context->GetResourceAllocator()->CreateTexture(texture_descriptor);
+    if (!dest_texture) {
+      std::string decode_error("Could not create Impeller texture.");
+      FML_DLOG(ERROR) << decode_error;
+      results[i] = std::make_pair(nullptr, decode_error);
+      continue;
+    }
 
-  auto dest_texture =
-      context->GetResourceAllocator()->CreateTexture(texture_descriptor);
-  if (!dest_texture) {
-    std::string decode_error("Could not create Impeller texture.");
-    FML_DLOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
+    dest_texture->SetLabel(
+        impeller::SPrintF("ui.Image(%p)", dest_texture.get()).c_str());
+    textures[i] = std::move(dest_texture);
+    texture_count++;
+  }
+  if (texture_count == 0u) {
+    return results;
   }
 
-  dest_texture->SetLabel(
-      impeller::SPrintF("ui.Image(%p)", dest_texture.get()).c_str());
+  // Reports the same error for every upload that got a texture.
+  auto fail_uploads = [&results, &textures](const std::string& decode_error) {
+    FML_DLOG(ERROR) << decode_error;
+    for (size_t i = 0; i < textures.size(); i++) {
+      if (textures[i]) {
+        results[i] = std::make_pair(nullptr, decode_error);
+      }
+    }
+    return results;
+  };
 
   auto command_buffer = context->CreateCommandBuffer();
   if (!command_buffer) {
-    std::string decode_error(
+    return fail_uploads(
         "Could not create command buffer for mipmap generation.");
-    FML_DLOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
   }
   command_buffer->SetLabel("Mipmap Command Buffer");
 
   auto blit_pass = command_buffer->CreateBlitPass();
   if (!blit_pass) {
-    std::string decode_error(
-        "Could not create blit pass for mipmap generation.");
-    FML_DLOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
+    return fail_uploads("Could not create blit pass for mipmap generation.");
   }
   blit_pass->SetLabel("Mipmap Blit Pass");
-  blit_pass->AddCopy(impeller::DeviceBuffer::AsBufferView(buffer),
-                     dest_texture);
-  if (texture_descriptor.size.MipCount() > 1) {
-    blit_pass->GenerateMipmap(dest_texture);
+  for (size_t i = 0; i < uploads.size(); i++) {
+    if (!textures[i]) {
+      continue;
+    }
+    blit_pass->AddCopy(impeller::DeviceBuffer::AsBufferView(uploads[i].buffer),
+                       textures[i]);
+    if (textures[i]->GetTextureDescriptor().mip_count > 1) {
+      blit_pass->GenerateMipmap(textures[i]);
+    }
   }
 
   blit_pass->EncodeCommands(context->GetResourceAllocator());
   if (!context->GetCommandQueue()->Submit({command_buffer}).ok()) {
-    std::string decode_error("Failed to submit blit pass command buffer.");
-    FML_DLOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
+    return fail_uploads("Failed to submit blit pass command buffer.");
   }
 
-  return std::make_pair(
-      impeller::DlImageImpeller::Make(std::move(dest_texture)), std::string());
+  for (size_t i = 0; i < textures.size(); i++) {
+    if (textures[i]) {
+      results[i] = std::make_pair(
+          impeller::DlImageImpeller::Make(std::move(textures[i])),
+          std::string());
+    }
+  }
+  return results;
 }
 
 std::pair<sk_sp<DlImage>, std::string>
@@ -333,21 +499,41 @@ ImageDecoderImpeller::UploadTextureToPrivate(
   if (!buffer) {
     return std::make_pair(nullptr, "No Impeller device buffer is available");
   }
+  return UploadTexturesToPrivate(
+      context,
+      {ImpellerTextureUpload{
+          .buffer = buffer, .image_info = image_info, .bitmap = bitmap}},
+      gpu_disabled_switch)[0];
+}
+
+std::vector<std::pair<sk_sp<DlImage>, std::string>>
+ImageDecoderImpeller::UploadTexturesToPrivate(
+    const std::shared_ptr<impeller::Context>& context,
+    const std::vector<ImpellerTextureUpload>& uploads,
+    const std::shared_ptr<fml::SyncSwitch>& gpu_disabled_switch) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  std::vector<std::pair<sk_sp<DlImage>, std::string>> results;
+  if (!context) {
+    results.resize(uploads.size(),
+                   std::make_pair(nullptr, "No Impeller context is available"));
+    return results;
+  }
 
-  std::pair<sk_sp<DlImage>, std::string> result;
   gpu_disabled_switch->Execute(
       fml::SyncSwitch::Handlers()
-          .SetIfFalse([&result, context, buffer, image_info] {
-            result = UnsafeUploadTextureToPrivate(context, buffer, image_info);
+          .SetIfFalse([&results, &context, &uploads] {
+            results = UnsafeUploadTexturesToPrivate(context, uploads);
           })
-          .SetIfTrue([&result, context, bitmap, gpu_disabled_switch] {
+          .SetIfTrue([&results, &context, &uploads, &gpu_disabled_switch] {
             // create_mips is false because we already know the GPU is disabled.
-            result =
-                UploadTextureToStorage(context, bitmap, gpu_disabled_switch,
-                                       impeller::StorageMode::kHostVisible,
-                                       /*create_mips=*/false);
+            for (const ImpellerTextureUpload& upload : uploads) {
+              results.push_back(UploadTextureToStorage(
+                  context, upload.bitmap, gpu_disabled_switch,
+                  impeller::StorageMode::kHostVisible,
+                  /*create_mips=*/false));
+            }
           }));
-  return result;
+  return results;
 }
 
 std::pair<sk_sp<DlImage>, std::string>
@@ -468,10 +654,9 @@ void ImageDecoderImpeller::Decode(fml::RefPtr<ImageDescriptor> descriptor,
       [raw_descriptor,                                            //
        context = context_.get(),                                  //
        target_size = SkISize::Make(target_width, target_height),  //
-       io_runner = runners_.GetIOTaskRunner(),                    //
+       upload_batcher = upload_batcher_,                          //
        result,
-       supports_wide_gamut = supports_wide_gamut_,  //
-       gpu_disabled_switch = gpu_disabled_switch_]() {
+       supports_wide_gamut = supports_wide_gamut_]() {
         if (!context) {
           result(nullptr, "No Impeller context is available");
           return;
@@ -488,19 +673,98 @@ void ImageDecoderImpeller::Decode(fml::RefPtr<ImageDescriptor> descriptor,
           return;
         }
 
-        auto upload_texture_and_invoke_result = [result, context, bitmap_result,
-                                                 gpu_disabled_switch]() {
-          sk_sp<DlImage> image;
-          std::string decode_error;
-          std::tie(image, decode_error) = UploadTextureToPrivate(
-              context, bitmap_result.device_buffer, bitmap_result.image_info,
-              bitmap_result.sk_bitmap, gpu_disabled_switch);
-          result(image, decode_error);
-        };
-        io_runner->PostTask(upload_texture_and_invoke_result);
+        upload_batcher->Upload(
+            context,
+            ImpellerTextureUpload{.buffer = bitmap_result.device_buffer,
+                                  .image_info = bitmap_result.image_info,
+                                  .bitmap = bitmap_result.sk_bitmap},
+            result);
       });
 }
 
+ImpellerUploadBatcher::ImpellerUploadBatcher(
+    fml::RefPtr<fml::TaskRunner> io_runner,
+    std::shared_ptr<fml::SyncSwitch> gpu_disabled_switch,
+    fml::TimeDelta window)
+    : io_runner_(std::move(io_runner)),
+      gpu_disabled_switch_(std::move(gpu_disabled_switch)),
+      window_(window) {}
+
+ImpellerUploadBatcher::~ImpellerUploadBatcher() = default;
+
+void ImpellerUploadBatcher::Upload(
+    const std::shared_ptr<impeller::Context>& context,
+    ImpellerTextureUpload upload,
+    UploadResult result) {
+  bool flush_now = false;
+  bool schedule_flush = false;
+  {
+    std::scoped_lock lock(mutex_);
+    pending_uploads_.push_back(PendingUpload{.context = context,
+                                             .upload = std::move(upload),
+                                             .result = std::move(result)});
+    if (pending_uploads_.size() >= kMaxBatchSize) {
+      flush_now = true;
+    } else if (!flush_scheduled_) {
+      flush_scheduled_ = true;
+      schedule_flush = true;
+    }
+  }
+  auto flush = [batcher = shared_from_this()]() { batcher->Flush(); };
+  if (flush_now) {
+    io_runner_->PostTask(flush);
+  } else if (schedule_flush) {
+    io_runner_->PostDelayedTask(flush, window_);
+  }
+}
+
+void ImpellerUploadBatcher::Flush() {
+  FML_DCHECK(io_runner_->RunsTasksOnCurrentThread());
+  std::vector<PendingUpload> pending_uploads;
+  {
+    std::scoped_lock lock(mutex_);
+    pending_uploads.swap(pending_uploads_);
+    flush_scheduled_ = false;
+  }
+  if (pending_uploads.empty()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "ImpellerUploadBatcher::Flush");
+
+  // All images are decoded with the context of the same decoder, but split the
+  // batch by context in case that ever changes.
+  size_t start = 0u;
+  while (start < pending_uploads.size()) {
+    const std::shared_ptr<impeller::Context>& context =
+        pending_uploads[start].context;
+    size_t end = start + 1;
+    while (end < pending_uploads.size() &&
+           pending_uploads[end].context == context) {
+      end++;
+    }
+
+    std::vector<ImpellerTextureUpload> uploads;
+    uploads.reserve(end - start);
+    for (size_t i = start; i < end; i++) {
+      uploads.push_back(pending_uploads[i].upload);
+    }
+    auto results = ImageDecoderImpeller::UploadTexturesToPrivate(
+        context, uploads, gpu_disabled_switch_);
+    submission_count_++;
+    FML_TRACE_COUNTER("flutter", "ImpellerUploadBatcher",
+                      reinterpret_cast<int64_t>(this),  //
+                      "BatchSize", uploads.size(),      //
+                      "Submissions", submission_count_  //
+    );
+
+    for (size_t i = start; i < end; i++) {
+      pending_uploads[i].result(std::move(results[i - start].first),
+                                std::move(results[i - start].second));
+    }
+    start = end;
+  }
+}
+
 ImpellerAllocator::ImpellerAllocator(
     std::shared_ptr<impeller::Allocator> allocator)
     : allocator_(std::move(allocator)) {}
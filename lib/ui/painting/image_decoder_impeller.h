@@ -5,9 +5,14 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_IMPELLER_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_IMPELLER_H_
 
+#include <functional>
 #include <future>
+#include <mutex>
+#include <vector>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
 #include "impeller/core/formats.h"
 #include "impeller/geometry/size.h"
@@ -44,6 +49,62 @@ struct DecompressResult {
   std::string decode_error;
 };
 
+/// A decoded image that is waiting to be uploaded into a texture.
+struct ImpellerTextureUpload {
+  std::shared_ptr<impeller::DeviceBuffer> buffer;
+  SkImageInfo image_info;
+  std::shared_ptr<SkBitmap> bitmap;
+};
+
+/// Collects the images that finish decoding within a short window and uploads
+/// them to device private textures with a single command buffer on the IO
+/// task runner. The result of each upload is still reported individually.
+class ImpellerUploadBatcher
+    : public std::enable_shared_from_this<ImpellerUploadBatcher> {
+ public:
+  using UploadResult =
+      std::function<void(sk_sp<DlImage> image, std::string decode_error)>;
+
+  /// A batch is uploaded right away once it has this many images.
+  static constexpr size_t kMaxBatchSize = 64u;
+
+  ImpellerUploadBatcher(fml::RefPtr<fml::TaskRunner> io_runner,
+                        std::shared_ptr<fml::SyncSwitch> gpu_disabled_switch,
+                        fml::TimeDelta window);
+
+  ~ImpellerUploadBatcher();
+
+  /// @brief Queue an image for upload. May be called on any thread.
+  /// @param context The Impeller graphics context.
+  /// @param upload  The decoded image.
+  /// @param result  Called on the IO task runner with the uploaded image.
+  void Upload(const std::shared_ptr<impeller::Context>& context,
+              ImpellerTextureUpload upload,
+              UploadResult result);
+
+  /// @brief Upload all of the queued images. Must be called on the IO task
+  ///        runner.
+  void Flush();
+
+ private:
+  struct PendingUpload {
+    std::shared_ptr<impeller::Context> context;
+    ImpellerTextureUpload upload;
+    UploadResult result;
+  };
+
+  const fml::RefPtr<fml::TaskRunner> io_runner_;
+  const std::shared_ptr<fml::SyncSwitch> gpu_disabled_switch_;
+  const fml::TimeDelta window_;
+  std::mutex mutex_;
+  std::vector<PendingUpload> pending_uploads_;
+  bool flush_scheduled_ = false;
+  // Only accessed on the IO task runner.
+  size_t submission_count_ = 0u;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImpellerUploadBatcher);
+};
+
 class ImageDecoderImpeller final : public ImageDecoder {
  public:
   ImageDecoderImpeller(
@@ -83,6 +144,18 @@ class ImageDecoderImpeller final : public ImageDecoder {
       const std::shared_ptr<SkBitmap>& bitmap,
       const std::shared_ptr<fml::SyncSwitch>& gpu_disabled_switch);
 
+  /// @brief Create device private textures from the provided host buffers,
+  ///        encoding all of the copies into a single command buffer.
+  /// @param context    The Impeller graphics context.
+  /// @param uploads    The decoded images to be uploaded.
+  /// @param gpu_disabled_switch Whether the GPU is available command encoding.
+  /// @return           A DlImage or an error for each upload, in order.
+  static std::vector<std::pair<sk_sp<DlImage>, std::string>>
+  UploadTexturesToPrivate(
+      const std::shared_ptr<impeller::Context>& context,
+      const std::vector<ImpellerTextureUpload>& uploads,
+      const std::shared_ptr<fml::SyncSwitch>& gpu_disabled_switch);
+
   /// @brief Create a host visible texture from the provided bitmap.
   /// @param context     The Impeller graphics context.
   /// @param bitmap      A bitmap containg the image to be uploaded.
@@ -103,6 +176,7 @@ class ImageDecoderImpeller final : public ImageDecoder {
   FutureContext context_;
   const bool supports_wide_gamut_;
   std::shared_ptr<fml::SyncSwitch> gpu_disabled_switch_;
+  std::shared_ptr<ImpellerUploadBatcher> upload_batcher_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderImpeller);
 };
@@ -2,8 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/impeller/core/allocator.h"
 #include "flutter/impeller/core/device_buffer.h"
@@ -26,6 +31,7 @@
 #include "fml/logging.h"
 #include "impeller/renderer/command_queue.h"
 #include "third_party/skia/include/codec/SkCodecAnimation.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
@@ -348,6 +354,63 @@ TEST_F(ImageDecoderFixtureTest, ImpellerUploadToSharedNoGpu) {
   ASSERT_EQ(result.second, "");
 }
 
+TEST_F(ImageDecoderFixtureTest, ImpellerUploadBatcherSubmitsImagesTogether) {
+#if !IMPELLER_SUPPORTS_RENDERING
+  GTEST_SKIP() << "Impeller only test.";
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
+  auto context = std::make_shared<impeller::TestImpellerContext>();
+  auto io_runner = CreateNewThread("io");
+  // A window long enough that the batches are only flushed by the test, or by
+  // reaching the maximum batch size.
+  auto batcher = std::make_shared<ImpellerUploadBatcher>(
+      io_runner, std::make_shared<fml::SyncSwitch>(),
+      fml::TimeDelta::FromSeconds(60));
+
+  auto info = SkImageInfo::Make(10, 10, SkColorType::kRGBA_8888_SkColorType,
+                                SkAlphaType::kPremul_SkAlphaType);
+  auto bitmap = std::make_shared<SkBitmap>();
+  bitmap->allocPixels(info, 10 * 4);
+  impeller::DeviceBufferDescriptor desc;
+  desc.size = bitmap->computeByteSize();
+  auto buffer = std::make_shared<impeller::TestImpellerDeviceBuffer>(desc);
+
+  std::atomic_size_t result_count = 0u;
+  fml::CountDownLatch latch(ImpellerUploadBatcher::kMaxBatchSize + 3);
+  auto upload = [&]() {
+    batcher->Upload(
+        context,
+        ImpellerTextureUpload{
+            .buffer = buffer, .image_info = info, .bitmap = bitmap},
+        [&](const sk_sp<DlImage>& image, const std::string& decode_error) {
+          EXPECT_TRUE(io_runner->RunsTasksOnCurrentThread());
+          // The test context can't create command buffers.
+          EXPECT_EQ(decode_error,
+                    "Could not create command buffer for mipmap generation.");
+          result_count++;
+          latch.CountDown();
+        });
+  };
+
+  for (int i = 0; i < 3; i++) {
+    upload();
+  }
+  PostTaskSync(io_runner, [&]() {
+    EXPECT_EQ(result_count, 0u);
+    batcher->Flush();
+  });
+  EXPECT_EQ(result_count, 3u);
+  EXPECT_EQ(context->command_buffer_count_, 1u);
+
+  result_count = 0u;
+  for (size_t i = 0; i < ImpellerUploadBatcher::kMaxBatchSize; i++) {
+    upload();
+  }
+  latch.Wait();
+  EXPECT_EQ(result_count, ImpellerUploadBatcher::kMaxBatchSize);
+  EXPECT_EQ(context->command_buffer_count_, 2u);
+}
+
 TEST_F(ImageDecoderFixtureTest, ImpellerNullColorspace) {
   auto info = SkImageInfo::Make(10, 10, SkColorType::kRGBA_8888_SkColorType,
                                 SkAlphaType::kPremul_SkAlphaType);
@@ -740,6 +803,58 @@ TEST(ImageDecoderTest, VerifySimpleDecoding) {
 #endif  // IMPELLER_SUPPORTS_RENDERING
 }
 
+TEST(ImageDecoderTest, ScanlineDecodingIsOnlyUsedForUnorientedImages) {
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> rotated_generator =
+      registry.CreateCompatibleGenerator(
+          flutter::testing::OpenFixtureAsSkData("Horizontal.jpg"));
+  ASSERT_TRUE(rotated_generator);
+  EXPECT_FALSE(rotated_generator->StartScanlineDecode(
+      rotated_generator->GetInfo().makeColorType(kRGBA_8888_SkColorType)));
+
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(
+          flutter::testing::OpenFixtureAsSkData("DashInNooglerHat.jpg"));
+  ASSERT_TRUE(generator);
+  SkImageInfo info = generator->GetInfo()
+                         .makeDimensions(generator->GetScaledDimensions(0.125))
+                         .makeColorType(kRGBA_8888_SkColorType);
+  ASSERT_TRUE(generator->StartScanlineDecode(info));
+  std::vector<uint8_t> rows(info.minRowBytes() * 2);
+  EXPECT_EQ(generator->GetScanlines(rows.data(), 2, info.minRowBytes()), 2);
+}
+
+#if IMPELLER_SUPPORTS_RENDERING
+TEST(ImageDecoderTest, ImpellerScalesImageRowsWhileDecoding) {
+  SkBitmap source;
+  source.allocN32Pixels(400, 200);
+  source.erase(SK_ColorRED, SkIRect::MakeLTRB(0, 0, 200, 200));
+  source.erase(SK_ColorBLUE, SkIRect::MakeLTRB(200, 0, 400, 200));
+  sk_sp<SkData> data = SkPngEncoder::Encode(
+      nullptr, SkImages::RasterFromBitmap(source).get(), {});
+  ASSERT_TRUE(data);
+
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(data);
+  ASSERT_TRUE(generator);
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                         std::move(generator));
+
+  std::shared_ptr<impeller::Allocator> allocator =
+      std::make_shared<impeller::TestImpellerAllocator>();
+  auto result = ImageDecoderImpeller::DecompressTexture(
+      descriptor.get(), SkISize::Make(100, 50), {1000, 1000},
+      /*supports_wide_gamut=*/false, allocator);
+  ASSERT_TRUE(result.device_buffer);
+  ASSERT_EQ(result.sk_bitmap->dimensions(), SkISize::Make(100, 50));
+  EXPECT_EQ(result.sk_bitmap->getColor(0, 0), SK_ColorRED);
+  EXPECT_EQ(result.sk_bitmap->getColor(49, 49), SK_ColorRED);
+  EXPECT_EQ(result.sk_bitmap->getColor(50, 0), SK_ColorBLUE);
+  EXPECT_EQ(result.sk_bitmap->getColor(99, 49), SK_ColorBLUE);
+}
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
 TEST(ImageDecoderTest, ImagesWithTransparencyArePremulAlpha) {
   auto data = flutter::testing::OpenFixtureAsSkData("heart_end.png");
   ASSERT_TRUE(data);
@@ -1050,6 +1165,260 @@ TEST_F(ImageDecoderFixtureTest,
   PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
 }
 
+namespace {
+
+/// Forwards to another generator and counts the frames it decodes.
+class CountingImageGenerator : public ImageGenerator {
+ public:
+  explicit CountingImageGenerator(std::shared_ptr<ImageGenerator> generator)
+      : generator_(std::move(generator)) {}
+
+  const SkImageInfo& GetInfo() override { return generator_->GetInfo(); }
+
+  unsigned int GetFrameCount() const override {
+    return generator_->GetFrameCount();
+  }
+
+  unsigned int GetPlayCount() const override {
+    return generator_->GetPlayCount();
+  }
+
+  const ImageGenerator::FrameInfo GetFrameInfo(
+      unsigned int frame_index) override {
+    return generator_->GetFrameInfo(frame_index);
+  }
+
+  SkISize GetScaledDimensions(float scale) override {
+    return generator_->GetScaledDimensions(scale);
+  }
+
+  bool GetPixels(const SkImageInfo& info,
+                 void* pixels,
+                 size_t row_bytes,
+                 unsigned int frame_index,
+                 std::optional<unsigned int> prior_frame) override {
+    decoded_frame_count_++;
+    const int concurrent_decodes = ++concurrent_decode_count_;
+    int max_concurrent_decodes = max_concurrent_decode_count_;
+    while (concurrent_decodes > max_concurrent_decodes &&
+           !max_concurrent_decode_count_.compare_exchange_weak(
+               max_concurrent_decodes, concurrent_decodes)) {
+    }
+    // Widens the window in which decodes would overlap if they could.
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    const bool result = generator_->GetPixels(info, pixels, row_bytes,
+                                              frame_index, prior_frame);
+    concurrent_decode_count_--;
+    return result;
+  }
+
+  int decoded_frame_count() const { return decoded_frame_count_; }
+
+  int max_concurrent_decode_count() const {
+    return max_concurrent_decode_count_;
+  }
+
+ private:
+  std::shared_ptr<ImageGenerator> generator_;
+  std::atomic_int decoded_frame_count_{0};
+  std::atomic_int concurrent_decode_count_{0};
+  std::atomic_int max_concurrent_decode_count_{0};
+};
+
+}  // namespace
+
+TEST_F(ImageDecoderFixtureTest, MultiFrameCodecCachesFramesOfShortLoops) {
+  auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto vm_data = vm_ref.GetVMData();
+
+  auto gif_mapping = flutter::testing::OpenFixtureAsSkData("hello_loop_2.gif");
+
+  ASSERT_TRUE(gif_mapping);
+
+  ImageGeneratorRegistry registry;
+  auto gif_generator = std::make_shared<CountingImageGenerator>(
+      registry.CreateCompatibleGenerator(gif_mapping));
+  const int frame_count = gif_generator->GetFrameCount();
+  ASSERT_GT(frame_count, 1);
+
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  std::unique_ptr<TestIOManager> io_manager;
+  fml::RefPtr<MultiFrameCodec> codec;
+  fml::AutoResetWaitableEvent latch;
+
+  auto validate_frame_callback = [&latch](Dart_NativeArguments args) {
+    EXPECT_FALSE(Dart_IsNull(Dart_GetNativeArgument(args, 0)));
+    latch.Signal();
+  };
+
+  AddNativeCallback("ValidateFrameCallback",
+                    CREATE_NATIVE_ENTRY(validate_frame_callback));
+  // Setup the IO manager.
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  auto isolate = RunDartCodeInIsolate(vm_ref, settings, runners, "main", {},
+                                      GetDefaultKernelFilePath(),
+                                      io_manager->GetWeakIOManager());
+
+  // Play the animation three times.
+  for (int i = 0; i < frame_count * 3; i++) {
+    PostTaskSync(runners.GetUITaskRunner(), [&]() {
+      EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+        Dart_Handle library = Dart_RootLibrary();
+        if (Dart_IsError(library)) {
+          return false;
+        }
+        Dart_Handle closure =
+            Dart_GetField(library, Dart_NewStringFromCString("frameCallback"));
+        if (Dart_IsError(closure) || !Dart_IsClosure(closure)) {
+          return false;
+        }
+        if (!codec) {
+          codec = fml::MakeRefCounted<MultiFrameCodec>(
+              gif_generator, MultiFrameCodec::Options{
+                                 .decode_ahead_frames = 0,
+                                 .frame_cache_max_bytes = 16 * 1024 * 1024,
+                             });
+        }
+        codec->getNextFrame(closure);
+        return true;
+      }));
+    });
+    latch.Wait();
+  }
+
+  // Only the first loop was decoded.
+  EXPECT_EQ(gif_generator->decoded_frame_count(), frame_count);
+
+  // Destroy the Isolate
+  isolate = nullptr;
+
+  // Destroy the MultiFrameCodec
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { codec = nullptr; });
+
+  // Destroy the IO manager
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
+TEST_F(ImageDecoderFixtureTest,
+       MultiFrameCodecsOfOneDescriptorDoNotDecodeConcurrently) {
+  auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto vm_data = vm_ref.GetVMData();
+
+  auto gif_mapping = flutter::testing::OpenFixtureAsSkData("hello_loop_2.gif");
+
+  ASSERT_TRUE(gif_mapping);
+
+  ImageGeneratorRegistry registry;
+  auto gif_generator = std::make_shared<CountingImageGenerator>(
+      registry.CreateCompatibleGenerator(gif_mapping));
+  const int frame_count = gif_generator->GetFrameCount();
+  ASSERT_GT(frame_count, 1);
+
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  std::unique_ptr<TestIOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+  fml::RefPtr<ImageDescriptor> descriptor;
+  fml::RefPtr<Codec> codec_1;
+  fml::RefPtr<Codec> codec_2;
+  std::atomic_int frame_callback_count{0};
+  fml::AutoResetWaitableEvent latch;
+
+  auto validate_frame_callback = [&](Dart_NativeArguments args) {
+    EXPECT_FALSE(Dart_IsNull(Dart_GetNativeArgument(args, 0)));
+    frame_callback_count++;
+    latch.Signal();
+  };
+
+  AddNativeCallback("ValidateFrameCallback",
+                    CREATE_NATIVE_ENTRY(validate_frame_callback));
+  // Setup the IO manager.
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+  // Both codecs decode frames ahead on the concurrent task runner.
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    image_decoder = ImageDecoder::Make(
+        settings, runners, vm_ref->GetConcurrentWorkerTaskRunner(),
+        io_manager->GetWeakIOManager(), std::make_shared<fml::SyncSwitch>());
+    image_decoder->SetMultiFrameCodecOptions(
+        MultiFrameCodec::Options{.decode_ahead_frames = 2});
+  });
+
+  auto isolate = RunDartCodeInIsolate(
+      vm_ref, settings, runners, "main", {}, GetDefaultKernelFilePath(),
+      io_manager->GetWeakIOManager(), nullptr, nullptr,
+      image_decoder->GetWeakPtr());
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    descriptor =
+        fml::MakeRefCounted<ImageDescriptor>(gif_mapping, gif_generator);
+    EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+      const int width = descriptor->width();
+      const int height = descriptor->height();
+      codec_1 = descriptor->MakeCodec(width, height);
+      codec_2 = descriptor->MakeCodec(width, height);
+      return true;
+    }));
+  });
+
+  // Play the animation twice with both codecs at the same time.
+  for (int i = 0; i < frame_count * 2; i++) {
+    PostTaskSync(runners.GetUITaskRunner(), [&]() {
+      EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+        Dart_Handle library = Dart_RootLibrary();
+        if (Dart_IsError(library)) {
+          return false;
+        }
+        Dart_Handle closure =
+            Dart_GetField(library, Dart_NewStringFromCString("frameCallback"));
+        if (Dart_IsError(closure) || !Dart_IsClosure(closure)) {
+          return false;
+        }
+        codec_1->getNextFrame(closure);
+        codec_2->getNextFrame(closure);
+        return true;
+      }));
+    });
+    while (frame_callback_count < (i + 1) * 2) {
+      latch.Wait();
+    }
+  }
+
+  EXPECT_GE(gif_generator->decoded_frame_count(), frame_count * 4);
+  EXPECT_EQ(gif_generator->max_concurrent_decode_count(), 1);
+
+  // Destroy the Isolate
+  isolate = nullptr;
+
+  // Destroy the codecs, the descriptor, and the decoder
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    codec_1 = nullptr;
+    codec_2 = nullptr;
+    descriptor = nullptr;
+    image_decoder.reset();
+  });
+
+  // Destroy the IO manager
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
 TEST_F(ImageDecoderFixtureTest, NullCheckBuffer) {
   auto context = std::make_shared<impeller::TestImpellerContext>();
   auto allocator = ImpellerAllocator(context->GetResourceAllocator());
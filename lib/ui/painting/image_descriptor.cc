@@ -7,6 +7,7 @@
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/lib/ui/painting/single_frame_codec.h"
 #include "flutter/lib/ui/ui_dart_state.h"
@@ -110,15 +111,30 @@ void ImageDescriptor::initRaw(Dart_Handle descriptor_handle,
 void ImageDescriptor::instantiateCodec(Dart_Handle codec_handle,
                                        int target_width,
                                        int target_height) {
-  fml::RefPtr<Codec> ui_codec;
-  if (!generator_ || generator_->GetFrameCount() == 1) {
-    ui_codec = fml::MakeRefCounted<SingleFrameCodec>(
+  fml::RefPtr<Codec> ui_codec = MakeCodec(target_width, target_height);
+  ui_codec->AssociateWithDartWrapper(codec_handle);
+}
+
+fml::RefPtr<Codec> ImageDescriptor::MakeCodec(int target_width,
+                                              int target_height) {
+  if (!generator_) {
+    return fml::MakeRefCounted<SingleFrameCodec>(
         static_cast<fml::RefPtr<ImageDescriptor>>(this), target_width,
         target_height);
-  } else {
-    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(generator_);
   }
-  ui_codec->AssociateWithDartWrapper(codec_handle);
+  // Codecs created earlier may be decoding frames from the generator.
+  std::scoped_lock lock(*generator_mutex_);
+  if (generator_->GetFrameCount() == 1) {
+    return fml::MakeRefCounted<SingleFrameCodec>(
+        static_cast<fml::RefPtr<ImageDescriptor>>(this), target_width,
+        target_height);
+  }
+  MultiFrameCodec::Options options;
+  if (auto decoder = UIDartState::Current()->GetImageDecoder()) {
+    options = decoder->GetMultiFrameCodecOptions();
+  }
+  return fml::MakeRefCounted<MultiFrameCodec>(generator_, options,
+                                              generator_mutex_);
 }
 
 sk_sp<SkImage> ImageDescriptor::image() const {
@@ -131,4 +147,16 @@ bool ImageDescriptor::get_pixels(const SkPixmap& pixmap) const {
                                pixmap.rowBytes());
 }
 
+bool ImageDescriptor::start_scanline_decode(const SkImageInfo& info) const {
+  FML_DCHECK(generator_);
+  return generator_->StartScanlineDecode(info);
+}
+
+int ImageDescriptor::get_scanlines(void* pixels,
+                                   int count,
+                                   size_t row_bytes) const {
+  FML_DCHECK(generator_);
+  return generator_->GetScanlines(pixels, count, row_bytes);
+}
+
 }  // namespace flutter
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 #include "flutter/fml/macros.h"
@@ -22,6 +23,8 @@
 
 namespace flutter {
 
+class Codec;
+
 /// @brief  Creates an image descriptor for encoded or decoded image data,
 ///         describing the width, height, and bytes per pixel for that image.
 ///         This class will hold a reference on the underlying image data, and
@@ -62,6 +65,11 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   /// @brief  Associates a flutter::Codec object with the dart.ui Codec handle.
   void instantiateCodec(Dart_Handle codec, int target_width, int target_height);
 
+  /// @brief  Creates the codec that `instantiateCodec` associates with the
+  ///         Dart handle. The multi-frame codecs of a descriptor share its
+  ///         generator, and a lock that serializes their decodes.
+  fml::RefPtr<Codec> MakeCodec(int target_width, int target_height);
+
   /// @brief  The width of this image, EXIF oriented if applicable.
   int width() const { return image_info_.width(); }
 
@@ -110,6 +118,16 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   ///         orientation tag, if applicable.
   bool get_pixels(const SkPixmap& pixmap) const;
 
+  /// @brief  Starts decoding the pixels of this image row by row, if its
+  ///         generator supports it.
+  /// @see    `ImageGenerator::StartScanlineDecode`
+  bool start_scanline_decode(const SkImageInfo& info) const;
+
+  /// @brief  Decodes the next `count` rows of a decode started with
+  ///         `start_scanline_decode`.
+  /// @see    `ImageGenerator::GetScanlines`
+  int get_scanlines(void* pixels, int count, size_t row_bytes) const;
+
   void dispose() {
     buffer_.reset();
     generator_.reset();
@@ -125,6 +143,9 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
 
   sk_sp<SkData> buffer_;
   std::shared_ptr<ImageGenerator> generator_;
+  // Guards the generator, which all of the multi-frame codecs instantiated
+  // from this descriptor share and decode frames from concurrently.
+  std::shared_ptr<std::mutex> generator_mutex_ = std::make_shared<std::mutex>();
   const SkImageInfo image_info_;
   std::optional<size_t> row_bytes_;
 
@@ -16,6 +16,14 @@ namespace flutter {
 
 ImageGenerator::~ImageGenerator() = default;
 
+bool ImageGenerator::StartScanlineDecode(const SkImageInfo& info) {
+  return false;
+}
+
+int ImageGenerator::GetScanlines(void* pixels, int count, size_t row_bytes) {
+  return 0;
+}
+
 sk_sp<SkImage> ImageGenerator::GetImage() {
   SkImageInfo info = GetInfo();
 
@@ -188,6 +196,28 @@ bool BuiltinSkiaCodecImageGenerator::GetPixels(
   return SkPixmapUtils::Orient(output_pixmap, temp_pixmap, origin);
 }
 
+bool BuiltinSkiaCodecImageGenerator::StartScanlineDecode(
+    const SkImageInfo& info) {
+  // Re-orienting the pixels requires all of the rows of the image.
+  if (codec_->getOrigin() != kTopLeft_SkEncodedOrigin) {
+    return false;
+  }
+  SkCodec::Result result = codec_->startScanlineDecode(info);
+  if (result != SkCodec::kSuccess) {
+    FML_DLOG(WARNING) << "codec could not start scanline decode. "
+                      << SkCodec::ResultToString(result);
+    return false;
+  }
+  // Interlaced images produce their rows out of order.
+  return codec_->getScanlineOrder() == SkCodec::kTopDown_SkScanlineOrder;
+}
+
+int BuiltinSkiaCodecImageGenerator::GetScanlines(void* pixels,
+                                                 int count,
+                                                 size_t row_bytes) {
+  return codec_->getScanlines(pixels, count, row_bytes);
+}
+
 std::unique_ptr<ImageGenerator> BuiltinSkiaCodecImageGenerator::MakeFromData(
     sk_sp<SkData> data) {
   auto codec = SkCodec::MakeFromData(std::move(data));
@@ -135,6 +135,30 @@ class ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) = 0;
 
+  /// @brief      Prepare to decode the first frame of the image row by row,
+  ///             from top to bottom, with `GetScanlines`. This allows callers
+  ///             to process the image in strips instead of holding all of its
+  ///             pixels at once.
+  /// @param[in]  info  The desired size and color info of the decoded image.
+  ///                   As with `GetPixels`, the size must be one returned by
+  ///                   `GetScaledDimensions`.
+  /// @return     True if the image can be decoded row by row. If false,
+  ///             `GetPixels` must be used instead. The default implementation
+  ///             always returns false.
+  /// @see        `GetScanlines`
+  virtual bool StartScanlineDecode(const SkImageInfo& info);
+
+  /// @brief      Decode the next rows of the image started by
+  ///             `StartScanlineDecode`.
+  /// @param[in]  pixels     The location where the decoded rows should be
+  ///                        written.
+  /// @param[in]  count      The number of rows to decode.
+  /// @param[in]  row_bytes  The number of bytes between two rows in `pixels`.
+  /// @return     The number of rows that were successfully decoded. If less
+  ///             than `count`, the encoded data was incomplete or invalid.
+  /// @see        `StartScanlineDecode`
+  virtual int GetScanlines(void* pixels, int count, size_t row_bytes);
+
   /// @brief   Creates an `SkImage` based on the current `ImageInfo` of this
   ///          `ImageGenerator`.
   /// @return  A new `SkImage` containing the decoded image data.
@@ -212,6 +236,12 @@ class BuiltinSkiaCodecImageGenerator : public ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) override;
 
+  // |ImageGenerator|
+  bool StartScanlineDecode(const SkImageInfo& info) override;
+
+  // |ImageGenerator|
+  int GetScanlines(void* pixels, int count, size_t row_bytes) override;
+
   static std::unique_ptr<ImageGenerator> MakeFromData(sk_sp<SkData> data);
 
  private:
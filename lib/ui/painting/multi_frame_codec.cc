@@ -4,9 +4,11 @@
 
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/display_list_image_gpu.h"
 #include "flutter/lib/ui/painting/image.h"
 #if IMPELLER_SUPPORTS_RENDERING
@@ -22,18 +24,65 @@
 namespace flutter {
 
 MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator)
-    : state_(new State(std::move(generator))) {}
+    : MultiFrameCodec(std::move(generator), Options()) {}
+
+MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                                 const Options& options)
+    : MultiFrameCodec(std::move(generator),
+                      options,
+                      std::make_shared<std::mutex>()) {}
+
+MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                                 const Options& options,
+                                 std::shared_ptr<std::mutex> generator_mutex)
+    : state_(new State(std::move(generator),
+                       options,
+                       std::move(generator_mutex))) {}
 
 MultiFrameCodec::~MultiFrameCodec() = default;
 
-MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
+static SkImageInfo GetFrameImageInfo(ImageGenerator& generator) {
+  SkImageInfo info = generator.GetInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    SkImageInfo updated = info.makeAlphaType(kPremul_SkAlphaType);
+    info = updated;
+  }
+  return info;
+}
+
+static bool CanCacheAllFrames(ImageGenerator& generator,
+                              int frame_count,
+                              size_t frame_cache_max_bytes) {
+  if (frame_cache_max_bytes == 0 || frame_count <= 0) {
+    return false;
+  }
+  const size_t frame_byte_size =
+      GetFrameImageInfo(generator).computeMinByteSize();
+  return frame_byte_size > 0 &&
+         frame_byte_size <= frame_cache_max_bytes / frame_count;
+}
+
+MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator,
+                              const Options& options,
+                              std::shared_ptr<std::mutex> generator_mutex)
     : generator_(std::move(generator)),
+      generator_mutex_(std::move(generator_mutex)),
       frameCount_(generator_->GetFrameCount()),
       repetitionCount_(generator_->GetPlayCount() ==
                                ImageGenerator::kInfinitePlayCount
                            ? -1
                            : generator_->GetPlayCount() - 1),
-      is_impeller_enabled_(UIDartState::Current()->IsImpellerEnabled()) {}
+      is_impeller_enabled_(UIDartState::Current()->IsImpellerEnabled()),
+      // Decoding more than a whole loop ahead would decode frames twice.
+      decode_ahead_frames_(std::min(options.decode_ahead_frames,
+                                    static_cast<size_t>(frameCount_))),
+      cache_all_frames_(CanCacheAllFrames(*generator_,
+                                          frameCount_,
+                                          options.frame_cache_max_bytes)) {
+  if (cache_all_frames_) {
+    cachedFrames_.resize(frameCount_);
+  }
+}
 
 static void InvokeNextFrameCallback(
     const fml::RefPtr<CanvasImage>& image,
@@ -53,29 +102,26 @@ static void InvokeNextFrameCallback(
                      tonic::ToDart(decode_error)});
 }
 
-std::pair<sk_sp<DlImage>, std::string>
-MultiFrameCodec::State::GetNextFrameImage(
-    fml::WeakPtr<GrDirectContext> resourceContext,
-    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
-    const std::shared_ptr<impeller::Context>& impeller_context,
-    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
+MultiFrameCodec::State::DecodedFrame
+MultiFrameCodec::State::DecodeNextFrame() {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::DecodeNextFrame");
+  std::scoped_lock generator_lock(*generator_mutex_);
+  DecodedFrame frame;
+  frame.index = nextDecodeIndex_;
+  nextDecodeIndex_ = (nextDecodeIndex_ + 1) % frameCount_;
+
   SkBitmap bitmap = SkBitmap();
-  SkImageInfo info = generator_->GetInfo().makeColorType(kN32_SkColorType);
-  if (info.alphaType() == kUnpremul_SkAlphaType) {
-    SkImageInfo updated = info.makeAlphaType(kPremul_SkAlphaType);
-    info = updated;
-  }
+  SkImageInfo info = GetFrameImageInfo(*generator_);
   if (!bitmap.tryAllocPixels(info)) {
     std::ostringstream ostr;
     ostr << "Failed to allocate memory for bitmap of size "
          << info.computeMinByteSize() << "B";
-    std::string decode_error = ostr.str();
-    FML_LOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
+    frame.decode_error = ostr.str();
+    FML_LOG(ERROR) << frame.decode_error;
+    return frame;
   }
 
-  ImageGenerator::FrameInfo frameInfo =
-      generator_->GetFrameInfo(nextFrameIndex_);
+  ImageGenerator::FrameInfo frameInfo = generator_->GetFrameInfo(frame.index);
 
   const int requiredFrameIndex =
       frameInfo.required_frame.value_or(SkCodec::kNoFrame);
@@ -86,7 +132,7 @@ MultiFrameCodec::State::GetNextFrameImage(
     // |requiredFrameIndex| is set to ex-frame or ex-ex-frame.
     if (!lastRequiredFrame_.has_value()) {
       FML_DLOG(INFO)
-          << "Frame " << nextFrameIndex_ << " depends on frame "
+          << "Frame " << frame.index << " depends on frame "
           << requiredFrameIndex
           << " and no required frames are cached. Using blank slate instead.";
     } else {
@@ -102,12 +148,12 @@ MultiFrameCodec::State::GetNextFrameImage(
   // Write the new frame to the output buffer. The bitmap pixels as supplied
   // are already set in accordance with the previous frame's disposal policy.
   if (!generator_->GetPixels(info, bitmap.getPixels(), bitmap.rowBytes(),
-                             nextFrameIndex_, requiredFrameIndex)) {
+                             frame.index, requiredFrameIndex)) {
     std::ostringstream ostr;
-    ostr << "Could not getPixels for frame " << nextFrameIndex_;
-    std::string decode_error = ostr.str();
-    FML_LOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
+    ostr << "Could not getPixels for frame " << frame.index;
+    frame.decode_error = ostr.str();
+    FML_LOG(ERROR) << frame.decode_error;
+    return frame;
   }
 
   const bool keep_current_frame =
@@ -132,7 +178,7 @@ MultiFrameCodec::State::GetNextFrameImage(
     // Replace the stored frame. The `lastRequiredFrame_` will get used as the
     // starting backdrop for the next frame.
     lastRequiredFrame_ = bitmap;
-    lastRequiredFrameIndex_ = nextFrameIndex_;
+    lastRequiredFrameIndex_ = frame.index;
   }
 
   if (frameInfo.disposal_method ==
@@ -142,6 +188,60 @@ MultiFrameCodec::State::GetNextFrameImage(
     restoreBGColorRect_.reset();
   }
 
+  frame.bitmap = std::move(bitmap);
+  frame.duration = frameInfo.duration;
+  return frame;
+}
+
+MultiFrameCodec::State::DecodedFrame
+MultiFrameCodec::State::TakeDecodedFrame() {
+  std::scoped_lock lock(decode_mutex_);
+  if (decodedFrames_.empty()) {
+    return DecodeNextFrame();
+  }
+  DecodedFrame frame = std::move(decodedFrames_.front());
+  decodedFrames_.pop_front();
+  return frame;
+}
+
+void MultiFrameCodec::State::DecodeAhead(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner) {
+  if (decode_ahead_frames_ == 0 || !concurrent_runner) {
+    return;
+  }
+  {
+    std::scoped_lock lock(decode_mutex_);
+    if (all_frames_cached_ || decode_ahead_pending_ ||
+        decodedFrames_.size() >= decode_ahead_frames_) {
+      return;
+    }
+    decode_ahead_pending_ = true;
+  }
+  concurrent_runner->PostTask([weak_state = weak_from_this()]() {
+    auto state = weak_state.lock();
+    if (!state) {
+      return;
+    }
+    // The lock is released between frames, so that the IO thread waits for at
+    // most one frame when it needs the next frame before it is decoded.
+    while (true) {
+      std::scoped_lock lock(state->decode_mutex_);
+      if (state->all_frames_cached_ ||
+          state->decodedFrames_.size() >= state->decode_ahead_frames_) {
+        state->decode_ahead_pending_ = false;
+        return;
+      }
+      state->decodedFrames_.push_back(state->DecodeNextFrame());
+    }
+  });
+}
+
+std::pair<sk_sp<DlImage>, std::string> MultiFrameCodec::State::UploadFrame(
+    const SkBitmap& bitmap,
+    const fml::WeakPtr<GrDirectContext>& resourceContext,
+    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+    const std::shared_ptr<impeller::Context>& impeller_context,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
 #if IMPELLER_SUPPORTS_RENDERING
   if (is_impeller_enabled_) {
     // This is safe regardless of whether the GPU is available or not because
@@ -185,6 +285,50 @@ MultiFrameCodec::State::GetNextFrameImage(
 #endif  //  !SLIMPELLER
 }
 
+std::pair<sk_sp<DlImage>, std::string>
+MultiFrameCodec::State::GetNextFrameImage(
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+    const std::shared_ptr<impeller::Context>& impeller_context,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner,
+    int* duration) {
+  if (cache_all_frames_ && cachedFrameCount_ == frameCount_) {
+    const auto& [image, frame_duration] = cachedFrames_[nextFrameIndex_];
+    *duration = frame_duration;
+    return std::make_pair(image, std::string());
+  }
+
+  DecodedFrame frame = TakeDecodedFrame();
+  FML_DCHECK(frame.index == nextFrameIndex_);
+  // Decode the following frames while this one is uploaded.
+  DecodeAhead(concurrent_runner);
+  if (!frame.bitmap.has_value()) {
+    return std::make_pair(nullptr, std::move(frame.decode_error));
+  }
+
+  auto result = UploadFrame(frame.bitmap.value(), resourceContext,
+                            gpu_disable_sync_switch, impeller_context,
+                            std::move(unref_queue));
+  if (!result.first) {
+    return result;
+  }
+  *duration = frame.duration;
+
+  if (cache_all_frames_ && !cachedFrames_[frame.index].first) {
+    cachedFrames_[frame.index] = std::make_pair(result.first, frame.duration);
+    if (++cachedFrameCount_ == frameCount_) {
+      // Nothing needs to be decoded anymore, drop the decoder state.
+      std::scoped_lock lock(decode_mutex_);
+      all_frames_cached_ = true;
+      decodedFrames_.clear();
+      lastRequiredFrame_.reset();
+      restoreBGColorRect_.reset();
+    }
+  }
+  return result;
+}
+
 void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     std::unique_ptr<tonic::DartPersistentValue> callback,
     const fml::RefPtr<fml::TaskRunner>& ui_task_runner,
@@ -192,20 +336,18 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
     const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
     size_t trace_id,
-    const std::shared_ptr<impeller::Context>& impeller_context) {
+    const std::shared_ptr<impeller::Context>& impeller_context,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner) {
   fml::RefPtr<CanvasImage> image = nullptr;
   int duration = 0;
   sk_sp<DlImage> dlImage;
   std::string decode_error;
-  std::tie(dlImage, decode_error) =
-      GetNextFrameImage(std::move(resourceContext), gpu_disable_sync_switch,
-                        impeller_context, std::move(unref_queue));
+  std::tie(dlImage, decode_error) = GetNextFrameImage(
+      std::move(resourceContext), gpu_disable_sync_switch, impeller_context,
+      std::move(unref_queue), concurrent_runner, &duration);
   if (dlImage) {
     image = CanvasImage::Create();
     image->set_image(dlImage);
-    ImageGenerator::FrameInfo frameInfo =
-        generator_->GetFrameInfo(nextFrameIndex_);
-    duration = frameInfo.duration;
   }
   nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
@@ -249,7 +391,8 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
        ui_task_runner = task_runners.GetUITaskRunner(),
-       io_manager = dart_state->GetIOManager()]() mutable {
+       io_manager = dart_state->GetIOManager(),
+       concurrent_runner = dart_state->GetConcurrentTaskRunner()]() mutable {
         auto state = weak_state.lock();
         if (!state) {
           ui_task_runner->PostTask(fml::MakeCopyable(
@@ -260,7 +403,7 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
             std::move(callback), ui_task_runner,
             io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
             io_manager->GetIsGpuDisabledSyncSwitch(), trace_id,
-            io_manager->GetImpellerContext());
+            io_manager->GetImpellerContext(), concurrent_runner);
       }));
 
   return Dart_Null();
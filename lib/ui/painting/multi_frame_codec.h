@@ -5,18 +5,42 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_CODEC_H_
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image_generator.h"
 
+#include <deque>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 namespace flutter {
 
 class MultiFrameCodec : public Codec {
  public:
+  struct Options {
+    // The number of frames that are decoded on the concurrent task runner
+    // ahead of the frame Dart asks for next. 0 decodes every frame when it is
+    // asked for.
+    size_t decode_ahead_frames = 0;
+    // If all of the decoded frames of an animation fit in this many bytes, the
+    // frames are kept after they are first decoded, and later loops of the
+    // animation don't decode any frames. 0 keeps no frames.
+    size_t frame_cache_max_bytes = 0;
+  };
+
   explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator);
 
+  MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                  const Options& options);
+
+  // Codecs that share a generator must share the |generator_mutex| too, as
+  // they decode frames on the IO thread and on the concurrent task runner.
+  MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                  const Options& options,
+                  std::shared_ptr<std::mutex> generator_mutex);
+
   ~MultiFrameCodec() override;
 
   // |Codec|
@@ -38,18 +62,45 @@ class MultiFrameCodec : public Codec {
   // Instead, the MultiFrameCodec creates this object when it is constructed,
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
-  struct State {
-    explicit State(std::shared_ptr<ImageGenerator> generator);
+  struct State : public std::enable_shared_from_this<State> {
+    State(std::shared_ptr<ImageGenerator> generator,
+          const Options& options,
+          std::shared_ptr<std::mutex> generator_mutex);
+
+    // A frame composited on top of the frames it depends on, but not yet
+    // uploaded.
+    struct DecodedFrame {
+      int index = 0;
+      std::optional<SkBitmap> bitmap;
+      int duration = 0;
+      std::string decode_error;
+    };
 
     const std::shared_ptr<ImageGenerator> generator_;
+    // Guards the generator, which may be shared with other codecs. Taken
+    // after |decode_mutex_|.
+    const std::shared_ptr<std::mutex> generator_mutex_;
     const int frameCount_;
     const int repetitionCount_;
     bool is_impeller_enabled_ = false;
+    const size_t decode_ahead_frames_;
+    // Whether all of the frames fit in the frame cache.
+    const bool cache_all_frames_;
 
-    // The non-const members and functions below here are only read or written
-    // to on the IO thread. They are not safe to access or write on the UI
-    // thread.
+    // The non-const members below here until |decode_mutex_| are only read or
+    // written to on the IO thread. They are not safe to access or write on the
+    // UI thread.
     int nextFrameIndex_ = 0;
+    // The uploaded frames and their durations, if |cache_all_frames_|.
+    std::vector<std::pair<sk_sp<DlImage>, int>> cachedFrames_;
+    int cachedFrameCount_ = 0;
+
+    // Guards the members below, which are shared between the IO thread and
+    // the decode ahead tasks on the concurrent task runner.
+    std::mutex decode_mutex_;
+    // The index of the next frame to decode, which is ahead of
+    // |nextFrameIndex_| by the number of |decodedFrames_|.
+    int nextDecodeIndex_ = 0;
     // The last decoded frame that's required to decode any subsequent frames.
     std::optional<SkBitmap> lastRequiredFrame_;
     // The index of the last decoded required frame.
@@ -59,11 +110,38 @@ class MultiFrameCodec : public Codec {
     // method was kRestoreBGColor.
     std::optional<SkIRect> restoreBGColorRect_;
 
+    // The frames that were decoded ahead, in order.
+    std::deque<DecodedFrame> decodedFrames_;
+    bool decode_ahead_pending_ = false;
+    // Set once all of the frames are cached, and nothing is decoded anymore.
+    bool all_frames_cached_ = false;
+
+    // Decodes the frame at |nextDecodeIndex_|. |decode_mutex_| must be held.
+    DecodedFrame DecodeNextFrame();
+
+    // Takes the next decoded frame, decoding it now if it was not decoded
+    // ahead.
+    DecodedFrame TakeDecodedFrame();
+
+    // Decodes frames on the concurrent task runner until there are
+    // |decode_ahead_frames_| of them.
+    void DecodeAhead(
+        const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner);
+
+    std::pair<sk_sp<DlImage>, std::string> UploadFrame(
+        const SkBitmap& bitmap,
+        const fml::WeakPtr<GrDirectContext>& resourceContext,
+        const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+        const std::shared_ptr<impeller::Context>& impeller_context,
+        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+
     std::pair<sk_sp<DlImage>, std::string> GetNextFrameImage(
         fml::WeakPtr<GrDirectContext> resourceContext,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
         const std::shared_ptr<impeller::Context>& impeller_context,
-        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+        const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner,
+        int* duration);
 
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<tonic::DartPersistentValue> callback,
@@ -72,7 +150,8 @@ class MultiFrameCodec : public Codec {
         fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
         size_t trace_id,
-        const std::shared_ptr<impeller::Context>& impeller_context);
+        const std::shared_ptr<impeller::Context>& impeller_context,
+        const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner);
   };
 
   // Shared across the UI and IO task runners.
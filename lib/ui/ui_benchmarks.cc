@@ -4,14 +4,30 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "flutter/testing/post_task_sync.h"
+#include "flutter/testing/test_dart_native_resolver.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/encode/SkPngEncoder.h"
 
+#if IMPELLER_SUPPORTS_RENDERING
+#include "flutter/lib/ui/painting/image_decoder_impeller.h"
+#include "flutter/lib/ui/painting/image_decoder_no_gl_unittests.h"
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
+#include <algorithm>
+#include <atomic>
 #include <future>
+#include <thread>
 
 namespace flutter {
 
@@ -112,6 +128,297 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+#if !SLIMPELLER
+namespace {
+
+// An IO manager without a GPU context, so that the frames of animated images
+// stay in host memory.
+class RasterIOManager final : public IOManager {
+ public:
+  explicit RasterIOManager(fml::RefPtr<fml::TaskRunner> task_runner)
+      : unref_queue_(fml::MakeRefCounted<SkiaUnrefQueue>(
+            std::move(task_runner),
+            fml::TimeDelta::FromNanoseconds(0))),
+        is_gpu_disabled_sync_switch_(std::make_shared<fml::SyncSwitch>()),
+        weak_factory_(this) {}
+
+  // |IOManager|
+  fml::WeakPtr<IOManager> GetWeakIOManager() const override {
+    return weak_factory_.GetWeakPtr();
+  }
+
+  // |IOManager|
+  fml::WeakPtr<GrDirectContext> GetResourceContext() const override {
+    return {};
+  }
+
+  // |IOManager|
+  fml::RefPtr<flutter::SkiaUnrefQueue> GetSkiaUnrefQueue() const override {
+    return unref_queue_;
+  }
+
+  // |IOManager|
+  std::shared_ptr<const fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() override {
+    return is_gpu_disabled_sync_switch_;
+  }
+
+ private:
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+  std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
+  fml::WeakPtrFactory<RasterIOManager> weak_factory_;
+};
+
+// Plays a still image as an animation of |frame_count| frames, each of which
+// decodes the image again.
+class LoopingImageGenerator final : public ImageGenerator {
+ public:
+  LoopingImageGenerator(std::shared_ptr<ImageGenerator> generator,
+                        unsigned int frame_count)
+      : generator_(std::move(generator)), frame_count_(frame_count) {}
+
+  const SkImageInfo& GetInfo() override { return generator_->GetInfo(); }
+
+  unsigned int GetFrameCount() const override { return frame_count_; }
+
+  unsigned int GetPlayCount() const override { return kInfinitePlayCount; }
+
+  const ImageGenerator::FrameInfo GetFrameInfo(
+      unsigned int frame_index) override {
+    return {std::nullopt, 16, SkCodecAnimation::DisposalMethod::kKeep};
+  }
+
+  SkISize GetScaledDimensions(float scale) override {
+    return generator_->GetScaledDimensions(scale);
+  }
+
+  bool GetPixels(const SkImageInfo& info,
+                 void* pixels,
+                 size_t row_bytes,
+                 unsigned int frame_index,
+                 std::optional<unsigned int> prior_frame) override {
+    decoded_frame_count_++;
+    return generator_->GetPixels(info, pixels, row_bytes, 0, std::nullopt);
+  }
+
+  size_t decoded_frame_count() const { return decoded_frame_count_; }
+
+ private:
+  const std::shared_ptr<ImageGenerator> generator_;
+  const unsigned int frame_count_;
+  std::atomic_size_t decoded_frame_count_{0};
+};
+
+// A 480x640 PNG.
+sk_sp<SkData> EncodeAnimationFramePng() {
+  sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(
+      testing::OpenFixtureAsSkData("DashInNooglerHat.jpg"));
+  if (!image) {
+    return nullptr;
+  }
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(SkImageInfo::MakeN32Premul(480, 640)) ||
+      !image->scalePixels(bitmap.pixmap(), SkSamplingOptions())) {
+    return nullptr;
+  }
+  return SkPngEncoder::Encode(nullptr, SkImages::RasterFromBitmap(bitmap).get(),
+                              {});
+}
+
+}  // namespace
+
+// Measures the time from asking a multi-frame codec for the next frame of a
+// looping 100 frame animation to receiving it on the UI thread, as an
+// animated image widget does. The time between frames, in which frames can be
+// decoded ahead, is not measured.
+static void BM_AnimatedImageLoop(benchmark::State& state,
+                                 MultiFrameCodec::Options options) {
+  constexpr unsigned int kFrameCount = 100;
+  constexpr auto kFrameInterval = std::chrono::milliseconds(8);
+
+  sk_sp<SkData> data = EncodeAnimationFramePng();
+  if (!data) {
+    state.SkipWithError("Could not encode the animation frame.");
+    return;
+  }
+  ImageGeneratorRegistry registry;
+  auto generator = std::make_shared<LoopingImageGenerator>(
+      registry.CreateCompatibleGenerator(data), kFrameCount);
+
+  ThreadHost thread_host(ThreadHost::ThreadHostConfig(
+      "test", ThreadHost::Type::kPlatform | ThreadHost::Type::kRaster |
+                  ThreadHost::Type::kIo | ThreadHost::Type::kUi));
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  fml::AutoResetWaitableEvent frame_latch;
+  fixture.AddNativeCallback(
+      "ValidateFrameCallback",
+      CREATE_NATIVE_ENTRY([&frame_latch](Dart_NativeArguments args) {
+        frame_latch.Signal();
+      }));
+  auto settings = fixture.CreateSettingsForFixture();
+  settings.enable_impeller = false;
+  auto vm_ref = DartVMRef::Create(settings);
+
+  std::unique_ptr<RasterIOManager> io_manager;
+  testing::PostTaskSync(task_runners.GetIOTaskRunner(), [&]() {
+    io_manager =
+        std::make_unique<RasterIOManager>(task_runners.GetIOTaskRunner());
+  });
+  auto isolate = testing::RunDartCodeInIsolate(
+      vm_ref, settings, task_runners, "main", {},
+      testing::GetDefaultKernelFilePath(), io_manager->GetWeakIOManager());
+
+  fml::RefPtr<MultiFrameCodec> codec;
+  while (state.KeepRunning()) {
+    bool successful = isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle closure = Dart_GetField(
+          Dart_RootLibrary(), Dart_NewStringFromCString("frameCallback"));
+      if (!codec) {
+        codec = fml::MakeRefCounted<MultiFrameCodec>(generator, options);
+      }
+      codec->getNextFrame(closure);
+      return true;
+    });
+    FML_CHECK(successful);
+    frame_latch.Wait();
+
+    state.PauseTiming();
+    std::this_thread::sleep_for(kFrameInterval);
+    state.ResumeTiming();
+  }
+  state.counters["DecodesPerFrame"] = benchmark::Counter(
+      generator->decoded_frame_count(), benchmark::Counter::kAvgIterations);
+
+  isolate = nullptr;
+  testing::PostTaskSync(task_runners.GetUITaskRunner(),
+                        [&]() { codec = nullptr; });
+  testing::PostTaskSync(task_runners.GetIOTaskRunner(),
+                        [&]() { io_manager.reset(); });
+}
+
+// Each benchmark plays the animation three times.
+BENCHMARK_CAPTURE(BM_AnimatedImageLoop,
+                  decode_on_demand,
+                  MultiFrameCodec::Options{.decode_ahead_frames = 0,
+                                           .frame_cache_max_bytes = 0})
+    ->Iterations(300)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_AnimatedImageLoop,
+                  decode_ahead,
+                  MultiFrameCodec::Options{.decode_ahead_frames = 2,
+                                           .frame_cache_max_bytes = 0})
+    ->Iterations(300)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_AnimatedImageLoop,
+                  frame_cache,
+                  MultiFrameCodec::Options{
+                      .decode_ahead_frames = 2,
+                      .frame_cache_max_bytes = 128 * 1024 * 1024})
+    ->Iterations(300)
+    ->Unit(benchmark::kMillisecond);
+#endif  // !SLIMPELLER
+
+#if IMPELLER_SUPPORTS_RENDERING
+namespace {
+
+// Records the largest number of bytes held by the device buffers it created at
+// the same time.
+class PeakTrackingAllocator final : public impeller::Allocator {
+ public:
+  size_t GetPeakBytes() const { return peak_bytes_; }
+
+ private:
+  size_t live_bytes_ = 0u;
+  size_t peak_bytes_ = 0u;
+
+  uint16_t MinimumBytesPerRow(impeller::PixelFormat format) const override {
+    return 0;
+  }
+
+  impeller::ISize GetMaxTextureSizeSupported() const override {
+    return impeller::ISize{16384, 16384};
+  }
+
+  std::shared_ptr<impeller::DeviceBuffer> OnCreateBuffer(
+      const impeller::DeviceBufferDescriptor& desc) override {
+    live_bytes_ += desc.size;
+    peak_bytes_ = std::max(peak_bytes_, live_bytes_);
+    return std::shared_ptr<impeller::DeviceBuffer>(
+        new impeller::TestImpellerDeviceBuffer(desc),
+        [this, size = desc.size](impeller::DeviceBuffer* buffer) {
+          live_bytes_ -= size;
+          delete buffer;
+        });
+  }
+
+  std::shared_ptr<impeller::Texture> OnCreateTexture(
+      const impeller::TextureDescriptor& desc) override {
+    return std::make_shared<impeller::TestImpellerTexture>(desc);
+  }
+};
+
+// A 3024x4032 JPEG.
+sk_sp<SkData> LoadLargeJpeg() {
+  return testing::OpenFixtureAsSkData("DashInNooglerHat.jpg");
+}
+
+// The JPEG fixture re-encoded as a PNG of the same size.
+sk_sp<SkData> EncodeLargePng() {
+  sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(LoadLargeJpeg());
+  if (!image) {
+    return nullptr;
+  }
+  return SkPngEncoder::Encode(nullptr, image->makeRasterImage().get(), {});
+}
+
+}  // namespace
+
+// Measures decoding a large image into a thumbnail of |target_size| with the
+// Impeller image decoder, and the peak size of the buffers it allocates.
+static void BM_ImageDecodeToTargetSize(benchmark::State& state,
+                                       sk_sp<SkData> (*load_image)(),
+                                       SkISize target_size) {
+  sk_sp<SkData> data = load_image();
+  if (!data) {
+    state.SkipWithError("Could not load the image.");
+    return;
+  }
+  ImageGeneratorRegistry registry;
+  auto allocator = std::make_shared<PeakTrackingAllocator>();
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    std::shared_ptr<ImageGenerator> generator =
+        registry.CreateCompatibleGenerator(data);
+    auto descriptor =
+        fml::MakeRefCounted<ImageDescriptor>(data, std::move(generator));
+    state.ResumeTiming();
+
+    DecompressResult result = ImageDecoderImpeller::DecompressTexture(
+        descriptor.get(), target_size, {16384, 16384},
+        /*supports_wide_gamut=*/false, allocator);
+    if (!result.device_buffer) {
+      state.SkipWithError(result.decode_error.c_str());
+      break;
+    }
+  }
+  state.counters["PeakBufferBytes"] = allocator->GetPeakBytes();
+}
+
+BENCHMARK_CAPTURE(BM_ImageDecodeToTargetSize,
+                  jpeg_thumbnail,
+                  &LoadLargeJpeg,
+                  SkISize::Make(300, 400))
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ImageDecodeToTargetSize,
+                  png_thumbnail,
+                  &EncodeLargePng,
+                  SkISize::Make(300, 400))
+    ->Unit(benchmark::kMillisecond);
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
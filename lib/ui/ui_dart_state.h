@@ -29,6 +29,8 @@
 
 namespace flutter {
 class FontSelector;
+// Declared here too, image_decoder.h includes this header through codec.h.
+class ImageDecoder;
 class ImageGeneratorRegistry;
 class PlatformConfiguration;
 class PlatformMessage;
@@ -4,16 +4,26 @@
 
 #include "flutter/runtime/dart_snapshot.h"
 
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <utility>
 
 #include <third_party/dart/runtime/bin/elf_loader.h>
+#include "flutter/fml/closure.h"
 #include "flutter/fml/native_library.h"
 #include "flutter/fml/paths.h"
+#include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/snapshot/snapshot.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/runtime/dart_vm_lifecycle.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 
+#if !FML_OS_WIN
+#include <sys/mman.h>
+#endif  // !FML_OS_WIN
+
 namespace flutter {
 
 const char* DartSnapshot::kVMDataSymbol = "kDartVmSnapshotData";
@@ -30,6 +40,129 @@ const char* DartSnapshot::kIsolateInstructionsSymbol =
 
 #if !DART_SNAPSHOT_STATIC_LINK
 
+using PreloadedMapping = std::shared_ptr<const fml::FileMapping>;
+
+// A preload of one path. Whichever of the preload task and |JoinPreload|
+// claims it first decides whether the file is mapped: a preload that has not
+// started by the time its library is needed is dropped instead of waited on.
+struct Preload {
+  std::mutex mutex;
+  bool claimed = false;
+  fml::ManualResetWaitableEvent mapped;
+  PreloadedMapping mapping;
+};
+
+// Preloads started by |PreloadNativeLibrary| that have not been joined or
+// released yet, keyed by path.
+static std::mutex gPreloadMutex;
+static std::map<std::string, std::shared_ptr<Preload>> gPreloads;
+
+static PreloadedMapping MapAndPrefetch(const std::string& path) {
+  TRACE_EVENT0("flutter", "DartSnapshot::PreloadNativeLibrary");
+  PreloadedMapping mapping = fml::FileMapping::CreateReadOnly(path);
+  if (!mapping || mapping->GetMapping() == nullptr) {
+    return nullptr;
+  }
+#if !FML_OS_WIN
+  // The mapping is page aligned since it comes straight from mmap. This only
+  // schedules readahead; the later dlopen/ELF load of the same file then hits
+  // the page cache instead of faulting each page in from disk.
+  ::madvise(const_cast<uint8_t*>(mapping->GetMapping()), mapping->GetSize(),
+            MADV_WILLNEED);
+#endif  // !FML_OS_WIN
+  return mapping;
+}
+
+static void RunPreload(const std::shared_ptr<Preload>& preload,
+                       const std::string& path) {
+  {
+    std::scoped_lock lock(preload->mutex);
+    if (preload->claimed) {
+      return;
+    }
+    preload->claimed = true;
+  }
+  preload->mapping = MapAndPrefetch(path);
+  preload->mapped.Signal();
+}
+
+#endif  // !DART_SNAPSHOT_STATIC_LINK
+
+void DartSnapshot::PreloadNativeLibrary(
+    const std::string& path,
+    const fml::RefPtr<fml::TaskRunner>& runner) {
+#if DART_SNAPSHOT_STATIC_LINK
+  // Snapshots are linked into the executable, so no library is ever loaded
+  // from |path| and nothing would join the preload.
+  return;
+#else   // DART_SNAPSHOT_STATIC_LINK
+  // Only AOT snapshots are resolved from native libraries.
+  if (!DartVM::IsRunningPrecompiledCode()) {
+    return;
+  }
+  // A running VM is reused by the next launch, which then never loads the
+  // library.
+  if (DartVMRef::IsInstanceRunning()) {
+    return;
+  }
+  auto preload = std::make_shared<Preload>();
+  {
+    std::scoped_lock lock(gPreloadMutex);
+    // A preload of |path| that is still pending already covers this one.
+    // Once it is joined or released its entry is erased, so |path| can be
+    // preloaded again.
+    if (!gPreloads.emplace(path, preload).second) {
+      return;
+    }
+  }
+  if (!runner) {
+    RunPreload(preload, path);
+    return;
+  }
+  runner->PostTask([preload, path]() { RunPreload(preload, path); });
+#endif  // DART_SNAPSHOT_STATIC_LINK
+}
+
+#if !DART_SNAPSHOT_STATIC_LINK
+
+// Forgets any preload of |path| started by PreloadNativeLibrary and returns
+// its mapping, waiting for it if it is being mapped right now. Returns
+// nullptr if no preload of |path| is pending or it had not started yet.
+static PreloadedMapping JoinPreload(const std::string& path) {
+  std::shared_ptr<Preload> preload;
+  {
+    std::scoped_lock lock(gPreloadMutex);
+    auto found = gPreloads.find(path);
+    if (found == gPreloads.end()) {
+      return nullptr;
+    }
+    preload = std::move(found->second);
+    gPreloads.erase(found);
+  }
+  {
+    std::scoped_lock lock(preload->mutex);
+    if (!preload->claimed) {
+      preload->claimed = true;
+      return nullptr;
+    }
+  }
+  TRACE_EVENT0("flutter", "DartSnapshot::JoinPreload");
+  preload->mapped.Wait();
+  return preload->mapping;
+}
+
+#endif  // !DART_SNAPSHOT_STATIC_LINK
+
+void DartSnapshot::ReleasePreloads(const std::vector<std::string>& paths) {
+#if !DART_SNAPSHOT_STATIC_LINK
+  for (const std::string& path : paths) {
+    JoinPreload(path);
+  }
+#endif  // !DART_SNAPSHOT_STATIC_LINK
+}
+
+#if !DART_SNAPSHOT_STATIC_LINK
+
 static std::unique_ptr<const fml::Mapping> GetFileMapping(
     const std::string& path,
     bool executable) {
@@ -57,6 +190,12 @@ static std::shared_ptr<const fml::Mapping> SearchMapping(
     const std::vector<std::string>& native_library_path,
     const char* native_library_symbol_name,
     bool is_executable) {
+  // Whichever way the mapping is resolved, no preload of these paths is
+  // joined after this returns.
+  fml::ScopedCleanupClosure release_preloads([&native_library_path]() {
+    DartSnapshot::ReleasePreloads(native_library_path);
+  });
+
 #if FML_OS_IOS
   // Detect when we're trying to load a Shorebird patch.
   auto patch_path = native_library_path.front();
@@ -79,7 +218,11 @@ static std::shared_ptr<const fml::Mapping> SearchMapping(
     if (leaked_elf == nullptr) {
       const char* error = nullptr;
       // vmcode files are elf files prefixed with a shorebird linker header.
-      auto elf_mapping = GetFileMapping(patch_path, false /* executable */);
+      std::shared_ptr<const fml::Mapping> elf_mapping =
+          JoinPreload(patch_path);
+      if (!elf_mapping) {
+        elf_mapping = GetFileMapping(patch_path, false /* executable */);
+      }
       int elf_file_offset = Shorebird_ReadLinkHeader(elf_mapping->GetMapping(),
                                                      elf_mapping->GetSize());
 
@@ -133,6 +276,9 @@ static std::shared_ptr<const fml::Mapping> SearchMapping(
 
     // Look in application specified native library if specified.
     for (const std::string& path : native_library_path) {
+      // Make sure any readahead of this library has finished so that loading
+      // it does not contend with the preload for the same pages.
+      JoinPreload(path);
       auto native_library = fml::NativeLibrary::Create(path.c_str());
       auto symbol_mapping = std::make_unique<const fml::SymbolMapping>(
           native_library, native_library_symbol_name);
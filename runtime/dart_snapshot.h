@@ -7,10 +7,12 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/task_runner.h"
 
 namespace flutter {
 
@@ -123,6 +125,41 @@ class DartSnapshot : public fml::RefCountedThreadSafe<DartSnapshot> {
   static fml::RefPtr<DartSnapshot> VMServiceIsolateSnapshotFromSettings(
       const Settings& settings);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Start mapping the native library at the given path and ask
+  ///             the kernel to read it ahead.
+  ///
+  ///             This is meant to be called as soon as the embedder knows
+  ///             which library (e.g. a Shorebird patch) the snapshots will be
+  ///             resolved from, so that the I/O overlaps with the rest of
+  ///             engine and platform view setup. Resolving snapshots from
+  ///             `Settings::application_library_path` joins on the preload
+  ///             before opening the same path, and releases the preloads of
+  ///             any paths it did not need to open. A preload that has not
+  ///             started by then is dropped rather than waited on.
+  ///
+  ///             This does nothing unless the snapshots are resolved from
+  ///             native libraries, i.e. when running precompiled code and the
+  ///             snapshots are not linked into the executable, or when a VM
+  ///             is already running, since the next launch reuses it.
+  ///
+  /// @param[in]  path    The path of the native library to preload.
+  /// @param[in]  runner  The task runner to map the library on. If this is
+  ///                     null, the library is mapped on the calling thread.
+  ///                     The readahead itself happens asynchronously in the
+  ///                     kernel either way.
+  ///
+  static void PreloadNativeLibrary(const std::string& path,
+                                   const fml::RefPtr<fml::TaskRunner>& runner);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Release the pending preloads of the given paths without
+  ///             loading them, waiting for any that are being mapped.
+  ///
+  /// @param[in]  paths  The paths whose preloads to release.
+  ///
+  static void ReleasePreloads(const std::vector<std::string>& paths);
+
   //----------------------------------------------------------------------------
   /// @brief      Determines if this snapshot contains a heap component. Since
   ///             the instructions component is optional, the method does not
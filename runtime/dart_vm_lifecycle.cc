@@ -7,6 +7,8 @@
 #include <mutex>
 #include <utility>
 
+#include "flutter/runtime/dart_snapshot.h"
+
 namespace flutter {
 
 // We need to explicitly put the constructor and destructor of the DartVM in the
@@ -61,7 +63,9 @@ DartVMRef DartVMRef::Create(const Settings& settings,
     FML_DLOG(WARNING) << "Attempted to create a VM in a process where one was "
                          "already running. Ignoring arguments for current VM "
                          "create call and reusing the old VM.";
-    // There was already a running VM in the process,
+    // There was already a running VM in the process, so nothing loads the
+    // libraries these settings would have resolved the snapshots from.
+    DartSnapshot::ReleasePreloads(settings.application_library_path);
     return DartVMRef{std::move(vm)};
   }
 
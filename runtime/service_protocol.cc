@@ -42,6 +42,9 @@ const std::string_view
         "_flutter.renderFrameWithRasterStats";
 const std::string_view ServiceProtocol::kReloadAssetFonts =
     "_flutter.reloadAssetFonts";
+const std::string_view
+    ServiceProtocol::kGetDecodedImageCacheStatsExtensionName =
+        "_flutter.getDecodedImageCacheStats";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -63,6 +66,7 @@ ServiceProtocol::ServiceProtocol()
           kEstimateRasterCacheMemoryExtensionName,
           kRenderFrameWithRasterStatsExtensionName,
           kReloadAssetFonts,
+          kGetDecodedImageCacheStatsExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
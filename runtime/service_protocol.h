@@ -31,6 +31,7 @@ class ServiceProtocol {
   static const std::string_view kEstimateRasterCacheMemoryExtensionName;
   static const std::string_view kRenderFrameWithRasterStatsExtensionName;
   static const std::string_view kReloadAssetFonts;
+  static const std::string_view kGetDecodedImageCacheStatsExtensionName;
 
   class Handler {
    public:
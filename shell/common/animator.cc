@@ -4,6 +4,8 @@
 
 #include "flutter/shell/common/animator.h"
 
+#include <utility>
+
 #include "flutter/common/constants.h"
 #include "flutter/flow/frame_timings.h"
 #include "flutter/fml/time/time_point.h"
@@ -20,6 +22,27 @@ namespace {
 constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
     fml::TimeDelta::FromMilliseconds(51);
 
+// Number of consecutive frames that must rasterize within their vsync budget
+// before an extra frame the pipeline was deepened by is given back.
+constexpr size_t kFramesWithinBudgetBeforeShallowingPipeline = 30;
+
+// The number of frames the UI thread may have in flight ahead of the raster
+// thread when rasterization keeps up with vsync.
+uint32_t GetBasePipelineDepth(
+    [[maybe_unused]] const TaskRunners& task_runners) {
+#if SHELL_ENABLE_METAL
+  return 2;
+#else   // SHELL_ENABLE_METAL
+  // TODO(dnfield): We should remove this logic and set the pipeline depth
+  // back to 2 in this case. See
+  // https://github.com/flutter/engine/pull/9132 for discussion.
+  return task_runners.GetPlatformTaskRunner() ==
+                 task_runners.GetRasterTaskRunner()
+             ? 1
+             : 2;
+#endif  // SHELL_ENABLE_METAL
+}
+
 }  // namespace
 
 Animator::Animator(Delegate& delegate,
@@ -28,18 +51,13 @@ Animator::Animator(Delegate& delegate,
     : delegate_(delegate),
       task_runners_(task_runners),
       waiter_(std::move(waiter)),
-#if SHELL_ENABLE_METAL
-      layer_tree_pipeline_(std::make_shared<FramePipeline>(2)),
-#else   // SHELL_ENABLE_METAL
-      // TODO(dnfield): We should remove this logic and set the pipeline depth
-      // back to 2 in this case. See
-      // https://github.com/flutter/engine/pull/9132 for discussion.
+      base_pipeline_depth_(GetBasePipelineDepth(task_runners)),
+      // A pipeline of depth 1 is used when the platform and raster threads
+      // are the same, which must not be deepened either.
       layer_tree_pipeline_(std::make_shared<FramePipeline>(
-          task_runners.GetPlatformTaskRunner() ==
-                  task_runners.GetRasterTaskRunner()
-              ? 1
-              : 2)),
-#endif  // SHELL_ENABLE_METAL
+          base_pipeline_depth_,
+          base_pipeline_depth_ > 1 ? base_pipeline_depth_ + 1
+                                   : base_pipeline_depth_)),
       pending_frame_semaphore_(1),
       weak_factory_(this) {
 }
@@ -58,6 +76,11 @@ void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
       });
 }
 
+void Animator::OnPointerInput() {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  has_pointer_input_ = true;
+}
+
 void Animator::BeginFrame(
     std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) {
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending",
@@ -71,6 +94,10 @@ void Animator::BeginFrame(
   frame_timings_recorder_ = std::move(frame_timings_recorder);
   frame_timings_recorder_->RecordBuildStart(fml::TimePoint::Now());
 
+  UpdatePipelineDepth(frame_timings_recorder_->GetVsyncTargetTime() -
+                          frame_timings_recorder_->GetVsyncStartTime(),
+                      std::exchange(has_pointer_input_, false));
+
   size_t flow_id_count = trace_flow_ids_.size();
   std::unique_ptr<uint64_t[]> flow_ids =
       std::make_unique<uint64_t[]>(flow_id_count);
@@ -103,6 +130,7 @@ void Animator::BeginFrame(
       // full because the consumer is being too slow. Try again at the next
       // frame interval.
       TRACE_EVENT0("flutter", "PipelineFull");
+      dropped_frame_count_++;
       RequestFrame();
       return;
     }
@@ -139,6 +167,9 @@ void Animator::EndFrame() {
       layer_tree_task_list.push_back(std::move(layer_tree_task));
     }
     layer_trees_tasks_.clear();
+    frame_timings_recorder_->RecordPipelineState(
+        layer_tree_pipeline_->GetDepth(), dropped_frame_count_);
+    dropped_frame_count_ = 0;
     PipelineProduceResult result = producer_continuation_.Complete(
         std::make_unique<FrameItem>(std::move(layer_tree_task_list),
                                     std::move(frame_timings_recorder_)));
@@ -210,6 +241,36 @@ void Animator::Render(int64_t view_id,
                                                device_pixel_ratio));
 }
 
+void Animator::UpdatePipelineDepth(fml::TimeDelta frame_budget,
+                                   bool has_pointer_input) {
+  const uint32_t max_depth = layer_tree_pipeline_->GetMaxDepth();
+  if (max_depth == base_pipeline_depth_) {
+    return;
+  }
+
+  if (has_pointer_input) {
+    // Every extra frame in flight adds a vsync of latency between the input
+    // and the frame reflecting it, which matters more than throughput here.
+    frames_within_budget_ = 0;
+    layer_tree_pipeline_->SetDepth(base_pipeline_depth_);
+    return;
+  }
+
+  if (layer_tree_pipeline_->GetLastConsumeDuration() > frame_budget) {
+    // The raster thread fell behind. Let the UI thread get a frame further
+    // ahead instead of stalling on a full pipeline.
+    frames_within_budget_ = 0;
+    layer_tree_pipeline_->SetDepth(max_depth);
+    return;
+  }
+
+  if (layer_tree_pipeline_->GetDepth() > base_pipeline_depth_ &&
+      ++frames_within_budget_ >= kFramesWithinBudgetBeforeShallowingPipeline) {
+    frames_within_budget_ = 0;
+    layer_tree_pipeline_->SetDepth(base_pipeline_depth_);
+  }
+}
+
 const std::weak_ptr<VsyncWaiter> Animator::GetVsyncWaiter() const {
   std::weak_ptr<VsyncWaiter> weak = waiter_;
   return weak;
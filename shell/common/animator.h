@@ -112,6 +112,18 @@ class Animator final {
   // rendering.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
+  //--------------------------------------------------------------------------
+  /// @brief    Tells the Animator that pointer events were dispatched to the
+  ///           framework since the last frame.
+  ///
+  ///           While there is pointer input the frame pipeline is kept at its
+  ///           base depth, since every extra frame in flight adds a vsync of
+  ///           latency between the input and the frame that reflects it.
+  ///
+  ///           This method must be called on the UI thread.
+  ///
+  void OnPointerInput();
+
  private:
   // Animator's work during a vsync is split into two methods, BeginFrame and
   // EndFrame. The two methods should be called synchronously back-to-back to
@@ -123,6 +135,11 @@ class Animator final {
 
   bool CanReuseLastLayerTrees();
 
+  // Deepens the pipeline by a frame when rasterizing the last frame took more
+  // than |frame_budget|, and returns it to its base depth when there is
+  // pointer input or once rasterization has kept up for a while.
+  void UpdatePipelineDepth(fml::TimeDelta frame_budget, bool has_pointer_input);
+
   void DrawLastLayerTrees(
       std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder);
 
@@ -140,7 +157,13 @@ class Animator final {
       layer_trees_tasks_;
   uint64_t frame_request_number_ = 1;
   fml::TimeDelta dart_frame_deadline_;
+  const uint32_t base_pipeline_depth_;
   std::shared_ptr<FramePipeline> layer_tree_pipeline_;
+  size_t frames_within_budget_ = 0;
+  bool has_pointer_input_ = false;
+  // Vsyncs skipped because the pipeline was full since the last frame
+  // submitted to it.
+  uint32_t dropped_frame_count_ = 0;
   fml::Semaphore pending_frame_semaphore_;
   FramePipeline::ProducerContinuation producer_continuation_;
   bool regenerate_layer_trees_ = false;
@@ -9,6 +9,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <thread>
 
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
@@ -261,6 +262,130 @@ TEST_F(ShellTest, AnimatorDoesNotNotifyDelegateIfPipelineIsNotEmpty) {
   PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
 }
 
+namespace {
+
+constexpr fml::TimeDelta kFrameBudget = fml::TimeDelta::FromMilliseconds(16);
+
+// Fires each vsync as soon as it is awaited and gives every frame
+// |kFrameBudget| to be built and rasterized in.
+class FixedBudgetVsyncWaiter : public VsyncWaiter {
+ public:
+  explicit FixedBudgetVsyncWaiter(const TaskRunners& task_runners)
+      : VsyncWaiter(task_runners) {}
+
+ protected:
+  void AwaitVSync() override {
+    task_runners_.GetPlatformTaskRunner()->PostTask([this]() {
+      const fml::TimePoint now = fml::TimePoint::Now();
+      FireCallback(now, now + kFrameBudget);
+    });
+  }
+};
+
+// Builds and renders one frame, then consumes it from the pipeline as the
+// rasterizer would, taking |raster_time| to do so. Returns the depth of the
+// pipeline when the frame was submitted.
+uint32_t DrawFrame(const TaskRunners& task_runners,
+                   Animator& animator,
+                   FakeAnimatorDelegate& delegate,
+                   fml::TimeDelta raster_time,
+                   bool pointer_input = false) {
+  fml::AutoResetWaitableEvent drawn;
+  uint32_t depth = 0;
+  task_runners.GetUITaskRunner()->PostTask([&] {
+    EXPECT_CALL(delegate, OnAnimatorBeginFrame).WillOnce([&] {
+      auto layer_tree =
+          std::make_unique<LayerTree>(nullptr, SkISize::Make(600, 800));
+      animator.Render(kImplicitViewId, std::move(layer_tree), 1.0);
+    });
+    EXPECT_CALL(delegate, OnAnimatorDraw)
+        .WillOnce([&](const std::shared_ptr<FramePipeline>& pipeline) {
+          depth = pipeline->GetDepth();
+          pipeline->Consume([&](std::unique_ptr<FrameItem> item) {
+            std::this_thread::sleep_for(
+                std::chrono::microseconds(raster_time.ToMicroseconds()));
+          });
+          drawn.Signal();
+        });
+    if (pointer_input) {
+      animator.OnPointerInput();
+    }
+    animator.RequestFrame();
+  });
+  drawn.Wait();
+  return depth;
+}
+
+}  // namespace
+
+TEST_F(ShellTest, AnimatorDeepensPipelineWhileRasterizationOverruns) {
+  FakeAnimatorDelegate delegate;
+  TaskRunners task_runners = {
+      "test",
+      CreateNewThread(),  // platform
+      CreateNewThread(),  // raster
+      CreateNewThread(),  // ui
+      CreateNewThread()   // io
+  };
+  std::unique_ptr<Animator> animator;
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+    animator = std::make_unique<Animator>(
+        delegate, task_runners,
+        std::make_unique<FixedBudgetVsyncWaiter>(task_runners));
+  });
+
+  const fml::TimeDelta overrun = kFrameBudget * 2;
+  const fml::TimeDelta within_budget = fml::TimeDelta::Zero();
+
+  // The platform and raster threads differ, so the base depth is 2.
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, overrun), 2u);
+  // The last frame took longer than its budget to rasterize.
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, within_budget), 3u);
+  // See kFramesWithinBudgetBeforeShallowingPipeline in animator.cc.
+  for (int i = 0; i < 29; i++) {
+    EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, within_budget), 3u);
+  }
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, overrun), 2u);
+  // An overrun deepens the pipeline again.
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, within_budget), 3u);
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
+}
+
+TEST_F(ShellTest, AnimatorKeepsPipelineAtBaseDepthUnderPointerInput) {
+  FakeAnimatorDelegate delegate;
+  TaskRunners task_runners = {
+      "test",
+      CreateNewThread(),  // platform
+      CreateNewThread(),  // raster
+      CreateNewThread(),  // ui
+      CreateNewThread()   // io
+  };
+  std::unique_ptr<Animator> animator;
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+    animator = std::make_unique<Animator>(
+        delegate, task_runners,
+        std::make_unique<FixedBudgetVsyncWaiter>(task_runners));
+  });
+
+  const fml::TimeDelta overrun = kFrameBudget * 2;
+
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, overrun), 2u);
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, overrun), 3u);
+  // Pointer input returns the pipeline to its base depth right away, and
+  // keeps it there while rasterization is still overrunning.
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, overrun,
+                      /*pointer_input=*/true),
+            2u);
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, overrun,
+                      /*pointer_input=*/true),
+            2u);
+  // Once the input stops, the overrun deepens it again.
+  EXPECT_EQ(DrawFrame(task_runners, *animator, delegate, overrun), 3u);
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
+}
+
 }  // namespace testing
 }  // namespace flutter
 
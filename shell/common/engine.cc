@@ -61,6 +61,14 @@ Engine::Engine(
       task_runners_(task_runners),
       weak_factory_(this) {
   pointer_data_dispatcher_ = dispatcher_maker(*this);
+  if (settings_.decoded_image_cache_max_bytes > 0) {
+    image_decoder_->SetDecodedImageCache(std::make_shared<DecodedImageCache>(
+        settings_.decoded_image_cache_max_bytes));
+  }
+  image_decoder_->SetMultiFrameCodecOptions({
+      .decode_ahead_frames = settings_.animated_image_decode_ahead_frames,
+      .frame_cache_max_bytes = settings_.animated_image_frame_cache_max_bytes,
+  });
 }
 
 Engine::Engine(Delegate& delegate,
@@ -147,6 +155,8 @@ std::unique_ptr<Engine> Engine::Spawn(
       /*snapshot_delegate=*/std::move(snapshot_delegate));
   result->initial_route_ = initial_route;
   result->asset_manager_ = asset_manager_;
+  result->image_decoder_->SetDecodedImageCache(
+      image_decoder_->GetDecodedImageCache());
   return result;
 }
 
@@ -169,6 +179,11 @@ fml::WeakPtr<ImageDecoder> Engine::GetImageDecoderWeakPtr() {
   return image_decoder_->GetWeakPtr();
 }
 
+const std::shared_ptr<DecodedImageCache>& Engine::GetDecodedImageCache()
+    const {
+  return image_decoder_->GetDecodedImageCache();
+}
+
 fml::WeakPtr<ImageGeneratorRegistry> Engine::GetImageGeneratorRegistry() {
   return image_generator_registry_.GetWeakPtr();
 }
@@ -528,6 +543,7 @@ FontCollection& Engine::GetFontCollection() {
 void Engine::DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
                               uint64_t trace_flow_id) {
   animator_->EnqueueTraceFlowId(trace_flow_id);
+  animator_->OnPointerInput();
   if (runtime_controller_) {
     runtime_controller_->DispatchPointerDataPacket(*packet);
   }
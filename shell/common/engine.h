@@ -856,6 +856,14 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   // Return the weak_ptr of ImageDecoder.
   fml::WeakPtr<ImageDecoder> GetImageDecoderWeakPtr();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get the cache of decoded images that this engine shares with
+  ///             the engines spawned from it.
+  ///
+  /// @return     The cache, or null if it is disabled by the settings.
+  ///
+  const std::shared_ptr<DecodedImageCache>& GetDecodedImageCache() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Get the `ImageGeneratorRegistry` associated with the current
   ///             engine.
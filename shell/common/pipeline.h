@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_COMMON_PIPELINE_H_
 #define FLUTTER_SHELL_COMMON_PIPELINE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -14,6 +16,8 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/synchronization/semaphore.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -57,6 +61,8 @@ size_t GetNextPipelineTraceID();
 ///   calls |Produce| to the time they complete the `ProducerContinuation` with
 ///   a resource.
 /// * Pipeline Depth: counter of inflight resource producers.
+/// * Pipeline Target Depth: counter of the depth currently allowed, for
+///   pipelines whose depth is adjusted with |SetDepth|.
 ///
 /// The primary use of this class is as the frame pipeline used in Flutter's
 /// animator/rasterizer.
@@ -128,20 +134,54 @@ class Pipeline {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(uint32_t depth) : Pipeline(depth, depth) {}
+
+  /// Creates a pipeline whose depth starts at |depth| and may later be raised
+  /// up to |max_depth| with |SetDepth|.
+  Pipeline(uint32_t depth, uint32_t max_depth)
+      : empty_(max_depth),
+        available_(0),
+        inflight_(0),
+        max_depth_(max_depth),
+        depth_(std::clamp<uint32_t>(depth, 1, max_depth)) {}
 
   ~Pipeline() = default;
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  /// The maximum number of resources the producer may currently have in
+  /// flight.
+  uint32_t GetDepth() const { return depth_.load(); }
+
+  /// The depth this pipeline was created with room for.
+  uint32_t GetMaxDepth() const { return max_depth_; }
+
+  /// Changes the number of resources the producer may have in flight, clamped
+  /// to [1, |GetMaxDepth|]. Lowering the depth does not drop resources that
+  /// are already in flight; |Produce| fails until enough have been consumed.
+  void SetDepth(uint32_t depth) {
+    depth = std::clamp<uint32_t>(depth, 1, max_depth_);
+    if (depth_.exchange(depth) != depth) {
+      FML_TRACE_COUNTER("flutter", "Pipeline Target Depth",
+                        reinterpret_cast<int64_t>(this),  //
+                        "depth", depth                    //
+      );
+    }
+  }
+
+  /// How long the consumer took to consume the most recent resource, or zero
+  /// if nothing has been consumed yet.
+  fml::TimeDelta GetLastConsumeDuration() const {
+    return fml::TimeDelta::FromMicroseconds(last_consume_duration_.load());
+  }
+
   /// Creates a `ProducerContinuation` that a producer can use to add a
   /// resource to the queue.
   ///
   /// If the queue is already at its maximum depth, the `ProducerContinuation`
   /// is returned with success = false.
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    if (!TryReserve()) {
       return {};
     }
     ++inflight_;
@@ -162,7 +202,7 @@ class Pipeline {
   /// Prefer using |Produce|. ProducerContinuation returned by this method
   /// doesn't guarantee that the frame will be rendered.
   ProducerContinuation ProduceIfEmpty() {
-    if (!empty_.TryWait()) {
+    if (!TryReserve()) {
       return {};
     }
     ++inflight_;
@@ -200,7 +240,10 @@ class Pipeline {
       items_count = queue_.size();
     }
 
+    const fml::TimePoint consume_start = fml::TimePoint::Now();
     consumer(std::move(resource));
+    last_consume_duration_ =
+        (fml::TimePoint::Now() - consume_start).ToMicroseconds();
 
     empty_.Signal();
     --inflight_;
@@ -216,9 +259,22 @@ class Pipeline {
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
+  const uint32_t max_depth_;
+  std::atomic<uint32_t> depth_;
+  std::atomic<int64_t> last_consume_duration_ = 0;
   std::mutex queue_mutex_;
   std::deque<std::pair<ResourcePtr, size_t>> queue_;
 
+  /// Reserves a spot for a resource if fewer than |depth_| are in flight.
+  bool TryReserve() {
+    // |empty_| has a spot for every resource up to |max_depth_|. It is
+    // |depth_| that limits the pipeline below that.
+    if (inflight_.load() >= static_cast<int>(depth_.load())) {
+      return false;
+    }
+    return empty_.TryWait();
+  }
+
   /// Commits a produced resource to the queue and signals the consumer that a
   /// resource is available.
   PipelineProduceResult ProducerCommit(ResourcePtr resource, size_t trace_id) {
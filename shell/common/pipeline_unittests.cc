@@ -9,6 +9,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -144,5 +145,69 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, DepthCanBeRaisedUpToMaxDepth) {
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(/*depth=*/1, /*max_depth=*/2);
+  ASSERT_EQ(pipeline->GetDepth(), 1u);
+  ASSERT_EQ(pipeline->GetMaxDepth(), 2u);
+
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1);
+  ASSERT_FALSE(pipeline->Produce());
+
+  pipeline->SetDepth(5);
+  ASSERT_EQ(pipeline->GetDepth(), 2u);
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_TRUE(continuation_2);
+  ASSERT_FALSE(pipeline->Produce());
+
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)).success);
+  ASSERT_TRUE(continuation_2.Complete(std::make_unique<int>(2)).success);
+  PipelineConsumeResult consume_result_1 =
+      pipeline->Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::MoreAvailable);
+  PipelineConsumeResult consume_result_2 =
+      pipeline->Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 2); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, LoweringDepthWaitsForInflightResources) {
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(/*depth=*/2, /*max_depth=*/2);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)).success);
+  ASSERT_TRUE(continuation_2.Complete(std::make_unique<int>(2)).success);
+
+  pipeline->SetDepth(0);
+  ASSERT_EQ(pipeline->GetDepth(), 1u);
+
+  ASSERT_EQ(pipeline->Consume([](std::unique_ptr<int> v) {}),
+            PipelineConsumeResult::MoreAvailable);
+  // One resource is still in flight.
+  ASSERT_FALSE(pipeline->Produce());
+
+  ASSERT_EQ(pipeline->Consume([](std::unique_ptr<int> v) {}),
+            PipelineConsumeResult::Done);
+  ASSERT_TRUE(pipeline->Produce());
+}
+
+TEST(PipelineTest, RecordsConsumeDuration) {
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(1);
+  ASSERT_EQ(pipeline->GetLastConsumeDuration(), fml::TimeDelta::Zero());
+
+  Continuation continuation = pipeline->Produce();
+  ASSERT_TRUE(continuation.Complete(std::make_unique<int>(1)).success);
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([](std::unique_ptr<int> v) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+
+  ASSERT_GE(pipeline->GetLastConsumeDuration(),
+            fml::TimeDelta::FromMilliseconds(2));
+}
+
 }  // namespace testing
 }  // namespace flutter
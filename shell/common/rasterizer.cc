@@ -12,7 +12,9 @@
 #include "flow/frame_timings.h"
 #include "flutter/common/constants.h"
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/display_list/utils/dl_binary_writer.h"
 #include "flutter/flow/layers/offscreen_surface.h"
+#include "flutter/fml/file.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/base64.h"
@@ -59,6 +61,18 @@ Rasterizer::Rasterizer(Delegate& delegate,
           SnapshotController::Make(*this, delegate.GetSettings())),
       weak_factory_(this) {
   FML_DCHECK(compositor_context_);
+#if !SLIMPELLER
+  const Settings& settings = delegate.GetSettings();
+  RasterCache& raster_cache = compositor_context_->raster_cache();
+  if (settings.raster_cache_population != RasterCachePopulation::kSynchronous) {
+    raster_cache.SetPopulation(settings.raster_cache_population,
+                               delegate.GetConcurrentWorkerTaskRunner());
+  }
+  if (settings.raster_cache_max_bytes > 0) {
+    raster_cache.SetPolicy(std::make_unique<ByteBudgetRasterCachePolicy>(
+        settings.raster_cache_max_bytes));
+  }
+#endif  //  !SLIMPELLER
 }
 
 Rasterizer::~Rasterizer() = default;
@@ -662,6 +676,7 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
     auto& view_record = EnsureViewRecord(task->view_id);
     view_record.last_draw_status = status;
     if (status == DrawSurfaceStatus::kSuccess) {
+      CaptureDisplayList(view_id, *layer_tree);
       view_record.last_successful_task = std::make_unique<LayerTreeTask>(
           view_id, std::move(layer_tree), device_pixel_ratio);
     } else if (status == DrawSurfaceStatus::kRetry) {
@@ -674,6 +689,8 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
   frame_timings_recorder.RecordRasterEnd(
       NOT_SLIMPELLER(&compositor_context_->raster_cache()));
 
+  WriteDisplayListCaptures();
+
   FireNextFrameCallbackIfPresent();
 
 #if !SLIMPELLER
@@ -692,6 +709,69 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
   }
 }
 
+void Rasterizer::CaptureDisplayList(int64_t view_id,
+                                    flutter::LayerTree& layer_tree) {
+  const Settings& settings = delegate_.GetSettings();
+  if (settings.display_list_capture_path.empty() ||
+      display_list_capture_frame_count_ >=
+          settings.display_list_capture_frame_limit) {
+    return;
+  }
+  if (!display_list_capture_directory_) {
+    fml::UniqueFD directory =
+        fml::OpenDirectory(settings.display_list_capture_path.c_str(), true,
+                           fml::FilePermission::kReadWrite);
+    if (!directory.is_valid()) {
+      FML_LOG(ERROR) << "Could not open the display list capture directory "
+                     << settings.display_list_capture_path;
+      return;
+    }
+    display_list_capture_directory_ =
+        std::make_shared<fml::UniqueFD>(std::move(directory));
+  }
+  TRACE_EVENT0("flutter", "Rasterizer::CaptureDisplayList");
+
+  // Only the flattening needs the layer tree and the texture registry. The
+  // display list is serialized and written by |WriteDisplayListCaptures|.
+  sk_sp<DisplayList> display_list =
+      layer_tree.Flatten(SkRect::Make(layer_tree.frame_size()),
+                         compositor_context_->texture_registry());
+  if (!display_list) {
+    return;
+  }
+  char file_name[64];
+  snprintf(file_name, sizeof(file_name), "frame_%05zu_view_%lld.dlb",
+           display_list_capture_frame_count_,
+           static_cast<long long>(view_id));
+  pending_display_list_captures_.push_back(
+      {file_name, std::move(display_list)});
+}
+
+void Rasterizer::WriteDisplayListCaptures() {
+  if (pending_display_list_captures_.empty()) {
+    return;
+  }
+  display_list_capture_frame_count_++;
+  delegate_.GetTaskRunners().GetIOTaskRunner()->PostTask(
+      [directory = display_list_capture_directory_,
+       captures = std::move(pending_display_list_captures_)]() {
+        TRACE_EVENT0("flutter", "Rasterizer::WriteDisplayListCaptures");
+        for (const DisplayListCapture& capture : captures) {
+          std::unique_ptr<fml::Mapping> data =
+              DlBinaryWriter::Serialize(*capture.display_list);
+          if (!data) {
+            continue;
+          }
+          if (!fml::WriteAtomically(*directory, capture.file_name.c_str(),
+                                    *data)) {
+            FML_LOG(ERROR) << "Could not write the display list capture "
+                           << capture.file_name;
+          }
+        }
+      });
+  pending_display_list_captures_.clear();
+}
+
 /// \see Rasterizer::DrawToSurfaces
 DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
     int64_t view_id,
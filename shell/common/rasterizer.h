@@ -7,7 +7,9 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
@@ -18,12 +20,14 @@
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "flutter/fml/synchronization/sync_switch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_fd.h"
 #if IMPELLER_SUPPORTS_RENDERING
 #include "impeller/aiks/aiks_context.h"  // nogncheck
 #include "impeller/core/formats.h"       // nogncheck
@@ -169,6 +173,13 @@ class Rasterizer final : public SnapshotDelegate,
 
     virtual const Settings& GetSettings() const = 0;
 
+    /// The task runner for the concurrent worker threads, used to populate
+    /// the raster cache off the raster thread if the settings request it.
+    virtual const std::shared_ptr<fml::ConcurrentTaskRunner>
+    GetConcurrentWorkerTaskRunner() const {
+      return nullptr;
+    }
+
     virtual bool ShouldDiscardLayerTree(int64_t view_id,
                                         const flutter::LayerTree& tree) = 0;
   };
@@ -740,6 +751,20 @@ class Rasterizer final : public SnapshotDelegate,
 
   ViewRecord& EnsureViewRecord(int64_t view_id);
 
+  // A flattened layer tree waiting to be written to the capture directory.
+  struct DisplayListCapture {
+    std::string file_name;
+    sk_sp<DisplayList> display_list;
+  };
+
+  // Flattens the layer tree of a drawn view for the directory in
+  // |Settings::display_list_capture_path|, if set.
+  void CaptureDisplayList(int64_t view_id, flutter::LayerTree& layer_tree);
+
+  // Serializes and writes the display lists captured in this frame on the IO
+  // task runner, so that the frame is not delayed by the disk.
+  void WriteDisplayListCaptures();
+
   void FireNextFrameCallbackIfPresent();
 
   static bool ShouldResubmitFrame(const DoDrawResult& result);
@@ -759,6 +784,9 @@ class Rasterizer final : public SnapshotDelegate,
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   std::shared_ptr<ExternalViewEmbedder> external_view_embedder_;
   std::unique_ptr<SnapshotController> snapshot_controller_;
+  std::shared_ptr<fml::UniqueFD> display_list_capture_directory_;
+  std::vector<DisplayListCapture> pending_display_list_captures_;
+  size_t display_list_capture_frame_count_ = 0;
 
   // WeakPtrFactory must be the last member.
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
@@ -534,6 +534,11 @@ Shell::Shell(DartVMRef vm,
       task_runners_.GetPlatformTaskRunner(),
       std::bind(&Shell::OnServiceProtocolReloadAssetFonts, this,
                 std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetDecodedImageCacheStatsExtensionName] = {
+          task_runners_.GetUITaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetDecodedImageCacheStats, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -662,6 +667,15 @@ void Shell::NotifyLowMemoryWarning() const {
         TRACE_EVENT_ASYNC_END0("flutter", "Shell::NotifyLowMemoryWarning",
                                trace_id);
       });
+  // The decoded image cache is shared with the other engines in the group, and
+  // would otherwise keep its images alive until they are evicted.
+  task_runners_.GetUITaskRunner()->PostTask([engine = weak_engine_]() {
+    if (engine) {
+      if (const auto& cache = engine->GetDecodedImageCache()) {
+        cache->Purge();
+      }
+    }
+  });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
   // to purge them.
 }
@@ -1936,11 +1950,25 @@ bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
 
   uint64_t layer_cache_byte_size = 0u;
   uint64_t picture_cache_byte_size = 0u;
+  uint64_t byte_budget = 0u;
+  // The hit, miss and eviction counts of the last frame.
+  uint64_t hit_count = 0u;
+  uint64_t miss_count = 0u;
+  uint64_t evicted_byte_size = 0u;
 
 #if !SLIMPELLER
   const auto& raster_cache = rasterizer_->compositor_context()->raster_cache();
   layer_cache_byte_size = raster_cache.EstimateLayerCacheByteSize();
   picture_cache_byte_size = raster_cache.EstimatePictureCacheByteSize();
+  if (const RasterCachePolicy* policy = raster_cache.policy()) {
+    byte_budget = policy->byte_budget();
+  }
+  for (const RasterCacheMetrics* metrics :
+       {&raster_cache.layer_metrics(), &raster_cache.picture_metrics()}) {
+    hit_count += metrics->hit_count;
+    miss_count += metrics->miss_count;
+    evicted_byte_size += metrics->eviction_bytes;
+  }
 #endif  //  !SLIMPELLER
 
   response->SetObject();
@@ -1950,6 +1978,39 @@ bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
                                 response->GetAllocator());
   response->AddMember<uint64_t>("pictureBytes", picture_cache_byte_size,
                                 response->GetAllocator());
+  response->AddMember<uint64_t>("budgetBytes", byte_budget,
+                                response->GetAllocator());
+  response->AddMember<uint64_t>("hits", hit_count, response->GetAllocator());
+  response->AddMember<uint64_t>("misses", miss_count,
+                                response->GetAllocator());
+  response->AddMember<uint64_t>("evictedBytes", evicted_byte_size,
+                                response->GetAllocator());
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetDecodedImageCacheStats(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  if (!engine_) {
+    return false;
+  }
+
+  DecodedImageCache::Stats stats;
+  if (const auto& cache = engine_->GetDecodedImageCache()) {
+    stats = cache->GetStats();
+  }
+
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "DecodedImageCacheStats", allocator);
+  response->AddMember<uint64_t>("hits", stats.hit_count, allocator);
+  response->AddMember<uint64_t>("misses", stats.miss_count, allocator);
+  response->AddMember<uint64_t>("evictions", stats.eviction_count, allocator);
+  response->AddMember<uint64_t>("entries", stats.entry_count, allocator);
+  response->AddMember<uint64_t>("bytes", stats.byte_size, allocator);
+  response->AddMember<uint64_t>("budgetBytes", stats.byte_budget, allocator);
   return true;
 }
 
@@ -409,8 +409,9 @@ class Shell final : public PlatformView::Delegate,
 
   const std::weak_ptr<VsyncWaiter> GetVsyncWaiter() const;
 
+  // |Rasterizer::Delegate|
   const std::shared_ptr<fml::ConcurrentTaskRunner>
-  GetConcurrentWorkerTaskRunner() const;
+  GetConcurrentWorkerTaskRunner() const override;
 
   // Infer the VM ref and the isolate snapshot based on the settings.
   //
@@ -772,6 +773,14 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // Responds with the size and the hit, miss and eviction counts of the
+  // decoded image cache shared by this engine group.
+  bool OnServiceProtocolGetDecodedImageCacheStats(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Send a system font change notification.
   void SendFontChangeNotification();
 
@@ -5,17 +5,29 @@
 #include "flutter/shell/common/shell.h"
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/paths.h"
+#include "flutter/runtime/dart_snapshot.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
 
+#if FML_OS_LINUX || FML_OS_ANDROID
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // FML_OS_LINUX || FML_OS_ANDROID
+
 namespace flutter {
 
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
-                                    bool measure_shutdown) {
+                                    bool measure_shutdown,
+                                    const std::string& patch_path = "",
+                                    bool preload_patch = false) {
   auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
                                        fml::FilePermission::kRead);
   std::unique_ptr<Shell> shell;
@@ -28,7 +40,16 @@ static void StartupAndShutdownShell(benchmark::State& state,
     settings.task_observer_add = [](intptr_t, const fml::closure&) {};
     settings.task_observer_remove = [](intptr_t) {};
 
-    if (DartVM::IsRunningPrecompiledCode()) {
+    if (!patch_path.empty()) {
+      // Mirrors what ConfigureShorebird does with the active patch: the
+      // snapshots are resolved by loading the patch library rather than
+      // from symbols the embedder provides. Shutting the VM down with the
+      // shell makes every iteration resolve them again.
+      FML_CHECK(DartVM::IsRunningPrecompiledCode());
+      settings.leak_vm = false;
+      settings.application_library_path.insert(
+          settings.application_library_path.begin(), patch_path);
+    } else if (DartVM::IsRunningPrecompiledCode()) {
       aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
           testing::kDefaultAOTAppELFFileName);
       FML_CHECK(
@@ -48,6 +69,11 @@ static void StartupAndShutdownShell(benchmark::State& state,
         ThreadHost::Type::kPlatform | ThreadHost::Type::kRaster |
             ThreadHost::Type::kIo | ThreadHost::Type::kUi));
 
+    if (preload_patch) {
+      DartSnapshot::PreloadNativeLibrary(
+          patch_path, thread_host->io_thread->GetTaskRunner());
+    }
+
     TaskRunners task_runners("test",
                              thread_host->platform_thread->GetTaskRunner(),
                              thread_host->raster_thread->GetTaskRunner(),
@@ -120,4 +146,50 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+static void StartupAndShutdownShellWithPatch(benchmark::State& state,
+                                             bool preload_patch) {
+  if (!DartVM::IsRunningPrecompiledCode()) {
+    state.SkipWithError("Patches are only loaded in AOT mode.");
+    return;
+  }
+  // Use the AOT ELF fixture as the patch so that snapshot resolution really
+  // dlopens it, as it would a downloaded patch.
+  auto fixture = fml::FileMapping::CreateReadOnly(fml::paths::JoinPaths(
+      {testing::GetFixturesPath(), testing::kDefaultAOTAppELFFileName}));
+  FML_CHECK(fixture && fixture->GetMapping() != nullptr);
+  fml::ScopedTemporaryDirectory temp_dir;
+  const std::string patch_name = "libapp_patch.so";
+  FML_CHECK(
+      fml::WriteAtomically(temp_dir.fd(), patch_name.c_str(), *fixture));
+  const std::string patch_path =
+      fml::paths::JoinPaths({temp_dir.path(), patch_name});
+  while (state.KeepRunning()) {
+#if FML_OS_LINUX || FML_OS_ANDROID
+    {
+      // A patch is read from disk the first time it is booted. Drop it from
+      // the page cache so that no iteration finds it already resident.
+      benchmarking::ScopedPauseTiming pause(state, true);
+      fml::UniqueFD patch_fd = fml::OpenFile(patch_path.c_str(), false,
+                                             fml::FilePermission::kRead);
+      FML_CHECK(patch_fd.is_valid());
+      ::fdatasync(patch_fd.get());
+      ::posix_fadvise(patch_fd.get(), 0, 0, POSIX_FADV_DONTNEED);
+    }
+#endif  // FML_OS_LINUX || FML_OS_ANDROID
+    StartupAndShutdownShell(state, true, false, patch_path, preload_patch);
+  }
+}
+
+static void BM_ShellInitializationWithPatch(benchmark::State& state) {
+  StartupAndShutdownShellWithPatch(state, false);
+}
+
+BENCHMARK(BM_ShellInitializationWithPatch);
+
+static void BM_ShellInitializationWithPreloadedPatch(benchmark::State& state) {
+  StartupAndShutdownShellWithPatch(state, true);
+}
+
+BENCHMARK(BM_ShellInitializationWithPreloadedPatch);
+
 }  // namespace flutter
@@ -322,6 +322,9 @@ void ShellTest::OnServiceProtocol(
       case ServiceProtocolEnum::kRenderFrameWithRasterStats:
         shell->OnServiceProtocolRenderFrameWithRasterStats(params, response);
         break;
+      case ServiceProtocolEnum::kGetDecodedImageCacheStats:
+        shell->OnServiceProtocolGetDecodedImageCacheStats(params, response);
+        break;
     }
     finished.set_value(true);
   });
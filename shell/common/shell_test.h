@@ -137,6 +137,7 @@ class ShellTest : public FixtureTest {
     kSetAssetBundlePath,
     kRunInView,
     kRenderFrameWithRasterStats,
+    kGetDecodedImageCacheStats,
   };
 
   // Helper method to test private method Shell::OnServiceProtocolGetSkSLs.
@@ -2559,7 +2559,37 @@ TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   document.Accept(writer);
   std::string expected_json =
       "{\"type\":\"EstimateRasterCacheMemory\",\"layerBytes\":40024,\"picture"
-      "Bytes\":424}";
+      "Bytes\":424,\"budgetBytes\":0,\"hits\":2,\"misses\":0,\"evicted"
+      "Bytes\":0}";
+  std::string actual_json = buffer.GetString();
+  ASSERT_EQ(actual_json, expected_json);
+
+  DestroyShell(std::move(shell));
+}
+
+TEST_F(ShellTest, OnServiceProtocolGetDecodedImageCacheStatsWorks) {
+  Settings settings = CreateSettingsForFixture();
+  settings.decoded_image_cache_max_bytes = 1024;
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  PostSync(shell->GetTaskRunners().GetUITaskRunner(),
+           [engine = shell->GetEngine()]() {
+             const auto& cache = engine->GetDecodedImageCache();
+             ASSERT_NE(cache, nullptr);
+             ASSERT_EQ(cache->Get(DecodedImageCache::Key{}), nullptr);
+           });
+
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetDecodedImageCacheStats,
+      shell->GetTaskRunners().GetUITaskRunner(), empty_params, &document);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  std::string expected_json =
+      "{\"type\":\"DecodedImageCacheStats\",\"hits\":0,\"misses\":1,"
+      "\"evictions\":0,\"entries\":0,\"bytes\":0,\"budgetBytes\":1024}";
   std::string actual_json = buffer.GetString();
   ASSERT_EQ(actual_json, expected_json);
 
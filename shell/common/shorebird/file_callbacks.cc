@@ -0,0 +1,57 @@
+#include "flutter/shell/common/shorebird/file_callbacks.h"
+
+#include <utility>
+
+#include "flutter/shell/common/shorebird/snapshots_data_handle.h"
+
+namespace flutter {
+
+static fml::RefPtr<const DartSnapshot> vm_snapshot;
+static fml::RefPtr<const DartSnapshot> isolate_snapshot;
+
+class FileCallbacksImpl {
+ public:
+  static void* Open();
+  static uintptr_t Read(void* file, uint8_t* buffer, uintptr_t length);
+  static int64_t Seek(void* file, int64_t offset, int32_t whence);
+  static void Close(void* file);
+};
+
+void SetFileCallbacksSnapshots(
+    fml::RefPtr<const DartSnapshot> vm_snapshot_arg,
+    fml::RefPtr<const DartSnapshot> isolate_snapshot_arg) {
+  vm_snapshot = std::move(vm_snapshot_arg);
+  isolate_snapshot = std::move(isolate_snapshot_arg);
+}
+
+FileCallbacks ShorebirdFileCallbacks() {
+  return {
+      .open = FileCallbacksImpl::Open,
+      .read = FileCallbacksImpl::Read,
+      .seek = FileCallbacksImpl::Seek,
+      .close = FileCallbacksImpl::Close,
+  };
+}
+
+void* FileCallbacksImpl::Open() {
+  return SnapshotsDataHandle::createForSnapshots(*vm_snapshot,
+                                                 *isolate_snapshot)
+      .release();
+}
+
+uintptr_t FileCallbacksImpl::Read(void* file,
+                                  uint8_t* buffer,
+                                  uintptr_t length) {
+  return reinterpret_cast<SnapshotsDataHandle*>(file)->Read(buffer, length);
+}
+
+int64_t FileCallbacksImpl::Seek(void* file, int64_t offset, int32_t whence) {
+  // Currently we only support blob handles.
+  return reinterpret_cast<SnapshotsDataHandle*>(file)->Seek(offset, whence);
+}
+
+void FileCallbacksImpl::Close(void* file) {
+  delete reinterpret_cast<SnapshotsDataHandle*>(file);
+}
+
+}  // namespace flutter
@@ -0,0 +1,22 @@
+#ifndef FLUTTER_SHELL_COMMON_SHOREBIRD_FILE_CALLBACKS_H_
+#define FLUTTER_SHELL_COMMON_SHOREBIRD_FILE_CALLBACKS_H_
+
+#include "flutter/runtime/dart_snapshot.h"
+
+#include "third_party/updater/library/include/updater.h"
+
+namespace flutter {
+
+// Sets the snapshots that the |open| callback returned by
+// ShorebirdFileCallbacks() hands out handles to.
+void SetFileCallbacksSnapshots(
+    fml::RefPtr<const DartSnapshot> vm_snapshot,
+    fml::RefPtr<const DartSnapshot> isolate_snapshot);
+
+// The callbacks through which the updater reads the base snapshots as a
+// single file. Files are SnapshotsDataHandle instances.
+FileCallbacks ShorebirdFileCallbacks();
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SHOREBIRD_FILE_CALLBACKS_H_
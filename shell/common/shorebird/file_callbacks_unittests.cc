@@ -0,0 +1,53 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/shell/common/shorebird/file_callbacks.h"
+
+#include "flutter/fml/mapping.h"
+#include "flutter/shell/common/shorebird/snapshots_data_handle.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+// Returns a handle to |blobs| as the |open| callback would, so that it can be
+// read and closed through the callbacks table.
+static void* OpenBlobs(const std::vector<std::string>& blobs) {
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  for (const auto& blob : blobs) {
+    mappings.push_back(std::make_unique<fml::NonOwnedMapping>(
+        reinterpret_cast<const uint8_t*>(blob.data()), blob.size()));
+  }
+  return std::make_unique<SnapshotsDataHandle>(std::move(mappings)).release();
+}
+
+TEST(FileCallbacks, RegistersEveryCallback) {
+  FileCallbacks callbacks = ShorebirdFileCallbacks();
+  EXPECT_NE(callbacks.open, nullptr);
+  EXPECT_NE(callbacks.read, nullptr);
+  EXPECT_NE(callbacks.seek, nullptr);
+  EXPECT_NE(callbacks.close, nullptr);
+}
+
+TEST(FileCallbacks, ReadsAcrossBlobs) {
+  std::vector<std::string> blobs = {"abc", "def", "ghi", "jkl"};
+  FileCallbacks callbacks = ShorebirdFileCallbacks();
+  void* file = OpenBlobs(blobs);
+
+  EXPECT_EQ(callbacks.seek(file, 2, SEEK_SET), 2);
+
+  uint8_t buffer[5];
+  ASSERT_EQ(callbacks.read(file, buffer, 5), 5u);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(buffer), 5), "cdefg");
+
+  EXPECT_EQ(callbacks.seek(file, -1, SEEK_END), 11);
+  ASSERT_EQ(callbacks.read(file, buffer, 5), 1u);
+  EXPECT_EQ(buffer[0], 'l');
+  EXPECT_EQ(callbacks.read(file, buffer, 5), 0u);
+
+  callbacks.close(file);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -15,11 +15,12 @@
 #include "flutter/fml/native_library.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/size.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/plugins/callback_cache.h"
 #include "flutter/runtime/dart_snapshot.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/shell.h"
-#include "flutter/shell/common/shorebird/snapshots_data_handle.h"
+#include "flutter/shell/common/shorebird/file_callbacks.h"
 #include "flutter/shell/common/switches.h"
 #include "fml/logging.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
@@ -61,23 +62,7 @@ void SetBaseSnapshot(Settings& settings) {
                              isolate_snapshot->GetInstructionsMapping(),
                              vm_snapshot->GetDataMapping(),
                              vm_snapshot->GetInstructionsMapping());
-}
-
-class FileCallbacksImpl {
- public:
-  static void* Open();
-  static uintptr_t Read(void* file, uint8_t* buffer, uintptr_t length);
-  static int64_t Seek(void* file, int64_t offset, int32_t whence);
-  static void Close(void* file);
-};
-
-FileCallbacks ShorebirdFileCallbacks() {
-  return {
-      .open = FileCallbacksImpl::Open,
-      .read = FileCallbacksImpl::Read,
-      .seek = FileCallbacksImpl::Seek,
-      .close = FileCallbacksImpl::Close,
-  };
+  SetFileCallbacksSnapshots(vm_snapshot, isolate_snapshot);
 }
 
 void ConfigureShorebird(std::string code_cache_path,
@@ -86,6 +71,7 @@ void ConfigureShorebird(std::string code_cache_path,
                         const std::string& shorebird_yaml,
                         const std::string& version,
                         const std::string& version_code) {
+  TRACE_EVENT0("shorebird", "ConfigureShorebird");
   // If you are crashing here, you probably are running Shorebird in a Debug
   // config, where the AOT snapshot won't be linked into the process, and thus
   // lookups will fail.  Change your Scheme to Release to fix:
@@ -126,6 +112,7 @@ void ConfigureShorebird(std::string code_cache_path,
     app_parameters.original_libapp_paths_size = c_paths.size();
 
     // shorebird_init copies from app_parameters and shorebirdYaml.
+    TRACE_EVENT0("shorebird", "shorebird_init");
     init_result = shorebird_init(&app_parameters, ShorebirdFileCallbacks(),
                                  shorebird_yaml.c_str());
   }
@@ -141,12 +128,22 @@ void ConfigureShorebird(std::string code_cache_path,
   SetBaseSnapshot(settings);
 #endif
 
-  char* c_active_path = shorebird_next_boot_patch_path();
+  char* c_active_path;
+  {
+    TRACE_EVENT0("shorebird", "shorebird_next_boot_patch_path");
+    c_active_path = shorebird_next_boot_patch_path();
+  }
   if (c_active_path != NULL) {
     std::string active_path = c_active_path;
     shorebird_free_string(c_active_path);
     FML_LOG(INFO) << "Shorebird updater: active path: " << active_path;
 
+    // Start paging the patch in while the embedder goes on to create the
+    // engine and platform view. Snapshot resolution during isolate creation
+    // joins on this before loading the patch. No engine threads exist yet,
+    // so the patch is mapped here and only the readahead is asynchronous.
+    DartSnapshot::PreloadNativeLibrary(active_path, nullptr);
+
 #if FML_OS_IOS
     // On iOS we add the patch to the front of the list instead of clearing
     // the list, to allow dart_shapshot.cc to still find the base snapshot
@@ -189,25 +186,4 @@ void ConfigureShorebird(std::string code_cache_path,
   }
 }
 
-void* FileCallbacksImpl::Open() {
-  return SnapshotsDataHandle::createForSnapshots(*vm_snapshot,
-                                                 *isolate_snapshot)
-      .release();
-}
-
-uintptr_t FileCallbacksImpl::Read(void* file,
-                                  uint8_t* buffer,
-                                  uintptr_t length) {
-  return reinterpret_cast<SnapshotsDataHandle*>(file)->Read(buffer, length);
-}
-
-int64_t FileCallbacksImpl::Seek(void* file, int64_t offset, int32_t whence) {
-  // Currently we only support blob handles.
-  return reinterpret_cast<SnapshotsDataHandle*>(file)->Seek(offset, whence);
-}
-
-void FileCallbacksImpl::Close(void* file) {
-  delete reinterpret_cast<SnapshotsDataHandle*>(file);
-}
-
 }  // namespace flutter
\ No newline at end of file
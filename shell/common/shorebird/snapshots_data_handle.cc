@@ -1,5 +1,7 @@
 #include "flutter/shell/common/shorebird/snapshots_data_handle.h"
 
+#include <algorithm>
+
 #include "third_party/dart/runtime/include/dart_native_api.h"
 
 namespace flutter {
@@ -17,22 +19,28 @@ static std::unique_ptr<fml::Mapping> InstructionsMapping(
                                                 Dart_SnapshotInstrSize(ptr));
 }
 
-// The size of the snapshot data is the sum of the sizes of the blobs.
-size_t SnapshotsDataHandle::FullSize() const {
-  size_t size = 0;
+SnapshotsDataHandle::SnapshotsDataHandle(
+    std::vector<std::unique_ptr<fml::Mapping>> blobs)
+    : blobs_(std::move(blobs)) {
+  blob_offsets_.reserve(blobs_.size() + 1);
+  size_t offset = 0;
+  blob_offsets_.push_back(offset);
   for (const auto& blob : blobs_) {
-    size += blob->GetSize();
+    offset += blob->GetSize();
+    blob_offsets_.push_back(offset);
   }
-  return size;
 }
 
 // The offset into the snapshots data blobs as though they were a single
 // contiguous buffer.
-size_t SnapshotsDataHandle::AbsoluteOffsetForIndex(BlobsIndex index) {
+size_t SnapshotsDataHandle::AbsoluteOffsetForIndex(BlobsIndex index) const {
   if (index.blob >= blobs_.size()) {
-    FML_LOG(WARNING) << "Blob index " << index.blob
-                     << " is larger than the number of blobs (" << blobs_.size()
-                     << "). Returning full size (" << FullSize() << ")";
+    if (index.blob > blobs_.size()) {
+      FML_LOG(WARNING) << "Blob index " << index.blob
+                       << " is larger than the number of blobs ("
+                       << blobs_.size() << "). Returning full size ("
+                       << FullSize() << ")";
+    }
     return FullSize();
   }
   if (index.offset > blobs_[index.blob]->GetSize()) {
@@ -40,18 +48,14 @@ size_t SnapshotsDataHandle::AbsoluteOffsetForIndex(BlobsIndex index) {
                      << ") is larger than the blob size ("
                      << blobs_[index.blob]->GetSize()
                      << "). Returning index start of next blob";
-    return AbsoluteOffsetForIndex({index.blob + 1, 0});
+    return blob_offsets_[index.blob + 1];
   }
-  size_t offset = 0;
-  for (size_t i = 0; i < index.blob; i++) {
-    offset += blobs_[i]->GetSize();
-  }
-  offset += index.offset;
-  return offset;
+  return blob_offsets_[index.blob] + index.offset;
 }
 
-BlobsIndex SnapshotsDataHandle::IndexForAbsoluteOffset(int64_t offset,
-                                                       BlobsIndex start_index) {
+BlobsIndex SnapshotsDataHandle::IndexForAbsoluteOffset(
+    int64_t offset,
+    BlobsIndex start_index) const {
   size_t start_offset = AbsoluteOffsetForIndex(start_index);
   if (offset < 0) {
     if ((size_t)abs(offset) > start_offset) {
@@ -60,25 +64,23 @@ BlobsIndex SnapshotsDataHandle::IndexForAbsoluteOffset(int64_t offset,
       return {0, 0};
     }
   } else if (offset + start_offset >= FullSize()) {
-    FML_LOG(WARNING) << "Target offset is past the end of SnapshotsData ("
-                     << offset + start_offset << ", blobs size:" << FullSize()
-                     << "). Returning last blob index and offset";
-    return {blobs_.size(), blobs_.back()->GetSize()};
+    if (offset + start_offset > FullSize()) {
+      FML_LOG(WARNING) << "Target offset is past the end of SnapshotsData ("
+                       << offset + start_offset
+                       << ", blobs size:" << FullSize()
+                       << "). Returning last blob index and offset";
+    }
+    return {blobs_.size(), blobs_.empty() ? 0 : blobs_.back()->GetSize()};
   }
 
   size_t dest_offset = start_offset + offset;
-  BlobsIndex index = {0, 0};
-  for (const auto& blob : blobs_) {
-    if (dest_offset < blob->GetSize()) {
-      // The remaining offset is within this blob.
-      index.offset = dest_offset;
-      break;
-    }
-
-    index.blob++;
-    dest_offset -= blob->GetSize();
-  }
-  return index;
+  // Find the last blob starting at or before dest_offset. Empty blobs share
+  // their start offset with the following blob, so upper_bound skips past
+  // them to the blob that actually contains dest_offset.
+  auto it = std::upper_bound(blob_offsets_.begin(), blob_offsets_.end(),
+                             dest_offset);
+  size_t blob = std::distance(blob_offsets_.begin(), it) - 1;
+  return {blob, dest_offset - blob_offsets_[blob]};
 }
 
 std::unique_ptr<SnapshotsDataHandle> SnapshotsDataHandle::createForSnapshots(
@@ -122,6 +124,33 @@ uintptr_t SnapshotsDataHandle::Read(uint8_t* buffer, uintptr_t length) {
   return bytes_read;
 }
 
+size_t SnapshotsDataHandle::ReadSpans(SnapshotsDataSpan* spans,
+                                      size_t max_spans,
+                                      uintptr_t length) {
+  size_t span_count = 0;
+  uintptr_t bytes_read = 0;
+  while (bytes_read < length && span_count < max_spans) {
+    if (current_index_.blob >= blobs_.size()) {
+      // We have read all blobs.
+      break;
+    }
+    const auto& blob = blobs_[current_index_.blob];
+    if (current_index_.offset >= blob->GetSize()) {
+      // We have read all bytes in this blob.
+      current_index_.blob++;
+      current_index_.offset = 0;
+      continue;
+    }
+    size_t bytes_to_read = std::min<size_t>(
+        length - bytes_read, blob->GetSize() - current_index_.offset);
+    spans[span_count++] = {blob->GetMapping() + current_index_.offset,
+                           bytes_to_read};
+    bytes_read += bytes_to_read;
+    current_index_.offset += bytes_to_read;
+  }
+  return span_count;
+}
+
 int64_t SnapshotsDataHandle::Seek(int64_t offset, int32_t whence) {
   BlobsIndex start_index;
   switch (whence) {
@@ -132,13 +161,13 @@ int64_t SnapshotsDataHandle::Seek(int64_t offset, int32_t whence) {
       start_index = {0, 0};
       break;
     case SEEK_END:
-      start_index = {blobs_.size(), blobs_.back()->GetSize()};
+      start_index = {blobs_.size(), 0};
       break;
     default:
       FML_CHECK(false) << "Unrecognized whence value in Seek: " << whence;
   }
   current_index_ = IndexForAbsoluteOffset(offset, start_index);
-  return current_index_.offset;
+  return AbsoluteOffsetForIndex(current_index_);
 }
 
 }  // namespace flutter
\ No newline at end of file
@@ -14,6 +14,13 @@ struct BlobsIndex {
   size_t offset;
 };
 
+// A contiguous run of bytes inside one of the blobs. The memory is owned by
+// the blob's mapping and remains valid for the lifetime of the handle.
+struct SnapshotsDataSpan {
+  const uint8_t* data;
+  size_t length;
+};
+
 // Implements a POSIX file I/O interface which allows us to provide the four
 // data blobs of a Dart snapshot (vm_data, vm_instructions, isolate_data,
 // isolate_instructions) to Rust as though it were a single piece of memory.
@@ -21,25 +28,40 @@ class SnapshotsDataHandle {
  public:
   // This would ideally be private, but we need to be able to call it from the
   // static createForSnapshots method.
-  explicit SnapshotsDataHandle(std::vector<std::unique_ptr<fml::Mapping>> blobs)
-      : blobs_(std::move(blobs)) {}
+  explicit SnapshotsDataHandle(
+      std::vector<std::unique_ptr<fml::Mapping>> blobs);
 
   static std::unique_ptr<SnapshotsDataHandle> createForSnapshots(
       const DartSnapshot& vm_snapshot,
       const DartSnapshot& isolate_snapshot);
 
   uintptr_t Read(uint8_t* buffer, uintptr_t length);
+
+  // Like Read, but rather than copying into a caller provided buffer, fills
+  // |spans| with up to |max_spans| pointers directly into the underlying
+  // mappings covering at most |length| bytes, and advances the current
+  // position past them. Returns the number of spans written.
+  size_t ReadSpans(SnapshotsDataSpan* spans,
+                   size_t max_spans,
+                   uintptr_t length);
+
+  // Returns the new absolute position, as lseek(2) does.
   int64_t Seek(int64_t offset, int32_t whence);
 
   // The sum of all the blobs' sizes.
-  size_t FullSize() const;
+  size_t FullSize() const { return blob_offsets_.back(); }
 
  private:
-  size_t AbsoluteOffsetForIndex(BlobsIndex index);
-  BlobsIndex IndexForAbsoluteOffset(int64_t offset, BlobsIndex startIndex);
+  size_t AbsoluteOffsetForIndex(BlobsIndex index) const;
+  BlobsIndex IndexForAbsoluteOffset(int64_t offset,
+                                    BlobsIndex start_index) const;
 
   BlobsIndex current_index_ = {0, 0};
   std::vector<std::unique_ptr<fml::Mapping>> blobs_;
+  // blob_offsets_[i] is the absolute offset of the start of blob i, and
+  // blob_offsets_[blobs_.size()] is the full size. Computed once on creation
+  // so seeking is a binary search rather than a walk over every blob.
+  std::vector<size_t> blob_offsets_;
 };
 
 }  // namespace flutter
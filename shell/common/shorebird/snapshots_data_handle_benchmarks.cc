@@ -0,0 +1,93 @@
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/shell/common/shorebird/snapshots_data_handle.h"
+
+namespace flutter {
+
+namespace {
+
+// Roughly the size of a release snapshot for a mid-sized app, split the same
+// way as createForSnapshots (vm_data, isolate_data, vm_instr, isolate_instr).
+constexpr size_t kBlobSizes[] = {
+    64 * 1024,
+    12 * 1024 * 1024,
+    32 * 1024,
+    18 * 1024 * 1024,
+};
+
+// Matches the chunk size the updater uses when hashing/diffing.
+constexpr size_t kChunkSize = 64 * 1024;
+
+std::vector<std::vector<uint8_t>> MakeBlobs() {
+  std::vector<std::vector<uint8_t>> blobs;
+  for (size_t size : kBlobSizes) {
+    blobs.emplace_back(size, 0xAB);
+  }
+  return blobs;
+}
+
+std::unique_ptr<SnapshotsDataHandle> MakeHandle(
+    const std::vector<std::vector<uint8_t>>& blobs) {
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  for (const auto& blob : blobs) {
+    mappings.push_back(
+        std::make_unique<fml::NonOwnedMapping>(blob.data(), blob.size()));
+  }
+  return std::make_unique<SnapshotsDataHandle>(std::move(mappings));
+}
+
+}  // namespace
+
+static void BM_SnapshotsDataHandleRead(benchmark::State& state) {
+  auto blobs = MakeBlobs();
+  auto handle = MakeHandle(blobs);
+  std::vector<uint8_t> buffer(kChunkSize);
+  for (auto _ : state) {
+    handle->Seek(0, SEEK_SET);
+    uint64_t sum = 0;
+    while (uintptr_t read = handle->Read(buffer.data(), buffer.size())) {
+      sum += buffer[read - 1];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * handle->FullSize());
+}
+
+static void BM_SnapshotsDataHandleReadSpans(benchmark::State& state) {
+  auto blobs = MakeBlobs();
+  auto handle = MakeHandle(blobs);
+  SnapshotsDataSpan spans[4];
+  for (auto _ : state) {
+    handle->Seek(0, SEEK_SET);
+    uint64_t sum = 0;
+    while (size_t count = handle->ReadSpans(spans, 4, kChunkSize)) {
+      for (size_t i = 0; i < count; i++) {
+        sum += spans[i].data[spans[i].length - 1];
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * handle->FullSize());
+}
+
+// Random access pattern, as when the updater applies a bsdiff patch against
+// the base snapshot.
+static void BM_SnapshotsDataHandleSeek(benchmark::State& state) {
+  auto blobs = MakeBlobs();
+  auto handle = MakeHandle(blobs);
+  const int64_t full_size = handle->FullSize();
+  int64_t offset = 0;
+  for (auto _ : state) {
+    offset = (offset * 1103515245 + 12345) % full_size;
+    benchmark::DoNotOptimize(handle->Seek(offset, SEEK_SET));
+  }
+}
+
+BENCHMARK(BM_SnapshotsDataHandleRead)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotsDataHandleReadSpans)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotsDataHandleSeek);
+
+}  // namespace flutter
@@ -173,5 +173,65 @@ TEST(SnapshotsDataHandle, SeekFromEnd) {
   EXPECT_EQ(buffer[1], 'l');
 }
 
+TEST(SnapshotsDataHandle, SeekReturnsAbsolutePosition) {
+  std::vector<std::string> blobs = {"abc", "def", "ghi", "jkl"};
+  std::unique_ptr<SnapshotsDataHandle> blobs_handle = MakeHandle(blobs);
+
+  EXPECT_EQ(blobs_handle->Seek(4, SEEK_SET), 4);
+  EXPECT_EQ(blobs_handle->Seek(3, SEEK_CUR), 7);
+  EXPECT_EQ(blobs_handle->Seek(-1, SEEK_END), 11);
+  EXPECT_EQ(blobs_handle->Seek(100, SEEK_CUR), 12);
+  EXPECT_EQ(blobs_handle->Seek(-100, SEEK_CUR), 0);
+}
+
+TEST(SnapshotsDataHandle, SeekSkipsEmptyBlobs) {
+  std::vector<std::string> blobs = {"abc", "", "def", ""};
+  std::unique_ptr<SnapshotsDataHandle> blobs_handle = MakeHandle(blobs);
+
+  EXPECT_EQ(blobs_handle->FullSize(), 6u);
+
+  uint8_t buffer[2] = {0, 0};
+  blobs_handle->Seek(3, SEEK_SET);
+  blobs_handle->Read(buffer, 2);
+
+  EXPECT_EQ(buffer[0], 'd');
+  EXPECT_EQ(buffer[1], 'e');
+}
+
+TEST(SnapshotsDataHandle, ReadSpans) {
+  std::vector<std::string> blobs = {"abc", "def", "ghi", "jkl"};
+  std::unique_ptr<SnapshotsDataHandle> blobs_handle = MakeHandle(blobs);
+
+  blobs_handle->Seek(2, SEEK_SET);
+
+  SnapshotsDataSpan spans[4];
+  ASSERT_EQ(blobs_handle->ReadSpans(spans, 4, 5), 3u);
+
+  // Spans point directly into the blobs rather than into a copy.
+  EXPECT_EQ(spans[0].data,
+            reinterpret_cast<const uint8_t*>(blobs[0].data()) + 2);
+  EXPECT_EQ(spans[0].length, 1u);
+  EXPECT_EQ(spans[1].data, reinterpret_cast<const uint8_t*>(blobs[1].data()));
+  EXPECT_EQ(spans[1].length, 3u);
+  EXPECT_EQ(spans[2].data, reinterpret_cast<const uint8_t*>(blobs[2].data()));
+  EXPECT_EQ(spans[2].length, 1u);
+
+  EXPECT_EQ(blobs_handle->Seek(0, SEEK_CUR), 7);
+}
+
+TEST(SnapshotsDataHandle, ReadSpansStopsAtMaxSpans) {
+  std::vector<std::string> blobs = {"abc", "def", "ghi", "jkl"};
+  std::unique_ptr<SnapshotsDataHandle> blobs_handle = MakeHandle(blobs);
+
+  SnapshotsDataSpan spans[2];
+  ASSERT_EQ(blobs_handle->ReadSpans(spans, 2, 100), 2u);
+  EXPECT_EQ(blobs_handle->Seek(0, SEEK_CUR), 6);
+
+  // The remaining bytes are returned by subsequent calls.
+  ASSERT_EQ(blobs_handle->ReadSpans(spans, 2, 100), 2u);
+  EXPECT_EQ(spans[1].data[2], 'l');
+  EXPECT_EQ(blobs_handle->ReadSpans(spans, 2, 100), 0u);
+}
+
 }  // namespace testing
 }  // namespace flutter
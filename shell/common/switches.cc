@@ -519,6 +519,70 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  {
+    std::string raster_cache_population;
+    if (command_line.GetOptionValue(
+            FlagForSwitch(Switch::RasterCachePopulation),
+            &raster_cache_population)) {
+      if (raster_cache_population == "join") {
+        settings.raster_cache_population =
+            RasterCachePopulation::kConcurrentJoin;
+      } else if (raster_cache_population == "deferred") {
+        settings.raster_cache_population =
+            RasterCachePopulation::kConcurrentDeferred;
+      } else {
+        settings.raster_cache_population = RasterCachePopulation::kSynchronous;
+      }
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    std::string raster_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheMaxBytes),
+                                &raster_cache_max_bytes);
+    settings.raster_cache_max_bytes = std::stoull(raster_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    std::string decoded_image_cache_max_bytes;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::DecodedImageCacheMaxBytes),
+        &decoded_image_cache_max_bytes);
+    settings.decoded_image_cache_max_bytes =
+        std::stoull(decoded_image_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageDecodeAheadFrames))) {
+    std::string decode_ahead_frames;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::AnimatedImageDecodeAheadFrames),
+        &decode_ahead_frames);
+    settings.animated_image_decode_ahead_frames =
+        std::stoull(decode_ahead_frames);
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageFrameCacheMaxBytes))) {
+    std::string frame_cache_max_bytes;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::AnimatedImageFrameCacheMaxBytes),
+        &frame_cache_max_bytes);
+    settings.animated_image_frame_cache_max_bytes =
+        std::stoull(frame_cache_max_bytes);
+  }
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::CaptureDisplayLists),
+                              &settings.display_list_capture_path);
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::CaptureDisplayListsFrameLimit))) {
+    std::string frame_limit;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::CaptureDisplayListsFrameLimit), &frame_limit);
+    settings.display_list_capture_frame_limit = std::stoull(frame_limit);
+  }
+
   settings.enable_platform_isolates =
       command_line.HasOption(FlagForSwitch(Switch::EnablePlatformIsolates));
 
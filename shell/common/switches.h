@@ -262,6 +262,42 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(ResourceCacheMaxBytesThreshold,
            "resource-cache-max-bytes-threshold",
            "The max bytes threshold of resource cache, or 0 for unlimited.")
+DEF_SWITCH(RasterCachePopulation,
+           "raster-cache-population",
+           "How display lists are rasterized into the Skia raster cache. "
+           "`sync` (the default) rasterizes them on the raster thread. `join` "
+           "rasterizes them on the concurrent worker threads and waits for "
+           "them before painting the frame. `deferred` rasterizes them on the "
+           "worker threads and paints them uncached until they are ready.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The total size in bytes of the images held by the Skia raster "
+           "cache, or 0 (the default) for unlimited.")
+DEF_SWITCH(AnimatedImageDecodeAheadFrames,
+           "animated-image-decode-ahead-frames",
+           "The number of frames of an animated image that are decoded on "
+           "worker threads ahead of the frame that is shown next. Defaults to "
+           "1, 0 decodes each frame when it is needed.")
+DEF_SWITCH(AnimatedImageFrameCacheMaxBytes,
+           "animated-image-frame-cache-max-bytes",
+           "If all of the decoded frames of an animated image fit in this many "
+           "bytes, they are kept after the first loop of the animation "
+           "instead of being decoded again. Defaults to 0, which keeps none.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The total size in bytes of the decoded images that the engine "
+           "keeps to avoid decoding the same image at the same size again, or "
+           "0 (the default) to disable the cache.")
+DEF_SWITCH(CaptureDisplayLists,
+           "capture-display-lists",
+           "Writes the display list of every rendered frame to the specified "
+           "directory, so that it can be replayed offline with "
+           "display_list_replay_benchmarks. Texture backed images and "
+           "Impeller text frames are replaced by placeholders.")
+DEF_SWITCH(CaptureDisplayListsFrameLimit,
+           "capture-display-lists-frame-limit",
+           "The number of frames written by --capture-display-lists. "
+           "Defaults to 100.")
 DEF_SWITCH(EnableImpeller,
            "enable-impeller",
            "Enable the Impeller renderer on supported platforms. Ignored if "
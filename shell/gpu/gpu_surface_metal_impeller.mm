@@ -179,7 +179,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromCAMetalLa
                   cull_rect);
               display_list->Dispatch(impeller_dispatcher, sk_cull_rect);
               impeller_dispatcher.FinishRecording();
-              aiks_context->GetContentContext().GetTransientsBuffer().Reset();
+              aiks_context->GetContentContext().ResetTransientsBuffers();
               aiks_context->GetContentContext().GetLazyGlyphAtlas()->ResetTextFrames();
               return true;
             }));
@@ -298,7 +298,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromMTLTextur
                   cull_rect);
               display_list->Dispatch(impeller_dispatcher, sk_cull_rect);
               impeller_dispatcher.FinishRecording();
-              aiks_context->GetContentContext().GetTransientsBuffer().Reset();
+              aiks_context->GetContentContext().ResetTransientsBuffers();
               aiks_context->GetContentContext().GetLazyGlyphAtlas()->ResetTextFrames();
               return true;
             }));
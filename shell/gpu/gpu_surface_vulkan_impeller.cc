@@ -6,6 +6,7 @@
 
 #include "flutter/fml/make_copyable.h"
 #include "impeller/display_list/dl_dispatcher.h"
+#include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/surface_context_vk.h"
 #include "impeller/renderer/renderer.h"
 #include "impeller/renderer/surface.h"
@@ -26,8 +27,12 @@ GPUSurfaceVulkanImpeller::GPUSurfaceVulkanImpeller(
     return;
   }
 
+  // Rasterize the glyphs added to the glyph atlas on the worker threads of
+  // the context.
+  auto& context_vk = impeller::SurfaceContextVK::Cast(*context);
   auto aiks_context = std::make_shared<impeller::AiksContext>(
-      context, impeller::TypographerContextSkia::Make());
+      context, impeller::TypographerContextSkia::Make(
+                   context_vk.GetParent()->GetConcurrentWorkerTaskRunner()));
   if (!aiks_context->IsValid()) {
     return;
   }
@@ -105,7 +110,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkanImpeller::AcquireFrame(
                   impeller_dispatcher,
                   SkIRect::MakeWH(cull_rect.width, cull_rect.height));
               impeller_dispatcher.FinishRecording();
-              aiks_context->GetContentContext().GetTransientsBuffer().Reset();
+              aiks_context->GetContentContext().ResetTransientsBuffers();
               aiks_context->GetContentContext()
                   .GetLazyGlyphAtlas()
                   ->ResetTextFrames();
@@ -26,11 +26,11 @@ size_t EmbedderTaskRunner::GetEmbedderIdentifier() const {
   return embedder_identifier_;
 }
 
-void EmbedderTaskRunner::PostTask(const fml::closure& task) {
-  PostTaskForTime(task, fml::TimePoint::Now());
+void EmbedderTaskRunner::PostTask(fml::UniqueTask task) {
+  PostTaskForTime(std::move(task), fml::TimePoint::Now());
 }
 
-void EmbedderTaskRunner::PostTaskForTime(const fml::closure& task,
+void EmbedderTaskRunner::PostTaskForTime(fml::UniqueTask task,
                                          fml::TimePoint target_time) {
   if (!task) {
     return;
@@ -42,15 +42,15 @@ void EmbedderTaskRunner::PostTaskForTime(const fml::closure& task,
     // Release the lock before the jump via the dispatch table.
     std::scoped_lock lock(tasks_mutex_);
     baton = ++last_baton_;
-    pending_tasks_[baton] = task;
+    pending_tasks_[baton] = std::move(task);
   }
 
   dispatch_table_.post_task_callback(this, baton, target_time);
 }
 
-void EmbedderTaskRunner::PostDelayedTask(const fml::closure& task,
+void EmbedderTaskRunner::PostDelayedTask(fml::UniqueTask task,
                                          fml::TimeDelta delay) {
-  PostTaskForTime(task, fml::TimePoint::Now() + delay);
+  PostTaskForTime(std::move(task), fml::TimePoint::Now() + delay);
 }
 
 bool EmbedderTaskRunner::RunsTasksOnCurrentThread() {
@@ -58,7 +58,7 @@ bool EmbedderTaskRunner::RunsTasksOnCurrentThread() {
 }
 
 bool EmbedderTaskRunner::PostTask(uint64_t baton) {
-  fml::closure task;
+  fml::UniqueTask task;
 
   {
     std::scoped_lock lock(tasks_mutex_);
@@ -67,7 +67,7 @@ bool EmbedderTaskRunner::PostTask(uint64_t baton) {
       FML_LOG(ERROR) << "Embedder attempted to post an unknown task.";
       return false;
     }
-    task = found->second;
+    task = std::move(found->second);
     pending_tasks_.erase(found);
 
     // Let go of the tasks mutex befor executing the task.
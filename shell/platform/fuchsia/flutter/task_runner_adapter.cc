@@ -4,6 +4,8 @@
 
 #include "task_runner_adapter.h"
 
+#include <utility>
+
 #include <lib/async/cpp/task.h>
 #include <lib/async/default.h>
 #include <lib/zx/time.h>
@@ -19,20 +21,19 @@ class CompatTaskRunner : public fml::TaskRunner {
     FML_DCHECK(forwarding_target_);
   }
 
-  void PostTask(const fml::closure& task) override {
-    async::PostTask(forwarding_target_, task);
+  void PostTask(fml::UniqueTask task) override {
+    async::PostTask(forwarding_target_, std::move(task));
   }
 
-  void PostTaskForTime(const fml::closure& task,
+  void PostTaskForTime(fml::UniqueTask task,
                        fml::TimePoint target_time) override {
     async::PostTaskForTime(
-        forwarding_target_, task,
+        forwarding_target_, std::move(task),
         zx::time(target_time.ToEpochDelta().ToNanoseconds()));
   }
 
-  void PostDelayedTask(const fml::closure& task,
-                       fml::TimeDelta delay) override {
-    async::PostDelayedTask(forwarding_target_, task,
+  void PostDelayedTask(fml::UniqueTask task, fml::TimeDelta delay) override {
+    async::PostDelayedTask(forwarding_target_, std::move(task),
                            zx::duration(delay.ToNanoseconds()));
   }
 
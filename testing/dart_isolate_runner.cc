@@ -73,7 +73,8 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolateOnUITaskRunner(
     const std::string& kernel_file_path,
     fml::WeakPtr<IOManager> io_manager,
     const std::shared_ptr<VolatilePathTracker>& volatile_path_tracker,
-    std::unique_ptr<PlatformConfiguration> platform_configuration) {
+    std::unique_ptr<PlatformConfiguration> platform_configuration,
+    fml::WeakPtr<ImageDecoder> image_decoder) {
   FML_CHECK(task_runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
 
   if (!vm_ref) {
@@ -122,9 +123,11 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolateOnUITaskRunner(
 
   UIDartState::Context context(task_runners);
   context.io_manager = std::move(io_manager);
+  context.image_decoder = std::move(image_decoder);
   context.advisory_script_uri = "main.dart";
   context.advisory_script_entrypoint = entrypoint.c_str();
   context.enable_impeller = p_settings.enable_impeller;
+  context.concurrent_task_runner = vm_ref->GetConcurrentWorkerTaskRunner();
 
   auto isolate =
       DartIsolate::CreateRunningRootIsolate(
@@ -161,7 +164,8 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolate(
     const std::string& kernel_file_path,
     fml::WeakPtr<IOManager> io_manager,
     std::shared_ptr<VolatilePathTracker> volatile_path_tracker,
-    std::unique_ptr<PlatformConfiguration> platform_configuration) {
+    std::unique_ptr<PlatformConfiguration> platform_configuration,
+    fml::WeakPtr<ImageDecoder> image_decoder) {
   std::unique_ptr<AutoIsolateShutdown> result;
   fml::AutoResetWaitableEvent latch;
   fml::TaskRunner::RunNowOrPostTask(
@@ -169,7 +173,7 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolate(
         result = RunDartCodeInIsolateOnUITaskRunner(
             vm_ref, settings, task_runners, entrypoint, args, kernel_file_path,
             io_manager, volatile_path_tracker,
-            std::move(platform_configuration));
+            std::move(platform_configuration), std::move(image_decoder));
         latch.Signal();
       }));
   latch.Wait();
@@ -66,7 +66,8 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolate(
     const std::string& fixtures_path,
     fml::WeakPtr<IOManager> io_manager = {},
     std::shared_ptr<VolatilePathTracker> volatile_path_tracker = nullptr,
-    std::unique_ptr<PlatformConfiguration> platform_configuration = nullptr);
+    std::unique_ptr<PlatformConfiguration> platform_configuration = nullptr,
+    fml::WeakPtr<ImageDecoder> image_decoder = {});
 
 }  // namespace testing
 }  // namespace flutter
@@ -574,6 +574,10 @@ def run_engine_benchmarks(build_dir, executable_filter):
 
   run_engine_executable(build_dir, 'fml_benchmarks', executable_filter, icu_flags)
 
+  run_engine_executable(build_dir, 'flow_benchmarks', executable_filter, icu_flags)
+
+  run_engine_executable(build_dir, 'shorebird_benchmarks', executable_filter, icu_flags)
+
   run_engine_executable(build_dir, 'ui_benchmarks', executable_filter, icu_flags)
 
   run_engine_executable(build_dir, 'display_list_builder_benchmarks', executable_filter, icu_flags)
@@ -582,6 +586,8 @@ def run_engine_benchmarks(build_dir, executable_filter):
 
   run_engine_executable(build_dir, 'canvas_benchmarks', executable_filter, icu_flags)
 
+  run_engine_executable(build_dir, 'typographer_benchmarks', executable_filter, icu_flags)
+
   if is_linux():
     run_engine_executable(build_dir, 'txt_benchmarks', executable_filter, icu_flags)
 